@@ -17,7 +17,9 @@ LOCAL_MODULE_CLASS := STATIC_LIBRARIES
 LOCAL_MODULE := libwebrtc_resampler
 LOCAL_MODULE_TAGS := optional
 LOCAL_CPP_EXTENSION := .cc
-LOCAL_SRC_FILES := resampler.cc
+LOCAL_SRC_FILES := \
+    polyphase_resampler.cc \
+    resampler.cc
 
 # Flags passed to both C and C++ files.
 LOCAL_CFLAGS := \
@@ -58,9 +58,13 @@ enum ResamplerMode
     kResamplerMode3To2,
     kResamplerMode11To2,
     kResamplerMode11To4,
-    kResamplerMode11To8
+    kResamplerMode11To8,
+    // Any other ratio, handled by the polyphase resampler.
+    kResamplerModeArbitrary
 };
 
+class PolyphaseResampler;
+
 class Resampler
 {
 
@@ -70,7 +74,8 @@ public:
     Resampler(int inFreq, int outFreq, ResamplerType type);
     ~Resampler();
 
-    // Reset all states
+    // Reset all states. Rate combinations without a dedicated fixed-ratio
+    // filter chain fall back to a general polyphase resampler.
     int Reset(int inFreq, int outFreq, ResamplerType type);
 
     // Reset all states if any parameter has changed
@@ -103,12 +108,19 @@ private:
     // State
     int my_in_frequency_khz_;
     int my_out_frequency_khz_;
+    // Exact rates, to tell e.g. 44.1 kHz from 44 kHz apart.
+    int my_in_frequency_hz_;
+    int my_out_frequency_hz_;
     ResamplerMode my_mode_;
     ResamplerType my_type_;
 
     // Extra instance for stereo
     Resampler* slave_left_;
     Resampler* slave_right_;
+
+    // Used instead of the above for kResamplerModeArbitrary; handles all
+    // channels interleaved.
+    PolyphaseResampler* polyphase_;
 };
 
 } // namespace webrtc
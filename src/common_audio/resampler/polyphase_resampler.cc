@@ -0,0 +1,205 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "polyphase_resampler.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "signal_processing_library.h"
+
+namespace webrtc {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+// Cutoff relative to the lower of the two Nyquist frequencies. Together with
+// the Kaiser window below this puts the stopband edge close to Nyquist.
+const double kCutoffRatio = 0.88;
+// Gives about 70 dB of stopband attenuation.
+const double kKaiserBeta = 7.0;
+// Coefficients are stored in Q14.
+const int kCoefficientShift = 14;
+
+// Zeroth-order modified Bessel function of the first kind.
+double BesselI0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  const double x_half_squared = x * x / 4.0;
+  for (int k = 1; k < 50; ++k) {
+    term *= x_half_squared / (k * k);
+    sum += term;
+    if (term < sum * 1e-12) {
+      break;
+    }
+  }
+  return sum;
+}
+
+int GreatestCommonDivisor(int a, int b) {
+  while (b != 0) {
+    const int c = a % b;
+    a = b;
+    b = c;
+  }
+  return a;
+}
+
+}  // namespace
+
+PolyphaseResampler::PolyphaseResampler()
+    : interpolation_(1),
+      decimation_(1),
+      num_channels_(0),
+      taps_(0),
+      phase_(0),
+      buffer_stride_(0) {}
+
+PolyphaseResampler::~PolyphaseResampler() {}
+
+int PolyphaseResampler::Init(int in_rate, int out_rate, int num_channels) {
+  if (in_rate <= 0 || out_rate <= 0 || num_channels <= 0) {
+    return -1;
+  }
+  const int gcd = GreatestCommonDivisor(in_rate, out_rate);
+  if (out_rate / gcd > kMaxPhases) {
+    return -1;
+  }
+  interpolation_ = out_rate / gcd;
+  decimation_ = in_rate / gcd;
+  num_channels_ = num_channels;
+  phase_ = 0;
+
+  // Widen the filter in proportion to the ratio when downsampling, rounded
+  // up to a multiple of eight taps to suit the vectorized dot product.
+  taps_ = kTapsPerPhase;
+  if (decimation_ > interpolation_) {
+    taps_ = (kTapsPerPhase * decimation_ + interpolation_ - 1) /
+        interpolation_;
+    taps_ = (taps_ + 7) & ~7;
+  }
+
+  // Design the prototype low-pass filter at the upsampled rate and split it
+  // into |interpolation_| phases of |taps_| coefficients each.
+  const int length = interpolation_ * taps_;
+  const double center = (length - 1) / 2.0;
+  const double cutoff = kCutoffRatio * 0.5 /
+      (interpolation_ > decimation_ ? interpolation_ : decimation_);
+  const double window_scale = 1.0 / BesselI0(kKaiserBeta);
+  std::vector<double> prototype(length);
+  for (int k = 0; k < length; ++k) {
+    const double t = k - center;
+    const double x = t / (length / 2.0);
+    const double window = BesselI0(kKaiserBeta * sqrt(1.0 - x * x)) *
+        window_scale;
+    const double arg = 2.0 * kPi * cutoff * t;
+    prototype[k] = window * (arg == 0.0 ? 1.0 : sin(arg) / arg);
+  }
+
+  filter_bank_.resize(length);
+  for (int p = 0; p < interpolation_; ++p) {
+    double sum = 0.0;
+    for (int j = 0; j < taps_; ++j) {
+      sum += prototype[j * interpolation_ + p];
+    }
+    // Normalize every phase to unit DC gain, and fix up the rounding error on
+    // the largest tap so that the gain is exact in Q14 as well.
+    WebRtc_Word16* filter = &filter_bank_[p * taps_];
+    int quantized_sum = 0;
+    int largest = 0;
+    for (int m = 0; m < taps_; ++m) {
+      const double value = prototype[(taps_ - 1 - m) * interpolation_ + p] /
+          sum * (1 << kCoefficientShift);
+      filter[m] = static_cast<WebRtc_Word16>(floor(value + 0.5));
+      quantized_sum += filter[m];
+      if (abs(filter[m]) > abs(filter[largest])) {
+        largest = m;
+      }
+    }
+    filter[largest] += (1 << kCoefficientShift) - quantized_sum;
+  }
+
+  buffer_stride_ = taps_ - 1;
+  buffer_.assign(num_channels_ * buffer_stride_, 0);
+
+  // Make sure the dispatched dot product uses the best version for this CPU.
+  WebRtcSpl_Init();
+  return 0;
+}
+
+int PolyphaseResampler::OutputLength(int length_in) const {
+  if (num_channels_ <= 0) {
+    return 0;
+  }
+  const int end = (length_in / num_channels_) * interpolation_;
+  if (end <= phase_) {
+    return 0;
+  }
+  return ((end - phase_ + decimation_ - 1) / decimation_) * num_channels_;
+}
+
+int PolyphaseResampler::Push(const WebRtc_Word16* samples_in, int length_in,
+                             WebRtc_Word16* samples_out, int max_length,
+                             int* length_out) {
+  if (num_channels_ <= 0 || length_in < 0 || length_in % num_channels_ != 0) {
+    return -1;
+  }
+  const int out_length = OutputLength(length_in);
+  if (out_length > max_length) {
+    return -1;
+  }
+  const int frames_in = length_in / num_channels_;
+  const int history = taps_ - 1;
+
+  // Append the deinterleaved block to the history of each channel.
+  if (history + frames_in > buffer_stride_) {
+    std::vector<WebRtc_Word16> grown(num_channels_ * (history + frames_in));
+    for (int ch = 0; ch < num_channels_; ++ch) {
+      memcpy(&grown[ch * (history + frames_in)], &buffer_[ch * buffer_stride_],
+             history * sizeof(WebRtc_Word16));
+    }
+    buffer_.swap(grown);
+    buffer_stride_ = history + frames_in;
+  }
+  for (int ch = 0; ch < num_channels_; ++ch) {
+    WebRtc_Word16* buffer = &buffer_[ch * buffer_stride_ + history];
+    for (int i = 0; i < frames_in; ++i) {
+      buffer[i] = samples_in[i * num_channels_ + ch];
+    }
+  }
+
+  // Output n sits at input position |phase_| / |interpolation_|; the integer
+  // part selects the last input frame of the window and the remainder picks
+  // the filter.
+  const int end = frames_in * interpolation_;
+  const int out_frames = out_length / num_channels_;
+  for (int ch = 0; ch < num_channels_; ++ch) {
+    WebRtc_Word16* buffer = &buffer_[ch * buffer_stride_];
+    int position = phase_;
+    for (int n = 0; n < out_frames; ++n) {
+      const int frame = position / interpolation_;
+      const int phase = position - frame * interpolation_;
+      const WebRtc_Word32 sum = WebRtcSpl_DotProductWithScale(
+          &buffer[frame], &filter_bank_[phase * taps_], taps_, 0);
+      samples_out[n * num_channels_ + ch] = WebRtcSpl_SatW32ToW16(
+          (sum + (1 << (kCoefficientShift - 1))) >> kCoefficientShift);
+      position += decimation_;
+    }
+    // Keep the last |history| frames for the next block.
+    memmove(buffer, buffer + frames_in, history * sizeof(WebRtc_Word16));
+  }
+  phase_ += out_frames * decimation_ - end;
+
+  *length_out = out_length;
+  return 0;
+}
+
+}  // namespace webrtc
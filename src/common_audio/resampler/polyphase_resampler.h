@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A polyphase windowed-sinc resampler for any rational ratio between two
+// sample rates. It is used by Resampler for the rate combinations that have
+// no dedicated fixed-ratio filter chain, e.g. 44.1 kHz <-> 48 kHz.
+
+#ifndef WEBRTC_COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
+#define WEBRTC_COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
+
+#include <vector>
+
+#include "typedefs.h"
+
+namespace webrtc {
+
+class PolyphaseResampler {
+ public:
+  // The largest number of filter phases, i.e. the largest output rate
+  // divided by the gcd of the two rates, that Init() accepts. Enough for any
+  // pair of the 8, 11.025, 12, 16, 22.05, 24, 32, 44.1, 48 and 96 kHz
+  // families.
+  static const int kMaxPhases = 1024;
+  // Number of taps per phase when upsampling. It grows with the ratio when
+  // downsampling to keep the transition band narrow.
+  static const int kTapsPerPhase = 32;
+
+  PolyphaseResampler();
+  ~PolyphaseResampler();
+
+  // Designs the filter bank for |in_rate| -> |out_rate| and clears the
+  // history. Returns 0 on success and -1 on invalid arguments.
+  int Init(int in_rate, int out_rate, int num_channels);
+
+  // Resamples |length_in| interleaved samples (|length_in| / num_channels
+  // frames) from |samples_in| into |samples_out|. The output frame count
+  // follows the exact rate ratio over the whole stream, so it may differ by
+  // one frame between calls if a block is not an exact multiple of the
+  // ratio. Returns -1 if |max_length| is too small for the output.
+  int Push(const WebRtc_Word16* samples_in, int length_in,
+           WebRtc_Word16* samples_out, int max_length, int* length_out);
+
+  // Returns the number of interleaved output samples the next call to Push()
+  // with |length_in| interleaved input samples will produce.
+  int OutputLength(int length_in) const;
+
+  int num_channels() const { return num_channels_; }
+  int taps_per_phase() const { return taps_; }
+
+ private:
+  // Input step per output sample is |decimation_| / |interpolation_|.
+  int interpolation_;
+  int decimation_;
+  int num_channels_;
+  int taps_;
+  // Position of the next output sample in units of 1 / |interpolation_|
+  // input samples, relative to the first frame of the next Push().
+  int phase_;
+  // |interpolation_| filters of |taps_| Q14 coefficients each, stored in
+  // reverse order so that each output is a plain dot product with the input.
+  std::vector<WebRtc_Word16> filter_bank_;
+  // Per channel, the last |taps_| - 1 input frames followed by room for the
+  // current block.
+  std::vector<WebRtc_Word16> buffer_;
+  int buffer_stride_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_RESAMPLER_POLYPHASE_RESAMPLER_H_
@@ -18,6 +18,7 @@
 
 #include "signal_processing_library.h"
 #include "resampler.h"
+#include "polyphase_resampler.h"
 
 
 namespace webrtc
@@ -37,10 +38,13 @@ Resampler::Resampler()
     // we need a reset before we will work
     my_in_frequency_khz_ = 0;
     my_out_frequency_khz_ = 0;
+    my_in_frequency_hz_ = 0;
+    my_out_frequency_hz_ = 0;
     my_mode_ = kResamplerMode1To1;
     my_type_ = kResamplerInvalid;
     slave_left_ = NULL;
     slave_right_ = NULL;
+    polyphase_ = NULL;
 }
 
 Resampler::Resampler(int inFreq, int outFreq, ResamplerType type)
@@ -57,10 +61,13 @@ Resampler::Resampler(int inFreq, int outFreq, ResamplerType type)
     // we need a reset before we will work
     my_in_frequency_khz_ = 0;
     my_out_frequency_khz_ = 0;
+    my_in_frequency_hz_ = 0;
+    my_out_frequency_hz_ = 0;
     my_mode_ = kResamplerMode1To1;
     my_type_ = kResamplerInvalid;
     slave_left_ = NULL;
     slave_right_ = NULL;
+    polyphase_ = NULL;
 
     Reset(inFreq, outFreq, type);
 }
@@ -95,14 +102,15 @@ Resampler::~Resampler()
     {
         delete slave_right_;
     }
+    if (polyphase_)
+    {
+        delete polyphase_;
+    }
 }
 
 int Resampler::ResetIfNeeded(int inFreq, int outFreq, ResamplerType type)
 {
-    int tmpInFreq_kHz = inFreq / 1000;
-    int tmpOutFreq_kHz = outFreq / 1000;
-
-    if ((tmpInFreq_kHz != my_in_frequency_khz_) || (tmpOutFreq_kHz != my_out_frequency_khz_)
+    if ((inFreq != my_in_frequency_hz_) || (outFreq != my_out_frequency_hz_)
             || (type != my_type_))
     {
         return Reset(inFreq, outFreq, type);
@@ -150,6 +158,11 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
         delete slave_right_;
         slave_right_ = NULL;
     }
+    if (polyphase_)
+    {
+        delete polyphase_;
+        polyphase_ = NULL;
+    }
 
     in_buffer_size_ = 0;
     out_buffer_size_ = 0;
@@ -159,6 +172,12 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
     // This might be overridden if parameters are not accepted.
     my_type_ = type;
 
+    if ((inFreq <= 0) || (outFreq <= 0))
+    {
+        my_type_ = kResamplerInvalid;
+        return -1;
+    }
+
     // Start with a math exercise, Euclid's algorithm to find the gcd:
 
     int a = inFreq;
@@ -175,21 +194,13 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
     // We need to track what domain we're in.
     my_in_frequency_khz_ = inFreq / 1000;
     my_out_frequency_khz_ = outFreq / 1000;
+    my_in_frequency_hz_ = inFreq;
+    my_out_frequency_hz_ = outFreq;
 
     // Scale with GCD
     inFreq = inFreq / b;
     outFreq = outFreq / b;
 
-    // Do we need stereo?
-    if ((my_type_ & 0xf0) == 0x20)
-    {
-        // Change type to mono
-        type = static_cast<ResamplerType>(
-            ((static_cast<int>(type) & 0x0f) + 0x10));
-        slave_left_ = new Resampler(inFreq, outFreq, type);
-        slave_right_ = new Resampler(inFreq, outFreq, type);
-    }
-
     if (inFreq == outFreq)
     {
         my_mode_ = kResamplerMode1To1;
@@ -213,8 +224,8 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
                 my_mode_ = kResamplerMode1To12;
                 break;
             default:
-                my_type_ = kResamplerInvalid;
-                return -1;
+                my_mode_ = kResamplerModeArbitrary;
+                break;
         }
     } else if (outFreq == 1)
     {
@@ -236,8 +247,8 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
                 my_mode_ = kResamplerMode12To1;
                 break;
             default:
-                my_type_ = kResamplerInvalid;
-                return -1;
+                my_mode_ = kResamplerModeArbitrary;
+                break;
         }
     } else if ((inFreq == 2) && (outFreq == 3))
     {
@@ -271,8 +282,17 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
         my_mode_ = kResamplerMode11To8;
     } else
     {
-        my_type_ = kResamplerInvalid;
-        return -1;
+        my_mode_ = kResamplerModeArbitrary;
+    }
+
+    // Do we need stereo? The polyphase resampler handles it by itself.
+    if (((my_type_ & 0xf0) == 0x20) && (my_mode_ != kResamplerModeArbitrary))
+    {
+        // Change type to mono
+        type = static_cast<ResamplerType>(
+            ((static_cast<int>(type) & 0x0f) + 0x10));
+        slave_left_ = new Resampler(inFreq, outFreq, type);
+        slave_right_ = new Resampler(inFreq, outFreq, type);
     }
 
     // Now create the states we need
@@ -421,7 +441,16 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
             state1_ = malloc(sizeof(WebRtcSpl_State22khzTo16khz));
             WebRtcSpl_ResetResample22khzTo16khz((WebRtcSpl_State22khzTo16khz *)state1_);
             break;
-
+        case kResamplerModeArbitrary:
+            polyphase_ = new PolyphaseResampler();
+            if (polyphase_->Init(inFreq, outFreq, (my_type_ & 0xf0) >> 4) != 0)
+            {
+                delete polyphase_;
+                polyphase_ = NULL;
+                my_type_ = kResamplerInvalid;
+                return -1;
+            }
+            break;
     }
 
     return 0;
@@ -437,6 +466,12 @@ int Resampler::Push(const WebRtc_Word16 * samplesIn, int lengthIn, WebRtc_Word16
         return -1;
     }
 
+    // The polyphase resampler works on interleaved channels directly
+    if (my_mode_ == kResamplerModeArbitrary)
+    {
+        return polyphase_->Push(samplesIn, lengthIn, samplesOut, maxLen, &outLen);
+    }
+
     // Do we have a stereo signal?
     if ((my_type_ & 0xf0) == 0x20)
     {
@@ -987,7 +1022,9 @@ int Resampler::Push(const WebRtc_Word16 * samplesIn, int lengthIn, WebRtc_Word16
             free(tmp_mem);
             return 0;
             break;
-
+        case kResamplerModeArbitrary:
+            // Handled above
+            break;
     }
     return 0;
 }
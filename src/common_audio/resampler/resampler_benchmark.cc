@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the throughput and the quality of Resampler for rate combinations
+// served by the polyphase resampler. For every combination it prints the
+// time to resample 10 ms with the C and the optimized SPL kernels, and the
+// signal-to-noise ratio of a resampled in-band tone.
+
+#include <math.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include "common_audio/resampler/include/resampler.h"
+#include "signal_processing_library.h"
+#include "system_wrappers/interface/tick_util.h"
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const int kIterations = 2000;
+const int kSeconds = 1;
+
+struct RatePair {
+  int in_rate;
+  int out_rate;
+};
+
+const RatePair kRatePairs[] = {
+  {44100, 48000},
+  {48000, 44100},
+  {44100, 16000},
+  {16000, 44100},
+  {44100, 32000},
+  {22050, 48000},
+  {96000, 44100}
+};
+
+void GenerateTone(int rate, double frequency, int num_channels,
+                  int frames, std::vector<WebRtc_Word16>* samples) {
+  samples->resize(frames * num_channels);
+  for (int i = 0; i < frames; ++i) {
+    for (int ch = 0; ch < num_channels; ++ch) {
+      (*samples)[i * num_channels + ch] = static_cast<WebRtc_Word16>(
+          16000 * sin(2 * kPi * frequency * i / rate));
+    }
+  }
+}
+
+// Returns the SNR in dB of |samples| against the best fitting sine of
+// |frequency| Hz, ignoring the first |skip| samples.
+double ToneSnr(const std::vector<WebRtc_Word16>& samples, int rate,
+               double frequency, int skip) {
+  double ss = 0, sc = 0, cc = 0, xs = 0, xc = 0;
+  for (size_t i = skip; i < samples.size(); ++i) {
+    const double s = sin(2 * kPi * frequency * i / rate);
+    const double c = cos(2 * kPi * frequency * i / rate);
+    ss += s * s;
+    sc += s * c;
+    cc += c * c;
+    xs += samples[i] * s;
+    xc += samples[i] * c;
+  }
+  const double det = ss * cc - sc * sc;
+  const double a = (xs * cc - xc * sc) / det;
+  const double b = (xc * ss - xs * sc) / det;
+  double signal = 0, noise = 0;
+  for (size_t i = skip; i < samples.size(); ++i) {
+    const double fit = a * sin(2 * kPi * frequency * i / rate) +
+        b * cos(2 * kPi * frequency * i / rate);
+    signal += fit * fit;
+    noise += (samples[i] - fit) * (samples[i] - fit);
+  }
+  return 10 * log10(signal / (noise + 1e-9));
+}
+
+// Returns the time in microseconds to resample 10 ms of |num_channels|
+// channels from |in_rate| to |out_rate| with |dot_product| as the inner loop.
+double TimePush(int in_rate, int out_rate, int num_channels,
+                DotProductWithScale dot_product) {
+  const webrtc::ResamplerType type = num_channels == 2 ?
+      webrtc::kResamplerSynchronousStereo : webrtc::kResamplerSynchronous;
+  webrtc::Resampler resampler(in_rate, out_rate, type);
+  std::vector<WebRtc_Word16> in;
+  GenerateTone(in_rate, 1000, num_channels, in_rate / 100, &in);
+  std::vector<WebRtc_Word16> out(2 * num_channels * out_rate / 100);
+  int out_length = 0;
+
+  // Reset() has already picked the best version for this CPU; override it.
+  const DotProductWithScale saved = WebRtcSpl_DotProductWithScale;
+  WebRtcSpl_DotProductWithScale = dot_product;
+  const webrtc::TickTime start = webrtc::TickTime::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    resampler.Push(&in[0], static_cast<int>(in.size()), &out[0],
+                   static_cast<int>(out.size()), out_length);
+  }
+  const double us = static_cast<double>(
+      (webrtc::TickTime::Now() - start).Microseconds()) / kIterations;
+  WebRtcSpl_DotProductWithScale = saved;
+  return us;
+}
+
+// Resamples |kSeconds| of a tone at |fraction| of the lower Nyquist frequency
+// and returns its SNR.
+double MeasureSnr(int in_rate, int out_rate, double fraction) {
+  const int nyquist = (in_rate < out_rate ? in_rate : out_rate) / 2;
+  const double frequency = fraction * nyquist;
+  webrtc::Resampler resampler(in_rate, out_rate,
+                              webrtc::kResamplerSynchronous);
+  std::vector<WebRtc_Word16> in;
+  GenerateTone(in_rate, frequency, 1, kSeconds * in_rate, &in);
+  std::vector<WebRtc_Word16> out(kSeconds * out_rate + 1);
+  int out_length = 0;
+  if (resampler.Push(&in[0], static_cast<int>(in.size()), &out[0],
+                     static_cast<int>(out.size()), out_length) != 0) {
+    return 0.0;
+  }
+  out.resize(out_length);
+  return ToneSnr(out, out_rate, frequency, out_rate / 100);
+}
+
+}  // namespace
+
+int main(int /*argc*/, char** /*argv*/) {
+  WebRtcSpl_Init();
+  if (WebRtcSpl_DotProductWithScale == WebRtcSpl_DotProductWithScaleC) {
+    printf("No optimized versions available on this CPU.\n");
+  }
+  printf("%-16s %-8s %10s %10s %8s %12s %12s\n", "rates", "channels",
+         "C (us)", "opt (us)", "speedup", "SNR 1/8 (dB)", "SNR 3/4 (dB)");
+  for (size_t i = 0; i < sizeof(kRatePairs) / sizeof(*kRatePairs); ++i) {
+    const int in_rate = kRatePairs[i].in_rate;
+    const int out_rate = kRatePairs[i].out_rate;
+    const double snr_low = MeasureSnr(in_rate, out_rate, 0.125);
+    const double snr_high = MeasureSnr(in_rate, out_rate, 0.75);
+    for (int num_channels = 1; num_channels <= 2; ++num_channels) {
+      const double c_us = TimePush(in_rate, out_rate, num_channels,
+                                   WebRtcSpl_DotProductWithScaleC);
+      const double optimized_us = TimePush(in_rate, out_rate, num_channels,
+                                           WebRtcSpl_DotProductWithScale);
+
+      printf("%6d -> %6d  %-8d %10.2f %10.2f %7.2fx %12.1f %12.1f\n",
+             in_rate, out_rate, num_channels, c_us, optimized_us,
+             optimized_us > 0 ? c_us / optimized_us : 0.0, snr_low, snr_high);
+    }
+  }
+  return 0;
+}
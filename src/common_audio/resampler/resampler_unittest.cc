@@ -8,6 +8,12 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "common_audio/resampler/include/resampler.h"
@@ -32,21 +38,72 @@ const int kRates[] = {
   16000,
   32000,
   44000,
+  44100,
   48000,
   kMaxRate
 };
 const size_t kRatesSize = sizeof(kRates) / sizeof(*kRates);
 const size_t kDataSize = kMaxRate / 100;
 
-// TODO(andrew): should we be supporting these combinations?
-bool ValidRates(int in_rate, int out_rate) {
-  // Not the most compact notation, for clarity.
-  if ((in_rate == 44000 && (out_rate == 48000 || out_rate == 96000)) ||
-      (out_rate == 44000 && (in_rate == 48000 || in_rate == 96000))) {
-    return false;
+const double kPi = 3.14159265358979323846;
+
+// Fills |frames| interleaved frames of |num_channels| channels with a sine of
+// |frequency| Hz at |rate| Hz, shifting the frequency up by 10% per channel.
+void GenerateTones(int rate, int frequency, int num_channels, int frames,
+                   std::vector<int16_t>* samples) {
+  samples->resize(frames * num_channels);
+  for (int i = 0; i < frames; ++i) {
+    for (int ch = 0; ch < num_channels; ++ch) {
+      const double f = frequency * (1.0 + 0.1 * ch);
+      (*samples)[i * num_channels + ch] = static_cast<int16_t>(
+          10000 * sin(2 * kPi * f * i / rate));
+    }
   }
+}
 
-  return true;
+// Pushes |in| through |rs| in blocks of |block_length| samples and returns
+// the concatenated output.
+std::vector<int16_t> PushInBlocks(Resampler* rs,
+                                  const std::vector<int16_t>& in,
+                                  int block_length) {
+  std::vector<int16_t> out;
+  int16_t block_out[kDataSize * 2];
+  for (size_t i = 0; i < in.size(); i += block_length) {
+    const int length = std::min(static_cast<int>(in.size() - i),
+                                block_length);
+    int out_length = 0;
+    EXPECT_EQ(0, rs->Push(&in[i], length, block_out,
+                          sizeof(block_out) / sizeof(*block_out), out_length));
+    out.insert(out.end(), block_out, block_out + out_length);
+  }
+  return out;
+}
+
+// Returns the ratio in dB between a least-squares fit of a sine of
+// |frequency| Hz to the mono signal |samples| at |rate| Hz, and the residual.
+double ToneSnr(const std::vector<int16_t>& samples, int rate, int frequency,
+               int skip) {
+  double ss = 0, sc = 0, cc = 0, xs = 0, xc = 0;
+  for (size_t i = skip; i < samples.size(); ++i) {
+    const double s = sin(2 * kPi * frequency * i / rate);
+    const double c = cos(2 * kPi * frequency * i / rate);
+    ss += s * s;
+    sc += s * c;
+    cc += c * c;
+    xs += samples[i] * s;
+    xc += samples[i] * c;
+  }
+  const double det = ss * cc - sc * sc;
+  const double a = (xs * cc - xc * sc) / det;
+  const double b = (xc * ss - xs * sc) / det;
+  double signal = 0, noise = 0;
+  for (size_t i = skip; i < samples.size(); ++i) {
+    const double fit = a * sin(2 * kPi * frequency * i / rate) +
+        b * cos(2 * kPi * frequency * i / rate);
+    signal += fit * fit;
+    noise += (samples[i] - fit) * (samples[i] - fit);
+  }
+  return 10 * log10(signal / (noise + 1e-9));
 }
 
 class ResamplerTest : public testing::Test {
@@ -82,13 +139,15 @@ TEST_F(ResamplerTest, Reset) {
         ss << "Input rate: " << kRates[i] << ", output rate: " << kRates[j]
             << ", type: " << kTypes[k];
         SCOPED_TRACE(ss.str());
-        if (ValidRates(kRates[i], kRates[j]))
-          EXPECT_EQ(0, rs_.Reset(kRates[i], kRates[j], kTypes[k]));
-        else
-          EXPECT_EQ(-1, rs_.Reset(kRates[i], kRates[j], kTypes[k]));
+        EXPECT_EQ(0, rs_.Reset(kRates[i], kRates[j], kTypes[k]));
       }
     }
   }
+
+  EXPECT_EQ(-1, rs_.Reset(0, 16000, kResamplerSynchronous));
+  EXPECT_EQ(-1, rs_.Reset(16000, -1, kResamplerSynchronous));
+  // Too many filter phases.
+  EXPECT_EQ(-1, rs_.Reset(16000, 44101, kResamplerSynchronous));
 }
 
 TEST_F(ResamplerTest, Synchronous) {
@@ -98,20 +157,72 @@ TEST_F(ResamplerTest, Synchronous) {
       ss << "Input rate: " << kRates[i] << ", output rate: " << kRates[j];
       SCOPED_TRACE(ss.str());
 
-      if (ValidRates(kRates[i], kRates[j])) {
-        int in_length = kRates[i] / 100;
-        int out_length = 0;
-        EXPECT_EQ(0, rs_.Reset(kRates[i], kRates[j], kResamplerSynchronous));
-        EXPECT_EQ(0, rs_.Push(data_in_, in_length, data_out_, kDataSize,
-                              out_length));
-        EXPECT_EQ(kRates[j] / 100, out_length);
-      } else {
-        EXPECT_EQ(-1, rs_.Reset(kRates[i], kRates[j], kResamplerSynchronous));
-      }
+      int in_length = kRates[i] / 100;
+      int out_length = 0;
+      EXPECT_EQ(0, rs_.Reset(kRates[i], kRates[j], kResamplerSynchronous));
+      EXPECT_EQ(0, rs_.Push(data_in_, in_length, data_out_, kDataSize,
+                            out_length));
+      EXPECT_EQ(kRates[j] / 100, out_length);
     }
   }
 
   // TODO(andrew): test stereo.
 }
+
+TEST_F(ResamplerTest, ArbitraryRatioPreservesTone) {
+  const int kRatePairs[][2] = {
+    {44100, 48000},
+    {48000, 44100},
+    {44100, 16000},
+    {8000, 44100},
+    {22050, 32000}
+  };
+  for (size_t i = 0; i < sizeof(kRatePairs) / sizeof(*kRatePairs); ++i) {
+    const int in_rate = kRatePairs[i][0];
+    const int out_rate = kRatePairs[i][1];
+    std::ostringstream ss;
+    ss << "Input rate: " << in_rate << ", output rate: " << out_rate;
+    SCOPED_TRACE(ss.str());
+
+    std::vector<int16_t> in;
+    GenerateTones(in_rate, 1000, 1, in_rate / 2, &in);
+    ASSERT_EQ(0, rs_.Reset(in_rate, out_rate, kResamplerSynchronous));
+    std::vector<int16_t> out = PushInBlocks(&rs_, in, in_rate / 100);
+    EXPECT_EQ(out_rate / 2, static_cast<int>(out.size()));
+    // Skip the filter's start-up transient.
+    EXPECT_GT(ToneSnr(out, out_rate, 1000, out_rate / 100), 60.0);
+  }
+}
+
+TEST_F(ResamplerTest, ArbitraryRatioIsBlockSizeIndependent) {
+  std::vector<int16_t> in;
+  GenerateTones(44100, 1000, 1, 4410, &in);
+  ASSERT_EQ(0, rs_.Reset(44100, 48000, kResamplerSynchronous));
+  const std::vector<int16_t> reference = PushInBlocks(&rs_, in, 441);
+  ASSERT_EQ(4800u, reference.size());
+  ASSERT_EQ(0, rs_.Reset(44100, 48000, kResamplerSynchronous));
+  EXPECT_TRUE(reference == PushInBlocks(&rs_, in, 97));
+}
+
+TEST_F(ResamplerTest, ArbitraryRatioStereoMatchesMono) {
+  std::vector<int16_t> stereo;
+  GenerateTones(48000, 1000, 2, 4800, &stereo);
+  ASSERT_EQ(0, rs_.Reset(48000, 44100, kResamplerSynchronousStereo));
+  const std::vector<int16_t> out = PushInBlocks(&rs_, stereo, 960);
+  ASSERT_EQ(2 * 4410u, out.size());
+
+  for (int ch = 0; ch < 2; ++ch) {
+    std::vector<int16_t> mono(stereo.size() / 2);
+    for (size_t i = 0; i < mono.size(); ++i) {
+      mono[i] = stereo[2 * i + ch];
+    }
+    Resampler mono_rs(48000, 44100, kResamplerSynchronous);
+    const std::vector<int16_t> mono_out = PushInBlocks(&mono_rs, mono, 480);
+    ASSERT_EQ(out.size() / 2, mono_out.size());
+    for (size_t i = 0; i < mono_out.size(); ++i) {
+      ASSERT_EQ(mono_out[i], out[2 * i + ch]) << "channel " << ch;
+    }
+  }
+}
 }  // namespace
 }  // namespace webrtc
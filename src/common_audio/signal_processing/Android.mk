@@ -23,12 +23,16 @@ LOCAL_SRC_FILES := \
     complex_bit_reverse.c \
     copy_set_operations.c \
     cross_correlation.c \
+    cross_correlation_sse2.c \
     division_operations.c \
     dot_product_with_scale.c \
+    dot_product_with_scale_sse2.c \
     downsample_fast.c \
+    downsample_fast_sse2.c \
     energy.c \
     filter_ar.c \
     filter_ar_fast_q12.c \
+    filter_ar_fast_q12_sse2.c \
     filter_ma_fast_q12.c \
     get_hanning_window.c \
     get_scaling_square.c \
@@ -36,6 +40,8 @@ LOCAL_SRC_FILES := \
     levinson_durbin.c \
     lpc_to_refl_coef.c \
     min_max_operations.c \
+    mix_vectors.c \
+    mix_vectors_sse2.c \
     randomization_functions.c \
     refl_coef_to_lpc.c \
     resample.c \
@@ -43,6 +49,7 @@ LOCAL_SRC_FILES := \
     resample_by_2.c \
     resample_by_2_internal.c \
     resample_fractional.c \
+    spl_init.c \
     spl_sqrt.c \
     spl_sqrt_floor.c \
     spl_version.c \
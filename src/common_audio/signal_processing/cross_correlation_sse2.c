@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file contains the function WebRtcSpl_CrossCorrelationSSE2().
+ * The description header can be found in signal_processing_library.h
+ *
+ */
+
+#include "signal_processing_library.h"
+
+#if defined(WEBRTC_USE_SSE2)
+
+void WebRtcSpl_CrossCorrelationSSE2(WebRtc_Word32* cross_correlation,
+                                    WebRtc_Word16* seq1,
+                                    WebRtc_Word16* seq2,
+                                    WebRtc_Word16 dim_seq,
+                                    WebRtc_Word16 dim_cross_correlation,
+                                    WebRtc_Word16 right_shifts,
+                                    WebRtc_Word16 step_seq2)
+{
+    int i;
+
+    // Each lag is a dot product of |seq1| with a shifted |seq2|.
+    for (i = 0; i < dim_cross_correlation; i++)
+    {
+        cross_correlation[i] = WebRtcSpl_DotProductWithScaleSSE2(
+            seq1, seq2 + step_seq2 * i, dim_seq, right_shifts);
+    }
+}
+
+#endif  // WEBRTC_USE_SSE2
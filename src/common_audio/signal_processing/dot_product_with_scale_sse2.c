@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file contains the function WebRtcSpl_DotProductWithScaleSSE2().
+ * The description header can be found in signal_processing_library.h
+ *
+ */
+
+#include "signal_processing_library.h"
+
+#if defined(WEBRTC_USE_SSE2)
+
+#include <emmintrin.h>
+
+WebRtc_Word32 WebRtcSpl_DotProductWithScaleSSE2(WebRtc_Word16 *vector1,
+                                                WebRtc_Word16 *vector2,
+                                                int length, int scaling)
+{
+    __m128i sum = _mm_setzero_si128();
+    WebRtc_Word32 result;
+    int i = 0;
+
+    if (scaling == 0)
+    {
+        // Products are summed in pairs before the accumulation, which gives
+        // the same 32-bit (wrapping) result as summing them one by one.
+        for (; i + 7 < length; i += 8)
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i*) &vector1[i]);
+            const __m128i b = _mm_loadu_si128((const __m128i*) &vector2[i]);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(a, b));
+        }
+    }
+    else
+    {
+        // Each product has to be shifted on its own, so form the full 32-bit
+        // products from their low and high halves.
+        const __m128i shift = _mm_cvtsi32_si128(scaling);
+        for (; i + 7 < length; i += 8)
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i*) &vector1[i]);
+            const __m128i b = _mm_loadu_si128((const __m128i*) &vector2[i]);
+            const __m128i low = _mm_mullo_epi16(a, b);
+            const __m128i high = _mm_mulhi_epi16(a, b);
+            sum = _mm_add_epi32(sum, _mm_sra_epi32(
+                _mm_unpacklo_epi16(low, high), shift));
+            sum = _mm_add_epi32(sum, _mm_sra_epi32(
+                _mm_unpackhi_epi16(low, high), shift));
+        }
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    result = _mm_cvtsi128_si32(sum);
+
+    for (; i < length; i++)
+    {
+        result += WEBRTC_SPL_MUL_16_16_RSFT(vector1[i], vector2[i], scaling);
+    }
+
+    return result;
+}
+
+#endif  // WEBRTC_USE_SSE2
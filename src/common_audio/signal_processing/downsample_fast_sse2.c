@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file contains the function WebRtcSpl_DownsampleFastSSE2().
+ * The description header can be found in signal_processing_library.h
+ *
+ */
+
+#include "signal_processing_library.h"
+
+#if defined(WEBRTC_USE_SSE2)
+
+#include <emmintrin.h>
+
+// Longer filters than this are handed to the C version.
+#define MAX_COEF_LENGTH 64
+
+int WebRtcSpl_DownsampleFastSSE2(WebRtc_Word16 *in_ptr, WebRtc_Word16 in_length,
+                                 WebRtc_Word16 *out_ptr, WebRtc_Word16 out_length,
+                                 WebRtc_Word16 *B, WebRtc_Word16 B_length,
+                                 WebRtc_Word16 factor, WebRtc_Word16 delay)
+{
+    WebRtc_Word16 B_reversed[MAX_COEF_LENGTH];
+    WebRtc_Word32 o;
+    int i;
+
+    WebRtc_Word16 *downsampled_ptr = out_ptr;
+    WebRtc_Word16 endpos = delay
+            + (WebRtc_Word16)WEBRTC_SPL_MUL_16_16(factor, (out_length - 1)) + 1;
+
+    if (B_length > MAX_COEF_LENGTH)
+    {
+        return WebRtcSpl_DownsampleFastC(in_ptr, in_length, out_ptr, out_length,
+                                         B, B_length, factor, delay);
+    }
+    if (in_length < endpos)
+    {
+        return -1;
+    }
+
+    // With the coefficients reversed, each output is a plain dot product
+    // with the input samples leading up to it.
+    WebRtcSpl_MemCpyReversedOrder(&B_reversed[B_length - 1], B, B_length);
+
+    for (i = delay; i < endpos; i += factor)
+    {
+        const WebRtc_Word16* x_ptr = &in_ptr[i - B_length + 1];
+        __m128i sum = _mm_setzero_si128();
+        int j;
+
+        for (j = 0; j + 7 < B_length; j += 8)
+        {
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(
+                _mm_loadu_si128((const __m128i*) &B_reversed[j]),
+                _mm_loadu_si128((const __m128i*) &x_ptr[j])));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        o = (WebRtc_Word32)2048 + _mm_cvtsi128_si32(sum); // Round val
+        for (; j < B_length; j++)
+        {
+            o += WEBRTC_SPL_MUL_16_16(B_reversed[j], x_ptr[j]);
+        }
+
+        o = WEBRTC_SPL_RSHIFT_W32(o, 12);
+
+        // If output is higher than 32768, saturate it. Same with negative side
+
+        *downsampled_ptr++ = WebRtcSpl_SatW32ToW16(o);
+    }
+
+    return 0;
+}
+
+#endif  // WEBRTC_USE_SSE2
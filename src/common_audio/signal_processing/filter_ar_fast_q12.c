@@ -10,15 +10,15 @@
 
 
 /*
- * This file contains the function WebRtcSpl_FilterARFastQ12().
+ * This file contains the function WebRtcSpl_FilterARFastQ12C().
  * The description header can be found in signal_processing_library.h
  *
  */
 
 #include "signal_processing_library.h"
 
-void WebRtcSpl_FilterARFastQ12(WebRtc_Word16 *in, WebRtc_Word16 *out, WebRtc_Word16 *A,
-                               WebRtc_Word16 A_length, WebRtc_Word16 length)
+void WebRtcSpl_FilterARFastQ12C(WebRtc_Word16 *in, WebRtc_Word16 *out, WebRtc_Word16 *A,
+                                WebRtc_Word16 A_length, WebRtc_Word16 length)
 {
     WebRtc_Word32 o;
     int i, j;
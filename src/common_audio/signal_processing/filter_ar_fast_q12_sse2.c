@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file contains the function WebRtcSpl_FilterARFastQ12SSE2().
+ * The description header can be found in signal_processing_library.h
+ *
+ */
+
+#include "signal_processing_library.h"
+
+#if defined(WEBRTC_USE_SSE2)
+
+#include <emmintrin.h>
+
+// Longer filters than this are handed to the C version.
+#define MAX_COEF_LENGTH 64
+
+void WebRtcSpl_FilterARFastQ12SSE2(WebRtc_Word16 *in, WebRtc_Word16 *out,
+                                   WebRtc_Word16 *A, WebRtc_Word16 A_length,
+                                   WebRtc_Word16 length)
+{
+    // The coefficients A[1..order] are reversed and zero padded at the front
+    // to whole vectors, so that the feedback of each output is a dot product
+    // with the |num_vectors| * 8 outputs preceding it. Those outputs are kept
+    // in registers and shifted by one sample per output, as reading back the
+    // output just written would stall on the store.
+    WebRtc_Word16 A_reversed[MAX_COEF_LENGTH];
+    WebRtc_Word16 state[MAX_COEF_LENGTH];
+    __m128i coef_vec[MAX_COEF_LENGTH / 8];
+    __m128i state_vec[MAX_COEF_LENGTH / 8];
+    WebRtc_Word32 o;
+    int i, k;
+    const int order = A_length - 1;
+    const int num_vectors = (order + 7) >> 3;
+    const int padding = num_vectors * 8 - order;
+
+    if (order < 8 || order > MAX_COEF_LENGTH)
+    {
+        // Short filters don't fill a vector.
+        WebRtcSpl_FilterARFastQ12C(in, out, A, A_length, length);
+        return;
+    }
+
+    WebRtcSpl_MemSetW16(A_reversed, 0, padding);
+    WebRtcSpl_MemCpyReversedOrder(&A_reversed[padding + order - 1], &A[1],
+                                  order);
+    WebRtcSpl_MemSetW16(state, 0, padding);
+    WEBRTC_SPL_MEMCPY_W16(&state[padding], &out[-order], order);
+    for (k = 0; k < num_vectors; k++)
+    {
+        coef_vec[k] = _mm_loadu_si128((const __m128i*) &A_reversed[8 * k]);
+        state_vec[k] = _mm_loadu_si128((const __m128i*) &state[8 * k]);
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        __m128i sum = _mm_setzero_si128();
+        for (k = 0; k < num_vectors; k++)
+        {
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(coef_vec[k], state_vec[k]));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        o = WEBRTC_SPL_MUL_16_16(in[i], A[0]) - _mm_cvtsi128_si32(sum);
+
+        // Saturate the output
+        o = WEBRTC_SPL_SAT((WebRtc_Word32)134215679, o, (WebRtc_Word32)-134217728);
+
+        out[i] = (WebRtc_Word16)((o + (WebRtc_Word32)2048) >> 12);
+
+        // Shift the new output into the state.
+        for (k = 0; k < num_vectors - 1; k++)
+        {
+            state_vec[k] = _mm_or_si128(_mm_srli_si128(state_vec[k], 2),
+                                        _mm_slli_si128(state_vec[k + 1], 14));
+        }
+        state_vec[k] = _mm_insert_epi16(_mm_srli_si128(state_vec[k], 2),
+                                        out[i], 7);
+    }
+}
+
+#endif  // WEBRTC_USE_SSE2
@@ -177,6 +177,11 @@ extern "C"
 // inline functions:
 #include "spl_inl.h"
 
+// Initialize SPL. Selects the fastest versions of the functions declared
+// below as function pointers (e.g. WebRtcSpl_CrossCorrelation) for the CPU at
+// hand. Until it's called the C versions are used.
+void WebRtcSpl_Init(void);
+
 // Get SPL Version
 WebRtc_Word16 WebRtcSpl_get_version(char* version,
                                     WebRtc_Word16 length_in_bytes);
@@ -268,6 +273,24 @@ void WebRtcSpl_ScaleAndAddVectors(G_CONST WebRtc_Word16* in_vector1,
                                   WebRtc_Word16 gain2, int right_shifts2,
                                   WebRtc_Word16* out_vector,
                                   int vector_length);
+typedef void (*MixVectorsW16)(const WebRtc_Word16* const* in_vectors,
+                              int num_vectors,
+                              int right_shifts,
+                              WebRtc_Word16* out_vector,
+                              int vector_length);
+extern MixVectorsW16 WebRtcSpl_MixVectorsW16;
+void WebRtcSpl_MixVectorsW16C(const WebRtc_Word16* const* in_vectors,
+                              int num_vectors,
+                              int right_shifts,
+                              WebRtc_Word16* out_vector,
+                              int vector_length);
+#if defined(WEBRTC_USE_SSE2)
+void WebRtcSpl_MixVectorsW16SSE2(const WebRtc_Word16* const* in_vectors,
+                                 int num_vectors,
+                                 int right_shifts,
+                                 WebRtc_Word16* out_vector,
+                                 int vector_length);
+#endif
 // End: Vector scaling operations.
 
 // iLBC specific functions. Implementations in ilbc_specific_functions.c.
@@ -326,13 +349,30 @@ void WebRtcSpl_LpcToReflCoef(WebRtc_Word16* lpc_coef,
 void WebRtcSpl_AutoCorrToReflCoef(G_CONST WebRtc_Word32* auto_corr,
                                   int use_order,
                                   WebRtc_Word16* refl_coef);
-void WebRtcSpl_CrossCorrelation(WebRtc_Word32* cross_corr,
-                                WebRtc_Word16* vector1,
-                                WebRtc_Word16* vector2,
-                                WebRtc_Word16 dim_vector,
-                                WebRtc_Word16 dim_cross_corr,
-                                WebRtc_Word16 right_shifts,
-                                WebRtc_Word16 step_vector2);
+typedef void (*CrossCorrelation)(WebRtc_Word32* cross_corr,
+                                 WebRtc_Word16* vector1,
+                                 WebRtc_Word16* vector2,
+                                 WebRtc_Word16 dim_vector,
+                                 WebRtc_Word16 dim_cross_corr,
+                                 WebRtc_Word16 right_shifts,
+                                 WebRtc_Word16 step_vector2);
+extern CrossCorrelation WebRtcSpl_CrossCorrelation;
+void WebRtcSpl_CrossCorrelationC(WebRtc_Word32* cross_corr,
+                                 WebRtc_Word16* vector1,
+                                 WebRtc_Word16* vector2,
+                                 WebRtc_Word16 dim_vector,
+                                 WebRtc_Word16 dim_cross_corr,
+                                 WebRtc_Word16 right_shifts,
+                                 WebRtc_Word16 step_vector2);
+#if defined(WEBRTC_USE_SSE2)
+void WebRtcSpl_CrossCorrelationSSE2(WebRtc_Word32* cross_corr,
+                                    WebRtc_Word16* vector1,
+                                    WebRtc_Word16* vector2,
+                                    WebRtc_Word16 dim_vector,
+                                    WebRtc_Word16 dim_cross_corr,
+                                    WebRtc_Word16 right_shifts,
+                                    WebRtc_Word16 step_vector2);
+#endif
 void WebRtcSpl_GetHanningWindow(WebRtc_Word16* window, WebRtc_Word16 size);
 void WebRtcSpl_SqrtOfOneMinusXSquared(WebRtc_Word16* in_vector,
                                       int vector_length,
@@ -367,10 +407,21 @@ WebRtc_Word32 WebRtcSpl_Energy(WebRtc_Word16* vector,
                                int vector_length,
                                int* scale_factor);
 
-WebRtc_Word32 WebRtcSpl_DotProductWithScale(WebRtc_Word16* vector1,
-                                            WebRtc_Word16* vector2,
-                                            int vector_length,
-                                            int scaling);
+typedef WebRtc_Word32 (*DotProductWithScale)(WebRtc_Word16* vector1,
+                                              WebRtc_Word16* vector2,
+                                              int vector_length,
+                                              int scaling);
+extern DotProductWithScale WebRtcSpl_DotProductWithScale;
+WebRtc_Word32 WebRtcSpl_DotProductWithScaleC(WebRtc_Word16* vector1,
+                                             WebRtc_Word16* vector2,
+                                             int vector_length,
+                                             int scaling);
+#if defined(WEBRTC_USE_SSE2)
+WebRtc_Word32 WebRtcSpl_DotProductWithScaleSSE2(WebRtc_Word16* vector1,
+                                                WebRtc_Word16* vector2,
+                                                int vector_length,
+                                                int scaling);
+#endif
 
 // Filter operations.
 int WebRtcSpl_FilterAR(G_CONST WebRtc_Word16* ar_coef, int ar_coef_length,
@@ -385,19 +436,51 @@ void WebRtcSpl_FilterMAFastQ12(WebRtc_Word16* in_vector,
                                WebRtc_Word16* ma_coef,
                                WebRtc_Word16 ma_coef_length,
                                WebRtc_Word16 vector_length);
-void WebRtcSpl_FilterARFastQ12(WebRtc_Word16* in_vector,
-                               WebRtc_Word16* out_vector,
-                               WebRtc_Word16* ar_coef,
-                               WebRtc_Word16 ar_coef_length,
-                               WebRtc_Word16 vector_length);
-int WebRtcSpl_DownsampleFast(WebRtc_Word16* in_vector,
-                             WebRtc_Word16 in_vector_length,
-                             WebRtc_Word16* out_vector,
-                             WebRtc_Word16 out_vector_length,
-                             WebRtc_Word16* ma_coef,
-                             WebRtc_Word16 ma_coef_length,
-                             WebRtc_Word16 factor,
-                             WebRtc_Word16 delay);
+typedef void (*FilterARFastQ12)(WebRtc_Word16* in_vector,
+                                WebRtc_Word16* out_vector,
+                                WebRtc_Word16* ar_coef,
+                                WebRtc_Word16 ar_coef_length,
+                                WebRtc_Word16 vector_length);
+extern FilterARFastQ12 WebRtcSpl_FilterARFastQ12;
+void WebRtcSpl_FilterARFastQ12C(WebRtc_Word16* in_vector,
+                                WebRtc_Word16* out_vector,
+                                WebRtc_Word16* ar_coef,
+                                WebRtc_Word16 ar_coef_length,
+                                WebRtc_Word16 vector_length);
+#if defined(WEBRTC_USE_SSE2)
+void WebRtcSpl_FilterARFastQ12SSE2(WebRtc_Word16* in_vector,
+                                   WebRtc_Word16* out_vector,
+                                   WebRtc_Word16* ar_coef,
+                                   WebRtc_Word16 ar_coef_length,
+                                   WebRtc_Word16 vector_length);
+#endif
+typedef int (*DownsampleFast)(WebRtc_Word16* in_vector,
+                              WebRtc_Word16 in_vector_length,
+                              WebRtc_Word16* out_vector,
+                              WebRtc_Word16 out_vector_length,
+                              WebRtc_Word16* ma_coef,
+                              WebRtc_Word16 ma_coef_length,
+                              WebRtc_Word16 factor,
+                              WebRtc_Word16 delay);
+extern DownsampleFast WebRtcSpl_DownsampleFast;
+int WebRtcSpl_DownsampleFastC(WebRtc_Word16* in_vector,
+                              WebRtc_Word16 in_vector_length,
+                              WebRtc_Word16* out_vector,
+                              WebRtc_Word16 out_vector_length,
+                              WebRtc_Word16* ma_coef,
+                              WebRtc_Word16 ma_coef_length,
+                              WebRtc_Word16 factor,
+                              WebRtc_Word16 delay);
+#if defined(WEBRTC_USE_SSE2)
+int WebRtcSpl_DownsampleFastSSE2(WebRtc_Word16* in_vector,
+                                 WebRtc_Word16 in_vector_length,
+                                 WebRtc_Word16* out_vector,
+                                 WebRtc_Word16 out_vector_length,
+                                 WebRtc_Word16* ma_coef,
+                                 WebRtc_Word16 ma_coef_length,
+                                 WebRtc_Word16 factor,
+                                 WebRtc_Word16 delay);
+#endif
 // End: Filter operations.
 
 // FFT operations
@@ -948,6 +1031,26 @@ void WebRtcSpl_SynthesisQMF(const WebRtc_Word16* low_band,
 //      - out_vector    : Output vector
 //
 
+//
+// WebRtcSpl_MixVectorsW16(...)
+//
+// Mixes |num_vectors| vectors into one. The sum is accumulated in 32 bits and
+// saturated only once, so the result does not depend on the order of the
+// input vectors:
+//  out_vector[k] = SATURATE( sum_j (in_vectors[j][k]>>right_shifts) )
+//
+// Input:
+//      - in_vectors    : Array of |num_vectors| pointers to input vectors
+//      - num_vectors   : Number of input vectors
+//      - right_shifts  : Number of right bit shifts applied to every input
+//                        sample (must be >= 0)
+//      - vector_length : Elements in each of the input vectors
+//
+// Output:
+//      - out_vector    : Output vector (can be the same as one of the input
+//                        vectors)
+//
+
 //
 // WebRtcSpl_ScaleAndAddVectorsWithRound(...)
 //
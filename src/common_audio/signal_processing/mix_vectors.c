@@ -0,0 +1,37 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file contains the function WebRtcSpl_MixVectorsW16C().
+ * The description header can be found in signal_processing_library.h
+ *
+ */
+
+#include "signal_processing_library.h"
+
+void WebRtcSpl_MixVectorsW16C(const WebRtc_Word16* const* in_vectors,
+                              int num_vectors,
+                              int right_shifts,
+                              WebRtc_Word16* out_vector,
+                              int vector_length)
+{
+    int i, j;
+
+    for (i = 0; i < vector_length; i++)
+    {
+        WebRtc_Word32 sum = 0;
+        for (j = 0; j < num_vectors; j++)
+        {
+            sum += in_vectors[j][i] >> right_shifts;
+        }
+        out_vector[i] = WebRtcSpl_SatW32ToW16(sum);
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file contains the function WebRtcSpl_MixVectorsW16SSE2().
+ * The description header can be found in signal_processing_library.h
+ *
+ */
+
+#include "signal_processing_library.h"
+
+#if defined(WEBRTC_USE_SSE2)
+
+#include <emmintrin.h>
+
+void WebRtcSpl_MixVectorsW16SSE2(const WebRtc_Word16* const* in_vectors,
+                                 int num_vectors,
+                                 int right_shifts,
+                                 WebRtc_Word16* out_vector,
+                                 int vector_length)
+{
+    // Interleaving a sample with itself and shifting the 32-bit result right
+    // by 16 sign extends it; the extra |right_shifts| scale it at no cost.
+    const __m128i shift = _mm_cvtsi32_si128(16 + right_shifts);
+    int i = 0;
+    int j;
+
+    // Each block of eight outputs is kept in two 32-bit accumulators while
+    // all the inputs are added, and saturated once when it is stored.
+    for (; i + 8 <= vector_length; i += 8)
+    {
+        __m128i sum_low = _mm_setzero_si128();
+        __m128i sum_high = _mm_setzero_si128();
+        for (j = 0; j < num_vectors; j++)
+        {
+            const __m128i in = _mm_loadu_si128(
+                (const __m128i*) &in_vectors[j][i]);
+            sum_low = _mm_add_epi32(sum_low,
+                                    _mm_sra_epi32(_mm_unpacklo_epi16(in, in),
+                                                  shift));
+            sum_high = _mm_add_epi32(sum_high,
+                                     _mm_sra_epi32(_mm_unpackhi_epi16(in, in),
+                                                   shift));
+        }
+        _mm_storeu_si128((__m128i*) &out_vector[i],
+                         _mm_packs_epi32(sum_low, sum_high));
+    }
+
+    for (; i < vector_length; i++)
+    {
+        WebRtc_Word32 sum = 0;
+        for (j = 0; j < num_vectors; j++)
+        {
+            sum += in_vectors[j][i] >> right_shifts;
+        }
+        out_vector[i] = WebRtcSpl_SatW32ToW16(sum);
+    }
+}
+
+#endif  // WEBRTC_USE_SSE2
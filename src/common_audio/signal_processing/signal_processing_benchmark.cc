@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Times the C and the optimized versions of the dispatched SPL kernels on
+// typical input sizes and prints the time per call.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "signal_processing_library.h"
+#include "system_wrappers/interface/tick_util.h"
+
+namespace {
+
+const int kIterations = 100000;
+const int kLength = 480;
+const int kOrder = 16;
+// 10 ms at 32 kHz, and the largest number of streams mixed.
+const int kMixLength = 320;
+const int kMaxMixStreams = 64;
+
+WebRtc_Word16 g_vector1[kOrder + kLength];
+WebRtc_Word16 g_vector2[kOrder + kLength];
+WebRtc_Word16 g_coef[kOrder + 1];
+WebRtc_Word16 g_out16[kOrder + kLength];
+WebRtc_Word32 g_out32[kLength];
+WebRtc_Word16 g_streams[kMaxMixStreams][kMixLength];
+const WebRtc_Word16* g_stream_ptrs[kMaxMixStreams];
+// Keeps the compiler from dropping calls whose result is unused.
+volatile WebRtc_Word32 g_sink;
+
+class KernelTimer {
+ public:
+  KernelTimer(const char* name, int iterations)
+      : name_(name),
+        iterations_(iterations),
+        c_us_(0) {}
+
+  int iterations() const { return iterations_; }
+
+  void Start() {
+    start_ = webrtc::TickTime::Now();
+  }
+
+  // Ends the timing of the C version if |c_version| is true, otherwise of
+  // the optimized version, in which case the result is printed.
+  void Stop(bool c_version) {
+    const double us = static_cast<double>(
+        (webrtc::TickTime::Now() - start_).Microseconds()) / iterations_;
+    if (c_version) {
+      c_us_ = us;
+      return;
+    }
+    printf("%-28s C: %8.3f us  optimized: %8.3f us  speedup: %5.2fx\n",
+           name_, c_us_, us, us > 0 ? c_us_ / us : 0.0);
+  }
+
+ private:
+  const char* name_;
+  const int iterations_;
+  double c_us_;
+  webrtc::TickTime start_;
+};
+
+void BenchmarkDotProductWithScale(DotProductWithScale function, int scaling,
+                                  KernelTimer* timer, bool c_version) {
+  timer->Start();
+  for (int i = 0; i < timer->iterations(); ++i) {
+    g_sink = function(g_vector1, g_vector2, kLength, scaling);
+  }
+  timer->Stop(c_version);
+}
+
+void BenchmarkCrossCorrelation(CrossCorrelation function, KernelTimer* timer,
+                               bool c_version) {
+  // Sizes used by the NetEQ correlator.
+  timer->Start();
+  for (int i = 0; i < timer->iterations(); ++i) {
+    function(g_out32, g_vector1, g_vector2, 60, 54, 2, 1);
+  }
+  timer->Stop(c_version);
+}
+
+void BenchmarkDownsampleFast(DownsampleFast function, KernelTimer* timer,
+                             bool c_version) {
+  timer->Start();
+  for (int i = 0; i < timer->iterations(); ++i) {
+    function(&g_vector1[kOrder], kLength, g_out16, (kLength - kOrder) / 4,
+             g_coef, kOrder + 1, 4, kOrder);
+  }
+  timer->Stop(c_version);
+}
+
+void BenchmarkFilterARFastQ12(FilterARFastQ12 function, KernelTimer* timer,
+                              bool c_version) {
+  timer->Start();
+  for (int i = 0; i < timer->iterations(); ++i) {
+    function(g_vector1, &g_out16[kOrder], g_coef, kOrder + 1, kLength);
+  }
+  timer->Stop(c_version);
+}
+
+// How AudioFrame mixing used to work: every stream is halved and added with
+// saturation, one stream at a time.
+void SequentialMix(const WebRtc_Word16* const* in_vectors, int num_vectors,
+                   int right_shifts, WebRtc_Word16* out_vector,
+                   int vector_length) {
+  memset(out_vector, 0, vector_length * sizeof(*out_vector));
+  for (int j = 0; j < num_vectors; ++j) {
+    for (int i = 0; i < vector_length; ++i) {
+      out_vector[i] = WebRtcSpl_AddSatW16(out_vector[i],
+                                          in_vectors[j][i] >> right_shifts);
+    }
+  }
+}
+
+double TimeMix(MixVectorsW16 function, int num_streams, int iterations) {
+  const webrtc::TickTime start = webrtc::TickTime::Now();
+  for (int i = 0; i < iterations; ++i) {
+    function(g_stream_ptrs, num_streams, 1, g_out16, kMixLength);
+  }
+  return static_cast<double>(
+      (webrtc::TickTime::Now() - start).Microseconds()) / iterations;
+}
+
+void BenchmarkMixVectors(int num_streams) {
+  const int iterations = kIterations * 3 / num_streams;
+  const double sequential_us = TimeMix(SequentialMix, num_streams,
+                                       iterations);
+  const double c_us = TimeMix(WebRtcSpl_MixVectorsW16C, num_streams,
+                              iterations);
+  const double optimized_us = TimeMix(WebRtcSpl_MixVectorsW16, num_streams,
+                                      iterations);
+  printf("MixVectorsW16, %2d streams    sequential: %7.3f us  C: %7.3f us  "
+         "optimized: %7.3f us\n", num_streams, sequential_us, c_us,
+         optimized_us);
+}
+
+}  // namespace
+
+int main(int /*argc*/, char** /*argv*/) {
+  WebRtc_UWord32 seed = 1;
+  for (int i = 0; i < kOrder + kLength; ++i) {
+    g_vector1[i] = WebRtcSpl_RandN(&seed);
+    g_vector2[i] = WebRtcSpl_RandN(&seed);
+    g_out16[i] = 0;
+  }
+  for (int j = 0; j < kMaxMixStreams; ++j) {
+    for (int i = 0; i < kMixLength; ++i) {
+      g_streams[j][i] = WebRtcSpl_RandN(&seed);
+    }
+    g_stream_ptrs[j] = g_streams[j];
+  }
+  g_coef[0] = 4096;
+  for (int i = 1; i <= kOrder; ++i) {
+    g_coef[i] = WebRtcSpl_RandN(&seed) >> 6;
+  }
+
+  WebRtcSpl_Init();
+  if (WebRtcSpl_DotProductWithScale == WebRtcSpl_DotProductWithScaleC) {
+    printf("No optimized versions available on this CPU.\n");
+  }
+
+  KernelTimer dot0("DotProductWithScale(0)", kIterations);
+  BenchmarkDotProductWithScale(WebRtcSpl_DotProductWithScaleC, 0, &dot0, true);
+  BenchmarkDotProductWithScale(WebRtcSpl_DotProductWithScale, 0, &dot0, false);
+
+  KernelTimer dot2("DotProductWithScale(2)", kIterations);
+  BenchmarkDotProductWithScale(WebRtcSpl_DotProductWithScaleC, 2, &dot2, true);
+  BenchmarkDotProductWithScale(WebRtcSpl_DotProductWithScale, 2, &dot2, false);
+
+  KernelTimer cross("CrossCorrelation", kIterations / 10);
+  BenchmarkCrossCorrelation(WebRtcSpl_CrossCorrelationC, &cross, true);
+  BenchmarkCrossCorrelation(WebRtcSpl_CrossCorrelation, &cross, false);
+
+  KernelTimer down("DownsampleFast", kIterations);
+  BenchmarkDownsampleFast(WebRtcSpl_DownsampleFastC, &down, true);
+  BenchmarkDownsampleFast(WebRtcSpl_DownsampleFast, &down, false);
+
+  KernelTimer ar("FilterARFastQ12", kIterations / 10);
+  BenchmarkFilterARFastQ12(WebRtcSpl_FilterARFastQ12C, &ar, true);
+  BenchmarkFilterARFastQ12(WebRtcSpl_FilterARFastQ12, &ar, false);
+
+  const int mix_streams[] = {3, 8, 16, 32, 64};
+  for (size_t i = 0; i < sizeof(mix_streams) / sizeof(*mix_streams); ++i) {
+    BenchmarkMixVectors(mix_streams[i]);
+  }
+  return 0;
+}
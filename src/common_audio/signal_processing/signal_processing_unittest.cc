@@ -295,6 +295,25 @@ TEST_F(SplTest, VectorOperationsTest) {
         EXPECT_EQ(((a16[kk]*13)>>2)+((b16[kk]*7)>>2), bTmp16[kk]);
     }
 
+    // Saturation is applied to the sum, not after every addition.
+    WebRtc_Word16 loud16[kVectorSize] = {20000, 32767, -32768, 30000};
+    WebRtc_Word16 quiet16[kVectorSize] = {-32768, 100, -100, 10000};
+    const WebRtc_Word16* mix[] = {loud16, loud16, quiet16, a16};
+    WebRtcSpl_MixVectorsW16(mix, 4, 0, bTmp16, kVectorSize);
+    EXPECT_EQ(20000 + 20000 - 32768 + B[0], bTmp16[0]);
+    EXPECT_EQ(32767, bTmp16[1]);
+    EXPECT_EQ(-32768, bTmp16[2]);
+    EXPECT_EQ(32767, bTmp16[3]);
+    WebRtcSpl_MixVectorsW16(mix, 4, 1, bTmp16, kVectorSize);
+    for (int kk = 0; kk < kVectorSize; ++kk) {
+        EXPECT_EQ(WebRtcSpl_SatW32ToW16((loud16[kk] >> 1) * 2 +
+            (quiet16[kk] >> 1) + (a16[kk] >> 1)), bTmp16[kk]);
+    }
+    WebRtcSpl_MixVectorsW16(mix, 0, 0, bTmp16, kVectorSize);
+    for (int kk = 0; kk < kVectorSize; ++kk) {
+        EXPECT_EQ(0, bTmp16[kk]);
+    }
+
     WebRtcSpl_AddVectorsAndShift(bTmp16, a16, b16, kVectorSize, 2);
     for (int kk = 0; kk < kVectorSize; ++kk) {
         EXPECT_EQ(B[kk] >> 1, bTmp16[kk]);
@@ -371,6 +390,109 @@ TEST_F(SplTest, FilterTest) {
                                               kVectorSize));
 }
 
+#if defined(WEBRTC_USE_SSE2)
+TEST_F(SplTest, SSE2MatchesCTest) {
+    const int kMaxLength = 300;
+    const int kMaxOrder = 20;
+    // Room for the filter states in front of the vectors.
+    WebRtc_Word16 a16[kMaxOrder + kMaxLength];
+    WebRtc_Word16 b16[kMaxOrder + kMaxLength];
+    WebRtc_Word16 coef[kMaxOrder + 1];
+    WebRtc_Word16 out_c[kMaxOrder + kMaxLength];
+    WebRtc_Word16 out_sse2[kMaxOrder + kMaxLength];
+    WebRtc_Word32 corr_c[kMaxOrder];
+    WebRtc_Word32 corr_sse2[kMaxOrder];
+    WebRtc_UWord32 seed = 12345;
+
+    // Full scale values make sure the 32-bit sums wrap the same way.
+    for (int kk = 0; kk < kMaxOrder + kMaxLength; ++kk) {
+        a16[kk] = WebRtcSpl_RandU(&seed) * 2 - 32768;
+        b16[kk] = WebRtcSpl_RandN(&seed);
+    }
+    a16[0] = -32768;
+    b16[0] = -32768;
+
+    for (int length = 0; length < 40; ++length) {
+        for (int scaling = 0; scaling < 3; ++scaling) {
+            EXPECT_EQ(WebRtcSpl_DotProductWithScaleC(a16, b16, length, scaling),
+                      WebRtcSpl_DotProductWithScaleSSE2(a16, b16, length,
+                                                        scaling));
+        }
+    }
+
+    for (int step = -1; step <= 1; step += 2) {
+        WebRtc_Word16* seq2 = step > 0 ? b16 : &b16[kMaxOrder + kMaxLength - 1];
+        for (int shifts = 0; shifts < 7; shifts += 3) {
+            WebRtcSpl_CrossCorrelationC(corr_c, a16, seq2 - (step < 0 ? 160 : 0),
+                                        160, kMaxOrder, shifts, step);
+            WebRtcSpl_CrossCorrelationSSE2(corr_sse2, a16,
+                                           seq2 - (step < 0 ? 160 : 0), 160,
+                                           kMaxOrder, shifts, step);
+            for (int kk = 0; kk < kMaxOrder; ++kk) {
+                EXPECT_EQ(corr_c[kk], corr_sse2[kk]);
+            }
+        }
+    }
+
+    for (int order = 0; order <= kMaxOrder; order += 5) {
+        for (int kk = 0; kk <= order; ++kk) {
+            coef[kk] = (WebRtcSpl_RandN(&seed) >> 4) + (kk == 0 ? 4096 : 0);
+        }
+        // Same filter state, different output buffers.
+        WEBRTC_SPL_MEMCPY_W16(out_c, b16, kMaxOrder);
+        WEBRTC_SPL_MEMCPY_W16(out_sse2, b16, kMaxOrder);
+        WebRtcSpl_FilterARFastQ12C(&a16[kMaxOrder], &out_c[kMaxOrder], coef,
+                                   order + 1, kMaxLength);
+        WebRtcSpl_FilterARFastQ12SSE2(&a16[kMaxOrder], &out_sse2[kMaxOrder],
+                                      coef, order + 1, kMaxLength);
+        for (int kk = 0; kk < kMaxLength; ++kk) {
+            EXPECT_EQ(out_c[kMaxOrder + kk], out_sse2[kMaxOrder + kk]);
+        }
+
+        for (int factor = 1; factor <= 4; ++factor) {
+            const int out_length = (kMaxLength - order) / factor;
+            EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(&a16[kMaxOrder], kMaxLength,
+                out_c, out_length, coef, order + 1, factor, order));
+            EXPECT_EQ(0, WebRtcSpl_DownsampleFastSSE2(&a16[kMaxOrder],
+                kMaxLength, out_sse2, out_length, coef, order + 1, factor,
+                order));
+            for (int kk = 0; kk < out_length; ++kk) {
+                EXPECT_EQ(out_c[kk], out_sse2[kk]);
+            }
+        }
+    }
+    EXPECT_EQ(-1, WebRtcSpl_DownsampleFastSSE2(a16, 10, out_sse2, 10, coef, 4,
+                                               2, 0));
+
+    // Inputs at arbitrary offsets so that the loads are unaligned.
+    const int kMaxVectors = 9;
+    const WebRtc_Word16* mix[kMaxVectors];
+    for (int kk = 0; kk < kMaxVectors; ++kk) {
+        mix[kk] = (kk % 2 ? a16 : b16) + kk;
+    }
+    for (int num_vectors = 0; num_vectors <= kMaxVectors; num_vectors += 3) {
+        for (int shifts = 0; shifts < 3; ++shifts) {
+            for (int length = 0; length < 40; length += 13) {
+                WebRtcSpl_MixVectorsW16C(mix, num_vectors, shifts, out_c,
+                                         length);
+                WebRtcSpl_MixVectorsW16SSE2(mix, num_vectors, shifts,
+                                            out_sse2, length);
+                for (int kk = 0; kk < length; ++kk) {
+                    EXPECT_EQ(out_c[kk], out_sse2[kk]);
+                }
+            }
+        }
+    }
+}
+#endif
+
+TEST_F(SplTest, InitTest) {
+    WebRtcSpl_Init();
+    WebRtc_Word16 A[] = {1, 2, 33, 100, 1, 2, 33, 100, 1, 2};
+    EXPECT_EQ(WebRtcSpl_DotProductWithScaleC(A, A, 10, 1),
+              WebRtcSpl_DotProductWithScale(A, A, 10, 1));
+}
+
 TEST_F(SplTest, RandTest) {
     const int kVectorSize = 4;
     WebRtc_Word16 BU[] = {3653, 12446, 8525, 30691};
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file contains the function WebRtcSpl_Init() and the function pointers
+ * it assigns. The description header can be found in
+ * signal_processing_library.h
+ *
+ */
+
+#include "signal_processing_library.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
+
+// The C versions are used until WebRtcSpl_Init() is called.
+CrossCorrelation WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationC;
+DotProductWithScale WebRtcSpl_DotProductWithScale =
+    WebRtcSpl_DotProductWithScaleC;
+DownsampleFast WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
+FilterARFastQ12 WebRtcSpl_FilterARFastQ12 = WebRtcSpl_FilterARFastQ12C;
+MixVectorsW16 WebRtcSpl_MixVectorsW16 = WebRtcSpl_MixVectorsW16C;
+
+void WebRtcSpl_Init(void)
+{
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationC;
+    WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
+    WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
+    WebRtcSpl_FilterARFastQ12 = WebRtcSpl_FilterARFastQ12C;
+    WebRtcSpl_MixVectorsW16 = WebRtcSpl_MixVectorsW16C;
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+#if defined(WEBRTC_USE_SSE2)
+        WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+        WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleSSE2;
+        WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+        WebRtcSpl_FilterARFastQ12 = WebRtcSpl_FilterARFastQ12SSE2;
+        WebRtcSpl_MixVectorsW16 = WebRtcSpl_MixVectorsW16SSE2;
+#endif
+    }
+}
@@ -81,6 +81,8 @@ WebRtc_Word16 WebRtcIsacfix_Create(ISACFIX_MainStruct **ISAC_main_inst)
   tempo = malloc(1 * sizeof(ISACFIX_SubStruct));
   *ISAC_main_inst = (ISACFIX_MainStruct *)tempo;
   if (*ISAC_main_inst!=NULL) {
+    /* Select the fastest signal processing functions for this CPU */
+    WebRtcSpl_Init();
     (*(ISACFIX_SubStruct**)ISAC_main_inst)->errorcode = 0;
     (*(ISACFIX_SubStruct**)ISAC_main_inst)->initflag = 0;
     (*(ISACFIX_SubStruct**)ISAC_main_inst)->ISACenc_obj.SaveEnc_ptr = NULL;
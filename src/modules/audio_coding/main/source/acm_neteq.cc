@@ -13,6 +13,7 @@
 #include <stdlib.h>  // malloc
 #include <vector>
 
+#include "acm_common_defs.h"
 #include "acm_neteq.h"
 #include "common_types.h"
 #include "critical_section_wrapper.h"
@@ -34,57 +35,60 @@ namespace webrtc
 
 ACMNetEQ::ACMNetEQ()
 :
+_inst(NULL),
+_instMem(NULL),
+_netEqPacketBuffer(NULL),
 _id(0),
 _currentSampFreqKHz(NETEQ_INIT_FREQ_KHZ),
 _avtPlayout(false),
 _playoutMode(voice),
 _netEqCritSect(CriticalSectionWrapper::CreateCriticalSection()),
+_ptrVADInst(NULL),
 _vadStatus(false),
 _vadMode(VADNormal),
 _decodeLock(RWLockWrapper::CreateRWLock()),
+_isInitialized(false),
 _numSlaves(0),
 _receivedStereo(false),
-_masterSlaveInfo(NULL),
+_channelMem(NULL),
+_stereoPayload(NULL),
+_stereoPayloadLength(0),
+_stereoSequenceNumber(0),
+_stereoTimestamp(0),
 _previousAudioActivity(AudioFrame::kVadUnknown),
 _extraDelay(0),
 _callbackCritSect(CriticalSectionWrapper::CreateCriticalSection())
 {
-    for(int n = 0; n < MAX_NUM_SLAVE_NETEQ + 1; n++)
-    {
-        _isInitialized[n]     = false;
-        _ptrVADInst[n]        = NULL;
-        _inst[n]              = NULL;
-        _instMem[n]           = NULL;
-        _netEqPacketBuffer[n] = NULL;
-    }
 }
 
 ACMNetEQ::~ACMNetEQ()
 {
     {
         CriticalSectionScoped lock(*_netEqCritSect);
-        for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+        if (_instMem != NULL)
         {
-            if (_instMem[idx] != NULL)
-            {
-                free(_instMem[idx]);
-                _instMem[idx] = NULL;
-            }
-            if (_netEqPacketBuffer[idx] != NULL)
-            {
-                free(_netEqPacketBuffer[idx]);
-                _netEqPacketBuffer[idx] = NULL;
-            }
-            if(_ptrVADInst[idx] != NULL)
-            {
-                WebRtcVad_Free(_ptrVADInst[idx]);
-                _ptrVADInst[idx] = NULL;
-            }
+            free(_instMem);
+            _instMem = NULL;
         }
-        if(_masterSlaveInfo != NULL)
+        if (_netEqPacketBuffer != NULL)
         {
-            free(_masterSlaveInfo);
-            _masterSlaveInfo = NULL;
+            free(_netEqPacketBuffer);
+            _netEqPacketBuffer = NULL;
+        }
+        if(_ptrVADInst != NULL)
+        {
+            WebRtcVad_Free(_ptrVADInst);
+            _ptrVADInst = NULL;
+        }
+        if(_channelMem != NULL)
+        {
+            free(_channelMem);
+            _channelMem = NULL;
+        }
+        if(_stereoPayload != NULL)
+        {
+            free(_stereoPayload);
+            _stereoPayload = NULL;
         }
     }
     if(_netEqCritSect != NULL)
@@ -108,43 +112,54 @@ ACMNetEQ::Init()
 {
     CriticalSectionScoped lock(*_netEqCritSect);
 
-    for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+    // The instance is recreated below, without the slave channel.
+    _numSlaves = 0;
+    _stereoPayloadLength = 0;
+    if(_channelMem != NULL)
     {
-        if(InitByIdxSafe(idx) < 0)
-        {
-            return -1;
-        }
-        // delete VAD instance and start fresh if required.
-        if(_ptrVADInst[idx] != NULL)
-        {
-            WebRtcVad_Free(_ptrVADInst[idx]);
-            _ptrVADInst[idx] = NULL;
-        }
-        if(_vadStatus)
+        free(_channelMem);
+        _channelMem = NULL;
+    }
+    if(_stereoPayload != NULL)
+    {
+        free(_stereoPayload);
+        _stereoPayload = NULL;
+    }
+
+    if(InitSafe() < 0)
+    {
+        return -1;
+    }
+    // delete VAD instance and start fresh if required.
+    if(_ptrVADInst != NULL)
+    {
+        WebRtcVad_Free(_ptrVADInst);
+        _ptrVADInst = NULL;
+    }
+    if(_vadStatus)
+    {
+        // Has to enable VAD
+        if(EnableVADSafe() < 0)
         {
-            // Has to enable VAD
-            if(EnableVADByIdxSafe(idx) < 0)
+            // Failed to enable VAD.
+            // Delete VAD instance, if it is created
+            if(_ptrVADInst != NULL)
             {
-                // Failed to enable VAD.
-                // Delete VAD instance, if it is created
-                if(_ptrVADInst[idx] != NULL)
-                {
-                    WebRtcVad_Free(_ptrVADInst[idx]);
-                    _ptrVADInst[idx] = NULL;
-                }
-                // We are at initialization of NetEq, if failed to
-                // enable VAD, we delete the NetEq instance.
-                if (_instMem[idx] != NULL) {
-                    free(_instMem[idx]);
-                    _instMem[idx] = NULL;
-                    _inst[idx] = NULL;
-                }
-                _isInitialized[idx] = false;
-                return -1;
+                WebRtcVad_Free(_ptrVADInst);
+                _ptrVADInst = NULL;
+            }
+            // We are at initialization of NetEq, if failed to
+            // enable VAD, we delete the NetEq instance.
+            if (_instMem != NULL) {
+                free(_instMem);
+                _instMem = NULL;
+                _inst = NULL;
             }
+            _isInitialized = false;
+            return -1;
         }
-        _isInitialized[idx] = true;
     }
+    _isInitialized = true;
     if (EnableVAD() == -1)
     {
         return -1;
@@ -153,88 +168,86 @@ ACMNetEQ::Init()
 }
 
 WebRtc_Word16
-ACMNetEQ::InitByIdxSafe(
-    const WebRtc_Word16 idx)
+ACMNetEQ::InitSafe()
 {
     int memorySizeBytes;
     if (WebRtcNetEQ_AssignSize(&memorySizeBytes) != 0)
     {
-        LogError("AssignSize", idx);
+        LogError("AssignSize");
         return -1;
     }
 
-    if(_instMem[idx] != NULL)
+    if(_instMem != NULL)
     {
-        free(_instMem[idx]);
-        _instMem[idx] = NULL;
+        free(_instMem);
+        _instMem = NULL;
     }
-    _instMem[idx] = malloc(memorySizeBytes);
-    if (_instMem[idx] == NULL)
+    _instMem = malloc(memorySizeBytes);
+    if (_instMem == NULL)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-            "InitByIdxSafe: NetEq Initialization error: could not allocate memory for NetEq");
-        _isInitialized[idx] = false;
+            "InitSafe: NetEq Initialization error: could not allocate memory for NetEq");
+        _isInitialized = false;
         return -1;
     }
-    if (WebRtcNetEQ_Assign(&_inst[idx], _instMem[idx]) != 0)
+    if (WebRtcNetEQ_Assign(&_inst, _instMem) != 0)
     {
-        if (_instMem[idx] != NULL) {
-            free(_instMem[idx]);
-            _instMem[idx] = NULL;
+        if (_instMem != NULL) {
+            free(_instMem);
+            _instMem = NULL;
         }
-        LogError("Assign", idx);
+        LogError("Assign");
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-            "InitByIdxSafe: NetEq Initialization error: could not Assign");
-        _isInitialized[idx] = false;
+            "InitSafe: NetEq Initialization error: could not Assign");
+        _isInitialized = false;
         return -1;
     }
-    if (WebRtcNetEQ_Init(_inst[idx], NETEQ_INIT_FREQ) != 0)
+    if (WebRtcNetEQ_Init(_inst, NETEQ_INIT_FREQ) != 0)
     {
-        if (_instMem[idx] != NULL) {
-            free(_instMem[idx]);
-            _instMem[idx] = NULL;
+        if (_instMem != NULL) {
+            free(_instMem);
+            _instMem = NULL;
         }
-        LogError("Init", idx);
+        LogError("Init");
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-            "InitByIdxSafe: NetEq Initialization error: could not initialize NetEq");
-        _isInitialized[idx] = false;
+            "InitSafe: NetEq Initialization error: could not initialize NetEq");
+        _isInitialized = false;
         return -1;
     }
-    _isInitialized[idx] = true;
+    _isInitialized = true;
     return 0;
 }
 
 WebRtc_Word16
-ACMNetEQ::EnableVADByIdxSafe(
-    const WebRtc_Word16 idx)
+ACMNetEQ::EnableVADSafe()
 {
-    if(_ptrVADInst[idx] == NULL)
+    if(_ptrVADInst == NULL)
     {
-        if(WebRtcVad_Create(&_ptrVADInst[idx]) < 0)
+        if(WebRtcVad_Create(&_ptrVADInst) < 0)
         {
-            _ptrVADInst[idx] = NULL;
+            _ptrVADInst = NULL;
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "EnableVADByIdxSafe: NetEq Initialization error: could not create VAD");
+                "EnableVADSafe: NetEq Initialization error: could not create VAD");
             return -1;
         }
     }
 
-    if(WebRtcNetEQ_SetVADInstance(_inst[idx], _ptrVADInst[idx],
+    if(WebRtcNetEQ_SetVADInstance(_inst, _ptrVADInst,
         (WebRtcNetEQ_VADInitFunction)    WebRtcVad_Init,
         (WebRtcNetEQ_VADSetmodeFunction) WebRtcVad_set_mode,
         (WebRtcNetEQ_VADFunction)        WebRtcVad_Process) < 0)
     {
-       LogError("setVADinstance", idx);
+       LogError("setVADinstance");
        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-           "EnableVADByIdxSafe: NetEq Initialization error: could not set VAD instance");
+           "EnableVADSafe: NetEq Initialization error: could not set VAD instance");
         return -1;
     }
 
-    if(WebRtcNetEQ_SetVADMode(_inst[idx], _vadMode) < 0)
+    if(WebRtcNetEQ_SetVADMode(_inst, _vadMode) < 0)
     {
-        LogError("setVADmode", idx);
+        LogError("setVADmode");
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-            "EnableVADByIdxSafe: NetEq Initialization error: could not set VAD mode");
+            "EnableVADSafe: NetEq Initialization error: could not set VAD mode");
         return -1;
     }
     return 0;
@@ -253,61 +266,53 @@ ACMNetEQ::AllocatePacketBuffer(
     // if not casted
 
     CriticalSectionScoped lock(*_netEqCritSect);
-    for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
-    {
-        if(AllocatePacketBufferByIdxSafe(usedCodecs, noOfCodecs, idx) < 0)
-        {
-            return -1;
-        }
-    }
-    return 0;
+    return AllocatePacketBufferSafe(usedCodecs, noOfCodecs);
 }
 
 WebRtc_Word16
-ACMNetEQ::AllocatePacketBufferByIdxSafe(
+ACMNetEQ::AllocatePacketBufferSafe(
     const WebRtcNetEQDecoder*    usedCodecs,
-    WebRtc_Word16       noOfCodecs,
-    const WebRtc_Word16 idx)
+    WebRtc_Word16       noOfCodecs)
 {
     int maxNoPackets;
     int bufferSizeInBytes;
 
-    if(!_isInitialized[idx])
+    if(!_isInitialized)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-            "AllocatePacketBufferByIdxSafe: NetEq is not initialized.");
+            "AllocatePacketBufferSafe: NetEq is not initialized.");
         return -1;
     }
-    if (WebRtcNetEQ_GetRecommendedBufferSize(_inst[idx], usedCodecs, noOfCodecs,
+    if (WebRtcNetEQ_GetRecommendedBufferSize(_inst, usedCodecs, noOfCodecs,
         kTCPLargeJitter , &maxNoPackets, &bufferSizeInBytes)
         != 0)
     {
-        LogError("GetRecommendedBufferSize", idx);
+        LogError("GetRecommendedBufferSize");
         return -1;
     }
-    if(_netEqPacketBuffer[idx] != NULL)
+    if(_netEqPacketBuffer != NULL)
     {
-        free(_netEqPacketBuffer[idx]);
-        _netEqPacketBuffer[idx] = NULL;
+        free(_netEqPacketBuffer);
+        _netEqPacketBuffer = NULL;
     }
 
-    _netEqPacketBuffer[idx] = (WebRtc_Word16 *)malloc(bufferSizeInBytes);
-    if (_netEqPacketBuffer[idx] == NULL)
+    _netEqPacketBuffer = (WebRtc_Word16 *)malloc(bufferSizeInBytes);
+    if (_netEqPacketBuffer == NULL)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-            "AllocatePacketBufferByIdxSafe: NetEq Initialization error: could not allocate "
+            "AllocatePacketBufferSafe: NetEq Initialization error: could not allocate "
             "memory for NetEq Packet Buffer");
         return -1;
 
     }
-    if (WebRtcNetEQ_AssignBuffer(_inst[idx], maxNoPackets, _netEqPacketBuffer[idx],
+    if (WebRtcNetEQ_AssignBuffer(_inst, maxNoPackets, _netEqPacketBuffer,
         bufferSizeInBytes) != 0)
     {
-        if (_netEqPacketBuffer[idx] != NULL) {
-            free(_netEqPacketBuffer[idx]);
-            _netEqPacketBuffer[idx] = NULL;
+        if (_netEqPacketBuffer != NULL) {
+            free(_netEqPacketBuffer);
+            _netEqPacketBuffer = NULL;
         }
-        LogError("AssignBuffer", idx);
+        LogError("AssignBuffer");
         return -1;
     }
     return 0;
@@ -322,19 +327,16 @@ ACMNetEQ::SetExtraDelay(
 {
     CriticalSectionScoped lock(*_netEqCritSect);
 
-    for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+    if(!_isInitialized)
     {
-        if(!_isInitialized[idx])
-        {
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "SetExtraDelay: NetEq is not initialized.");
-            return -1;
-        }
-        if(WebRtcNetEQ_SetExtraDelay(_inst[idx], delayInMS) < 0)
-        {
-            LogError("SetExtraDelay", idx);
-            return -1;
-        }
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+            "SetExtraDelay: NetEq is not initialized.");
+        return -1;
+    }
+    if(WebRtcNetEQ_SetExtraDelay(_inst, delayInMS) < 0)
+    {
+        LogError("SetExtraDelay");
+        return -1;
     }
     _extraDelay = delayInMS;
     return 0;
@@ -348,19 +350,16 @@ ACMNetEQ::SetAVTPlayout(
     CriticalSectionScoped lock(*_netEqCritSect);
     if (_avtPlayout != enable)
     {
-        for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+        if(!_isInitialized)
         {
-            if(!_isInitialized[idx])
-            {
-                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                    "SetAVTPlayout: NetEq is not initialized.");
-                return -1;
-            }
-            if(WebRtcNetEQ_SetAVTPlayout(_inst[idx], (enable) ? 1 : 0) < 0)
-            {
-                LogError("SetAVTPlayout", idx);
-                return -1;
-            }
+            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+                "SetAVTPlayout: NetEq is not initialized.");
+            return -1;
+        }
+        if(WebRtcNetEQ_SetAVTPlayout(_inst, (enable) ? 1 : 0) < 0)
+        {
+            LogError("SetAVTPlayout");
+            return -1;
         }
     }
     _avtPlayout = enable;
@@ -379,7 +378,7 @@ WebRtc_Word32
 ACMNetEQ::CurrentSampFreqHz() const
 {
     CriticalSectionScoped lock(*_netEqCritSect);
-    if(!_isInitialized[0])
+    if(!_isInitialized)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
             "CurrentSampFreqHz: NetEq is not initialized.");
@@ -396,37 +395,34 @@ ACMNetEQ::SetPlayoutMode(
     CriticalSectionScoped lock(*_netEqCritSect);
     if(_playoutMode != mode)
     {
-        for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+        if(!_isInitialized)
         {
-            if(!_isInitialized[idx])
-            {
-                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                    "SetPlayoutMode: NetEq is not initialized.");
-                return -1;
-            }
+            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+                "SetPlayoutMode: NetEq is not initialized.");
+            return -1;
+        }
 
-            enum WebRtcNetEQPlayoutMode playoutMode;
-            switch(mode)
-            {
-            case voice:
-                playoutMode = kPlayoutOn;
-                break;
-            case fax:
-                playoutMode = kPlayoutFax;
-                break;
-            case streaming:
-                playoutMode = kPlayoutStreaming;
-                break;
-            default:
-                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                    "SetPlayoutMode: NetEq Error playout mode not recognized");
-                return -1;
-            }
-            if(WebRtcNetEQ_SetPlayoutMode(_inst[idx], playoutMode) < 0)
-            {
-                LogError("SetPlayoutMode", idx);
-                return -1;
-            }
+        enum WebRtcNetEQPlayoutMode playoutMode;
+        switch(mode)
+        {
+        case voice:
+            playoutMode = kPlayoutOn;
+            break;
+        case fax:
+            playoutMode = kPlayoutFax;
+            break;
+        case streaming:
+            playoutMode = kPlayoutStreaming;
+            break;
+        default:
+            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+                "SetPlayoutMode: NetEq Error playout mode not recognized");
+            return -1;
+        }
+        if(WebRtcNetEQ_SetPlayoutMode(_inst, playoutMode) < 0)
+        {
+            LogError("SetPlayoutMode");
+            return -1;
         }
         _playoutMode = mode;
     }
@@ -448,13 +444,13 @@ ACMNetEQ::NetworkStatistics(
 {
     WebRtcNetEQ_NetworkStatistics stats;
     CriticalSectionScoped lock(*_netEqCritSect);
-    if(!_isInitialized[0])
+    if(!_isInitialized)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
             "NetworkStatistics: NetEq is not initialized.");
         return -1;
     }
-    if(WebRtcNetEQ_GetNetworkStatistics(_inst[0], &stats) == 0)
+    if(WebRtcNetEQ_GetNetworkStatistics(_inst, &stats) == 0)
     {
         statistics->currentAccelerateRate = stats.currentAccelerateRate;
         statistics->currentBufferSize = stats.currentBufferSize;
@@ -466,13 +462,13 @@ ACMNetEQ::NetworkStatistics(
     }
     else
     {
-        LogError("getNetworkStatistics", 0);
+        LogError("getNetworkStatistics");
         return -1;
     }
     const int kArrayLen = 100;
     int waiting_times[kArrayLen];
     int waiting_times_len = WebRtcNetEQ_GetRawFrameWaitingTimes(
-        _inst[0], kArrayLen, waiting_times);
+        _inst, kArrayLen, waiting_times);
     if (waiting_times_len >= 0)
     {
         std::vector<int> waiting_times_vec(waiting_times,
@@ -499,7 +495,7 @@ ACMNetEQ::NetworkStatistics(
     }
     else
     {
-        LogError("getRawFrameWaitingTimes", 0);
+        LogError("getRawFrameWaitingTimes");
         return -1;
     }
     return 0;
@@ -531,21 +527,38 @@ ACMNetEQ::RecIn(
 
     int status;
 
+    if(!_isInitialized)
+    {
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+            "RecIn: NetEq is not initialized.");
+        return -1;
+    }
+
     if(rtpInfo.type.Audio.channel == 1)
     {
-        if(!_isInitialized[0])
+        if(_receivedStereo && (_numSlaves > 0) && !rtpInfo.type.Audio.isCNG)
         {
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "RecIn: NetEq is not initialized.");
-            return -1;
+            // Hold on to the master payload until the slave payload of the
+            // same packet arrives.
+            if(payloadLength > MAX_PAYLOAD_SIZE_BYTE)
+            {
+                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+                    "RecIn: NetEq, payload too large for stereo decoding");
+                return -1;
+            }
+            memcpy(_stereoPayload, incomingPayload, payloadLength);
+            _stereoPayloadLength = payloadLength;
+            _stereoSequenceNumber = rtpInfo.header.sequenceNumber;
+            _stereoTimestamp = rtpInfo.header.timestamp;
+            return 0;
         }
         // PUSH into Master
-        status = WebRtcNetEQ_RecInRTPStruct(_inst[0], &netEqRTPInfo,
+        status = WebRtcNetEQ_RecInRTPStruct(_inst, &netEqRTPInfo,
             (WebRtc_UWord8 *)incomingPayload, (WebRtc_Word16)payloadLength,
             recvTimestamp);
         if(status < 0)
         {
-            LogError("RecInRTPStruct", 0);
+            LogError("RecInRTPStruct");
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
                 "RecIn: NetEq, error in pushing in Master");
             return -1;
@@ -553,21 +566,28 @@ ACMNetEQ::RecIn(
     }
     else if(rtpInfo.type.Audio.channel == 2)
     {
-        if(!_isInitialized[1])
+        if((_stereoPayloadLength == 0) ||
+            (_stereoSequenceNumber != rtpInfo.header.sequenceNumber) ||
+            (_stereoTimestamp != rtpInfo.header.timestamp) ||
+            (payloadLength != _stereoPayloadLength))
         {
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "RecIn: NetEq is not initialized.");
+                "RecIn: NetEq, slave payload without a matching master payload");
             return -1;
         }
-        // PUSH into Slave
-        status = WebRtcNetEQ_RecInRTPStruct(_inst[1], &netEqRTPInfo,
-            (WebRtc_UWord8 *)incomingPayload, (WebRtc_Word16)payloadLength,
+        // NetEq takes the channels of a packet one after the other.
+        memcpy(&_stereoPayload[_stereoPayloadLength], incomingPayload,
+            payloadLength);
+        const WebRtc_Word32 stereoLength = _stereoPayloadLength + payloadLength;
+        _stereoPayloadLength = 0;
+        status = WebRtcNetEQ_RecInRTPStruct(_inst, &netEqRTPInfo,
+            (WebRtc_UWord8 *)_stereoPayload, (WebRtc_Word16)stereoLength,
             recvTimestamp);
         if(status < 0)
         {
-            LogError("RecInRTPStruct", 1);
+            LogError("RecInRTPStruct");
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "RecIn: NetEq, error in pushing in Slave");
+                "RecIn: NetEq, error in pushing stereo payload");
             return -1;
         }
     }
@@ -589,120 +609,40 @@ ACMNetEQ::RecOut(
 {
     enum WebRtcNetEQOutputType type;
     WebRtc_Word16 payloadLenSample;
-    enum WebRtcNetEQOutputType typeMaster;
-    enum WebRtcNetEQOutputType typeSlave;
-
-    WebRtc_Word16 payloadLenSampleSlave;
+    WebRtc_Word16 numChannels = 1;
 
     CriticalSectionScoped lockNetEq(*_netEqCritSect);
 
-    if(!_receivedStereo)
+    if(!_isInitialized)
     {
-        if(!_isInitialized[0])
-        {
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "RecOut: NetEq is not initialized.");
-            return -1;
-        }
-        {
-            WriteLockScoped lockCodec(*_decodeLock);
-            if(WebRtcNetEQ_RecOut(_inst[0], &(audioFrame._payloadData[0]),
-                &payloadLenSample) != 0)
-            {
-                LogError("RecOut", 0);
-                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id, 
-                    "RecOut: NetEq, error in pulling out for mono case");
-
-                // Check for errors that can be recovered from:
-                // RECOUT_ERROR_SAMPLEUNDERRUN = 2003
-                int errorCode = WebRtcNetEQ_GetErrorCode(_inst[0]);
-                if(errorCode != 2003)
-                {
-                    // Cannot recover; return an error
-                    return -1;
-                }
-            }
-        }
-        WebRtcNetEQ_GetSpeechOutputType(_inst[0], &type);
-        audioFrame._audioChannel = 1;
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+            "RecOut: NetEq is not initialized.");
+        return -1;
     }
-    else
     {
-        if(!_isInitialized[0] || !_isInitialized[1])
+        WriteLockScoped lockCodec(*_decodeLock);
+        // Stereo comes out interleaved, with both channels time-stretched
+        // and concealed alike; mono codecs give one channel.
+        if(WebRtcNetEQ_RecOutMultichannel(_inst,
+            &(audioFrame._payloadData[0]), &payloadLenSample,
+            &numChannels) != 0)
         {
+            LogError("RecOut");
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "RecOut: NetEq is not initialized.");
-            return -1;
-        }
-        WebRtc_Word16 payloadMaster[480];
-        WebRtc_Word16 payloadSlave[480];
-        {
-            WriteLockScoped lockCodec(*_decodeLock);
-            if(WebRtcNetEQ_RecOutMasterSlave(_inst[0], payloadMaster,
-                &payloadLenSample, _masterSlaveInfo, 1) != 0)
-            {
-                LogError("RecOutMasterSlave", 0);
-                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                    "RecOut: NetEq, error in pulling out for master");
-
-                // Check for errors that can be recovered from:
-                // RECOUT_ERROR_SAMPLEUNDERRUN = 2003
-                int errorCode = WebRtcNetEQ_GetErrorCode(_inst[0]);
-                if(errorCode != 2003)
-                {
-                    // Cannot recover; return an error
-                    return -1;
-                }
-            }
-            if(WebRtcNetEQ_RecOutMasterSlave(_inst[1], payloadSlave,
-                &payloadLenSampleSlave, _masterSlaveInfo, 0) != 0)
-            {
-                LogError("RecOutMasterSlave", 1);
-                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                    "RecOut: NetEq, error in pulling out for slave");
-
-                // Check for errors that can be recovered from:
-                // RECOUT_ERROR_SAMPLEUNDERRUN = 2003
-                int errorCode = WebRtcNetEQ_GetErrorCode(_inst[0]);
-                if(errorCode != 2003)
-                {
-                    // Cannot recover; return an error
-                    return -1;
-                }
-            }
-        }
-        if(payloadLenSample != payloadLenSampleSlave)
-        {
-            WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceAudioCoding, _id,
-                "RecOut: mismatch between the lenght of the decoded \
-audio by Master (%d samples) and Slave (%d samples).",
-            payloadLenSample, payloadLenSampleSlave);
-            if(payloadLenSample > payloadLenSampleSlave)
+                "RecOut: NetEq, error in pulling out audio");
+
+            // Check for errors that can be recovered from:
+            // RECOUT_ERROR_SAMPLEUNDERRUN = 2003
+            int errorCode = WebRtcNetEQ_GetErrorCode(_inst);
+            if(errorCode != 2003)
             {
-                memset(&payloadSlave[payloadLenSampleSlave], 0,
-                    (payloadLenSample - payloadLenSampleSlave) * sizeof(WebRtc_Word16));
+                // Cannot recover; return an error
+                return -1;
             }
         }
-
-        for(WebRtc_Word16 n = 0; n < payloadLenSample; n++)
-        {
-            audioFrame._payloadData[n<<1]     = payloadMaster[n];
-            audioFrame._payloadData[(n<<1)+1] = payloadSlave[n];
-        }
-        audioFrame._audioChannel = 2;
-
-        WebRtcNetEQ_GetSpeechOutputType(_inst[0], &typeMaster);
-        WebRtcNetEQ_GetSpeechOutputType(_inst[1], &typeSlave);
-        if((typeMaster == kOutputNormal) ||
-            (typeSlave == kOutputNormal))
-        {
-            type = kOutputNormal;
-        }
-        else
-        {
-            type = typeMaster;
-        }
     }
+    WebRtcNetEQ_GetSpeechOutputType(_inst, &type);
+    audioFrame._audioChannel = numChannels;
 
     audioFrame._payloadDataLengthInSamples = static_cast<WebRtc_UWord16>(payloadLenSample);
     // NetEq always returns 10 ms of audio.
@@ -787,25 +727,29 @@ ACMNetEQ::AddCodec(
     }
     CriticalSectionScoped lock(*_netEqCritSect);
 
-    WebRtc_Word16 idx;
-    if(toMaster)
-    {
-        idx = 0;
-    }
-    else
-    {
-        idx = 1;
-    }
-
-    if(!_isInitialized[idx])
+    if(!_isInitialized)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
                 "ACMNetEQ::AddCodec: NetEq is not initialized.");
         return -1;
     }
-    if(WebRtcNetEQ_CodecDbAdd(_inst[idx], codecDef) < 0)
+    if(!toMaster)
     {
-        LogError("CodecDB_Add", idx);
+        // The slave channel decodes with its own state, on top of the codec
+        // already added to the master.
+        if(WebRtcNetEQ_CodecDbAddChannel(_inst, codecDef->codec, 1,
+            codecDef->codec_state) < 0)
+        {
+            LogError("CodecDB_AddChannel");
+            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+                "ACMNetEQ::AddCodec: NetEq, error in adding codec to slave channel");
+            return -1;
+        }
+        return 0;
+    }
+    if(WebRtcNetEQ_CodecDbAdd(_inst, codecDef) < 0)
+    {
+        LogError("CodecDB_Add");
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
             "ACMNetEQ::AddCodec: NetEq, error in adding codec");
         return -1;
@@ -893,23 +837,20 @@ ACMNetEQ::EnableVAD()
     {
         return 0;
     }
-    for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+    if(!_isInitialized)
     {
-        if(!_isInitialized[idx])
-        {
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "SetVADStatus: NetEq is not initialized.");
-            return -1;
-        }
-        // VAD was off and we have to turn it on
-        if(EnableVADByIdxSafe(idx) < 0)
-        {
-            return -1;
-        }
-
-        // Set previous VAD status to PASSIVE
-        _previousAudioActivity = AudioFrame::kVadPassive;
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+            "SetVADStatus: NetEq is not initialized.");
+        return -1;
+    }
+    // VAD was off and we have to turn it on
+    if(EnableVADSafe() < 0)
+    {
+        return -1;
     }
+
+    // Set previous VAD status to PASSIVE
+    _previousAudioActivity = AudioFrame::kVadPassive;
     _vadStatus = true;
     return 0;
 }
@@ -936,19 +877,16 @@ ACMNetEQ::SetVADMode(
     }
     else
     {
-        for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+        if(!_isInitialized)
         {
-            if(!_isInitialized[idx])
-            {
-                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                    "SetVADMode: NetEq is not initialized.");
-                return -1;
-            }
-            if(WebRtcNetEQ_SetVADMode(_inst[idx], mode) < 0)
-            {
-                LogError("SetVADmode", idx);
-                return -1;
-            }
+            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+                "SetVADMode: NetEq is not initialized.");
+            return -1;
+        }
+        if(WebRtcNetEQ_SetVADMode(_inst, mode) < 0)
+        {
+            LogError("SetVADmode");
+            return -1;
         }
         _vadMode = mode;
         return 0;
@@ -960,19 +898,16 @@ WebRtc_Word32
 ACMNetEQ::FlushBuffers()
 {
     CriticalSectionScoped lock(*_netEqCritSect);
-    for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+    if(!_isInitialized)
     {
-        if(!_isInitialized[idx])
-        {
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "FlushBuffers: NetEq is not initialized.");
-            return -1;
-        }
-        if(WebRtcNetEQ_FlushBuffers(_inst[idx]) < 0)
-        {
-            LogError("FlushBuffers", idx);
-            return -1;
-        }
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+            "FlushBuffers: NetEq is not initialized.");
+        return -1;
+    }
+    if(WebRtcNetEQ_FlushBuffers(_inst) < 0)
+    {
+        LogError("FlushBuffers");
+        return -1;
     }
     return 0;
 }
@@ -1011,8 +946,7 @@ ACMNetEQ::GetVersion(
 
 WebRtc_Word16
 ACMNetEQ::RemoveCodec(
-    WebRtcNetEQDecoder codecIdx,
-    bool               isStereo)
+    WebRtcNetEQDecoder codecIdx)
 {
     // sanity check
     if((codecIdx <= kDecoderReservedStart) ||
@@ -1023,28 +957,20 @@ ACMNetEQ::RemoveCodec(
         return -1;
     }
     CriticalSectionScoped lock(*_netEqCritSect);
-    if(!_isInitialized[0])
+    if(!_isInitialized)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
             "RemoveCodec: NetEq is not initialized.");
         return -1;
     }
 
-    if(WebRtcNetEQ_CodecDbRemove(_inst[0], codecIdx) < 0)
+    // Removes the codec from the slave channel too.
+    if(WebRtcNetEQ_CodecDbRemove(_inst, codecIdx) < 0)
     {
-        LogError("CodecDB_Remove", 0);
+        LogError("CodecDB_Remove");
         return -1;
     }
 
-    if(isStereo)
-    {
-        if(WebRtcNetEQ_CodecDbRemove(_inst[1], codecIdx) < 0)
-        {
-            LogError("CodecDB_Remove", 1);
-            return -1;
-        }
-    }
-
     return 0;
 }
 
@@ -1053,19 +979,16 @@ ACMNetEQ::SetBackgroundNoiseMode(
     const ACMBackgroundNoiseMode mode)
 {
     CriticalSectionScoped lock(*_netEqCritSect);
-    for(WebRtc_Word16 idx = 0; idx < _numSlaves + 1; idx++)
+    if(!_isInitialized)
     {
-        if(!_isInitialized[idx])
-        {
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "SetBackgroundNoiseMode: NetEq is not initialized.");
-            return -1;
-        }
-        if(WebRtcNetEQ_SetBGNMode(_inst[idx], (WebRtcNetEQBGNMode)mode) < 0)
-        {
-            LogError("SetBGNMode", idx);
-            return -1;
-        }
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+            "SetBackgroundNoiseMode: NetEq is not initialized.");
+        return -1;
+    }
+    if(WebRtcNetEQ_SetBGNMode(_inst, (WebRtcNetEQBGNMode)mode) < 0)
+    {
+        LogError("SetBGNMode");
+        return -1;
     }
     return 0;
 }
@@ -1076,15 +999,15 @@ ACMNetEQ::BackgroundNoiseMode(
 {
     WebRtcNetEQBGNMode myMode;
     CriticalSectionScoped lock(*_netEqCritSect);
-    if(!_isInitialized[0])
+    if(!_isInitialized)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
             "BackgroundNoiseMode: NetEq is not initialized.");
         return -1;
     }
-    if(WebRtcNetEQ_GetBGNMode(_inst[0], &myMode) < 0)
+    if(WebRtcNetEQ_GetBGNMode(_inst, &myMode) < 0)
     {
-        LogError("WebRtcNetEQ_GetBGNMode", 0);
+        LogError("WebRtcNetEQ_GetBGNMode");
         return -1;
     }
     else
@@ -1105,19 +1028,17 @@ ACMNetEQ::SetUniqueId(
 
 void
 ACMNetEQ::LogError(
-    const WebRtc_Word8* neteqFuncName,
-    const WebRtc_Word16 idx) const
+    const WebRtc_Word8* neteqFuncName) const
 {
     WebRtc_Word8 errorName[NETEQ_ERR_MSG_LEN_BYTE];
     WebRtc_Word8 myFuncName[50];
-    int neteqErrorCode = WebRtcNetEQ_GetErrorCode(_inst[idx]);
+    int neteqErrorCode = WebRtcNetEQ_GetErrorCode(_inst);
     WebRtcNetEQ_GetErrorName(neteqErrorCode, errorName, NETEQ_ERR_MSG_LEN_BYTE - 1);
     strncpy(myFuncName, neteqFuncName, 49);
     errorName[NETEQ_ERR_MSG_LEN_BYTE - 1] = '\0';
     myFuncName[49] = '\0';
     WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-        "NetEq-%d Error in function %s, error-code: %d, error-string: %s",
-        idx,
+        "NetEq Error in function %s, error-code: %d, error-string: %s",
         myFuncName,
         neteqErrorCode,
         errorName);
@@ -1129,9 +1050,9 @@ ACMNetEQ::PlayoutTimestamp(
     WebRtc_UWord32& timestamp)
 {
     CriticalSectionScoped lock(*_netEqCritSect);
-    if(WebRtcNetEQ_GetSpeechTimeStamp(_inst[0], &timestamp) < 0)
+    if(WebRtcNetEQ_GetSpeechTimeStamp(_inst, &timestamp) < 0)
     {
-        LogError("GetSpeechTimeStamp", 0);
+        LogError("GetSpeechTimeStamp");
         return -1;
     }
     else
@@ -1146,105 +1067,73 @@ ACMNetEQ::AddSlave(
     WebRtc_Word16       noOfCodecs)
 {
     CriticalSectionScoped lock(*_netEqCritSect);
-    const WebRtc_Word16 slaveIdx = 1;
     if(_numSlaves < 1)
     {
-        // initialize the receiver, this also sets up VAD.
-        if(InitByIdxSafe(slaveIdx) < 0)
+        if(!_isInitialized)
         {
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AddSlave: AddSlave Failed, Could not Initialize");
+                "AddSlave: NetEq is not initialized.");
             return -1;
         }
 
-        // Allocate buffer.
-        if(AllocatePacketBufferByIdxSafe(usedCodecs, noOfCodecs, slaveIdx) < 0)
+        int channelMemSize;
+        if(WebRtcNetEQ_AssignChannelsSize(MAX_NUM_NETEQ_CHANNELS,
+            &channelMemSize) != 0)
         {
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AddSlave: AddSlave Failed, Could not Allocate Packet Buffer");
+                "AddSlave: AddSlave Failed, Could not get channel memory size");
             return -1;
         }
-
-        if(_masterSlaveInfo != NULL)
+        if(_channelMem != NULL)
         {
-            free(_masterSlaveInfo);
-            _masterSlaveInfo = NULL;
-        }
-        int msInfoSize = WebRtcNetEQ_GetMasterSlaveInfoSize();
-        _masterSlaveInfo = malloc(msInfoSize);
-
-        if(_masterSlaveInfo == NULL)
-        {
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AddSlave: AddSlave Failed, Could not Allocate memory for Master-Slave Info");
-            return -1;
+            free(_channelMem);
+            _channelMem = NULL;
         }
-
-        // We accept this as initialized NetEQ, the rest is to synchronize
-        // Slave with Master.
-        _numSlaves = 1;
-        _isInitialized[slaveIdx] = true;
-
-        // Set Slave delay as all other instances.
-        if(WebRtcNetEQ_SetExtraDelay(_inst[slaveIdx], _extraDelay) < 0)
+        _channelMem = malloc(channelMemSize);
+        if(_channelMem == NULL)
         {
-            LogError("SetExtraDelay", slaveIdx);
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AddSlave: AddSlave Failed, Could not set delay");
+                "AddSlave: AddSlave Failed, Could not Allocate memory for the slave channel");
             return -1;
         }
-
-        // Set AVT
-        if(WebRtcNetEQ_SetAVTPlayout(_inst[slaveIdx], (_avtPlayout) ? 1 : 0) < 0)
+        if(WebRtcNetEQ_AssignChannels(_inst, MAX_NUM_NETEQ_CHANNELS,
+            _channelMem, channelMemSize) != 0)
         {
-            LogError("SetAVTPlayout", slaveIdx);
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AddSlave: AddSlave Failed, Could not set AVT playout.");
+            LogError("AssignChannels");
+            free(_channelMem);
+            _channelMem = NULL;
             return -1;
         }
 
-        // Set Background Noise
-        WebRtcNetEQBGNMode currentMode;
-        if(WebRtcNetEQ_GetBGNMode(_inst[0], &currentMode) < 0)
+        // The packet buffer has to hold the payloads of both channels.
+        if(AllocatePacketBufferSafe(usedCodecs, noOfCodecs) < 0)
         {
-            LogError("GetBGNMode", 0);
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AAddSlave: AddSlave Failed, Could not Get BGN form Master.");
+                "AddSlave: AddSlave Failed, Could not Allocate Packet Buffer");
+            WebRtcNetEQ_AssignChannels(_inst, 1, NULL, 0);
+            free(_channelMem);
+            _channelMem = NULL;
             return -1;
         }
 
-        if(WebRtcNetEQ_SetBGNMode(_inst[slaveIdx], (WebRtcNetEQBGNMode)currentMode) < 0)
-        {
-            LogError("SetBGNMode", slaveIdx);
-             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AddSlave: AddSlave Failed, Could not set BGN mode.");
-           return -1;
-        }
-
-        enum WebRtcNetEQPlayoutMode playoutMode;
-        switch(_playoutMode)
+        // Only stereo receivers pay for the buffer that joins the payloads
+        // of the two channels.
+        if(_stereoPayload == NULL)
         {
-        case voice:
-            playoutMode = kPlayoutOn;
-            break;
-        case fax:
-            playoutMode = kPlayoutFax;
-            break;
-        case streaming:
-            playoutMode = kPlayoutStreaming;
-            break;
-        default:
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AddSlave: NetEq Error, playout mode not recognized");
-            return -1;
-        }
-        if(WebRtcNetEQ_SetPlayoutMode(_inst[slaveIdx], playoutMode) < 0)
-        {
-            LogError("SetPlayoutMode", 1);
-            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
-                "AddSlave: AddSlave Failed, Could not Set Playout Mode.");
-            return -1;
+            _stereoPayload = (WebRtc_Word8*)malloc(MAX_NUM_NETEQ_CHANNELS *
+                MAX_PAYLOAD_SIZE_BYTE);
+            if(_stereoPayload == NULL)
+            {
+                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+                    "AddSlave: AddSlave Failed, Could not Allocate memory for the stereo payload");
+                WebRtcNetEQ_AssignChannels(_inst, 1, NULL, 0);
+                free(_channelMem);
+                _channelMem = NULL;
+                return -1;
+            }
         }
+        _stereoPayloadLength = 0;
+        _numSlaves = 1;
     }
 
     return 0;
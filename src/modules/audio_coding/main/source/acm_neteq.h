@@ -27,7 +27,8 @@ struct CodecInst;
 enum AudioPlayoutMode;
 enum ACMSpeechType;
 
-#define MAX_NUM_SLAVE_NETEQ 1
+// Stereo is decoded as two channels of one NetEQ instance, see AddSlave().
+#define MAX_NUM_NETEQ_CHANNELS 2
 
 class ACMNetEQ
 {
@@ -259,14 +260,14 @@ public:
     // Removes a codec from the NetEQ codec database.
     //
     // Input:
-    //   - codecIdx              : Codec to be removed.
+    //   - codecIdx              : Codec to be removed, from the master and
+    //                             the slave channel.
     //
     // Return value              : 0 if ok.
     //                            -1 if an error occurred.
     //
     WebRtc_Word16 RemoveCodec(
-        WebRtcNetEQDecoder codecIdx,
-        bool isStereo = false);
+        WebRtcNetEQDecoder codecIdx);
 
 
     //
@@ -301,10 +302,30 @@ public:
     void SetReceivedStereo(
         bool receivedStereo);
 
+    //
+    // NumSlaves()
+    // Returns the number of channels decoded in addition to the master
+    // channel.
+    //
     WebRtc_UWord8 NumSlaves();
 
     enum JB {masterJB = 0, slaveJB = 1};
 
+    //
+    // AddSlave()
+    // Adds a second (slave) channel to the NetEQ instance, so that stereo
+    // payloads are decoded with one set of jitter buffer decisions for both
+    // channels. Decoders of the slave channel are added with AddCodec(),
+    // with |toMaster| set to false. The packet buffer is reallocated, which
+    // drops all buffered packets.
+    //
+    // Input:
+    //   - usedCodecs            : Codecs used by the receiver.
+    //   - noOfCodecs            : Number of codecs in |usedCodecs|.
+    //
+    // Return value              : 0 if ok.
+    //                            -1 if an error occurred.
+    //
     WebRtc_Word16 AddSlave(
         const WebRtcNetEQDecoder*    usedCodecs,
         WebRtc_Word16       noOfCodecs);
@@ -330,11 +351,9 @@ private:
         const WebRtcRTPHeader& rtpInfo);
 
     void LogError(
-        const WebRtc_Word8* neteqFuncName,
-        const WebRtc_Word16 idx) const;
+        const WebRtc_Word8* neteqFuncName) const;
 
-    WebRtc_Word16 InitByIdxSafe(
-        const WebRtc_Word16 idx);
+    WebRtc_Word16 InitSafe();
 
     // EnableVAD()
     // Enable VAD.
@@ -344,18 +363,16 @@ private:
     //
     WebRtc_Word16 EnableVAD();
 
-    WebRtc_Word16 EnableVADByIdxSafe(
-        const WebRtc_Word16 idx);
+    WebRtc_Word16 EnableVADSafe();
 
-    WebRtc_Word16 AllocatePacketBufferByIdxSafe(
+    WebRtc_Word16 AllocatePacketBufferSafe(
         const WebRtcNetEQDecoder* usedCodecs,
-        WebRtc_Word16       noOfCodecs,
-        const WebRtc_Word16 idx);
+        WebRtc_Word16       noOfCodecs);
 
-    void*                   _inst[MAX_NUM_SLAVE_NETEQ + 1];
-    void*                   _instMem[MAX_NUM_SLAVE_NETEQ + 1];
+    void*                   _inst;
+    void*                   _instMem;
 
-    WebRtc_Word16*          _netEqPacketBuffer[MAX_NUM_SLAVE_NETEQ + 1];
+    WebRtc_Word16*          _netEqPacketBuffer;
 
     WebRtc_Word32           _id;
     float                   _currentSampFreqKHz;
@@ -363,15 +380,21 @@ private:
     AudioPlayoutMode        _playoutMode;
     CriticalSectionWrapper* _netEqCritSect;
 
-    WebRtcVadInst*          _ptrVADInst[MAX_NUM_SLAVE_NETEQ + 1];
+    WebRtcVadInst*          _ptrVADInst;
 
     bool                    _vadStatus;
     ACMVADMode              _vadMode;
     RWLockWrapper*          _decodeLock;
-    bool                    _isInitialized[MAX_NUM_SLAVE_NETEQ + 1];
+    bool                    _isInitialized;
     WebRtc_UWord8           _numSlaves;
     bool                    _receivedStereo;
-    void*                   _masterSlaveInfo;
+    void*                   _channelMem;
+    // Master channel payload, held until the slave channel payload of the
+    // same packet arrives. Allocated by AddSlave().
+    WebRtc_Word8*           _stereoPayload;
+    WebRtc_Word32           _stereoPayloadLength;
+    WebRtc_UWord16          _stereoSequenceNumber;
+    WebRtc_UWord32          _stereoTimestamp;
     AudioFrame::VADActivity _previousAudioActivity;
     WebRtc_Word32           _extraDelay;
 
@@ -172,7 +172,7 @@ AudioCodingModule::IsCodecValid(
 
     if(codecNumber < 0)
     {
-        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, -1, errMsg);
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, -1, "%s", errMsg);
         return false;
     }
     else
@@ -678,7 +678,7 @@ mono codecs are supported, i.e. channels=1.", sendCodec.channels);
             // This values has to be NULL if there is no codec registered
             _currentSendCodecIdx = -1;  // invalid value
         }
-        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id, errMsg);
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id, "%s", errMsg);
         // Failed to register Send Codec
         return -1;
     }
@@ -1541,7 +1541,7 @@ AudioCodingModuleImpl::RegisterReceiveCodec(
     }
 
 
-    // If receive stereo, make sure we have two instances of NetEQ, one for each channel
+    // If receive stereo, make sure NetEQ decodes a second (slave) channel
     if(receiveCodec.channels == 2)
     {
         if(_netEq.NumSlaves() < 1)
@@ -2569,7 +2569,7 @@ AudioCodingModuleImpl::UnregisterReceiveCodecSafe(
         {
             // before deleting the decoder instance unregister
             // from NetEQ.
-            if(_netEq.RemoveCodec(neteqDecoder[codecID], _stereoReceive[codecID]) < 0)
+            if(_netEq.RemoveCodec(neteqDecoder[codecID]) < 0)
             {
                 CodecInst codecInst;
                 ACMCodecDB::Codec(codecID, &codecInst);
@@ -268,6 +268,9 @@ int WebRtcNetEQ_DbAdd(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec,
         inst->funcUpdBWEst[temp] = funcUpdBWEst;
         inst->funcGetErrorCode[temp] = funcGetErrorCode;
         inst->codec_fs[temp] = codec_fs;
+#ifdef NETEQ_STEREO
+        inst->numChannels[temp] = 1;
+#endif
 
     }
 
@@ -318,6 +321,9 @@ int WebRtcNetEQ_DbRemove(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec)
             inst->funcUpdBWEst[i] = inst->funcUpdBWEst[i + 1];
             inst->funcGetErrorCode[i] = inst->funcGetErrorCode[i + 1];
             inst->codec_fs[i] = inst->codec_fs[i + 1];
+#ifdef NETEQ_STEREO
+            inst->numChannels[i] = inst->numChannels[i + 1];
+#endif
         }
         inst->payloadType[i] = -1;
         inst->codec_state[i] = NULL;
@@ -331,6 +337,9 @@ int WebRtcNetEQ_DbRemove(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec)
         inst->funcUpdBWEst[i] = NULL;
         inst->funcGetErrorCode[i] = NULL;
         inst->codec_fs[i] = 0;
+#ifdef NETEQ_STEREO
+        inst->numChannels[i] = 0;
+#endif
         /* Move down all the codecs above this one */
         for (i = 0; i < NUM_TOTAL_CODECS; i++)
         {
@@ -390,6 +399,42 @@ int WebRtcNetEQ_DbGetPtrs(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec,
     }
 }
 
+#ifdef NETEQ_STEREO
+/*
+ * Returns the number of channels decoded for a codec.
+ */
+
+int WebRtcNetEQ_DbGetChannels(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec)
+{
+    if ((codec <= kDecoderReservedStart) || (codec >= kDecoderReservedEnd)
+        || (inst->position[codec] == -1))
+    {
+        /* Unknown codecs (including "no codec yet") are mono */
+        return 1;
+    }
+    return inst->numChannels[inst->position[codec]];
+}
+
+/*
+ * Sets the number of channels decoded for a codec.
+ */
+
+int WebRtcNetEQ_DbSetChannels(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec,
+                              int numChannels)
+{
+    if ((codec <= kDecoderReservedStart) || (codec >= kDecoderReservedEnd))
+    {
+        return CODEC_DB_UNSUPPORTED_CODEC;
+    }
+    if (inst->position[codec] == -1)
+    {
+        return CODEC_DB_NOT_EXIST1;
+    }
+    inst->numChannels[inst->position[codec]] = (WebRtc_Word16) numChannels;
+    return 0;
+}
+#endif
+
 /*
  * Returns payload number given a codec identifier.
  */
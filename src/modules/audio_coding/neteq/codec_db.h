@@ -49,6 +49,9 @@ typedef struct
     FuncGetErrorCode funcGetErrorCode[NUM_CODECS];
     void * codec_state[NUM_CODECS];
     WebRtc_UWord16 codec_fs[NUM_CODECS];
+#ifdef NETEQ_STEREO
+    WebRtc_Word16 numChannels[NUM_CODECS];
+#endif
     WebRtc_Word16 CNGpayloadType[NUM_CNG_CODECS];
 
 } CodecDbInst_t;
@@ -88,6 +91,20 @@ int WebRtcNetEQ_DbRemove(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec);
 int WebRtcNetEQ_DbGetPtrs(CodecDbInst_t *inst, enum WebRtcNetEQDecoder,
                           CodecFuncInst_t *ptr_inst);
 
+#ifdef NETEQ_STEREO
+/*
+ * Returns the number of channels decoded for a codec; 1 unless more channels
+ * have been set with WebRtcNetEQ_DbSetChannels.
+ */
+int WebRtcNetEQ_DbGetChannels(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec);
+
+/*
+ * Sets the number of channels decoded for a codec in the database.
+ */
+int WebRtcNetEQ_DbSetChannels(CodecDbInst_t *inst, enum WebRtcNetEQDecoder codec,
+                              int numChannels);
+#endif
+
 /*
  * Returns payload number given a codec identifier.
  */
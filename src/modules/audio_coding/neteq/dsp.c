@@ -200,17 +200,13 @@ int WebRtcNetEQ_DSPInit(DSPInst_t *inst, WebRtc_UWord16 fs)
     WebRtc_Word16 saveMsPerCall = inst->millisecondsPerCall;
     enum BGNMode saveBgnMode = inst->BGNInst.bgnMode;
 #ifdef NETEQ_STEREO
-    MasterSlaveInfo saveMSinfo;
+    MasterSlaveInfo *saveMSinfo = inst->msInfo;
+    WebRtc_Word16 saveChannel = inst->w16_channel;
 #endif
 
     /* copy contents of statInst to avoid clearing */WEBRTC_SPL_MEMCPY_W16(&saveStats, &(inst->statInst),
         sizeof(DSPStats_t)/sizeof(WebRtc_Word16));
 
-#ifdef NETEQ_STEREO
-    /* copy contents of msInfo to avoid clearing */WEBRTC_SPL_MEMCPY_W16(&saveMSinfo, &(inst->msInfo),
-        sizeof(MasterSlaveInfo)/sizeof(WebRtc_Word16));
-#endif
-
     /* check that the sample rate is valid */
     if ((fs != 8000)
 #ifdef NETEQ_WIDEBAND
@@ -292,8 +288,9 @@ int WebRtcNetEQ_DSPInit(DSPInst_t *inst, WebRtc_UWord16 fs)
         sizeof(DSPStats_t)/sizeof(WebRtc_Word16));
 
 #ifdef NETEQ_STEREO
-    /* Recreate MSinfo */WEBRTC_SPL_MEMCPY_W16(&(inst->msInfo), &saveMSinfo,
-        sizeof(MasterSlaveInfo)/sizeof(WebRtc_Word16));
+    /* Recreate MSinfo pointer */
+    inst->msInfo = saveMSinfo;
+    inst->w16_channel = saveChannel;
 #endif
 
 #ifdef NETEQ_CNG_CODEC
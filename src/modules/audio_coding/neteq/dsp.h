@@ -319,6 +319,9 @@ typedef struct DSPInst_t_
 #ifdef NETEQ_STEREO
     /* Pointer to Master/Slave info */
     MasterSlaveInfo *msInfo;
+
+    /* Channel index within a multichannel instance (0 for the main DSP) */
+    WebRtc_Word16 w16_channel;
 #endif
 
 } DSPInst_t;
@@ -13,6 +13,7 @@
  */
 
 #include "typedefs.h"
+#include "webrtc_neteq.h"
 
 #ifndef WEBRTC_NETEQ_INTERNAL_H
 #define WEBRTC_NETEQ_INTERNAL_H
@@ -90,6 +91,99 @@ int WebRtcNetEQ_RecOutMasterSlave(void *inst, WebRtc_Word16 *pw16_outData,
                                   WebRtc_Word16 *pw16_len, void *msInfo,
                                   WebRtc_Word16 isMaster);
 
+/****************************************************************************
+ * WebRtcNetEQ_AssignChannelsSize(...)
+ *
+ * Get the size in bytes of the extra memory needed for decoding numChannels
+ * channels in one NetEQ instance (see WebRtcNetEQ_AssignChannels).
+ *
+ * Input:
+ *      - numChannels   : Number of channels, at most NETEQ_MAX_CHANNELS (8)
+ *
+ * Output:
+ *      - sizeinbytes   : Memory size in bytes
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+
+int WebRtcNetEQ_AssignChannelsSize(int numChannels, int *sizeinbytes);
+
+/****************************************************************************
+ * WebRtcNetEQ_AssignChannels(...)
+ *
+ * Make an initialized NetEQ instance decode up to numChannels channels, as an
+ * alternative to running one instance per channel in master/slave mode. The
+ * channels share the packet buffer and all decisions; each channel has its
+ * own speech history and decoder. Payloads of a multichannel codec hold the
+ * data of each channel in turn, payloadLen/numChannels bytes per channel.
+ * Memory for the packet buffer should be scaled accordingly; this is done by
+ * WebRtcNetEQ_GetRecommendedBufferSize once the channels are assigned.
+ * Setting numChannels to 1 makes the instance mono again.
+ *
+ * Input:
+ *      - inst          : NetEQ instance
+ *      - numChannels   : Number of channels, at most NETEQ_MAX_CHANNELS (8)
+ *      - channelsAddr  : Memory of (at least) the size given by
+ *                        WebRtcNetEQ_AssignChannelsSize
+ *      - sizeinbytes   : Size of the memory in bytes
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+
+int WebRtcNetEQ_AssignChannels(void *inst, int numChannels, void *channelsAddr,
+                               int sizeinbytes);
+
+/****************************************************************************
+ * WebRtcNetEQ_CodecDbAddChannel(...)
+ *
+ * Add the decoder state of one more channel for a codec in the database of a
+ * multichannel instance. The codec itself (channel 0) is added with
+ * WebRtcNetEQ_CodecDbAdd; the decoder functions are shared by all channels.
+ * The codec is decoded with channel+1 channels, or more, from then on.
+ *
+ * Input:
+ *      - inst          : NetEQ instance
+ *      - codec         : Codec, already added to the database
+ *      - channel       : Channel index, 1 to numChannels-1
+ *      - codec_state   : Decoder state for the channel
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+
+int WebRtcNetEQ_CodecDbAddChannel(void *inst, enum WebRtcNetEQDecoder codec, int channel,
+                                  void *codec_state);
+
+/****************************************************************************
+ * WebRtcNetEQ_RecOutMultichannel(...)
+ *
+ * RecOut function for a multichannel instance. One decision is made for all
+ * channels of the current codec and the output is interleaved. CNG and DTMF
+ * played without a speech codec are copied to all channels of the stream.
+ *
+ * Input:
+ *      - inst              : NetEQ instance
+ *
+ * Output:
+ *      - pw16_outData      : Pointer to vector where the interleaved output
+ *                            should be written
+ *      - pw16_len          : Pointer to variable where the output length per
+ *                            channel is returned
+ *      - pw16_numChannels  : Pointer to variable where the number of output
+ *                            channels is returned
+ *
+ * Return value             :  0 - Ok
+ *                            -1 - Error. If the instance could make a
+ *                                 decision, the output is 10 ms of zeros and
+ *                                 the length and number of channels are set.
+ */
+
+int WebRtcNetEQ_RecOutMultichannel(void *inst, WebRtc_Word16 *pw16_outData,
+                                   WebRtc_Word16 *pw16_len,
+                                   WebRtc_Word16 *pw16_numChannels);
+
 typedef struct
 {
     WebRtc_UWord16 currentBufferSize; /* current jitter buffer size in ms */
@@ -236,6 +236,42 @@ int WebRtcNetEQ_RecInInternal(MCUInst_t *MCU_inst, RTPPacket_t *RTPpacket,
 int WebRtcNetEQ_SplitAndInsertPayload(RTPPacket_t *packet, PacketBuf_t *Buffer_inst,
                                       SplitInfo_t *split_inst, WebRtc_Word16 *flushed);
 
+#ifdef NETEQ_STEREO
+/****************************************************************************
+ * WebRtcNetEQ_SplitAndInsertMultichannel(...)
+ *
+ * Multichannel version of WebRtcNetEQ_SplitAndInsertPayload. The payload
+ * holds the data of each channel in turn, payloadLen/numChannels bytes per
+ * channel. Every inserted part holds the same time span of all channels, laid
+ * out the same way.
+ *
+ * Input:
+ *      - packet        : The RTP packet
+ *      - Buffer_inst   : Packet buffer to insert the parts into
+ *      - split_inst    : Split information for one channel of the codec
+ *      - numChannels   : Number of channels in the payload
+ *
+ * Output:
+ *      - flushed       : 1 if the packet buffer was flushed, 0 otherwise
+ *
+ * Return value         :  0 - Ok
+ *                        <0 - Error
+ */
+int WebRtcNetEQ_SplitAndInsertMultichannel(RTPPacket_t *packet, PacketBuf_t *Buffer_inst,
+                                           SplitInfo_t *split_inst, int numChannels,
+                                           WebRtc_Word16 *flushed);
+
+/****************************************************************************
+ * WebRtcNetEQ_CopyPayloadBytes(...)
+ *
+ * Copies numBytes bytes of payload, starting at byte srcByte of pw16_src, to
+ * byte dstByte of pw16_dst. The byte positions need not be 16-bit aligned.
+ */
+void WebRtcNetEQ_CopyPayloadBytes(WebRtc_Word16 *pw16_dst, int dstByte,
+                                  const WebRtc_Word16 *pw16_src, int srcByte,
+                                  int numBytes);
+#endif
+
 /****************************************************************************
  * WebRtcNetEQ_GetTimestampScaling(...)
  *
@@ -16,6 +16,8 @@
 
 #include <string.h>
 
+#include "signal_processing_library.h"
+
 /* Initialize instances with read and write address */
 int WebRtcNetEQ_DSPinit(MainInst_t *inst)
 {
@@ -35,3 +37,116 @@ int WebRtcNetEQ_DSP2MCUinterrupt(MainInst_t *inst, WebRtc_Word16 *pw16_shared_me
     inst->MCUinst.pw16_writeAddress = pw16_shared_mem;
     return WebRtcNetEQ_SignalMcu(&inst->MCUinst);
 }
+
+#ifdef NETEQ_STEREO
+
+/*
+ * Copies the part of the common MCU output that belongs to one channel to the
+ * shared memory of that channel. The blocks are parsed the same way as in
+ * WebRtcNetEQ_RecOutInternal.
+ */
+static void WebRtcNetEQ_ExtractChannel(MainInst_t *inst, WebRtc_Word16 channel,
+                                       WebRtc_Word16 *pw16_out)
+{
+    const WebRtc_Word16 *pw16_in = inst->pw16_mcuOutput;
+    const WebRtc_Word16 *pw16_inEnd = pw16_in + SHARED_MEM_SIZE * inst->maxChannels;
+    const WebRtc_Word16 *inPtr = &pw16_in[3];
+    WebRtc_Word16 *outPtr = &pw16_out[3];
+    WebRtc_Word16 blockLen, payloadLen, channelLen;
+    /* CNG parameters are common to all channels */
+    int splitPayload = ((pw16_in[0] & 0xf000) != DSP_INSTR_DO_RFC3389CNG);
+
+    /* Instruction word and timestamp update */
+    WEBRTC_SPL_MEMCPY_W16(pw16_out, pw16_in, 3);
+
+    if ((pw16_in[0] & DSP_DTMF_PAYLOAD) != 0)
+    {
+        WEBRTC_SPL_MEMCPY_W16(outPtr, inPtr, 3);
+        inPtr += 3;
+        outPtr += 3;
+    }
+
+    if ((pw16_in[0] & 0x0f00) == DSP_CODEC_NEW_CODEC)
+    {
+        /* Decoder functions, with the decoder state of this channel */
+        blockLen = (((*inPtr) & DSP_CODEC_MASK_RED_FLAG) + 1) >> 1;
+        WEBRTC_SPL_MEMCPY_W16(outPtr, inPtr, blockLen + 1);
+        if (channel > 0)
+        {
+            CodecFuncInst_t cinst;
+
+            WEBRTC_SPL_MEMCPY_W8(&cinst, inPtr + 1, sizeof(CodecFuncInst_t));
+            cinst.codec_state = NULL;
+            if (inst->MCUinst.current_Codec >= 0)
+            {
+                cinst.codec_state = inst->channelCodecState[(channel - 1) * NUM_TOTAL_CODECS
+                    + inst->MCUinst.current_Codec];
+            }
+            WEBRTC_SPL_MEMCPY_W8(outPtr + 1, &cinst, sizeof(CodecFuncInst_t));
+        }
+        inPtr += blockLen + 1;
+        outPtr += blockLen + 1;
+
+#ifdef NETEQ_CNG_CODEC
+        /* The CNG instance is shared */
+        blockLen = (((*inPtr) & DSP_CODEC_MASK_RED_FLAG) + 1) >> 1;
+        WEBRTC_SPL_MEMCPY_W16(outPtr, inPtr, blockLen + 1);
+        inPtr += blockLen + 1;
+        outPtr += blockLen + 1;
+#endif
+    }
+
+    /* Payloads (including a late packet), closed by a zero size block */
+    while ((inPtr < pw16_inEnd) && (((*inPtr) & DSP_CODEC_MASK_RED_FLAG) > 0))
+    {
+        payloadLen = (*inPtr) & DSP_CODEC_MASK_RED_FLAG;
+        blockLen = (payloadLen + 1) >> 1;
+        if (splitPayload)
+        {
+            channelLen = payloadLen / inst->numChannels;
+            *outPtr = channelLen | ((*inPtr) & DSP_CODEC_RED_FLAG);
+            WebRtcNetEQ_CopyPayloadBytes(outPtr + 1, 0, inPtr + 1, channel * channelLen,
+                channelLen);
+            outPtr += ((channelLen + 1) >> 1) + 1;
+        }
+        else
+        {
+            WEBRTC_SPL_MEMCPY_W16(outPtr, inPtr, blockLen + 1);
+            outPtr += blockLen + 1;
+        }
+        inPtr += blockLen + 1;
+    }
+    *outPtr = 0;
+}
+
+/* Channel 0 interrupts the MCU side on behalf of all channels */
+int WebRtcNetEQ_DSP2MCUinterruptChannel(MainInst_t *inst, WebRtc_Word16 channel,
+                                        WebRtc_Word16 *pw16_shared_mem)
+{
+    if (channel == 0)
+    {
+        /* The payloads in the MCU output hold this many channels */
+        inst->numChannels = (WebRtc_Word16) WEBRTC_SPL_MIN(inst->maxChannels,
+            WebRtcNetEQ_DbGetChannels(&inst->MCUinst.codec_DB_inst,
+                (enum WebRtcNetEQDecoder) inst->MCUinst.current_Codec));
+        if (inst->MCUinst.current_Codec != -1)
+        {
+            /* Without a speech codec (e.g., CNG only) keep the stream layout */
+            inst->outputChannels = inst->numChannels;
+        }
+
+        WEBRTC_SPL_MEMCPY_W8(inst->pw16_mcuOutput, pw16_shared_mem, sizeof(DSP2MCU_info_t));
+        inst->mcuReturnValue = WebRtcNetEQ_DSP2MCUinterrupt(inst, inst->pw16_mcuOutput);
+    }
+
+    if (inst->mcuReturnValue < 0)
+    {
+        pw16_shared_mem[0] = inst->pw16_mcuOutput[0];
+        return inst->mcuReturnValue;
+    }
+
+    WebRtcNetEQ_ExtractChannel(inst, channel, pw16_shared_mem);
+    return inst->mcuReturnValue;
+}
+
+#endif /* NETEQ_STEREO */
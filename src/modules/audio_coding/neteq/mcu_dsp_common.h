@@ -39,6 +39,16 @@ typedef struct
     WebRtc_Word16 ErrorCode; /* Store last error code */
 #ifdef NETEQ_STEREO
     WebRtc_Word16 masterSlave; /* 0 = not set, 1 = master, 2 = slave */
+
+    /* Multichannel decoding (memory assigned with WebRtcNetEQ_AssignChannels) */
+    WebRtc_Word16 maxChannels; /* Number of channels memory is assigned for */
+    WebRtc_Word16 numChannels; /* Number of channels in the current MCU output */
+    WebRtc_Word16 outputChannels; /* Number of output channels; kept through CNG
+                                   * and DTMF, which are decoded as mono */
+    DSPInst_t *channelDSPinst; /* DSP instances for channels 1 to maxChannels-1 */
+    void **channelCodecState; /* Decoder states for channels 1 and up, per codec */
+    WebRtc_Word16 *pw16_mcuOutput; /* MCU output shared by all channels */
+    int mcuReturnValue; /* MCU return value for the current MCU output */
 #endif /* NETEQ_STEREO */
 } MainInst_t;
 
@@ -58,4 +68,15 @@ int WebRtcNetEQ_DSPinit(MainInst_t *inst);
 /* The DSP side will call this function to interrupt the MCU side */
 int WebRtcNetEQ_DSP2MCUinterrupt(MainInst_t *inst, WebRtc_Word16 *pw16_shared_mem);
 
+#ifdef NETEQ_STEREO
+/*
+ * Multichannel version of WebRtcNetEQ_DSP2MCUinterrupt. Channel 0 interrupts
+ * the MCU side, which makes one decision for all channels. Every channel then
+ * gets the instructions with its own part of the payloads and its own decoder
+ * state in the shared memory.
+ */
+int WebRtcNetEQ_DSP2MCUinterruptChannel(MainInst_t *inst, WebRtc_Word16 channel,
+                                        WebRtc_Word16 *pw16_shared_mem);
+#endif
+
 #endif
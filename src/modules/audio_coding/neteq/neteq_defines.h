@@ -347,5 +347,8 @@
 /* Enable stereo */
 #define NETEQ_STEREO
 
+/* Max number of channels decoded by one multichannel instance */
+#define NETEQ_MAX_CHANNELS 8
+
 #endif /* #if !defined NETEQ_DEFINES_H */
 
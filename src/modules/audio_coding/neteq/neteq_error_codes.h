@@ -29,6 +29,7 @@
 #define CORRUPT_INSTANCE                -1005
 #define ILLEGAL_MASTER_SLAVE_SWITCH     -1006
 #define MASTER_SLAVE_ERROR              -1007
+#define FAULTY_NUMBER_OF_CHANNELS       -1008
 
 /* Misc Recout problems */
 #define UNKNOWN_BUFSTAT_DECISION        -2001
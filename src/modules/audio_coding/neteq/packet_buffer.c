@@ -29,6 +29,187 @@ extern FILE *delay_fid2; /* file pointer to delay log file */
 extern WebRtc_UWord32 tot_received_packets;
 #endif /* NETEQ_DELAY_LOGGING */
 
+/*
+ * The occupied slots are indexed in a ring (sortedSlots), ordered on
+ * timestamp with ties broken on RCU counter and slot number, i.e., in the
+ * order WebRtcNetEQ_PacketBufferFindLowestTimestamp() would pick them. The
+ * order is only well defined while all timestamps are within half the
+ * timestamp range from each other; if they are not, the index is marked
+ * invalid and the slots are searched linearly until the buffer is empty.
+ */
+
+/* Returns the slot at position k in timestamp order */
+static int WebRtcNetEQ_PacketBufferSortedSlot(const PacketBuf_t *bufferInst, int k)
+{
+    int pos = bufferInst->sortedHead + k;
+    if (pos >= bufferInst->maxInsertPositions)
+    {
+        pos -= bufferInst->maxInsertPositions;
+    }
+    return bufferInst->sortedSlots[pos];
+}
+
+static void WebRtcNetEQ_PacketBufferSetSortedSlot(PacketBuf_t *bufferInst, int k, int slot)
+{
+    int pos = bufferInst->sortedHead + k;
+    if (pos >= bufferInst->maxInsertPositions)
+    {
+        pos -= bufferInst->maxInsertPositions;
+    }
+    bufferInst->sortedSlots[pos] = (WebRtc_Word16) slot;
+}
+
+static void WebRtcNetEQ_PacketBufferClearIndex(PacketBuf_t *bufferInst)
+{
+    bufferInst->sortedHead = 0;
+    bufferInst->sortedCount = 0;
+    bufferInst->sortedValid = 1;
+}
+
+/* Returns non-zero if the packet in slotA is picked before the one in slotB */
+static int WebRtcNetEQ_PacketBufferIsBefore(const PacketBuf_t *bufferInst, int slotA,
+                                            int slotB, WebRtc_UWord32 headTS)
+{
+    WebRtc_UWord32 offsetA = bufferInst->timeStamp[slotA] - headTS;
+    WebRtc_UWord32 offsetB = bufferInst->timeStamp[slotB] - headTS;
+
+    if (offsetA != offsetB)
+    {
+        return (offsetA < offsetB);
+    }
+    if (bufferInst->rcuPlCntr[slotA] != bufferInst->rcuPlCntr[slotB])
+    {
+        return (bufferInst->rcuPlCntr[slotA] < bufferInst->rcuPlCntr[slotB]);
+    }
+    return (slotA < slotB);
+}
+
+static void WebRtcNetEQ_PacketBufferIndexInsert(PacketBuf_t *bufferInst, int slot)
+{
+    WebRtc_UWord32 headTS;
+    int k;
+
+    if (bufferInst->sortedCount == 0)
+    {
+        WebRtcNetEQ_PacketBufferClearIndex(bufferInst);
+        bufferInst->sortedSlots[0] = (WebRtc_Word16) slot;
+        bufferInst->sortedCount = 1;
+        return;
+    }
+
+    headTS = bufferInst->timeStamp[WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, 0)];
+
+    if (bufferInst->sortedValid
+        && ((WebRtc_UWord32) (bufferInst->timeStamp[slot] - headTS) >= 0x80000000))
+    {
+        /* The packet is older than the oldest one in the buffer */
+        WebRtc_UWord32 tailTS = bufferInst->timeStamp[WebRtcNetEQ_PacketBufferSortedSlot(
+            bufferInst, bufferInst->sortedCount - 1)];
+
+        if ((WebRtc_UWord32) (tailTS - bufferInst->timeStamp[slot]) < 0x80000000)
+        {
+            /* Make it the new head */
+            bufferInst->sortedHead--;
+            if (bufferInst->sortedHead < 0)
+            {
+                bufferInst->sortedHead = bufferInst->maxInsertPositions - 1;
+            }
+            bufferInst->sortedSlots[bufferInst->sortedHead] = (WebRtc_Word16) slot;
+            bufferInst->sortedCount++;
+            return;
+        }
+
+        /* The buffer would span more than half the timestamp range */
+        bufferInst->sortedValid = 0;
+    }
+
+    /*
+     * Insertion sort from the end; packets normally arrive in order, so this
+     * rarely moves more than a few entries. An invalid index is not sorted.
+     */
+    k = bufferInst->sortedCount;
+    if (bufferInst->sortedValid)
+    {
+        while (k > 0)
+        {
+            int prevSlot = WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, k - 1);
+            if (!WebRtcNetEQ_PacketBufferIsBefore(bufferInst, slot, prevSlot, headTS))
+            {
+                break;
+            }
+            WebRtcNetEQ_PacketBufferSetSortedSlot(bufferInst, k, prevSlot);
+            k--;
+        }
+    }
+    WebRtcNetEQ_PacketBufferSetSortedSlot(bufferInst, k, slot);
+    bufferInst->sortedCount++;
+}
+
+static void WebRtcNetEQ_PacketBufferIndexRemove(PacketBuf_t *bufferInst, int slot)
+{
+    int k;
+
+    /* The packet is normally the oldest one */
+    for (k = 0; k < bufferInst->sortedCount; k++)
+    {
+        if (WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, k) == slot)
+        {
+            break;
+        }
+    }
+    if (k == bufferInst->sortedCount)
+    {
+        /* Not in the index */
+        return;
+    }
+
+    if (k == 0)
+    {
+        bufferInst->sortedHead++;
+        if (bufferInst->sortedHead >= bufferInst->maxInsertPositions)
+        {
+            bufferInst->sortedHead = 0;
+        }
+    }
+    else
+    {
+        for (; k < bufferInst->sortedCount - 1; k++)
+        {
+            WebRtcNetEQ_PacketBufferSetSortedSlot(bufferInst, k,
+                WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, k + 1));
+        }
+    }
+    bufferInst->sortedCount--;
+
+    if (bufferInst->sortedCount == 0)
+    {
+        WebRtcNetEQ_PacketBufferClearIndex(bufferInst);
+    }
+}
+
+/* Removes all slots that have been emptied from the index */
+static void WebRtcNetEQ_PacketBufferIndexPrune(PacketBuf_t *bufferInst)
+{
+    int k;
+    int count = 0;
+
+    for (k = 0; k < bufferInst->sortedCount; k++)
+    {
+        int slot = WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, k);
+        if (bufferInst->payloadLengthBytes[slot] != 0)
+        {
+            WebRtcNetEQ_PacketBufferSetSortedSlot(bufferInst, count, slot);
+            count++;
+        }
+    }
+    bufferInst->sortedCount = count;
+
+    if (bufferInst->sortedCount == 0)
+    {
+        WebRtcNetEQ_PacketBufferClearIndex(bufferInst);
+    }
+}
+
 
 int WebRtcNetEQ_PacketBufferInit(PacketBuf_t *bufferInst, int maxNoOfPackets,
                                  WebRtc_Word16 *pw16_memory, int memorySize)
@@ -83,6 +264,9 @@ int WebRtcNetEQ_PacketBufferInit(PacketBuf_t *bufferInst, int maxNoOfPackets,
     pos += maxNoOfPackets *
         sizeof(*bufferInst->waitingTime) / sizeof(*pw16_memory);
 
+    bufferInst->sortedSlots = &pw16_memory[pos];
+    pos += maxNoOfPackets; /* advance maxNoOfPackets * WebRtc_Word16 */
+
     /* The payload memory starts after the slot arrays */
     bufferInst->startPayloadMemory = &pw16_memory[pos];
     bufferInst->currentMemoryPos = bufferInst->startPayloadMemory;
@@ -98,6 +282,7 @@ int WebRtcNetEQ_PacketBufferInit(PacketBuf_t *bufferInst, int maxNoOfPackets,
     bufferInst->numPacketsInBuffer = 0;
     bufferInst->packSizeSamples = 0;
     bufferInst->insertPosition = 0;
+    WebRtcNetEQ_PacketBufferClearIndex(bufferInst);
 
     /* Reset buffer statistics */
     bufferInst->discardedPackets = 0;
@@ -126,6 +311,7 @@ int WebRtcNetEQ_PacketBufferFlush(PacketBuf_t *bufferInst)
     bufferInst->numPacketsInBuffer = 0;
     bufferInst->currentMemoryPos = bufferInst->startPayloadMemory;
     bufferInst->insertPosition = 0;
+    WebRtcNetEQ_PacketBufferClearIndex(bufferInst);
 
     /* Clear all slots, starting with the last one */
     for (i = (bufferInst->maxInsertPositions - 1); i >= 0; i--)
@@ -199,16 +385,16 @@ int WebRtcNetEQ_PacketBufferInsert(PacketBuf_t *bufferInst, const RTPPacket_t *R
             tempMemAddress = &bufferInst->startPayloadMemory[bufferInst->memorySizeW16];
             nextPos = -1;
 
-            /* Loop through all slots again */
-            for (i = 0; i < bufferInst->maxInsertPositions; i++)
+            /* Loop through all non-empty slots */
+            for (i = 0; i < bufferInst->sortedCount; i++)
             {
-                /* Look for the non-empty slot with the lowest
-                 payload location address */
-                if (bufferInst->payloadLengthBytes[i] != 0 && bufferInst->payloadLocation[i]
-                    < tempMemAddress)
+                int slot = WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, i);
+
+                /* Look for the slot with the lowest payload location address */
+                if (bufferInst->payloadLocation[slot] < tempMemAddress)
                 {
-                    tempMemAddress = bufferInst->payloadLocation[i];
-                    nextPos = i;
+                    tempMemAddress = bufferInst->payloadLocation[slot];
+                    nextPos = slot;
                 }
             }
 
@@ -307,10 +493,11 @@ int WebRtcNetEQ_PacketBufferInsert(PacketBuf_t *bufferInst, const RTPPacket_t *R
     bufferInst->timeStamp[bufferInst->insertPosition] = RTPpacket->timeStamp;
     bufferInst->rcuPlCntr[bufferInst->insertPosition] = RTPpacket->rcuPlCntr;
     bufferInst->rcuPlCntr[bufferInst->insertPosition] = 0;
-    bufferInst->waitingTime[bufferInst->insertPosition] = 0;
+    bufferInst->waitingTime[bufferInst->insertPosition] = bufferInst->waitingTimeTicks;
     /* Update buffer parameters */
     bufferInst->numPacketsInBuffer++;
     bufferInst->currentMemoryPos += (RTPpacket->payloadLen + 1) >> 1;
+    WebRtcNetEQ_PacketBufferIndexInsert(bufferInst, bufferInst->insertPosition);
 
 #ifdef NETEQ_DELAY_LOGGING
     /* special code for offline delay logging */
@@ -371,7 +558,8 @@ int WebRtcNetEQ_PacketBufferExtract(PacketBuf_t *bufferInst, RTPPacket_t *RTPpac
     RTPpacket->seqNumber = bufferInst->seqNumber[bufferPosition];
     RTPpacket->timeStamp = bufferInst->timeStamp[bufferPosition];
     RTPpacket->rcuPlCntr = bufferInst->rcuPlCntr[bufferPosition];
-    *waitingTime = bufferInst->waitingTime[bufferPosition];
+    *waitingTime = (int) ((unsigned int) bufferInst->waitingTimeTicks
+        - (unsigned int) bufferInst->waitingTime[bufferPosition]);
     RTPpacket->starts_byte1 = 0; /* payload is 16-bit aligned */
 
     /* Clear the position in the packet buffer */
@@ -384,6 +572,40 @@ int WebRtcNetEQ_PacketBufferExtract(PacketBuf_t *bufferInst, RTPPacket_t *RTPpac
 
     /* Reduce packet counter with one */
     bufferInst->numPacketsInBuffer--;
+    WebRtcNetEQ_PacketBufferIndexRemove(bufferInst, bufferPosition);
+
+    return (0);
+}
+
+
+int WebRtcNetEQ_PacketBufferDiscard(PacketBuf_t *bufferInst, int bufferPosition)
+{
+    /* Sanity check */
+    if (bufferInst->startPayloadMemory == NULL)
+    {
+        /* packet buffer has not been initialized */
+        return (PBUFFER_NOT_INITIALIZED);
+    }
+
+    if (bufferPosition < 0 || bufferPosition >= bufferInst->maxInsertPositions)
+    {
+        /* buffer position is outside valid range */
+        return (NETEQ_OTHER_ERROR);
+    }
+
+    if (bufferInst->payloadLengthBytes[bufferPosition] <= 0)
+    {
+        /* The position does not contain a valid payload */
+        return (PBUFFER_NONEXISTING_PACKET);
+    }
+
+    /* Clear the position in the packet buffer */
+    bufferInst->payloadType[bufferPosition] = -1;
+    bufferInst->payloadLengthBytes[bufferPosition] = 0;
+
+    /* Reduce packet counter with one */
+    bufferInst->numPacketsInBuffer--;
+    WebRtcNetEQ_PacketBufferIndexRemove(bufferInst, bufferPosition);
 
     return (0);
 }
@@ -399,6 +621,7 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
     WebRtc_Word32 newDiff;
     int i;
     WebRtc_Word16 rcuPlCntr;
+    int erased = 0;
 
     /* Sanity check */
     if (bufferInst->startPayloadMemory == NULL)
@@ -420,6 +643,56 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
         return (0);
     }
 
+    if (bufferInst->sortedValid)
+    {
+        int headPos = WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, 0);
+        int tailPos = WebRtcNetEQ_PacketBufferSortedSlot(bufferInst,
+            bufferInst->sortedCount - 1);
+
+        /*
+         * If the difference to currentTS does not wrap between the oldest and
+         * the newest packet, the differences grow along the index. The packets
+         * that are too old are then found first and the lowest timestamp is
+         * the first packet that is kept.
+         */
+        if ((WebRtc_Word32) (bufferInst->timeStamp[headPos] - currentTS)
+            <= (WebRtc_Word32) (bufferInst->timeStamp[tailPos] - currentTS))
+        {
+            for (i = 0; (i < bufferInst->sortedCount) && eraseOldPkts; i++)
+            {
+                int slot = WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, i);
+
+                newDiff = (WebRtc_Word32) (bufferInst->timeStamp[slot] - currentTS);
+                if (newDiff >= 0)
+                {
+                    break;
+                }
+                if (newDiff > -30000) /* account for TS wrap-around */
+                {
+                    /* Throw away old packet */
+                    bufferInst->payloadType[slot] = -1;
+                    bufferInst->payloadLengthBytes[slot] = 0;
+                    bufferInst->numPacketsInBuffer--;
+                    bufferInst->discardedPackets++;
+                    erased = 1;
+                }
+            }
+
+            if (erased)
+            {
+                WebRtcNetEQ_PacketBufferIndexPrune(bufferInst);
+            }
+
+            if (bufferInst->sortedCount > 0)
+            {
+                *bufferPosition = WebRtcNetEQ_PacketBufferSortedSlot(bufferInst, 0);
+                *payloadType = bufferInst->payloadType[*bufferPosition];
+                *timestamp = bufferInst->timeStamp[*bufferPosition];
+            }
+            return 0;
+        }
+    }
+
     /* Loop through all slots in buffer */
     for (i = 0; i < bufferInst->maxInsertPositions; i++)
     {
@@ -443,6 +716,7 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
 
             /* Increase discard counter for in-call statistics */
             bufferInst->discardedPackets++;
+            erased = 1;
         }
         else if (((newDiff < timeStampDiff) || ((newDiff == timeStampDiff)
             && (bufferInst->rcuPlCntr[i] < rcuPlCntr))) && (bufferInst->payloadLengthBytes[i]
@@ -461,6 +735,11 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
         }
     } /* end of for loop */
 
+    if (erased)
+    {
+        WebRtcNetEQ_PacketBufferIndexPrune(bufferInst);
+    }
+
     /* check that we did find a real position */
     if (*bufferPosition >= 0)
     {
@@ -474,20 +753,10 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
 
 WebRtc_Word32 WebRtcNetEQ_PacketBufferGetSize(const PacketBuf_t *bufferInst)
 {
-    int i, count;
     WebRtc_Word32 sizeSamples;
 
-    count = 0;
-
-    /* Loop through all slots in the buffer */
-    for (i = 0; i < bufferInst->maxInsertPositions; i++)
-    {
-        /* Only count the packets with non-zero size */
-        if (bufferInst->payloadLengthBytes[i] != 0)
-        {
-            count++;
-        }
-    }
+    /* All packets with non-zero size are in the index */
+    int count = bufferInst->sortedCount;
 
     /*
      * Calculate buffer size as number of packets times packet size
@@ -505,14 +774,9 @@ WebRtc_Word32 WebRtcNetEQ_PacketBufferGetSize(const PacketBuf_t *bufferInst)
 }
 
 void WebRtcNetEQ_IncrementWaitingTimes(PacketBuf_t *buffer_inst) {
-  int i;
-  /* Loop through all slots in the buffer. */
-  for (i = 0; i < buffer_inst->maxInsertPositions; ++i) {
-    /* Only increment waiting time for the packets with non-zero size. */
-    if (buffer_inst->payloadLengthBytes[i] != 0) {
-      buffer_inst->waitingTime[i]++;
-    }
-  }
+  /* The waiting times are relative to this counter. */
+  buffer_inst->waitingTimeTicks =
+      (int) ((unsigned int) buffer_inst->waitingTimeTicks + 1);
 }
 
 int WebRtcNetEQ_GetDefaultCodecSettings(const enum WebRtcNetEQDecoder *codecID,
@@ -712,7 +976,8 @@ int WebRtcNetEQ_GetDefaultCodecSettings(const enum WebRtcNetEQDecoder *codecID,
     + sizeof(WebRtc_Word16)  /* payloadType */
     + sizeof(WebRtc_Word16)  /* payloadLengthBytes */
     + sizeof(WebRtc_Word16)  /* rcuPlCntr   */
-    + sizeof(int));          /* waitingTime */
+    + sizeof(int)            /* waitingTime */
+    + sizeof(WebRtc_Word16)); /* sortedSlots */
     /* Add the extra size per slot to the memory count */
     *maxBytes += w16_tmp * (*maxSlots);
 
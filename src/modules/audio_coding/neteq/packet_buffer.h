@@ -49,8 +49,15 @@ typedef struct
     WebRtc_Word16 *payloadLengthBytes; /* Payload length of packet in slot n */
     WebRtc_Word16 *rcuPlCntr; /* zero for non-RCU payload, 1 for main payload
      2 for redundant payload */
-    int *waitingTime;
+    int *waitingTime; /* Value of waitingTimeTicks when slot n was filled */
+    WebRtc_Word16 *sortedSlots; /* Ring of occupied slots, lowest timestamp first */
 
+    /* Timestamp index into the slot arrays */
+    int sortedHead; /* Position in sortedSlots of the lowest timestamp */
+    int sortedCount; /* Number of slots in sortedSlots */
+    int sortedValid; /* 0 if the timestamps span more than half the range */
+
+    int waitingTimeTicks; /* Number of calls to WebRtcNetEQ_IncrementWaitingTimes */
 
     /* Statistics counter */
     WebRtc_UWord16 discardedPackets; /* Number of discarded packets */
@@ -140,10 +147,30 @@ int WebRtcNetEQ_PacketBufferInsert(PacketBuf_t *bufferInst, const RTPPacket_t *R
 int WebRtcNetEQ_PacketBufferExtract(PacketBuf_t *bufferInst, RTPPacket_t *RTPpacket,
                                     int bufferPosition, int *waitingTime);
 
+/****************************************************************************
+ * WebRtcNetEQ_PacketBufferDiscard(...)
+ *
+ * This function discards a packet from the buffer without extracting it.
+ *
+ * Input:
+ *		- bufferInst	: Buffer instance
+ *		- bufferPosition: Position of the packet that should be discarded
+ *
+ * Output:
+ *      - bufferInst    : Updated buffer instance
+ *
+ * Return value			:  0 - Ok
+ *						  <0 - Error
+ */
+
+int WebRtcNetEQ_PacketBufferDiscard(PacketBuf_t *bufferInst, int bufferPosition);
+
 /****************************************************************************
  * WebRtcNetEQ_PacketBufferFindLowestTimestamp(...)
  *
- * This function finds the next packet with the lowest timestamp.
+ * This function finds the next packet with the lowest timestamp. The
+ * packets are kept in timestamp order, so this is normally done without
+ * visiting the empty slots of the buffer.
  *
  * Input:
  *		- bufferInst	: Buffer instance
@@ -171,9 +198,8 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
  *
  * Calculate and return an estimate of the total data length (in samples)
  * currently in the buffer. The estimate is calculated as the number of
- * packets currently in the buffer (which does not have any remaining waiting
- * time), multiplied with the number of samples obtained from the last
- * decoded packet.
+ * packets currently in the buffer, multiplied with the number of samples
+ * obtained from the last decoded packet.
  *
  * Input:
  *		- bufferInst	: Buffer instance
@@ -186,7 +212,9 @@ WebRtc_Word32 WebRtcNetEQ_PacketBufferGetSize(const PacketBuf_t *bufferInst);
 /****************************************************************************
  * WebRtcNetEQ_IncrementWaitingTimes(...)
  *
- * Increment the waiting time for all packets in the buffer by one.
+ * Increment the waiting time for all packets in the buffer by one. The
+ * waiting time of a packet is counted from the tick it was inserted at, so
+ * this does not touch the individual slots.
  *
  * Input:
  *    - bufferInst  : Buffer instance
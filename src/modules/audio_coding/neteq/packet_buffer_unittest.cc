@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Unit tests for the NetEQ packet buffer.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "modules/audio_coding/neteq/packet_buffer.h"
+}
+
+namespace webrtc {
+
+class PacketBufferTest : public ::testing::Test {
+ protected:
+  static const int kMaxPackets = 20;
+  static const int kPayloadBytes = 20;
+
+  PacketBufferTest() : memory_(2000) {}
+
+  virtual void SetUp() {
+    ASSERT_EQ(0, WebRtcNetEQ_PacketBufferInit(&buffer_, kMaxPackets,
+                                              &memory_[0],
+                                              static_cast<int>(memory_.size())));
+    for (int i = 0; i < kPayloadBytes / 2; ++i) {
+      payload_[i] = i;
+    }
+  }
+
+  void Insert(WebRtc_UWord32 timestamp, WebRtc_UWord16 seq_no) {
+    RTPPacket_t packet;
+    packet.payloadType = 0;
+    packet.seqNumber = seq_no;
+    packet.timeStamp = timestamp;
+    packet.ssrc = 0;
+    packet.rcuPlCntr = 0;
+    packet.payload = payload_;
+    packet.payloadLen = kPayloadBytes;
+    packet.starts_byte1 = 0;
+    WebRtc_Word16 flushed;
+    ASSERT_EQ(0, WebRtcNetEQ_PacketBufferInsert(&buffer_, &packet, &flushed));
+    EXPECT_EQ(0, flushed);
+  }
+
+  // Extracts the packet with the lowest timestamp and returns its timestamp.
+  WebRtc_UWord32 ExtractLowest(WebRtc_UWord32 current_ts, int* waiting_time) {
+    WebRtc_UWord32 timestamp;
+    int position;
+    WebRtc_Word16 payload_type;
+    EXPECT_EQ(0, WebRtcNetEQ_PacketBufferFindLowestTimestamp(
+        &buffer_, current_ts, &timestamp, &position, 1, &payload_type));
+    EXPECT_NE(-1, position);
+    WebRtc_Word16 data[kPayloadBytes / 2];
+    RTPPacket_t packet;
+    packet.payload = data;
+    EXPECT_EQ(0, WebRtcNetEQ_PacketBufferExtract(&buffer_, &packet, position,
+                                                 waiting_time));
+    EXPECT_EQ(timestamp, packet.timeStamp);
+    return packet.timeStamp;
+  }
+
+  PacketBuf_t buffer_;
+  std::vector<WebRtc_Word16> memory_;
+  WebRtc_Word16 payload_[kPayloadBytes / 2];
+};
+
+TEST_F(PacketBufferTest, ExtractsInTimestampOrder) {
+  const WebRtc_UWord32 kTimestamps[] = {160, 480, 320, 800, 640, 960};
+  const int kNumPackets = sizeof(kTimestamps) / sizeof(kTimestamps[0]);
+  for (int i = 0; i < kNumPackets; ++i) {
+    Insert(kTimestamps[i], i);
+  }
+  EXPECT_EQ(kNumPackets, buffer_.numPacketsInBuffer);
+
+  int waiting_time;
+  for (WebRtc_UWord32 ts = 160; ts <= 960; ts += 160) {
+    EXPECT_EQ(ts, ExtractLowest(0, &waiting_time));
+  }
+  EXPECT_EQ(0, buffer_.numPacketsInBuffer);
+}
+
+TEST_F(PacketBufferTest, HandlesTimestampWrapAround) {
+  Insert(0x00000040, 2);
+  Insert(0xFFFFFF00, 0);
+  Insert(0xFFFFFFA0, 1);
+
+  int waiting_time;
+  EXPECT_EQ(0xFFFFFF00, ExtractLowest(0xFFFFFF00, &waiting_time));
+  EXPECT_EQ(0xFFFFFFA0, ExtractLowest(0xFFFFFF00, &waiting_time));
+  EXPECT_EQ(0x00000040u, ExtractLowest(0xFFFFFF00, &waiting_time));
+}
+
+TEST_F(PacketBufferTest, DiscardsOldPackets) {
+  for (int i = 0; i < 5; ++i) {
+    Insert(1000 + 160 * i, i);
+  }
+  int waiting_time;
+  // The first three packets are older than the current timestamp.
+  EXPECT_EQ(1480u, ExtractLowest(1400, &waiting_time));
+  EXPECT_EQ(3, buffer_.discardedPackets);
+  EXPECT_EQ(1, buffer_.numPacketsInBuffer);
+  EXPECT_EQ(1640u, ExtractLowest(1400, &waiting_time));
+}
+
+TEST_F(PacketBufferTest, DiscardRemovesPacket) {
+  Insert(160, 0);
+  Insert(320, 1);
+
+  WebRtc_UWord32 timestamp;
+  int position;
+  WebRtc_Word16 payload_type;
+  ASSERT_EQ(0, WebRtcNetEQ_PacketBufferFindLowestTimestamp(
+      &buffer_, 0, &timestamp, &position, 1, &payload_type));
+  EXPECT_EQ(160u, timestamp);
+  EXPECT_EQ(0, WebRtcNetEQ_PacketBufferDiscard(&buffer_, position));
+  EXPECT_GT(0, WebRtcNetEQ_PacketBufferDiscard(&buffer_, position));
+  EXPECT_EQ(1, buffer_.numPacketsInBuffer);
+
+  int waiting_time;
+  EXPECT_EQ(320u, ExtractLowest(0, &waiting_time));
+}
+
+TEST_F(PacketBufferTest, CountsWaitingTime) {
+  Insert(160, 0);
+  WebRtcNetEQ_IncrementWaitingTimes(&buffer_);
+  WebRtcNetEQ_IncrementWaitingTimes(&buffer_);
+  Insert(320, 1);
+  WebRtcNetEQ_IncrementWaitingTimes(&buffer_);
+
+  int waiting_time;
+  ExtractLowest(0, &waiting_time);
+  EXPECT_EQ(3, waiting_time);
+  ExtractLowest(0, &waiting_time);
+  EXPECT_EQ(1, waiting_time);
+}
+
+TEST_F(PacketBufferTest, FlushEmptiesBuffer) {
+  for (int i = 0; i < 5; ++i) {
+    Insert(160 * i, i);
+  }
+  EXPECT_EQ(0, WebRtcNetEQ_PacketBufferFlush(&buffer_));
+  EXPECT_EQ(0, buffer_.numPacketsInBuffer);
+  EXPECT_EQ(0, WebRtcNetEQ_PacketBufferGetSize(&buffer_));
+
+  WebRtc_UWord32 timestamp;
+  int position;
+  WebRtc_Word16 payload_type;
+  EXPECT_EQ(0, WebRtcNetEQ_PacketBufferFindLowestTimestamp(
+      &buffer_, 0, &timestamp, &position, 1, &payload_type));
+  EXPECT_EQ(-1, position);
+
+  Insert(1000, 5);
+  int waiting_time;
+  EXPECT_EQ(1000u, ExtractLowest(0, &waiting_time));
+}
+
+}  // namespace webrtc
@@ -36,6 +36,7 @@ int WebRtcNetEQ_RecInInternal(MCUInst_t *MCU_inst, RTPPacket_t *RTPpacketInput,
     int curr_Codec;
     WebRtc_Word16 isREDPayload = 0;
     WebRtc_Word32 temp_bufsize = MCU_inst->PacketBuffer_inst.numPacketsInBuffer;
+    int numChannels = 1;
 #ifdef NETEQ_RED_CODEC
     RTPPacket_t* RTPpacketPtr[2]; /* Support for redundancy up to 2 payloads */
     RTPpacketPtr[0] = &RTPpacket[0];
@@ -122,6 +123,13 @@ int WebRtcNetEQ_RecInInternal(MCUInst_t *MCU_inst, RTPPacket_t *RTPpacketInput,
             RTPpacket[i_k].rcuPlCntr = 0;
         }
 
+#ifdef NETEQ_STEREO
+        /* Multichannel payloads hold all channels; split info is per channel */
+        numChannels = WebRtcNetEQ_DbGetChannels(&MCU_inst->codec_DB_inst,
+            (enum WebRtcNetEQDecoder) WebRtcNetEQ_DbGetCodec(&MCU_inst->codec_DB_inst,
+                RTPpacket[i_k].payloadType));
+#endif
+
         /* Force update of SplitInfo if it's iLBC because of potential change between 20/30ms */
         if (RTPpacket[i_k].payloadType == WebRtcNetEQ_DbGetPayload(&MCU_inst->codec_DB_inst,
             kDecoderILBC))
@@ -129,7 +137,7 @@ int WebRtcNetEQ_RecInInternal(MCUInst_t *MCU_inst, RTPPacket_t *RTPpacketInput,
             i_ok = WebRtcNetEQ_DbGetSplitInfo(
                 &MCU_inst->PayloadSplit_inst,
                 (enum WebRtcNetEQDecoder) WebRtcNetEQ_DbGetCodec(&MCU_inst->codec_DB_inst,
-                    RTPpacket[i_k].payloadType), RTPpacket[i_k].payloadLen);
+                    RTPpacket[i_k].payloadType), RTPpacket[i_k].payloadLen / numChannels);
             if (i_ok < 0)
             {
                 /* error returned */
@@ -239,7 +247,7 @@ int WebRtcNetEQ_RecInInternal(MCUInst_t *MCU_inst, RTPPacket_t *RTPpacketInput,
                 MCU_inst->current_Payload = RTPpacket[i_k].payloadType;
                 i_ok = WebRtcNetEQ_DbGetSplitInfo(&MCU_inst->PayloadSplit_inst,
                     (enum WebRtcNetEQDecoder) MCU_inst->current_Codec,
-                    RTPpacket[i_k].payloadLen);
+                    RTPpacket[i_k].payloadLen / numChannels);
                 if (i_ok < 0)
                 { /* error returned */
                     return i_ok;
@@ -249,8 +257,19 @@ int WebRtcNetEQ_RecInInternal(MCUInst_t *MCU_inst, RTPPacket_t *RTPpacketInput,
             }
 
             /* Parse the payload and insert it into the buffer */
-            i_ok = WebRtcNetEQ_SplitAndInsertPayload(&RTPpacket[i_k],
-                &MCU_inst->PacketBuffer_inst, &MCU_inst->PayloadSplit_inst, &flushed);
+#ifdef NETEQ_STEREO
+            if (numChannels > 1)
+            {
+                i_ok = WebRtcNetEQ_SplitAndInsertMultichannel(&RTPpacket[i_k],
+                    &MCU_inst->PacketBuffer_inst, &MCU_inst->PayloadSplit_inst, numChannels,
+                    &flushed);
+            }
+            else
+#endif
+            {
+                i_ok = WebRtcNetEQ_SplitAndInsertPayload(&RTPpacket[i_k],
+                    &MCU_inst->PacketBuffer_inst, &MCU_inst->PayloadSplit_inst, &flushed);
+            }
             if (i_ok < 0)
             {
                 return i_ok;
@@ -210,9 +210,13 @@ int WebRtcNetEQ_RecOutInternal(DSPInst_t *inst, WebRtc_Word16 *pw16_outData,
         dspInfo->lastMode |= MODE_MASTER_DTMF_SIGNAL;
     }
 
-    if (msInfo->msMode != NETEQ_MONO)
+    if ((msInfo->msMode != NETEQ_MONO)
+        && (((MainInst_t *) inst->main_inst)->maxChannels <= 1))
     {
-        /* We are using stereo mode; signal this to MCU side */
+        /*
+         * We are using stereo mode with separate instances; signal this to MCU
+         * side (a multichannel instance has only one MCU side for all channels)
+         */
         dspInfo->lastMode |= MODE_USING_STEREO;
     }
 #endif
@@ -241,7 +245,18 @@ int WebRtcNetEQ_RecOutInternal(DSPInst_t *inst, WebRtc_Word16 *pw16_outData,
      * decision history. Instructions, encoded data and function pointers will be written
      * to the shared memory.
      */
-    return_value = WebRtcNetEQ_DSP2MCUinterrupt((MainInst_t *) inst->main_inst, sharedMem);
+#ifdef NETEQ_STEREO
+    if (((MainInst_t *) inst->main_inst)->maxChannels > 1)
+    {
+        /* One decision for all channels; read this channel's part of it */
+        return_value = WebRtcNetEQ_DSP2MCUinterruptChannel((MainInst_t *) inst->main_inst,
+            inst->w16_channel, sharedMem);
+    }
+    else
+#endif
+    {
+        return_value = WebRtcNetEQ_DSP2MCUinterrupt((MainInst_t *) inst->main_inst, sharedMem);
+    }
 
     /* Read MCU data and instructions */
     instr = (WebRtc_UWord16) (inst->pw16_readAddress[0] & 0xf000);
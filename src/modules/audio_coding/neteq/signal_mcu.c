@@ -211,9 +211,11 @@ int WebRtcNetEQ_SignalMcu(MCUInst_t *inst)
         {
 
             /* Don't use this packet, discard it */
-            inst->PacketBuffer_inst.payloadType[i_bufferpos] = -1;
-            inst->PacketBuffer_inst.payloadLengthBytes[i_bufferpos] = 0;
-            inst->PacketBuffer_inst.numPacketsInBuffer--;
+            i_res = WebRtcNetEQ_PacketBufferDiscard(&inst->PacketBuffer_inst, i_bufferpos);
+            if (i_res < 0)
+            { /* error returned */
+                return i_res;
+            }
 
             /* Check buffer again */
             WebRtcNetEQ_PacketBufferFindLowestTimestamp(&inst->PacketBuffer_inst,
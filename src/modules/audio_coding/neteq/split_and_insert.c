@@ -139,3 +139,134 @@ int WebRtcNetEQ_SplitAndInsertPayload(RTPPacket_t *packet, PacketBuf_t *Buffer_i
     return 0;
 }
 
+#ifdef NETEQ_STEREO
+
+void WebRtcNetEQ_CopyPayloadBytes(WebRtc_Word16 *pw16_dst, int dstByte,
+                                  const WebRtc_Word16 *pw16_src, int srcByte,
+                                  int numBytes)
+{
+    int i;
+
+    if (((dstByte | srcByte) & 0x1) == 0)
+    {
+        /* Both aligned; copy whole words and the odd byte at the end, if any */
+        WEBRTC_SPL_MEMCPY_W16(&pw16_dst[dstByte >> 1], &pw16_src[srcByte >> 1],
+            numBytes >> 1);
+        if (numBytes & 0x1)
+        {
+            WEBRTC_SPL_SET_BYTE(pw16_dst,
+                (WebRtc_UWord8) WEBRTC_SPL_GET_BYTE(pw16_src, srcByte + numBytes - 1),
+                dstByte + numBytes - 1);
+        }
+    }
+    else
+    {
+        for (i = 0; i < numBytes; i++)
+        {
+            WEBRTC_SPL_SET_BYTE(pw16_dst,
+                (WebRtc_UWord8) WEBRTC_SPL_GET_BYTE(pw16_src, srcByte + i), dstByte + i);
+        }
+    }
+}
+
+int WebRtcNetEQ_SplitAndInsertMultichannel(RTPPacket_t *packet, PacketBuf_t *Buffer_inst,
+                                           SplitInfo_t *split_inst, int numChannels,
+                                           WebRtc_Word16 *flushed)
+{
+
+    int i_ok;
+    int c;
+    int channelLen; /* payload bytes per channel */
+    int chunkLen = 0; /* bytes per channel in each inserted part */
+    int len;
+    int pos;
+    int softSplit = (split_inst->deltaBytes < -10);
+    WebRtc_UWord32 timestampsPerChunk = 0;
+    RTPPacket_t temp_packet;
+    WebRtc_Word16 localFlushed = 0;
+    /* The parts are gathered here, since the channels are not adjacent */
+    WebRtc_Word16 pw16_chunk[NETEQ_MAX_FRAME_SIZE];
+    *flushed = 0;
+
+    channelLen = packet->payloadLen / numChannels;
+
+    if (softSplit)
+    {
+        /* G711, PCM16B or G722; find the chunk size as for one channel */
+        int mult = WEBRTC_SPL_ABS_W32(split_inst->deltaBytes) - 10;
+
+        chunkLen = channelLen;
+        while (chunkLen >= ((80 << split_inst->deltaTime) * mult))
+        {
+            chunkLen >>= 1;
+        }
+
+        /* The last part may be up to twice the chunk size */
+        while ((2 * chunkLen * numChannels) > (int) sizeof(pw16_chunk))
+        {
+            chunkLen >>= 1;
+        }
+
+        /* Make the size an even value. */
+        if (chunkLen > 1)
+        {
+            chunkLen >>= 1;
+            chunkLen *= 2;
+        }
+        timestampsPerChunk = (2 * chunkLen) >> split_inst->deltaTime;
+    }
+    else if ((split_inst->deltaBytes != NO_SPLIT) && ((split_inst->deltaBytes
+        * numChannels) <= (int) sizeof(pw16_chunk)))
+    {
+        /* Frame based codec, use hard splitting. */
+        chunkLen = split_inst->deltaBytes;
+        timestampsPerChunk = split_inst->deltaTime;
+    }
+
+    if ((chunkLen <= 0) || (chunkLen >= channelLen))
+    {
+        /* Not splittable, or nothing to split */
+        i_ok = WebRtcNetEQ_PacketBufferInsert(Buffer_inst, packet, &localFlushed);
+        *flushed |= localFlushed;
+        if (i_ok < 0)
+        {
+            return PBUFFER_INSERT_ERROR5;
+        }
+        return 0;
+    }
+
+    WEBRTC_SPL_MEMCPY_W8(&temp_packet,packet,sizeof(RTPPacket_t));
+    temp_packet.payload = pw16_chunk;
+    temp_packet.starts_byte1 = 0;
+
+    pos = 0;
+    while (pos < channelLen)
+    {
+        len = WEBRTC_SPL_MIN(chunkLen, channelLen - pos);
+        if (softSplit && ((channelLen - pos) < (2 * chunkLen)))
+        {
+            /* Insert the rest */
+            len = channelLen - pos;
+        }
+
+        for (c = 0; c < numChannels; c++)
+        {
+            WebRtcNetEQ_CopyPayloadBytes(pw16_chunk, c * len, packet->payload,
+                packet->starts_byte1 + c * channelLen + pos, len);
+        }
+        temp_packet.payloadLen = (WebRtc_Word16) (len * numChannels);
+
+        i_ok = WebRtcNetEQ_PacketBufferInsert(Buffer_inst, &temp_packet, &localFlushed);
+        *flushed |= localFlushed;
+        if (i_ok < 0)
+        {
+            return PBUFFER_INSERT_ERROR1;
+        }
+        temp_packet.timeStamp += timestampsPerChunk;
+        pos += len;
+    }
+
+    return 0;
+}
+
+#endif /* NETEQ_STEREO */
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the RecIn and RecOut throughput of NetEQ with a deep jitter
+// buffer, as seen when audio is delayed to sync with video. A number of
+// NetEQ instances are fed 10 ms PCMu packets, slightly reordered, while
+// the buffer of each instance holds a configurable amount of audio.
+//
+// Usage: NetEqBenchmark [num_channels [buffer_depth_ms [seconds]]]
+// By default 100 channels with a 1000 ms deep buffer are run for 10 s.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "g711_interface.h"
+#include "system_wrappers/interface/tick_util.h"
+#include "webrtc_neteq.h"
+#include "webrtc_neteq_help_macros.h"
+#include "webrtc_neteq_internal.h"
+
+namespace {
+
+const int kSampleRateHz = 8000;
+const int kPacketMs = 10;
+const int kSamplesPerPacket = kSampleRateHz / 1000 * kPacketMs;
+const int kPayloadTypePcmu = 0;
+// Every kReorderInterval:th pair of packets is delivered in swapped order.
+const int kReorderInterval = 7;
+
+class Channel {
+ public:
+  Channel()
+      : inst_(NULL),
+        seq_no_(0),
+        timestamp_(0) {}
+
+  ~Channel() {}
+
+  bool Init() {
+    int size;
+    if (WebRtcNetEQ_AssignSize(&size) != 0) {
+      return false;
+    }
+    inst_memory_.resize(size);
+    if (WebRtcNetEQ_Assign(&inst_, &inst_memory_[0]) != 0 ||
+        WebRtcNetEQ_Init(inst_, kSampleRateHz) != 0) {
+      return false;
+    }
+
+    WebRtcNetEQDecoder codec = kDecoderPCMu;
+    int max_packets;
+    if (WebRtcNetEQ_GetRecommendedBufferSize(inst_, &codec, 1,
+                                             kTCPXLargeJitter, &max_packets,
+                                             &size) != 0) {
+      return false;
+    }
+    buffer_memory_.resize(size);
+    if (WebRtcNetEQ_AssignBuffer(inst_, max_packets, &buffer_memory_[0],
+                                 size) != 0) {
+      return false;
+    }
+
+    WebRtcNetEQ_CodecDef codec_def;
+    SET_CODEC_PAR(codec_def, kDecoderPCMu, kPayloadTypePcmu, NULL,
+                  kSampleRateHz);
+    SET_PCMU_FUNCTIONS(codec_def);
+    if (WebRtcNetEQ_CodecDbAdd(inst_, &codec_def) != 0) {
+      return false;
+    }
+    // Hold on to whatever is buffered instead of time-stretching it away,
+    // so that the buffer depth stays what the benchmark asks for.
+    return WebRtcNetEQ_SetPlayoutMode(inst_, kPlayoutFax) == 0;
+  }
+
+  bool InsertPacket(const WebRtc_UWord8* payload, WebRtc_UWord32 time_ms) {
+    WebRtcNetEQ_RTPInfo rtp_info;
+    rtp_info.payloadType = kPayloadTypePcmu;
+    rtp_info.SSRC = 0x12345678;
+    rtp_info.markerBit = 0;
+    // Swap every kReorderInterval:th pair of packets.
+    WebRtc_UWord16 seq_no = seq_no_;
+    if (seq_no % kReorderInterval == 0) {
+      ++seq_no;
+    } else if (seq_no % kReorderInterval == 1) {
+      --seq_no;
+    }
+    rtp_info.sequenceNumber = seq_no;
+    rtp_info.timeStamp = timestamp_ +
+        (seq_no - seq_no_) * kSamplesPerPacket;
+    ++seq_no_;
+    timestamp_ += kSamplesPerPacket;
+    return WebRtcNetEQ_RecInRTPStruct(inst_, &rtp_info, payload,
+                                      kSamplesPerPacket,
+                                      time_ms * (kSampleRateHz / 1000)) == 0;
+  }
+
+  bool GetAudio() {
+    WebRtc_Word16 out[kSamplesPerPacket * 6];
+    WebRtc_Word16 out_len;
+    return WebRtcNetEQ_RecOut(inst_, out, &out_len) == 0;
+  }
+
+  int BufferSizeMs() {
+    WebRtcNetEQ_NetworkStatistics stats;
+    if (WebRtcNetEQ_GetNetworkStatistics(inst_, &stats) != 0) {
+      return -1;
+    }
+    return stats.currentBufferSize;
+  }
+
+ private:
+  void* inst_;
+  std::vector<WebRtc_Word8> inst_memory_;
+  std::vector<WebRtc_Word8> buffer_memory_;
+  WebRtc_UWord16 seq_no_;
+  WebRtc_UWord32 timestamp_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int num_channels = argc > 1 ? atoi(argv[1]) : 100;
+  const int depth_ms = argc > 2 ? atoi(argv[2]) : 1000;
+  const int seconds = argc > 3 ? atoi(argv[3]) : 10;
+  if (num_channels < 1 || depth_ms < 0 || seconds < 1) {
+    printf("Usage: %s [num_channels [buffer_depth_ms [seconds]]]\n",
+           argv[0]);
+    return 1;
+  }
+
+  WebRtc_UWord8 payload[kSamplesPerPacket];
+  for (int i = 0; i < kSamplesPerPacket; ++i) {
+    payload[i] = static_cast<WebRtc_UWord8>(rand());
+  }
+
+  std::vector<Channel> channels(num_channels);
+  for (int i = 0; i < num_channels; ++i) {
+    if (!channels[i].Init()) {
+      printf("Failed to create NetEQ instance %d\n", i);
+      return 1;
+    }
+  }
+
+  // Fill the buffers before the clock starts running.
+  WebRtc_UWord32 time_ms = 0;
+  for (int k = 0; k < depth_ms / kPacketMs; ++k) {
+    for (int i = 0; i < num_channels; ++i) {
+      if (!channels[i].InsertPacket(payload, time_ms)) {
+        printf("RecIn failed\n");
+        return 1;
+      }
+    }
+  }
+
+  const int num_frames = seconds * 1000 / kPacketMs;
+  WebRtc_Word64 rec_in_us = 0;
+  WebRtc_Word64 rec_out_us = 0;
+  for (int k = 0; k < num_frames; ++k) {
+    webrtc::TickTime start = webrtc::TickTime::Now();
+    for (int i = 0; i < num_channels; ++i) {
+      if (!channels[i].InsertPacket(payload, time_ms)) {
+        printf("RecIn failed\n");
+        return 1;
+      }
+    }
+    webrtc::TickTime middle = webrtc::TickTime::Now();
+    for (int i = 0; i < num_channels; ++i) {
+      if (!channels[i].GetAudio()) {
+        printf("RecOut failed\n");
+        return 1;
+      }
+    }
+    rec_in_us += (middle - start).Microseconds();
+    rec_out_us += (webrtc::TickTime::Now() - middle).Microseconds();
+    time_ms += kPacketMs;
+  }
+
+  const double calls = static_cast<double>(num_frames) * num_channels;
+  printf("%d channels, %d ms buffered (%d ms at end), %d s\n", num_channels,
+         depth_ms, channels[0].BufferSizeMs(), seconds);
+  printf("RecIn:  %8.3f us/packet\n", rec_in_us / calls);
+  printf("RecOut: %8.3f us/10 ms\n", rec_out_us / calls);
+  printf("Total:  %8.1f us per 10 ms for all channels\n",
+         (rec_in_us + rec_out_us) / static_cast<double>(num_frames));
+  return 0;
+}
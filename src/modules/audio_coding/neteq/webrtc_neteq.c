@@ -133,6 +133,11 @@ int WebRtcNetEQ_GetErrorName(int errorCode, WebRtc_Word8 *errorName, int maxStrL
             WebRtcNetEQ_strncpy(errorName, maxStrLen, "MASTER_SLAVE_ERROR", maxStrLen);
             break;
         }
+        case 1008:
+        {
+            WebRtcNetEQ_strncpy(errorName, maxStrLen, "FAULTY_NUMBER_OF_CHANNELS", maxStrLen);
+            break;
+        }
         case 2001:
         {
             WebRtcNetEQ_strncpy(errorName, maxStrLen, "UNKNOWN_BUFSTAT_DECISION", maxStrLen);
@@ -358,6 +363,13 @@ int WebRtcNetEQ_GetRecommendedBufferSize(void *inst, const enum WebRtcNetEQDecod
     }
     *MaxNoOfPackets = (*MaxNoOfPackets) * multiplier;
     *sizeinbytes = (*sizeinbytes) * multiplier;
+#ifdef NETEQ_STEREO
+    if (NetEqMainInst->maxChannels > 1)
+    {
+        /* Payloads hold all channels */
+        *sizeinbytes = (*sizeinbytes) * NetEqMainInst->maxChannels;
+    }
+#endif
     if (ok != 0)
     {
         NetEqMainInst->ErrorCode = -ok;
@@ -382,6 +394,101 @@ int WebRtcNetEQ_AssignBuffer(void *inst, int MaxNoOfPackets, void *NETEQ_Buffer_
     return (ok);
 }
 
+#ifdef NETEQ_STEREO
+/* Initialize the DSP side of channel 1 and up of a multichannel instance */
+static int WebRtcNetEQ_InitChannel(MainInst_t *NetEqMainInst, int channel)
+{
+    int ok;
+    DSPInst_t *channelInst = &NetEqMainInst->channelDSPinst[channel - 1];
+
+    channelInst->w16_channel = (WebRtc_Word16) channel;
+    ok = WebRtcNetEQ_AddressInit(channelInst, NULL, NULL, NetEqMainInst);
+    if (ok != 0) return (ok);
+    ok = WebRtcNetEQ_DSPInit(channelInst, NetEqMainInst->DSPinst.fs);
+    if (ok != 0) return (ok);
+    channelInst->BGNInst.bgnMode = NetEqMainInst->DSPinst.BGNInst.bgnMode;
+    ok = WebRtcNetEQ_ClearInCallStats(channelInst);
+    if (ok != 0) return (ok);
+    return (WebRtcNetEQ_ClearPostCallStats(channelInst));
+}
+#endif
+
+int WebRtcNetEQ_AssignChannelsSize(int numChannels, int *sizeinbytes)
+{
+#ifndef NETEQ_STEREO
+    /* Multichannel not supported */
+    return (-1);
+#else
+    if ((numChannels < 1) || (numChannels > NETEQ_MAX_CHANNELS)) return (-1);
+    if (numChannels == 1)
+    {
+        /* A mono instance needs no extra memory */
+        *sizeinbytes = 0;
+        return (0);
+    }
+
+    /* DSP instances and decoder states of channel 1 and up, and the MCU output */
+    *sizeinbytes = (numChannels - 1) * (sizeof(DSPInst_t) + NUM_TOTAL_CODECS * sizeof(void*))
+        + numChannels * SHARED_MEM_SIZE * sizeof(WebRtc_Word16);
+    return (0);
+#endif
+}
+
+int WebRtcNetEQ_AssignChannels(void *inst, int numChannels, void *channelsAddr,
+                               int sizeinbytes)
+{
+#ifndef NETEQ_STEREO
+    /* Multichannel not supported */
+    return (-1);
+#else
+    int ok = 0;
+    int i;
+    int requiredSize;
+    MainInst_t *NetEqMainInst = (MainInst_t*) inst;
+    if (NetEqMainInst == NULL) return (-1);
+
+    if (WebRtcNetEQ_AssignChannelsSize(numChannels, &requiredSize) != 0)
+    {
+        NetEqMainInst->ErrorCode = -FAULTY_NUMBER_OF_CHANNELS;
+        return (-1);
+    }
+
+    NetEqMainInst->maxChannels = 1;
+    NetEqMainInst->numChannels = 1;
+    NetEqMainInst->outputChannels = 1;
+    NetEqMainInst->channelDSPinst = NULL;
+    NetEqMainInst->channelCodecState = NULL;
+    NetEqMainInst->pw16_mcuOutput = NULL;
+    if (numChannels == 1)
+    {
+        /* Back to mono; the memory is not used */
+        return (0);
+    }
+
+    if ((channelsAddr == NULL) || (sizeinbytes < requiredSize))
+    {
+        NetEqMainInst->ErrorCode = -NETEQ_OTHER_ERROR;
+        return (-1);
+    }
+    WebRtcSpl_MemSetW16((WebRtc_Word16*) channelsAddr, 0, requiredSize / sizeof(WebRtc_Word16));
+
+    NetEqMainInst->channelDSPinst = (DSPInst_t*) channelsAddr;
+    NetEqMainInst->channelCodecState =
+        (void**) &NetEqMainInst->channelDSPinst[numChannels - 1];
+    NetEqMainInst->pw16_mcuOutput =
+        (WebRtc_Word16*) &NetEqMainInst->channelCodecState[(numChannels - 1) * NUM_TOTAL_CODECS];
+    NetEqMainInst->maxChannels = (WebRtc_Word16) numChannels;
+
+    for (i = 1; i < numChannels; i++)
+    {
+        ok = WebRtcNetEQ_InitChannel(NetEqMainInst, i);
+        RETURN_ON_ERROR(ok, NetEqMainInst);
+    }
+
+    return (0);
+#endif
+}
+
 /************************************************
  * Init functions
  */
@@ -405,6 +512,9 @@ int WebRtcNetEQ_AssignBuffer(void *inst, int MaxNoOfPackets, void *NETEQ_Buffer_
 int WebRtcNetEQ_Init(void *inst, WebRtc_UWord16 fs)
 {
     int ok = 0;
+#ifdef NETEQ_STEREO
+    int i;
+#endif
 
     /* Typecast inst to internal instance format */
     MainInst_t *NetEqMainInst = (MainInst_t*) inst;
@@ -414,6 +524,9 @@ int WebRtcNetEQ_Init(void *inst, WebRtc_UWord16 fs)
         return (-1);
     }
 
+    /* Select the fastest signal processing functions for this CPU */
+    WebRtcSpl_Init();
+
 #ifdef NETEQ_VAD
     /* Start out with no PostDecode VAD instance */
     NetEqMainInst->DSPinst.VADInst.VADState = NULL;
@@ -474,6 +587,15 @@ int WebRtcNetEQ_Init(void *inst, WebRtc_UWord16 fs)
 #ifdef NETEQ_STEREO
     /* set master/slave info to undecided */
     NetEqMainInst->masterSlave = 0;
+
+    /* init the other channels of a multichannel instance */
+    for (i = 1; i < NetEqMainInst->maxChannels; i++)
+    {
+        ok = WebRtcNetEQ_InitChannel(NetEqMainInst, i);
+        RETURN_ON_ERROR(ok, NetEqMainInst);
+    }
+    NetEqMainInst->numChannels = 1;
+    NetEqMainInst->outputChannels = 1;
 #endif
 
     return (ok);
@@ -482,6 +604,9 @@ int WebRtcNetEQ_Init(void *inst, WebRtc_UWord16 fs)
 int WebRtcNetEQ_FlushBuffers(void *inst)
 {
     int ok = 0;
+#ifdef NETEQ_STEREO
+    int i;
+#endif
 
     /* Typecast inst to internal instance format */
     MainInst_t *NetEqMainInst = (MainInst_t*) inst;
@@ -502,6 +627,14 @@ int WebRtcNetEQ_FlushBuffers(void *inst)
     ok = WebRtcNetEQ_FlushSpeechBuffer(&NetEqMainInst->DSPinst);
     RETURN_ON_ERROR(ok, NetEqMainInst);
 
+#ifdef NETEQ_STEREO
+    for (i = 1; i < NetEqMainInst->maxChannels; i++)
+    {
+        ok = WebRtcNetEQ_FlushSpeechBuffer(&NetEqMainInst->channelDSPinst[i - 1]);
+        RETURN_ON_ERROR(ok, NetEqMainInst);
+    }
+#endif
+
     return 0;
 }
 
@@ -559,6 +692,9 @@ int WebRtcNetEQ_SetBGNMode(void *inst, enum WebRtcNetEQBGNMode bgnMode)
 {
 
     MainInst_t *NetEqMainInst = (MainInst_t*) inst;
+#ifdef NETEQ_STEREO
+    int i;
+#endif
 
     /* Instance sanity */
     if (NetEqMainInst == NULL) return (-1);
@@ -572,6 +708,12 @@ int WebRtcNetEQ_SetBGNMode(void *inst, enum WebRtcNetEQBGNMode bgnMode)
     }
 
     NetEqMainInst->DSPinst.BGNInst.bgnMode = (enum BGNMode) bgnMode;
+#ifdef NETEQ_STEREO
+    for (i = 1; i < NetEqMainInst->maxChannels; i++)
+    {
+        NetEqMainInst->channelDSPinst[i - 1].BGNInst.bgnMode = (enum BGNMode) bgnMode;
+    }
+#endif
 
     return (0);
 }
@@ -596,6 +738,9 @@ int WebRtcNetEQ_GetBGNMode(const void *inst, enum WebRtcNetEQBGNMode *bgnMode)
 int WebRtcNetEQ_CodecDbReset(void *inst)
 {
     int ok = 0;
+#ifdef NETEQ_STEREO
+    int i;
+#endif
     MainInst_t *NetEqMainInst = (MainInst_t*) inst;
     if (NetEqMainInst == NULL) return (-1);
     ok = WebRtcNetEQ_DbReset(&NetEqMainInst->MCUinst.codec_DB_inst);
@@ -616,6 +761,19 @@ int WebRtcNetEQ_CodecDbReset(void *inst)
     NetEqMainInst->DSPinst.codec_ptr_inst.funcUpdBWEst = NULL;
     NetEqMainInst->DSPinst.codec_ptr_inst.funcGetErrorCode = NULL;
 
+#ifdef NETEQ_STEREO
+    /* same for the other channels, which also lose their decoder states */
+    for (i = 1; i < NetEqMainInst->maxChannels; i++)
+    {
+        WebRtcSpl_MemSetW16((WebRtc_Word16*) &NetEqMainInst->channelDSPinst[i - 1].codec_ptr_inst,
+            0, sizeof(CodecFuncInst_t) / sizeof(WebRtc_Word16));
+    }
+    for (i = 0; i < (NetEqMainInst->maxChannels - 1) * NUM_TOTAL_CODECS; i++)
+    {
+        NetEqMainInst->channelCodecState[i] = NULL;
+    }
+#endif
+
     return (0);
 }
 
@@ -675,6 +833,9 @@ int WebRtcNetEQ_CodecDbAdd(void *inst, WebRtcNetEQ_CodecDef *codecInst)
 int WebRtcNetEQ_CodecDbRemove(void *inst, enum WebRtcNetEQDecoder codec)
 {
     int ok = 0;
+#ifdef NETEQ_STEREO
+    int i;
+#endif
     MainInst_t *NetEqMainInst = (MainInst_t*) inst;
     if (NetEqMainInst == NULL) return (-1);
 
@@ -691,6 +852,14 @@ int WebRtcNetEQ_CodecDbRemove(void *inst, enum WebRtcNetEQDecoder codec)
         NetEqMainInst->DSPinst.codec_ptr_inst.funcGetMDinfo = NULL;
         NetEqMainInst->DSPinst.codec_ptr_inst.funcUpdBWEst = NULL;
         NetEqMainInst->DSPinst.codec_ptr_inst.funcGetErrorCode = NULL;
+#ifdef NETEQ_STEREO
+        for (i = 1; i < NetEqMainInst->maxChannels; i++)
+        {
+            WebRtcSpl_MemSetW16(
+                (WebRtc_Word16*) &NetEqMainInst->channelDSPinst[i - 1].codec_ptr_inst, 0,
+                sizeof(CodecFuncInst_t) / sizeof(WebRtc_Word16));
+        }
+#endif
     }
 
     ok = WebRtcNetEQ_DbRemove(&NetEqMainInst->MCUinst.codec_DB_inst, codec);
@@ -699,7 +868,52 @@ int WebRtcNetEQ_CodecDbRemove(void *inst, enum WebRtcNetEQDecoder codec)
         NetEqMainInst->ErrorCode = -ok;
         return (-1);
     }
+
+#ifdef NETEQ_STEREO
+    /* forget the decoder states of the other channels */
+    for (i = 1; i < NetEqMainInst->maxChannels; i++)
+    {
+        NetEqMainInst->channelCodecState[(i - 1) * NUM_TOTAL_CODECS + codec] = NULL;
+    }
+#endif
+    return (ok);
+}
+
+int WebRtcNetEQ_CodecDbAddChannel(void *inst, enum WebRtcNetEQDecoder codec, int channel,
+                                  void *codec_state)
+{
+#ifndef NETEQ_STEREO
+    /* Multichannel not supported */
+    return (-1);
+#else
+    int ok = 0;
+    int numChannels;
+    MainInst_t *NetEqMainInst = (MainInst_t*) inst;
+    if (NetEqMainInst == NULL) return (-1);
+
+    if ((channel < 1) || (channel >= NetEqMainInst->maxChannels))
+    {
+        NetEqMainInst->ErrorCode = -FAULTY_NUMBER_OF_CHANNELS;
+        return (-1);
+    }
+
+    numChannels = WebRtcNetEQ_DbGetChannels(&NetEqMainInst->MCUinst.codec_DB_inst, codec);
+    ok = WebRtcNetEQ_DbSetChannels(&NetEqMainInst->MCUinst.codec_DB_inst, codec,
+        WEBRTC_SPL_MAX(numChannels, channel + 1));
+    if (ok != 0)
+    {
+        NetEqMainInst->ErrorCode = -ok;
+        return (-1);
+    }
+    NetEqMainInst->channelCodecState[(channel - 1) * NUM_TOTAL_CODECS + codec] = codec_state;
+
+    if (NetEqMainInst->MCUinst.current_Codec == (WebRtc_Word16) codec)
+    {
+        /* hand the decoders to all channels */
+        NetEqMainInst->MCUinst.new_codec = 1;
+    }
     return (ok);
+#endif
 }
 
 /*********************************
@@ -924,6 +1138,112 @@ int WebRtcNetEQ_GetMasterSlaveInfoSize()
 #endif
 }
 
+int WebRtcNetEQ_RecOutMultichannel(void *inst, WebRtc_Word16 *pw16_outData,
+                                   WebRtc_Word16 *pw16_len,
+                                   WebRtc_Word16 *pw16_numChannels)
+{
+#ifndef NETEQ_STEREO
+    /* Multichannel not supported */
+    return (-1);
+#else
+    int ok = 0;
+    int i;
+    WebRtc_Word16 channel, numChannels, outChannels, len, channelLen;
+    /* 10 ms of one channel */
+    WebRtc_Word16 pw16_channelOut[NETEQ_MAX_FRAME_SIZE / 6];
+    MasterSlaveInfo msInfo;
+    MainInst_t *NetEqMainInst = (MainInst_t*) inst;
+
+    if (NetEqMainInst == NULL) return (-1);
+
+    if (NetEqMainInst->maxChannels <= 1)
+    {
+        /* Not a multichannel instance */
+        *pw16_numChannels = 1;
+        return (WebRtcNetEQ_RecOut(inst, pw16_outData, pw16_len));
+    }
+
+    /* Check for corrupt/cleared instance */
+    if (NetEqMainInst->DSPinst.main_inst != NetEqMainInst)
+    {
+        /* Instance is corrupt */
+        NetEqMainInst->ErrorCode = CORRUPT_INSTANCE;
+        return (-1);
+    }
+
+    /*
+     * Channel 0 gets the decision of the MCU side and leads; the other channels
+     * follow it as slaves, so that they use the same lags and time-stretching.
+     */
+    numChannels = (WebRtc_Word16) WEBRTC_SPL_MIN(NetEqMainInst->maxChannels,
+        WebRtcNetEQ_DbGetChannels(&NetEqMainInst->MCUinst.codec_DB_inst,
+            (enum WebRtcNetEQDecoder) NetEqMainInst->MCUinst.current_Codec));
+    msInfo.msMode = (numChannels > 1) ? NETEQ_MASTER : NETEQ_MONO;
+    NetEqMainInst->DSPinst.msInfo = &msInfo;
+
+    ok = WebRtcNetEQ_RecOutInternal(&NetEqMainInst->DSPinst, pw16_channelOut, &len,
+        0 /* not BGN only */);
+
+    /*
+     * Number of channels in the decision that was just made, and in the output. CNG and
+     * DTMF without a speech codec are decoded as mono and copied to all channels of the
+     * stream.
+     */
+    numChannels = NetEqMainInst->numChannels;
+    outChannels = WEBRTC_SPL_MAX(NetEqMainInst->outputChannels, numChannels);
+    if (ok == 0)
+    {
+        for (i = 0; i < len; i++)
+        {
+            pw16_outData[i * outChannels] = pw16_channelOut[i];
+        }
+    }
+
+    msInfo.msMode = NETEQ_SLAVE;
+    for (channel = 1; (ok == 0) && (channel < numChannels); channel++)
+    {
+        NetEqMainInst->channelDSPinst[channel - 1].msInfo = &msInfo;
+        ok = WebRtcNetEQ_RecOutInternal(&NetEqMainInst->channelDSPinst[channel - 1],
+            pw16_channelOut, &channelLen, 0 /* not BGN only */);
+        if (ok == 0)
+        {
+            /* The lengths agree, since all channels follow the same instructions */
+            for (i = 0; i < len; i++)
+            {
+                pw16_outData[i * outChannels + channel] = (i < channelLen) ? pw16_channelOut[i]
+                    : 0;
+            }
+        }
+    }
+
+    if (ok != 0)
+    {
+        /*
+         * Play out 10 ms of silence in the stream layout, like a single channel does on
+         * a sample underrun (which the caller may recover from).
+         */
+        len = (WebRtc_Word16) NetEqMainInst->DSPinst.timestampsPerCall;
+        WebRtcSpl_MemSetW16(pw16_outData, 0, (WebRtc_Word16) (len * outChannels));
+        *pw16_len = len;
+        *pw16_numChannels = outChannels;
+        NetEqMainInst->ErrorCode = -ok;
+        return (-1);
+    }
+
+    for (channel = numChannels; channel < outChannels; channel++)
+    {
+        for (i = 0; i < len; i++)
+        {
+            pw16_outData[i * outChannels + channel] = pw16_outData[i * outChannels];
+        }
+    }
+
+    *pw16_len = len;
+    *pw16_numChannels = outChannels;
+    return (ok);
+#endif
+}
+
 /* Special RecOut that does not do any decoding. */
 int WebRtcNetEQ_RecOutNoDecode(void *inst, WebRtc_Word16 *pw16_outData,
                                WebRtc_Word16 *pw16_len)
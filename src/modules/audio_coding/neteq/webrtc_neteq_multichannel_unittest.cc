@@ -0,0 +1,314 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Unit tests for multichannel decoding in one NetEQ instance.
+ */
+
+#include <math.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/audio_coding/neteq/interface/webrtc_neteq.h"
+#include "modules/audio_coding/neteq/interface/webrtc_neteq_help_macros.h"
+#include "modules/audio_coding/neteq/interface/webrtc_neteq_internal.h"
+#include "pcm16b.h"
+#include "typedefs.h"  // NOLINT(build/include)
+
+namespace webrtc {
+
+namespace {
+
+const int kSampleRateHz = 8000;
+const int kPacketMs = 20;
+const int kSamplesPerPacket = kSampleRateHz / 1000 * kPacketMs;
+const int kSamplesPer10Ms = kSampleRateHz / 100;
+const int kPayloadType = 93;
+const int kChannels = 2;
+
+// Decodes 16-bit big-endian samples, like PCM16B, and multiplies them with
+// the gain held in the decoder state.
+WebRtc_Word16 DecodeWithGain(void* state, WebRtc_Word16* encoded,
+                             WebRtc_Word16 len, WebRtc_Word16* decoded,
+                             WebRtc_Word16* speech_type) {
+  const WebRtc_Word16 gain = *static_cast<WebRtc_Word16*>(state);
+  const WebRtc_UWord8* bytes = reinterpret_cast<WebRtc_UWord8*>(encoded);
+  for (int i = 0; i < len / 2; ++i) {
+    decoded[i] = static_cast<WebRtc_Word16>(
+        (bytes[2 * i] << 8) | bytes[2 * i + 1]) * gain;
+  }
+  *speech_type = 1;
+  return len / 2;
+}
+
+// Returns far fewer samples than the packet holds.
+WebRtc_Word16 DecodeTooFewSamples(void* state, WebRtc_Word16* encoded,
+                                  WebRtc_Word16 len, WebRtc_Word16* decoded,
+                                  WebRtc_Word16* speech_type) {
+  decoded[0] = 1000;
+  decoded[1] = 1000;
+  *speech_type = 1;
+  return 2;
+}
+
+}  // namespace
+
+class NetEqMultichannelTest : public ::testing::Test {
+ protected:
+  NetEqMultichannelTest() : inst_(NULL), seq_no_(0), timestamp_(0) {
+    gain_[0] = 1;
+    gain_[1] = -1;
+  }
+
+  // Creates an instance for |num_channels| channels, with the codec
+  // registered for |codec_channels| of them.
+  void CreateInstance(int num_channels, int codec_channels,
+                      WebRtcNetEQ_FuncDecode decode, bool use_gain) {
+    int size;
+    ASSERT_EQ(0, WebRtcNetEQ_AssignSize(&size));
+    inst_memory_.resize(size);
+    ASSERT_EQ(0, WebRtcNetEQ_Assign(&inst_, &inst_memory_[0]));
+    ASSERT_EQ(0, WebRtcNetEQ_Init(inst_, kSampleRateHz));
+
+    ASSERT_EQ(0, WebRtcNetEQ_AssignChannelsSize(num_channels, &size));
+    channel_memory_.resize(size + 1);
+    ASSERT_EQ(0, WebRtcNetEQ_AssignChannels(inst_, num_channels,
+                                            &channel_memory_[0], size));
+
+    WebRtcNetEQDecoder codec = kDecoderPCM16B;
+    int max_packets;
+    ASSERT_EQ(0, WebRtcNetEQ_GetRecommendedBufferSize(inst_, &codec, 1,
+                                                      kTCPNormal, &max_packets,
+                                                      &size));
+    buffer_memory_.resize(size);
+    ASSERT_EQ(0, WebRtcNetEQ_AssignBuffer(inst_, max_packets,
+                                          &buffer_memory_[0], size));
+
+    WebRtcNetEQ_CodecDef codec_def;
+    SET_CODEC_PAR(codec_def, kDecoderPCM16B, kPayloadType,
+                  use_gain ? &gain_[0] : NULL, kSampleRateHz);
+    SET_PCM16B_FUNCTIONS(codec_def);
+    codec_def.funcDecode = decode;
+    ASSERT_EQ(0, WebRtcNetEQ_CodecDbAdd(inst_, &codec_def));
+    for (int channel = 1; channel < codec_channels; ++channel) {
+      ASSERT_EQ(0, WebRtcNetEQ_CodecDbAddChannel(
+          inst_, kDecoderPCM16B, channel, use_gain ? &gain_[channel] : NULL));
+    }
+  }
+
+  // Inserts one packet where channel c holds |signal| scaled by |scale[c]|.
+  void InsertPacket(int num_channels, const int* scale) {
+    std::vector<WebRtc_UWord8> payload(2 * kSamplesPerPacket * num_channels);
+    for (int c = 0; c < num_channels; ++c) {
+      for (int i = 0; i < kSamplesPerPacket; ++i) {
+        const WebRtc_Word16 sample = static_cast<WebRtc_Word16>(
+            scale[c] * Signal(timestamp_ + i));
+        const int pos = 2 * (c * kSamplesPerPacket + i);
+        payload[pos] = static_cast<WebRtc_UWord8>((sample >> 8) & 0xFF);
+        payload[pos + 1] = static_cast<WebRtc_UWord8>(sample & 0xFF);
+      }
+    }
+    WebRtcNetEQ_RTPInfo rtp_info;
+    rtp_info.payloadType = kPayloadType;
+    rtp_info.sequenceNumber = seq_no_;
+    rtp_info.timeStamp = timestamp_;
+    rtp_info.SSRC = 0x1234;
+    rtp_info.markerBit = 0;
+    ASSERT_EQ(0, WebRtcNetEQ_RecInRTPStruct(
+        inst_, &rtp_info, &payload[0],
+        static_cast<WebRtc_Word16>(payload.size()), timestamp_));
+    Skip();
+  }
+
+  // Advances to the next packet without inserting anything.
+  void Skip() {
+    ++seq_no_;
+    timestamp_ += kSamplesPerPacket;
+  }
+
+  static double Signal(WebRtc_UWord32 n) {
+    return 6000 * sin(2 * 3.14159265 * 300 * n / kSampleRateHz) +
+        2000 * sin(2 * 3.14159265 * 1100 * n / kSampleRateHz);
+  }
+
+  void* inst_;
+  std::vector<WebRtc_Word8> inst_memory_;
+  std::vector<WebRtc_Word8> channel_memory_;
+  std::vector<WebRtc_Word8> buffer_memory_;
+  WebRtc_Word16 gain_[kChannels];
+  WebRtc_UWord16 seq_no_;
+  WebRtc_UWord32 timestamp_;
+  WebRtc_Word16 out_[kSamplesPer10Ms * kChannels];
+};
+
+TEST_F(NetEqMultichannelTest, RejectsBadChannelConfigurations) {
+  int size;
+  EXPECT_EQ(-1, WebRtcNetEQ_AssignChannelsSize(0, &size));
+  EXPECT_EQ(-1, WebRtcNetEQ_AssignChannelsSize(9, &size));
+  ASSERT_EQ(0, WebRtcNetEQ_AssignChannelsSize(1, &size));
+  EXPECT_EQ(0, size);
+
+  CreateInstance(kChannels, 1, WebRtcNetEQ_FuncDecode(WebRtcPcm16b_DecodeW16),
+                 false);
+  // Only channel 1 exists besides channel 0.
+  EXPECT_EQ(-1, WebRtcNetEQ_CodecDbAddChannel(inst_, kDecoderPCM16B, 0, NULL));
+  EXPECT_EQ(-1, WebRtcNetEQ_CodecDbAddChannel(inst_, kDecoderPCM16B, 2, NULL));
+  // The codec must be in the database.
+  EXPECT_EQ(-1, WebRtcNetEQ_CodecDbAddChannel(inst_, kDecoderPCMu, 1, NULL));
+  EXPECT_EQ(0, WebRtcNetEQ_CodecDbAddChannel(inst_, kDecoderPCM16B, 1, NULL));
+  // Too little memory.
+  ASSERT_EQ(0, WebRtcNetEQ_AssignChannelsSize(kChannels, &size));
+  EXPECT_EQ(-1, WebRtcNetEQ_AssignChannels(inst_, kChannels,
+                                           &channel_memory_[0], size - 1));
+}
+
+TEST_F(NetEqMultichannelTest, DecodesEachChannelWithItsOwnState) {
+  CreateInstance(kChannels, kChannels, DecodeWithGain, true);
+  const int kScale[kChannels] = {1, 1};
+  bool got_signal = false;
+  for (int k = 0; k < 50; ++k) {
+    InsertPacket(kChannels, kScale);
+    for (int j = 0; j < kPacketMs / 10; ++j) {
+      WebRtc_Word16 len;
+      WebRtc_Word16 num_channels;
+      ASSERT_EQ(0, WebRtcNetEQ_RecOutMultichannel(inst_, out_, &len,
+                                                  &num_channels));
+      ASSERT_EQ(kSamplesPer10Ms, len);
+      ASSERT_EQ(kChannels, num_channels);
+      for (int i = 0; i < len; ++i) {
+        // Same payload in both channels; the decoder of channel 1 inverts it.
+        ASSERT_EQ(out_[2 * i], -out_[2 * i + 1]) << "frame " << k;
+        got_signal |= (out_[2 * i] != 0);
+      }
+    }
+  }
+  EXPECT_TRUE(got_signal);
+}
+
+TEST_F(NetEqMultichannelTest, ChannelsShareTimeStretchingAndConcealment) {
+  CreateInstance(kChannels, kChannels,
+                 WebRtcNetEQ_FuncDecode(WebRtcPcm16b_DecodeW16), false);
+  const int kScale[kChannels] = {1, 1};
+  WebRtcNetEQ_NetworkStatistics stats;
+  int expand_rate = 0;
+  int stretch_rate = 0;
+  for (int k = 0; k < 200; ++k) {
+    if (k % 7 == 3) {
+      // Lost packet, concealed by expand and merge.
+      Skip();
+    } else if (k % 25 == 10) {
+      // Burst, which the buffer has to catch up with.
+      for (int burst = 0; burst < 4; ++burst) {
+        InsertPacket(kChannels, kScale);
+      }
+    } else {
+      InsertPacket(kChannels, kScale);
+    }
+    for (int j = 0; j < kPacketMs / 10; ++j) {
+      WebRtc_Word16 len;
+      WebRtc_Word16 num_channels;
+      ASSERT_EQ(0, WebRtcNetEQ_RecOutMultichannel(inst_, out_, &len,
+                                                  &num_channels));
+      ASSERT_EQ(kSamplesPer10Ms, len);
+      ASSERT_EQ(kChannels, num_channels);
+      for (int i = 0; i < len; ++i) {
+        ASSERT_EQ(out_[2 * i], out_[2 * i + 1]) << "frame " << k;
+      }
+    }
+    if (k % 10 == 9) {
+      ASSERT_EQ(0, WebRtcNetEQ_GetNetworkStatistics(inst_, &stats));
+      expand_rate += stats.currentExpandRate;
+      stretch_rate += stats.currentAccelerateRate +
+          stats.currentPreemptiveRate;
+    }
+  }
+  EXPECT_GT(expand_rate, 0);
+  EXPECT_GT(stretch_rate, 0);
+}
+
+TEST_F(NetEqMultichannelTest, UnderrunGivesSilenceInStreamLayout) {
+  CreateInstance(kChannels, kChannels, DecodeTooFewSamples, false);
+  const int kScale[kChannels] = {1, 1};
+  InsertPacket(kChannels, kScale);
+  for (int i = 0; i < kSamplesPer10Ms * kChannels; ++i) {
+    out_[i] = 4711;
+  }
+  WebRtc_Word16 len = 0;
+  WebRtc_Word16 num_channels = 0;
+  EXPECT_EQ(-1, WebRtcNetEQ_RecOutMultichannel(inst_, out_, &len,
+                                               &num_channels));
+  // The caller may continue after an underrun, so the output must be usable.
+  EXPECT_EQ(2003, WebRtcNetEQ_GetErrorCode(inst_));
+  EXPECT_EQ(kSamplesPer10Ms, len);
+  EXPECT_EQ(kChannels, num_channels);
+  for (int i = 0; i < kSamplesPer10Ms * kChannels; ++i) {
+    ASSERT_EQ(0, out_[i]) << "sample " << i;
+  }
+}
+
+TEST_F(NetEqMultichannelTest, MonoCodecGivesMonoOutput) {
+  // Reference: a mono instance.
+  void* mono_inst;
+  int size;
+  ASSERT_EQ(0, WebRtcNetEQ_AssignSize(&size));
+  std::vector<WebRtc_Word8> mono_memory(size);
+  ASSERT_EQ(0, WebRtcNetEQ_Assign(&mono_inst, &mono_memory[0]));
+  ASSERT_EQ(0, WebRtcNetEQ_Init(mono_inst, kSampleRateHz));
+  WebRtcNetEQDecoder codec = kDecoderPCM16B;
+  int max_packets;
+  ASSERT_EQ(0, WebRtcNetEQ_GetRecommendedBufferSize(mono_inst, &codec, 1,
+                                                    kTCPNormal, &max_packets,
+                                                    &size));
+  std::vector<WebRtc_Word8> mono_buffer(size);
+  ASSERT_EQ(0, WebRtcNetEQ_AssignBuffer(mono_inst, max_packets,
+                                        &mono_buffer[0], size));
+  WebRtcNetEQ_CodecDef codec_def;
+  SET_CODEC_PAR(codec_def, kDecoderPCM16B, kPayloadType, NULL, kSampleRateHz);
+  SET_PCM16B_FUNCTIONS(codec_def);
+  ASSERT_EQ(0, WebRtcNetEQ_CodecDbAdd(mono_inst, &codec_def));
+
+  // The codec is only registered for channel 0.
+  CreateInstance(kChannels, 1, WebRtcNetEQ_FuncDecode(WebRtcPcm16b_DecodeW16),
+                 false);
+  const int kScale[1] = {1};
+  for (int k = 0; k < 100; ++k) {
+    void* current = inst_;
+    if (k % 7 != 3) {
+      const WebRtc_UWord16 seq_no = seq_no_;
+      const WebRtc_UWord32 timestamp = timestamp_;
+      InsertPacket(1, kScale);
+      seq_no_ = seq_no;
+      timestamp_ = timestamp;
+      inst_ = mono_inst;
+      InsertPacket(1, kScale);
+      inst_ = current;
+    } else {
+      Skip();
+    }
+    for (int j = 0; j < kPacketMs / 10; ++j) {
+      WebRtc_Word16 len;
+      WebRtc_Word16 num_channels;
+      WebRtc_Word16 mono_out[kSamplesPer10Ms];
+      WebRtc_Word16 mono_len;
+      ASSERT_EQ(0, WebRtcNetEQ_RecOutMultichannel(inst_, out_, &len,
+                                                  &num_channels));
+      ASSERT_EQ(0, WebRtcNetEQ_RecOut(mono_inst, mono_out, &mono_len));
+      ASSERT_EQ(1, num_channels);
+      ASSERT_EQ(mono_len, len);
+      for (int i = 0; i < len; ++i) {
+        ASSERT_EQ(mono_out[i], out_[i]) << "frame " << k;
+      }
+    }
+  }
+}
+
+}  // namespace webrtc
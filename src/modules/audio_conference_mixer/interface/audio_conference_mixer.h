@@ -24,7 +24,10 @@ class Trace;
 class AudioConferenceMixer : public Module
 {
 public:
-    enum {kMaximumAmountOfMixedParticipants = 3};
+    // Default and upper bound for the number of (non-anonymous) participants
+    // that are mixed, see SetMaximumAmountOfMixedParticipants().
+    enum {kDefaultAmountOfMixedParticipants = 3};
+    enum {kMaximumAmountOfMixedParticipants = 16};
     enum Frequency
     {
         kNbInHz           = 8000,
@@ -87,6 +90,26 @@ public:
     // downsampling of audio contributing to the mixed audio.
     virtual WebRtc_Word32 SetMinimumMixingFrequency(Frequency freq) = 0;
 
+    // Set the maximum number of participants that are mixed at the same time.
+    // Anonymous participants don't count toward this number. amount must be
+    // in the range [1, kMaximumAmountOfMixedParticipants]. The default is
+    // kDefaultAmountOfMixedParticipants.
+    virtual WebRtc_Word32 SetMaximumAmountOfMixedParticipants(
+        const WebRtc_UWord32 amount) = 0;
+    virtual WebRtc_Word32 MaximumAmountOfMixedParticipants(
+        WebRtc_UWord32& amount) = 0;
+
+    // Enable/disable mix-minus output. When enabled, every call to
+    // AudioMixerOutputReceiver::NewMixedAudio() additionally provides one
+    // unique AudioFrame per mixed participant, anonymous and ramping out
+    // participants included. The unique frame contains the mix without the
+    // participant's own audio and its _id is the _id of the participant's
+    // AudioFrame. Participants that were not mixed should be sent the general
+    // AudioFrame. The full mix is only computed once, so
+    // the cost is independent of the number of participants.
+    virtual WebRtc_Word32 SetMixMinusStatus(const bool enable) = 0;
+    virtual WebRtc_Word32 MixMinusStatus(bool& enabled) = 0;
+
 protected:
     AudioConferenceMixer() {}
 };
@@ -77,7 +77,9 @@ class AudioMixerOutputReceiver
 public:
     // This callback function provides the mixed audio for this mix iteration.
     // Note that uniqueAudioFrames is an array of AudioFrame pointers with the
-    // size according to the size parameter.
+    // size according to the size parameter. It is only populated when
+    // mix-minus output is enabled, see AudioConferenceMixer::
+    // SetMixMinusStatus().
     virtual void NewMixedAudio(const WebRtc_Word32 id,
                                const AudioFrame& generalAudioFrame,
                                const AudioFrame** uniqueAudioFrames,
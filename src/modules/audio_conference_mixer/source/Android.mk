@@ -30,6 +30,7 @@ LOCAL_C_INCLUDES := \
     $(LOCAL_PATH)/../interface \
     $(LOCAL_PATH)/../../interface \
     $(LOCAL_PATH)/../../audio_processing/interface \
+    $(LOCAL_PATH)/../../../common_audio/signal_processing/include \
     $(LOCAL_PATH)/../../.. \
     $(LOCAL_PATH)/../../../system_wrappers/interface 
 
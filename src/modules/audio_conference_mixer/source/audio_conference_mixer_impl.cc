@@ -14,6 +14,7 @@
 #include "audio_processing.h"
 #include "critical_section_wrapper.h"
 #include "map_wrapper.h"
+#include "signal_processing_library.h"
 #include "trace.h"
 
 namespace webrtc {
@@ -92,6 +93,13 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
       _scratchMixedParticipants(),
       _scratchVadPositiveParticipantsAmount(0),
       _scratchVadPositiveParticipants(),
+      _scratchMixMinusFramesAmount(0),
+      _scratchMixMinusFrames(),
+      _scratchUniqueFrames(),
+      _scratchMixMinusFramesSize(0),
+      _scratchMixInputs(),
+      _scratchMixInputsSize(0),
+      _mixMinusAccumulator(),
       _crit(NULL),
       _cbCrit(NULL),
       _id(id),
@@ -107,12 +115,17 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
       _participantList(),
       _additionalParticipantList(),
       _amountOfMixableParticipants(0),
+      _amountOfMixedParticipants(kDefaultAmountOfMixedParticipants),
+      _mixMinus(false),
       _timeStamp(0),
       _timeScheduler(kProcessPeriodicityInMs),
       _mixedAudioLevel(),
       _processCalls(0),
-      _limiter(NULL)
-{}
+      _limiter(NULL),
+      _mixMinusLimiters(),
+      _mixMinusLimiterIds()
+{
+}
 
 bool AudioConferenceMixerImpl::Init()
 {
@@ -124,6 +137,9 @@ bool AudioConferenceMixerImpl::Init()
     if(_cbCrit.get() == NULL)
         return false;
 
+    // Select the fastest mixing kernel for this CPU.
+    WebRtcSpl_Init();
+
     _limiter.reset(AudioProcessing::Create(_id));
     if(_limiter.get() == NULL)
         return false;
@@ -140,24 +156,29 @@ bool AudioConferenceMixerImpl::Init()
     if (!SetNumLimiterChannels(1))
         return false;
 
-    if(_limiter->gain_control()->set_mode(GainControl::kFixedDigital) != 
-        _limiter->kNoError)
+    return SetLimiterParameters(*_limiter);
+}
+
+bool AudioConferenceMixerImpl::SetLimiterParameters(AudioProcessing& limiter)
+{
+    if(limiter.gain_control()->set_mode(GainControl::kFixedDigital) !=
+        limiter.kNoError)
         return false;
 
     // We smoothly limit the mixed frame to -7 dbFS. -6 would correspond to the
     // divide-by-2 but -7 is used instead to give a bit of headroom since the
     // AGC is not a hard limiter.
-    if(_limiter->gain_control()->set_target_level_dbfs(7) != _limiter->kNoError)
+    if(limiter.gain_control()->set_target_level_dbfs(7) != limiter.kNoError)
         return false;
 
-    if(_limiter->gain_control()->set_compression_gain_db(0)
-        != _limiter->kNoError)
+    if(limiter.gain_control()->set_compression_gain_db(0)
+        != limiter.kNoError)
         return false;
 
-    if(_limiter->gain_control()->enable_limiter(true) != _limiter->kNoError)
+    if(limiter.gain_control()->enable_limiter(true) != limiter.kNoError)
         return false;
 
-    if(_limiter->gain_control()->Enable(true) != _limiter->kNoError)
+    if(limiter.gain_control()->Enable(true) != limiter.kNoError)
         return false;
 
     return true;
@@ -165,6 +186,10 @@ bool AudioConferenceMixerImpl::Init()
 
 AudioConferenceMixerImpl::~AudioConferenceMixerImpl()
 {
+    for(size_t i = 0; i < _mixMinusLimiters.size(); i++)
+    {
+        AudioProcessing::Destroy(_mixMinusLimiters[i]);
+    }
     MemoryPool<AudioFrame>::DeleteMemoryPool(_audioFramePool);
     assert(_audioFramePool == NULL);
 }
@@ -244,12 +269,14 @@ WebRtc_Word32 AudioConferenceMixerImpl::TimeUntilNextProcess()
 
 WebRtc_Word32 AudioConferenceMixerImpl::Process()
 {
-    WebRtc_UWord32 remainingParticipantsAllowedToMix =
-        kMaximumAmountOfMixedParticipants;
+    WebRtc_UWord32 remainingParticipantsAllowedToMix = 0;
+    bool mixMinus = false;
     {
         CriticalSectionScoped cs(_crit.get());
         assert(_processCalls == 0);
         _processCalls++;
+        remainingParticipantsAllowedToMix = _amountOfMixedParticipants;
+        mixMinus = _mixMinus;
 
         // Let the scheduler know that we are running one iteration.
         _timeScheduler.UpdateScheduler();
@@ -358,9 +385,19 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
 
         _timeStamp += _sampleSize;
 
-        MixFromList(*mixedAudio, mixList);
-        MixAnonomouslyFromList(*mixedAudio, additionalFramesList);
-        MixAnonomouslyFromList(*mixedAudio, rampOutList);
+        _scratchMixMinusFramesAmount = 0;
+        if(mixMinus)
+        {
+            if(MixWithMixMinus(*mixedAudio, mixList, additionalFramesList,
+                               rampOutList) != 0)
+                retval = -1;
+        }
+        else
+        {
+            if(MixFromLists(*mixedAudio, mixList, additionalFramesList,
+                            rampOutList) != 0)
+                retval = -1;
+        }
 
         if(mixedAudio->_payloadDataLengthInSamples == 0)
         {
@@ -371,10 +408,20 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
         else
         {
             // Only call the limiter if we have something to mix.
-            if(!LimitMixedAudio(*mixedAudio))
+            if(!LimitMixedAudio(*mixedAudio, *_limiter))
                 retval = -1;
         }
 
+        for(WebRtc_UWord32 i = 0; i < _scratchMixMinusFramesAmount; i++)
+        {
+            AudioFrame* mixMinusFrame = _scratchMixMinusFrames[i];
+            AudioProcessing* limiter = MixMinusLimiter(mixMinusFrame->_id);
+            if(limiter == NULL ||
+               !LimitMixedAudio(*mixMinusFrame, *limiter))
+                retval = -1;
+        }
+        ReleaseUnusedMixMinusLimiters();
+
         _mixedAudioLevel.ComputeLevel(mixedAudio->_payloadData,_sampleSize);
         audioLevel = _mixedAudioLevel.GetLevel();
 
@@ -394,12 +441,16 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
         CriticalSectionScoped cs(_cbCrit.get());
         if(_mixReceiver != NULL)
         {
-            const AudioFrame** dummy = NULL;
+            for(WebRtc_UWord32 i = 0; i < _scratchMixMinusFramesAmount; i++)
+            {
+                _scratchUniqueFrames[i] = _scratchMixMinusFrames[i];
+            }
             _mixReceiver->NewMixedAudio(
                 _id,
                 *mixedAudio,
-                dummy,
-                0);
+                _scratchMixMinusFramesAmount > 0 ?
+                    _scratchUniqueFrames.get() : NULL,
+                _scratchMixMinusFramesAmount);
         }
 
         if((_mixerStatusCallback != NULL) &&
@@ -420,6 +471,11 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
 
     // Reclaim all outstanding memory.
     _audioFramePool->PushMemory(mixedAudio);
+    for(WebRtc_UWord32 i = 0; i < _scratchMixMinusFramesAmount; i++)
+    {
+        _audioFramePool->PushMemory(_scratchMixMinusFrames[i]);
+    }
+    _scratchMixMinusFramesAmount = 0;
     ClearAudioFrameList(mixList);
     ClearAudioFrameList(rampOutList);
     ClearAudioFrameList(additionalFramesList);
@@ -484,6 +540,8 @@ AudioConferenceMixerImpl::OutputFrequency() const
 
 bool AudioConferenceMixerImpl::SetNumLimiterChannels(int numChannels)
 {
+    // The mix-minus limiters are reconfigured when they are used, see
+    // MixMinusLimiter().
     if(_limiter->num_input_channels() != numChannels)
     {
         const int error = _limiter->set_num_channels(numChannels,
@@ -714,6 +772,47 @@ WebRtc_Word32 AudioConferenceMixerImpl::SetMinimumMixingFrequency(
     }
 }
 
+WebRtc_Word32 AudioConferenceMixerImpl::SetMaximumAmountOfMixedParticipants(
+    const WebRtc_UWord32 amount)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceAudioMixerServer, _id,
+                 "SetMaximumAmountOfMixedParticipants(amount:%u)", amount);
+    if((amount == 0) || (amount > kMaximumAmountOfMixedParticipants))
+    {
+        WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                     "amount of mixed participants must be in [1, %d]",
+                     kMaximumAmountOfMixedParticipants);
+        return -1;
+    }
+    CriticalSectionScoped cs(_crit.get());
+    _amountOfMixedParticipants = amount;
+    return 0;
+}
+
+WebRtc_Word32 AudioConferenceMixerImpl::MaximumAmountOfMixedParticipants(
+    WebRtc_UWord32& amount)
+{
+    CriticalSectionScoped cs(_crit.get());
+    amount = _amountOfMixedParticipants;
+    return 0;
+}
+
+WebRtc_Word32 AudioConferenceMixerImpl::SetMixMinusStatus(const bool enable)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceAudioMixerServer, _id,
+                 "SetMixMinusStatus(enable:%s)", enable ? "true" : "false");
+    CriticalSectionScoped cs(_crit.get());
+    _mixMinus = enable;
+    return 0;
+}
+
+WebRtc_Word32 AudioConferenceMixerImpl::MixMinusStatus(bool& enabled)
+{
+    CriticalSectionScoped cs(_crit.get());
+    enabled = _mixMinus;
+    return 0;
+}
+
 // Check all AudioFrames that are to be mixed. The highest sampling frequency
 // found is the lowest that can be used without losing information.
 WebRtc_Word32 AudioConferenceMixerImpl::GetLowestMixingFrequency()
@@ -1138,29 +1237,28 @@ bool AudioConferenceMixerImpl::RemoveParticipantFromList(
     return false;
 }
 
-WebRtc_Word32 AudioConferenceMixerImpl::MixFromList(
+WebRtc_Word32 AudioConferenceMixerImpl::MixFromLists(
     AudioFrame& mixedAudio,
-    const ListWrapper& audioFrameList)
+    const ListWrapper& mixList,
+    const ListWrapper& additionalFramesList,
+    const ListWrapper& rampOutList)
 {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
-                 "MixFromList(mixedAudio, audioFrameList)");
-    WebRtc_UWord32 position = 0;
-    ListItem* item = audioFrameList.First();
-    if(item == NULL)
+                 "MixFromLists(mixedAudio, mixList)");
+    const WebRtc_UWord32 maxInputs = mixList.GetSize() +
+        additionalFramesList.GetSize() + rampOutList.GetSize();
+    if(maxInputs == 0)
     {
         return 0;
     }
-
-    if(_amountOfMixableParticipants == 1)
+    if(maxInputs > _scratchMixInputsSize)
     {
-        // No mixing required here; skip the saturation protection.
-        AudioFrame* audioFrame = static_cast<AudioFrame*>(item->GetItem());
-        mixedAudio = *audioFrame;
-        SetParticipantStatistics(&_scratchMixedParticipants[position],
-                                 *audioFrame);
-        return 0;
+        _scratchMixInputs.reset(new const WebRtc_Word16*[maxInputs]);
+        _scratchMixInputsSize = maxInputs;
     }
 
+    WebRtc_UWord32 position = 0;
+    ListItem* item = mixList.First();
     while(item != NULL)
     {
         if(position >= kMaximumAmountOfMixedParticipants)
@@ -1175,53 +1273,305 @@ WebRtc_Word32 AudioConferenceMixerImpl::MixFromList(
             assert(false);
             position = 0;
         }
-        AudioFrame* audioFrame = static_cast<AudioFrame*>(item->GetItem());
-
-        // Divide by two to avoid saturation in the mixing.
-        *audioFrame >>= 1;
-        mixedAudio += *audioFrame;
-
         SetParticipantStatistics(&_scratchMixedParticipants[position],
-                                 *audioFrame);
-
+                                 *static_cast<AudioFrame*>(item->GetItem()));
         position++;
-        item = audioFrameList.Next(item);
+        item = mixList.Next(item);
     }
 
+    WebRtc_UWord32 numInputs = 0;
+    AddMixInputsFromList(mixList, mixedAudio, numInputs);
+    AddMixInputsFromList(additionalFramesList, mixedAudio, numInputs);
+    AddMixInputsFromList(rampOutList, mixedAudio, numInputs);
+
+    // Divide by two to avoid saturation in the mixing, unless there is
+    // nothing to mix with. LimitMixedAudio() restores the level.
+    const int rightShifts = (_amountOfMixableParticipants == 1) ? 0 : 1;
+    WebRtcSpl_MixVectorsW16(
+        _scratchMixInputs.get(), numInputs, rightShifts,
+        mixedAudio._payloadData,
+        mixedAudio._payloadDataLengthInSamples * mixedAudio._audioChannel);
     return 0;
 }
 
-// TODO(andrew): consolidate this function with MixFromList.
-WebRtc_Word32 AudioConferenceMixerImpl::MixAnonomouslyFromList(
+void AudioConferenceMixerImpl::AddMixInputsFromList(
+    const ListWrapper& audioFrameList,
     AudioFrame& mixedAudio,
-    const ListWrapper& audioFrameList)
+    WebRtc_UWord32& numInputs)
 {
-    WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
-                 "MixAnonomouslyFromList(mixedAudio, audioFrameList)");
     ListItem* item = audioFrameList.First();
-    if(item == NULL)
-        return 0;
+    while(item != NULL)
+    {
+        const AudioFrame* audioFrame =
+            static_cast<const AudioFrame*>(item->GetItem());
+        item = audioFrameList.Next(item);
+        // Same restrictions as AudioFrame::operator+=().
+        if(audioFrame->_audioChannel != mixedAudio._audioChannel)
+        {
+            continue;
+        }
+        if(numInputs == 0)
+        {
+            mixedAudio._payloadDataLengthInSamples =
+                audioFrame->_payloadDataLengthInSamples;
+            mixedAudio._speechType = audioFrame->_speechType;
+            mixedAudio._vadActivity = audioFrame->_vadActivity;
+        }
+        else
+        {
+            if(mixedAudio._payloadDataLengthInSamples !=
+               audioFrame->_payloadDataLengthInSamples)
+            {
+                continue;
+            }
+            if((mixedAudio._vadActivity == AudioFrame::kVadActive) ||
+               (audioFrame->_vadActivity == AudioFrame::kVadActive))
+            {
+                mixedAudio._vadActivity = AudioFrame::kVadActive;
+            }
+            else if((mixedAudio._vadActivity == AudioFrame::kVadUnknown) ||
+                    (audioFrame->_vadActivity == AudioFrame::kVadUnknown))
+            {
+                mixedAudio._vadActivity = AudioFrame::kVadUnknown;
+            }
+            if(mixedAudio._speechType != audioFrame->_speechType)
+            {
+                mixedAudio._speechType = AudioFrame::kUndefined;
+            }
+        }
+        _scratchMixInputs[numInputs++] = audioFrame->_payloadData;
+    }
+}
 
-    if(_amountOfMixableParticipants == 1)
+WebRtc_Word32 AudioConferenceMixerImpl::MixWithMixMinus(
+    AudioFrame& mixedAudio,
+    const ListWrapper& mixList,
+    const ListWrapper& additionalFramesList,
+    const ListWrapper& rampOutList)
+{
+    WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
+                 "MixWithMixMinus(mixedAudio, mixList)");
+    // Divide by two to avoid saturation in the mixing, unless there is no
+    // mixing (see MixFromLists()). LimitMixedAudio() restores the level.
+    const int shift = (_amountOfMixableParticipants == 1) ? 0 : 1;
+
+    const WebRtc_UWord32 maxFrames = mixList.GetSize() +
+        additionalFramesList.GetSize() + rampOutList.GetSize();
+    if(maxFrames > _scratchMixMinusFramesSize)
     {
-        // No mixing required here; skip the saturation protection.
-        AudioFrame* audioFrame = static_cast<AudioFrame*>(item->GetItem());
-        mixedAudio = *audioFrame;
-        return 0;
+        _scratchMixMinusFrames.reset(new AudioFrame*[maxFrames]);
+        _scratchUniqueFrames.reset(new const AudioFrame*[maxFrames]);
+        _scratchMixMinusFramesSize = maxFrames;
+    }
+
+    AccumulateFromList(mixList, mixedAudio, shift, true);
+    AccumulateFromList(additionalFramesList, mixedAudio, shift, false);
+    AccumulateFromList(rampOutList, mixedAudio, shift, false);
+
+    const int numSamples =
+        mixedAudio._payloadDataLengthInSamples * mixedAudio._audioChannel;
+    for(int i = 0; i < numSamples; i++)
+    {
+        mixedAudio._payloadData[i] = WebRtcSpl_SatW32ToW16(
+            _mixMinusAccumulator[i]);
+    }
+
+    // Everyone heard in the mix, anonymous and ramped out participants
+    // included, gets it without their own audio.
+    if((AddMixMinusFrames(mixList, mixedAudio, shift) != 0) ||
+       (AddMixMinusFrames(additionalFramesList, mixedAudio, shift) != 0) ||
+       (AddMixMinusFrames(rampOutList, mixedAudio, shift) != 0))
+    {
+        return -1;
     }
+    return 0;
+}
 
+WebRtc_Word32 AudioConferenceMixerImpl::AddMixMinusFrames(
+    const ListWrapper& audioFrameList,
+    const AudioFrame& mixedAudio,
+    const int shift)
+{
+    const int numSamples =
+        mixedAudio._payloadDataLengthInSamples * mixedAudio._audioChannel;
+    ListItem* item = audioFrameList.First();
     while(item != NULL)
     {
-        AudioFrame* audioFrame = static_cast<AudioFrame*>(item->GetItem());
-        // Divide by two to avoid saturation in the mixing.
-        *audioFrame >>= 1;
-        mixedAudio += *audioFrame;
+        const AudioFrame* audioFrame =
+            static_cast<const AudioFrame*>(item->GetItem());
         item = audioFrameList.Next(item);
+        if((audioFrame->_audioChannel != mixedAudio._audioChannel) ||
+           (audioFrame->_payloadDataLengthInSamples !=
+            mixedAudio._payloadDataLengthInSamples))
+        {
+            // Not part of the mix; the general frame is the mix-minus frame.
+            continue;
+        }
+        assert(_scratchMixMinusFramesAmount < _scratchMixMinusFramesSize);
+        AudioFrame* mixMinusFrame = NULL;
+        if(_audioFramePool->PopMemory(mixMinusFrame) == -1)
+        {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            return -1;
+        }
+        mixMinusFrame->UpdateFrame(audioFrame->_id, mixedAudio._timeStamp,
+                                   NULL, 0, mixedAudio._frequencyInHz,
+                                   mixedAudio._speechType,
+                                   mixedAudio._vadActivity,
+                                   mixedAudio._audioChannel);
+        for(int i = 0; i < numSamples; i++)
+        {
+            mixMinusFrame->_payloadData[i] = WebRtcSpl_SatW32ToW16(
+                _mixMinusAccumulator[i] -
+                (audioFrame->_payloadData[i] >> shift));
+        }
+        mixMinusFrame->_payloadDataLengthInSamples =
+            mixedAudio._payloadDataLengthInSamples;
+        _scratchMixMinusFrames[_scratchMixMinusFramesAmount++] = mixMinusFrame;
     }
     return 0;
 }
 
-bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio)
+void AudioConferenceMixerImpl::AccumulateFromList(
+    const ListWrapper& audioFrameList,
+    AudioFrame& mixedAudio,
+    const int shift,
+    const bool updateStatistics)
+{
+    WebRtc_UWord32 position = 0;
+    ListItem* item = audioFrameList.First();
+    while(item != NULL)
+    {
+        const AudioFrame* audioFrame =
+            static_cast<const AudioFrame*>(item->GetItem());
+        item = audioFrameList.Next(item);
+        if(updateStatistics)
+        {
+            assert(position < kMaximumAmountOfMixedParticipants);
+            SetParticipantStatistics(&_scratchMixedParticipants[position++],
+                                     *audioFrame);
+        }
+        // Same restrictions as AudioFrame::operator+=().
+        if(audioFrame->_audioChannel != mixedAudio._audioChannel)
+        {
+            continue;
+        }
+        const int numSamples =
+            audioFrame->_payloadDataLengthInSamples * audioFrame->_audioChannel;
+        if(mixedAudio._payloadDataLengthInSamples == 0)
+        {
+            mixedAudio._payloadDataLengthInSamples =
+                audioFrame->_payloadDataLengthInSamples;
+            memset(_mixMinusAccumulator, 0,
+                   sizeof(_mixMinusAccumulator[0]) * numSamples);
+        }
+        else if(mixedAudio._payloadDataLengthInSamples !=
+                audioFrame->_payloadDataLengthInSamples)
+        {
+            continue;
+        }
+        if(audioFrame->_vadActivity == AudioFrame::kVadActive)
+        {
+            mixedAudio._vadActivity = AudioFrame::kVadActive;
+        }
+        for(int i = 0; i < numSamples; i++)
+        {
+            _mixMinusAccumulator[i] += audioFrame->_payloadData[i] >> shift;
+        }
+    }
+}
+
+AudioProcessing* AudioConferenceMixerImpl::MixMinusLimiter(
+    const WebRtc_Word32 id)
+{
+    const int numLimiters = static_cast<int>(_mixMinusLimiters.size());
+    int slot = -1;
+    for(int i = 0; i < numLimiters; i++)
+    {
+        if(_mixMinusLimiterIds[i] == id)
+        {
+            slot = i;
+            break;
+        }
+    }
+    if(slot == -1)
+    {
+        // New mix-minus participant. Take the first limiter not used by any
+        // of this iteration's mix-minus frames, or add one.
+        for(int i = 0; (i < numLimiters) && (slot == -1); i++)
+        {
+            slot = i;
+            for(WebRtc_UWord32 j = 0; j < _scratchMixMinusFramesAmount; j++)
+            {
+                if(_mixMinusLimiterIds[i] == _scratchMixMinusFrames[j]->_id)
+                {
+                    slot = -1;
+                    break;
+                }
+            }
+        }
+        if(slot == -1)
+        {
+            AudioProcessing* limiter = AudioProcessing::Create(_id);
+            if((limiter == NULL) || !SetLimiterParameters(*limiter))
+            {
+                AudioProcessing::Destroy(limiter);
+                WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                             "failed to create mix-minus limiter");
+                return NULL;
+            }
+            slot = numLimiters;
+            _mixMinusLimiters.push_back(limiter);
+            _mixMinusLimiterIds.push_back(-1);
+        }
+        else
+        {
+            // Start from a clean gain state.
+            _mixMinusLimiters[slot]->Initialize();
+        }
+        _mixMinusLimiterIds[slot] = id;
+    }
+
+    AudioProcessing* limiter = _mixMinusLimiters[slot];
+    if((limiter->sample_rate_hz() != _outputFrequency) &&
+       (limiter->set_sample_rate_hz(_outputFrequency) != limiter->kNoError))
+    {
+        return NULL;
+    }
+    if((limiter->num_input_channels() != _limiter->num_input_channels()) &&
+       (limiter->set_num_channels(_limiter->num_input_channels(),
+                                  _limiter->num_input_channels()) !=
+        limiter->kNoError))
+    {
+        return NULL;
+    }
+    return limiter;
+}
+
+void AudioConferenceMixerImpl::ReleaseUnusedMixMinusLimiters()
+{
+    for(size_t i = 0; i < _mixMinusLimiterIds.size(); i++)
+    {
+        bool used = false;
+        for(WebRtc_UWord32 j = 0; j < _scratchMixMinusFramesAmount; j++)
+        {
+            if(_mixMinusLimiterIds[i] == _scratchMixMinusFrames[j]->_id)
+            {
+                used = true;
+                break;
+            }
+        }
+        if(!used)
+        {
+            _mixMinusLimiterIds[i] = -1;
+        }
+    }
+}
+
+bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio,
+                                               AudioProcessing& limiter)
 {
     if(_amountOfMixableParticipants == 1)
     {
@@ -1229,7 +1579,7 @@ bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio)
     }
 
     // Smoothly limit the mixed frame.
-    const int error = _limiter->ProcessStream(&mixedAudio);
+    const int error = limiter.ProcessStream(&mixedAudio);
 
     // And now we can safely restore the level. This procedure results in
     // some loss of resolution, deemed acceptable.
@@ -1243,7 +1593,7 @@ bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio)
     // negative value is undefined).
     mixedAudio += mixedAudio;
 
-    if(error != _limiter->kNoError)
+    if(error != limiter.kNoError)
     {
         WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
                      "Error from AudioProcessing: %d", error);
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_CONFERENCE_MIXER_IMPL_H_
 #define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_CONFERENCE_MIXER_IMPL_H_
 
+#include <vector>
+
 #include "atomic32_wrapper.h"
 #include "audio_conference_mixer.h"
 #include "engine_configurations.h"
@@ -88,6 +90,12 @@ public:
         MixerParticipant& participant, const bool mixable);
     virtual WebRtc_Word32 AnonymousMixabilityStatus(
         MixerParticipant& participant, bool& mixable);
+    virtual WebRtc_Word32 SetMaximumAmountOfMixedParticipants(
+        const WebRtc_UWord32 amount);
+    virtual WebRtc_Word32 MaximumAmountOfMixedParticipants(
+        WebRtc_UWord32& amount);
+    virtual WebRtc_Word32 SetMixMinusStatus(const bool enable);
+    virtual WebRtc_Word32 MixMinusStatus(bool& enabled);
 private:
     enum{DEFAULT_AUDIO_FRAME_POOLSIZE = 50};
 
@@ -99,6 +107,10 @@ private:
     // has changed.
     bool SetNumLimiterChannels(int numChannels);
 
+    // Configures limiter as a smooth limiter. Used for both the general and
+    // the mix-minus limiters.
+    bool SetLimiterParameters(AudioProcessing& limiter);
+
     // Fills mixList with the AudioFrames pointers that should be used when
     // mixing. Fills mixParticipantList with ParticipantStatistics for the
     // participants who's AudioFrames are inside mixList.
@@ -146,17 +158,47 @@ private:
         MixerParticipant& removeParticipant,
         ListWrapper& participantList);
 
-    // Mix the AudioFrames stored in audioFrameList into mixedAudio.
-    WebRtc_Word32 MixFromList(
-        AudioFrame& mixedAudio,
-        const ListWrapper& audioFrameList);
-    // Mix the AudioFrames stored in audioFrameList into mixedAudio. No
-    // record will be kept of this mix (e.g. the corresponding MixerParticipants
-    // will not be marked as IsMixed()
-    WebRtc_Word32 MixAnonomouslyFromList(AudioFrame& mixedAudio,
-                                         const ListWrapper& audioFrameList);
-
-    bool LimitMixedAudio(AudioFrame& mixedAudio);
+    // Mix the AudioFrames stored in mixList, additionalFramesList and
+    // rampOutList into mixedAudio. The mix is accumulated in 32 bits and
+    // saturated once. Statistics are only kept for the AudioFrames in mixList;
+    // the others are mixed anonymously.
+    WebRtc_Word32 MixFromLists(AudioFrame& mixedAudio,
+                               const ListWrapper& mixList,
+                               const ListWrapper& additionalFramesList,
+                               const ListWrapper& rampOutList);
+    // Adds the samples of the AudioFrames in audioFrameList that can be mixed
+    // into mixedAudio to _scratchMixInputs.
+    void AddMixInputsFromList(const ListWrapper& audioFrameList,
+                              AudioFrame& mixedAudio,
+                              WebRtc_UWord32& numInputs);
+
+    // Mix-minus version of MixFromLists(). Sums all AudioFrames in
+    // mixList, additionalFramesList and rampOutList into
+    // _mixMinusAccumulator and writes the full mix to mixedAudio. Then writes
+    // one frame per mixed AudioFrame, from any of the lists, with that
+    // frame's contribution subtracted, to _scratchMixMinusFrames.
+    WebRtc_Word32 MixWithMixMinus(AudioFrame& mixedAudio,
+                                  const ListWrapper& mixList,
+                                  const ListWrapper& additionalFramesList,
+                                  const ListWrapper& rampOutList);
+    void AccumulateFromList(const ListWrapper& audioFrameList,
+                            AudioFrame& mixedAudio,
+                            const int shift,
+                            const bool updateStatistics);
+    // Adds a mix-minus frame to _scratchMixMinusFrames for each AudioFrame in
+    // audioFrameList that is part of mixedAudio.
+    WebRtc_Word32 AddMixMinusFrames(const ListWrapper& audioFrameList,
+                                    const AudioFrame& mixedAudio,
+                                    const int shift);
+
+    // Returns the limiter to use for the mix-minus frame of the participant
+    // whose AudioFrame has the _id id. A participant keeps its limiter for as
+    // long as it is mixed so that the limiter gain is continuous.
+    AudioProcessing* MixMinusLimiter(const WebRtc_Word32 id);
+    // Frees the limiters of participants that were not mixed this iteration.
+    void ReleaseUnusedMixMinusLimiters();
+
+    bool LimitMixedAudio(AudioFrame& mixedAudio, AudioProcessing& limiter);
 
     bool _initialized;
 
@@ -169,6 +211,20 @@ private:
     WebRtc_UWord32         _scratchVadPositiveParticipantsAmount;
     ParticipantStatistics  _scratchVadPositiveParticipants[
         kMaximumAmountOfMixedParticipants];
+    // Mix-minus frames of this iteration, and the same pointers as passed to
+    // NewMixedAudio(). Sized for all mixed AudioFrames, anonymous ones
+    // included.
+    WebRtc_UWord32         _scratchMixMinusFramesAmount;
+    scoped_array<AudioFrame*> _scratchMixMinusFrames;
+    scoped_array<const AudioFrame*> _scratchUniqueFrames;
+    WebRtc_UWord32         _scratchMixMinusFramesSize;
+    // Sample pointers of the AudioFrames being mixed.
+    scoped_array<const WebRtc_Word16*> _scratchMixInputs;
+    WebRtc_UWord32         _scratchMixInputsSize;
+    // Wide accumulator for the full mix. Used in mix-minus mode so that the
+    // participants' own contributions can be subtracted without saturation.
+    WebRtc_Word32          _mixMinusAccumulator[
+        AudioFrame::kMaxAudioFrameSizeSamples];
 
     scoped_ptr<CriticalSectionWrapper> _crit;
     scoped_ptr<CriticalSectionWrapper> _cbCrit;
@@ -197,6 +253,9 @@ private:
     ListWrapper _additionalParticipantList;    // Always mixed, anonomously.
 
     WebRtc_UWord32 _amountOfMixableParticipants;
+    WebRtc_UWord32 _amountOfMixedParticipants;
+
+    bool _mixMinus;
 
     WebRtc_UWord32 _timeStamp;
 
@@ -212,6 +271,12 @@ private:
 
     // Used for inhibiting saturation in mixing.
     scoped_ptr<AudioProcessing> _limiter;
+
+    // Limiters for the mix-minus frames and the _id of the participant using
+    // them (-1 if unused). Grown to the largest number of mix-minus frames
+    // seen. May only be touched in the scope of Process().
+    std::vector<AudioProcessing*> _mixMinusLimiters;
+    std::vector<WebRtc_Word32> _mixMinusLimiterIds;
 };
 } // namespace webrtc
 
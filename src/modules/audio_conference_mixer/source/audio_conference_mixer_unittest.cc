@@ -8,10 +8,201 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-/*
- * Empty test just to get code coverage metrics for this dir.
- */
+#include <stdlib.h>
+
+#include <map>
+
 #include "audio_conference_mixer.h"
+#include "audio_conference_mixer_defines.h"
 #include "gtest/gtest.h"
+#include "module_common_types.h"
+#include "scoped_ptr.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const int kSamplesPer10Ms = kSampleRateHz / 100;
+
+// Produces a constant (DC) signal so that the mix is easy to predict.
+class ConstantParticipant : public MixerParticipant {
+ public:
+  ConstantParticipant(int id, WebRtc_Word16 value)
+      : id_(id),
+        value_(value) {
+  }
+  virtual ~ConstantParticipant() {}
+
+  virtual WebRtc_Word32 GetAudioFrame(const WebRtc_Word32 id,
+                                      AudioFrame& audioFrame) {
+    WebRtc_Word16 samples[kSamplesPer10Ms];
+    for (int i = 0; i < kSamplesPer10Ms; i++) {
+      samples[i] = value_;
+    }
+    return audioFrame.UpdateFrame(id_, 0, samples, kSamplesPer10Ms,
+                                  kSampleRateHz, AudioFrame::kNormalSpeech,
+                                  AudioFrame::kVadActive);
+  }
+
+  virtual WebRtc_Word32 NeededFrequency(const WebRtc_Word32 id) {
+    return kSampleRateHz;
+  }
+
+ private:
+  int id_;
+  WebRtc_Word16 value_;
+};
+
+// Stores the last sample of every frame delivered by the mixer.
+class OutputReceiver : public AudioMixerOutputReceiver {
+ public:
+  OutputReceiver() : general_(0) {}
+  virtual ~OutputReceiver() {}
+
+  virtual void NewMixedAudio(const WebRtc_Word32 id,
+                             const AudioFrame& generalAudioFrame,
+                             const AudioFrame** uniqueAudioFrames,
+                             const WebRtc_UWord32 size) {
+    general_ = LastSample(generalAudioFrame);
+    unique_.clear();
+    for (WebRtc_UWord32 i = 0; i < size; i++) {
+      unique_[uniqueAudioFrames[i]->_id] = LastSample(*uniqueAudioFrames[i]);
+    }
+  }
+
+  int general() const { return general_; }
+  const std::map<int, int>& unique() const { return unique_; }
+
+ private:
+  static int LastSample(const AudioFrame& frame) {
+    return frame._payloadData[
+        frame._payloadDataLengthInSamples * frame._audioChannel - 1];
+  }
+
+  int general_;
+  std::map<int, int> unique_;
+};
 
 TEST(AudioConferenceMixerTest, EmptyTestToGetCodeCoverage) {}
+
+class AudioConferenceMixerProcessTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    mixer_.reset(AudioConferenceMixer::Create(0));
+    ASSERT_TRUE(mixer_.get() != NULL);
+    ASSERT_EQ(0, mixer_->RegisterMixedStreamCallback(receiver_));
+  }
+
+  virtual void TearDown() {
+    EXPECT_EQ(0, mixer_->UnRegisterMixedStreamCallback());
+  }
+
+  scoped_ptr<AudioConferenceMixer> mixer_;
+  OutputReceiver receiver_;
+};
+
+TEST_F(AudioConferenceMixerProcessTest, MaximumAmountOfMixedParticipants) {
+  WebRtc_UWord32 amount = 0;
+  EXPECT_EQ(0, mixer_->MaximumAmountOfMixedParticipants(amount));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(
+      AudioConferenceMixer::kDefaultAmountOfMixedParticipants), amount);
+
+  EXPECT_EQ(-1, mixer_->SetMaximumAmountOfMixedParticipants(0));
+  EXPECT_EQ(-1, mixer_->SetMaximumAmountOfMixedParticipants(
+      AudioConferenceMixer::kMaximumAmountOfMixedParticipants + 1));
+  EXPECT_EQ(0, mixer_->SetMaximumAmountOfMixedParticipants(
+      AudioConferenceMixer::kMaximumAmountOfMixedParticipants));
+  EXPECT_EQ(0, mixer_->MaximumAmountOfMixedParticipants(amount));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(
+      AudioConferenceMixer::kMaximumAmountOfMixedParticipants), amount);
+}
+
+TEST_F(AudioConferenceMixerProcessTest, MixMinusExcludesOwnAudio) {
+  const WebRtc_Word16 kValues[] = {100, 200, 400, 800, 1600};
+  const int kNumParticipants = sizeof(kValues) / sizeof(kValues[0]);
+  const int kNumMixed = 4;
+  ConstantParticipant* participants[kNumParticipants];
+  for (int i = 0; i < kNumParticipants; i++) {
+    participants[i] = new ConstantParticipant(i, kValues[i]);
+    ASSERT_EQ(0, mixer_->SetMixabilityStatus(*participants[i], true));
+  }
+  ASSERT_EQ(0, mixer_->SetMaximumAmountOfMixedParticipants(kNumMixed));
+
+  // Without mix-minus there are no unique frames.
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(0, mixer_->Process());
+  }
+  EXPECT_TRUE(receiver_.unique().empty());
+  // The participant with the lowest energy is not mixed.
+  const int kMixedSum = 200 + 400 + 800 + 1600;
+  EXPECT_NEAR(kMixedSum, receiver_.general(), 2);
+
+  bool enabled = false;
+  EXPECT_EQ(0, mixer_->SetMixMinusStatus(true));
+  EXPECT_EQ(0, mixer_->MixMinusStatus(enabled));
+  EXPECT_TRUE(enabled);
+
+  // Let the mix-minus limiters settle.
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(0, mixer_->Process());
+  }
+
+  EXPECT_NEAR(kMixedSum, receiver_.general(), 2);
+  ASSERT_EQ(static_cast<size_t>(kNumMixed), receiver_.unique().size());
+  EXPECT_TRUE(receiver_.unique().find(0) == receiver_.unique().end());
+  for (int i = 1; i < kNumParticipants; i++) {
+    std::map<int, int>::const_iterator it = receiver_.unique().find(i);
+    ASSERT_TRUE(it != receiver_.unique().end());
+    EXPECT_NEAR(kMixedSum - kValues[i], it->second, 2);
+  }
+
+  EXPECT_EQ(0, mixer_->SetMixMinusStatus(false));
+  EXPECT_EQ(0, mixer_->Process());
+  EXPECT_TRUE(receiver_.unique().empty());
+
+  for (int i = 0; i < kNumParticipants; i++) {
+    EXPECT_EQ(0, mixer_->SetMixabilityStatus(*participants[i], false));
+    delete participants[i];
+  }
+}
+
+TEST_F(AudioConferenceMixerProcessTest, MixMinusForAnonymousParticipants) {
+  const WebRtc_Word16 kValues[] = {100, 200, 400, 800};
+  const int kNumParticipants = sizeof(kValues) / sizeof(kValues[0]);
+  const int kNumMixed = 2;
+  ConstantParticipant* participants[kNumParticipants];
+  for (int i = 0; i < kNumParticipants; i++) {
+    participants[i] = new ConstantParticipant(i, kValues[i]);
+    ASSERT_EQ(0, mixer_->SetMixabilityStatus(*participants[i], true));
+  }
+  // The quietest participant is always mixed, without taking one of the
+  // kNumMixed places.
+  ASSERT_EQ(0, mixer_->SetAnonymousMixabilityStatus(*participants[0], true));
+  ASSERT_EQ(0, mixer_->SetMaximumAmountOfMixedParticipants(kNumMixed));
+  EXPECT_EQ(0, mixer_->SetMixMinusStatus(true));
+
+  // Let the mix-minus limiters settle.
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(0, mixer_->Process());
+  }
+
+  const int kMixedSum = 100 + 400 + 800;
+  EXPECT_NEAR(kMixedSum, receiver_.general(), 2);
+  ASSERT_EQ(static_cast<size_t>(kNumMixed + 1), receiver_.unique().size());
+  EXPECT_TRUE(receiver_.unique().find(1) == receiver_.unique().end());
+  const int kHeard[] = {0, 2, 3};
+  for (size_t i = 0; i < sizeof(kHeard) / sizeof(kHeard[0]); i++) {
+    std::map<int, int>::const_iterator it =
+        receiver_.unique().find(kHeard[i]);
+    ASSERT_TRUE(it != receiver_.unique().end());
+    EXPECT_NEAR(kMixedSum - kValues[kHeard[i]], it->second, 2);
+  }
+
+  for (int i = 0; i < kNumParticipants; i++) {
+    EXPECT_EQ(0, mixer_->SetMixabilityStatus(*participants[i], false));
+    delete participants[i];
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
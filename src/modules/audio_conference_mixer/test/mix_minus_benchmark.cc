@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of producing an "everyone but me" mix for every
+// participant in a room, either with one mixer per participant (the only
+// option without mix-minus) or with a single mixer in mix-minus mode.
+//
+// Usage: audio_conference_mixer_benchmark [num_participants [num_speakers]]
+// By default a 100 participant room with 3 simultaneous speakers is used.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "audio_conference_mixer.h"
+#include "audio_conference_mixer_defines.h"
+#include "module_common_types.h"
+#include "scoped_ptr.h"
+#include "tick_util.h"
+
+using webrtc::AudioConferenceMixer;
+using webrtc::AudioFrame;
+
+namespace {
+
+const int kSeconds = 2;
+const int kSampleRateHz = 16000;
+const int kSamplesPer10Ms = kSampleRateHz / 100;
+const double kPi = 3.14159265358979323846;
+
+// Plays back a pregenerated signal: a tone for speakers, low-level noise for
+// everyone else.
+class Participant : public webrtc::MixerParticipant {
+ public:
+  Participant(int id, const std::vector<WebRtc_Word16>* signal, bool speaking)
+      : id_(id),
+        signal_(signal),
+        speaking_(speaking),
+        index_(0) {
+  }
+  virtual ~Participant() {}
+
+  virtual WebRtc_Word32 GetAudioFrame(const WebRtc_Word32 id,
+                                      AudioFrame& audioFrame) {
+    const int num_frames = static_cast<int>(signal_->size()) / kSamplesPer10Ms;
+    const WebRtc_Word16* samples =
+        &(*signal_)[(index_++ % num_frames) * kSamplesPer10Ms];
+    return audioFrame.UpdateFrame(
+        id_, 0, samples, kSamplesPer10Ms, kSampleRateHz,
+        AudioFrame::kNormalSpeech,
+        speaking_ ? AudioFrame::kVadActive : AudioFrame::kVadPassive);
+  }
+
+  virtual WebRtc_Word32 NeededFrequency(const WebRtc_Word32 id) {
+    return kSampleRateHz;
+  }
+
+ private:
+  int id_;
+  const std::vector<WebRtc_Word16>* signal_;
+  bool speaking_;
+  int index_;
+};
+
+class NullReceiver : public webrtc::AudioMixerOutputReceiver {
+ public:
+  virtual void NewMixedAudio(const WebRtc_Word32 id,
+                             const AudioFrame& generalAudioFrame,
+                             const AudioFrame** uniqueAudioFrames,
+                             const WebRtc_UWord32 size) {}
+};
+
+void GenerateSignal(int participant, bool speaking,
+                    std::vector<WebRtc_Word16>* signal) {
+  signal->resize(100 * kSamplesPer10Ms);
+  const double frequency = 200.0 + 10.0 * participant;
+  for (size_t i = 0; i < signal->size(); ++i) {
+    const double tone = speaking ?
+        5000 * sin(2 * kPi * frequency * i / kSampleRateHz) : 0;
+    (*signal)[i] = static_cast<WebRtc_Word16>(tone + (rand() % 200) - 100);
+  }
+}
+
+// Runs |kSeconds| of audio through |mixers| and returns the average time in
+// microseconds it takes to produce the outputs for one 10 ms frame.
+double MicrosecondsPer10Ms(
+    const std::vector<AudioConferenceMixer*>& mixers) {
+  const int num_frames = kSeconds * 100;
+  const webrtc::TickTime start = webrtc::TickTime::Now();
+  for (int k = 0; k < num_frames; ++k) {
+    for (size_t i = 0; i < mixers.size(); ++i) {
+      if (mixers[i]->Process() != 0) {
+        return -1.0;
+      }
+    }
+  }
+  return static_cast<double>(
+      (webrtc::TickTime::Now() - start).Microseconds()) / num_frames;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int num_participants = argc > 1 ? atoi(argv[1]) : 100;
+  const int num_speakers = argc > 2 ? atoi(argv[2]) :
+      AudioConferenceMixer::kDefaultAmountOfMixedParticipants;
+  if (num_participants < 2 || num_speakers < 0 ||
+      num_speakers > AudioConferenceMixer::kMaximumAmountOfMixedParticipants) {
+    printf("Usage: %s [num_participants [num_speakers]]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<std::vector<WebRtc_Word16> > signals(num_participants);
+  for (int i = 0; i < num_participants; ++i) {
+    GenerateSignal(i, i < num_speakers, &signals[i]);
+  }
+  NullReceiver receiver;
+
+  // One mixer per participant, each mixing everyone else. Every mixer needs
+  // its own participant objects since the mix history is per participant.
+  std::vector<AudioConferenceMixer*> per_participant_mixers;
+  std::vector<Participant*> participants;
+  for (int i = 0; i < num_participants; ++i) {
+    AudioConferenceMixer* mixer = AudioConferenceMixer::Create(i);
+    mixer->RegisterMixedStreamCallback(receiver);
+    for (int j = 0; j < num_participants; ++j) {
+      if (j == i) {
+        continue;
+      }
+      participants.push_back(new Participant(j, &signals[j],
+                                             j < num_speakers));
+      mixer->SetMixabilityStatus(*participants.back(), true);
+    }
+    per_participant_mixers.push_back(mixer);
+  }
+
+  // A single mixer in mix-minus mode.
+  std::vector<AudioConferenceMixer*> mix_minus_mixer;
+  mix_minus_mixer.push_back(AudioConferenceMixer::Create(num_participants));
+  mix_minus_mixer[0]->RegisterMixedStreamCallback(receiver);
+  mix_minus_mixer[0]->SetMixMinusStatus(true);
+  for (int j = 0; j < num_participants; ++j) {
+    participants.push_back(new Participant(j, &signals[j], j < num_speakers));
+    mix_minus_mixer[0]->SetMixabilityStatus(*participants.back(), true);
+  }
+
+  printf("%d participants, %d speakers, %d Hz\n", num_participants,
+         num_speakers, kSampleRateHz);
+  printf("Time to produce all outputs for 10 ms of audio:\n");
+  const double per_participant_us = MicrosecondsPer10Ms(per_participant_mixers);
+  printf("%-24s %10.1f us (%5.1f%% of real time)\n", "one mixer/participant",
+         per_participant_us, per_participant_us / 100.0);
+  const double mix_minus_us = MicrosecondsPer10Ms(mix_minus_mixer);
+  printf("%-24s %10.1f us (%5.1f%% of real time)\n", "mix-minus",
+         mix_minus_us, mix_minus_us / 100.0);
+
+  for (size_t i = 0; i < per_participant_mixers.size(); ++i) {
+    per_participant_mixers[i]->UnRegisterMixedStreamCallback();
+    delete per_participant_mixers[i];
+  }
+  mix_minus_mixer[0]->UnRegisterMixedStreamCallback();
+  delete mix_minus_mixer[0];
+  for (size_t i = 0; i < participants.size(); ++i) {
+    delete participants[i];
+  }
+  return 0;
+}
@@ -19,6 +19,7 @@ LOCAL_CPP_EXTENSION := .cc
 LOCAL_SRC_FILES := \
     $(call all-proto-files-under, .) \
     audio_buffer.cc \
+    audio_processing_batch_impl.cc \
     audio_processing_impl.cc \
     echo_cancellation_impl.cc \
     echo_control_mobile_impl.cc \
@@ -101,6 +101,9 @@ WebRtc_Word32 WebRtcAecm_Create(void **aecmInst)
         return -1;
     }
 
+    // Select the fastest signal processing functions for this CPU.
+    WebRtcSpl_Init();
+
     if (WebRtcAecm_CreateCore(&aecm->aecmCore) == -1)
     {
         WebRtcAecm_Free(aecm);
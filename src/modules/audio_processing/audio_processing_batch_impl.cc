@@ -0,0 +1,240 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_processing_batch_impl.h"
+
+#include <assert.h>
+
+#include "audio_processing_impl.h"
+#include "event_wrapper.h"
+#if defined(WEBRTC_NS_FLOAT)
+#include "noise_suppression.h"
+#endif
+#include "thread_wrapper.h"
+
+namespace webrtc {
+namespace {
+// set_num_channels() allows up to two output channels, each with its own
+// noise suppressor. The noise estimates of a shard are indexed by channel,
+// then by stream, so that those of mono streams are next to each other.
+const int kMaxNsChannels = 2;
+}  // namespace
+
+AudioProcessingBatch* AudioProcessingBatch::Create(int id,
+                                                   int num_streams,
+                                                   int num_threads) {
+  AudioProcessingBatchImpl* batch = new AudioProcessingBatchImpl();
+  if (batch->Init(id, num_streams, num_threads) !=
+      AudioProcessing::kNoError) {
+    delete batch;
+    batch = NULL;
+  }
+  return batch;
+}
+
+AudioProcessingBatchImpl::AudioProcessingBatchImpl()
+    : caller_end_stream_(0),
+      operation_(kProcessStream),
+      frames_(NULL),
+      done_event_(EventWrapper::Create()) {
+}
+
+AudioProcessingBatchImpl::~AudioProcessingBatchImpl() {
+  StopWorkers();
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    AudioProcessing::Destroy(streams_[i]);
+  }
+  // The noise suppressors of the streams are gone; their batches can go.
+#if defined(WEBRTC_NS_FLOAT)
+  for (size_t i = 0; i < ns_batches_.size(); ++i) {
+    WebRtcNs_FreeBatch(ns_batches_[i]);
+  }
+#endif
+}
+
+int AudioProcessingBatchImpl::Init(int id, int num_streams, int num_threads) {
+  if (num_streams < 1 || num_threads < 1) {
+    return AudioProcessing::kBadParameterError;
+  }
+  if (num_threads > num_streams) {
+    num_threads = num_streams;
+  }
+
+  for (int i = 0; i < num_streams; ++i) {
+    AudioProcessing* apm = AudioProcessing::Create(id + i);
+    if (apm == NULL) {
+      return AudioProcessing::kCreationFailedError;
+    }
+    streams_.push_back(static_cast<AudioProcessingImpl*>(apm));
+  }
+  results_.resize(num_streams);
+
+  // Split the streams as evenly as possible; the calling thread takes the
+  // first shard.
+  caller_end_stream_ = num_streams / num_threads;
+  ns_batches_.push_back(CreateNsBatch(0, caller_end_stream_));
+  workers_.resize(num_threads - 1);
+  for (int i = 0; i < num_threads - 1; ++i) {
+    Worker& worker = workers_[i];
+    worker.parent = this;
+    worker.first_stream = (i + 1) * num_streams / num_threads;
+    worker.end_stream = (i + 2) * num_streams / num_threads;
+    worker.ns_batch = CreateNsBatch(worker.first_stream, worker.end_stream);
+    ns_batches_.push_back(worker.ns_batch);
+    worker.start_event = EventWrapper::Create();
+    worker.thread = ThreadWrapper::CreateThread(WorkerThread, &worker,
+                                                kHighPriority,
+                                                "AudioProcessingBatch");
+    unsigned int thread_id = 0;
+    if (worker.thread == NULL || !worker.thread->Start(thread_id)) {
+      delete worker.thread;
+      worker.thread = NULL;
+      return AudioProcessing::kCreationFailedError;
+    }
+  }
+  return AudioProcessing::kNoError;
+}
+
+int AudioProcessingBatchImpl::num_streams() const {
+  return static_cast<int>(streams_.size());
+}
+
+int AudioProcessingBatchImpl::num_threads() const {
+  return static_cast<int>(workers_.size()) + 1;
+}
+
+AudioProcessing* AudioProcessingBatchImpl::stream(int index) {
+  if (index < 0 || index >= num_streams()) {
+    return NULL;
+  }
+  return streams_[index];
+}
+
+int AudioProcessingBatchImpl::ProcessStreams(AudioFrame* const* frames,
+                                             int* errors) {
+  return Run(kProcessStream, frames, errors);
+}
+
+int AudioProcessingBatchImpl::AnalyzeReverseStreams(AudioFrame* const* frames,
+                                                    int* errors) {
+  return Run(kAnalyzeReverseStream, frames, errors);
+}
+
+int AudioProcessingBatchImpl::Run(Operation operation,
+                                  AudioFrame* const* frames,
+                                  int* errors) {
+  if (frames == NULL) {
+    return AudioProcessing::kNullPointerError;
+  }
+  operation_ = operation;
+  frames_ = frames;
+
+  // Setting the events publishes the operation and the frames to the
+  // workers.
+  pending_workers_ = static_cast<WebRtc_Word32>(workers_.size());
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i].start_event->Set();
+  }
+  ProcessShard(0, caller_end_stream_, ns_batches_[0]);
+  while (pending_workers_.Value() > 0) {
+    done_event_->Wait(WEBRTC_EVENT_INFINITE);
+  }
+  frames_ = NULL;
+
+  int result = AudioProcessing::kNoError;
+  for (size_t i = 0; i < results_.size(); ++i) {
+    if (results_[i] != AudioProcessing::kNoError) {
+      result = results_[i];
+    }
+    if (errors != NULL) {
+      errors[i] = results_[i];
+    }
+  }
+  return result;
+}
+
+NsBatch* AudioProcessingBatchImpl::CreateNsBatch(int first, int end) {
+  NsBatch* ns_batch = NULL;
+#if defined(WEBRTC_NS_FLOAT)
+  if (WebRtcNs_CreateBatch(&ns_batch, (end - first) * kMaxNsChannels) != 0) {
+    ns_batch = NULL;
+  }
+#endif
+  return ns_batch;
+}
+
+void AudioProcessingBatchImpl::ProcessShard(int first, int end,
+                                            NsBatch* ns_batch) {
+  if (operation_ == kAnalyzeReverseStream) {
+    for (int i = first; i < end; ++i) {
+      AudioFrame* frame = frames_[i];
+      results_[i] = frame == NULL ? AudioProcessing::kNoError :
+          streams_[i]->AnalyzeReverseStreamLocked(frame);
+    }
+    return;
+  }
+
+  // Process the streams up to their noise estimates, update the estimates of
+  // the whole shard at once, and finish the streams.
+  for (int i = first; i < end; ++i) {
+    AudioFrame* frame = frames_[i];
+    results_[i] = frame == NULL ? AudioProcessing::kNoError :
+        streams_[i]->AnalyzeCaptureStream(frame, ns_batch, i - first,
+                                          end - first);
+  }
+#if defined(WEBRTC_NS_FLOAT)
+  if (ns_batch != NULL) {
+    WebRtcNs_ProcessBatch(ns_batch);
+  }
+#endif
+  for (int i = first; i < end; ++i) {
+    AudioFrame* frame = frames_[i];
+    if (frame != NULL && results_[i] == AudioProcessing::kNoError) {
+      results_[i] = streams_[i]->SuppressCaptureStream(frame);
+    }
+  }
+}
+
+bool AudioProcessingBatchImpl::WorkerThread(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  return worker->parent->WorkerProcess(worker);
+}
+
+bool AudioProcessingBatchImpl::WorkerProcess(Worker* worker) {
+  if (worker->start_event->Wait(WEBRTC_EVENT_INFINITE) != kEventSignaled) {
+    return true;
+  }
+  // Woken without a batch by StopWorkers().
+  if (frames_ == NULL) {
+    return true;
+  }
+  ProcessShard(worker->first_stream, worker->end_stream, worker->ns_batch);
+  if (--pending_workers_ == 0) {
+    done_event_->Set();
+  }
+  return true;
+}
+
+void AudioProcessingBatchImpl::StopWorkers() {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker& worker = workers_[i];
+    if (worker.thread != NULL) {
+      worker.thread->SetNotAlive();
+      worker.start_event->Set();
+      if (worker.thread->Stop()) {
+        delete worker.thread;
+      }
+    }
+    delete worker.start_event;
+  }
+  workers_.clear();
+}
+
+}  // namespace webrtc
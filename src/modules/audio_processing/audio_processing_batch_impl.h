@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_AUDIO_PROCESSING_BATCH_IMPL_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_AUDIO_PROCESSING_BATCH_IMPL_H_
+
+#include "audio_processing_batch.h"
+
+#include <vector>
+
+#include "atomic32_wrapper.h"
+#include "scoped_ptr.h"
+
+typedef struct NsBatchT NsBatch;
+
+namespace webrtc {
+class AudioProcessingImpl;
+class EventWrapper;
+class ThreadWrapper;
+
+class AudioProcessingBatchImpl : public AudioProcessingBatch {
+ public:
+  AudioProcessingBatchImpl();
+  virtual ~AudioProcessingBatchImpl();
+
+  int Init(int id, int num_streams, int num_threads);
+
+  // AudioProcessingBatch methods.
+  virtual int num_streams() const;
+  virtual int num_threads() const;
+  virtual AudioProcessing* stream(int index);
+  virtual int ProcessStreams(AudioFrame* const* frames, int* errors);
+  virtual int AnalyzeReverseStreams(AudioFrame* const* frames, int* errors);
+
+ private:
+  enum Operation {
+    kProcessStream,
+    kAnalyzeReverseStream
+  };
+
+  // A worker thread and the shard of streams it processes.
+  struct Worker {
+    AudioProcessingBatchImpl* parent;
+    ThreadWrapper* thread;
+    EventWrapper* start_event;
+    int first_stream;
+    int end_stream;
+    NsBatch* ns_batch;
+  };
+
+  static bool WorkerThread(void* obj);
+  bool WorkerProcess(Worker* worker);
+
+  // Runs |operation| on all streams and waits for the workers.
+  int Run(Operation operation, AudioFrame* const* frames, int* errors);
+
+  // Runs the current operation on the streams in [first, end), with the
+  // noise estimates of the shard in |ns_batch|.
+  void ProcessShard(int first, int end, NsBatch* ns_batch);
+
+  // Returns the noise estimate batch for the shard [first, end), or NULL if
+  // the noise suppressor can't be batched.
+  static NsBatch* CreateNsBatch(int first, int end);
+
+  // Stops and deletes the worker threads.
+  void StopWorkers();
+
+  std::vector<AudioProcessingImpl*> streams_;
+  std::vector<Worker> workers_;
+  // The calling thread's shard is [0, caller_end_stream_).
+  int caller_end_stream_;
+  // The noise estimate batches of the shards, the calling thread's first.
+  std::vector<NsBatch*> ns_batches_;
+
+  // The current operation, set before the workers are started.
+  Operation operation_;
+  AudioFrame* const* frames_;
+  std::vector<int> results_;
+
+  // The number of workers that haven't finished the current operation.
+  Atomic32Wrapper pending_workers_;
+  scoped_ptr<EventWrapper> done_event_;
+};
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_AUDIO_PROCESSING_BATCH_IMPL_H_
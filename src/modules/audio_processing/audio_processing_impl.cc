@@ -255,6 +255,17 @@ int AudioProcessingImpl::num_output_channels() const {
 
 int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
   CriticalSectionScoped crit_scoped(*crit_);
+  int err = AnalyzeCaptureStream(frame, NULL, 0, 0);
+  if (err != kNoError) {
+    return err;
+  }
+  return SuppressCaptureStream(frame);
+}
+
+int AudioProcessingImpl::AnalyzeCaptureStream(AudioFrame* frame,
+                                              NsBatch* ns_batch,
+                                              int ns_index,
+                                              int ns_channel_stride) {
   int err = kNoError;
 
   if (frame == NULL) {
@@ -327,7 +338,12 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
     capture_audio_->CopyLowPassToReference();
   }
 
-  err = noise_suppression_->ProcessCaptureAudio(capture_audio_);
+  return noise_suppression_->AnalyzeCaptureAudio(capture_audio_, ns_batch,
+                                                 ns_index, ns_channel_stride);
+}
+
+int AudioProcessingImpl::SuppressCaptureStream(AudioFrame* frame) {
+  int err = noise_suppression_->SuppressCaptureAudio(capture_audio_);
   if (err != kNoError) {
     return err;
   }
@@ -347,6 +363,7 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
     return err;
   }
 
+  bool data_changed = stream_data_changed();
   if (synthesis_needed(data_changed)) {
     for (int i = 0; i < num_output_channels_; i++) {
       // Recombine low and high bands.
@@ -386,6 +403,10 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
 
 int AudioProcessingImpl::AnalyzeReverseStream(AudioFrame* frame) {
   CriticalSectionScoped crit_scoped(*crit_);
+  return AnalyzeReverseStreamLocked(frame);
+}
+
+int AudioProcessingImpl::AnalyzeReverseStreamLocked(AudioFrame* frame) {
   int err = kNoError;
 
   if (frame == NULL) {
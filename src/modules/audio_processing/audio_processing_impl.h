@@ -18,6 +18,8 @@
 
 #include "scoped_ptr.h"
 
+typedef struct NsBatchT NsBatch;
+
 namespace webrtc {
 class AudioBuffer;
 class CriticalSectionWrapper;
@@ -55,6 +57,19 @@ class AudioProcessingImpl : public AudioProcessing {
   int split_sample_rate_hz() const;
   bool was_stream_delay_set() const;
 
+  // ProcessStream() and AnalyzeReverseStream() without taking crit(); the
+  // caller holds it, or makes sure the instance isn't used concurrently as
+  // AudioProcessingBatchImpl does. ProcessStream() is split around the noise
+  // suppression's noise estimate: AnalyzeCaptureStream() queues the
+  // estimates in |ns_batch|, as NoiseSuppressionImpl::AnalyzeCaptureAudio()
+  // does, and SuppressCaptureStream() finishes the frame after
+  // WebRtcNs_ProcessBatch(). With a NULL |ns_batch|, the first half runs the
+  // whole noise suppression.
+  int AnalyzeCaptureStream(AudioFrame* frame, NsBatch* ns_batch,
+                           int ns_index, int ns_channel_stride);
+  int SuppressCaptureStream(AudioFrame* frame);
+  int AnalyzeReverseStreamLocked(AudioFrame* frame);
+
   // AudioProcessing methods.
   virtual int Initialize();
   virtual int InitializeLocked();
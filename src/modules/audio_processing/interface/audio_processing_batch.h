@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_INTERFACE_AUDIO_PROCESSING_BATCH_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_INTERFACE_AUDIO_PROCESSING_BATCH_H_
+
+#include "audio_processing.h"
+
+namespace webrtc {
+class AudioFrame;
+
+// Processes many independent primary streams, e.g. the incoming streams of a
+// conference server, with one call per 10 ms.
+//
+// Each stream has its own APM instance, configured through |stream()| as
+// usual. The batch processes the streams without taking their locks, and
+// shares the noise suppression's quantile noise estimate between them: the
+// estimates of all streams of a shard are stored side by side, streams
+// innermost, and updated by one vectorized pass per 10 ms instead of one per
+// stream. The output is the same as from each instance's ProcessStream().
+// The other components still run per stream.
+//
+// The streams are split into fixed, contiguous shards, one for each thread.
+// The calling thread processes the first shard and a pool of worker threads
+// the others. A stream is always processed by the same thread, so its state
+// tends to stay in that thread's cache.
+//
+// Usage example, omitting error checking:
+// AudioProcessingBatch* batch = AudioProcessingBatch::Create(0, 64, 4);
+// for (int i = 0; i < batch->num_streams(); ++i) {
+//   batch->stream(i)->set_sample_rate_hz(16000);
+//   batch->stream(i)->noise_suppression()->Enable(true);
+// }
+//
+// // Every 10 ms, with one frame per stream:
+// batch->ProcessStreams(frames, NULL);
+//
+// delete batch;
+class AudioProcessingBatch {
+ public:
+  // Creates a batch of |num_streams| APM instances, processed by
+  // |num_threads| threads including the calling thread. The instances get
+  // the identifiers |id|, |id| + 1, ..., |id| + |num_streams| - 1.
+  static AudioProcessingBatch* Create(int id, int num_streams,
+                                      int num_threads);
+  virtual ~AudioProcessingBatch() {}
+
+  virtual int num_streams() const = 0;
+  virtual int num_threads() const = 0;
+
+  // Returns the APM instance of stream |index|, for configuration and for the
+  // stream_ setters and getters. It may also process its stream on its own,
+  // with the frames the batch skips. It must not be used concurrently with
+  // ProcessStreams() or AnalyzeReverseStreams(), which don't lock it.
+  virtual AudioProcessing* stream(int index) = 0;
+
+  // Calls ProcessStream() on every stream |i| with |frames[i]|, and returns
+  // when all streams are done. A NULL frame skips its stream. If |errors| is
+  // not NULL, the result for stream |i| is stored in |errors[i]|. Returns
+  // kNoError if all streams succeeded, otherwise one of the errors.
+  virtual int ProcessStreams(AudioFrame* const* frames, int* errors) = 0;
+
+  // As ProcessStreams(), but calls AnalyzeReverseStream().
+  virtual int AnalyzeReverseStreams(AudioFrame* const* frames,
+                                    int* errors) = 0;
+};
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_INTERFACE_AUDIO_PROCESSING_BATCH_H_
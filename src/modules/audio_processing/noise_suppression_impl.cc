@@ -50,7 +50,8 @@ int MapSetting(NoiseSuppression::Level level) {
 NoiseSuppressionImpl::NoiseSuppressionImpl(const AudioProcessingImpl* apm)
   : ProcessingComponent(apm),
     apm_(apm),
-    level_(kModerate) {}
+    level_(kModerate),
+    suppression_pending_(false) {}
 
 NoiseSuppressionImpl::~NoiseSuppressionImpl() {}
 
@@ -87,6 +88,54 @@ int NoiseSuppressionImpl::ProcessCaptureAudio(AudioBuffer* audio) {
   return apm_->kNoError;
 }
 
+int NoiseSuppressionImpl::AnalyzeCaptureAudio(AudioBuffer* audio,
+                                              NsBatch* batch,
+                                              int index,
+                                              int channel_stride) {
+  suppression_pending_ = false;
+#if defined(WEBRTC_NS_FLOAT)
+  if (batch == NULL || !is_component_enabled()) {
+    return ProcessCaptureAudio(audio);
+  }
+  assert(audio->samples_per_split_channel() <= 160);
+  assert(audio->num_channels() == num_handles());
+
+  for (int i = 0; i < num_handles(); i++) {
+    Handle* my_handle = static_cast<Handle*>(handle(i));
+    int err = WebRtcNs_Analyze(my_handle, batch, index + i * channel_stride,
+                               audio->low_pass_split_data(i),
+                               audio->high_pass_split_data(i));
+    if (err != apm_->kNoError) {
+      return GetHandleError(my_handle);
+    }
+  }
+  suppression_pending_ = true;
+  return apm_->kNoError;
+#else
+  return ProcessCaptureAudio(audio);
+#endif
+}
+
+int NoiseSuppressionImpl::SuppressCaptureAudio(AudioBuffer* audio) {
+  if (!suppression_pending_) {
+    return apm_->kNoError;
+  }
+  suppression_pending_ = false;
+
+#if defined(WEBRTC_NS_FLOAT)
+  for (int i = 0; i < num_handles(); i++) {
+    Handle* my_handle = static_cast<Handle*>(handle(i));
+    int err = WebRtcNs_Suppress(my_handle,
+                                audio->low_pass_split_data(i),
+                                audio->high_pass_split_data(i));
+    if (err != apm_->kNoError) {
+      return GetHandleError(my_handle);
+    }
+  }
+#endif
+  return apm_->kNoError;
+}
+
 int NoiseSuppressionImpl::Enable(bool enable) {
   CriticalSectionScoped crit_scoped(*apm_->crit());
   return EnableComponent(enable);
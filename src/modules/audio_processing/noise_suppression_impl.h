@@ -14,6 +14,8 @@
 #include "audio_processing.h"
 #include "processing_component.h"
 
+typedef struct NsBatchT NsBatch;
+
 namespace webrtc {
 class AudioProcessingImpl;
 class AudioBuffer;
@@ -26,6 +28,15 @@ class NoiseSuppressionImpl : public NoiseSuppression,
 
   int ProcessCaptureAudio(AudioBuffer* audio);
 
+  // ProcessCaptureAudio() in two halves, for AudioProcessingBatchImpl. The
+  // first queues the noise estimate of channel |i| in |batch|, at |index| +
+  // |i| * |channel_stride|, and the second suppresses the noise after
+  // WebRtcNs_ProcessBatch(). With a NULL |batch|, or with the fixed point
+  // NS, the first half does all the processing.
+  int AnalyzeCaptureAudio(AudioBuffer* audio, NsBatch* batch, int index,
+                          int channel_stride);
+  int SuppressCaptureAudio(AudioBuffer* audio);
+
   // NoiseSuppression implementation.
   virtual bool is_enabled() const;
 
@@ -48,6 +59,8 @@ class NoiseSuppressionImpl : public NoiseSuppression,
 
   const AudioProcessingImpl* apm_;
   Level level_;
+  // True between a batched AnalyzeCaptureAudio() and SuppressCaptureAudio().
+  bool suppression_pending_;
 };
 }  // namespace webrtc
 
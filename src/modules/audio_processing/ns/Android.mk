@@ -23,7 +23,7 @@ LOCAL_SRC_FILES := \
     nsx_core.c
 
 # Files for floating point.
-# noise_suppression.c ns_core.c 
+# noise_suppression.c ns_core.c ns_core_sse2.c
 
 # Flags passed to both C and C++ files.
 LOCAL_CFLAGS := $(MY_WEBRTC_COMMON_DEFS)
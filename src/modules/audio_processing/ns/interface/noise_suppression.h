@@ -14,6 +14,7 @@
 #include "typedefs.h"
 
 typedef struct NsHandleT NsHandle;
+typedef struct NsBatchT NsBatch;
 
 #ifdef __cplusplus
 extern "C" {
@@ -117,6 +118,88 @@ int WebRtcNs_Process(NsHandle* NS_inst,
                      short* outframe,
                      short* outframe_H);
 
+/*
+ * This function creates a batch, which holds the noise estimates of up to
+ * |num_instances| NS instances side by side and updates them in one call.
+ * WebRtcNs_Analyze(), WebRtcNs_ProcessBatch() and WebRtcNs_Suppress() then
+ * replace WebRtcNs_Process() for the instances of the batch. The batch must
+ * outlive its instances, and an instance may only be in one batch.
+ *
+ * Input:
+ *      - num_instances : Number of instances in the batch
+ *
+ * Output:
+ *      - batch         : Pointer to created batch
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_CreateBatch(NsBatch** batch, int num_instances);
+
+/*
+ * This function frees the dynamic memory of a batch.
+ *
+ * Input:
+ *      - batch         : Pointer to batch that should be freed
+ *
+ * Return value         :  0 - Ok
+ *                        -1 - Error
+ */
+int WebRtcNs_FreeBatch(NsBatch* batch);
+
+/*
+ * This function does the first half of WebRtcNs_Process(): it analyzes the
+ * speech frame and queues its noise estimate in |batch|.
+ *
+ * Input
+ *      - NS_inst       : NS Instance. Needs to be initiated before call.
+ *      - batch         : Batch for the noise estimate
+ *      - index         : Index of the instance in the batch, lower than
+ *                        the |num_instances| of the batch
+ *      - spframe       : Pointer to speech frame buffer for L band
+ *      - spframe_H     : Pointer to speech frame buffer for H band
+ *
+ * Output:
+ *      - NS_inst       : Updated NS instance
+ *
+ * Return value         :  0 - OK
+ *                        -1 - Error
+ */
+int WebRtcNs_Analyze(NsHandle* NS_inst,
+                     NsBatch* batch,
+                     int index,
+                     short* spframe,
+                     short* spframe_H);
+
+/*
+ * This function updates the noise estimates queued in |batch| since the
+ * last call, for all instances at once.
+ *
+ * Input
+ *      - batch         : Batch to update
+ *
+ * Return value         :  0 - OK
+ *                        -1 - Error
+ */
+int WebRtcNs_ProcessBatch(NsBatch* batch);
+
+/*
+ * This function does the second half of WebRtcNs_Process(), after
+ * WebRtcNs_ProcessBatch() on the batch of the WebRtcNs_Analyze() call.
+ *
+ * Input
+ *      - NS_inst       : NS Instance. Needs to be initiated before call.
+ *
+ * Output:
+ *      - NS_inst       : Updated NS instance
+ *      - outframe      : Pointer to output frame for L band
+ *      - outframe_H    : Pointer to output frame for H band
+ *
+ * Return value         :  0 - OK
+ *                        -1 - Error
+ */
+int WebRtcNs_Suppress(NsHandle* NS_inst, short* outframe, short* outframe_H);
+
 #ifdef __cplusplus
 }
 #endif
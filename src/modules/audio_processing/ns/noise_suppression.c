@@ -36,6 +36,8 @@ int WebRtcNs_Create(NsHandle** NS_inst) {
   *NS_inst = (NsHandle*) malloc(sizeof(NSinst_t));
   if (*NS_inst != NULL) {
     (*(NSinst_t**)NS_inst)->initFlag = 0;
+    (*(NSinst_t**)NS_inst)->quantileBatch = NULL;
+    (*(NSinst_t**)NS_inst)->estimateQueued = 0;
     return 0;
   } else {
     return -1;
@@ -63,3 +65,99 @@ int WebRtcNs_Process(NsHandle* NS_inst, short* spframe, short* spframe_H,
   return WebRtcNs_ProcessCore(
       (NSinst_t*) NS_inst, spframe, spframe_H, outframe, outframe_H);
 }
+
+int WebRtcNs_CreateBatch(NsBatch** batch, int num_instances) {
+  NSQuantileBatch_t* self;
+  int numLanes, i;
+
+  if (batch == NULL || num_instances < 1) {
+    return -1;
+  }
+  *batch = NULL;
+  self = (NSQuantileBatch_t*) calloc(1, sizeof(NSQuantileBatch_t));
+  if (self == NULL) {
+    return -1;
+  }
+
+  // The kernels process four lanes at once.
+  numLanes = (num_instances + 3) & ~3;
+  self->numLanes = numLanes;
+  self->magnLen = 0;
+  self->density = (float*) malloc(sizeof(float) * SIMULT * HALF_ANAL_BLOCKL *
+                                  numLanes);
+  self->lquantile = (float*) malloc(sizeof(float) * SIMULT *
+                                    HALF_ANAL_BLOCKL * numLanes);
+  self->lmagn = (float*) calloc(HALF_ANAL_BLOCKL * numLanes, sizeof(float));
+  self->counter = (int*) calloc(SIMULT * numLanes, sizeof(int));
+  self->pending = (int*) calloc(numLanes, sizeof(int));
+  if (self->density == NULL || self->lquantile == NULL ||
+      self->lmagn == NULL || self->counter == NULL || self->pending == NULL) {
+    WebRtcNs_FreeBatch((NsBatch*) self);
+    return -1;
+  }
+  // Lanes without an instance are never pending, but still go through the
+  // kernels; keep them at the initial estimates.
+  for (i = 0; i < SIMULT * HALF_ANAL_BLOCKL * numLanes; i++) {
+    self->lquantile[i] = (float)8.0;
+    self->density[i] = (float)0.3;
+  }
+
+  *batch = (NsBatch*) self;
+  return 0;
+}
+
+int WebRtcNs_FreeBatch(NsBatch* batch) {
+  NSQuantileBatch_t* self = (NSQuantileBatch_t*) batch;
+  if (self != NULL) {
+    free(self->density);
+    free(self->lquantile);
+    free(self->lmagn);
+    free(self->counter);
+    free(self->pending);
+    free(self);
+  }
+  return 0;
+}
+
+int WebRtcNs_Analyze(NsHandle* NS_inst, NsBatch* batch, int index,
+                     short* spframe, short* spframe_H) {
+  NSinst_t* inst = (NSinst_t*) NS_inst;
+  NSQuantileBatch_t* quantileBatch = (NSQuantileBatch_t*) batch;
+  int analyzed;
+
+  if (quantileBatch == NULL || index < 0 ||
+      index >= quantileBatch->numLanes) {
+    return -1;
+  }
+  analyzed = WebRtcNs_AnalyzeCore(inst, spframe, spframe_H);
+  if (analyzed < 0) {
+    return -1;
+  }
+  inst->estimateQueued = analyzed;
+  if (analyzed == 1) {
+    WebRtcNs_QueueNoiseEstimate(inst, quantileBatch, index);
+  }
+  return 0;
+}
+
+int WebRtcNs_ProcessBatch(NsBatch* batch) {
+  NSQuantileBatch_t* self = (NSQuantileBatch_t*) batch;
+  if (self == NULL) {
+    return -1;
+  }
+  if (self->magnLen > 0) {
+    WebRtcNs_UpdateQuantileBatch(self);
+    memset(self->pending, 0, sizeof(int) * self->numLanes);
+    self->magnLen = 0;
+  }
+  return 0;
+}
+
+int WebRtcNs_Suppress(NsHandle* NS_inst, short* outframe, short* outframe_H) {
+  NSinst_t* inst = (NSinst_t*) NS_inst;
+  if (inst->estimateQueued) {
+    WebRtcNs_FinishNoiseEstimate(inst);
+    inst->estimateQueued = 0;
+  }
+  return WebRtcNs_SuppressCore(inst, outframe, outframe_H);
+}
@@ -17,6 +17,7 @@
 #include "windows_private.h"
 #include "fft4g.h"
 #include "signal_processing_library.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
 
 // Set Feature Extraction Parameters
 void WebRtcNs_set_feature_extraction_parameters(NSinst_t* inst) {
@@ -67,6 +68,137 @@ void WebRtcNs_set_feature_extraction_parameters(NSinst_t* inst) {
       * (inst->modelUpdatePars[1])); //for spectral difference
 }
 
+static float AnalysisWindow(const float* window,
+                            const float* in,
+                            int length,
+                            float* out) {
+  int i;
+  float energy = 0.0;
+  for (i = 0; i < length; i++) {
+    out[i] = window[i] * in[i];
+    energy += out[i] * out[i];
+  }
+  return energy;
+}
+
+static void MagnitudeSpectrum(NSinst_t* inst,
+                              const float* fft,
+                              float* real,
+                              float* imag,
+                              float* magn,
+                              float* signalEnergy,
+                              float* sumMagn) {
+  int i;
+  float fTmp;
+  for (i = 1; i < inst->magnLen - 1; i++) {
+    real[i] = fft[2 * i];
+    imag[i] = fft[2 * i + 1];
+    fTmp = real[i] * real[i];
+    fTmp += imag[i] * imag[i];
+    *signalEnergy += fTmp;
+    magn[i] = ((float)sqrt(fTmp)) + 1.0f;
+    *sumMagn += magn[i];
+  }
+}
+
+// Steps the log quantile estimate |lquantile| towards |lmagn| and updates its
+// density, with |counter| previous updates of the estimate.
+__inline static void UpdateQuantileBin(float lmagn,
+                                       int counter,
+                                       float* lquantile,
+                                       float* density) {
+  float delta;
+  // compute delta
+  if (*density > 1.0) {
+    delta = FACTOR * (float)1.0 / *density;
+  } else {
+    delta = FACTOR;
+  }
+
+  // update log quantile estimate
+  if (lmagn > *lquantile) {
+    *lquantile += QUANTILE * delta / (float)(counter + 1);
+  } else {
+    *lquantile -= ((float)1.0 - QUANTILE) * delta / (float)(counter + 1);
+  }
+
+  // update density estimate
+  if (fabs(lmagn - *lquantile) < WIDTH) {
+    *density = ((float)counter * *density + (float)1.0 / ((float)2.0 * WIDTH))
+               / (float)(counter + 1);
+  }
+}
+
+static void UpdateQuantile(NSinst_t* inst,
+                           const float* lmagn,
+                           int offset,
+                           int counter) {
+  int i;
+  for (i = 0; i < inst->magnLen; i++) {
+    UpdateQuantileBin(lmagn[i], counter, &inst->lquantile[offset + i],
+                      &inst->density[offset + i]);
+  }
+}
+
+static void UpdateQuantileBatch(NSQuantileBatch_t* batch) {
+  int s, i, lane;
+  const int numLanes = batch->numLanes;
+  for (s = 0; s < SIMULT; s++) {
+    const int* counter = &batch->counter[s * numLanes];
+    float* lquantile = &batch->lquantile[s * HALF_ANAL_BLOCKL * numLanes];
+    float* density = &batch->density[s * HALF_ANAL_BLOCKL * numLanes];
+    for (i = 0; i < batch->magnLen; i++) {
+      const int bin = i * numLanes;
+      for (lane = 0; lane < numLanes; lane++) {
+        if (batch->pending[lane]) {
+          UpdateQuantileBin(batch->lmagn[bin + lane], counter[lane],
+                            &lquantile[bin + lane], &density[bin + lane]);
+        }
+      }
+    }
+  }
+}
+
+static void WienerFilter(NSinst_t* inst,
+                         const float* magn,
+                         const float* noise,
+                         const float* previousEstimateStsa,
+                         float* theFilter) {
+  int i;
+  float currentEstimateStsa, snrPrior;
+  for (i = 0; i < inst->magnLen; i++) {
+    // post and prior snr
+    currentEstimateStsa = (float)0.0;
+    if (magn[i] > noise[i]) {
+      currentEstimateStsa = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
+    }
+    // DD estimate is sume of two terms: current estimate and previous estimate
+    // directed decision update of snrPrior
+    snrPrior = DD_PR_SNR * previousEstimateStsa[i] + ((float)1.0 - DD_PR_SNR)
+               * currentEstimateStsa;
+    // gain filter
+    theFilter[i] = snrPrior / (inst->overdrive + snrPrior);
+  }
+}
+
+static void SynthesisWindow(const float* window,
+                            const float* in,
+                            float factor,
+                            int length,
+                            float* out) {
+  int i;
+  for (i = 0; i < length; i++) {
+    out[i] += factor * window[i] * in[i];
+  }
+}
+
+WebRtcNs_AnalysisWindow_t WebRtcNs_AnalysisWindow;
+WebRtcNs_MagnitudeSpectrum_t WebRtcNs_MagnitudeSpectrum;
+WebRtcNs_UpdateQuantile_t WebRtcNs_UpdateQuantile;
+WebRtcNs_UpdateQuantileBatch_t WebRtcNs_UpdateQuantileBatch;
+WebRtcNs_WienerFilter_t WebRtcNs_WienerFilter;
+WebRtcNs_SynthesisWindow_t WebRtcNs_SynthesisWindow;
+
 // Initialize state
 int WebRtcNs_InitCore(NSinst_t* inst, WebRtc_UWord32 fs) {
   int i;
@@ -131,6 +263,10 @@ int WebRtcNs_InitCore(NSinst_t* inst, WebRtc_UWord32 fs) {
   }
 
   inst->updates = 0;
+  // the estimates start over in |inst|, detached from any batch
+  inst->quantileBatch = NULL;
+  inst->quantileLane = 0;
+  inst->estimateQueued = 0;
 
   // Wiener filter initialization
   for (i = 0; i < HALF_ANAL_BLOCKL; i++) {
@@ -199,6 +335,20 @@ int WebRtcNs_InitCore(NSinst_t* inst, WebRtc_UWord32 fs) {
   //default mode
   WebRtcNs_set_policy_core(inst, 0);
 
+  // Assembly optimization
+  WebRtcNs_AnalysisWindow = AnalysisWindow;
+  WebRtcNs_MagnitudeSpectrum = MagnitudeSpectrum;
+  WebRtcNs_UpdateQuantile = UpdateQuantile;
+  WebRtcNs_UpdateQuantileBatch = UpdateQuantileBatch;
+  WebRtcNs_WienerFilter = WienerFilter;
+  WebRtcNs_SynthesisWindow = SynthesisWindow;
+  fft4g_init();
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+#if defined(WEBRTC_USE_SSE2)
+    WebRtcNs_InitCore_SSE2();
+#endif
+  }
+
 
   memset(inst->outBuf, 0, sizeof(float) * 3 * BLOCKL_MAX);
 
@@ -236,10 +386,119 @@ int WebRtcNs_set_policy_core(NSinst_t* inst, int mode) {
   return 0;
 }
 
+// Index of bin |i| of the simultaneous estimate |s| of |lane| in the
+// density and lquantile arrays of |batch|.
+static int QuantileBatchIndex(const NSQuantileBatch_t* batch,
+                              int s,
+                              int i,
+                              int lane) {
+  return (s * HALF_ANAL_BLOCKL + i) * batch->numLanes + lane;
+}
+
+// Moves the quantile estimates of |inst| back from its lane.
+static void DetachQuantileBatch(NSinst_t* inst) {
+  const NSQuantileBatch_t* batch = inst->quantileBatch;
+  const int lane = inst->quantileLane;
+  int i, s, k;
+  for (s = 0; s < SIMULT; s++) {
+    for (i = 0; i < inst->magnLen; i++) {
+      k = QuantileBatchIndex(batch, s, i, lane);
+      inst->lquantile[s * inst->magnLen + i] = batch->lquantile[k];
+      inst->density[s * inst->magnLen + i] = batch->density[k];
+    }
+    inst->counter[s] = batch->counter[s * batch->numLanes + lane];
+  }
+  inst->quantileBatch = NULL;
+  inst->quantileLane = 0;
+}
+
+// Moves the quantile estimates of |inst| to |lane| of |batch|.
+static void AttachQuantileBatch(NSinst_t* inst,
+                                NSQuantileBatch_t* batch,
+                                int lane) {
+  int i, s, k;
+  for (s = 0; s < SIMULT; s++) {
+    for (i = 0; i < inst->magnLen; i++) {
+      k = QuantileBatchIndex(batch, s, i, lane);
+      batch->lquantile[k] = inst->lquantile[s * inst->magnLen + i];
+      batch->density[k] = inst->density[s * inst->magnLen + i];
+    }
+    batch->counter[s * batch->numLanes + lane] = inst->counter[s];
+  }
+  batch->pending[lane] = 0;
+  inst->quantileBatch = batch;
+  inst->quantileLane = lane;
+}
+
+// Completes the noise estimate of an attached |inst| after the update of its
+// lane, as the end of WebRtcNs_NoiseEstimation().
+static void FinishLaneEstimate(NSinst_t* inst, float* noise) {
+  NSQuantileBatch_t* batch = inst->quantileBatch;
+  const int lane = inst->quantileLane;
+  int i, s;
+  int* counter;
+
+  for (s = 0; s < SIMULT; s++) {
+    counter = &batch->counter[s * batch->numLanes + lane];
+    if (*counter >= END_STARTUP_LONG) {
+      *counter = 0;
+      if (inst->updates >= END_STARTUP_LONG) {
+        for (i = 0; i < inst->magnLen; i++) {
+          inst->quantile[i] = (float)exp(
+              batch->lquantile[QuantileBatchIndex(batch, s, i, lane)]);
+        }
+      }
+    }
+    (*counter)++;
+  }
+
+  // Sequentially update the noise during startup
+  if (inst->updates < END_STARTUP_LONG) {
+    // Use the last "s" to get noise during startup that differ from zero.
+    for (i = 0; i < inst->magnLen; i++) {
+      inst->quantile[i] = (float)exp(
+          batch->lquantile[QuantileBatchIndex(batch, SIMULT - 1, i, lane)]);
+    }
+  }
+
+  for (i = 0; i < inst->magnLen; i++) {
+    noise[i] = inst->quantile[i];
+  }
+}
+
+void WebRtcNs_QueueNoiseEstimate(NSinst_t* inst,
+                                 NSQuantileBatch_t* batch,
+                                 int lane) {
+  int i;
+
+  if (inst->quantileBatch != batch || inst->quantileLane != lane) {
+    if (inst->quantileBatch != NULL) {
+      DetachQuantileBatch(inst);
+    }
+    AttachQuantileBatch(inst, batch, lane);
+  }
+
+  if (inst->updates < END_STARTUP_LONG) {
+    inst->updates++;
+  }
+
+  for (i = 0; i < inst->magnLen; i++) {
+    batch->lmagn[i * batch->numLanes + lane] = (float)log(inst->magn[i]);
+  }
+  if (inst->magnLen > batch->magnLen) {
+    batch->magnLen = inst->magnLen;
+  }
+  batch->pending[lane] = 1;
+}
+
+void WebRtcNs_FinishNoiseEstimate(NSinst_t* inst) {
+  FinishLaneEstimate(inst, inst->noise);
+}
+
 // Estimate noise
 void WebRtcNs_NoiseEstimation(NSinst_t* inst, float* magn, float* noise) {
   int i, s, offset;
-  float lmagn[HALF_ANAL_BLOCKL], delta;
+  float lmagn[HALF_ANAL_BLOCKL];
 
   if (inst->updates < END_STARTUP_LONG) {
     inst->updates++;
@@ -249,34 +508,29 @@ void WebRtcNs_NoiseEstimation(NSinst_t* inst, float* magn, float* noise) {
     lmagn[i] = (float)log(magn[i]);
   }
 
+  if (inst->quantileBatch != NULL) {
+    // Update this lane only: the instances of the other lanes may be
+    // processed concurrently.
+    NSQuantileBatch_t* batch = inst->quantileBatch;
+    const int lane = inst->quantileLane;
+    for (s = 0; s < SIMULT; s++) {
+      const int counter = batch->counter[s * batch->numLanes + lane];
+      for (i = 0; i < inst->magnLen; i++) {
+        offset = QuantileBatchIndex(batch, s, i, lane);
+        UpdateQuantileBin(lmagn[i], counter, &batch->lquantile[offset],
+                          &batch->density[offset]);
+      }
+    }
+    FinishLaneEstimate(inst, noise);
+    return;
+  }
+
   // loop over simultaneous estimates
   for (s = 0; s < SIMULT; s++) {
     offset = s * inst->magnLen;
 
     // newquantest(...)
-    for (i = 0; i < inst->magnLen; i++) {
-      // compute delta
-      if (inst->density[offset + i] > 1.0) {
-        delta = FACTOR * (float)1.0 / inst->density[offset + i];
-      } else {
-        delta = FACTOR;
-      }
-
-      // update log quantile estimate
-      if (lmagn[i] > inst->lquantile[offset + i]) {
-        inst->lquantile[offset + i] += QUANTILE * delta
-                                       / (float)(inst->counter[s] + 1);
-      } else {
-        inst->lquantile[offset + i] -= ((float)1.0 - QUANTILE) * delta
-                                       / (float)(inst->counter[s] + 1);
-      }
-
-      // update density estimate
-      if (fabs(lmagn[i] - inst->lquantile[offset + i]) < WIDTH) {
-        inst->density[offset + i] = ((float)inst->counter[s] * inst->density[offset
-            + i] + (float)1.0 / ((float)2.0 * WIDTH)) / (float)(inst->counter[s] + 1);
-      }
-    } // end loop over magnitude spectrum
+    WebRtcNs_UpdateQuantile(inst, lmagn, offset, inst->counter[s]);
 
     if (inst->counter[s] >= END_STARTUP_LONG) {
       inst->counter[s] = 0;
@@ -714,47 +968,28 @@ void WebRtcNs_SpeechNoiseProb(NSinst_t* inst, float* probSpeechFinal, float* snr
   }
 }
 
-int WebRtcNs_ProcessCore(NSinst_t* inst,
+int WebRtcNs_AnalyzeCore(NSinst_t* inst,
                          short* speechFrame,
-                         short* speechFrameHB,
-                         short* outFrame,
-                         short* outFrameHB) {
-  // main routine for noise reduction
+                         short* speechFrameHB) {
+  // analysis part of the noise reduction
 
   int     flagHB = 0;
   int     i;
   const int kStartBand = 5; // Skip first frequency bins during estimation.
-  int     updateParsFlag;
 
-  float   energy1, energy2, gain, factor, factor1, factor2;
+  float   energy1;
   float   signalEnergy, sumMagn;
-  float   snrPrior, currentEstimateStsa;
-  float   tmpFloat1, tmpFloat2, tmpFloat3, probSpeech, probNonSpeech;
-  float   gammaNoiseTmp, gammaNoiseOld;
-  float   noiseUpdateTmp, fTmp, dTmp;
-  float   fin[BLOCKL_MAX], fout[BLOCKL_MAX];
+  float   tmpFloat1, tmpFloat2;
+  float   fin[BLOCKL_MAX];
   float   winData[ANAL_BLOCKL_MAX];
-  float   magn[HALF_ANAL_BLOCKL], noise[HALF_ANAL_BLOCKL];
-  float   theFilter[HALF_ANAL_BLOCKL], theFilterTmp[HALF_ANAL_BLOCKL];
-  float   snrLocPost[HALF_ANAL_BLOCKL], snrLocPrior[HALF_ANAL_BLOCKL];
-  float   probSpeechFinal[HALF_ANAL_BLOCKL], previousEstimateStsa[HALF_ANAL_BLOCKL];
-  float   real[ANAL_BLOCKL_MAX], imag[HALF_ANAL_BLOCKL];
+  float*  magn = inst->magn;
+  float*  real = inst->real;
+  float*  imag = inst->imag;
   // Variables during startup
   float   sum_log_i = 0.0;
   float   sum_log_i_square = 0.0;
   float   sum_log_magn = 0.0;
   float   sum_log_i_log_magn = 0.0;
-  float   parametric_noise = 0.0;
-  float   parametric_exp = 0.0;
-  float   parametric_num = 0.0;
-
-  // SWB variables
-  int     deltaBweHB = 1;
-  int     deltaGainHB = 1;
-  float   decayBweHB = 1.0;
-  float   gainMapParHB = 1.0;
-  float   gainTimeDomainHB = 1.0;
-  float   avgProbSpeechHB, avgProbSpeechHBTmp, avgFilterGainHB, gainModHB;
 
   // Check that initiation has been done
   if (inst->initFlag != 1) {
@@ -766,13 +1001,7 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
       return -1;
     }
     flagHB = 1;
-    // range for averaging low band quantities for H band gain
-    deltaBweHB = (int)inst->magnLen / 4;
-    deltaGainHB = deltaBweHB;
   }
-  //
-  updateParsFlag = inst->modelUpdatePars[0];
-  //
 
   //for LB do all processing
   // convert to float
@@ -800,11 +1029,131 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
   // check if processing needed
   if (inst->outLen == 0) {
     // windowing
-    energy1 = 0.0;
-    for (i = 0; i < inst->anaLen; i++) {
-      winData[i] = inst->window[i] * inst->dataBuf[i];
-      energy1 += winData[i] * winData[i];
+    energy1 = WebRtcNs_AnalysisWindow(inst->window, inst->dataBuf,
+                                      inst->anaLen, winData);
+    inst->energyIn = energy1;
+    if (energy1 == 0.0) {
+      // synthesized by WebRtcNs_SuppressCore(), without updating statistics
+      return 0;
     }
+
+    //
+    inst->blockInd++; // Update the block index only when we process a block.
+    // FFT
+    rdft(inst->anaLen, 1, winData, inst->ip, inst->wfft);
+
+    imag[0] = 0;
+    real[0] = winData[0];
+    magn[0] = (float)(fabs(real[0]) + 1.0f);
+    imag[inst->magnLen - 1] = 0;
+    real[inst->magnLen - 1] = winData[1];
+    magn[inst->magnLen - 1] = (float)(fabs(real[inst->magnLen - 1]) + 1.0f);
+    signalEnergy = (float)(real[0] * real[0]) + 
+                   (float)(real[inst->magnLen - 1] * real[inst->magnLen - 1]);
+    sumMagn = magn[0] + magn[inst->magnLen - 1];
+    if (inst->blockInd < END_STARTUP_SHORT) {
+      inst->initMagnEst[0] += magn[0];
+      inst->initMagnEst[inst->magnLen - 1] += magn[inst->magnLen - 1];
+      tmpFloat2 = log((float)(inst->magnLen - 1));
+      sum_log_i = tmpFloat2;
+      sum_log_i_square = tmpFloat2 * tmpFloat2;
+      tmpFloat1 = log(magn[inst->magnLen - 1]);
+      sum_log_magn = tmpFloat1;
+      sum_log_i_log_magn = tmpFloat2 * tmpFloat1;
+    }
+    // magnitude spectrum
+    WebRtcNs_MagnitudeSpectrum(inst, winData, real, imag, magn, &signalEnergy,
+                               &sumMagn);
+    if (inst->blockInd < END_STARTUP_SHORT) {
+      for (i = 1; i < inst->magnLen - 1; i++) {
+        inst->initMagnEst[i] += magn[i];
+        if (i >= kStartBand) {
+          tmpFloat2 = log((float)i);
+          sum_log_i += tmpFloat2;
+          sum_log_i_square += tmpFloat2 * tmpFloat2;
+          tmpFloat1 = log(magn[i]);
+          sum_log_magn += tmpFloat1;
+          sum_log_i_log_magn += tmpFloat2 * tmpFloat1;
+        }
+      }
+    }
+    signalEnergy = signalEnergy / ((float)inst->magnLen);
+    inst->signalEnergy = signalEnergy;
+    inst->sumMagn = sumMagn;
+
+    //compute spectral flatness on input spectrum
+    WebRtcNs_ComputeSpectralFlatness(inst, magn);
+    inst->sumLogI = sum_log_i;
+    inst->sumLogISquare = sum_log_i_square;
+    inst->sumLogMagn = sum_log_magn;
+    inst->sumLogILogMagn = sum_log_i_log_magn;
+    return 1;
+  }
+
+  return 0;
+}
+
+int WebRtcNs_SuppressCore(NSinst_t* inst,
+                          short* outFrame,
+                          short* outFrameHB) {
+  // suppression part of the noise reduction
+
+  int     flagHB = 0;
+  int     i;
+  const int kStartBand = 5; // Skip first frequency bins during estimation.
+  int     updateParsFlag;
+
+  float   energy1, energy2, gain, factor, factor1, factor2;
+  float   signalEnergy, sumMagn;
+  float   tmpFloat1, tmpFloat2, tmpFloat3, probSpeech, probNonSpeech;
+  float   gammaNoiseTmp, gammaNoiseOld;
+  float   noiseUpdateTmp, dTmp;
+  float   fout[BLOCKL_MAX];
+  float   winData[ANAL_BLOCKL_MAX];
+  float*  magn = inst->magn;
+  float*  noise = inst->noise;
+  float*  real = inst->real;
+  float*  imag = inst->imag;
+  float   theFilter[HALF_ANAL_BLOCKL], theFilterTmp[HALF_ANAL_BLOCKL];
+  float   snrLocPost[HALF_ANAL_BLOCKL], snrLocPrior[HALF_ANAL_BLOCKL];
+  float   probSpeechFinal[HALF_ANAL_BLOCKL], previousEstimateStsa[HALF_ANAL_BLOCKL];
+  // Variables during startup
+  float   sum_log_i = inst->sumLogI;
+  float   sum_log_i_square = inst->sumLogISquare;
+  float   sum_log_magn = inst->sumLogMagn;
+  float   sum_log_i_log_magn = inst->sumLogILogMagn;
+  float   parametric_noise = 0.0;
+  float   parametric_exp = 0.0;
+  float   parametric_num = 0.0;
+
+  // SWB variables
+  int     deltaBweHB = 1;
+  int     deltaGainHB = 1;
+  float   decayBweHB = 1.0;
+  float   gainMapParHB = 1.0;
+  float   gainTimeDomainHB = 1.0;
+  float   avgProbSpeechHB, avgProbSpeechHBTmp, avgFilterGainHB, gainModHB;
+
+  // Check that initiation has been done
+  if (inst->initFlag != 1) {
+    return (-1);
+  }
+  // Check for valid pointers based on sampling rate
+  if (inst->fs == 32000) {
+    if (outFrameHB == NULL) {
+      return -1;
+    }
+    flagHB = 1;
+    // range for averaging low band quantities for H band gain
+    deltaBweHB = (int)inst->magnLen / 4;
+    deltaGainHB = deltaBweHB;
+  }
+  //
+  updateParsFlag = inst->modelUpdatePars[0];
+  //
+
+  if (inst->outLen == 0) {
+    energy1 = inst->energyIn;
     if (energy1 == 0.0) {
       // synthesize the special case of zero input
       // we want to avoid updating statistics in this case:
@@ -859,59 +1208,8 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
       return 0;
     }
 
-    //
-    inst->blockInd++; // Update the block index only when we process a block.
-    // FFT
-    rdft(inst->anaLen, 1, winData, inst->ip, inst->wfft);
-
-    imag[0] = 0;
-    real[0] = winData[0];
-    magn[0] = (float)(fabs(real[0]) + 1.0f);
-    imag[inst->magnLen - 1] = 0;
-    real[inst->magnLen - 1] = winData[1];
-    magn[inst->magnLen - 1] = (float)(fabs(real[inst->magnLen - 1]) + 1.0f);
-    signalEnergy = (float)(real[0] * real[0]) + 
-                   (float)(real[inst->magnLen - 1] * real[inst->magnLen - 1]);
-    sumMagn = magn[0] + magn[inst->magnLen - 1];
-    if (inst->blockInd < END_STARTUP_SHORT) {
-      inst->initMagnEst[0] += magn[0];
-      inst->initMagnEst[inst->magnLen - 1] += magn[inst->magnLen - 1];
-      tmpFloat2 = log((float)(inst->magnLen - 1));
-      sum_log_i = tmpFloat2;
-      sum_log_i_square = tmpFloat2 * tmpFloat2;
-      tmpFloat1 = log(magn[inst->magnLen - 1]);
-      sum_log_magn = tmpFloat1;
-      sum_log_i_log_magn = tmpFloat2 * tmpFloat1;
-    }
-    for (i = 1; i < inst->magnLen - 1; i++) {
-      real[i] = winData[2 * i];
-      imag[i] = winData[2 * i + 1];
-      // magnitude spectrum
-      fTmp = real[i] * real[i];
-      fTmp += imag[i] * imag[i];
-      signalEnergy += fTmp;
-      magn[i] = ((float)sqrt(fTmp)) + 1.0f;
-      sumMagn += magn[i];
-      if (inst->blockInd < END_STARTUP_SHORT) {
-        inst->initMagnEst[i] += magn[i];
-        if (i >= kStartBand) {
-          tmpFloat2 = log((float)i);
-          sum_log_i += tmpFloat2;
-          sum_log_i_square += tmpFloat2 * tmpFloat2;
-          tmpFloat1 = log(magn[i]);
-          sum_log_magn += tmpFloat1;
-          sum_log_i_log_magn += tmpFloat2 * tmpFloat1;
-        }
-      }
-    }
-    signalEnergy = signalEnergy / ((float)inst->magnLen);
-    inst->signalEnergy = signalEnergy;
-    inst->sumMagn = sumMagn;
-
-    //compute spectral flatness on input spectrum
-    WebRtcNs_ComputeSpectralFlatness(inst, magn);
-    // quantile noise estimate
-    WebRtcNs_NoiseEstimation(inst, magn, noise);
+    signalEnergy = inst->signalEnergy;
+    sumMagn = inst->sumMagn;
     //compute simplified noise model during startup
     if (inst->blockInd < END_STARTUP_SHORT) {
       // Estimate White noise
@@ -1090,21 +1388,7 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
     //
     // STEP 3: compute dd update of prior snr and post snr based on new noise estimate
     //
-    for (i = 0; i < inst->magnLen; i++) {
-      // post and prior snr
-      currentEstimateStsa = (float)0.0;
-      if (magn[i] > noise[i]) {
-        currentEstimateStsa = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
-      }
-      // DD estimate is sume of two terms: current estimate and previous estimate
-      // directed decision update of snrPrior
-      snrPrior = DD_PR_SNR * previousEstimateStsa[i] + ((float)1.0 - DD_PR_SNR)
-                 * currentEstimateStsa;
-      // gain filter
-      tmpFloat1 = inst->overdrive + snrPrior;
-      tmpFloat2 = (float)snrPrior / tmpFloat1;
-      theFilter[i] = (float)tmpFloat2;
-    } // end of loop over freqs
+    WebRtcNs_WienerFilter(inst, magn, noise, previousEstimateStsa, theFilter);
     // done with step3
 #endif
 #endif
@@ -1206,9 +1490,8 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
     } // out of inst->gainmap==1
 
     // synthesis
-    for (i = 0; i < inst->anaLen; i++) {
-      inst->syntBuf[i] += factor * inst->window[i] * (float)real[i];
-    }
+    WebRtcNs_SynthesisWindow(inst->window, real, factor, inst->anaLen,
+                             inst->syntBuf);
     // read out fully processed segment
     for (i = inst->windShift; i < inst->blockLen + inst->windShift; i++) {
       fout[i - inst->windShift] = inst->syntBuf[i];
@@ -1303,3 +1586,20 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
 
   return 0;
 }
+
+int WebRtcNs_ProcessCore(NSinst_t* inst,
+                         short* speechFrame,
+                         short* speechFrameHB,
+                         short* outFrame,
+                         short* outFrameHB) {
+  // main routine for noise reduction
+  const int analyzed = WebRtcNs_AnalyzeCore(inst, speechFrame, speechFrameHB);
+  if (analyzed < 0) {
+    return -1;
+  }
+  if (analyzed == 1) {
+    // quantile noise estimate
+    WebRtcNs_NoiseEstimation(inst, inst->magn, inst->noise);
+  }
+  return WebRtcNs_SuppressCore(inst, outFrame, outFrameHB);
+}
@@ -48,6 +48,22 @@ typedef struct NSParaExtract_t_ {
 
 } NSParaExtract_t;
 
+// Quantile noise estimates of several instances ("lanes"), laid out as
+// structure of arrays with the lane index innermost, so that one kernel call
+// updates the estimates of all lanes. An instance is attached to a lane by
+// WebRtcNs_Analyze() and keeps its estimates there until it is initialized.
+typedef struct NSQuantileBatch_t_ {
+
+  int             numLanes;   // a multiple of 4
+  int             magnLen;    // largest magnLen of the pending lanes
+  float*          density;    // [SIMULT][HALF_ANAL_BLOCKL][numLanes]
+  float*          lquantile;  // [SIMULT][HALF_ANAL_BLOCKL][numLanes]
+  float*          lmagn;      // [HALF_ANAL_BLOCKL][numLanes]
+  int*            counter;    // [SIMULT][numLanes]
+  int*            pending;    // [numLanes], 1 if |lmagn| awaits the update
+
+} NSQuantileBatch_t;
+
 typedef struct NSinst_t_ {
 
   WebRtc_UWord32  fs;
@@ -70,6 +86,9 @@ typedef struct NSinst_t_ {
   float           quantile[HALF_ANAL_BLOCKL];
   int             counter[SIMULT];
   int             updates;
+  // lane holding density, lquantile and counter instead, if attached
+  NSQuantileBatch_t* quantileBatch;
+  int             quantileLane;
   // parameters for Wiener filter
   float           smooth[HALF_ANAL_BLOCKL];
   float           overdrive;
@@ -104,6 +123,17 @@ typedef struct NSinst_t_ {
   //quantities for high band estimate
   float           speechProbHB[HALF_ANAL_BLOCKL];     //final speech/noise prob: prior + LRT
   float           dataBufHB[ANAL_BLOCKL_MAX];         //buffering data for HB
+  //frame in flight between WebRtcNs_AnalyzeCore() and WebRtcNs_SuppressCore()
+  float           energyIn;                           //energy of windowed input
+  float           magn[HALF_ANAL_BLOCKL];             //magnitude spectrum
+  float           noise[HALF_ANAL_BLOCKL];            //quantile noise estimate
+  float           real[ANAL_BLOCKL_MAX];              //real part of spectrum
+  float           imag[HALF_ANAL_BLOCKL];             //imag part of spectrum
+  float           sumLogI;                            //sums for the startup
+  float           sumLogISquare;                      // pink noise model
+  float           sumLogMagn;
+  float           sumLogILogMagn;
+  int             estimateQueued;                     //1 if queued in a batch
 
 } NSinst_t;
 
@@ -112,6 +142,55 @@ typedef struct NSinst_t_ {
 extern "C" {
 #endif
 
+// Speed-critical loops of WebRtcNs_ProcessCore(). They default to the C
+// versions in ns_core.c and are replaced by WebRtcNs_InitCore_SSE2() when the
+// CPU supports it, which also selects the SSE2 FFT passes of fft4g.
+
+// Windows |length| samples of |in| into |out| and returns their energy.
+typedef float (*WebRtcNs_AnalysisWindow_t)(const float* window,
+                                           const float* in,
+                                           int length,
+                                           float* out);
+extern WebRtcNs_AnalysisWindow_t WebRtcNs_AnalysisWindow;
+// Splits the rdft() output |fft| into |real|/|imag| and computes |magn| for
+// the bins [1, inst->magnLen - 1). The energy and magnitude sum of those bins
+// are added to |signalEnergy| and |sumMagn|.
+typedef void (*WebRtcNs_MagnitudeSpectrum_t)(NSinst_t* inst,
+                                             const float* fft,
+                                             float* real,
+                                             float* imag,
+                                             float* magn,
+                                             float* signalEnergy,
+                                             float* sumMagn);
+extern WebRtcNs_MagnitudeSpectrum_t WebRtcNs_MagnitudeSpectrum;
+// Updates the log quantile and density estimates of the simultaneous
+// estimate starting at |offset| with the log magnitude spectrum |lmagn|.
+typedef void (*WebRtcNs_UpdateQuantile_t)(NSinst_t* inst,
+                                          const float* lmagn,
+                                          int offset,
+                                          int counter);
+extern WebRtcNs_UpdateQuantile_t WebRtcNs_UpdateQuantile;
+// As WebRtcNs_UpdateQuantile(), for every simultaneous estimate of the
+// pending lanes of |batch|, with the log magnitude spectra in |batch->lmagn|.
+// Lanes that aren't pending are left untouched.
+typedef void (*WebRtcNs_UpdateQuantileBatch_t)(NSQuantileBatch_t* batch);
+extern WebRtcNs_UpdateQuantileBatch_t WebRtcNs_UpdateQuantileBatch;
+// Computes the Wiener gain |theFilter| from the directed decision estimate of
+// the prior SNR.
+typedef void (*WebRtcNs_WienerFilter_t)(NSinst_t* inst,
+                                        const float* magn,
+                                        const float* noise,
+                                        const float* previousEstimateStsa,
+                                        float* theFilter);
+extern WebRtcNs_WienerFilter_t WebRtcNs_WienerFilter;
+// Overlap-adds |factor| * |window| * |in| to |out|.
+typedef void (*WebRtcNs_SynthesisWindow_t)(const float* window,
+                                           const float* in,
+                                           float factor,
+                                           int length,
+                                           float* out);
+extern WebRtcNs_SynthesisWindow_t WebRtcNs_SynthesisWindow;
+
 /****************************************************************************
  * WebRtcNs_InitCore(...)
  *
@@ -128,6 +207,7 @@ extern "C" {
  *                        -1 - Error
  */
 int WebRtcNs_InitCore(NSinst_t* inst, WebRtc_UWord32 fs);
+void WebRtcNs_InitCore_SSE2(void);
 
 /****************************************************************************
  * WebRtcNs_set_policy_core(...)
@@ -172,6 +252,62 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
                          short* outFrameLow,
                          short* outFrameHigh);
 
+/****************************************************************************
+ * WebRtcNs_AnalyzeCore(...)
+ *
+ * First half of WebRtcNs_ProcessCore(): buffers the input and computes the
+ * spectrum of the frame, up to the quantile noise estimate.
+ *
+ * Input:
+ *      - inst          : Instance that should be initialized
+ *      - inFrameLow    : Input speech frame for lower band
+ *      - inFrameHigh   : Input speech frame for higher band
+ *
+ * Output:
+ *      - inst          : Updated instance
+ *
+ * Return value         :  1 - OK, the noise estimate of inst->magn is due
+ *                         0 - OK, no noise estimate needed for this frame
+ *                        -1 - Error
+ */
+int WebRtcNs_AnalyzeCore(NSinst_t* inst,
+                         short* inFrameLow,
+                         short* inFrameHigh);
+
+/****************************************************************************
+ * WebRtcNs_SuppressCore(...)
+ *
+ * Second half of WebRtcNs_ProcessCore(): suppresses the noise of the frame
+ * analyzed by WebRtcNs_AnalyzeCore(), using the noise estimate in
+ * inst->noise.
+ *
+ * Input:
+ *      - inst          : Instance that should be initialized
+ *
+ * Output:
+ *      - inst          : Updated instance
+ *      - outFrameLow   : Output speech frame for lower band
+ *      - outFrameHigh  : Output speech frame for higher band
+ *
+ * Return value         :  0 - OK
+ *                        -1 - Error
+ */
+int WebRtcNs_SuppressCore(NSinst_t* inst,
+                          short* outFrameLow,
+                          short* outFrameHigh);
+
+/****************************************************************************
+ * WebRtcNs_QueueNoiseEstimate(...)
+ *
+ * Attaches |inst| to lane |lane| of |batch| if it isn't already, and queues
+ * the noise estimate of inst->magn for WebRtcNs_UpdateQuantileBatch().
+ * WebRtcNs_FinishNoiseEstimate() then completes it into inst->noise.
+ */
+void WebRtcNs_QueueNoiseEstimate(NSinst_t* inst,
+                                 NSQuantileBatch_t* batch,
+                                 int lane);
+void WebRtcNs_FinishNoiseEstimate(NSinst_t* inst);
+
 
 #ifdef __cplusplus
 }
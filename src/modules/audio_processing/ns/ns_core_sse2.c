@@ -0,0 +1,325 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core noise suppression algorithm, SSE2 version of speed-critical
+ * functions.
+ */
+
+#include "typedefs.h"
+
+#if defined(WEBRTC_USE_SSE2)
+#include <emmintrin.h>
+#include <math.h>
+
+#include "fft4g.h"
+#include "ns_core.h"
+
+// Returns the sum of the four elements of |a|.
+__inline static float HorizontalSum(__m128 a) {
+  float result;
+  const __m128 b = _mm_add_ps(a, _mm_movehl_ps(a, a));
+  _mm_store_ss(&result, _mm_add_ss(b, _mm_shuffle_ps(b, b, 1)));
+  return result;
+}
+
+static float AnalysisWindowSSE2(const float* window,
+                                const float* in,
+                                int length,
+                                float* out) {
+  int i;
+  float energy;
+  __m128 energy_4 = _mm_setzero_ps();
+
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < length; i += 4) {
+    const __m128 window_4 = _mm_loadu_ps(&window[i]);
+    const __m128 in_4 = _mm_loadu_ps(&in[i]);
+    const __m128 out_4 = _mm_mul_ps(window_4, in_4);
+    _mm_storeu_ps(&out[i], out_4);
+    energy_4 = _mm_add_ps(energy_4, _mm_mul_ps(out_4, out_4));
+  }
+  energy = HorizontalSum(energy_4);
+
+  // scalar code for the remaining items.
+  for (; i < length; i++) {
+    out[i] = window[i] * in[i];
+    energy += out[i] * out[i];
+  }
+  return energy;
+}
+
+static void MagnitudeSpectrumSSE2(NSinst_t* inst,
+                                  const float* fft,
+                                  float* real,
+                                  float* imag,
+                                  float* magn,
+                                  float* signalEnergy,
+                                  float* sumMagn) {
+  int i;
+  const __m128 one = _mm_set1_ps(1.0f);
+  __m128 energy_4 = _mm_setzero_ps();
+  __m128 sum_4 = _mm_setzero_ps();
+  float fTmp;
+
+  // vectorized code (four at once)
+  for (i = 1; i + 3 < inst->magnLen - 1; i += 4) {
+    // Deinterleave the (real, imag) pairs of four bins.
+    const __m128 a = _mm_loadu_ps(&fft[2 * i]);
+    const __m128 b = _mm_loadu_ps(&fft[2 * i + 4]);
+    const __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 power = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+    const __m128 magn_4 = _mm_add_ps(_mm_sqrt_ps(power), one);
+    _mm_storeu_ps(&real[i], re);
+    _mm_storeu_ps(&imag[i], im);
+    _mm_storeu_ps(&magn[i], magn_4);
+    energy_4 = _mm_add_ps(energy_4, power);
+    sum_4 = _mm_add_ps(sum_4, magn_4);
+  }
+  *signalEnergy += HorizontalSum(energy_4);
+  *sumMagn += HorizontalSum(sum_4);
+
+  // scalar code for the remaining items.
+  for (; i < inst->magnLen - 1; i++) {
+    real[i] = fft[2 * i];
+    imag[i] = fft[2 * i + 1];
+    fTmp = real[i] * real[i];
+    fTmp += imag[i] * imag[i];
+    *signalEnergy += fTmp;
+    magn[i] = ((float)sqrt(fTmp)) + 1.0f;
+    *sumMagn += magn[i];
+  }
+}
+
+static void UpdateQuantileSSE2(NSinst_t* inst,
+                               const float* lmagn,
+                               int offset,
+                               int counter) {
+  int i;
+  float delta;
+  float* lquantile = &inst->lquantile[offset];
+  float* density = &inst->density[offset];
+  const float counterPlusOne = (float)(counter + 1);
+  const float densityUpdate = (float)1.0 / ((float)2.0 * WIDTH);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 factor = _mm_set1_ps(FACTOR);
+  const __m128 quantileUp = _mm_set1_ps(QUANTILE);
+  const __m128 quantileDown = _mm_set1_ps((float)1.0 - QUANTILE);
+  const __m128 counter_4 = _mm_set1_ps((float)counter);
+  const __m128 counterPlusOne_4 = _mm_set1_ps(counterPlusOne);
+  const __m128 densityUpdate_4 = _mm_set1_ps(densityUpdate);
+  const __m128 width = _mm_set1_ps(WIDTH);
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < inst->magnLen; i += 4) {
+    const __m128 lmagn_4 = _mm_loadu_ps(&lmagn[i]);
+    __m128 lquantile_4 = _mm_loadu_ps(&lquantile[i]);
+    const __m128 density_4 = _mm_loadu_ps(&density[i]);
+
+    // delta = density > 1 ? FACTOR / density : FACTOR
+    const __m128 bigDensity = _mm_cmpgt_ps(density_4, one);
+    const __m128 delta_4 = _mm_or_ps(
+        _mm_and_ps(bigDensity, _mm_div_ps(factor, density_4)),
+        _mm_andnot_ps(bigDensity, factor));
+
+    // Step the log quantile up or down.
+    const __m128 up = _mm_cmpgt_ps(lmagn_4, lquantile_4);
+    const __m128 stepUp = _mm_div_ps(_mm_mul_ps(quantileUp, delta_4),
+                                     counterPlusOne_4);
+    const __m128 stepDown = _mm_div_ps(_mm_mul_ps(quantileDown, delta_4),
+                                       counterPlusOne_4);
+    lquantile_4 = _mm_or_ps(
+        _mm_and_ps(up, _mm_add_ps(lquantile_4, stepUp)),
+        _mm_andnot_ps(up, _mm_sub_ps(lquantile_4, stepDown)));
+    _mm_storeu_ps(&lquantile[i], lquantile_4);
+
+    {
+      // Update the density where the new estimate is close to the input.
+      const __m128 distance = _mm_and_ps(_mm_sub_ps(lmagn_4, lquantile_4),
+                                         absMask);
+      const __m128 close = _mm_cmplt_ps(distance, width);
+      const __m128 newDensity = _mm_div_ps(
+          _mm_add_ps(_mm_mul_ps(counter_4, density_4), densityUpdate_4),
+          counterPlusOne_4);
+      _mm_storeu_ps(&density[i], _mm_or_ps(
+          _mm_and_ps(close, newDensity),
+          _mm_andnot_ps(close, density_4)));
+    }
+  }
+
+  // scalar code for the remaining items.
+  for (; i < inst->magnLen; i++) {
+    if (density[i] > 1.0) {
+      delta = FACTOR * (float)1.0 / density[i];
+    } else {
+      delta = FACTOR;
+    }
+    if (lmagn[i] > lquantile[i]) {
+      lquantile[i] += QUANTILE * delta / counterPlusOne;
+    } else {
+      lquantile[i] -= ((float)1.0 - QUANTILE) * delta / counterPlusOne;
+    }
+    if (fabs(lmagn[i] - lquantile[i]) < WIDTH) {
+      density[i] = ((float)counter * density[i] + densityUpdate) /
+          counterPlusOne;
+    }
+  }
+}
+
+// Vectorized over the lanes, four instances at once, so that lanes at
+// different stages of their estimates share one pass.
+static void UpdateQuantileBatchSSE2(NSQuantileBatch_t* batch) {
+  int s, i, lane;
+  const int numLanes = batch->numLanes;
+  const __m128i zeroInt = _mm_setzero_si128();
+  const __m128i oneInt = _mm_set1_epi32(1);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 factor = _mm_set1_ps(FACTOR);
+  const __m128 quantileUp = _mm_set1_ps(QUANTILE);
+  const __m128 quantileDown = _mm_set1_ps((float)1.0 - QUANTILE);
+  const __m128 densityUpdate_4 =
+      _mm_set1_ps((float)1.0 / ((float)2.0 * WIDTH));
+  const __m128 width = _mm_set1_ps(WIDTH);
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+  for (s = 0; s < SIMULT; s++) {
+    const int* counter = &batch->counter[s * numLanes];
+    float* lquantile = &batch->lquantile[s * HALF_ANAL_BLOCKL * numLanes];
+    float* density = &batch->density[s * HALF_ANAL_BLOCKL * numLanes];
+    for (lane = 0; lane < numLanes; lane += 4) {
+      const __m128 pending = _mm_castsi128_ps(_mm_cmpgt_epi32(
+          _mm_loadu_si128((const __m128i*)&batch->pending[lane]), zeroInt));
+      const __m128i counterInt =
+          _mm_loadu_si128((const __m128i*)&counter[lane]);
+      const __m128 counter_4 = _mm_cvtepi32_ps(counterInt);
+      const __m128 counterPlusOne_4 =
+          _mm_cvtepi32_ps(_mm_add_epi32(counterInt, oneInt));
+      if (_mm_movemask_ps(pending) == 0) {
+        continue;
+      }
+
+      for (i = 0; i < batch->magnLen; i++) {
+        const int k = i * numLanes + lane;
+        const __m128 lmagn_4 = _mm_loadu_ps(&batch->lmagn[k]);
+        const __m128 lquantile_4 = _mm_loadu_ps(&lquantile[k]);
+        const __m128 density_4 = _mm_loadu_ps(&density[k]);
+
+        // delta = density > 1 ? FACTOR / density : FACTOR
+        const __m128 bigDensity = _mm_cmpgt_ps(density_4, one);
+        const __m128 delta_4 = _mm_or_ps(
+            _mm_and_ps(bigDensity, _mm_div_ps(factor, density_4)),
+            _mm_andnot_ps(bigDensity, factor));
+
+        // Step the log quantile up or down.
+        const __m128 up = _mm_cmpgt_ps(lmagn_4, lquantile_4);
+        const __m128 stepUp = _mm_div_ps(_mm_mul_ps(quantileUp, delta_4),
+                                         counterPlusOne_4);
+        const __m128 stepDown = _mm_div_ps(_mm_mul_ps(quantileDown, delta_4),
+                                           counterPlusOne_4);
+        const __m128 newLquantile = _mm_or_ps(
+            _mm_and_ps(up, _mm_add_ps(lquantile_4, stepUp)),
+            _mm_andnot_ps(up, _mm_sub_ps(lquantile_4, stepDown)));
+
+        // Update the density where the new estimate is close to the input.
+        const __m128 distance = _mm_and_ps(_mm_sub_ps(lmagn_4, newLquantile),
+                                           absMask);
+        const __m128 close = _mm_and_ps(pending,
+                                        _mm_cmplt_ps(distance, width));
+        const __m128 newDensity = _mm_div_ps(
+            _mm_add_ps(_mm_mul_ps(counter_4, density_4), densityUpdate_4),
+            counterPlusOne_4);
+
+        // Lanes that aren't pending keep their estimates.
+        _mm_storeu_ps(&lquantile[k], _mm_or_ps(
+            _mm_and_ps(pending, newLquantile),
+            _mm_andnot_ps(pending, lquantile_4)));
+        _mm_storeu_ps(&density[k], _mm_or_ps(
+            _mm_and_ps(close, newDensity),
+            _mm_andnot_ps(close, density_4)));
+      }
+    }
+  }
+}
+
+static void WienerFilterSSE2(NSinst_t* inst,
+                             const float* magn,
+                             const float* noise,
+                             const float* previousEstimateStsa,
+                             float* theFilter) {
+  int i;
+  float currentEstimateStsa, snrPrior;
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 noiseFloor = _mm_set1_ps((float)0.0001);
+  const __m128 ddPrSnr = _mm_set1_ps(DD_PR_SNR);
+  const __m128 ddPrSnrInv = _mm_set1_ps((float)1.0 - DD_PR_SNR);
+  const __m128 overdrive = _mm_set1_ps(inst->overdrive);
+
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < inst->magnLen; i += 4) {
+    const __m128 magn_4 = _mm_loadu_ps(&magn[i]);
+    const __m128 noise_4 = _mm_loadu_ps(&noise[i]);
+    const __m128 prev_4 = _mm_loadu_ps(&previousEstimateStsa[i]);
+    const __m128 aboveNoise = _mm_cmpgt_ps(magn_4, noise_4);
+    const __m128 current_4 = _mm_and_ps(aboveNoise, _mm_sub_ps(
+        _mm_div_ps(magn_4, _mm_add_ps(noise_4, noiseFloor)), one));
+    const __m128 snrPrior_4 = _mm_add_ps(_mm_mul_ps(ddPrSnr, prev_4),
+                                         _mm_mul_ps(ddPrSnrInv, current_4));
+    _mm_storeu_ps(&theFilter[i], _mm_div_ps(
+        snrPrior_4, _mm_add_ps(overdrive, snrPrior_4)));
+  }
+
+  // scalar code for the remaining items.
+  for (; i < inst->magnLen; i++) {
+    currentEstimateStsa = (float)0.0;
+    if (magn[i] > noise[i]) {
+      currentEstimateStsa = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
+    }
+    snrPrior = DD_PR_SNR * previousEstimateStsa[i] + ((float)1.0 - DD_PR_SNR)
+               * currentEstimateStsa;
+    theFilter[i] = snrPrior / (inst->overdrive + snrPrior);
+  }
+}
+
+static void SynthesisWindowSSE2(const float* window,
+                                const float* in,
+                                float factor,
+                                int length,
+                                float* out) {
+  int i;
+  const __m128 factor_4 = _mm_set1_ps(factor);
+
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < length; i += 4) {
+    const __m128 window_4 = _mm_loadu_ps(&window[i]);
+    const __m128 in_4 = _mm_loadu_ps(&in[i]);
+    const __m128 out_4 = _mm_loadu_ps(&out[i]);
+    _mm_storeu_ps(&out[i], _mm_add_ps(out_4, _mm_mul_ps(
+        _mm_mul_ps(factor_4, window_4), in_4)));
+  }
+
+  // scalar code for the remaining items.
+  for (; i < length; i++) {
+    out[i] += factor * window[i] * in[i];
+  }
+}
+
+void WebRtcNs_InitCore_SSE2(void) {
+  WebRtcNs_AnalysisWindow = AnalysisWindowSSE2;
+  WebRtcNs_MagnitudeSpectrum = MagnitudeSpectrumSSE2;
+  WebRtcNs_UpdateQuantile = UpdateQuantileSSE2;
+  WebRtcNs_UpdateQuantileBatch = UpdateQuantileBatchSSE2;
+  WebRtcNs_WienerFilter = WienerFilterSSE2;
+  WebRtcNs_SynthesisWindow = SynthesisWindowSSE2;
+  fft4g_init_sse2();
+}
+
+#endif   // WEBRTC_USE_SSE2
@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how many capture streams AudioProcessingBatch processes per core
+// in real time, with the components a conference server would typically
+// enable, at 16 kHz and 32 kHz. For comparison, the same streams are also
+// processed one by one with ProcessStream().
+//
+// Usage: audioproc_batch_benchmark [num_streams [num_threads]]
+// By default 64 streams are processed by one thread per core.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "audio_processing.h"
+#include "audio_processing_batch.h"
+#include "cpu_info.h"
+#include "module_common_types.h"
+#include "scoped_ptr.h"
+#include "tick_util.h"
+
+using webrtc::AudioFrame;
+using webrtc::AudioProcessing;
+using webrtc::AudioProcessingBatch;
+
+namespace {
+
+const int kSeconds = 5;
+const double kPi = 3.14159265358979323846;
+
+int ConfigureStream(AudioProcessing* apm, int sample_rate_hz) {
+  if (apm->set_sample_rate_hz(sample_rate_hz) != apm->kNoError ||
+      apm->set_num_channels(1, 1) != apm->kNoError ||
+      apm->high_pass_filter()->Enable(true) != apm->kNoError ||
+      apm->noise_suppression()->set_level(
+          webrtc::NoiseSuppression::kModerate) != apm->kNoError ||
+      apm->noise_suppression()->Enable(true) != apm->kNoError ||
+      apm->gain_control()->set_mode(
+          webrtc::GainControl::kAdaptiveDigital) != apm->kNoError ||
+      apm->gain_control()->Enable(true) != apm->kNoError ||
+      apm->voice_detection()->Enable(true) != apm->kNoError) {
+    return -1;
+  }
+  return 0;
+}
+
+// Fills |frame| with a tone in noise, different for every stream.
+void GenerateFrame(int stream, int index, int sample_rate_hz,
+                   AudioFrame* frame) {
+  const int samples = sample_rate_hz / 100;
+  frame->_payloadDataLengthInSamples = samples;
+  frame->_audioChannel = 1;
+  frame->_frequencyInHz = sample_rate_hz;
+  const double frequency = 200.0 + 50.0 * stream;
+  for (int i = 0; i < samples; ++i) {
+    const int n = index * samples + i;
+    frame->_payloadData[i] = static_cast<WebRtc_Word16>(
+        3000 * sin(2 * kPi * frequency * n / sample_rate_hz) +
+        (rand() % 1000) - 500);
+  }
+}
+
+// Processes |kSeconds| of audio on |num_streams| streams with |num_threads|
+// threads and returns the number of streams that can be processed in real
+// time. Unless |batched|, each stream is processed with its own
+// ProcessStream() call on the calling thread.
+double RealTimeStreams(int sample_rate_hz, int num_streams, int num_threads,
+                       bool batched) {
+  webrtc::scoped_ptr<AudioProcessingBatch> batch(
+      AudioProcessingBatch::Create(0, num_streams, num_threads));
+  if (batch.get() == NULL) {
+    return 0.0;
+  }
+  for (int i = 0; i < num_streams; ++i) {
+    if (ConfigureStream(batch->stream(i), sample_rate_hz) != 0) {
+      return 0.0;
+    }
+  }
+
+  // Generate all input up front so that only the processing is timed.
+  const int num_frames = kSeconds * 100;
+  std::vector<AudioFrame> input(num_frames * num_streams);
+  for (int k = 0; k < num_frames; ++k) {
+    for (int i = 0; i < num_streams; ++i) {
+      GenerateFrame(i, k, sample_rate_hz, &input[k * num_streams + i]);
+    }
+  }
+  std::vector<AudioFrame*> frames(num_streams);
+
+  const webrtc::TickTime start = webrtc::TickTime::Now();
+  for (int k = 0; k < num_frames; ++k) {
+    for (int i = 0; i < num_streams; ++i) {
+      frames[i] = &input[k * num_streams + i];
+    }
+    if (!batched) {
+      for (int i = 0; i < num_streams; ++i) {
+        if (batch->stream(i)->ProcessStream(frames[i]) !=
+            AudioProcessing::kNoError) {
+          return 0.0;
+        }
+      }
+    } else if (batch->ProcessStreams(&frames[0], NULL) !=
+               AudioProcessing::kNoError) {
+      return 0.0;
+    }
+  }
+  const double elapsed_s = static_cast<double>(
+      (webrtc::TickTime::Now() - start).Microseconds()) / 1e6;
+  return num_streams * kSeconds / elapsed_s;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int num_cores = webrtc::CpuInfo::DetectNumberOfCores();
+  const int num_streams = argc > 1 ? atoi(argv[1]) : 64;
+  const int num_threads = argc > 2 ? atoi(argv[2]) : num_cores;
+  if (num_streams < 1 || num_threads < 1) {
+    printf("Usage: %s [num_streams [num_threads]]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%d streams, %d threads, %d cores\n", num_streams, num_threads,
+         num_cores);
+  // Threads beyond the number of cores don't add any processing power.
+  const int cores_used = num_threads < num_cores ? num_threads : num_cores;
+  printf("Streams per core processed in real time:\n");
+  printf("%-10s %12s %12s %12s\n", "rate (Hz)", "one by one", "1 thread",
+         num_threads > 1 ? "all threads" : "");
+  const int sample_rates[] = {16000, 32000};
+  for (size_t i = 0; i < sizeof(sample_rates) / sizeof(*sample_rates); ++i) {
+    printf("%-10d %12.1f %12.1f", sample_rates[i],
+           RealTimeStreams(sample_rates[i], num_streams, 1, false),
+           RealTimeStreams(sample_rates[i], num_streams, 1, true));
+    if (num_threads > 1) {
+      printf(" %12.1f", RealTimeStreams(sample_rates[i], num_streams,
+                                        num_threads, true) / cores_used);
+    }
+    printf("\n");
+  }
+  return 0;
+}
@@ -10,9 +10,13 @@
 
 #include <stdio.h>
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "audio_processing.h"
+#include "audio_processing_batch.h"
+#include "cpu_features_wrapper.h"
 #include "event_wrapper.h"
 #include "module_common_types.h"
 #include "scoped_ptr.h"
@@ -740,6 +744,159 @@ TEST_F(ApmTest, NoiseSuppression) {
   EXPECT_FALSE(apm_->noise_suppression()->is_enabled());
 }
 
+#if defined(WEBRTC_APM_UNIT_TEST_FLOAT_PROFILE)
+// Runs the near-end file through |apm| and appends the output to |output|.
+void ProcessNearEnd(AudioProcessing* apm,
+                    FILE* near_file,
+                    AudioFrame* frame,
+                    std::vector<int16_t>* output) {
+  const int samples_per_channel = frame->_payloadDataLengthInSamples;
+  const size_t frame_size = samples_per_channel * 2;
+  rewind(near_file);
+  while (fread(frame->_payloadData, sizeof(int16_t), frame_size, near_file) ==
+         frame_size) {
+    MixStereoToMono(frame->_payloadData, frame->_payloadData,
+                    samples_per_channel);
+    ASSERT_EQ(apm->kNoError, apm->ProcessStream(frame));
+    output->insert(output->end(), frame->_payloadData,
+                   frame->_payloadData + samples_per_channel);
+  }
+}
+
+TEST_F(ApmTest, NoiseSuppressionOptimizedMatchesC) {
+  // The SSE2 version sums the spectrum energy in a different order, which
+  // can move an output sample by one step after rounding.
+  const int kMaxSampleDiff = 1;
+  const int sample_rates[] = {8000, 16000, 32000};
+  WebRtc_CPUInfo cpu_info = WebRtc_GetCPUInfo;
+
+  EXPECT_EQ(apm_->kNoError, apm_->noise_suppression()->Enable(true));
+  EXPECT_EQ(apm_->kNoError,
+            apm_->noise_suppression()->set_level(NoiseSuppression::kHigh));
+  for (size_t i = 0; i < sizeof(sample_rates) / sizeof(*sample_rates); i++) {
+    ASSERT_EQ(apm_->kNoError, apm_->set_sample_rate_hz(sample_rates[i]));
+    ASSERT_EQ(apm_->kNoError, apm_->set_num_channels(1, 1));
+    frame_->_payloadDataLengthInSamples = sample_rates[i] / 100;
+    frame_->_audioChannel = 1;
+    frame_->_frequencyInHz = sample_rates[i];
+
+    std::vector<int16_t> reference;
+    WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+    ASSERT_EQ(apm_->kNoError, apm_->Initialize());
+    ProcessNearEnd(apm_, near_file_, frame_, &reference);
+
+    std::vector<int16_t> optimized;
+    WebRtc_GetCPUInfo = cpu_info;
+    ASSERT_EQ(apm_->kNoError, apm_->Initialize());
+    ProcessNearEnd(apm_, near_file_, frame_, &optimized);
+
+    ASSERT_EQ(reference.size(), optimized.size());
+    ASSERT_FALSE(reference.empty());
+    int max_diff = 0;
+    for (size_t j = 0; j < reference.size(); j++) {
+      max_diff = MaxValue(max_diff, AbsValue(reference[j] - optimized[j]));
+    }
+    EXPECT_LE(max_diff, kMaxSampleDiff) << "at " << sample_rates[i] << " Hz";
+  }
+}
+#endif
+
+TEST_F(ApmTest, BatchMatchesIndividualInstances) {
+  const int kNumStreams = 7;
+  const int kNumThreads = 3;
+  const int kNumFrames = 100;
+  // Stereo streams exercise the noise estimates of both channels in the
+  // batch, 32 kHz the high band.
+  const int kSampleRatesHz[] = {16000, 32000};
+  const int kNumChannels[] = {1, 2};
+
+  for (int c = 0; c < 2; c++) {
+    const int sample_rate_hz = kSampleRatesHz[c];
+    const int num_channels = kNumChannels[c];
+    const int samples_per_frame = sample_rate_hz / 100;
+    const int frame_size = samples_per_frame * num_channels;
+
+    webrtc::scoped_ptr<webrtc::AudioProcessingBatch> batch(
+        webrtc::AudioProcessingBatch::Create(0, kNumStreams, kNumThreads));
+    ASSERT_TRUE(batch.get() != NULL);
+    EXPECT_EQ(kNumStreams, batch->num_streams());
+    EXPECT_EQ(kNumThreads, batch->num_threads());
+    EXPECT_TRUE(batch->stream(kNumStreams) == NULL);
+
+    std::vector<AudioProcessing*> reference(kNumStreams);
+    for (int i = 0; i < kNumStreams; i++) {
+      reference[i] = AudioProcessing::Create(100 + i);
+      AudioProcessing* apms[] = {reference[i], batch->stream(i)};
+      for (int j = 0; j < 2; j++) {
+        ASSERT_EQ(apm_->kNoError, apms[j]->set_sample_rate_hz(sample_rate_hz));
+        ASSERT_EQ(apm_->kNoError,
+                  apms[j]->set_num_channels(num_channels, num_channels));
+        ASSERT_EQ(apm_->kNoError, apms[j]->high_pass_filter()->Enable(true));
+        ASSERT_EQ(apm_->kNoError,
+                  apms[j]->noise_suppression()->Enable(true));
+        ASSERT_EQ(apm_->kNoError, apms[j]->gain_control()->set_mode(
+            GainControl::kFixedDigital));
+        ASSERT_EQ(apm_->kNoError, apms[j]->gain_control()->Enable(true));
+        ASSERT_EQ(apm_->kNoError, apms[j]->voice_detection()->Enable(true));
+      }
+    }
+
+    std::vector<AudioFrame> batch_frames(kNumStreams);
+    std::vector<AudioFrame> reference_frames(kNumStreams);
+    std::vector<AudioFrame*> frame_pointers(kNumStreams);
+    std::vector<int> errors(kNumStreams);
+    for (int k = 0; k < kNumFrames; k++) {
+      for (int i = 0; i < kNumStreams; i++) {
+        AudioFrame& frame = batch_frames[i];
+        frame._payloadDataLengthInSamples = samples_per_frame;
+        frame._audioChannel = num_channels;
+        frame._frequencyInHz = sample_rate_hz;
+        // Every stream gets different audio.
+        if (fread(frame._payloadData, sizeof(int16_t), frame_size,
+                  near_file_) != static_cast<size_t>(frame_size)) {
+          rewind(near_file_);
+          memset(frame._payloadData, 0, sizeof(int16_t) * frame_size);
+        }
+        reference_frames[i] = frame;
+        ASSERT_EQ(apm_->kNoError,
+                  reference[i]->ProcessStream(&reference_frames[i]));
+        // Now and then a stream is skipped by the batch and processed on its
+        // own instead.
+        frame_pointers[i] = &frame;
+        if ((k + i) % 10 == 0) {
+          frame_pointers[i] = NULL;
+          ASSERT_EQ(apm_->kNoError, batch->stream(i)->ProcessStream(&frame));
+        }
+      }
+      ASSERT_EQ(apm_->kNoError,
+                batch->ProcessStreams(&frame_pointers[0], &errors[0]));
+      for (int i = 0; i < kNumStreams; i++) {
+        EXPECT_EQ(apm_->kNoError, errors[i]);
+        EXPECT_EQ(0, memcmp(reference_frames[i]._payloadData,
+                            batch_frames[i]._payloadData,
+                            sizeof(int16_t) * frame_size))
+            << "at " << sample_rate_hz << " Hz";
+        EXPECT_EQ(reference[i]->voice_detection()->stream_has_voice(),
+                  batch->stream(i)->voice_detection()->stream_has_voice());
+      }
+    }
+
+    // A bad frame only fails its own stream.
+    batch_frames[1]._frequencyInHz = 8000;
+    frame_pointers.assign(kNumStreams, NULL);
+    frame_pointers[1] = &batch_frames[1];
+    EXPECT_NE(apm_->kNoError,
+              batch->ProcessStreams(&frame_pointers[0], &errors[0]));
+    EXPECT_NE(apm_->kNoError, errors[1]);
+    EXPECT_EQ(apm_->kNoError, errors[0]);
+    EXPECT_EQ(apm_->kNullPointerError, batch->ProcessStreams(NULL, NULL));
+
+    for (int i = 0; i < kNumStreams; i++) {
+      AudioProcessing::Destroy(reference[i]);
+    }
+  }
+}
+
 TEST_F(ApmTest, HighPassFilter) {
   // Turing HP filter on/off
   EXPECT_EQ(apm_->kNoError, apm_->high_pass_filter()->Enable(true));
@@ -18,6 +18,7 @@ LOCAL_MODULE := libwebrtc_apm_utility
 LOCAL_MODULE_TAGS := optional
 LOCAL_SRC_FILES := \
     fft4g.c \
+    fft4g_sse2.c \
     ring_buffer.c \
     delay_estimator.c \
     delay_estimator_wrapper.c
@@ -8,6 +8,7 @@
  *
  * Changes:
  * Trivial type modifications by the WebRTC authors.
+ * Runtime selection of cftfsub()/cftbsub() by the WebRTC authors.
  */
 
 /*
@@ -286,6 +287,41 @@ Appendix :
     w[] and ip[] are compatible with all routines.
 */
 
+#include "fft4g.h"
+
+static void cftfsub_C(int n, float *a, float *w);
+static void cftbsub_C(int n, float *a, float *w);
+
+fft4g_cftsub_t fft4g_cftfsub = cftfsub_C;
+fft4g_cftsub_t fft4g_cftbsub = cftbsub_C;
+
+void fft4g_init(void)
+{
+    fft4g_cftfsub = cftfsub_C;
+    fft4g_cftbsub = cftbsub_C;
+}
+
+
+static void cftfsub(int n, float *a, float *w)
+{
+    if (n >= 16) {
+        fft4g_cftfsub(n, a, w);
+    } else {
+        cftfsub_C(n, a, w);
+    }
+}
+
+
+static void cftbsub(int n, float *a, float *w)
+{
+    if (n >= 16) {
+        fft4g_cftbsub(n, a, w);
+    } else {
+        cftbsub_C(n, a, w);
+    }
+}
+
+
 void cdft(int n, int isgn, float *a, int *ip, float *w)
 {
     void makewt(int nw, int *ip, float *w);
@@ -925,7 +961,7 @@ void bitrv2conj(int n, int *ip, float *a)
 }
 
 
-void cftfsub(int n, float *a, float *w)
+static void cftfsub_C(int n, float *a, float *w)
 {
     void cft1st(int n, float *a, float *w);
     void cftmdl(int n, int l, float *a, float *w);
@@ -977,7 +1013,7 @@ void cftfsub(int n, float *a, float *w)
 }
 
 
-void cftbsub(int n, float *a, float *w)
+static void cftbsub_C(int n, float *a, float *w)
 {
     void cft1st(int n, float *a, float *w);
     void cftmdl(int n, int l, float *a, float *w);
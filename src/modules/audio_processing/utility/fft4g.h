@@ -14,5 +14,16 @@
 void rdft(int, int, float *, int *, float *);
 void cdft(int, int, float *, int *, float *);
 
+// The complex FFT passes used by the transforms above for 16 or more values;
+// shorter ones always use C. fft4g_init() selects the C versions, which are
+// also the default, and fft4g_init_sse2() the SSE2 versions in fft4g_sse2.c.
+// Both give bit-exact results.
+typedef void (*fft4g_cftsub_t)(int n, float *a, float *w);
+extern fft4g_cftsub_t fft4g_cftfsub;
+extern fft4g_cftsub_t fft4g_cftbsub;
+
+void fft4g_init(void);
+void fft4g_init_sse2(void);
+
 #endif
 
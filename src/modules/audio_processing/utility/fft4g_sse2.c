@@ -0,0 +1,303 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * SSE2 versions of the complex FFT passes in fft4g.c. Each vector holds two
+ * complex values (re, im, re, im). The butterflies evaluate the same
+ * expressions as the C code, so the results are bit-exact.
+ */
+
+#include "typedefs.h"
+
+#if defined(WEBRTC_USE_SSE2)
+#include <emmintrin.h>
+
+#include "fft4g.h"
+
+/* Swaps the real and imaginary parts: (re, im) -> (im, re). */
+static __inline __m128 SwapComplex(__m128 x)
+{
+    return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+/* Multiplies (re, im) by (wr, wi), given (wr, wr, ...) and (-wi, wi, ...). */
+static __inline __m128 ComplexMul(__m128 x, __m128 wr, __m128 wi_signed)
+{
+    return _mm_add_ps(_mm_mul_ps(wr, x),
+                      _mm_mul_ps(wi_signed, SwapComplex(x)));
+}
+
+/*
+ * The radix-4 butterfly on the complex values at |a0|, |a1|, |a2| and |a3|,
+ * two at a time. |minus_plus| is (-1, 1, -1, 1). Returns x1 + i * x3 in
+ * |x13p| and x1 - i * x3 in |x13m|; |x02m| is x0 - x2 and the sum x0 + x2
+ * is stored to |a0|.
+ */
+static __inline void Butterfly(float *a0, float *a1, float *a2, float *a3,
+                               __m128 minus_plus,
+                               __m128 *x02m, __m128 *x13p, __m128 *x13m)
+{
+    const __m128 a0v = _mm_loadu_ps(a0);
+    const __m128 a1v = _mm_loadu_ps(a1);
+    const __m128 a2v = _mm_loadu_ps(a2);
+    const __m128 a3v = _mm_loadu_ps(a3);
+    const __m128 x0 = _mm_add_ps(a0v, a1v);
+    const __m128 x1 = _mm_sub_ps(a0v, a1v);
+    const __m128 x2 = _mm_add_ps(a2v, a3v);
+    const __m128 x3 = _mm_sub_ps(a2v, a3v);
+    const __m128 x3_rotated = _mm_mul_ps(SwapComplex(x3), minus_plus);
+    _mm_storeu_ps(a0, _mm_add_ps(x0, x2));
+    *x02m = _mm_sub_ps(x0, x2);
+    *x13p = _mm_add_ps(x1, x3_rotated);
+    *x13m = _mm_sub_ps(x1, x3_rotated);
+}
+
+static void cft1st_SSE2(int n, float *a, float *w)
+{
+    const __m128 minus_plus = _mm_setr_ps(-1.f, 1.f, -1.f, 1.f);
+    int j, k1, k2;
+    float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+    float wk1r_b, wk1i_b, wk3r_b, wk3i_b;
+    float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+
+    /* The first 16 values use twiddle factors of 1 and exp(i * pi / 4),
+     * which the C code applies with fewer operations. */
+    x0r = a[0] + a[2];
+    x0i = a[1] + a[3];
+    x1r = a[0] - a[2];
+    x1i = a[1] - a[3];
+    x2r = a[4] + a[6];
+    x2i = a[5] + a[7];
+    x3r = a[4] - a[6];
+    x3i = a[5] - a[7];
+    a[0] = x0r + x2r;
+    a[1] = x0i + x2i;
+    a[4] = x0r - x2r;
+    a[5] = x0i - x2i;
+    a[2] = x1r - x3i;
+    a[3] = x1i + x3r;
+    a[6] = x1r + x3i;
+    a[7] = x1i - x3r;
+    wk1r = w[2];
+    x0r = a[8] + a[10];
+    x0i = a[9] + a[11];
+    x1r = a[8] - a[10];
+    x1i = a[9] - a[11];
+    x2r = a[12] + a[14];
+    x2i = a[13] + a[15];
+    x3r = a[12] - a[14];
+    x3i = a[13] - a[15];
+    a[8] = x0r + x2r;
+    a[9] = x0i + x2i;
+    a[12] = x2i - x0i;
+    a[13] = x0r - x2r;
+    x0r = x1r - x3i;
+    x0i = x1i + x3r;
+    a[10] = wk1r * (x0r - x0i);
+    a[11] = wk1r * (x0r + x0i);
+    x0r = x3i + x1r;
+    x0i = x3r - x1i;
+    a[14] = wk1r * (x0i - x0r);
+    a[15] = wk1r * (x0i + x0r);
+
+    /* The remaining blocks of 16 hold two groups of four complex values with
+     * their own twiddle factors. The low half of each vector works on the
+     * first group and the high half on the second. */
+    k1 = 0;
+    for (j = 16; j < n; j += 16) {
+        __m128 a00v, a04v, a08v, a12v, c0, c1, c2, c3;
+        __m128 x0, x1, x2, x3, x3_rotated, y0, y1, y2, y3;
+        k1 += 2;
+        k2 = 2 * k1;
+        wk2r = w[k1];
+        wk2i = w[k1 + 1];
+        wk1r = w[k2];
+        wk1i = w[k2 + 1];
+        wk3r = wk1r - 2 * wk2i * wk1i;
+        wk3i = 2 * wk2i * wk1r - wk1i;
+        wk1r_b = w[k2 + 2];
+        wk1i_b = w[k2 + 3];
+        wk3r_b = wk1r_b - 2 * wk2r * wk1i_b;
+        wk3i_b = 2 * wk2r * wk1r_b - wk1i_b;
+
+        a00v = _mm_loadu_ps(&a[j]);
+        a04v = _mm_loadu_ps(&a[j + 4]);
+        a08v = _mm_loadu_ps(&a[j + 8]);
+        a12v = _mm_loadu_ps(&a[j + 12]);
+        c0 = _mm_shuffle_ps(a00v, a08v, _MM_SHUFFLE(1, 0, 1, 0));
+        c1 = _mm_shuffle_ps(a00v, a08v, _MM_SHUFFLE(3, 2, 3, 2));
+        c2 = _mm_shuffle_ps(a04v, a12v, _MM_SHUFFLE(1, 0, 1, 0));
+        c3 = _mm_shuffle_ps(a04v, a12v, _MM_SHUFFLE(3, 2, 3, 2));
+        x0 = _mm_add_ps(c0, c1);
+        x1 = _mm_sub_ps(c0, c1);
+        x2 = _mm_add_ps(c2, c3);
+        x3 = _mm_sub_ps(c2, c3);
+        x3_rotated = _mm_mul_ps(SwapComplex(x3), minus_plus);
+        y0 = _mm_add_ps(x0, x2);
+        /* The second group is rotated by i * wk2. */
+        y2 = ComplexMul(_mm_sub_ps(x0, x2),
+                        _mm_setr_ps(wk2r, wk2r, -wk2i, -wk2i),
+                        _mm_setr_ps(-wk2i, wk2i, -wk2r, wk2r));
+        y1 = ComplexMul(_mm_add_ps(x1, x3_rotated),
+                        _mm_setr_ps(wk1r, wk1r, wk1r_b, wk1r_b),
+                        _mm_setr_ps(-wk1i, wk1i, -wk1i_b, wk1i_b));
+        y3 = ComplexMul(_mm_sub_ps(x1, x3_rotated),
+                        _mm_setr_ps(wk3r, wk3r, wk3r_b, wk3r_b),
+                        _mm_setr_ps(-wk3i, wk3i, -wk3i_b, wk3i_b));
+        _mm_storeu_ps(&a[j], _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(1, 0, 1, 0)));
+        _mm_storeu_ps(&a[j + 4],
+                      _mm_shuffle_ps(y2, y3, _MM_SHUFFLE(1, 0, 1, 0)));
+        _mm_storeu_ps(&a[j + 8],
+                      _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(3, 2, 3, 2)));
+        _mm_storeu_ps(&a[j + 12],
+                      _mm_shuffle_ps(y2, y3, _MM_SHUFFLE(3, 2, 3, 2)));
+    }
+}
+
+static void cftmdl_SSE2(int n, int l, float *a, float *w)
+{
+    const __m128 minus_plus = _mm_setr_ps(-1.f, 1.f, -1.f, 1.f);
+    const __m128 plus_minus = _mm_setr_ps(1.f, -1.f, 1.f, -1.f);
+    int j, k, k1, k2, m, m2;
+    float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+    __m128 x02m, x13p, x13m, wk1rv, wk1iv, wk2rv, wk2iv, wk3rv, wk3iv;
+
+    /* l is at least 8, so each run of l values holds whole vectors. */
+    m = l << 2;
+    for (j = 0; j < l; j += 4) {
+        Butterfly(&a[j], &a[j + l], &a[j + 2 * l], &a[j + 3 * l], minus_plus,
+                  &x02m, &x13p, &x13m);
+        _mm_storeu_ps(&a[j + 2 * l], x02m);
+        _mm_storeu_ps(&a[j + l], x13p);
+        _mm_storeu_ps(&a[j + 3 * l], x13m);
+    }
+    wk1rv = _mm_set1_ps(w[2]);
+    for (j = m; j < l + m; j += 4) {
+        Butterfly(&a[j], &a[j + l], &a[j + 2 * l], &a[j + 3 * l], minus_plus,
+                  &x02m, &x13p, &x13m);
+        _mm_storeu_ps(&a[j + 2 * l],
+                      _mm_mul_ps(SwapComplex(x02m), minus_plus));
+        /* wk1r * (re - im, im + re) */
+        _mm_storeu_ps(&a[j + l], _mm_mul_ps(wk1rv, _mm_add_ps(
+            x13p, _mm_mul_ps(SwapComplex(x13p), minus_plus))));
+        /* (-wk1r) * (im + re, im - re) */
+        x13m = _mm_add_ps(
+            _mm_shuffle_ps(x13m, x13m, _MM_SHUFFLE(3, 3, 1, 1)),
+            _mm_mul_ps(_mm_shuffle_ps(x13m, x13m, _MM_SHUFFLE(2, 2, 0, 0)),
+                       plus_minus));
+        _mm_storeu_ps(&a[j + 3 * l],
+                      _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), wk1rv), x13m));
+    }
+    k1 = 0;
+    m2 = 2 * m;
+    for (k = m2; k < n; k += m2) {
+        k1 += 2;
+        k2 = 2 * k1;
+        wk2r = w[k1];
+        wk2i = w[k1 + 1];
+        wk1r = w[k2];
+        wk1i = w[k2 + 1];
+        wk3r = wk1r - 2 * wk2i * wk1i;
+        wk3i = 2 * wk2i * wk1r - wk1i;
+        wk1rv = _mm_set1_ps(wk1r);
+        wk1iv = _mm_setr_ps(-wk1i, wk1i, -wk1i, wk1i);
+        wk2rv = _mm_set1_ps(wk2r);
+        wk2iv = _mm_setr_ps(-wk2i, wk2i, -wk2i, wk2i);
+        wk3rv = _mm_set1_ps(wk3r);
+        wk3iv = _mm_setr_ps(-wk3i, wk3i, -wk3i, wk3i);
+        for (j = k; j < l + k; j += 4) {
+            Butterfly(&a[j], &a[j + l], &a[j + 2 * l], &a[j + 3 * l],
+                      minus_plus, &x02m, &x13p, &x13m);
+            _mm_storeu_ps(&a[j + 2 * l], ComplexMul(x02m, wk2rv, wk2iv));
+            _mm_storeu_ps(&a[j + l], ComplexMul(x13p, wk1rv, wk1iv));
+            _mm_storeu_ps(&a[j + 3 * l], ComplexMul(x13m, wk3rv, wk3iv));
+        }
+        wk1r = w[k2 + 2];
+        wk1i = w[k2 + 3];
+        wk3r = wk1r - 2 * wk2r * wk1i;
+        wk3i = 2 * wk2r * wk1r - wk1i;
+        wk1rv = _mm_set1_ps(wk1r);
+        wk1iv = _mm_setr_ps(-wk1i, wk1i, -wk1i, wk1i);
+        /* Rotated by i * wk2. */
+        wk2rv = _mm_set1_ps(-wk2i);
+        wk2iv = _mm_setr_ps(-wk2r, wk2r, -wk2r, wk2r);
+        wk3rv = _mm_set1_ps(wk3r);
+        wk3iv = _mm_setr_ps(-wk3i, wk3i, -wk3i, wk3i);
+        for (j = k + m; j < l + (k + m); j += 4) {
+            Butterfly(&a[j], &a[j + l], &a[j + 2 * l], &a[j + 3 * l],
+                      minus_plus, &x02m, &x13p, &x13m);
+            _mm_storeu_ps(&a[j + 2 * l], ComplexMul(x02m, wk2rv, wk2iv));
+            _mm_storeu_ps(&a[j + l], ComplexMul(x13p, wk1rv, wk1iv));
+            _mm_storeu_ps(&a[j + 3 * l], ComplexMul(x13m, wk3rv, wk3iv));
+        }
+    }
+}
+
+/*
+ * The radix-4 or radix-2 pass of cftfsub()/cftbsub(). The inverse transform
+ * gives the conjugate of the forward pass, which |conjugate| applies by
+ * multiplying with (1, -1, 1, -1); pass (1, 1, 1, 1) for the forward pass.
+ */
+static void LastPass(int n, int l, float *a, __m128 conjugate)
+{
+    const __m128 minus_plus = _mm_setr_ps(-1.f, 1.f, -1.f, 1.f);
+    __m128 x02m, x13p, x13m;
+    int j;
+
+    if ((l << 2) == n) {
+        for (j = 0; j < l; j += 4) {
+            Butterfly(&a[j], &a[j + l], &a[j + 2 * l], &a[j + 3 * l],
+                      minus_plus, &x02m, &x13p, &x13m);
+            _mm_storeu_ps(&a[j], _mm_mul_ps(_mm_loadu_ps(&a[j]), conjugate));
+            _mm_storeu_ps(&a[j + 2 * l], _mm_mul_ps(x02m, conjugate));
+            _mm_storeu_ps(&a[j + l], _mm_mul_ps(x13p, conjugate));
+            _mm_storeu_ps(&a[j + 3 * l], _mm_mul_ps(x13m, conjugate));
+        }
+    } else {
+        for (j = 0; j < l; j += 4) {
+            const __m128 a0v = _mm_loadu_ps(&a[j]);
+            const __m128 a1v = _mm_loadu_ps(&a[j + l]);
+            _mm_storeu_ps(&a[j], _mm_mul_ps(_mm_add_ps(a0v, a1v), conjugate));
+            _mm_storeu_ps(&a[j + l],
+                          _mm_mul_ps(_mm_sub_ps(a0v, a1v), conjugate));
+        }
+    }
+}
+
+static void cftsub_SSE2(int n, float *a, float *w, __m128 conjugate)
+{
+    int l;
+
+    cft1st_SSE2(n, a, w);
+    l = 8;
+    while ((l << 2) < n) {
+        cftmdl_SSE2(n, l, a, w);
+        l <<= 2;
+    }
+    LastPass(n, l, a, conjugate);
+}
+
+static void cftfsub_SSE2(int n, float *a, float *w)
+{
+    cftsub_SSE2(n, a, w, _mm_set1_ps(1.f));
+}
+
+static void cftbsub_SSE2(int n, float *a, float *w)
+{
+    cftsub_SSE2(n, a, w, _mm_setr_ps(1.f, -1.f, 1.f, -1.f));
+}
+
+void fft4g_init_sse2(void)
+{
+    fft4g_cftfsub = cftfsub_SSE2;
+    fft4g_cftbsub = cftbsub_SSE2;
+}
+
+#endif  // WEBRTC_USE_SSE2
@@ -7,6 +7,10 @@
 #include "typedefs.h"
 #include "common_types.h"
 
+#if defined(WEBRTC_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
 #ifdef _WIN32
     #pragma warning(disable:4351)       // remove warning "new behavior: elements of array
                                         // 'array' will be default initialized"
@@ -878,7 +882,18 @@ AudioFrame::operator>>=(const WebRtc_Word32 rhs)
     {
         return *this;
     }
-    for(WebRtc_UWord16 i = 0; i < _payloadDataLengthInSamples * _audioChannel; i++)
+    const int length = _payloadDataLengthInSamples * _audioChannel;
+    int i = 0;
+#if defined(WEBRTC_USE_SSE2)
+    const __m128i shift = _mm_cvtsi32_si128(rhs);
+    for(; i + 8 <= length; i += 8)
+    {
+        __m128i* samples = reinterpret_cast<__m128i*>(&_payloadData[i]);
+        _mm_storeu_si128(samples,
+                         _mm_sra_epi16(_mm_loadu_si128(samples), shift));
+    }
+#endif
+    for(; i < length; i++)
     {
         _payloadData[i] = WebRtc_Word16(_payloadData[i] >> rhs);
     }
@@ -978,8 +993,19 @@ AudioFrame::operator+=(const AudioFrame& rhs)
           sizeof(WebRtc_Word16) * rhs._payloadDataLengthInSamples * _audioChannel);
     } else
     {
-      // IMPROVEMENT this can be done very fast in assembly
-      for(WebRtc_UWord16 i = 0; i < _payloadDataLengthInSamples * _audioChannel; i++)
+      const int length = _payloadDataLengthInSamples * _audioChannel;
+      int i = 0;
+#if defined(WEBRTC_USE_SSE2)
+      for(; i + 8 <= length; i += 8)
+      {
+          __m128i* samples = reinterpret_cast<__m128i*>(&_payloadData[i]);
+          const __m128i* rhsSamples =
+              reinterpret_cast<const __m128i*>(&rhs._payloadData[i]);
+          _mm_storeu_si128(samples, _mm_adds_epi16(
+              _mm_loadu_si128(samples), _mm_loadu_si128(rhsSamples)));
+      }
+#endif
+      for(; i < length; i++)
       {
           WebRtc_Word32 wrapGuard = (WebRtc_Word32)_payloadData[i] +
                   (WebRtc_Word32)rhs._payloadData[i];
@@ -1023,7 +1049,19 @@ AudioFrame::operator-=(const AudioFrame& rhs)
     }
     _speechType = kUndefined;
 
-    for(WebRtc_UWord16 i = 0; i < _payloadDataLengthInSamples * _audioChannel; i++)
+    const int length = _payloadDataLengthInSamples * _audioChannel;
+    int i = 0;
+#if defined(WEBRTC_USE_SSE2)
+    for(; i + 8 <= length; i += 8)
+    {
+        __m128i* samples = reinterpret_cast<__m128i*>(&_payloadData[i]);
+        const __m128i* rhsSamples =
+            reinterpret_cast<const __m128i*>(&rhs._payloadData[i]);
+        _mm_storeu_si128(samples, _mm_subs_epi16(
+            _mm_loadu_si128(samples), _mm_loadu_si128(rhsSamples)));
+    }
+#endif
+    for(; i < length; i++)
     {
         WebRtc_Word32 wrapGuard = (WebRtc_Word32)_payloadData[i] -
                 (WebRtc_Word32)rhs._payloadData[i];
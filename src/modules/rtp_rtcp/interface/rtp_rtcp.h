@@ -816,9 +816,14 @@ public:
     /*
     *   Store the sent packets, needed to answer to a Negative acknowledgement requests
     *
+    *   numberToStore   - max number of packets to store
+    *   maxBytesToStore - if not 0, max number of bytes the stored packets may use
+    *
     *   return -1 on failure else 0
     */
-    virtual WebRtc_Word32 SetStorePacketsStatus(const bool enable, const WebRtc_UWord16 numberToStore = 200) = 0;
+    virtual WebRtc_Word32 SetStorePacketsStatus(const bool enable,
+                                                const WebRtc_UWord16 numberToStore = 200,
+                                                const WebRtc_UWord32 maxBytesToStore = 0) = 0;
 
     /**************************************************************************
     *
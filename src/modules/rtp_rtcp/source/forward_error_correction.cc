@@ -11,6 +11,7 @@
 #include "forward_error_correction.h"
 #include "rtp_utility.h"
 
+#include "cpu_features_wrapper.h"
 #include "trace.h"
 #include <cassert>
 #include <cstring>
@@ -35,41 +36,84 @@ const WebRtc_UWord8 kUlpHeaderSizeLBitClear = (2 + kMaskSizeLBitClear);
 const WebRtc_UWord8 kTransportOverhead = 28;
 
 //
-// Used for internal storage of FEC packets in a list.
+// Used to link media packets to their protecting FEC packets.
 //
-struct FecPacket
+struct ProtectedPacket
 {
-    ListWrapper protectedPktList;        /**> List containing #ProtectedPacket types.*/
     WebRtc_UWord16 seqNum;               /**> Sequence number. */
-    WebRtc_UWord32 ssrc;                 /**> SSRC of the current frame. */
     ForwardErrorCorrection::Packet* pkt; /**> Pointer to the packet storage. */
 };
 
 //
-// Used to link media packets to their protecting FEC packets.
+// Used for internal storage of FEC packets in a list.
 //
-struct ProtectedPacket
+struct FecPacket
 {
+    /**> The media packets protected by this packet, one per packet mask bit set. */
+    ProtectedPacket protectedPkts[ForwardErrorCorrection::kMaxMediaPackets];
+    WebRtc_UWord16 numProtectedPkts;     /**> Number of protectedPkts in use. */
     WebRtc_UWord16 seqNum;               /**> Sequence number. */
+    WebRtc_UWord32 ssrc;                 /**> SSRC of the current frame. */
     ForwardErrorCorrection::Packet* pkt; /**> Pointer to the packet storage. */
+    FecPacket* nextFree;                 /**> Next packet in the free list. */
 };
 
 ForwardErrorCorrection::ForwardErrorCorrection(WebRtc_Word32 id) :
     _id(id),
-    _generatedFecPackets(NULL),
+    _generatedFecPackets(new Packet[kMaxMediaPackets]),
+    _packetMask(new WebRtc_UWord8[kMaxMediaPackets * kMaskSizeLBitSet]),
+    _xorPayload(internal::XorPayload_C),
     _fecPacketList(),
+    _freeFecPackets(NULL),
     _seqNumBase(0),
     _lastMediaPacketReceived(false),
     _fecPacketReceived(false)
 {
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+#if defined(WEBRTC_USE_SSE2)
+        _xorPayload = internal::XorPayload_SSE2;
+#endif
+    }
 }
 
 ForwardErrorCorrection::~ForwardErrorCorrection()
 {
-    if (_generatedFecPackets != NULL)
+    delete [] _generatedFecPackets;
+    delete [] _packetMask;
+    while (_freeFecPackets != NULL)
+    {
+        FecPacket* fecPacket = _freeFecPackets;
+        _freeFecPackets = fecPacket->nextFree;
+        delete fecPacket;
+    }
+}
+
+FecPacket*
+ForwardErrorCorrection::NewFecPacket()
+{
+    FecPacket* fecPacket = _freeFecPackets;
+    if (fecPacket != NULL)
     {
-        delete [] _generatedFecPackets;
+        _freeFecPackets = fecPacket->nextFree;
     }
+    else
+    {
+        fecPacket = new FecPacket;
+    }
+    fecPacket->numProtectedPkts = 0;
+    fecPacket->pkt = NULL;
+    fecPacket->nextFree = NULL;
+    return fecPacket;
+}
+
+void
+ForwardErrorCorrection::ReleaseFecPacket(FecPacket* fecPacket)
+{
+    delete fecPacket->pkt;
+    fecPacket->pkt = NULL;
+    fecPacket->nextFree = _freeFecPackets;
+    _freeFecPackets = fecPacket;
 }
 
 // Input packet
@@ -182,23 +226,16 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
     assert(numFecPackets <= numMediaPackets);
 
     // -- Initialize FEC list --
-    if (_generatedFecPackets != NULL)
-    {
-        delete [] _generatedFecPackets;
-        _generatedFecPackets = NULL;
-    }
-
-    _generatedFecPackets = new Packet[numFecPackets];
+    // The packets are only cleared as far as they are used, see below.
     for (WebRtc_UWord32 i = 0; i < numFecPackets; i++)
     {
-        memset(_generatedFecPackets[i].data, 0, IP_PACKET_SIZE);
         _generatedFecPackets[i].length = 0; // Use this as a marker for untouched
                                             // packets.
         fecPacketList.PushBack(&_generatedFecPackets[i]);
     }
 
     // -- Generate packet masks --
-    WebRtc_UWord8* packetMask = new WebRtc_UWord8[numFecPackets * numMaskBytes];
+    WebRtc_UWord8* packetMask = _packetMask;
     memset(packetMask, 0, numFecPackets * numMaskBytes);
     internal::GeneratePacketMasks(numMediaPackets, numFecPackets,
         numImportantPackets, useUnequalProtection, packetMask);
@@ -254,13 +291,21 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
                     _generatedFecPackets[i].data[8] ^= mediaPayloadLength[0];
                     _generatedFecPackets[i].data[9] ^= mediaPayloadLength[1];
 
-                    // XOR with RTP payload, leaving room for the ULP header.
-                    for (WebRtc_Word32 j = kFecHeaderSize + ulpHeaderSize;
-                        j < fecPacketLength; j++)
+                    // A longer media packet XORs with zeros past the end of
+                    // the shorter packets.
+                    if (fecPacketLength > _generatedFecPackets[i].length)
                     {
-                        _generatedFecPackets[i].data[j] ^=
-                            mediaPacket->data[j - fecRtpOffset];
+                        memset(&_generatedFecPackets[i].data[
+                                   _generatedFecPackets[i].length],
+                               0,
+                               fecPacketLength - _generatedFecPackets[i].length);
                     }
+
+                    // XOR with RTP payload, leaving room for the ULP header.
+                    _xorPayload(
+                        &_generatedFecPackets[i].data[kFecHeaderSize + ulpHeaderSize],
+                        &mediaPacket->data[kRtpHeaderSize],
+                        mediaPacket->length - kRtpHeaderSize);
                 }
 
                 if (fecPacketLength > _generatedFecPackets[i].length)
@@ -285,7 +330,6 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
             WEBRTC_TRACE(kTraceError, kTraceRtpRtcp, _id,
                 "Packet mask has row of zeros %d %d %d ",
                 numMediaPackets, numImportantPackets, numFecPackets);
-            delete [] packetMask;
             return -1;
 
         }
@@ -343,7 +387,6 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
         memcpy(&_generatedFecPackets[i].data[12], &packetMask[i * numMaskBytes],
             numMaskBytes);
     }
-    delete [] packetMask;
     return 0;
 }
 
@@ -365,7 +408,6 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
     }
 
     ListItem* packetListItem = NULL;
-    ListItem* protectedPacketListItem = NULL;
     FecPacket* fecPacket = NULL;
     RecoveredPacket* recPacket = NULL;
     if (frameComplete)
@@ -396,17 +438,7 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
         while (packetListItem != NULL)
         {
             fecPacket = static_cast<FecPacket*>(packetListItem->GetItem());
-            protectedPacketListItem = fecPacket->protectedPktList.First();
-            while (protectedPacketListItem != NULL)
-            {
-                delete static_cast<ProtectedPacket*>(protectedPacketListItem->GetItem());
-                protectedPacketListItem =
-                    fecPacket->protectedPktList.Next(protectedPacketListItem);
-                fecPacket->protectedPktList.PopFront();
-            }
-            assert(fecPacket->protectedPktList.Empty());
-            delete fecPacket->pkt;
-            delete fecPacket;
+            ReleaseFecPacket(fecPacket);
             fecPacket = NULL;
             packetListItem = _fecPacketList.Next(packetListItem);
             _fecPacketList.PopFront();
@@ -516,7 +548,7 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
 
             }else
             {
-                fecPacket = new FecPacket;
+                fecPacket = NewFecPacket();
                 fecPacket->pkt = rxPacket->pkt;
                 fecPacket->seqNum = rxPacket->seqNum;
                 fecPacket->ssrc = rxPacket->ssrc;
@@ -533,8 +565,8 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
                     {
                         if (packetMask & (1 << (7 - bitIdx)))
                         {
-                            protectedPacket = new ProtectedPacket;
-                            fecPacket->protectedPktList.PushBack(protectedPacket);
+                            protectedPacket = &fecPacket->protectedPkts[
+                                fecPacket->numProtectedPkts++];
                             // This wraps naturally with the sequence number.
                             protectedPacket->seqNum = static_cast<WebRtc_UWord16>
                                 (_seqNumBase + (byteIdx << 3) + bitIdx);
@@ -543,11 +575,10 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
                     }
                 }
 
-                if (fecPacket->protectedPktList.Empty())
+                if (fecPacket->numProtectedPkts == 0)
                 {
                     // All-zero packet mask; we can discard this FEC packet.
-                    delete fecPacket->pkt;
-                    delete fecPacket;
+                    ReleaseFecPacket(fecPacket);
                     fecPacket = NULL;
                 }
                 else
@@ -576,14 +607,12 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
     {
         // Search for each FEC packet's protected media packets.
         fecPacket = static_cast<FecPacket*>(fecPacketListItem->GetItem());
-        protectedPacketListItem = fecPacket->protectedPktList.First();
         recPacketListItem = recoveredPacketList.First();
         protectedPacketsFound = 0;
         fecPacketListItemToDiscard = NULL;
-        while (protectedPacketListItem != NULL)
+        for (WebRtc_UWord16 p = 0; p < fecPacket->numProtectedPkts; p++)
         {
-            protectedPacket =
-                static_cast<ProtectedPacket*>(protectedPacketListItem->GetItem());
+            protectedPacket = &fecPacket->protectedPkts[p];
 
             if (protectedPacket->pkt != NULL)
             {
@@ -614,12 +643,9 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
                     recPacketListItem = recoveredPacketList.First();
                 }
             }
-
-            protectedPacketListItem =
-                fecPacket->protectedPktList.Next(protectedPacketListItem);
         }
 
-        if (protectedPacketsFound == fecPacket->protectedPktList.GetSize() - 1)
+        if (protectedPacketsFound == fecPacket->numProtectedPkts - 1)
         {
             // Recovery possible.
             WebRtc_UWord8 lengthRecovery[2];
@@ -629,10 +655,18 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
             RecoveredPacket* recPacketToInsert = new RecoveredPacket;
             recPacketToInsert->wasRecovered = true;
             recPacketToInsert->pkt = new Packet;
-            memset(recPacketToInsert->pkt->data, 0, IP_PACKET_SIZE);
 
             // Copy the protection length from the ULP header.
             memcpy(&protectionLength, &fecPacket->pkt->data[10], 2);
+            // Only this much of the packet is initialized below.
+            WebRtc_UWord32 recoveredLength = kRtpHeaderSize +
+                ModuleRTPUtility::BufferToUWord16(protectionLength);
+            if (recoveredLength + kFecHeaderSize + ulpHeaderSize - kRtpHeaderSize >
+                IP_PACKET_SIZE)
+            {
+                recoveredLength =
+                    IP_PACKET_SIZE - kFecHeaderSize - ulpHeaderSize + kRtpHeaderSize;
+            }
 
             // Copy the first 2 bytes of the FEC header.
             memcpy(recPacketToInsert->pkt->data, fecPacket->pkt->data, 2);
@@ -650,13 +684,11 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
             // Copy FEC payload, skipping the ULP header.
             memcpy(&recPacketToInsert->pkt->data[kRtpHeaderSize],
                 &fecPacket->pkt->data[kFecHeaderSize + ulpHeaderSize],
-                ModuleRTPUtility::BufferToUWord16(protectionLength));
+                recoveredLength - kRtpHeaderSize);
 
-            protectedPacketListItem = fecPacket->protectedPktList.First();
-            while (protectedPacketListItem != NULL)
+            for (WebRtc_UWord16 p = 0; p < fecPacket->numProtectedPkts; p++)
             {
-                protectedPacket =
-                    static_cast<ProtectedPacket*>(protectedPacketListItem->GetItem());
+                protectedPacket = &fecPacket->protectedPkts[p];
 
                 if (protectedPacket->pkt == NULL)
                 {
@@ -683,16 +715,20 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
                     lengthRecovery[0] ^= mediaPayloadLength[0];
                     lengthRecovery[1] ^= mediaPayloadLength[1];
 
-                    // XOR with RTP payload.
-                    // TODO: Are we doing more XORs than required here?
-                    for (WebRtc_Word32 i = kRtpHeaderSize; i < protectedPacket->pkt->length;
-                        i++)
+                    // A valid FEC packet protects its whole length, but don't
+                    // XOR with uninitialized data if it doesn't.
+                    if (protectedPacket->pkt->length > recoveredLength)
                     {
-                        recPacketToInsert->pkt->data[i] ^= protectedPacket->pkt->data[i];
+                        memset(&recPacketToInsert->pkt->data[recoveredLength], 0,
+                            protectedPacket->pkt->length - recoveredLength);
+                        recoveredLength = protectedPacket->pkt->length;
                     }
+
+                    // XOR with RTP payload.
+                    _xorPayload(&recPacketToInsert->pkt->data[kRtpHeaderSize],
+                        &protectedPacket->pkt->data[kRtpHeaderSize],
+                        protectedPacket->pkt->length - kRtpHeaderSize);
                 }
-                protectedPacketListItem =
-                    fecPacket->protectedPktList.Next(protectedPacketListItem);
             }
 
             // Set the RTP version to 2.
@@ -720,6 +756,12 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
             // Recover the packet length.
             recPacketToInsert->pkt->length =
                 ModuleRTPUtility::BufferToUWord16(lengthRecovery) + kRtpHeaderSize;
+            if (recPacketToInsert->pkt->length > recoveredLength &&
+                recPacketToInsert->pkt->length <= IP_PACKET_SIZE)
+            {
+                memset(&recPacketToInsert->pkt->data[recoveredLength], 0,
+                    recPacketToInsert->pkt->length - recoveredLength);
+            }
 
             // Insert into recovered list in correct position.
             recPacketListItem = recoveredPacketList.Last();
@@ -754,7 +796,7 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
             }
 
             protectedPacketsFound++;
-            assert(protectedPacketsFound == fecPacket->protectedPktList.GetSize());
+            assert(protectedPacketsFound == fecPacket->numProtectedPkts);
             fecPacketListItemToDiscard = fecPacketListItem;
         }
 
@@ -776,21 +818,11 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
             fecPacketListItem = _fecPacketList.Next(fecPacketListItem);
         }
 
-        if (protectedPacketsFound == fecPacket->protectedPktList.GetSize())
+        if (protectedPacketsFound == fecPacket->numProtectedPkts)
         {
             // Either all protected packets arrived or have been recovered.
             // We can discard this FEC packet.
-            protectedPacketListItem = fecPacket->protectedPktList.First();
-            while (protectedPacketListItem != NULL)
-            {
-                delete static_cast<ProtectedPacket*>(protectedPacketListItem->GetItem());
-                protectedPacketListItem =
-                    fecPacket->protectedPktList.Next(protectedPacketListItem);
-                fecPacket->protectedPktList.PopFront();
-            }
-            assert(fecPacket->protectedPktList.Empty());
-            delete fecPacket->pkt;
-            delete fecPacket;
+            ReleaseFecPacket(fecPacket);
             fecPacket = NULL;
             assert(fecPacketListItemToDiscard != NULL);
             _fecPacketList.Erase(fecPacketListItemToDiscard);
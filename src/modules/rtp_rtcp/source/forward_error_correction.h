@@ -17,6 +17,8 @@
 #include "list_wrapper.h"
 
 namespace webrtc {
+struct FecPacket;
+
 /**
  * Performs codec-independent forward error correction (FEC), based on RFC 5109.
  * Option exists to enable unequal protection (UEP) across packets.
@@ -176,9 +178,21 @@ public:
     static WebRtc_UWord16 PacketOverhead();
 
 private:
+    // Returns a FEC packet from the free list, or allocates a new one.
+    FecPacket* NewFecPacket();
+    // Frees the packet data and returns fecPacket to the free list.
+    void ReleaseFecPacket(FecPacket* fecPacket);
+
     WebRtc_Word32 _id;
+    // Storage for the generated FEC packets and their masks, allocated once
+    // and reused by every call to GenerateFEC().
     Packet* _generatedFecPackets;
+    WebRtc_UWord8* _packetMask;
+    void (*_xorPayload)(WebRtc_UWord8* dst,
+                        const WebRtc_UWord8* src,
+                        WebRtc_UWord32 length);
     ListWrapper _fecPacketList;
+    FecPacket* _freeFecPackets;
     WebRtc_UWord16 _seqNumBase;
     bool _lastMediaPacketReceived;
     bool _fecPacketReceived;
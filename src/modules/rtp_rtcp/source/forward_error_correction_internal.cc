@@ -14,6 +14,10 @@
 #include <cassert>
 #include <cstring>
 
+#if defined(WEBRTC_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
 namespace {
 
 // Allow for different modes of protection for packets in UEP case.
@@ -380,5 +384,67 @@ void GeneratePacketMasks(int numMediaPackets,
 
 } //End of GetPacketMasks
 
+void XorPayload_C(WebRtc_UWord8* dst,
+                  const WebRtc_UWord8* src,
+                  WebRtc_UWord32 length)
+{
+#if defined(WEBRTC_ARCH_64_BITS)
+    typedef WebRtc_UWord64 Word;
+#else
+    typedef WebRtc_UWord32 Word;
+#endif
+    // memcpy() of a word compiles to a single unaligned load or store.
+    WebRtc_UWord32 i = 0;
+    for (; i + sizeof(Word) <= length; i += sizeof(Word))
+    {
+        Word d;
+        Word s;
+        memcpy(&d, &dst[i], sizeof(Word));
+        memcpy(&s, &src[i], sizeof(Word));
+        d ^= s;
+        memcpy(&dst[i], &d, sizeof(Word));
+    }
+    for (; i < length; i++)
+    {
+        dst[i] ^= src[i];
+    }
+}
+
+#if defined(WEBRTC_USE_SSE2)
+void XorPayload_SSE2(WebRtc_UWord8* dst,
+                     const WebRtc_UWord8* src,
+                     WebRtc_UWord32 length)
+{
+    WebRtc_UWord32 i = 0;
+    for (; i + 64 <= length; i += 64)
+    {
+        __m128i d0 = _mm_loadu_si128(reinterpret_cast<__m128i*>(&dst[i]));
+        __m128i d1 = _mm_loadu_si128(reinterpret_cast<__m128i*>(&dst[i + 16]));
+        __m128i d2 = _mm_loadu_si128(reinterpret_cast<__m128i*>(&dst[i + 32]));
+        __m128i d3 = _mm_loadu_si128(reinterpret_cast<__m128i*>(&dst[i + 48]));
+        d0 = _mm_xor_si128(d0, _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(&src[i])));
+        d1 = _mm_xor_si128(d1, _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(&src[i + 16])));
+        d2 = _mm_xor_si128(d2, _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(&src[i + 32])));
+        d3 = _mm_xor_si128(d3, _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(&src[i + 48])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), d0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i + 16]), d1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i + 32]), d2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i + 48]), d3);
+    }
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i*>(&dst[i]));
+        d = _mm_xor_si128(d, _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(&src[i])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), d);
+    }
+    XorPayload_C(&dst[i], &src[i], length - i);
+}
+#endif
+
 }  // namespace internal
 }  // namespace webrtc
@@ -43,5 +43,24 @@ void GeneratePacketMasks(int numMediaPackets,
                          int numImpPackets,
                          bool useUnequalProtection,
                          WebRtc_UWord8* packetMask);
+
+ /**
+  * XORs src into dst: dst[i] ^= src[i] for i in [0, length).
+  * The buffers may have any alignment but must not overlap.
+  */
+typedef void (*XorPayloadFunc)(WebRtc_UWord8* dst,
+                               const WebRtc_UWord8* src,
+                               WebRtc_UWord32 length);
+
+// Portable version, XORs a machine word at a time.
+void XorPayload_C(WebRtc_UWord8* dst,
+                  const WebRtc_UWord8* src,
+                  WebRtc_UWord32 length);
+
+#if defined(WEBRTC_USE_SSE2)
+void XorPayload_SSE2(WebRtc_UWord8* dst,
+                     const WebRtc_UWord8* src,
+                     WebRtc_UWord32 length);
+#endif
 } // namespace internal
 } // namespace webrtc
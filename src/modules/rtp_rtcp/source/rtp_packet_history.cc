@@ -0,0 +1,277 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtp_packet_history.h"
+
+#include <string.h> // memcpy
+
+#include "critical_section_wrapper.h"
+
+namespace webrtc {
+RTPPacketHistory::RTPPacketHistory(RtpRtcpClock* clock) :
+    _clock(*clock),
+    _critsect(CriticalSectionWrapper::CreateCriticalSection()),
+    _storePackets(false),
+    _maxPackets(0),
+    _slots(NULL),
+    _slotMask(0),
+    _buffer(NULL),
+    _bufferSize(0),
+    _writeOffset(0),
+    _storedPackets(0),
+    _storedBytes(0),
+    _oldestSequenceNumber(0),
+    _newestSequenceNumber(0)
+{
+}
+
+RTPPacketHistory::~RTPPacketHistory()
+{
+    Free();
+    delete _critsect;
+}
+
+WebRtc_Word32
+RTPPacketHistory::SetStorePacketsStatus(const bool enable,
+                                        const WebRtc_UWord16 numberToStore,
+                                        const WebRtc_UWord32 maxBytesToStore)
+{
+    CriticalSectionScoped lock(_critsect);
+
+    if(!enable)
+    {
+        Free();
+        _storePackets = false;
+        return 0;
+    }
+    if(_storePackets)
+    {
+        // already enabled
+        return -1;
+    }
+    if(numberToStore == 0)
+    {
+        // storing 0 packets does not make sence
+        return -1;
+    }
+    // The slots are indexed with the low bits of the sequence number.
+    WebRtc_UWord32 numberOfSlots = 1;
+    while(numberOfSlots < numberToStore)
+    {
+        numberOfSlots <<= 1;
+    }
+    _slots = new StoredPacket[numberOfSlots];
+    memset(_slots, 0, sizeof(StoredPacket) * numberOfSlots);
+    _slotMask = numberOfSlots - 1;
+    _maxPackets = numberToStore;
+
+    if(maxBytesToStore == 0)
+    {
+        _bufferSize = numberToStore * IP_PACKET_SIZE;
+    } else
+    {
+        // Always room for at least one packet.
+        _bufferSize = (maxBytesToStore < IP_PACKET_SIZE) ? IP_PACKET_SIZE :
+                                                           maxBytesToStore;
+    }
+    _storePackets = true;
+    Clear();
+    return 0;
+}
+
+bool
+RTPPacketHistory::StorePackets() const
+{
+    CriticalSectionScoped lock(_critsect);
+    return _storePackets;
+}
+
+void
+RTPPacketHistory::Free()
+{
+    delete [] _slots;
+    delete [] _buffer;
+    _slots = NULL;
+    _buffer = NULL;
+    _slotMask = 0;
+    _maxPackets = 0;
+    _bufferSize = 0;
+    Clear();
+}
+
+void
+RTPPacketHistory::Clear()
+{
+    if(_slots)
+    {
+        memset(_slots, 0, sizeof(StoredPacket) * (_slotMask + 1));
+    }
+    _writeOffset = 0;
+    _storedPackets = 0;
+    _storedBytes = 0;
+    _oldestSequenceNumber = 0;
+    _newestSequenceNumber = 0;
+}
+
+// Returns true if [offset, offset + length) overlaps a stored packet.
+// The stored packets occupy the circular range from the oldest packet up to
+// _writeOffset; any space skipped at the end of the buffer is counted as
+// used.
+bool
+RTPPacketHistory::Overlaps(const WebRtc_UWord32 offset,
+                           const WebRtc_UWord16 length) const
+{
+    if(_storedPackets == 0)
+    {
+        return false;
+    }
+    const WebRtc_UWord32 oldestOffset =
+        _slots[_oldestSequenceNumber & _slotMask].offset;
+    if(oldestOffset < _writeOffset)
+    {
+        return offset < _writeOffset && oldestOffset < offset + length;
+    }
+    // The stored packets wrap around the end of the buffer.
+    return offset + length > oldestOffset || offset < _writeOffset;
+}
+
+void
+RTPPacketHistory::DropOldest()
+{
+    StoredPacket& oldest = _slots[_oldestSequenceNumber & _slotMask];
+    _storedBytes -= oldest.length;
+    oldest.length = 0;
+    _storedPackets--;
+    if(_storedPackets == 0)
+    {
+        _writeOffset = 0;
+        return;
+    }
+    // Skip the sequence numbers that were never stored.
+    do
+    {
+        _oldestSequenceNumber++;
+    } while(_slots[_oldestSequenceNumber & _slotMask].length == 0);
+}
+
+void
+RTPPacketHistory::PutRTPPacket(const WebRtc_UWord8* packet,
+                               const WebRtc_UWord16 length)
+{
+    CriticalSectionScoped lock(_critsect);
+
+    if(!_storePackets || length == 0 || length > IP_PACKET_SIZE)
+    {
+        return;
+    }
+    if(_buffer == NULL)
+    {
+        _buffer = new WebRtc_UWord8[_bufferSize];
+    }
+    const WebRtc_UWord16 sequenceNumber = (packet[2] << 8) + packet[3];
+
+    if(_storedPackets > 0)
+    {
+        const WebRtc_UWord16 step =
+            static_cast<WebRtc_UWord16>(sequenceNumber - _newestSequenceNumber);
+        if(step == 0 || step >= 0x8000)
+        {
+            // The sequence number has been reset, the old packets can't be
+            // told apart from the new ones.
+            Clear();
+        }
+    }
+    WebRtc_UWord32 offset = _writeOffset;
+    if(offset + length > _bufferSize)
+    {
+        offset = 0;
+    }
+    while(_storedPackets > 0 &&
+          (_storedPackets >= _maxPackets ||
+           static_cast<WebRtc_UWord16>(sequenceNumber - _oldestSequenceNumber)
+               > _slotMask ||
+           Overlaps(offset, length)))
+    {
+        DropOldest();
+    }
+    if(_storedPackets == 0)
+    {
+        offset = 0;
+        _oldestSequenceNumber = sequenceNumber;
+    }
+    memcpy(_buffer + offset, packet, length);
+
+    StoredPacket& stored = _slots[sequenceNumber & _slotMask];
+    stored.sequenceNumber = sequenceNumber;
+    stored.length = length;
+    stored.offset = offset;
+    stored.resendTime = 0;
+
+    _newestSequenceNumber = sequenceNumber;
+    _writeOffset = offset + length;
+    _storedPackets++;
+    _storedBytes += length;
+}
+
+WebRtc_Word32
+RTPPacketHistory::GetRTPPacket(const WebRtc_UWord16 sequenceNumber,
+                               const WebRtc_UWord32 minResendTime,
+                               WebRtc_UWord8* packet)
+{
+    CriticalSectionScoped lock(_critsect);
+
+    if(_storedPackets == 0)
+    {
+        return -1;
+    }
+    StoredPacket& stored = _slots[sequenceNumber & _slotMask];
+    if(stored.length == 0 || stored.sequenceNumber != sequenceNumber)
+    {
+        return -1;
+    }
+    const WebRtc_UWord32 now = _clock.GetTimeInMS();
+    if(minResendTime > 0 && stored.resendTime != 0 &&
+       now - stored.resendTime < minResendTime)
+    {
+        // No point in sending the packet again yet.
+        return 0;
+    }
+    memcpy(packet, _buffer + stored.offset, stored.length);
+    return stored.length;
+}
+
+void
+RTPPacketHistory::UpdateResendTime(const WebRtc_UWord16 sequenceNumber)
+{
+    CriticalSectionScoped lock(_critsect);
+
+    StoredPacket& stored = _slots[sequenceNumber & _slotMask];
+    // Make sure the packet is still stored.
+    if(_storedPackets > 0 && stored.length != 0 &&
+       stored.sequenceNumber == sequenceNumber)
+    {
+        stored.resendTime = _clock.GetTimeInMS();
+    }
+}
+
+WebRtc_UWord16
+RTPPacketHistory::NumberOfStoredPackets() const
+{
+    CriticalSectionScoped lock(_critsect);
+    return _storedPackets;
+}
+
+WebRtc_UWord32
+RTPPacketHistory::StoredBytes() const
+{
+    CriticalSectionScoped lock(_critsect);
+    return _storedBytes;
+}
+} // namespace webrtc
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Class for storing sent RTP packets, used to answer NACK requests.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
+
+#include "rtp_rtcp_defines.h"
+#include "typedefs.h"
+
+namespace webrtc {
+class CriticalSectionWrapper;
+
+// Packets are looked up directly by sequence number in a ring of slots, and
+// their payload is kept back to back in a circular byte buffer. The oldest
+// packets are dropped when either the packet count or the byte count limit
+// is reached.
+class RTPPacketHistory
+{
+public:
+    RTPPacketHistory(RtpRtcpClock* clock);
+    ~RTPPacketHistory();
+
+    // Starts storing up to numberToStore packets. If maxBytesToStore is not 0
+    // the stored packets may also not use more than maxBytesToStore bytes.
+    WebRtc_Word32 SetStorePacketsStatus(const bool enable,
+                                        const WebRtc_UWord16 numberToStore,
+                                        const WebRtc_UWord32 maxBytesToStore);
+
+    bool StorePackets() const;
+
+    // Stores a sent RTP packet. Packets are expected in sequence number
+    // order; a sequence number that goes backwards clears the history.
+    void PutRTPPacket(const WebRtc_UWord8* packet,
+                      const WebRtc_UWord16 length);
+
+    // Copies the packet with sequenceNumber to packet, which must hold
+    // IP_PACKET_SIZE bytes.
+    // Returns the length of the packet, 0 if the packet was resent less than
+    // minResendTime ms ago or -1 if the packet is not stored.
+    WebRtc_Word32 GetRTPPacket(const WebRtc_UWord16 sequenceNumber,
+                               const WebRtc_UWord32 minResendTime,
+                               WebRtc_UWord8* packet);
+
+    // Records that the packet with sequenceNumber was resent now. Call it
+    // only once the resend has succeeded.
+    void UpdateResendTime(const WebRtc_UWord16 sequenceNumber);
+
+    WebRtc_UWord16 NumberOfStoredPackets() const;
+    WebRtc_UWord32 StoredBytes() const;
+
+private:
+    struct StoredPacket
+    {
+        WebRtc_UWord16 sequenceNumber;
+        WebRtc_UWord16 length;  // 0 if the slot is empty.
+        WebRtc_UWord32 offset;
+        WebRtc_UWord32 resendTime;  // 0 if never resent.
+    };
+
+    void Free();
+    void Clear();
+    bool Overlaps(const WebRtc_UWord32 offset,
+                  const WebRtc_UWord16 length) const;
+    void DropOldest();
+
+    RtpRtcpClock&           _clock;
+    CriticalSectionWrapper* _critsect;
+    bool                    _storePackets;
+
+    WebRtc_UWord16          _maxPackets;
+    StoredPacket*           _slots;
+    WebRtc_UWord32          _slotMask;  // Number of slots - 1.
+
+    WebRtc_UWord8*          _buffer;  // Allocated on the first packet.
+    WebRtc_UWord32          _bufferSize;
+    WebRtc_UWord32          _writeOffset;
+
+    WebRtc_UWord16          _storedPackets;
+    WebRtc_UWord32          _storedBytes;
+    WebRtc_UWord16          _oldestSequenceNumber;
+    WebRtc_UWord16          _newestSequenceNumber;
+};
+} // namespace webrtc
+
+#endif // WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
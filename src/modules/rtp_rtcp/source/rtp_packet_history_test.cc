@@ -0,0 +1,203 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file includes unit tests for the RTPPacketHistory.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include "rtp_packet_history.h"
+#include "rtp_rtcp_defines.h"
+#include "typedefs.h"
+
+namespace webrtc {
+
+namespace {
+const int kPacketLength = 1000;
+
+class FakeClock : public RtpRtcpClock {
+ public:
+  FakeClock() : time_in_ms_(123456) {}
+  virtual WebRtc_UWord32 GetTimeInMS() {
+    return time_in_ms_;
+  }
+  virtual void CurrentNTP(WebRtc_UWord32& secs, WebRtc_UWord32& frac) {
+    secs = time_in_ms_ / 1000;
+    frac = 0;
+  }
+  void AdvanceTime(WebRtc_UWord32 time_ms) {
+    time_in_ms_ += time_ms;
+  }
+ private:
+  WebRtc_UWord32 time_in_ms_;
+};
+}  // namespace
+
+class RtpPacketHistoryTest : public ::testing::Test {
+ protected:
+  RtpPacketHistoryTest() : history_(&fake_clock_) {}
+
+  // Stores a packet filled with the low byte of its sequence number.
+  void PutPacket(WebRtc_UWord16 seq_num, WebRtc_UWord16 length) {
+    WebRtc_UWord8 packet[IP_PACKET_SIZE];
+    memset(packet, seq_num & 0xff, length);
+    packet[0] = 0x80;
+    packet[1] = 100;
+    packet[2] = seq_num >> 8;
+    packet[3] = seq_num & 0xff;
+    history_.PutRTPPacket(packet, length);
+  }
+
+  bool HasPacket(WebRtc_UWord16 seq_num) {
+    return history_.GetRTPPacket(seq_num, 0, packet_) > 0;
+  }
+
+  FakeClock fake_clock_;
+  RTPPacketHistory history_;
+  WebRtc_UWord8 packet_[IP_PACKET_SIZE];
+};
+
+TEST_F(RtpPacketHistoryTest, SetStoreStatus) {
+  EXPECT_FALSE(history_.StorePackets());
+  EXPECT_EQ(-1, history_.SetStorePacketsStatus(true, 0, 0));
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, 10, 0));
+  EXPECT_TRUE(history_.StorePackets());
+  EXPECT_EQ(-1, history_.SetStorePacketsStatus(true, 10, 0));
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(false, 0, 0));
+  EXPECT_FALSE(history_.StorePackets());
+}
+
+TEST_F(RtpPacketHistoryTest, NoStoreStatus) {
+  PutPacket(1, kPacketLength);
+  EXPECT_FALSE(HasPacket(1));
+}
+
+TEST_F(RtpPacketHistoryTest, PutAndGetPacket) {
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, 10, 0));
+  PutPacket(1, kPacketLength);
+  PutPacket(2, kPacketLength / 2);
+  EXPECT_EQ(kPacketLength / 2, history_.GetRTPPacket(2, 0, packet_));
+  EXPECT_EQ(2, packet_[3]);
+  EXPECT_EQ(2, packet_[kPacketLength / 2 - 1]);
+  EXPECT_EQ(kPacketLength, history_.GetRTPPacket(1, 0, packet_));
+  EXPECT_EQ(1, packet_[kPacketLength - 1]);
+  EXPECT_EQ(-1, history_.GetRTPPacket(3, 0, packet_));
+}
+
+TEST_F(RtpPacketHistoryTest, MinResendTime) {
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, 10, 0));
+  PutPacket(1, kPacketLength);
+  EXPECT_EQ(kPacketLength, history_.GetRTPPacket(1, 100, packet_));
+  history_.UpdateResendTime(1);
+  fake_clock_.AdvanceTime(99);
+  EXPECT_EQ(0, history_.GetRTPPacket(1, 100, packet_));
+  fake_clock_.AdvanceTime(1);
+  EXPECT_EQ(kPacketLength, history_.GetRTPPacket(1, 100, packet_));
+}
+
+TEST_F(RtpPacketHistoryTest, FailedResendIsRetried) {
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, 10, 0));
+  PutPacket(1, kPacketLength);
+  // The resend time is only recorded once the packet was actually sent.
+  EXPECT_EQ(kPacketLength, history_.GetRTPPacket(1, 100, packet_));
+  fake_clock_.AdvanceTime(10);
+  EXPECT_EQ(kPacketLength, history_.GetRTPPacket(1, 100, packet_));
+  // Unknown packets are ignored.
+  history_.UpdateResendTime(2);
+  EXPECT_EQ(-1, history_.GetRTPPacket(2, 100, packet_));
+}
+
+TEST_F(RtpPacketHistoryTest, DropsOldestWhenPacketLimitIsReached) {
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, 10, 0));
+  for (WebRtc_UWord16 i = 0; i < 25; ++i) {
+    PutPacket(i, kPacketLength);
+  }
+  EXPECT_EQ(10, history_.NumberOfStoredPackets());
+  EXPECT_FALSE(HasPacket(14));
+  for (WebRtc_UWord16 i = 15; i < 25; ++i) {
+    EXPECT_TRUE(HasPacket(i));
+    EXPECT_EQ(i & 0xff, packet_[kPacketLength - 1]);
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, DropsOldestWhenByteLimitIsReached) {
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, 100, 5 * kPacketLength));
+  for (WebRtc_UWord16 i = 0; i < 20; ++i) {
+    PutPacket(i, kPacketLength);
+    EXPECT_LE(history_.StoredBytes(), 5u * kPacketLength);
+  }
+  EXPECT_EQ(5, history_.NumberOfStoredPackets());
+  EXPECT_FALSE(HasPacket(14));
+  for (WebRtc_UWord16 i = 15; i < 20; ++i) {
+    EXPECT_TRUE(HasPacket(i));
+  }
+  // Packets of different sizes wrapping around the end of the buffer.
+  for (WebRtc_UWord16 i = 20; i < 200; ++i) {
+    PutPacket(i, 12 + (i * 37) % (IP_PACKET_SIZE - 12));
+    EXPECT_LE(history_.StoredBytes(), 5u * kPacketLength);
+    EXPECT_TRUE(HasPacket(i));
+    EXPECT_EQ(i & 0xff, packet_[11]);
+  }
+  for (WebRtc_UWord16 i = 200 - history_.NumberOfStoredPackets(); i < 200;
+       ++i) {
+    const WebRtc_Word32 length = history_.GetRTPPacket(i, 0, packet_);
+    ASSERT_EQ(12 + (i * 37) % (IP_PACKET_SIZE - 12), length);
+    for (WebRtc_Word32 j = 4; j < length; ++j) {
+      ASSERT_EQ(i & 0xff, packet_[j]);
+    }
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, SequenceNumberWrapAndGaps) {
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, 10, 0));
+  PutPacket(65533, kPacketLength);
+  PutPacket(65535, kPacketLength);
+  PutPacket(1, kPacketLength);
+  EXPECT_TRUE(HasPacket(65533));
+  EXPECT_FALSE(HasPacket(65534));
+  EXPECT_TRUE(HasPacket(65535));
+  EXPECT_FALSE(HasPacket(0));
+  EXPECT_TRUE(HasPacket(1));
+  // A gap larger than the history drops the old packets.
+  PutPacket(30, kPacketLength);
+  EXPECT_EQ(1, history_.NumberOfStoredPackets());
+  EXPECT_FALSE(HasPacket(1));
+  EXPECT_TRUE(HasPacket(30));
+}
+
+TEST_F(RtpPacketHistoryTest, SequenceNumberResetClearsHistory) {
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, 10, 0));
+  PutPacket(1000, kPacketLength);
+  PutPacket(1001, kPacketLength);
+  PutPacket(5, kPacketLength);
+  EXPECT_EQ(1, history_.NumberOfStoredPackets());
+  EXPECT_FALSE(HasPacket(1000));
+  EXPECT_TRUE(HasPacket(5));
+}
+
+// Every lookup in a long NACK list is a single slot access.
+TEST_F(RtpPacketHistoryTest, LongNackList) {
+  const WebRtc_UWord16 kNumberToStore = 10000;
+  EXPECT_EQ(0, history_.SetStorePacketsStatus(true, kNumberToStore, 0));
+  for (WebRtc_UWord32 i = 0; i < 3 * kNumberToStore; ++i) {
+    PutPacket(static_cast<WebRtc_UWord16>(i), 100);
+  }
+  int found = 0;
+  for (WebRtc_UWord32 i = 0; i < 3 * kNumberToStore; ++i) {
+    if (HasPacket(static_cast<WebRtc_UWord16>(i))) {
+      ++found;
+    }
+  }
+  EXPECT_EQ(kNumberToStore, found);
+}
+}  // namespace webrtc
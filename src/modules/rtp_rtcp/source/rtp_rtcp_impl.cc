@@ -2013,16 +2013,18 @@ ModuleRtpRtcpImpl::SendNACK(const WebRtc_UWord16* nackList,
     // Store the sent packets, needed to answer to a Negative acknowledgement requests
 WebRtc_Word32 ModuleRtpRtcpImpl::SetStorePacketsStatus(
     const bool enable,
-    const WebRtc_UWord16 numberToStore)
+    const WebRtc_UWord16 numberToStore,
+    const WebRtc_UWord32 maxBytesToStore)
 {
     if(enable)
     {
-        WEBRTC_TRACE(kTraceModuleCall, kTraceRtpRtcp, _id, "SetStorePacketsStatus(enable, numberToStore:%d)", numberToStore);
+        WEBRTC_TRACE(kTraceModuleCall, kTraceRtpRtcp, _id, "SetStorePacketsStatus(enable, numberToStore:%d, maxBytesToStore:%u)", numberToStore, maxBytesToStore);
     }else
     {
         WEBRTC_TRACE(kTraceModuleCall, kTraceRtpRtcp, _id, "SetStorePacketsStatus(disable)");
     }
-    return _rtpSender.SetStorePacketsStatus(enable, numberToStore);
+    return _rtpSender.SetStorePacketsStatus(enable, numberToStore,
+                                            maxBytesToStore);
 }
 
     /*
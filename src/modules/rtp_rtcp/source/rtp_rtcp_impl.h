@@ -385,7 +385,9 @@ public:
                                    const WebRtc_UWord16 size);
 
     // Store the sent packets, needed to answer to a Negative acknowledgement requests
-    virtual WebRtc_Word32 SetStorePacketsStatus(const bool enable, const WebRtc_UWord16 numberToStore = 200);
+    virtual WebRtc_Word32 SetStorePacketsStatus(const bool enable,
+                                                const WebRtc_UWord16 numberToStore = 200,
+                                                const WebRtc_UWord32 maxBytesToStore = 0);
 
     /*
     *   (APP) Application specific data
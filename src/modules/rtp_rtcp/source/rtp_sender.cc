@@ -49,14 +49,7 @@ RTPSender::RTPSender(const WebRtc_Word32 id,
     _keepAliveLastSent(0),
     _keepAliveDeltaTimeSend(0),
 
-    _storeSentPackets(false),
-    _storeSentPacketsNumber(0),
-    _prevSentPacketsCritsect(CriticalSectionWrapper::CreateCriticalSection()),
-    _prevSentPacketsIndex(0),
-    _ptrPrevSentPackets(NULL),
-    _prevSentPacketsSeqNum(NULL),
-    _prevSentPacketsLength(NULL),
-    _prevSentPacketsResendTime(NULL),
+    _packetHistory(clock),
 
     // NACK
     _nackByteCountTimes(),
@@ -110,7 +103,6 @@ RTPSender::~RTPSender()
     _ssrcDB.ReturnSSRC(_ssrc);
 
     SSRCDatabase::ReturnSSRCDatabase();
-    delete _prevSentPacketsCritsect;
     delete _sendCritsect;
     delete _transportCritsect;
 
@@ -133,19 +125,6 @@ RTPSender::~RTPSender()
         }
     } while (loop);
 
-    for(WebRtc_Word32 i=0; i< _storeSentPacketsNumber; i++)
-    {
-        if(_ptrPrevSentPackets[i])
-        {
-            delete [] _ptrPrevSentPackets[i];
-            _ptrPrevSentPackets[i] = 0;
-        }
-    }
-    delete [] _ptrPrevSentPackets;
-    delete [] _prevSentPacketsSeqNum;
-    delete [] _prevSentPacketsLength;
-    delete [] _prevSentPacketsResendTime;
-
     delete _audio;
     delete _video;
 
@@ -566,24 +545,6 @@ RTPSender::SetMaxPayloadLength(const WebRtc_UWord16 maxPayloadLength, const WebR
         WEBRTC_TRACE(kTraceError, kTraceRtpRtcp, _id, "%s invalid argument", __FUNCTION__);
         return -1;
     }
-    if(maxPayloadLength > _maxPayloadLength)
-    {
-        CriticalSectionScoped lock(_prevSentPacketsCritsect);
-        if(_storeSentPackets)
-        {
-            // we need to free the memmory allocated for storing sent packets
-            // will be allocated in SendToNetwork
-            for(WebRtc_Word32 i=0; i< _storeSentPacketsNumber; i++)
-            {
-                if(_ptrPrevSentPackets[i])
-                {
-                    delete [] _ptrPrevSentPackets[i];
-                    _ptrPrevSentPackets[i] = NULL;
-                }
-            }
-        }
-    }
-
     CriticalSectionScoped cs(_sendCritsect);
     _maxPayloadLength = maxPayloadLength;
     _packetOverHead = packetOverHead;
@@ -760,69 +721,18 @@ RTPSender::SendOutgoingData(const FrameType frameType,
 }
 
 WebRtc_Word32
-RTPSender::SetStorePacketsStatus(const bool enable, const WebRtc_UWord16 numberToStore)
+RTPSender::SetStorePacketsStatus(const bool enable,
+                                 const WebRtc_UWord16 numberToStore,
+                                 const WebRtc_UWord32 maxBytesToStore)
 {
-    CriticalSectionScoped lock(_prevSentPacketsCritsect);
-
-    if(enable)
-    {
-        if(_storeSentPackets)
-        {
-            // already enabled
-            return -1;
-        }
-        if(numberToStore > 0)
-        {
-            _storeSentPackets = enable;
-            _storeSentPacketsNumber = numberToStore;
-
-            _ptrPrevSentPackets = new WebRtc_Word8*[numberToStore],
-            _prevSentPacketsSeqNum = new WebRtc_UWord16[numberToStore];
-            _prevSentPacketsLength = new WebRtc_UWord16[numberToStore];
-            _prevSentPacketsResendTime = new WebRtc_UWord32[numberToStore];
-
-            memset(_ptrPrevSentPackets,0, sizeof(WebRtc_Word8*)*numberToStore);
-            memset(_prevSentPacketsSeqNum,0, sizeof(WebRtc_UWord16)*numberToStore);
-            memset(_prevSentPacketsLength,0, sizeof(WebRtc_UWord16)*numberToStore);
-            memset(_prevSentPacketsResendTime,0,sizeof(WebRtc_UWord32)*numberToStore);
-        } else
-        {
-            // storing 0 packets does not make sence
-            return -1;
-        }
-    } else
-    {
-        _storeSentPackets = enable;
-        if(_storeSentPacketsNumber > 0)
-        {
-            for(WebRtc_Word32 i=0; i< _storeSentPacketsNumber; i++)
-            {
-                if(_ptrPrevSentPackets[i])
-                {
-                    delete [] _ptrPrevSentPackets[i];
-                    _ptrPrevSentPackets[i] = 0;
-                }
-            }
-            delete [] _ptrPrevSentPackets;
-            delete [] _prevSentPacketsSeqNum;
-            delete [] _prevSentPacketsLength;
-            delete [] _prevSentPacketsResendTime;
-
-            _ptrPrevSentPackets = NULL;
-            _prevSentPacketsSeqNum = NULL;
-            _prevSentPacketsLength = NULL;
-            _prevSentPacketsResendTime = NULL;
-
-            _storeSentPacketsNumber = 0;
-        }
-    }
-    return 0;
+    return _packetHistory.SetStorePacketsStatus(enable, numberToStore,
+                                                maxBytesToStore);
 }
 
 bool
 RTPSender::StorePackets() const
 {
-    return _storeSentPackets;
+    return _packetHistory.StorePackets();
 }
 
 WebRtc_Word32
@@ -836,78 +746,29 @@ RTPSender::ReSendToNetwork(WebRtc_UWord16 packetID,
 #endif
 
     WebRtc_Word32 i = -1;
-    WebRtc_Word32 length = 0;
-    WebRtc_Word32 index =0;
     WebRtc_UWord8 dataBuffer[IP_PACKET_SIZE];
 
+    const WebRtc_Word32 length = _packetHistory.GetRTPPacket(packetID,
+                                                             minResendTime,
+                                                             dataBuffer);
+    if(length == 0)
     {
-        CriticalSectionScoped lock(_prevSentPacketsCritsect);
-
-        WebRtc_UWord16 seqNum = 0;
-        if(_storeSentPackets)
-        {
-            if(_prevSentPacketsIndex)
-            {
-                seqNum = _prevSentPacketsSeqNum[_prevSentPacketsIndex-1];
-            }else
-            {
-                seqNum = _prevSentPacketsSeqNum[_storeSentPacketsNumber-1];
-            }
-            index = (_prevSentPacketsIndex-1) - (seqNum - packetID);
-            if (index >= 0 && index < _storeSentPacketsNumber)
-            {
-                seqNum = _prevSentPacketsSeqNum[index];
-            }
-            if(seqNum != packetID)
-            {
-                //we did not found a match, search all
-                for (WebRtc_Word32 m = 0; m < _storeSentPacketsNumber ;m++)
-                {
-                    if(_prevSentPacketsSeqNum[m] == packetID)
-                    {
-                        index = m;
-                        seqNum = _prevSentPacketsSeqNum[index];
-                        break;
-                    }
-                }
-            }
-            if(seqNum == packetID)
-            {
-                WebRtc_UWord32 timeNow= _clock.GetTimeInMS();
-                if(minResendTime>0 && (timeNow-_prevSentPacketsResendTime[index]<minResendTime))
-                {
-                    // No point in sending the packet again yet. Get out of here
-                    WEBRTC_TRACE(kTraceStream, kTraceRtpRtcp, _id, "Skipping to resend RTP packet %d because it was just resent", seqNum);
-                    return 0;
-                }
-
-                length = _prevSentPacketsLength[index];
-
-                if(length > _maxPayloadLength || _ptrPrevSentPackets[index] == 0)
-                {
-                    WEBRTC_TRACE(
-                        kTraceWarning, kTraceRtpRtcp, _id,
-                        "Failed to resend seqNum %u: length = %d index = %d",
-                        seqNum, length, index);
-                    return -1;
-                }
-            } else
-            {
-                WEBRTC_TRACE(kTraceWarning, kTraceRtpRtcp, _id,
-                             "No match for resending seqNum %u and packetId %u",
-                             seqNum, packetID);
-                return -1;
-            }
-        }
-        if(length ==0)
-        {
-          WEBRTC_TRACE(kTraceWarning, kTraceRtpRtcp, _id,
-                       "Resend packet length == 0 for seqNum %u", seqNum);
-            return -1;
-        }
-
-        // copy to local buffer for callback
-        memcpy(dataBuffer, _ptrPrevSentPackets[index], length);
+        // No point in sending the packet again yet. Get out of here
+        WEBRTC_TRACE(kTraceStream, kTraceRtpRtcp, _id, "Skipping to resend RTP packet %d because it was just resent", packetID);
+        return 0;
+    }
+    if(length < 0)
+    {
+        WEBRTC_TRACE(kTraceWarning, kTraceRtpRtcp, _id,
+                     "No match for resending packetId %u", packetID);
+        return -1;
+    }
+    if(length > _maxPayloadLength)
+    {
+        WEBRTC_TRACE(kTraceWarning, kTraceRtpRtcp, _id,
+                     "Failed to resend seqNum %u: length = %d",
+                     packetID, length);
+        return -1;
     }
     {
         CriticalSectionScoped lock(_transportCritsect);
@@ -926,15 +787,10 @@ RTPSender::ReSendToNetwork(WebRtc_UWord16 packetID,
 
         // we on purpose don't add to _payloadBytesSent since this is a re-transmit and not new payload data
     }
-    if(_storeSentPackets && i > 0)
+    if(i > 0)
     {
-        CriticalSectionScoped lock(_prevSentPacketsCritsect);
-
-        if(_prevSentPacketsSeqNum[index] == packetID) // Make sure the  packet is still in the array
-        {
-            // Store the time when the frame was last resent.
-            _prevSentPacketsResendTime[index]= _clock.GetTimeInMS();
-        }
+        // Store the time when the packet was last resent.
+        _packetHistory.UpdateResendTime(packetID);
         return i; //bytes sent over network
     }
     WEBRTC_TRACE(kTraceWarning, kTraceRtpRtcp, _id,
@@ -1082,29 +938,9 @@ RTPSender::SendToNetwork(const WebRtc_UWord8* buffer,
     {
         // Store my packets
         // Used for NACK
-        CriticalSectionScoped lock(_prevSentPacketsCritsect);
-        if(_storeSentPackets && length > 0)
+        if(length > 0)
         {
-            if(_ptrPrevSentPackets[0] == NULL)
-            {
-                for(WebRtc_Word32 i=0; i< _storeSentPacketsNumber; i++)
-                {
-                    _ptrPrevSentPackets[i] = new char[_maxPayloadLength];
-                    memset(_ptrPrevSentPackets[i],0, _maxPayloadLength);
-                }
-            }
-
-            const WebRtc_UWord16 sequenceNumber = (buffer[2] << 8) + buffer[3];
-
-            memcpy(_ptrPrevSentPackets[_prevSentPacketsIndex], buffer, length + rtpLength);
-            _prevSentPacketsSeqNum[_prevSentPacketsIndex] = sequenceNumber;
-            _prevSentPacketsLength[_prevSentPacketsIndex]= length + rtpLength;
-            _prevSentPacketsResendTime[_prevSentPacketsIndex]=0; // Packet has not been re-sent.
-            _prevSentPacketsIndex++;
-            if(_prevSentPacketsIndex >= _storeSentPacketsNumber)
-            {
-                _prevSentPacketsIndex = 0;
-            }
+            _packetHistory.PutRTPPacket(buffer, length + rtpLength);
         }
     }
     // Send packet
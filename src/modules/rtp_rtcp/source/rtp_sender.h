@@ -19,6 +19,7 @@
 #include "map_wrapper.h"
 #include "Bitrate.h"
 #include "rtp_header_extension.h"
+#include "rtp_packet_history.h"
 #include "video_codec_information.h"
 
 #include <cassert>
@@ -166,7 +167,9 @@ public:
                         const WebRtc_UWord16* nackSequenceNumbers,
                         const WebRtc_UWord16 avgRTT);
 
-    WebRtc_Word32 SetStorePacketsStatus(const bool enable, const WebRtc_UWord16 numberToStore);
+    WebRtc_Word32 SetStorePacketsStatus(const bool enable,
+                                        const WebRtc_UWord16 numberToStore,
+                                        const WebRtc_UWord32 maxBytesToStore = 0);
 
     bool StorePackets() const;
 
@@ -309,14 +312,7 @@ private:
     WebRtc_UWord32            _keepAliveLastSent;
     WebRtc_UWord16            _keepAliveDeltaTimeSend;
 
-    bool                      _storeSentPackets;
-    WebRtc_UWord16            _storeSentPacketsNumber;
-    CriticalSectionWrapper*    _prevSentPacketsCritsect;
-    WebRtc_Word32             _prevSentPacketsIndex;
-    WebRtc_Word8**            _ptrPrevSentPackets;
-    WebRtc_UWord16*           _prevSentPacketsSeqNum;
-    WebRtc_UWord16*           _prevSentPacketsLength;
-    WebRtc_UWord32*           _prevSentPacketsResendTime;
+    RTPPacketHistory          _packetHistory;
 
     // NACK
     WebRtc_UWord32            _nackByteCountTimes[NACK_BYTECOUNT_SIZE];
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string.h>
+
 #include "rtp_header_extension.h"
 #include "rtp_rtcp_defines.h"
 #include "rtp_sender.h"
@@ -30,6 +32,29 @@ const uint32_t kTimestamp = 10;
 const uint16_t kSeqNum = 33;
 const int kTimeOffset = 22222;
 const int kMaxPacketLength = 1500;
+
+class LoopbackTransportTest : public webrtc::Transport {
+ public:
+  LoopbackTransportTest()
+    : packets_sent_(0), last_sent_length_(0), fail_(false) {}
+  virtual int SendPacket(int /*channel*/, const void* data, int len) {
+    if (fail_) {
+      return -1;
+    }
+    packets_sent_++;
+    last_sent_length_ = len;
+    memcpy(last_sent_packet_, data, len);
+    return len;
+  }
+  virtual int SendRTCPPacket(int /*channel*/, const void* /*data*/,
+                             int /*len*/) {
+    return -1;
+  }
+  int packets_sent_;
+  int last_sent_length_;
+  uint8_t last_sent_packet_[kMaxPacketLength];
+  bool fail_;
+};
 }  // namespace
 
 class RtpSenderTest : public ::testing::Test {
@@ -124,4 +149,58 @@ TEST_F(RtpSenderTest, BuildRTPPacketWithExtension) {
   EXPECT_EQ(length, rtp_header2.header.headerLength);
   EXPECT_EQ(0, rtp_header2.extension.transmissionTimeOffset);
 }
+
+TEST_F(RtpSenderTest, ReSendStoredPacketsOnNack) {
+  LoopbackTransportTest transport;
+  EXPECT_EQ(0, rtp_sender_->RegisterSendTransport(&transport));
+  EXPECT_EQ(0, rtp_sender_->SetStorePacketsStatus(true, 10));
+
+  const int kPayloadLength = 100;
+  for (int i = 0; i < 20; ++i) {
+    WebRtc_Word32 length = rtp_sender_->BuildRTPheader(packet_,
+                                                       kPayload,
+                                                       kMarkerBit,
+                                                       kTimestamp);
+    ASSERT_EQ(12, length);
+    memset(packet_ + length, i, kPayloadLength);
+    EXPECT_EQ(0, rtp_sender_->SendToNetwork(packet_, kPayloadLength,
+                                            length));
+  }
+  EXPECT_EQ(20, transport.packets_sent_);
+
+  // The last ten packets are stored.
+  const WebRtc_UWord16 nack_list[] = {kSeqNum + 12, kSeqNum + 19};
+  rtp_sender_->OnReceivedNACK(2, nack_list, 0);
+  EXPECT_EQ(22, transport.packets_sent_);
+  EXPECT_EQ(12 + kPayloadLength, transport.last_sent_length_);
+  EXPECT_EQ(19, transport.last_sent_packet_[12]);
+
+  // Packets that have been dropped from the history are not resent.
+  EXPECT_EQ(-1, rtp_sender_->ReSendToNetwork(kSeqNum + 5));
+  EXPECT_EQ(22, transport.packets_sent_);
+}
+
+TEST_F(RtpSenderTest, FailedResendDoesNotDelayRetry) {
+  LoopbackTransportTest transport;
+  EXPECT_EQ(0, rtp_sender_->RegisterSendTransport(&transport));
+  EXPECT_EQ(0, rtp_sender_->SetStorePacketsStatus(true, 10));
+
+  const int kPayloadLength = 100;
+  WebRtc_Word32 length = rtp_sender_->BuildRTPheader(packet_, kPayload,
+                                                     kMarkerBit, kTimestamp);
+  ASSERT_EQ(12, length);
+  EXPECT_EQ(0, rtp_sender_->SendToNetwork(packet_, kPayloadLength, length));
+
+  const WebRtc_UWord32 kMinResendTimeMs = 10000;
+  transport.fail_ = true;
+  EXPECT_EQ(-1, rtp_sender_->ReSendToNetwork(kSeqNum, kMinResendTimeMs));
+  // The failed resend is not counted, so the retry goes out at once.
+  transport.fail_ = false;
+  EXPECT_EQ(length + kPayloadLength,
+            rtp_sender_->ReSendToNetwork(kSeqNum, kMinResendTimeMs));
+  EXPECT_EQ(2, transport.packets_sent_);
+  // A successful resend holds back the next one.
+  EXPECT_EQ(0, rtp_sender_->ReSendToNetwork(kSeqNum, kMinResendTimeMs));
+  EXPECT_EQ(2, transport.packets_sent_);
+}
 }  // namespace webrtc
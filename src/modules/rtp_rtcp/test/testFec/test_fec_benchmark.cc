@@ -0,0 +1,238 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/**
+ * Benchmark of the core FEC algorithm. Measures the throughput of
+ * ForwardErrorCorrection::GenerateFEC() and DecodeFEC() in MB/s of protected
+ * media data for frames of full size packets, as sent for HD video.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "forward_error_correction.h"
+#include "list_wrapper.h"
+#include "rtp_utility.h"
+#include "tick_util.h"
+
+namespace {
+
+const WebRtc_UWord32 kSsrc = 0x12345678;
+const int kPacketLength = 1200;
+const int kNumFrames = 2000;
+
+// Builds numMediaPackets packets of one frame, with random payloads.
+void BuildFrame(webrtc::ForwardErrorCorrection::Packet* mediaPackets,
+                int numMediaPackets,
+                WebRtc_UWord16 seqNum,
+                WebRtc_UWord32 timeStamp,
+                webrtc::ListWrapper& mediaPacketList)
+{
+    for (int i = 0; i < numMediaPackets; i++)
+    {
+        webrtc::ForwardErrorCorrection::Packet* mediaPacket = &mediaPackets[i];
+        // Vary the length a little, as a real frame would.
+        mediaPacket->length = static_cast<WebRtc_UWord16>(
+            kPacketLength - (rand() % 64));
+        for (int j = 12; j < mediaPacket->length; j++)
+        {
+            mediaPacket->data[j] = static_cast<WebRtc_UWord8>(rand());
+        }
+        mediaPacket->data[0] = 0x80;
+        mediaPacket->data[1] = 96;
+        webrtc::ModuleRTPUtility::AssignUWord16ToBuffer(&mediaPacket->data[2],
+                                                        seqNum + i);
+        webrtc::ModuleRTPUtility::AssignUWord32ToBuffer(&mediaPacket->data[4],
+                                                        timeStamp);
+        webrtc::ModuleRTPUtility::AssignUWord32ToBuffer(&mediaPacket->data[8],
+                                                        kSsrc);
+        mediaPacketList.PushBack(mediaPacket);
+    }
+    // Marker bit on the last packet.
+    mediaPackets[numMediaPackets - 1].data[1] |= 0x80;
+}
+
+webrtc::ForwardErrorCorrection::ReceivedPacket* CopyToReceived(
+    const webrtc::ForwardErrorCorrection::Packet* packet,
+    WebRtc_UWord16 seqNum,
+    bool isFec)
+{
+    webrtc::ForwardErrorCorrection::ReceivedPacket* receivedPacket =
+        new webrtc::ForwardErrorCorrection::ReceivedPacket;
+    receivedPacket->pkt = new webrtc::ForwardErrorCorrection::Packet;
+    receivedPacket->pkt->length = packet->length;
+    memcpy(receivedPacket->pkt->data, packet->data, packet->length);
+    receivedPacket->seqNum = seqNum;
+    receivedPacket->ssrc = kSsrc;
+    receivedPacket->isFec = isFec;
+    receivedPacket->lastMediaPktInFrame =
+        !isFec && (packet->data[1] & 0x80) != 0;
+    return receivedPacket;
+}
+
+void FreeRecovered(webrtc::ListWrapper& recoveredPacketList)
+{
+    while (!recoveredPacketList.Empty())
+    {
+        webrtc::ForwardErrorCorrection::RecoveredPacket* recoveredPacket =
+            static_cast<webrtc::ForwardErrorCorrection::RecoveredPacket*>(
+                recoveredPacketList.First()->GetItem());
+        delete recoveredPacket->pkt;
+        delete recoveredPacket;
+        recoveredPacketList.PopFront();
+    }
+}
+
+double MegaBytesPerSecond(WebRtc_Word64 bytes, WebRtc_Word64 microseconds)
+{
+    return microseconds > 0 ? static_cast<double>(bytes) / microseconds : 0.0;
+}
+
+// Returns -1 if recovery failed.
+int RunBenchmark(int numMediaPackets, WebRtc_UWord8 protectionFactor)
+{
+    webrtc::ForwardErrorCorrection fec(0);
+    webrtc::ForwardErrorCorrection::Packet* mediaPackets =
+        new webrtc::ForwardErrorCorrection::Packet[numMediaPackets];
+    webrtc::ListWrapper mediaPacketList;
+    webrtc::ListWrapper fecPacketList;
+    webrtc::ListWrapper receivedPacketList;
+    webrtc::ListWrapper recoveredPacketList;
+
+    WebRtc_UWord16 seqNum = static_cast<WebRtc_UWord16>(rand());
+    WebRtc_UWord32 timeStamp = static_cast<WebRtc_UWord32>(rand());
+    // Accumulated in ticks, a single call may take less than a microsecond.
+    webrtc::TickInterval encodeTime;
+    webrtc::TickInterval decodeTime;
+    WebRtc_Word64 encodedBytes = 0;
+    WebRtc_Word64 recoveredBytes = 0;
+    int numFecPackets = 0;
+
+    for (int frame = 0; frame < kNumFrames; frame++)
+    {
+        BuildFrame(mediaPackets, numMediaPackets, seqNum, timeStamp,
+                   mediaPacketList);
+        for (int i = 0; i < numMediaPackets; i++)
+        {
+            encodedBytes += mediaPackets[i].length;
+        }
+
+        webrtc::TickTime startTime = webrtc::TickTime::Now();
+        if (fec.GenerateFEC(mediaPacketList, protectionFactor, 0, false,
+                            fecPacketList) != 0)
+        {
+            printf("Error: GenerateFEC() failed\n");
+            return -1;
+        }
+        encodeTime += webrtc::TickTime::Now() - startTime;
+        numFecPackets = fecPacketList.GetSize();
+
+        // Lose the first media packet of the frame, which every FEC packet
+        // protects.
+        for (int i = 1; i < numMediaPackets; i++)
+        {
+            receivedPacketList.PushBack(CopyToReceived(
+                &mediaPackets[i], static_cast<WebRtc_UWord16>(seqNum + i),
+                false));
+        }
+        webrtc::ListItem* item = fecPacketList.First();
+        for (int i = 0; item != NULL; i++)
+        {
+            receivedPacketList.PushBack(CopyToReceived(
+                static_cast<webrtc::ForwardErrorCorrection::Packet*>(
+                    item->GetItem()),
+                static_cast<WebRtc_UWord16>(seqNum + numMediaPackets + i),
+                true));
+            item = fecPacketList.Next(item);
+        }
+
+        bool frameComplete = true;
+        startTime = webrtc::TickTime::Now();
+        if (fec.DecodeFEC(receivedPacketList, recoveredPacketList,
+                          seqNum - 1, frameComplete) != 0)
+        {
+            printf("Error: DecodeFEC() failed\n");
+            return -1;
+        }
+        decodeTime += webrtc::TickTime::Now() - startTime;
+
+        webrtc::ForwardErrorCorrection::RecoveredPacket* recoveredPacket =
+            static_cast<webrtc::ForwardErrorCorrection::RecoveredPacket*>(
+                recoveredPacketList.First()->GetItem());
+        if (recoveredPacketList.GetSize() !=
+                static_cast<WebRtc_UWord32>(numMediaPackets) ||
+            !recoveredPacket->wasRecovered ||
+            recoveredPacket->pkt->length != mediaPackets[0].length ||
+            memcmp(recoveredPacket->pkt->data, mediaPackets[0].data,
+                   mediaPackets[0].length) != 0)
+        {
+            printf("Error: lost packet was not recovered\n");
+            return -1;
+        }
+        recoveredBytes += mediaPackets[0].length;
+        FreeRecovered(recoveredPacketList);
+
+        while (!fecPacketList.Empty())
+        {
+            fecPacketList.PopFront();
+        }
+        while (!mediaPacketList.Empty())
+        {
+            mediaPacketList.PopFront();
+        }
+        seqNum += numMediaPackets + numFecPackets;
+        timeStamp += 90000 / 30;
+    }
+
+    // Have DecodeFEC free allocated memory.
+    bool frameComplete = true;
+    fec.DecodeFEC(receivedPacketList, recoveredPacketList, seqNum,
+                  frameComplete);
+    delete [] mediaPackets;
+
+    const WebRtc_Word64 encodeUs = encodeTime.Microseconds();
+    const WebRtc_Word64 decodeUs = decodeTime.Microseconds();
+    printf("%2d media packets, %2d FEC packets: encode %7.1f MB/s "
+           "(%.2f us/frame), decode %7.1f MB/s (%.2f us/frame), "
+           "recovery %6.1f MB/s\n",
+           numMediaPackets, numFecPackets,
+           MegaBytesPerSecond(encodedBytes, encodeUs),
+           static_cast<double>(encodeUs) / kNumFrames,
+           MegaBytesPerSecond(encodedBytes, decodeUs),
+           static_cast<double>(decodeUs) / kNumFrames,
+           MegaBytesPerSecond(recoveredBytes, decodeUs));
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    srand(1234);
+    // Encode throughput counts the media bytes protected; decode throughput
+    // counts the media bytes of the frames passed through DecodeFEC(), and
+    // recovery throughput the bytes of the lost packets restored.
+    const int numMediaPackets[] = {5, 12, 24, 48};
+    const WebRtc_UWord8 protectionFactor[] = {51, 128};
+    for (size_t i = 0; i < sizeof(numMediaPackets) / sizeof(*numMediaPackets);
+         i++)
+    {
+        for (size_t j = 0;
+             j < sizeof(protectionFactor) / sizeof(*protectionFactor); j++)
+        {
+            if (RunBenchmark(numMediaPackets[i], protectionFactor[j]) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
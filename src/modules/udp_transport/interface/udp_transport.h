@@ -90,6 +90,23 @@ struct SocketAddress
     };
 };
 
+// Counters for batched socket I/O, see UdpTransport::EnableBatchedIO(..).
+// Bin i of the histograms counts system calls that moved between 2^i and
+// 2^(i+1) - 1 packets. The last bin also counts larger batches.
+enum {kUdpBatchHistogramBins = 6};
+struct UdpBatchStatistics
+{
+    WebRtc_UWord32 receiveCalls;
+    WebRtc_UWord32 receivedPackets;
+    WebRtc_UWord32 receiveBatchHistogram[kUdpBatchHistogramBins];
+    WebRtc_UWord32 sendCalls;
+    WebRtc_UWord32 sentPackets;
+    WebRtc_UWord32 sendBatchHistogram[kUdpBatchHistogramBins];
+};
+
+class PacketBuffer;
+struct PacketBufferPoolStatistics;
+
 // Callback class that receives packets from UdpTransport.
 class UdpTransportData
 {
@@ -101,6 +118,16 @@ public:
                                    const WebRtc_Word8* fromIP,
                                    const WebRtc_UWord16 fromPort) = 0;
 
+    // Called instead of IncomingRTPPacket(..) when the packet was read
+    // straight into a pooled buffer. Implementations that need the packet
+    // after returning call packet->AddRef() and packet->Release() when done,
+    // instead of copying it. ViEReceiver passes the buffer on to VCM, which
+    // keeps it until the frame is assembled. The default implementation calls
+    // IncomingRTPPacket(..).
+    virtual void IncomingRTPPacketBuffer(PacketBuffer* packet,
+                                         const WebRtc_Word8* fromIP,
+                                         const WebRtc_UWord16 fromPort);
+
     virtual void IncomingRTCPPacket(const WebRtc_Word8* incomingRtcpPacket,
                                     const WebRtc_Word32 rtcpPacketLength,
                                     const WebRtc_Word8* fromIP,
@@ -116,6 +143,7 @@ public:
         kIpAddressVersion6Length = 64,
         kIpAddressVersion4Length = 16
     };
+    enum {kMaxBatchSize = 32};
     enum ErrorCode
     {
         kNoSocketError            = 0,
@@ -286,6 +314,34 @@ public:
     // Return true if receive sockets have been initialized.
     virtual bool ReceiveSocketsInitialized() const = 0;
 
+    // Enable/disable batched socket I/O. When enabled up to maxBatchSize
+    // incoming packets are read per socket wakeup and RTP packets passed to
+    // SendPacket(..) are queued and sent with a single system call once
+    // maxBatchSize packets are queued, FlushPackets() is called or Process()
+    // runs. maxBatchSize is capped at kMaxBatchSize.
+    // Note: queued RTP packets may be held for up to 5 ms, until the next
+    // Process() call, which adds as much to the send latency. Queued packets
+    // are flushed before any RTCP packet, or RTP packet sent with
+    // SendRTPPacketTo(..), so that packets leave in the order they were sent.
+    // Note: recvmmsg()/sendmmsg() are only used on Linux. Other platforms
+    // still queue outgoing packets but send them one at a time.
+    virtual WebRtc_Word32 EnableBatchedIO(
+        const bool enable,
+        const WebRtc_UWord32 maxBatchSize = kMaxBatchSize) = 0;
+
+    // Send all RTP packets queued by SendPacket(..) in batched mode.
+    virtual WebRtc_Word32 FlushPackets() = 0;
+
+    // Retrieve batch size counters for the sockets currently in use.
+    virtual WebRtc_Word32 BatchStatistics(UdpBatchStatistics& stats) const = 0;
+
+    // Retrieve allocation and reuse counters for the pooled buffers that
+    // incoming packets are read into. The pool is shared by all UdpTransport
+    // instances of the process.
+    // Note: this API is only implemented on Linux and Mac.
+    virtual WebRtc_Word32 PacketBufferStatistics(
+        PacketBufferPoolStatistics& stats) const = 0;
+
     // Send data with size length to ip:portnr. The same port as the set
     // with InitializeSendSockets(..) is used if portnr is 0. The same IP
     // address as set with InitializeSendSockets(..) is used if ip is NULL.
@@ -549,7 +549,7 @@ void UdpSocket2Windows::IOCompleted(PerIoContext* pIOContext,
             if(_wantsIncoming && _incomingCb)
             {
                 _incomingCb(_obj,pIOContext->wsabuf.buf, ioSize,
-                            &pIOContext->from);
+                            &pIOContext->from, NULL);
             }
             _ptrCbRWLock->ReleaseLockShared();
         }
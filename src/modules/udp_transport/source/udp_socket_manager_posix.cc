@@ -10,23 +10,36 @@
 
 #include "udp_socket_manager_posix.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
 #include <strings.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
 
+#include "cpu_info.h"
+#include "packet_buffer_pool.h"
 #include "trace.h"
 #include "udp_socket_posix.h"
 
 namespace webrtc {
-UdpSocketManagerPosix::UdpSocketManagerPosix()
+// Number of released packet buffers kept for reuse.
+enum {kMaxFreePacketBuffers = 1024};
+
+UdpSocketManagerPosix::UdpSocketManagerPosix(UdpSocketPollMethod pollMethod)
     : UdpSocketManager(),
       _id(-1),
       _critSect(CriticalSectionWrapper::CreateCriticalSection()),
-      _numberOfSocketMgr(-1),
-      _incSocketMgrNextTime(0),
-      _nextSocketMgrToAssign(0),
+#if defined(WEBRTC_LINUX)
+      _pollMethod(pollMethod),
+#else
+      _pollMethod(kUdpPollSelect),
+#endif
+      _packetPool(PacketBufferPool::Create(UDP_MAX_DATAGRAM_SIZE,
+                                           kMaxFreePacketBuffers)),
+      _numberOfSocketMgr(0),
       _socketMgr()
 {
 }
@@ -42,19 +55,59 @@ bool UdpSocketManagerPosix::Init(WebRtc_Word32 id,
 
     _id = id;
     _numberOfSocketMgr = numOfWorkThreads;
-    _numOfWorkThreads = numOfWorkThreads;
 
-    if(MAX_NUMBER_OF_SOCKET_MANAGERS_LINUX < _numberOfSocketMgr)
+    if(_pollMethod == kUdpPollEpoll)
     {
-        _numberOfSocketMgr = MAX_NUMBER_OF_SOCKET_MANAGERS_LINUX;
+        // One socket loop per core unless the caller asked for a specific
+        // number of loops.
+        if(_numberOfSocketMgr == 0)
+        {
+            WebRtc_UWord32 numberOfCores = CpuInfo::DetectNumberOfCores();
+            _numberOfSocketMgr = numberOfCores > 0 ?
+                static_cast<WebRtc_UWord8>(
+                    numberOfCores < MAX_NUMBER_OF_SOCKET_MANAGERS_EPOLL ?
+                    numberOfCores : MAX_NUMBER_OF_SOCKET_MANAGERS_EPOLL) : 1;
+        }
+        if(MAX_NUMBER_OF_SOCKET_MANAGERS_EPOLL < _numberOfSocketMgr)
+        {
+            _numberOfSocketMgr = MAX_NUMBER_OF_SOCKET_MANAGERS_EPOLL;
+        }
+    } else {
+        if(_numberOfSocketMgr == 0)
+        {
+            _numberOfSocketMgr = 1;
+        }
+        if(MAX_NUMBER_OF_SOCKET_MANAGERS_LINUX < _numberOfSocketMgr)
+        {
+            _numberOfSocketMgr = MAX_NUMBER_OF_SOCKET_MANAGERS_LINUX;
+        }
     }
+    _numOfWorkThreads = _numberOfSocketMgr;
+    numOfWorkThreads = _numberOfSocketMgr;
+
     for(int i = 0;i < _numberOfSocketMgr; i++)
     {
-        _socketMgr[i] = new UdpSocketManagerPosixImpl();
+        _socketMgr[i] = new UdpSocketManagerPosixImpl(_pollMethod,
+                                                      _packetPool);
     }
+    WEBRTC_TRACE(kTraceStateInfo, kTraceTransport, _id,
+                 "UdpSocketManagerPosix(%d)::Init() using %s",
+                 _numberOfSocketMgr,
+                 (_pollMethod == kUdpPollEpoll) ? "epoll" : "select");
     return true;
 }
 
+UdpSocketManagerPosixImpl* UdpSocketManagerPosix::SocketManagerForFd(
+    SOCKET fd) const
+{
+    // Fibonacci hashing spreads consecutive descriptors (e.g. RTP/RTCP
+    // pairs) over the loops. The same descriptor always maps to the same
+    // loop so that add and remove requests are handled in order.
+    const WebRtc_UWord32 hash =
+        static_cast<WebRtc_UWord32>(fd) * 2654435769U;
+    return _socketMgr[(hash >> 16) % _numberOfSocketMgr];
+}
+
 
 UdpSocketManagerPosix::~UdpSocketManagerPosix()
 {
@@ -67,6 +120,8 @@ UdpSocketManagerPosix::~UdpSocketManagerPosix()
     {
         delete _socketMgr[i];
     }
+    // Buffers still referenced by the application keep the pool alive.
+    _packetPool->Release();
     delete _critSect;
 }
 
@@ -132,7 +187,8 @@ bool UdpSocketManagerPosix::AddSocket(UdpSocketWrapper* s)
                  "UdpSocketManagerPosix(%d)::AddSocket()",_numberOfSocketMgr);
 
     _critSect->Enter();
-    bool retVal = _socketMgr[_nextSocketMgrToAssign]->AddSocket(s);
+    bool retVal = SocketManagerForFd(
+        static_cast<UdpSocketPosix*>(s)->GetFd())->AddSocket(s);
     if(!retVal)
     {
         WEBRTC_TRACE(
@@ -143,24 +199,17 @@ bool UdpSocketManagerPosix::AddSocket(UdpSocketWrapper* s)
  manager",
             _numberOfSocketMgr);
     }
-
-    // Distribute sockets on UdpSocketManagerPosixImpls in a round-robin
-    // fashion.
-    if(_incSocketMgrNextTime == 0)
-    {
-        _incSocketMgrNextTime++;
-    } else {
-        _incSocketMgrNextTime = 0;
-        _nextSocketMgrToAssign++;
-        if(_nextSocketMgrToAssign >= _numberOfSocketMgr)
-        {
-            _nextSocketMgrToAssign = 0;
-        }
-    }
     _critSect->Leave();
     return retVal;
 }
 
+bool UdpSocketManagerPosix::PacketBufferStatistics(
+    PacketBufferPoolStatistics& stats) const
+{
+    _packetPool->Statistics(stats);
+    return true;
+}
+
 bool UdpSocketManagerPosix::RemoveSocket(UdpSocketWrapper* s)
 {
     WEBRTC_TRACE(kTraceDebug, kTraceTransport, _id,
@@ -168,11 +217,8 @@ bool UdpSocketManagerPosix::RemoveSocket(UdpSocketWrapper* s)
                  _numberOfSocketMgr);
 
     _critSect->Enter();
-    bool retVal = false;
-    for(int i = 0;i < _numberOfSocketMgr && (retVal == false); i++)
-    {
-        retVal = _socketMgr[i]->RemoveSocket(s);
-    }
+    bool retVal = SocketManagerForFd(
+        static_cast<UdpSocketPosix*>(s)->GetFd())->RemoveSocket(s);
     if(!retVal)
     {
         WEBRTC_TRACE(
@@ -188,13 +234,31 @@ bool UdpSocketManagerPosix::RemoveSocket(UdpSocketWrapper* s)
 }
 
 
-UdpSocketManagerPosixImpl::UdpSocketManagerPosixImpl()
+UdpSocketManagerPosixImpl::UdpSocketManagerPosixImpl(
+    UdpSocketPollMethod pollMethod,
+    PacketBufferPool* packetPool)
+    : _epollFd(-1),
+      _receiveBatch(new UdpReceiveBatch(packetPool))
 {
     _critSectList = CriticalSectionWrapper::CreateCriticalSection();
     _thread = ThreadWrapper::CreateThread(UdpSocketManagerPosixImpl::Run, this,
                                           kRealtimePriority,
                                           "UdpSocketManagerPosixImplThread");
     FD_ZERO(&_readFds);
+#if defined(WEBRTC_LINUX)
+    if(pollMethod == kUdpPollEpoll)
+    {
+        _epollFd = epoll_create(MAX_NUMBER_OF_EPOLL_EVENTS);
+        if(_epollFd == -1)
+        {
+            WEBRTC_TRACE(kTraceWarning, kTraceTransport, -1,
+                         "UdpSocketManagerPosix epoll_create() failed: %d,\
+ using select()", errno);
+        } else {
+            fcntl(_epollFd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+#endif
     WEBRTC_TRACE(kTraceMemory,  kTraceTransport, -1,
                  "UdpSocketManagerPosix created");
 }
@@ -225,6 +289,12 @@ UdpSocketManagerPosixImpl::~UdpSocketManagerPosixImpl()
         delete _critSectList;
     }
 
+    if(_epollFd != -1)
+    {
+        close(_epollFd);
+    }
+    delete _receiveBatch;
+
     WEBRTC_TRACE(kTraceMemory,  kTraceTransport, -1,
                  "UdpSocketManagerPosix deleted");
 }
@@ -255,6 +325,52 @@ bool UdpSocketManagerPosixImpl::Stop()
 }
 
 bool UdpSocketManagerPosixImpl::Process()
+{
+    if(_epollFd != -1)
+    {
+        return ProcessEpoll();
+    }
+    return ProcessSelect();
+}
+
+bool UdpSocketManagerPosixImpl::ProcessEpoll()
+{
+#if defined(WEBRTC_LINUX)
+    UpdateSocketMap();
+
+    // Timeout = 10 ms, so that added and removed sockets are picked up.
+    int num = epoll_wait(_epollFd, _epollEvents, MAX_NUMBER_OF_EPOLL_EVENTS,
+                         10);
+    if(num == SOCKET_ERROR)
+    {
+        if(errno != EINTR)
+        {
+            // Timeout = 10 ms.
+            timespec t;
+            t.tv_sec = 0;
+            t.tv_nsec = 10000*1000;
+            nanosleep(&t, NULL);
+        }
+        return true;
+    }
+
+    // Sockets are only deleted by UpdateSocketMap() on this thread, after
+    // they have been removed from the epoll set, so the pointers are valid.
+    for(int i = 0; i < num; i++)
+    {
+        UdpSocketPosix* s =
+            static_cast<UdpSocketPosix*>(_epollEvents[i].data.ptr);
+        // Edge-triggered: drain the socket, no new event is reported for
+        // datagrams that were already queued.
+        while(s->HasIncoming(_receiveBatch))
+        {
+        }
+    }
+#endif
+    return true;
+}
+
+bool UdpSocketManagerPosixImpl::ProcessSelect()
 {
     bool doSelect = false;
     // Timeout = 1 second.
@@ -308,7 +424,7 @@ bool UdpSocketManagerPosixImpl::Process()
         UdpSocketPosix* s = static_cast<UdpSocketPosix*>(it->GetItem());
         if (FD_ISSET(it->GetUnsignedId(), &_readFds))
         {
-            s->HasIncoming();
+            s->HasIncoming(_receiveBatch);
             num--;
         }
     }
@@ -325,7 +441,11 @@ bool UdpSocketManagerPosixImpl::Run(ThreadObj obj)
 bool UdpSocketManagerPosixImpl::AddSocket(UdpSocketWrapper* s)
 {
     UdpSocketPosix* sl = static_cast<UdpSocketPosix*>(s);
-    if(sl->GetFd() == INVALID_SOCKET || !(sl->GetFd() < FD_SETSIZE))
+    if(sl->GetFd() == INVALID_SOCKET)
+    {
+        return false;
+    }
+    if(_epollFd == -1 && !(sl->GetFd() < FD_SETSIZE))
     {
         return false;
     }
@@ -404,6 +524,15 @@ void UdpSocketManagerPosixImpl::UpdateSocketMap()
                 deleteSocket = socket;
             }
             _socketMap.Erase(it);
+#if defined(WEBRTC_LINUX)
+            if(_epollFd != -1)
+            {
+                // Pre 2.6.9 kernels require a non-NULL event for DEL.
+                epoll_event event;
+                memset(&event, 0, sizeof(event));
+                epoll_ctl(_epollFd, EPOLL_CTL_DEL, removeFD, &event);
+            }
+#endif
         }
         if(deleteSocket)
         {
@@ -420,6 +549,22 @@ void UdpSocketManagerPosixImpl::UpdateSocketMap()
             static_cast<UdpSocketPosix*>(_addList.First()->GetItem());
         if(s)
         {
+#if defined(WEBRTC_LINUX)
+            if(_epollFd != -1)
+            {
+                epoll_event event;
+                memset(&event, 0, sizeof(event));
+                event.events = EPOLLIN | EPOLLET;
+                event.data.ptr = s;
+                if(epoll_ctl(_epollFd, EPOLL_CTL_ADD, s->GetFd(), &event) ==
+                   SOCKET_ERROR)
+                {
+                    WEBRTC_TRACE(kTraceError, kTraceTransport, -1,
+                                 "UdpSocketManagerPosix epoll_ctl() failed:\
+ %d", errno);
+                }
+            }
+#endif
             _socketMap.Insert(s->GetFd(), s);
         }
         _addList.PopFront();
@@ -13,6 +13,9 @@
 
 #include <sys/types.h>
 #include <unistd.h>
+#if defined(WEBRTC_LINUX)
+#include <sys/epoll.h>
+#endif
 
 #include "critical_section_wrapper.h"
 #include "list_wrapper.h"
@@ -22,18 +25,40 @@
 #include "udp_socket_wrapper.h"
 
 #define MAX_NUMBER_OF_SOCKET_MANAGERS_LINUX 8
+// The epoll backend is not limited by FD_SETSIZE and runs one loop per core.
+#define MAX_NUMBER_OF_SOCKET_MANAGERS_EPOLL 64
+// Maximum number of ready sockets returned by a single epoll_wait() call.
+#define MAX_NUMBER_OF_EPOLL_EVENTS 256
 
 namespace webrtc {
 
 class ConditionVariableWrapper;
+class PacketBufferPool;
+class UdpReceiveBatch;
 class UdpSocketManagerPosixImpl;
 
+enum UdpSocketPollMethod
+{
+    kUdpPollSelect = 0,
+    // Edge-triggered epoll. Only available on Linux, falls back to select()
+    // elsewhere or if the epoll instance can't be created.
+    kUdpPollEpoll  = 1
+};
+
 class UdpSocketManagerPosix : public UdpSocketManager
 {
 public:
-    UdpSocketManagerPosix();
+#if defined(WEBRTC_LINUX)
+    explicit UdpSocketManagerPosix(
+        UdpSocketPollMethod pollMethod = kUdpPollEpoll);
+#else
+    explicit UdpSocketManagerPosix(
+        UdpSocketPollMethod pollMethod = kUdpPollSelect);
+#endif
     virtual ~UdpSocketManagerPosix();
 
+    // If numOfWorkThreads is 0 and epoll is used one socket loop per core is
+    // created. numOfWorkThreads is set to the number of loops actually used.
     virtual bool Init(WebRtc_Word32 id,
                       WebRtc_UWord8& numOfWorkThreads);
 
@@ -44,19 +69,31 @@ public:
 
     virtual bool AddSocket(UdpSocketWrapper* s);
     virtual bool RemoveSocket(UdpSocketWrapper* s);
+
+    virtual bool PacketBufferStatistics(
+        PacketBufferPoolStatistics& stats) const;
+
+    UdpSocketPollMethod PollMethod() const {return _pollMethod;}
 private:
+    // Returns the socket loop that sockets with file descriptor fd are
+    // pinned to.
+    UdpSocketManagerPosixImpl* SocketManagerForFd(SOCKET fd) const;
+
     WebRtc_Word32 _id;
     CriticalSectionWrapper* _critSect;
+    UdpSocketPollMethod _pollMethod;
+    // Incoming packets of all socket loops are read into buffers from this
+    // pool.
+    PacketBufferPool* _packetPool;
     WebRtc_UWord8 _numberOfSocketMgr;
-    WebRtc_UWord8 _incSocketMgrNextTime;
-    WebRtc_UWord8 _nextSocketMgrToAssign;
-    UdpSocketManagerPosixImpl* _socketMgr[MAX_NUMBER_OF_SOCKET_MANAGERS_LINUX];
+    UdpSocketManagerPosixImpl* _socketMgr[MAX_NUMBER_OF_SOCKET_MANAGERS_EPOLL];
 };
 
 class UdpSocketManagerPosixImpl
 {
 public:
-    UdpSocketManagerPosixImpl();
+    UdpSocketManagerPosixImpl(UdpSocketPollMethod pollMethod,
+                              PacketBufferPool* packetPool);
     virtual ~UdpSocketManagerPosixImpl();
 
     virtual bool Start();
@@ -68,6 +105,8 @@ public:
 protected:
     static bool Run(ThreadObj obj);
     bool Process();
+    bool ProcessSelect();
+    bool ProcessEpoll();
     void UpdateSocketMap();
 
 private:
@@ -76,6 +115,14 @@ private:
 
     fd_set _readFds;
 
+    // -1 if select() is used.
+    int _epollFd;
+    // Buffers for batched reads, shared by all sockets of this loop.
+    UdpReceiveBatch* _receiveBatch;
+#if defined(WEBRTC_LINUX)
+    epoll_event _epollEvents[MAX_NUMBER_OF_EPOLL_EVENTS];
+#endif
+
     MapWrapper _socketMap;
     ListWrapper _addList;
     ListWrapper _removeList;
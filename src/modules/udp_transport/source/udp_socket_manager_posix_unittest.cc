@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Compares the select() and epoll socket loops of UdpSocketManagerPosix.
+// Packets are sent over loopback to a set of sockets and the receive rate and
+// the send-to-callback (wakeup) latency are reported.
+
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "critical_section_wrapper.h"
+#include "tick_util.h"
+#include "udp_socket_manager_posix.h"
+#include "udp_socket_posix.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumberOfSockets = 256;
+const int kPacketsPerSocket = 40;
+const int kPacketSize = 172;  // 20 ms G.711 RTP packet.
+
+class ReceiveStats
+{
+public:
+    ReceiveStats()
+        : _crit(CriticalSectionWrapper::CreateCriticalSection()),
+          _received(0),
+          _totalLatencyUs(0),
+          _maxLatencyUs(0)
+    {
+    }
+    ~ReceiveStats()
+    {
+        delete _crit;
+    }
+
+    static void OnIncoming(CallbackObj obj, const WebRtc_Word8* buf,
+                           WebRtc_Word32 len, const SocketAddress* /*from*/,
+                           PacketBuffer* /*packet*/)
+    {
+        ReceiveStats* stats = static_cast<ReceiveStats*>(obj);
+        WebRtc_Word64 sentUs = 0;
+        if (len >= static_cast<WebRtc_Word32>(sizeof(sentUs)))
+        {
+            memcpy(&sentUs, buf, sizeof(sentUs));
+        }
+        const WebRtc_Word64 latencyUs =
+            TickTime::MicrosecondTimestamp() - sentUs;
+        CriticalSectionScoped cs(stats->_crit);
+        stats->_received++;
+        stats->_totalLatencyUs += latencyUs;
+        if (latencyUs > stats->_maxLatencyUs)
+        {
+            stats->_maxLatencyUs = latencyUs;
+        }
+    }
+
+    int Received() const
+    {
+        CriticalSectionScoped cs(_crit);
+        return _received;
+    }
+    WebRtc_Word64 AverageLatencyUs() const
+    {
+        CriticalSectionScoped cs(_crit);
+        return _received > 0 ? _totalLatencyUs / _received : 0;
+    }
+    WebRtc_Word64 MaxLatencyUs() const
+    {
+        CriticalSectionScoped cs(_crit);
+        return _maxLatencyUs;
+    }
+
+private:
+    CriticalSectionWrapper* _crit;
+    int _received;
+    WebRtc_Word64 _totalLatencyUs;
+    WebRtc_Word64 _maxLatencyUs;
+};
+
+void RunBenchmark(UdpSocketPollMethod pollMethod, const char* name)
+{
+    UdpSocketManagerPosix* mgr = new UdpSocketManagerPosix(pollMethod);
+    WebRtc_UWord8 numOfWorkThreads = 0;
+    ASSERT_TRUE(mgr->Init(0, numOfWorkThreads));
+    ASSERT_GT(numOfWorkThreads, 0);
+    ASSERT_TRUE(mgr->Start());
+
+    ReceiveStats stats;
+    std::vector<UdpSocketPosix*> sockets;
+    std::vector<SocketAddress> addresses;
+    for (int i = 0; i < kNumberOfSockets; i++)
+    {
+        UdpSocketPosix* s = new UdpSocketPosix(0, mgr);
+        SocketAddress address;
+        memset(&address, 0, sizeof(address));
+        address._sockaddr_in.sin_family = AF_INET;
+        address._sockaddr_in.sin_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_TRUE(s->Bind(address));
+
+        sockaddr_in bound;
+        socklen_t boundLen = sizeof(bound);
+        ASSERT_EQ(0, getsockname(s->GetFd(),
+                                 reinterpret_cast<sockaddr*>(&bound),
+                                 &boundLen));
+        address._sockaddr_in.sin_port = bound.sin_port;
+
+        ASSERT_TRUE(s->StartReceiving());
+        ASSERT_TRUE(s->SetCallback(&stats, ReceiveStats::OnIncoming));
+        sockets.push_back(s);
+        addresses.push_back(address);
+    }
+    // Let the socket loops pick up the new sockets.
+    usleep(50 * 1000);
+
+    WebRtc_Word8 packet[kPacketSize];
+    memset(packet, 0, sizeof(packet));
+    const int expected = kNumberOfSockets * kPacketsPerSocket;
+    const TickTime start = TickTime::Now();
+    for (int n = 0; n < kPacketsPerSocket; n++)
+    {
+        for (int i = 0; i < kNumberOfSockets; i++)
+        {
+            const WebRtc_Word64 nowUs = TickTime::MicrosecondTimestamp();
+            memcpy(packet, &nowUs, sizeof(nowUs));
+            sockets[(i + 1) % kNumberOfSockets]->SendTo(packet, kPacketSize,
+                                                        addresses[i]);
+        }
+        // Pace the bursts so that the loopback socket buffers don't overflow.
+        usleep(1000);
+    }
+    for (int wait = 0; wait < 200 && stats.Received() < expected; wait++)
+    {
+        usleep(10 * 1000);
+    }
+    const WebRtc_Word64 elapsedMs = (TickTime::Now() - start).Milliseconds();
+
+    printf("%-6s: %d loops, %d sockets, received %d/%d packets, "
+           "%.0f packets/s, wakeup latency avg %lld us max %lld us\n",
+           name, numOfWorkThreads, kNumberOfSockets, stats.Received(),
+           expected,
+           elapsedMs > 0 ? 1000.0 * stats.Received() / elapsedMs : 0.0,
+           static_cast<long long>(stats.AverageLatencyUs()),
+           static_cast<long long>(stats.MaxLatencyUs()));
+    EXPECT_GT(stats.Received(), 0);
+
+    for (int i = 0; i < kNumberOfSockets; i++)
+    {
+        // The socket is deleted by the socket manager.
+        sockets[i]->CloseBlocking();
+    }
+    EXPECT_TRUE(mgr->Stop());
+    delete mgr;
+}
+
+}  // namespace
+
+TEST(UdpSocketManagerPosixTest, SelectThroughputAndLatency) {
+  RunBenchmark(kUdpPollSelect, "select");
+}
+
+#if defined(WEBRTC_LINUX)
+TEST(UdpSocketManagerPosixTest, EpollThroughputAndLatency) {
+  RunBenchmark(kUdpPollEpoll, "epoll");
+}
+
+TEST(UdpSocketManagerPosixTest, EpollOneLoopPerCore) {
+  UdpSocketManagerPosix* mgr = new UdpSocketManagerPosix(kUdpPollEpoll);
+  WebRtc_UWord8 numOfWorkThreads = 0;
+  ASSERT_TRUE(mgr->Init(0, numOfWorkThreads));
+  EXPECT_GE(numOfWorkThreads, 1);
+  EXPECT_LE(numOfWorkThreads, MAX_NUMBER_OF_SOCKET_MANAGERS_EPOLL);
+  EXPECT_EQ(numOfWorkThreads, mgr->WorkThreads());
+  delete mgr;
+}
+#endif
+
+}  // namespace webrtc
@@ -16,6 +16,7 @@
 
 namespace webrtc {
 
+struct PacketBufferPoolStatistics;
 class UdpSocketWrapper;
 
 class UdpSocketManager
@@ -45,6 +46,11 @@ public:
     // Unregister a socket from the manager.
     virtual bool RemoveSocket(UdpSocketWrapper* s) = 0;
 
+    // Retrieve statistics for the pool that incoming packets are read into.
+    // Returns false if the manager doesn't read into pooled buffers.
+    virtual bool PacketBufferStatistics(
+        PacketBufferPoolStatistics& /*stats*/) const {return false;}
+
 protected:
     UdpSocketManager();
     virtual ~UdpSocketManager() {}
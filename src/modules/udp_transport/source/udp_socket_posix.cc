@@ -24,6 +24,78 @@
 #include "udp_socket_wrapper.h"
 
 namespace webrtc {
+namespace {
+void AddToHistogram(WebRtc_UWord32* histogram, WebRtc_UWord32 batchSize)
+{
+    int bin = 0;
+    while((batchSize >>= 1) != 0 && bin < kUdpBatchHistogramBins - 1)
+    {
+        bin++;
+    }
+    histogram[bin]++;
+}
+} // namespace
+
+UdpReceiveBatch::UdpReceiveBatch(PacketBufferPool* pool)
+    : pool(pool)
+{
+    pool->AddRef();
+    memset(packet, 0, sizeof(packet));
+    memset(from, 0, sizeof(from));
+#if defined(WEBRTC_LINUX)
+    memset(msgs, 0, sizeof(msgs));
+    for(int i = 0; i < UdpTransport::kMaxBatchSize; i++)
+    {
+        iov[i].iov_base = NULL;
+        iov[i].iov_len = 0;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &from[i];
+    }
+#endif
+}
+
+UdpReceiveBatch::~UdpReceiveBatch()
+{
+    for(int i = 0; i < UdpTransport::kMaxBatchSize; i++)
+    {
+        if(packet[i])
+        {
+            packet[i]->Release();
+        }
+    }
+    pool->Release();
+}
+
+WebRtc_UWord32 UdpReceiveBatch::Fill(WebRtc_UWord32 num)
+{
+    for(WebRtc_UWord32 i = 0; i < num; i++)
+    {
+        if(packet[i] == NULL)
+        {
+            packet[i] = pool->Acquire();
+            if(packet[i] == NULL)
+            {
+                return i;
+            }
+#if defined(WEBRTC_LINUX)
+            iov[i].iov_base = packet[i]->Data();
+            iov[i].iov_len = packet[i]->Capacity();
+#endif
+        }
+    }
+    return num;
+}
+
+void UdpReceiveBatch::Recycle(WebRtc_UWord32 i)
+{
+    if(!packet[i]->HasOneRef())
+    {
+        packet[i]->Release();
+        packet[i] = NULL;
+    }
+}
+
 UdpSocketPosix::UdpSocketPosix(const WebRtc_Word32 id, UdpSocketManager* mgr,
                                bool ipV6Enable)
 {
@@ -44,6 +116,8 @@ UdpSocketPosix::UdpSocketPosix(const WebRtc_Word32 id, UdpSocketManager* mgr,
     _readyForDeletion = false;
     _closeBlockingActive = false;
     _closeBlockingCompleted= false;
+    _receiveBatchSize = 1;
+    memset(&_batchStats, 0, sizeof(_batchStats));
     if(ipV6Enable)
     {
         _socket = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
@@ -158,19 +232,117 @@ WebRtc_Word32 UdpSocketPosix::SendTo(const WebRtc_Word8* buf, WebRtc_Word32 len,
         _error = errno;
         WEBRTC_TRACE(kTraceError, kTraceTransport, _id,
                      "UdpSocketPosix::SendTo() error: %d", _error);
+    } else {
+        _batchStats.sendCalls++;
+        _batchStats.sentPackets++;
+        AddToHistogram(_batchStats.sendBatchHistogram, 1);
     }
 
     return retVal;
 }
 
+WebRtc_Word32 UdpSocketPosix::SendToBatch(const WebRtc_Word8* const* bufs,
+                                          const WebRtc_Word32* lens,
+                                          WebRtc_UWord32 num,
+                                          const SocketAddress& to)
+{
+#if defined(WEBRTC_LINUX)
+    mmsghdr msgs[UdpTransport::kMaxBatchSize];
+    iovec iov[UdpTransport::kMaxBatchSize];
+    WebRtc_UWord32 sent = 0;
+    while(sent < num)
+    {
+        WebRtc_UWord32 count = num - sent;
+        if(count > UdpTransport::kMaxBatchSize)
+        {
+            count = UdpTransport::kMaxBatchSize;
+        }
+        memset(msgs, 0, count * sizeof(msgs[0]));
+        for(WebRtc_UWord32 i = 0; i < count; i++)
+        {
+            iov[i].iov_base = const_cast<WebRtc_Word8*>(bufs[sent + i]);
+            iov[i].iov_len = lens[sent + i];
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = const_cast<SocketAddress*>(&to);
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr);
+        }
+        int retVal = sendmmsg(_socket, msgs, count, 0);
+        if(retVal == SOCKET_ERROR)
+        {
+            // The remaining packets are dropped, as they would have been by
+            // SendTo().
+            _error = errno;
+            WEBRTC_TRACE(kTraceError, kTraceTransport, _id,
+                         "UdpSocketPosix::SendToBatch() error: %d", _error);
+            break;
+        }
+        _batchStats.sendCalls++;
+        _batchStats.sentPackets += retVal;
+        AddToHistogram(_batchStats.sendBatchHistogram, retVal);
+        sent += retVal;
+    }
+    return (num > 0 && sent == 0) ? -1 : static_cast<WebRtc_Word32>(sent);
+#else
+    return UdpSocketWrapper::SendToBatch(bufs, lens, num, to);
+#endif
+}
+
+bool UdpSocketPosix::SetReceiveBatchSize(WebRtc_UWord32 batchSize)
+{
+#if defined(WEBRTC_LINUX)
+    if(batchSize == 0)
+    {
+        batchSize = 1;
+    }
+    if(batchSize > UdpTransport::kMaxBatchSize)
+    {
+        batchSize = UdpTransport::kMaxBatchSize;
+    }
+    _receiveBatchSize = batchSize;
+    return true;
+#else
+    return batchSize <= 1;
+#endif
+}
+
+void UdpSocketPosix::AddBatchStatistics(UdpBatchStatistics& stats) const
+{
+    stats.receiveCalls += _batchStats.receiveCalls;
+    stats.receivedPackets += _batchStats.receivedPackets;
+    stats.sendCalls += _batchStats.sendCalls;
+    stats.sentPackets += _batchStats.sentPackets;
+    for(int i = 0; i < kUdpBatchHistogramBins; i++)
+    {
+        stats.receiveBatchHistogram[i] += _batchStats.receiveBatchHistogram[i];
+        stats.sendBatchHistogram[i] += _batchStats.sendBatchHistogram[i];
+    }
+}
+
 bool UdpSocketPosix::ValidHandle()
 {
     return _socket != INVALID_SOCKET;
 }
 
-void UdpSocketPosix::HasIncoming()
+bool UdpSocketPosix::HasIncoming(UdpReceiveBatch* batch)
 {
-    char buf[2048];
+#if defined(WEBRTC_LINUX)
+    if(batch != NULL && _receiveBatchSize > 1)
+    {
+        return HasIncomingBatch(*batch);
+    }
+#endif
+    char stackBuf[UDP_MAX_DATAGRAM_SIZE];
+    char* buf = stackBuf;
+    int bufSize = sizeof(stackBuf);
+    PacketBuffer* packet = NULL;
+    if(batch != NULL && batch->Fill(1) == 1)
+    {
+        // Read straight into a pooled buffer that the receiver can keep.
+        packet = batch->packet[0];
+        buf = reinterpret_cast<char*>(packet->Data());
+        bufSize = packet->Capacity();
+    }
     int retval;
     SocketAddress from;
 #if defined(WEBRTC_MAC_INTEL) || defined(WEBRTC_MAC)
@@ -184,12 +356,12 @@ void UdpSocketPosix::HasIncoming()
 #endif
 
 #if defined(WEBRTC_MAC_INTEL) || defined(WEBRTC_MAC)
-        retval = recvfrom(_socket,buf, sizeof(buf), 0,
+        retval = recvfrom(_socket,buf, bufSize, 0,
                           reinterpret_cast<sockaddr*>(&sockaddrfrom), &fromlen);
         memcpy(&from, &sockaddrfrom, fromlen);
         from._sockaddr_storage.sin_family = sockaddrfrom.sa_family;
 #else
-        retval = recvfrom(_socket,buf, sizeof(buf), 0,
+        retval = recvfrom(_socket,buf, bufSize, 0,
                           reinterpret_cast<sockaddr*>(&from), &fromlen);
 #endif
 
@@ -199,14 +371,66 @@ void UdpSocketPosix::HasIncoming()
         // The peer has performed an orderly shutdown.
         break;
     case SOCKET_ERROR:
-        break;
+        return false;
     default:
         if(_wantsIncoming && _incomingCb)
         {
-                _incomingCb(_obj,buf, retval, &from);
+            if(packet)
+            {
+                packet->SetLength(retval);
+            }
+            _incomingCb(_obj,buf, retval, &from, packet);
+        }
+        if(packet)
+        {
+            batch->Recycle(0);
         }
         break;
     }
+    _batchStats.receiveCalls++;
+    _batchStats.receivedPackets++;
+    AddToHistogram(_batchStats.receiveBatchHistogram, 1);
+    return true;
+}
+
+bool UdpSocketPosix::HasIncomingBatch(UdpReceiveBatch& batch)
+{
+#if defined(WEBRTC_LINUX)
+    const WebRtc_UWord32 batchSize = batch.Fill(_receiveBatchSize);
+    if(batchSize == 0)
+    {
+        return false;
+    }
+    for(WebRtc_UWord32 i = 0; i < batchSize; i++)
+    {
+        batch.msgs[i].msg_hdr.msg_namelen = sizeof(batch.from[i]);
+        batch.msgs[i].msg_len = 0;
+    }
+    int num = recvmmsg(_socket, batch.msgs, batchSize, 0, NULL);
+    if(num == SOCKET_ERROR || num == 0)
+    {
+        return false;
+    }
+    _batchStats.receiveCalls++;
+    _batchStats.receivedPackets += num;
+    AddToHistogram(_batchStats.receiveBatchHistogram, num);
+
+    for(int i = 0; i < num; i++)
+    {
+        if(_wantsIncoming && _incomingCb)
+        {
+            PacketBuffer* packet = batch.packet[i];
+            packet->SetLength(batch.msgs[i].msg_len);
+            _incomingCb(_obj, reinterpret_cast<WebRtc_Word8*>(packet->Data()),
+                        packet->Length(), &batch.from[i], packet);
+        }
+        batch.Recycle(i);
+    }
+    // A short read means that the socket receive queue is empty.
+    return static_cast<WebRtc_UWord32>(num) == batchSize;
+#else
+    return false;
+#endif
 }
 
 void UdpSocketPosix::CloseBlocking()
@@ -15,14 +15,41 @@
 #include <netinet/in.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "condition_variable_wrapper.h"
 #include "critical_section_wrapper.h"
+#include "packet_buffer_pool.h"
 #include "udp_socket_wrapper.h"
 
 #define SOCKET_ERROR -1
 
 namespace webrtc {
+// Pooled receive buffers that a socket loop reads into. A buffer stays in its
+// slot until a receiver keeps a reference to it. Only accessed from the
+// thread of the loop that owns it.
+class UdpReceiveBatch
+{
+public:
+    explicit UdpReceiveBatch(PacketBufferPool* pool);
+    ~UdpReceiveBatch();
+
+    // Makes sure that the first num slots hold a packet buffer. Returns the
+    // number of slots that do.
+    WebRtc_UWord32 Fill(WebRtc_UWord32 num);
+    // Gives up the reference to the buffer in slot i if someone else kept a
+    // reference to it. Otherwise the buffer is reused by the next read.
+    void Recycle(WebRtc_UWord32 i);
+
+    PacketBufferPool* pool;
+    PacketBuffer* packet[UdpTransport::kMaxBatchSize];
+    SocketAddress from[UdpTransport::kMaxBatchSize];
+#if defined(WEBRTC_LINUX)
+    iovec iov[UdpTransport::kMaxBatchSize];
+    mmsghdr msgs[UdpTransport::kMaxBatchSize];
+#endif
+};
+
 class UdpSocketPosix : public UdpSocketWrapper
 {
 public:
@@ -45,6 +72,15 @@ public:
     virtual WebRtc_Word32 SendTo(const WebRtc_Word8* buf, WebRtc_Word32 len,
                                  const SocketAddress& to);
 
+    virtual WebRtc_Word32 SendToBatch(const WebRtc_Word8* const* bufs,
+                                      const WebRtc_Word32* lens,
+                                      WebRtc_UWord32 num,
+                                      const SocketAddress& to);
+
+    virtual bool SetReceiveBatchSize(WebRtc_UWord32 batchSize);
+
+    virtual void AddBatchStatistics(UdpBatchStatistics& stats) const;
+
     // Deletes socket in addition to closing it.
     // TODO (hellner): make destructor protected.
     virtual void CloseBlocking();
@@ -64,12 +100,17 @@ public:
                         WebRtc_Word32 /*overrideDSCP*/) {return false;}
 
     bool CleanUp();
-    void HasIncoming();
+    // Reads one datagram from the socket, or up to the receive batch size if
+    // batched reads are enabled and batch is provided. Returns false once the
+    // socket has been drained.
+    bool HasIncoming(UdpReceiveBatch* batch = NULL);
     bool WantsIncoming() {return _wantsIncoming;}
     void ReadyForDeletion();
 private:
     friend class UdpSocketManagerPosix;
 
+    bool HasIncomingBatch(UdpReceiveBatch& batch);
+
     WebRtc_Word32 _id;
     IncomingSocketCallback _incomingCb;
     CallbackObj _obj;
@@ -85,6 +126,9 @@ private:
     bool _readyForDeletion;
 
     CriticalSectionWrapper* _cs;
+
+    WebRtc_UWord32 _receiveBatchSize;
+    UdpBatchStatistics _batchStats;
 };
 } // namespace webrtc
 
@@ -293,7 +293,7 @@ void UdpSocketWindows::HasIncoming()
         break;
     default:
         if(_wantsIncoming && _incomingCb)
-            _incomingCb(_obj,buf, retval, &from);
+            _incomingCb(_obj,buf, retval, &from, NULL);
         break;
     }
 }
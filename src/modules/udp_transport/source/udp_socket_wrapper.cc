@@ -28,13 +28,6 @@
 namespace webrtc {
 bool UdpSocketWrapper::_initiated = false;
 
-// Temporary Android hack. The value 1024 is taken from
-// <ndk>/build/platforms/android-1.5/arch-arm/usr/include/linux/posix_types.h
-// TODO (tomasl): can we remove this now?
-#ifndef FD_SETSIZE
-#define FD_SETSIZE 1024
-#endif
-
 UdpSocketWrapper::UdpSocketWrapper() : _deleteEvent(NULL)
 {
 }
@@ -48,6 +41,22 @@ UdpSocketWrapper::~UdpSocketWrapper()
     }
 }
 
+WebRtc_Word32 UdpSocketWrapper::SendToBatch(const WebRtc_Word8* const* bufs,
+                                            const WebRtc_Word32* lens,
+                                            WebRtc_UWord32 num,
+                                            const SocketAddress& to)
+{
+    WebRtc_Word32 sent = 0;
+    for(WebRtc_UWord32 i = 0; i < num; i++)
+    {
+        if(SendTo(bufs[i], lens[i], to) >= 0)
+        {
+            sent++;
+        }
+    }
+    return (num > 0 && sent == 0) ? -1 : sent;
+}
+
 void UdpSocketWrapper::SetEventToNull()
 {
     if (_deleteEvent)
@@ -114,8 +123,10 @@ UdpSocketWrapper* UdpSocketWrapper::CreateSocket(const WebRtc_Word32 id,
     s = new UdpSocketPosix(id, mgr, ipV6Enable);
     if (s)
     {
+        // The socket manager rejects descriptors it can't poll, e.g.
+        // descriptors >= FD_SETSIZE when select() is used.
         UdpSocketPosix* sl = static_cast<UdpSocketPosix*>(s);
-        if (sl->GetFd() != INVALID_SOCKET && sl->GetFd() < FD_SETSIZE)
+        if (sl->GetFd() != INVALID_SOCKET)
         {
             // ok
         } else
@@ -15,10 +15,14 @@
 
 namespace webrtc {
 class EventWrapper;
+class PacketBuffer;
 class UdpSocketManager;
 
 #define SOCKET_ERROR_NO_QOS -1000
 
+// Largest datagram that is read from a socket.
+#define UDP_MAX_DATAGRAM_SIZE 2048
+
 #ifndef _WIN32
 typedef int SOCKET;
 #endif
@@ -33,9 +37,13 @@ typedef int SOCKET;
 #endif
 
 typedef void* CallbackObj;
+// packet is the pooled buffer that buf points into, or NULL if the socket
+// implementation doesn't read into pooled buffers. The callee must AddRef()
+// packet to keep it after returning.
 typedef void(*IncomingSocketCallback)(CallbackObj obj, const WebRtc_Word8* buf,
                                       WebRtc_Word32 len,
-                                      const SocketAddress* from);
+                                      const SocketAddress* from,
+                                      PacketBuffer* packet);
 
 class UdpSocketWrapper
 {
@@ -82,6 +90,22 @@ public:
     virtual WebRtc_Word32 SendTo(const WebRtc_Word8* buf, WebRtc_Word32 len,
                                  const SocketAddress& to) = 0;
 
+    // Send the num packets in bufs, with lengths lens, to the address
+    // specified by to. Returns the number of packets sent or -1 if none could
+    // be sent.
+    virtual WebRtc_Word32 SendToBatch(const WebRtc_Word8* const* bufs,
+                                      const WebRtc_Word32* lens,
+                                      WebRtc_UWord32 num,
+                                      const SocketAddress& to);
+
+    // Read up to batchSize incoming packets per wakeup. Returns false if
+    // batched reads aren't supported by the socket.
+    virtual bool SetReceiveBatchSize(WebRtc_UWord32 /*batchSize*/)
+    {return false;}
+
+    // Add the batched I/O counters of this socket to stats.
+    virtual void AddBatchStatistics(UdpBatchStatistics& /*stats*/) const {}
+
     virtual void SetEventToNull();
 
     // Close socket and don't return until completed.
@@ -48,6 +48,7 @@
 
 #include "common_types.h"
 #include "critical_section_wrapper.h"
+#include "packet_buffer_pool.h"
 #include "rw_lock_wrapper.h"
 #include "trace.h"
 #include "typedefs.h"
@@ -75,6 +76,14 @@ WebRtc_UWord32 timeGetTime()
 #endif // defined(WEBRTC_LINUX) || defined(WEBRTC_MAC)
 
 namespace webrtc {
+void UdpTransportData::IncomingRTPPacketBuffer(PacketBuffer* packet,
+                                               const WebRtc_Word8* fromIP,
+                                               const WebRtc_UWord16 fromPort)
+{
+    IncomingRTPPacket(reinterpret_cast<const WebRtc_Word8*>(packet->Data()),
+                      packet->Length(), fromIP, fromPort);
+}
+
 UdpTransport* UdpTransport::Create(const WebRtc_Word32 id,
                                    WebRtc_UWord8& numSocketThreads)
 {
@@ -139,7 +148,11 @@ UdpTransportImpl::UdpTransportImpl(const WebRtc_Word32 id,
       _filterIPAddress(),
       _rtpFilterPort(0),
       _rtcpFilterPort(0),
-      _packetCallback(0)
+      _packetCallback(0),
+      _batchSize(0),
+      _sendQueue(NULL),
+      _sendQueueLength(),
+      _sendQueueCount(0)
 {
     memset(&_remoteRTPAddr, 0, sizeof(_remoteRTPAddr));
     memset(&_remoteRTCPAddr, 0, sizeof(_remoteRTCPAddr));
@@ -164,6 +177,7 @@ UdpTransportImpl::~UdpTransportImpl()
 {
     CloseSendSockets();
     CloseReceiveSockets();
+    delete [] _sendQueue;
     delete _crit;
     delete _critFilter;
     delete _critPacketCallback;
@@ -231,11 +245,14 @@ WebRtc_Word32 UdpTransportImpl::Version(WebRtc_Word8* version,
 
 WebRtc_Word32 UdpTransportImpl::TimeUntilNextProcess()
 {
-    return 100;
+    // Queued RTP packets are flushed by Process() in batched mode.
+    return (_batchSize > 0) ? 5 : 100;
 }
 
 WebRtc_Word32 UdpTransportImpl::Process()
 {
+    CriticalSectionScoped cs(_crit);
+    FlushSendQueue();
     return 0;
 }
 
@@ -398,6 +415,8 @@ WebRtc_Word32 UdpTransportImpl::InitializeReceiveSockets(
     _ptrRtcpSocket = UdpSocketWrapper::CreateSocket(_id, _mgr, this,
                                                     IncomingRTCPCallback,
                                                     IpV6Enabled());
+    ConfigureReceiveBatching(_ptrRtpSocket);
+    ConfigureReceiveBatching(_ptrRtcpSocket);
 
     ErrorCode retVal = BindLocalRTPSocket();
     if(retVal != kNoSocketError)
@@ -919,6 +938,8 @@ WebRtc_Word32 UdpTransportImpl::SetToS(WebRtc_Word32 DSCP, bool useSetSockOpt)
                     _ptrRtcpSocket = UdpSocketWrapper::CreateSocket(
                         _id, _mgr, this, IncomingRTCPCallback,
                         IpV6Enabled(),true);
+                    ConfigureReceiveBatching(_ptrRtpSocket);
+                    ConfigureReceiveBatching(_ptrRtcpSocket);
                     rtpSock=_ptrRtpSocket;
                     rtcpSock=_ptrRtcpSocket;
                     ErrorCode retVal = BindLocalRTPSocket();
@@ -1248,6 +1269,9 @@ bool UdpTransportImpl::IpV6Enabled() const
 
 void UdpTransportImpl::BuildRemoteRTPAddr()
 {
+    // Queued packets go to the old address.
+    FlushSendQueue();
+
     if(_ipV6Enabled)
     {
 #ifdef HAVE_STRUCT_SOCKADDR_SA_LEN
@@ -1934,6 +1958,7 @@ WebRtc_Word32 UdpTransportImpl::SendRTPPacketTo(const WebRtc_Word8* data,
 {
     WEBRTC_TRACE(kTraceModuleCall, kTraceTransport, _id, "%s", __FUNCTION__);
     CriticalSectionScoped cs(_crit);
+    FlushSendQueue();
     if(_ptrSendRtpSocket)
     {
         return _ptrSendRtpSocket->SendTo(data,length,to);
@@ -1952,6 +1977,7 @@ WebRtc_Word32 UdpTransportImpl::SendRTCPPacketTo(const WebRtc_Word8* data,
     WEBRTC_TRACE(kTraceModuleCall, kTraceTransport, _id, "%s", __FUNCTION__);
 
     CriticalSectionScoped cs(_crit);
+    FlushSendQueue();
 
     if(_ptrSendRtcpSocket)
     {
@@ -1971,6 +1997,7 @@ WebRtc_Word32 UdpTransportImpl::SendRTPPacketTo(const WebRtc_Word8* data,
     WEBRTC_TRACE(kTraceModuleCall, kTraceTransport, _id, "%s", __FUNCTION__);
 
     CriticalSectionScoped cs(_crit);
+    FlushSendQueue();
     // Use the current SocketAdress but update it with rtpPort.
     SocketAddress to;
     memcpy(&to, &_remoteRTPAddr, sizeof(SocketAddress));
@@ -2000,6 +2027,7 @@ WebRtc_Word32 UdpTransportImpl::SendRTCPPacketTo(const WebRtc_Word8* data,
 {
     WEBRTC_TRACE(kTraceModuleCall, kTraceTransport, _id, "%s", __FUNCTION__);
     CriticalSectionScoped cs(_crit);
+    FlushSendQueue();
 
     // Use the current SocketAdress but update it with rtcpPort.
     SocketAddress to;
@@ -2055,6 +2083,7 @@ int UdpTransportImpl::SendPacket(int /*channel*/, const void* data, int length)
         _ptrRtpSocket = UdpSocketWrapper::CreateSocket(_id, _mgr, this,
                                                        IncomingRTPCallback,
                                                        IpV6Enabled());
+        ConfigureReceiveBatching(_ptrRtpSocket);
 
         // Don't bind to a specific IP address.
         if(! IpV6Enabled())
@@ -2078,6 +2107,23 @@ int UdpTransportImpl::SendPacket(int /*channel*/, const void* data, int length)
         }
     }
 
+    if(_batchSize > 0)
+    {
+        if(length <= UDP_MAX_DATAGRAM_SIZE)
+        {
+            memcpy(_sendQueue + _sendQueueCount * UDP_MAX_DATAGRAM_SIZE, data,
+                   length);
+            _sendQueueLength[_sendQueueCount++] = length;
+            if(_sendQueueCount == _batchSize)
+            {
+                FlushSendQueue();
+            }
+            return length;
+        }
+        // Keep the packet order.
+        FlushSendQueue();
+    }
+
     if(_ptrSendRtpSocket)
     {
         return _ptrSendRtpSocket->SendTo((const WebRtc_Word8*)data, length,
@@ -2122,6 +2168,7 @@ int UdpTransportImpl::SendRTCPPacket(int /*channel*/, const void* data,
         _ptrRtcpSocket = UdpSocketWrapper::CreateSocket(_id, _mgr, this,
                                                         IncomingRTCPCallback,
                                                         IpV6Enabled());
+        ConfigureReceiveBatching(_ptrRtcpSocket);
 
         // Don't bind to a specific IP address.
         if(! IpV6Enabled())
@@ -2145,6 +2192,8 @@ int UdpTransportImpl::SendRTCPPacket(int /*channel*/, const void* data,
         }
     }
 
+    // Don't let RTCP overtake RTP packets waiting in the send queue.
+    FlushSendQueue();
     if(_ptrSendRtcpSocket)
     {
         return _ptrSendRtcpSocket->SendTo((const WebRtc_Word8*)data, length,
@@ -2192,19 +2241,22 @@ WebRtc_Word32 UdpTransportImpl::SetSendPorts(WebRtc_UWord16 rtpPort,
 void UdpTransportImpl::IncomingRTPCallback(CallbackObj obj,
                                            const WebRtc_Word8* rtpPacket,
                                            WebRtc_Word32 rtpPacketLength,
-                                           const SocketAddress* from)
+                                           const SocketAddress* from,
+                                           PacketBuffer* packet)
 {
     if (rtpPacket && rtpPacketLength > 0)
     {
         UdpTransportImpl* socketTransport = (UdpTransportImpl*) obj;
-        socketTransport->IncomingRTPFunction(rtpPacket, rtpPacketLength, from);
+        socketTransport->IncomingRTPFunction(rtpPacket, rtpPacketLength, from,
+                                             packet);
     }
 }
 
 void UdpTransportImpl::IncomingRTCPCallback(CallbackObj obj,
                                             const WebRtc_Word8* rtcpPacket,
                                             WebRtc_Word32 rtcpPacketLength,
-                                            const SocketAddress* from)
+                                            const SocketAddress* from,
+                                            PacketBuffer* /*packet*/)
 {
     if (rtcpPacket && rtcpPacketLength > 0)
     {
@@ -2216,7 +2268,8 @@ void UdpTransportImpl::IncomingRTCPCallback(CallbackObj obj,
 
 void UdpTransportImpl::IncomingRTPFunction(const WebRtc_Word8* rtpPacket,
                                            WebRtc_Word32 rtpPacketLength,
-                                           const SocketAddress* fromSocket)
+                                           const SocketAddress* fromSocket,
+                                           PacketBuffer* packet)
 {
     WebRtc_Word8 ipAddress[kIpAddressVersion6Length];
     WebRtc_UWord32 ipAddressLength = kIpAddressVersion6Length;
@@ -2270,8 +2323,14 @@ void UdpTransportImpl::IncomingRTPFunction(const WebRtc_Word8* rtpPacket,
     {
         WEBRTC_TRACE(kTraceStream, kTraceTransport, _id,
             "Incoming RTP packet from ip:%s port:%d", ipAddress, portNr);
-        _packetCallback->IncomingRTPPacket(rtpPacket, rtpPacketLength,
-                                           ipAddress, portNr);
+        if (packet)
+        {
+            _packetCallback->IncomingRTPPacketBuffer(packet, ipAddress,
+                                                     portNr);
+        } else {
+            _packetCallback->IncomingRTPPacket(rtpPacket, rtpPacketLength,
+                                               ipAddress, portNr);
+        }
     }
 }
 
@@ -2377,6 +2436,7 @@ bool UdpTransportImpl::FilterIPAddress(const SocketAddress* fromAddress)
 
 void UdpTransportImpl::CloseReceiveSockets()
 {
+    FlushSendQueue();
     if(_ptrRtpSocket)
     {
         _ptrRtpSocket->CloseBlocking();
@@ -2392,6 +2452,7 @@ void UdpTransportImpl::CloseReceiveSockets()
 
 void UdpTransportImpl::CloseSendSockets()
 {
+    FlushSendQueue();
     if(_ptrSendRtpSocket)
     {
         _ptrSendRtpSocket->CloseBlocking();
@@ -2404,6 +2465,108 @@ void UdpTransportImpl::CloseSendSockets()
     }
 }
 
+WebRtc_Word32 UdpTransportImpl::EnableBatchedIO(
+    const bool enable,
+    const WebRtc_UWord32 maxBatchSize)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceTransport, _id,
+                 "EnableBatchedIO(enable:%d, maxBatchSize:%u)", enable,
+                 maxBatchSize);
+
+    CriticalSectionScoped cs(_crit);
+    FlushSendQueue();
+    delete [] _sendQueue;
+    _sendQueue = NULL;
+    _batchSize = 0;
+
+    if(enable && maxBatchSize > 1)
+    {
+        _batchSize = maxBatchSize < static_cast<WebRtc_UWord32>(kMaxBatchSize) ?
+            maxBatchSize : static_cast<WebRtc_UWord32>(kMaxBatchSize);
+        _sendQueue = new WebRtc_Word8[_batchSize * UDP_MAX_DATAGRAM_SIZE];
+    }
+    ConfigureReceiveBatching(_ptrRtpSocket);
+    ConfigureReceiveBatching(_ptrRtcpSocket);
+    return 0;
+}
+
+WebRtc_Word32 UdpTransportImpl::FlushPackets()
+{
+    CriticalSectionScoped cs(_crit);
+    return FlushSendQueue();
+}
+
+WebRtc_Word32 UdpTransportImpl::BatchStatistics(
+    UdpBatchStatistics& stats) const
+{
+    CriticalSectionScoped cs(_crit);
+    memset(&stats, 0, sizeof(stats));
+    if(_ptrRtpSocket)
+    {
+        _ptrRtpSocket->AddBatchStatistics(stats);
+    }
+    if(_ptrRtcpSocket)
+    {
+        _ptrRtcpSocket->AddBatchStatistics(stats);
+    }
+    if(_ptrSendRtpSocket)
+    {
+        _ptrSendRtpSocket->AddBatchStatistics(stats);
+    }
+    if(_ptrSendRtcpSocket)
+    {
+        _ptrSendRtcpSocket->AddBatchStatistics(stats);
+    }
+    return 0;
+}
+
+WebRtc_Word32 UdpTransportImpl::PacketBufferStatistics(
+    PacketBufferPoolStatistics& stats) const
+{
+    if(_mgr == NULL || !_mgr->PacketBufferStatistics(stats))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+void UdpTransportImpl::ConfigureReceiveBatching(UdpSocketWrapper* socket)
+{
+    if(socket == NULL)
+    {
+        return;
+    }
+    if(!socket->SetReceiveBatchSize(_batchSize > 0 ? _batchSize : 1) &&
+       _batchSize > 0)
+    {
+        WEBRTC_TRACE(kTraceWarning, kTraceTransport, _id,
+                     "Batched receive not supported by socket");
+    }
+}
+
+WebRtc_Word32 UdpTransportImpl::FlushSendQueue()
+{
+    if(_sendQueueCount == 0)
+    {
+        return 0;
+    }
+    UdpSocketWrapper* socket =
+        _ptrSendRtpSocket ? _ptrSendRtpSocket : _ptrRtpSocket;
+    WebRtc_Word32 retVal = -1;
+    if(socket)
+    {
+        const WebRtc_Word8* packets[kMaxBatchSize];
+        for(WebRtc_UWord32 i = 0; i < _sendQueueCount; i++)
+        {
+            packets[i] = _sendQueue + i * UDP_MAX_DATAGRAM_SIZE;
+        }
+        retVal = socket->SendToBatch(packets, _sendQueueLength,
+                                     _sendQueueCount, _remoteRTPAddr);
+    }
+    _sendQueueCount = 0;
+    return retVal;
+}
+
 WebRtc_UWord16 UdpTransport::Htons(const WebRtc_UWord16 port)
 {
     return htons(port);
@@ -90,6 +90,13 @@ public:
         const WebRtc_UWord32 numberOfSocketBuffers);
     virtual WebRtc_Word32 StopReceiving();
     virtual bool Receiving() const;
+    virtual WebRtc_Word32 EnableBatchedIO(
+        const bool enable,
+        const WebRtc_UWord32 maxBatchSize = kMaxBatchSize);
+    virtual WebRtc_Word32 FlushPackets();
+    virtual WebRtc_Word32 BatchStatistics(UdpBatchStatistics& stats) const;
+    virtual WebRtc_Word32 PacketBufferStatistics(
+        PacketBufferPoolStatistics& stats) const;
     virtual bool SendSocketsInitialized() const;
     virtual bool SourcePortsInitialized() const;
     virtual bool ReceiveSocketsInitialized() const;
@@ -132,15 +139,22 @@ protected:
     static void IncomingRTPCallback(CallbackObj obj,
                                     const WebRtc_Word8* rtpPacket,
                                     WebRtc_Word32 rtpPacketLength,
-                                    const SocketAddress* from);
+                                    const SocketAddress* from,
+                                    PacketBuffer* packet);
     static void IncomingRTCPCallback(CallbackObj obj,
                                      const WebRtc_Word8* rtcpPacket,
                                      WebRtc_Word32 rtcpPacketLength,
-                                     const SocketAddress* from);
+                                     const SocketAddress* from,
+                                     PacketBuffer* packet);
 
     void CloseSendSockets();
     void CloseReceiveSockets();
 
+    // Applies the receive batch size to a newly created receive socket.
+    void ConfigureReceiveBatching(UdpSocketWrapper* socket);
+    // Sends the RTP packets queued by SendPacket(..). _crit must be held.
+    WebRtc_Word32 FlushSendQueue();
+
     // Update _remoteRTPAddr according to _destPort and _destIP
     void BuildRemoteRTPAddr();
     // Update _remoteRTCPAddr according to _destPortRTCP and _destIP
@@ -157,7 +171,8 @@ protected:
 
     void IncomingRTPFunction(const WebRtc_Word8* rtpPacket,
                              WebRtc_Word32 rtpPacketLength,
-                             const SocketAddress* from);
+                             const SocketAddress* from,
+                             PacketBuffer* packet);
     void IncomingRTCPFunction(const WebRtc_Word8* rtcpPacket,
                               WebRtc_Word32 rtcpPacketLength,
                               const SocketAddress* from);
@@ -245,6 +260,13 @@ private:
     WebRtc_UWord16 _rtcpFilterPort;
 
     UdpTransportData* _packetCallback;
+
+    // Batched I/O. _batchSize is 0 when disabled. _sendQueue holds
+    // _batchSize slots of UDP_MAX_DATAGRAM_SIZE bytes.
+    WebRtc_UWord32 _batchSize;
+    WebRtc_Word8* _sendQueue;
+    WebRtc_Word32 _sendQueueLength[kMaxBatchSize];
+    WebRtc_UWord32 _sendQueueCount;
 };
 } // namespace webrtc
 
@@ -15,3 +15,214 @@
 #include "gtest/gtest.h"
 
 TEST(UDPTransportTest, EmptyTestToGetCodeCoverage) {}
+
+#if defined(WEBRTC_LINUX)
+#include <string.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "critical_section_wrapper.h"
+#include "packet_buffer_pool.h"
+
+namespace {
+
+class PacketCounter : public webrtc::UdpTransportData
+{
+public:
+    PacketCounter()
+        : _crit(webrtc::CriticalSectionWrapper::CreateCriticalSection()),
+          _rtpPackets(0)
+    {
+    }
+    virtual ~PacketCounter()
+    {
+        delete _crit;
+    }
+    virtual void IncomingRTPPacket(const WebRtc_Word8* /*rtpPacket*/,
+                                   const WebRtc_Word32 /*rtpPacketLength*/,
+                                   const WebRtc_Word8* /*fromIP*/,
+                                   const WebRtc_UWord16 /*fromPort*/)
+    {
+        webrtc::CriticalSectionScoped cs(_crit);
+        _rtpPackets++;
+    }
+    virtual void IncomingRTCPPacket(const WebRtc_Word8* /*rtcpPacket*/,
+                                    const WebRtc_Word32 /*rtcpPacketLength*/,
+                                    const WebRtc_Word8* /*fromIP*/,
+                                    const WebRtc_UWord16 /*fromPort*/)
+    {
+    }
+    int RtpPackets()
+    {
+        webrtc::CriticalSectionScoped cs(_crit);
+        return _rtpPackets;
+    }
+
+private:
+    webrtc::CriticalSectionWrapper* _crit;
+    int _rtpPackets;
+};
+
+// Keeps a reference to every received packet instead of copying it.
+class PacketKeeper : public PacketCounter
+{
+public:
+    PacketKeeper()
+        : _critPackets(
+              webrtc::CriticalSectionWrapper::CreateCriticalSection())
+    {
+    }
+    virtual ~PacketKeeper()
+    {
+        ReleaseAll();
+        delete _critPackets;
+    }
+    virtual void IncomingRTPPacketBuffer(webrtc::PacketBuffer* packet,
+                                         const WebRtc_Word8* fromIP,
+                                         const WebRtc_UWord16 fromPort)
+    {
+        packet->AddRef();
+        {
+            webrtc::CriticalSectionScoped cs(_critPackets);
+            _packets.push_back(packet);
+        }
+        PacketCounter::IncomingRTPPacketBuffer(packet, fromIP, fromPort);
+    }
+    void ReleaseAll()
+    {
+        webrtc::CriticalSectionScoped cs(_critPackets);
+        for (size_t i = 0; i < _packets.size(); ++i)
+        {
+            _packets[i]->Release();
+        }
+        _packets.clear();
+    }
+
+private:
+    webrtc::CriticalSectionWrapper* _critPackets;
+    std::vector<webrtc::PacketBuffer*> _packets;
+};
+
+}  // namespace
+
+TEST(UDPTransportTest, ReceiverKeepsPooledPackets) {
+  const WebRtc_UWord16 kPort = 22336;
+  const int kNumPackets = 64;
+
+  WebRtc_UWord8 numberOfSocketThreads = 1;
+  webrtc::UdpTransport* transport =
+      webrtc::UdpTransport::Create(0, numberOfSocketThreads);
+  PacketKeeper keeper;
+  ASSERT_EQ(0, transport->InitializeReceiveSockets(&keeper, kPort,
+                                                   "127.0.0.1"));
+  ASSERT_EQ(0, transport->StartReceiving(1));
+  ASSERT_EQ(0, transport->InitializeSendSockets("127.0.0.1", kPort));
+
+  webrtc::PacketBufferPoolStatistics before;
+  ASSERT_EQ(0, transport->PacketBufferStatistics(before));
+
+  char packet[200];
+  memset(packet, 0, sizeof(packet));
+  packet[0] = static_cast<char>(0x80);  // RTP version 2.
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < kNumPackets; i++) {
+      transport->SendPacket(0, packet, sizeof(packet));
+    }
+    for (int i = 0; i < 100 && keeper.RtpPackets() < (round + 1) * kNumPackets;
+         i++) {
+      usleep(10 * 1000);
+    }
+    ASSERT_EQ((round + 1) * kNumPackets, keeper.RtpPackets());
+    // Every kept packet has its own buffer.
+    webrtc::PacketBufferPoolStatistics stats;
+    ASSERT_EQ(0, transport->PacketBufferStatistics(stats));
+    EXPECT_GE(stats.buffersInUse, before.buffersInUse + kNumPackets);
+    keeper.ReleaseAll();
+  }
+
+  // The second round is served from buffers released after the first.
+  webrtc::PacketBufferPoolStatistics after;
+  ASSERT_EQ(0, transport->PacketBufferStatistics(after));
+  EXPECT_LE(after.allocations - before.allocations,
+            static_cast<WebRtc_UWord32>(kNumPackets + 1));
+  EXPECT_GE(after.reuses - before.reuses,
+            static_cast<WebRtc_UWord32>(kNumPackets - 1));
+
+  EXPECT_EQ(0, transport->StopReceiving());
+  webrtc::UdpTransport::Destroy(transport);
+}
+
+TEST(UDPTransportTest, BatchedSendAndReceive) {
+  const WebRtc_UWord16 kPort = 22334;
+  const int kNumPackets = 128;
+  const WebRtc_UWord32 kBatchSize = 16;
+
+  WebRtc_UWord8 numberOfSocketThreads = 1;
+  webrtc::UdpTransport* transport =
+      webrtc::UdpTransport::Create(0, numberOfSocketThreads);
+  PacketCounter counter;
+  ASSERT_EQ(0, transport->EnableBatchedIO(true, kBatchSize));
+  ASSERT_EQ(0, transport->InitializeReceiveSockets(&counter, kPort,
+                                                   "127.0.0.1"));
+  ASSERT_EQ(0, transport->StartReceiving(1));
+  ASSERT_EQ(0, transport->InitializeSendSockets("127.0.0.1", kPort));
+
+  char packet[200];
+  memset(packet, 0, sizeof(packet));
+  packet[0] = static_cast<char>(0x80);  // RTP version 2.
+  for (int i = 0; i < kNumPackets; i++) {
+    EXPECT_EQ(static_cast<int>(sizeof(packet)),
+              transport->SendPacket(0, packet, sizeof(packet)));
+  }
+  transport->FlushPackets();
+  for (int i = 0; i < 100 && counter.RtpPackets() < kNumPackets; i++) {
+    usleep(10 * 1000);
+  }
+  EXPECT_EQ(kNumPackets, counter.RtpPackets());
+
+  webrtc::UdpBatchStatistics stats;
+  ASSERT_EQ(0, transport->BatchStatistics(stats));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kNumPackets), stats.sentPackets);
+  EXPECT_EQ(kNumPackets / kBatchSize, stats.sendCalls);
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kNumPackets), stats.receivedPackets);
+  EXPECT_LE(stats.receiveCalls, stats.receivedPackets);
+
+  EXPECT_EQ(0, transport->StopReceiving());
+  webrtc::UdpTransport::Destroy(transport);
+}
+
+TEST(UDPTransportTest, RtcpFlushesQueuedRtp) {
+  const WebRtc_UWord16 kPort = 22338;
+  const int kNumPackets = 3;
+
+  WebRtc_UWord8 numberOfSocketThreads = 1;
+  webrtc::UdpTransport* transport =
+      webrtc::UdpTransport::Create(0, numberOfSocketThreads);
+  PacketCounter counter;
+  ASSERT_EQ(0, transport->EnableBatchedIO(true, 16));
+  ASSERT_EQ(0, transport->InitializeReceiveSockets(&counter, kPort,
+                                                   "127.0.0.1"));
+  ASSERT_EQ(0, transport->StartReceiving(1));
+  ASSERT_EQ(0, transport->InitializeSendSockets("127.0.0.1", kPort));
+
+  char packet[200];
+  memset(packet, 0, sizeof(packet));
+  packet[0] = static_cast<char>(0x80);  // RTP version 2.
+  for (int i = 0; i < kNumPackets; i++) {
+    transport->SendPacket(0, packet, sizeof(packet));
+  }
+  webrtc::UdpBatchStatistics stats;
+  ASSERT_EQ(0, transport->BatchStatistics(stats));
+  EXPECT_EQ(0u, stats.sentPackets);
+
+  // The queued RTP packets go out before the RTCP packet.
+  EXPECT_EQ(static_cast<int>(sizeof(packet)),
+            transport->SendRTCPPacket(0, packet, sizeof(packet)));
+  ASSERT_EQ(0, transport->BatchStatistics(stats));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kNumPackets + 1), stats.sentPackets);
+
+  EXPECT_EQ(0, transport->StopReceiving());
+  webrtc::UdpTransport::Destroy(transport);
+}
+#endif  // WEBRTC_LINUX
@@ -20,6 +20,10 @@ class ProcessThread
 {
 public:
     static ProcessThread* CreateProcessThread();
+    // Creates a process thread that spreads its modules over
+    // numberOfThreads threads. A module is always processed by the same
+    // thread, but modules on different threads are processed concurrently.
+    static ProcessThread* CreateProcessThread(WebRtc_UWord32 numberOfThreads);
     static void DestroyProcessThread(ProcessThread* module);
 
     virtual WebRtc_Word32 Start() = 0;
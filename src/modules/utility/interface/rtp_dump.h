@@ -33,7 +33,8 @@ public:
     // Note: this API also adds the rtpplay header.
     virtual WebRtc_Word32 Start(const WebRtc_Word8* fileNameUTF8) = 0;
 
-    // Close the existing file. No more packets will be recorded.
+    // Close the existing file. No more packets will be recorded. Returns -1,
+    // and keeps the file open, if the file writer thread could not be stopped.
     virtual WebRtc_Word32 Stop() = 0;
 
     // Return true if a file is open for recording RTP/RTCP packets.
@@ -42,9 +43,24 @@ public:
     // Writes the RTP/RTCP packet in packet with length packetLength in bytes.
     // Note: packet should contain the RTP/RTCP part of the packet. I.e. the
     // first bytes of packet should be the RTP/RTCP header.
+    // The packet is queued and written to the file by a separate thread. If
+    // the queue is full the packet is dropped, see GetStatistics().
     virtual WebRtc_Word32 DumpPacket(const WebRtc_UWord8* packet,
                                      WebRtc_UWord16 packetLength) = 0;
 
+    // Limits the number of payload bytes recorded for each RTP packet to
+    // maxPayloadLength. The RTP header is always recorded and the file keeps
+    // the original length of the packet. Use 0 to record only headers and -1
+    // (the default) to record whole packets. RTCP packets are always recorded
+    // in full.
+    virtual WebRtc_Word32 SetMaxPayloadLength(
+        WebRtc_Word32 maxPayloadLength) = 0;
+
+    // Returns the number of packets queued for the file and the number of
+    // packets dropped because the queue was full, since the last Start().
+    virtual void GetStatistics(WebRtc_UWord32& packetsDumped,
+                               WebRtc_UWord32& packetsDropped) const = 0;
+
 protected:
     virtual ~RtpDump();
 };
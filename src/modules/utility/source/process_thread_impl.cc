@@ -9,10 +9,23 @@
  */
 
 #include "process_thread_impl.h"
+
+#include <algorithm>
+
 #include "module.h"
+#include "tick_util.h"
 #include "trace.h"
 
 namespace webrtc {
+namespace {
+// Don't block the thread longer than this.
+const WebRtc_Word64 kMaxWaitTimeMs = 100;
+// A module's TimeUntilNextProcess() is cached until it is due. Modules can
+// move their deadline forward at any time, so never trust the cached value
+// for longer than this.
+const WebRtc_Word32 kMaxScheduleIntervalMs = 10;
+} // namespace
+
 ProcessThread::~ProcessThread()
 {
 }
@@ -23,28 +36,41 @@ ProcessThread* ProcessThread::CreateProcessThread()
     return new ProcessThreadImpl();
 }
 
+ProcessThread* ProcessThread::CreateProcessThread(
+    WebRtc_UWord32 numberOfThreads)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
+                 "CreateProcessThread(numberOfThreads:%u)", numberOfThreads);
+    if(numberOfThreads == 0 ||
+       numberOfThreads > MAX_NUMBER_OF_PROCESS_THREADS)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
+                     "invalid number of process threads %u", numberOfThreads);
+        return NULL;
+    }
+    return new ProcessThreadImpl(numberOfThreads);
+}
+
 void ProcessThread::DestroyProcessThread(ProcessThread* module)
 {
     WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1, "DestroyProcessThread()");
     delete module;
 }
 
-ProcessThreadImpl::ProcessThreadImpl()
+ProcessThreadWorker::ProcessThreadWorker()
     : _timeEvent(*EventWrapper::Create()),
       _critSectModules(CriticalSectionWrapper::CreateCriticalSection()),
       _thread(NULL)
 {
-    WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s created", __FUNCTION__);
 }
 
-ProcessThreadImpl::~ProcessThreadImpl()
+ProcessThreadWorker::~ProcessThreadWorker()
 {
     delete _critSectModules;
     delete &_timeEvent;
-    WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s deleted", __FUNCTION__);
 }
 
-WebRtc_Word32 ProcessThreadImpl::Start()
+WebRtc_Word32 ProcessThreadWorker::Start()
 {
     CriticalSectionScoped lock(_critSectModules);
     if(_thread)
@@ -64,7 +90,7 @@ WebRtc_Word32 ProcessThreadImpl::Start()
     return -1;
 }
 
-WebRtc_Word32 ProcessThreadImpl::Stop()
+WebRtc_Word32 ProcessThreadWorker::Stop()
 {
     _critSectModules->Enter();
     if(_thread)
@@ -89,84 +115,89 @@ WebRtc_Word32 ProcessThreadImpl::Stop()
     return 0;
 }
 
-WebRtc_Word32 ProcessThreadImpl::RegisterModule(const Module* module)
+WebRtc_Word32 ProcessThreadWorker::RegisterModule(const Module* module,
+                                                  WebRtc_UWord32 ticket)
 {
-    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
-                 "RegisterModule(module:0x%x)", module);
     CriticalSectionScoped lock(_critSectModules);
 
+    if(_cancelledTickets.erase(ticket) > 0)
+    {
+        // De-registered while the registration was on its way here.
+        return 0;
+    }
     // Only allow module to be registered once.
-    ListItem* item = _modules.First();
-    for(WebRtc_UWord32 i = 0; i < _modules.GetSize() && item; i++)
+    if(_modules.find(module) != _modules.end())
     {
-        if(module == item->GetItem())
-        {
-            return -1;
-        }
-        item = _modules.Next(item);
+        return -1;
     }
+    _modules[module] = ticket;
 
-    _modules.PushFront(module);
+    // Ask the module when it is due the next time the thread runs.
+    Schedule(const_cast<Module*>(module), ticket,
+             TickTime::MillisecondTimestamp());
     WEBRTC_TRACE(kTraceInfo, kTraceUtility, -1,
                  "number of registered modules has increased to %d",
-                 _modules.GetSize());
-    // Wake the thread calling ProcessThreadImpl::Process() to update the
+                 _modules.size());
+    // Wake the thread calling ProcessThreadWorker::Process() to update the
     // waiting time. The waiting time for the just registered module may be
     // shorter than all other registered modules.
     _timeEvent.Set();
     return 0;
 }
 
-WebRtc_Word32 ProcessThreadImpl::DeRegisterModule(const Module* module)
+WebRtc_Word32 ProcessThreadWorker::DeRegisterModule(const Module* module,
+                                                    WebRtc_UWord32 ticket)
 {
-    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
-                 "DeRegisterModule(module:0x%x)", module);
     CriticalSectionScoped lock(_critSectModules);
 
-    ListItem* item = _modules.First();
-    for(WebRtc_UWord32 i = 0; i < _modules.GetSize() && item; i++)
+    ModuleMap::iterator it = _modules.find(module);
+    if(it == _modules.end() || it->second != ticket)
     {
-        if(module == item->GetItem())
-        {
-            int res = _modules.Erase(item);
-            WEBRTC_TRACE(kTraceInfo, kTraceUtility, -1,
-                         "number of registered modules has decreased to %d",
-                         _modules.GetSize());
-            return res;
-        }
-        item = _modules.Next(item);
+        // The RegisterModule() call for this ticket hasn't arrived yet.
+        _cancelledTickets.insert(ticket);
+        return 0;
     }
-    return -1;
+    // The heap entry is dropped when it reaches the top of the heap.
+    _modules.erase(it);
+    WEBRTC_TRACE(kTraceInfo, kTraceUtility, -1,
+                 "number of registered modules has decreased to %d",
+                 _modules.size());
+    return 0;
+}
+
+void ProcessThreadWorker::Schedule(Module* module, WebRtc_UWord32 ticket,
+                                   WebRtc_Word64 dueTimeMs)
+{
+    ScheduledModule entry;
+    entry.dueTimeMs = dueTimeMs;
+    entry.module = module;
+    entry.ticket = ticket;
+    _schedule.push_back(entry);
+    std::push_heap(_schedule.begin(), _schedule.end(), LaterDueTime());
 }
 
-bool ProcessThreadImpl::Run(void* obj)
+bool ProcessThreadWorker::Run(void* obj)
 {
-    return static_cast<ProcessThreadImpl*>(obj)->Process();
+    return static_cast<ProcessThreadWorker*>(obj)->Process();
 }
 
-bool ProcessThreadImpl::Process()
+bool ProcessThreadWorker::Process()
 {
-    // Wait for the module that should be called next, but don't block thread
-    // longer than 100 ms.
-    WebRtc_Word32 minTimeToNext = 100;
+    WebRtc_Word64 waitTimeMs = kMaxWaitTimeMs;
     {
         CriticalSectionScoped lock(_critSectModules);
-        ListItem* item = _modules.First();
-        for(WebRtc_UWord32 i = 0; i < _modules.GetSize() && item; i++)
+        const WebRtc_Word64 nowMs = TickTime::MillisecondTimestamp();
+        ProcessDueModules(nowMs);
+        if(!_schedule.empty())
         {
-            WebRtc_Word32 timeToNext =
-                static_cast<Module*>(item->GetItem())->TimeUntilNextProcess();
-            if(minTimeToNext > timeToNext)
-            {
-                minTimeToNext = timeToNext;
-            }
-            item = _modules.Next(item);
+            waitTimeMs = std::min(_schedule.front().dueTimeMs - nowMs,
+                                  kMaxWaitTimeMs);
         }
     }
-
-    if(minTimeToNext > 0)
+    if(waitTimeMs > 0)
     {
-        if(kEventError == _timeEvent.Wait(minTimeToNext))
+        if(kEventError ==
+           _timeEvent.Wait(static_cast<unsigned long>(waitTimeMs)))
         {
             return true;
         }
@@ -175,20 +206,153 @@ bool ProcessThreadImpl::Process()
             return false;
         }
     }
+    return true;
+}
+
+void ProcessThreadWorker::ProcessDueModules(WebRtc_Word64 nowMs)
+{
+    while(!_schedule.empty() && _schedule.front().dueTimeMs <= nowMs)
     {
-        CriticalSectionScoped lock(_critSectModules);
-        ListItem* item = _modules.First();
-        for(WebRtc_UWord32 i = 0; i < _modules.GetSize() && item; i++)
+        const ScheduledModule entry = _schedule.front();
+        std::pop_heap(_schedule.begin(), _schedule.end(), LaterDueTime());
+        _schedule.pop_back();
+
+        ModuleMap::const_iterator it = _modules.find(entry.module);
+        if(it == _modules.end() || it->second != entry.ticket)
         {
-            WebRtc_Word32 timeToNext =
-                static_cast<Module*>(item->GetItem())->TimeUntilNextProcess();
+            // Stale entry of a de-registered module.
+            continue;
+        }
+        WebRtc_Word32 timeToNext = entry.module->TimeUntilNextProcess();
+        if(timeToNext < 1)
+        {
+            entry.module->Process();
+            timeToNext = entry.module->TimeUntilNextProcess();
+            // A module that wants to run again right away is called on the
+            // next wakeup rather than in this pass, so one busy module
+            // can't starve the rest.
             if(timeToNext < 1)
             {
-                static_cast<Module*>(item->GetItem())->Process();
+                timeToNext = 1;
             }
-            item = _modules.Next(item);
         }
+        if(timeToNext > kMaxScheduleIntervalMs)
+        {
+            timeToNext = kMaxScheduleIntervalMs;
+        }
+        Schedule(entry.module, entry.ticket, nowMs + timeToNext);
     }
-    return true;
+}
+
+ProcessThreadImpl::ProcessThreadImpl(WebRtc_UWord32 numberOfThreads)
+    : _critSect(CriticalSectionWrapper::CreateCriticalSection()),
+      _workerLoad(numberOfThreads, 0),
+      _lastTicket(0)
+{
+    for(WebRtc_UWord32 i = 0; i < numberOfThreads; i++)
+    {
+        _workers.push_back(new ProcessThreadWorker());
+    }
+    WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s created", __FUNCTION__);
+}
+
+ProcessThreadImpl::~ProcessThreadImpl()
+{
+    for(size_t i = 0; i < _workers.size(); i++)
+    {
+        _workers[i]->Stop();
+        delete _workers[i];
+    }
+    delete _critSect;
+    WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s deleted", __FUNCTION__);
+}
+
+// The set of workers never changes after construction. Start() and Stop()
+// don't take _critSect, see RegisterModule().
+WebRtc_Word32 ProcessThreadImpl::Start()
+{
+    for(size_t i = 0; i < _workers.size(); i++)
+    {
+        if(_workers[i]->Start() != 0)
+        {
+            // Leave the process thread either fully started or stopped.
+            for(size_t j = 0; j < i; j++)
+            {
+                _workers[j]->Stop();
+            }
+            return -1;
+        }
+    }
+    return 0;
+}
+
+WebRtc_Word32 ProcessThreadImpl::Stop()
+{
+    WebRtc_Word32 retVal = 0;
+    for(size_t i = 0; i < _workers.size(); i++)
+    {
+        if(_workers[i]->Stop() != 0)
+        {
+            retVal = -1;
+        }
+    }
+    return retVal;
+}
+
+WebRtc_Word32 ProcessThreadImpl::RegisterModule(const Module* module)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
+                 "RegisterModule(module:0x%x)", module);
+    ProcessThreadWorker* worker = NULL;
+    WebRtc_UWord32 ticket = 0;
+    {
+        CriticalSectionScoped lock(_critSect);
+        if(_moduleWorker.find(module) != _moduleWorker.end())
+        {
+            return -1;
+        }
+        // Put the module on the least loaded thread.
+        size_t index = 0;
+        for(size_t i = 1; i < _workers.size(); i++)
+        {
+            if(_workerLoad[i] < _workerLoad[index])
+            {
+                index = i;
+            }
+        }
+        _workerLoad[index]++;
+        ticket = ++_lastTicket;
+        Assignment& assignment = _moduleWorker[module];
+        assignment.worker = index;
+        assignment.ticket = ticket;
+        worker = _workers[index];
+    }
+    // A module may register other modules from its Process() call, which
+    // runs with the worker lock held, so _critSect is never held while
+    // taking a worker lock. A DeRegisterModule() call in between cancels the
+    // ticket, so the worker won't pick the module up after that.
+    return worker->RegisterModule(module, ticket);
+}
+
+WebRtc_Word32 ProcessThreadImpl::DeRegisterModule(const Module* module)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
+                 "DeRegisterModule(module:0x%x)", module);
+    ProcessThreadWorker* worker = NULL;
+    WebRtc_UWord32 ticket = 0;
+    {
+        CriticalSectionScoped lock(_critSect);
+        WorkerMap::iterator it = _moduleWorker.find(module);
+        if(it == _moduleWorker.end())
+        {
+            return -1;
+        }
+        worker = _workers[it->second.worker];
+        ticket = it->second.ticket;
+        _workerLoad[it->second.worker]--;
+        _moduleWorker.erase(it);
+    }
+    // Blocks until the module is no longer being processed.
+    return worker->DeRegisterModule(module, ticket);
 }
 } // namespace webrtc
@@ -11,18 +11,89 @@
 #ifndef WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 #define WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 
+#include <stddef.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
 #include "critical_section_wrapper.h"
 #include "event_wrapper.h"
-#include "list_wrapper.h"
 #include "process_thread.h"
 #include "thread_wrapper.h"
 #include "typedefs.h"
 
 namespace webrtc {
+class Module;
+
+// Upper limit on the number of threads a sharded ProcessThread may use.
+#define MAX_NUMBER_OF_PROCESS_THREADS 16
+
+// One thread calling Process() on a set of modules. The modules are kept in a
+// min-heap keyed on the time they are due, so a wakeup only touches the
+// modules that are due instead of asking every registered module for its
+// TimeUntilNextProcess().
+class ProcessThreadWorker
+{
+public:
+    ProcessThreadWorker();
+    ~ProcessThreadWorker();
+
+    WebRtc_Word32 Start();
+    WebRtc_Word32 Stop();
+
+    // |ticket| identifies one registration of |module| and is unique for the
+    // lifetime of the ProcessThreadImpl. If DeRegisterModule() is called
+    // for a ticket before RegisterModule(), the registration is cancelled and
+    // the module is never processed.
+    WebRtc_Word32 RegisterModule(const Module* module, WebRtc_UWord32 ticket);
+    WebRtc_Word32 DeRegisterModule(const Module* module,
+                                   WebRtc_UWord32 ticket);
+
+protected:
+    static bool Run(void* obj);
+
+    bool Process();
+
+private:
+    struct ScheduledModule
+    {
+        WebRtc_Word64   dueTimeMs;
+        Module*         module;
+        // Entries left in the heap by a module that has been de-registered
+        // (and possibly registered again) are detected by their ticket and
+        // dropped when they reach the top.
+        WebRtc_UWord32  ticket;
+    };
+    // Orders the heap so that the earliest due module is on top.
+    struct LaterDueTime
+    {
+        bool operator()(const ScheduledModule& a,
+                        const ScheduledModule& b) const
+        {
+            return a.dueTimeMs > b.dueTimeMs;
+        }
+    };
+    typedef std::map<const Module*, WebRtc_UWord32> ModuleMap;
+
+    void Schedule(Module* module, WebRtc_UWord32 ticket,
+                  WebRtc_Word64 dueTimeMs);
+    // Calls Process() on all modules due at nowMs and reschedules them.
+    void ProcessDueModules(WebRtc_Word64 nowMs);
+
+    EventWrapper&                   _timeEvent;
+    CriticalSectionWrapper*         _critSectModules;
+    ModuleMap                       _modules;
+    std::vector<ScheduledModule>    _schedule;
+    // Tickets de-registered before their RegisterModule() call arrived.
+    std::set<WebRtc_UWord32>        _cancelledTickets;
+    ThreadWrapper*                  _thread;
+};
+
 class ProcessThreadImpl : public ProcessThread
 {
 public:
-    ProcessThreadImpl();
+    explicit ProcessThreadImpl(WebRtc_UWord32 numberOfThreads = 1);
     virtual ~ProcessThreadImpl();
 
     virtual WebRtc_Word32 Start();
@@ -31,16 +102,21 @@ public:
     virtual WebRtc_Word32 RegisterModule(const Module* module);
     virtual WebRtc_Word32 DeRegisterModule(const Module* module);
 
-protected:
-    static bool Run(void* obj);
-
-    bool Process();
-
 private:
-    EventWrapper&           _timeEvent;
-    CriticalSectionWrapper* _critSectModules;
-    ListWrapper             _modules;
-    ThreadWrapper*          _thread;
+    struct Assignment
+    {
+        size_t          worker;
+        WebRtc_UWord32  ticket;
+    };
+    typedef std::map<const Module*, Assignment> WorkerMap;
+
+    CriticalSectionWrapper*             _critSect;
+    std::vector<ProcessThreadWorker*>   _workers;
+    // Number of modules assigned to each worker.
+    std::vector<WebRtc_UWord32>         _workerLoad;
+    // Worker and registration ticket of each registered module.
+    WorkerMap                           _moduleWorker;
+    WebRtc_UWord32                      _lastTicket;
 };
 } // namespace webrtc
 
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how late ProcessThread calls Process() on a large number of
+// periodic modules, and how many TimeUntilNextProcess() calls it needs to do
+// so.
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "module.h"
+#include "process_thread.h"
+#include "process_thread_impl.h"
+#include "tick_util.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumberOfModules = 1000;
+const int kProcessIntervalMs = 10;
+const int kRunTimeMs = 1000;
+
+class PeriodicModule : public Module
+{
+public:
+    explicit PeriodicModule(WebRtc_Word64 firstDueTimeMs)
+        : _nextDueTimeMs(firstDueTimeMs),
+          _processCalls(0),
+          _timeQueries(0),
+          _totalLatenessMs(0),
+          _maxLatenessMs(0)
+    {
+    }
+    virtual ~PeriodicModule() {}
+
+    virtual int32_t Version(char* /*version*/,
+                            uint32_t& /*remaining_buffer_in_bytes*/,
+                            uint32_t& /*position*/) const
+    {
+        return 0;
+    }
+    virtual int32_t ChangeUniqueId(const int32_t /*id*/)
+    {
+        return 0;
+    }
+    virtual int32_t TimeUntilNextProcess()
+    {
+        _timeQueries++;
+        return static_cast<int32_t>(
+            _nextDueTimeMs - TickTime::MillisecondTimestamp());
+    }
+    virtual int32_t Process()
+    {
+        const WebRtc_Word64 latenessMs =
+            TickTime::MillisecondTimestamp() - _nextDueTimeMs;
+        _processCalls++;
+        _totalLatenessMs += latenessMs;
+        if (latenessMs > _maxLatenessMs)
+        {
+            _maxLatenessMs = latenessMs;
+        }
+        _nextDueTimeMs += kProcessIntervalMs;
+        return 0;
+    }
+
+    // Only read after the module has been de-registered.
+    int ProcessCalls() const {return _processCalls;}
+    int TimeQueries() const {return _timeQueries;}
+    WebRtc_Word64 TotalLatenessMs() const {return _totalLatenessMs;}
+    WebRtc_Word64 MaxLatenessMs() const {return _maxLatenessMs;}
+
+private:
+    WebRtc_Word64 _nextDueTimeMs;
+    int _processCalls;
+    int _timeQueries;
+    WebRtc_Word64 _totalLatenessMs;
+    WebRtc_Word64 _maxLatenessMs;
+};
+
+void RunJitterTest(ProcessThread* processThread, const char* name)
+{
+    ASSERT_TRUE(processThread != NULL);
+    ASSERT_EQ(0, processThread->Start());
+
+    // Spread the deadlines over one interval.
+    const WebRtc_Word64 startMs = TickTime::MillisecondTimestamp();
+    std::vector<PeriodicModule*> modules;
+    for (int i = 0; i < kNumberOfModules; i++)
+    {
+        PeriodicModule* module = new PeriodicModule(
+            startMs + kProcessIntervalMs + i % kProcessIntervalMs);
+        modules.push_back(module);
+        ASSERT_EQ(0, processThread->RegisterModule(module));
+    }
+    // Registering a module twice fails.
+    EXPECT_EQ(-1, processThread->RegisterModule(modules[0]));
+
+    usleep(kRunTimeMs * 1000);
+
+    for (int i = 0; i < kNumberOfModules; i++)
+    {
+        ASSERT_EQ(0, processThread->DeRegisterModule(modules[i]));
+    }
+    EXPECT_EQ(-1, processThread->DeRegisterModule(modules[0]));
+    EXPECT_EQ(0, processThread->Stop());
+
+    int processCalls = 0;
+    int timeQueries = 0;
+    WebRtc_Word64 totalLatenessMs = 0;
+    WebRtc_Word64 maxLatenessMs = 0;
+    for (int i = 0; i < kNumberOfModules; i++)
+    {
+        processCalls += modules[i]->ProcessCalls();
+        timeQueries += modules[i]->TimeQueries();
+        totalLatenessMs += modules[i]->TotalLatenessMs();
+        if (modules[i]->MaxLatenessMs() > maxLatenessMs)
+        {
+            maxLatenessMs = modules[i]->MaxLatenessMs();
+        }
+        delete modules[i];
+    }
+    const double avgLatenessMs =
+        processCalls > 0 ? static_cast<double>(totalLatenessMs) / processCalls
+                         : 0.0;
+    const double queriesPerProcess =
+        processCalls > 0 ? static_cast<double>(timeQueries) / processCalls
+                         : 0.0;
+    printf("%-8s: %d modules, %d Process() calls, lateness avg %.2f ms "
+           "max %lld ms, %.1f TimeUntilNextProcess() calls per Process()\n",
+           name, kNumberOfModules, processCalls, avgLatenessMs,
+           static_cast<long long>(maxLatenessMs), queriesPerProcess);
+
+    // Every module should have run roughly once per interval.
+    EXPECT_GT(processCalls,
+              kNumberOfModules * (kRunTimeMs / kProcessIntervalMs) / 2);
+    EXPECT_LT(avgLatenessMs, kProcessIntervalMs / 2);
+    // A linear scan asks every module on every wakeup.
+    EXPECT_LT(queriesPerProcess, 10.0);
+}
+
+}  // namespace
+
+TEST(ProcessThreadTest, SchedulingJitterWith1000Modules) {
+  ProcessThread* processThread = ProcessThread::CreateProcessThread();
+  RunJitterTest(processThread, "1 thread");
+  ProcessThread::DestroyProcessThread(processThread);
+}
+
+TEST(ProcessThreadTest, SchedulingJitterWith1000ModulesSharded) {
+  ProcessThread* processThread = ProcessThread::CreateProcessThread(4);
+  RunJitterTest(processThread, "4 thread");
+  ProcessThread::DestroyProcessThread(processThread);
+}
+
+// ProcessThreadImpl registers a module on its worker without holding its own
+// lock, so a concurrent DeRegisterModule() can reach the worker first.
+TEST(ProcessThreadTest, DeRegisterBeforeWorkerRegistrationCancelsIt) {
+  ProcessThreadWorker worker;
+  ASSERT_EQ(0, worker.Start());
+  PeriodicModule module(TickTime::MillisecondTimestamp());
+  EXPECT_EQ(0, worker.DeRegisterModule(&module, 1));
+  EXPECT_EQ(0, worker.RegisterModule(&module, 1));
+  usleep(5 * kProcessIntervalMs * 1000);
+  EXPECT_EQ(0, module.ProcessCalls());
+  EXPECT_EQ(0, module.TimeQueries());
+
+  // A later registration of the module is not affected.
+  EXPECT_EQ(0, worker.RegisterModule(&module, 2));
+  usleep(5 * kProcessIntervalMs * 1000);
+  EXPECT_EQ(0, worker.DeRegisterModule(&module, 2));
+  EXPECT_EQ(0, worker.Stop());
+  EXPECT_GT(module.ProcessCalls(), 0);
+}
+
+TEST(ProcessThreadTest, InvalidNumberOfThreads) {
+  EXPECT_TRUE(ProcessThread::CreateProcessThread(0) == NULL);
+}
+
+}  // namespace webrtc
@@ -14,6 +14,8 @@
 #include <stdio.h>
 
 #include "critical_section_wrapper.h"
+#include "event_wrapper.h"
+#include "thread_wrapper.h"
 #include "trace.h"
 
 #if defined(_WIN32)
@@ -41,6 +43,10 @@
 namespace webrtc {
 const WebRtc_Word8 RTPFILE_VERSION[] = "1.0";
 const WebRtc_UWord32 MAX_UWORD32 = 0xffffffff;
+// The writer thread writes at least this often.
+const unsigned long kWriteIntervalMs = 100;
+// The writer thread is woken early when the fill buffer is this full.
+const WebRtc_UWord32 kWriteThreshold = RtpDumpImpl::kBufferSize / 2;
 
 // This stucture is specified in the rtpdump documentation.
 // This struct corresponds to RD_packet_t in
@@ -69,9 +75,19 @@ void RtpDump::DestroyRtpDump(RtpDump* object)
 }
 
 RtpDumpImpl::RtpDumpImpl()
-    : _critSect(CriticalSectionWrapper::CreateCriticalSection()),
+    : _startStopCritSect(CriticalSectionWrapper::CreateCriticalSection()),
+      _critSect(CriticalSectionWrapper::CreateCriticalSection()),
       _file(*FileWrapper::Create()),
-      _startTime(0)
+      _writeEvent(*EventWrapper::Create()),
+      _writerThread(NULL),
+      _active(false),
+      _startTime(0),
+      _maxPayloadLength(-1),
+      _fillBuffer(new WebRtc_UWord8[kBufferSize]),
+      _fillLength(0),
+      _writeBuffer(new WebRtc_UWord8[kBufferSize]),
+      _packetsDumped(0),
+      _packetsDropped(0)
 {
     WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s created", __FUNCTION__);
 }
@@ -82,9 +98,22 @@ RtpDump::~RtpDump()
 
 RtpDumpImpl::~RtpDumpImpl()
 {
-    _file.Flush();
-    _file.CloseFile();
+    bool stopped;
+    {
+        CriticalSectionScoped lock(_startStopCritSect);
+        stopped = StopLocked();
+    }
+    delete _startStopCritSect;
+    if (!stopped)
+    {
+        // The writer thread may still use the file, the buffers and
+        // _critSect. Leak them rather than free them under its feet.
+        return;
+    }
     delete &_file;
+    delete &_writeEvent;
+    delete [] _fillBuffer;
+    delete [] _writeBuffer;
     delete _critSect;
     WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s deleted", __FUNCTION__);
 }
@@ -98,9 +127,11 @@ WebRtc_Word32 RtpDumpImpl::Start(const WebRtc_Word8* fileNameUTF8)
         return -1;
     }
 
-    CriticalSectionScoped lock(_critSect);
-    _file.Flush();
-    _file.CloseFile();
+    CriticalSectionScoped startStopLock(_startStopCritSect);
+    if (!StopLocked())
+    {
+        return -1;
+    }
     if (_file.OpenFile(fileNameUTF8, false, false, false) == -1)
     {
         WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
@@ -108,9 +139,6 @@ WebRtc_Word32 RtpDumpImpl::Start(const WebRtc_Word8* fileNameUTF8)
         return -1;
     }
 
-    // Store start of RTP dump (to be used for offset calculation later).
-    _startTime = GetTimeInMS();
-
     // All rtp dump files start with #!rtpplay.
     WebRtc_Word8 magic[16];
     sprintf(magic, "#!rtpplay%s \n", RTPFILE_VERSION);
@@ -118,6 +146,7 @@ WebRtc_Word32 RtpDumpImpl::Start(const WebRtc_Word8* fileNameUTF8)
     {
         WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
                      "error writing to file");
+        _file.CloseFile();
         return -1;
     }
 
@@ -134,31 +163,101 @@ WebRtc_Word32 RtpDumpImpl::Start(const WebRtc_Word8* fileNameUTF8)
     {
         WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
                      "error writing to file");
+        _file.CloseFile();
         return -1;
     }
+
+    _writerThread = ThreadWrapper::CreateThread(WriterThread, this,
+                                                kNormalPriority,
+                                                "RtpDumpWriter");
+    unsigned int id;
+    if (_writerThread == NULL || !_writerThread->Start(id))
+    {
+        WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
+                     "failed to start the writer thread");
+        delete _writerThread;
+        _writerThread = NULL;
+        _file.CloseFile();
+        return -1;
+    }
+
+    CriticalSectionScoped lock(_critSect);
+    // Store start of RTP dump (to be used for offset calculation later).
+    _startTime = GetTimeInMS();
+    _fillLength = 0;
+    _packetsDumped = 0;
+    _packetsDropped = 0;
+    _active = true;
     return 0;
 }
 
 WebRtc_Word32 RtpDumpImpl::Stop()
 {
     WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1, "Stop()");
+    CriticalSectionScoped lock(_startStopCritSect);
+    return StopLocked() ? 0 : -1;
+}
+
+bool RtpDumpImpl::StopLocked()
+{
+    {
+        CriticalSectionScoped lock(_critSect);
+        _active = false;
+    }
+    if (_writerThread != NULL)
+    {
+        _writerThread->SetNotAlive();
+        _writeEvent.Set();
+        if (!_writerThread->Stop())
+        {
+            // The thread may still be writing; leave the file and the
+            // buffers to it.
+            WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
+                         "failed to stop the writer thread");
+            return false;
+        }
+        delete _writerThread;
+        _writerThread = NULL;
+    }
+    if (_file.Open())
+    {
+        // Write what the thread didn't get to.
+        WriteBuffered();
+        _file.CloseFile();
+    }
+    return true;
+}
+
+bool RtpDumpImpl::IsActive() const
+{
     CriticalSectionScoped lock(_critSect);
-    _file.Flush();
-    _file.CloseFile();
+    return _active;
+}
+
+WebRtc_Word32 RtpDumpImpl::SetMaxPayloadLength(WebRtc_Word32 maxPayloadLength)
+{
+    if (maxPayloadLength < -1)
+    {
+        return -1;
+    }
+    CriticalSectionScoped lock(_critSect);
+    _maxPayloadLength = maxPayloadLength;
     return 0;
 }
 
-bool RtpDumpImpl::IsActive() const
+void RtpDumpImpl::GetStatistics(WebRtc_UWord32& packetsDumped,
+                                WebRtc_UWord32& packetsDropped) const
 {
     CriticalSectionScoped lock(_critSect);
-    return _file.Open();
+    packetsDumped = _packetsDumped;
+    packetsDropped = _packetsDropped;
 }
 
 WebRtc_Word32 RtpDumpImpl::DumpPacket(const WebRtc_UWord8* packet,
                                       WebRtc_UWord16 packetLength)
 {
     CriticalSectionScoped lock(_critSect);
-    if (!IsActive())
+    if (!_active)
     {
         return 0;
     }
@@ -176,8 +275,17 @@ WebRtc_Word32 RtpDumpImpl::DumpPacket(const WebRtc_UWord8* packet,
     // If the packet doesn't contain a valid RTCP header the packet will be
     // considered RTP (without further verification).
     bool isRTCP = RTCP(packet);
+    const WebRtc_UWord16 recordedLength =
+        isRTCP ? packetLength : RecordedLength(packet, packetLength);
 
     rtpDumpPktHdr_t hdr;
+    if (_fillLength + sizeof(hdr) + recordedLength > kBufferSize)
+    {
+        // The writer thread is behind; drop rather than block.
+        _packetsDropped++;
+        return 0;
+    }
+
     WebRtc_UWord32 offset;
 
     // Offset is relative to when recording was started.
@@ -191,7 +299,7 @@ WebRtc_Word32 RtpDumpImpl::DumpPacket(const WebRtc_UWord8* packet,
     }
     hdr.offset = RtpDumpHtonl(offset);
 
-    hdr.length = RtpDumpHtons((WebRtc_UWord16)(packetLength + sizeof(hdr)));
+    hdr.length = RtpDumpHtons((WebRtc_UWord16)(recordedLength + sizeof(hdr)));
     if (isRTCP)
     {
         hdr.plen = 0;
@@ -201,20 +309,74 @@ WebRtc_Word32 RtpDumpImpl::DumpPacket(const WebRtc_UWord8* packet,
         hdr.plen = RtpDumpHtons((WebRtc_UWord16)packetLength);
     }
 
-    if (!_file.Write(&hdr, sizeof(hdr)))
+    memcpy(_fillBuffer + _fillLength, &hdr, sizeof(hdr));
+    memcpy(_fillBuffer + _fillLength + sizeof(hdr), packet, recordedLength);
+    _fillLength += sizeof(hdr) + recordedLength;
+    _packetsDumped++;
+    if (_fillLength >= kWriteThreshold)
     {
-        WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
-                     "error writing to file");
-        return -1;
+        _writeEvent.Set();
+    }
+    return 0;
+}
+
+bool RtpDumpImpl::WriterThread(void* obj)
+{
+    return static_cast<RtpDumpImpl*>(obj)->WriterProcess();
+}
+
+bool RtpDumpImpl::WriterProcess()
+{
+    _writeEvent.Wait(kWriteIntervalMs);
+    WriteBuffered();
+    return true;
+}
+
+void RtpDumpImpl::WriteBuffered()
+{
+    WebRtc_UWord32 length = 0;
+    {
+        CriticalSectionScoped lock(_critSect);
+        WebRtc_UWord8* buffer = _fillBuffer;
+        _fillBuffer = _writeBuffer;
+        _writeBuffer = buffer;
+        length = _fillLength;
+        _fillLength = 0;
+    }
+    if (length == 0)
+    {
+        return;
     }
-    if (!_file.Write(packet, packetLength))
+    if (!_file.Write(_writeBuffer, length))
     {
         WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
                      "error writing to file");
-        return -1;
+        return;
     }
+    _file.Flush();
+}
 
-    return 0;
+WebRtc_UWord16 RtpDumpImpl::RecordedLength(const WebRtc_UWord8* packet,
+                                           WebRtc_UWord16 packetLength) const
+{
+    if (_maxPayloadLength < 0 || packetLength < 12)
+    {
+        return packetLength;
+    }
+    // Fixed header and CSRC list.
+    WebRtc_UWord32 headerLength = 12 + 4 * (packet[0] & 0x0f);
+    // Header extension.
+    if ((packet[0] & 0x10) && packetLength >= headerLength + 4)
+    {
+        headerLength += 4 + 4 * ((packet[headerLength + 2] << 8) +
+                                 packet[headerLength + 3]);
+    }
+    const WebRtc_UWord32 recordedLength = headerLength + _maxPayloadLength;
+    if (recordedLength >= packetLength)
+    {
+        return packetLength;
+    }
+    return (WebRtc_UWord16)recordedLength;
 }
 
 bool RtpDumpImpl::RTCP(const WebRtc_UWord8* packet) const
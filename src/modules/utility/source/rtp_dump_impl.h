@@ -15,10 +15,21 @@
 
 namespace webrtc {
 class CriticalSectionWrapper;
+class EventWrapper;
 class FileWrapper;
+class ThreadWrapper;
+
+// Packets are copied into a buffer by DumpPacket() and written to the file in
+// large blocks by a writer thread, so that the RTP send and receive paths
+// never wait for the disk. There are two buffers: DumpPacket() fills one
+// while the writer thread writes the other. When the fill buffer is full,
+// packets are dropped and counted.
 class RtpDumpImpl : public RtpDump
 {
 public:
+    // Size of each of the two buffers.
+    enum { kBufferSize = 256 * 1024 };
+
     RtpDumpImpl();
     virtual ~RtpDumpImpl();
 
@@ -27,7 +38,21 @@ public:
     virtual bool IsActive() const;
     virtual WebRtc_Word32 DumpPacket(const WebRtc_UWord8* packet,
                                      WebRtc_UWord16 packetLength);
+    virtual WebRtc_Word32 SetMaxPayloadLength(WebRtc_Word32 maxPayloadLength);
+    virtual void GetStatistics(WebRtc_UWord32& packetsDumped,
+                               WebRtc_UWord32& packetsDropped) const;
 private:
+    static bool WriterThread(void* obj);
+    bool WriterProcess();
+
+    // Writes everything buffered so far to the file. Must only be called by
+    // the writer thread, or when the writer thread isn't running.
+    void WriteBuffered();
+
+    // Stops the writer thread and closes the file. Requires _startStopCritSect.
+    // Returns false, leaving the file open, if the thread couldn't be stopped.
+    bool StopLocked();
+
     // Return the system time in ms.
     inline WebRtc_UWord32 GetTimeInMS() const;
     // Return x in network byte order (big endian).
@@ -40,10 +65,29 @@ private:
     //       to determine if the packet is an RTCP packet.
     bool RTCP(const WebRtc_UWord8* packet) const;
 
+    // Return the number of bytes of the RTP packet to record.
+    WebRtc_UWord16 RecordedLength(const WebRtc_UWord8* packet,
+                                  WebRtc_UWord16 packetLength) const;
+
 private:
+    // Serializes Start() and Stop(). Never taken by DumpPacket().
+    CriticalSectionWrapper* _startStopCritSect;
+    // Protects the fill buffer, the counters and the settings below.
     CriticalSectionWrapper* _critSect;
     FileWrapper& _file;
+    EventWrapper& _writeEvent;
+    ThreadWrapper* _writerThread;
+    bool _active;
     WebRtc_UWord32 _startTime;
+    WebRtc_Word32 _maxPayloadLength;
+
+    WebRtc_UWord8* _fillBuffer;
+    WebRtc_UWord32 _fillLength;
+    // Only touched by the writer thread.
+    WebRtc_UWord8* _writeBuffer;
+
+    WebRtc_UWord32 _packetsDumped;
+    WebRtc_UWord32 _packetsDropped;
 };
 } // namespace webrtc
 #endif // WEBRTC_MODULES_UTILITY_SOURCE_RTP_DUMP_IMPL_H_
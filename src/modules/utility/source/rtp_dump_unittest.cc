@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "rtp_dump.h"
+#include "testsupport/fileutils.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kFileHeaderLength = 12 + 16;  // "#!rtpplay1.0 \n" + RD_hdr_t.
+const size_t kPacketHeaderLength = 8;
+
+struct DumpedPacket
+{
+    WebRtc_UWord16 length;
+    WebRtc_UWord16 plen;
+    std::vector<WebRtc_UWord8> data;
+};
+
+// Builds an RTP packet with |numCsrcs| CSRCs, an optional one-word header
+// extension and |payloadLength| payload bytes.
+std::vector<WebRtc_UWord8> RtpPacket(int numCsrcs, bool extension,
+                                     int payloadLength,
+                                     WebRtc_UWord16 sequenceNumber)
+{
+    std::vector<WebRtc_UWord8> packet(12 + 4 * numCsrcs);
+    packet[0] = 0x80 | (extension ? 0x10 : 0) | numCsrcs;
+    packet[1] = 96;
+    packet[2] = sequenceNumber >> 8;
+    packet[3] = sequenceNumber & 0xff;
+    if (extension)
+    {
+        const WebRtc_UWord8 header[] = {0xbe, 0xde, 0, 1, 1, 2, 3, 4};
+        packet.insert(packet.end(), header, header + sizeof(header));
+    }
+    for (int i = 0; i < payloadLength; ++i)
+    {
+        packet.push_back(static_cast<WebRtc_UWord8>(i));
+    }
+    return packet;
+}
+
+std::vector<DumpedPacket> ReadDump(const std::string& fileName)
+{
+    std::vector<DumpedPacket> packets;
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (file == NULL)
+    {
+        return packets;
+    }
+    char magic[32];
+    if (fgets(magic, sizeof(magic), file) == NULL ||
+        strcmp(magic, "#!rtpplay1.0 \n") != 0 ||
+        fseek(file, 16, SEEK_CUR) != 0)
+    {
+        fclose(file);
+        return packets;
+    }
+    WebRtc_UWord8 header[kPacketHeaderLength];
+    while (fread(header, 1, sizeof(header), file) == sizeof(header))
+    {
+        DumpedPacket packet;
+        packet.length = (header[0] << 8) + header[1];
+        packet.plen = (header[2] << 8) + header[3];
+        packet.data.resize(packet.length - kPacketHeaderLength);
+        if (fread(&packet.data[0], 1, packet.data.size(), file) !=
+            packet.data.size())
+        {
+            break;
+        }
+        packets.push_back(packet);
+    }
+    fclose(file);
+    return packets;
+}
+
+class RtpDumpTest : public ::testing::Test
+{
+protected:
+    RtpDumpTest()
+        : _dump(RtpDump::CreateRtpDump()),
+          _fileName(test::OutputPath() + "rtp_dump_unittest.rtp")
+    {
+    }
+    virtual ~RtpDumpTest()
+    {
+        RtpDump::DestroyRtpDump(_dump);
+        remove(_fileName.c_str());
+    }
+
+    RtpDump* _dump;
+    const std::string _fileName;
+};
+
+TEST_F(RtpDumpTest, WritesAllPacketsOnStop)
+{
+    ASSERT_EQ(0, _dump->Start(_fileName.c_str()));
+    EXPECT_TRUE(_dump->IsActive());
+    std::vector<std::vector<WebRtc_UWord8> > sent;
+    for (int i = 0; i < 100; ++i)
+    {
+        sent.push_back(RtpPacket(i % 3, i % 2 == 0, 100 + i, i));
+        EXPECT_EQ(0, _dump->DumpPacket(&sent.back()[0],
+                                       sent.back().size()));
+    }
+    const WebRtc_UWord8 rtcp[] = {0x80, 200, 0, 1, 0, 0, 0, 1};
+    EXPECT_EQ(0, _dump->DumpPacket(rtcp, sizeof(rtcp)));
+    EXPECT_EQ(0, _dump->Stop());
+    EXPECT_FALSE(_dump->IsActive());
+
+    WebRtc_UWord32 dumped = 0;
+    WebRtc_UWord32 dropped = 0;
+    _dump->GetStatistics(dumped, dropped);
+    EXPECT_EQ(101u, dumped);
+    EXPECT_EQ(0u, dropped);
+
+    std::vector<DumpedPacket> packets = ReadDump(_fileName);
+    ASSERT_EQ(101u, packets.size());
+    for (size_t i = 0; i < sent.size(); ++i)
+    {
+        EXPECT_EQ(sent[i].size(), packets[i].plen);
+        EXPECT_TRUE(sent[i] == packets[i].data);
+    }
+    EXPECT_EQ(0, packets[100].plen);
+    EXPECT_EQ(sizeof(rtcp), packets[100].data.size());
+}
+
+TEST_F(RtpDumpTest, TruncatesPayload)
+{
+    ASSERT_EQ(0, _dump->Start(_fileName.c_str()));
+    EXPECT_EQ(-1, _dump->SetMaxPayloadLength(-2));
+    ASSERT_EQ(0, _dump->SetMaxPayloadLength(0));
+    std::vector<WebRtc_UWord8> plain = RtpPacket(0, false, 1000, 1);
+    std::vector<WebRtc_UWord8> withCsrcs = RtpPacket(2, true, 1000, 2);
+    EXPECT_EQ(0, _dump->DumpPacket(&plain[0], plain.size()));
+    EXPECT_EQ(0, _dump->DumpPacket(&withCsrcs[0], withCsrcs.size()));
+    ASSERT_EQ(0, _dump->SetMaxPayloadLength(4));
+    EXPECT_EQ(0, _dump->DumpPacket(&plain[0], plain.size()));
+    const WebRtc_UWord8 rtcp[] = {0x80, 200, 0, 1, 0, 0, 0, 1};
+    EXPECT_EQ(0, _dump->DumpPacket(rtcp, sizeof(rtcp)));
+    EXPECT_EQ(0, _dump->Stop());
+
+    std::vector<DumpedPacket> packets = ReadDump(_fileName);
+    ASSERT_EQ(4u, packets.size());
+    // Header only, but the original length is kept.
+    EXPECT_EQ(plain.size(), packets[0].plen);
+    EXPECT_EQ(12u, packets[0].data.size());
+    EXPECT_EQ(withCsrcs.size(), packets[1].plen);
+    EXPECT_EQ(12u + 8 + 8, packets[1].data.size());
+    EXPECT_EQ(16u, packets[2].data.size());
+    EXPECT_EQ(0, memcmp(&plain[0], &packets[2].data[0], 16));
+    EXPECT_EQ(sizeof(rtcp), packets[3].data.size());
+}
+
+TEST_F(RtpDumpTest, CountsDroppedPackets)
+{
+    ASSERT_EQ(0, _dump->Start(_fileName.c_str()));
+    // Far more than the buffers hold, dumped faster than a disk is written.
+    std::vector<WebRtc_UWord8> packet = RtpPacket(0, false, 1400, 0);
+    const WebRtc_UWord32 kPackets = 10000;
+    for (WebRtc_UWord32 i = 0; i < kPackets; ++i)
+    {
+        EXPECT_EQ(0, _dump->DumpPacket(&packet[0], packet.size()));
+    }
+    EXPECT_EQ(0, _dump->Stop());
+
+    WebRtc_UWord32 dumped = 0;
+    WebRtc_UWord32 dropped = 0;
+    _dump->GetStatistics(dumped, dropped);
+    EXPECT_EQ(kPackets, dumped + dropped);
+    EXPECT_EQ(dumped, ReadDump(_fileName).size());
+}
+
+TEST_F(RtpDumpTest, IgnoresPacketsWhenStopped)
+{
+    std::vector<WebRtc_UWord8> packet = RtpPacket(0, false, 100, 0);
+    EXPECT_FALSE(_dump->IsActive());
+    EXPECT_EQ(0, _dump->DumpPacket(&packet[0], packet.size()));
+    WebRtc_UWord32 dumped = 0;
+    WebRtc_UWord32 dropped = 0;
+    _dump->GetStatistics(dumped, dropped);
+    EXPECT_EQ(0u, dumped);
+    EXPECT_EQ(-1, _dump->Start(NULL));
+}
+
+}  // namespace
+}  // namespace webrtc
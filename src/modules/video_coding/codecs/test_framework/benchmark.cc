@@ -34,7 +34,9 @@ Benchmark::Benchmark()
 :
 NormalAsyncTest("Benchmark", "Codec benchmark over a range of test cases", 6),
 _resultsFileName(webrtc::test::OutputPath() + "benchmark.txt"),
-_codecName("Default")
+_codecName("Default"),
+_encoderCores(4),
+_decoderCores(1)
 {
 }
 
@@ -42,7 +44,9 @@ Benchmark::Benchmark(std::string name, std::string description)
 :
 NormalAsyncTest(name, description, 6),
 _resultsFileName(webrtc::test::OutputPath() + "benchmark.txt"),
-_codecName("Default")
+_codecName("Default"),
+_encoderCores(4),
+_decoderCores(1)
 {
 }
 
@@ -50,7 +54,9 @@ Benchmark::Benchmark(std::string name, std::string description, std::string resu
 :
 NormalAsyncTest(name, description, 6),
 _resultsFileName(resultsFileName),
-_codecName(codecName)
+_codecName(codecName),
+_encoderCores(4),
+_decoderCores(1)
 {
 }
 
@@ -233,9 +239,9 @@ Benchmark::PerformNormalTest()
 
     _inputVideoBuffer.VerifyAndAllocate(_lengthSourceFrame);
     _decodedVideoBuffer.VerifyAndAllocate(_lengthSourceFrame);
-    _encoder->InitEncode(&_inst, 4, 1440);
+    _encoder->InitEncode(&_inst, _encoderCores, 1440);
     CodecSpecific_InitBitrate();
-    _decoder->InitDecode(&_inst,1);
+    _decoder->InitDecode(&_inst, _decoderCores);
 
     FrameQueue frameQueue;
     VideoEncodeCompleteCallback encCallback(_encodedFile, &frameQueue, *this);
@@ -34,6 +34,9 @@ protected:
     std::string        _resultsFileName;
     std::ofstream      _results;
     std::string        _codecName;
+    // Number of cores given to the encoder and the decoder.
+    int                _encoderCores;
+    int                _decoderCores;
 };
 
 #endif // WEBRTC_MODULES_VIDEO_CODING_CODECS_TEST_FRAWEWORK_BENCHMARK_H_
@@ -14,6 +14,8 @@
  * Creates up to kMaxSimulcastStreams number of VP8 encoders
  * Automatically scale the input frame to the right size for all VP8 encoders
  * Runtime it divides the available bitrate beteween the VP8 Encoders 
+ * With more than one core the layers are scaled and encoded in parallel, at
+ * most one thread per core; the encoded layers are still delivered in order.
  */
 
 
@@ -27,6 +29,8 @@
 
 namespace webrtc
 {
+class SimulcastLayerWorker;
+
 class VP8SimulcastEncoder : public VideoEncoder
 {
 public:
@@ -50,7 +54,10 @@ public:
 //
 // Input:
 //          - codecSettings     : Codec settings
-//          - numberOfCores     : Number of cores available for the encoder
+//          - numberOfCores     : Number of cores available for the encoder.
+//                                With more than one core the simulcast
+//                                layers are encoded in parallel, using no
+//                                more threads than the machine has cores.
 //          - maxPayloadSize    : The maximum size each payload is allowed
 //                                to have. Usually MTU - overhead.
 //
@@ -136,12 +143,19 @@ public:
                                       WebRtc_Word32 length);
 
 private:
+  void StopWorkers();
+
   VP8Encoder* encoder_[kMaxSimulcastStreams];
   bool encode_stream_[kMaxSimulcastStreams];
   VideoFrameType frame_type_[kMaxSimulcastStreams];
   Scaler* scaler_[kMaxSimulcastStreams];
   RawImage video_frame_[kMaxSimulcastStreams];
   VideoCodec video_codec_;
+  EncodedImageCallback* encoded_complete_callback_;
+  // When encoding in parallel the highest layers are encoded on the workers,
+  // one per spare core, and the remaining layers on the calling thread.
+  bool parallel_encode_;
+  SimulcastLayerWorker* worker_[kMaxSimulcastStreams];
 };// end of VP8SimulcastEncoder class
 } // namespace webrtc
 #endif // WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_SIMULCAST_H_
@@ -34,6 +34,60 @@ enum { kVp8ErrorPropagationTh = 30 };
 namespace webrtc
 {
 
+// Number of encoder threads to use for a given resolution. Small frames
+// don't have enough macroblock rows to keep more than one thread busy.
+static int NumberOfEncoderThreads(int width, int height, int numberOfCores)
+{
+    if (width * height >= 1280 * 720 && numberOfCores > 4)
+    {
+        return 4;
+    }
+    if (width * height > 704 * 576 && numberOfCores > 1)
+    {
+        return 2;
+    }
+    if (width * height > 352 * 288 && numberOfCores > 2)
+    {
+        return 2;
+    }
+    return 1;
+}
+
+// Number of decoder threads to use for a given resolution. An unknown
+// resolution is treated as the largest one.
+static int NumberOfDecoderThreads(int width, int height, int numberOfCores)
+{
+    int maxThreads = 1;
+    if (width * height == 0 || width * height >= 1280 * 720)
+    {
+        maxThreads = 4;
+    }
+    else if (width * height > 352 * 288)
+    {
+        maxThreads = 2;
+    }
+    if (numberOfCores < 1)
+    {
+        return 1;
+    }
+    return (numberOfCores < maxThreads) ? numberOfCores : maxThreads;
+}
+
+// The decoder can only spread a frame over several threads if its tokens
+// are split into several partitions, so use one partition per thread.
+static int TokenPartitionsForThreads(int threads)
+{
+    if (threads >= 4)
+    {
+        return VP8_FOUR_TOKENPARTITION;
+    }
+    if (threads >= 2)
+    {
+        return VP8_TWO_TOKENPARTITION;
+    }
+    return VP8_ONE_TOKENPARTITION;
+}
+
 VP8Encoder::VP8Encoder():
     _encodedImage(),
     _encodedCompleteCallback(NULL),
@@ -299,13 +353,11 @@ VP8Encoder::InitEncode(const VideoCodec* inst,
 #endif
     _cfg->g_lag_in_frames = 0; // 0- no frame lagging
 
-    // Determining number of threads based on the image size
-
-    if (_width * _height > 704 * 576 && numberOfCores > 1)
-      // 2 threads when larger than 4CIF
-      _cfg->g_threads = 2;
-    else
-      _cfg->g_threads = 1;
+    // Determining number of threads based on the image size and the number
+    // of cores. The token partitions follow the thread count so that a
+    // receiver with as many cores can decode the stream in parallel.
+    _cfg->g_threads = NumberOfEncoderThreads(_width, _height, numberOfCores);
+    _tokenPartitions = TokenPartitionsForThreads(_cfg->g_threads);
 
     // rate control settings
     _cfg->rc_dropframe_thresh = 30;
@@ -706,8 +758,18 @@ VP8Decoder::InitDecode(const VideoCodec* inst,
     }
 
     vpx_codec_dec_cfg_t  cfg;
-    // Setting number of threads to a constant value (1)
-    cfg.threads = 1;
+    // Rows of macroblocks are decoded in parallel, which requires the stream
+    // to be split into several token partitions. Streams with a single
+    // partition are decoded on one thread regardless of cfg.threads.
+    if (inst)
+    {
+        cfg.threads = NumberOfDecoderThreads(inst->width, inst->height,
+                                             numberOfCores);
+    }
+    else
+    {
+        cfg.threads = NumberOfDecoderThreads(0, 0, numberOfCores);
+    }
     cfg.h = cfg.w = 0; // set after decode
 
     vpx_codec_flags_t flags = 0;
@@ -17,21 +17,216 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <vector>
+
+#include "cpu_info.h"
+#include "event_wrapper.h"
 #include "module_common_types.h"
+#include "thread_wrapper.h"
 #include "trace.h"
 
 namespace webrtc {
 
-VP8SimulcastEncoder::VP8SimulcastEncoder() {
+// Scales the input image to the size of the layer, if needed, and encodes it.
+static WebRtc_Word32 EncodeLayer(VP8Encoder* encoder,
+                                 Scaler* scaler,
+                                 RawImage* scaled_frame,
+                                 const RawImage& input_image,
+                                 const CodecSpecificInfo* info,
+                                 VideoFrameType* frame_type) {
+  if (scaler) {
+    int video_frame_size = static_cast<int>(scaled_frame->_size);
+    scaler->Scale(input_image._buffer,
+                  scaled_frame->_buffer,
+                  video_frame_size);
+    scaled_frame->_length = scaled_frame->_size = video_frame_size;
+    return encoder->Encode(*scaled_frame, info, frame_type);
+  }
+  return encoder->Encode(input_image, info, frame_type);
+}
+
+// Encodes one simulcast layer on its own thread. The encoded images are kept
+// until the calling thread delivers them, so that the layers reach the
+// callback in the same order as when they are encoded one after another.
+class SimulcastLayerWorker : public EncodedImageCallback {
+ public:
+  SimulcastLayerWorker()
+      : thread_(NULL),
+        start_event_(EventWrapper::Create()),
+        done_event_(EventWrapper::Create()),
+        encode_pending_(false),
+        encoder_(NULL),
+        scaler_(NULL),
+        scaled_frame_(NULL),
+        input_image_(NULL),
+        frame_type_(kDeltaFrame),
+        result_(0),
+        num_encoded_(0) {
+  }
+
+  virtual ~SimulcastLayerWorker() {
+    Stop();
+    for (size_t i = 0; i < encoded_.size(); i++) {
+      delete [] encoded_[i]->image._buffer;
+      delete encoded_[i];
+    }
+    delete start_event_;
+    delete done_event_;
+  }
+
+  bool Start() {
+    if (thread_ != NULL) {
+      return true;
+    }
+    thread_ = ThreadWrapper::CreateThread(Run, this, kHighPriority,
+                                          "SimulcastLayerWorker");
+    unsigned int id = 0;
+    if (thread_ == NULL || !thread_->Start(id)) {
+      delete thread_;
+      thread_ = NULL;
+      return false;
+    }
+    return true;
+  }
+
+  void Stop() {
+    if (thread_ == NULL) {
+      return;
+    }
+    thread_->SetNotAlive();
+    start_event_->Set();
+    if (thread_->Stop()) {
+      delete thread_;
+    }
+    thread_ = NULL;
+  }
+
+  // Starts encoding the layer on the worker thread. The arguments must stay
+  // valid until WaitForEncode() returns.
+  void StartEncode(VP8Encoder* encoder,
+                   Scaler* scaler,
+                   RawImage* scaled_frame,
+                   const RawImage& input_image,
+                   const CodecSpecificInfo& info,
+                   VideoFrameType frame_type) {
+    encoder_ = encoder;
+    scaler_ = scaler;
+    scaled_frame_ = scaled_frame;
+    input_image_ = &input_image;
+    info_ = info;
+    frame_type_ = frame_type;
+    num_encoded_ = 0;
+    encode_pending_ = true;
+    start_event_->Set();
+  }
+
+  // Returns the return value of VP8Encoder::Encode().
+  WebRtc_Word32 WaitForEncode() {
+    done_event_->Wait(WEBRTC_EVENT_INFINITE);
+    return result_;
+  }
+
+  // Passes the images encoded by the last StartEncode() on to callback.
+  void DeliverEncoded(EncodedImageCallback* callback) {
+    for (int i = 0; i < num_encoded_; i++) {
+      EncodedFrame* frame = encoded_[i];
+      callback->Encoded(frame->image,
+                        &frame->info,
+                        frame->has_fragmentation ? &frame->fragmentation :
+                                                   NULL);
+    }
+    num_encoded_ = 0;
+  }
+
+  // Called by the layer encoder on the worker thread.
+  virtual WebRtc_Word32 Encoded(
+      EncodedImage& encodedImage,
+      const CodecSpecificInfo* codecSpecificInfo,
+      const RTPFragmentationHeader* fragmentation) {
+    if (num_encoded_ == static_cast<int>(encoded_.size())) {
+      encoded_.push_back(new EncodedFrame);
+    }
+    EncodedFrame* frame = encoded_[num_encoded_++];
+    WebRtc_UWord8* buffer = frame->image._buffer;
+    WebRtc_UWord32 size = frame->image._size;
+    if (size < encodedImage._length) {
+      delete [] buffer;
+      size = encodedImage._length;
+      buffer = new WebRtc_UWord8[size];
+    }
+    frame->image = encodedImage;  // Shallow copy.
+    frame->image._buffer = buffer;
+    frame->image._size = size;
+    memcpy(buffer, encodedImage._buffer, encodedImage._length);
+    if (codecSpecificInfo) {
+      frame->info = *codecSpecificInfo;
+    } else {
+      frame->info = info_;
+    }
+    frame->has_fragmentation = (fragmentation != NULL);
+    if (fragmentation) {
+      frame->fragmentation = *fragmentation;
+    }
+    return 0;
+  }
+
+ private:
+  struct EncodedFrame {
+    EncodedImage image;
+    CodecSpecificInfo info;
+    RTPFragmentationHeader fragmentation;
+    bool has_fragmentation;
+  };
+
+  static bool Run(ThreadObj obj) {
+    return static_cast<SimulcastLayerWorker*>(obj)->Process();
+  }
+
+  bool Process() {
+    if (start_event_->Wait(100) != kEventSignaled || !encode_pending_) {
+      // Timeout, or woken up to stop.
+      return true;
+    }
+    encode_pending_ = false;
+    result_ = EncodeLayer(encoder_, scaler_, scaled_frame_, *input_image_,
+                          &info_, &frame_type_);
+    done_event_->Set();
+    return true;
+  }
+
+  ThreadWrapper* thread_;
+  EventWrapper* start_event_;
+  EventWrapper* done_event_;
+  // Written by the calling thread before start_event_ is set, and read by
+  // the worker thread after it is signaled.
+  bool encode_pending_;
+  VP8Encoder* encoder_;
+  Scaler* scaler_;
+  RawImage* scaled_frame_;
+  const RawImage* input_image_;
+  CodecSpecificInfo info_;
+  VideoFrameType frame_type_;
+  // Written by the worker thread before done_event_ is set.
+  WebRtc_Word32 result_;
+  int num_encoded_;
+  std::vector<EncodedFrame*> encoded_;
+};
+
+VP8SimulcastEncoder::VP8SimulcastEncoder()
+    : encoded_complete_callback_(NULL),
+      parallel_encode_(false) {
   for (int i = 0; i < kMaxSimulcastStreams; i++) {
     encoder_[i] = NULL;
     encode_stream_[i] = false;
     frame_type_[i] = kKeyFrame;
     scaler_[i] = NULL;
+    worker_[i] = NULL;
   }
 }
 
 VP8SimulcastEncoder::~VP8SimulcastEncoder() {
+  StopWorkers();
   for (int i = 0; i < kMaxSimulcastStreams; i++) {
     delete encoder_[i];
     delete scaler_[i];
@@ -39,7 +234,19 @@ VP8SimulcastEncoder::~VP8SimulcastEncoder() {
   }
 }
 
+void VP8SimulcastEncoder::StopWorkers() {
+  for (int i = 0; i < kMaxSimulcastStreams; i++) {
+    if (worker_[i] && encoder_[i]) {
+      encoder_[i]->RegisterEncodeCompleteCallback(encoded_complete_callback_);
+    }
+    delete worker_[i];
+    worker_[i] = NULL;
+  }
+  parallel_encode_ = false;
+}
+
 WebRtc_Word32 VP8SimulcastEncoder::Release() {
+  StopWorkers();
   for (int i = 0; i < kMaxSimulcastStreams; i++) {
     delete encoder_[i];
     encoder_[i] = NULL;
@@ -72,6 +279,19 @@ WebRtc_Word32 VP8SimulcastEncoder::InitEncode(const VideoCodec* codecSettings,
   memcpy(&video_codec, codecSettings, sizeof(VideoCodec));
   video_codec.numberOfSimulcastStreams = 0;
 
+  StopWorkers();
+  // Never run more encoding threads than the machine has cores. The calling
+  // thread encodes the lower layers, so the workers take the top ones and
+  // the layers can still be delivered in order.
+  const WebRtc_Word32 available_cores = std::min(
+      numberOfCores,
+      static_cast<WebRtc_Word32>(CpuInfo::DetectNumberOfCores()));
+  const int num_workers = std::min<int>(
+      available_cores - 1, codecSettings->numberOfSimulcastStreams - 1);
+  const int first_worker_layer =
+      codecSettings->numberOfSimulcastStreams - num_workers;
+  parallel_encode_ = (num_workers > 0);
+
   WebRtc_UWord32 bitrate_sum = 0;
   WebRtc_Word32 ret_val = 0;
   for (int i = 0; i < codecSettings->numberOfSimulcastStreams; i++) {
@@ -79,6 +299,17 @@ WebRtc_Word32 VP8SimulcastEncoder::InitEncode(const VideoCodec* codecSettings,
       encoder_[i] = new VP8Encoder();
     }
     assert(encoder_[i]);
+    if (parallel_encode_ && i >= first_worker_layer) {
+      worker_[i] = new SimulcastLayerWorker();
+      if (!worker_[i]->Start()) {
+        WEBRTC_TRACE(webrtc::kTraceWarning,
+                     webrtc::kTraceVideoCoding,
+                     -1,
+                     "Failed to start VP8 simulcast worker, encoding the "
+                     "layers serially.");
+        StopWorkers();
+      }
+    }
 
     if (codecSettings->startBitrate > bitrate_sum) {
       frame_type_[i] = kKeyFrame;
@@ -105,7 +336,7 @@ WebRtc_Word32 VP8SimulcastEncoder::InitEncode(const VideoCodec* codecSettings,
 
     WebRtc_Word32 cores = 1;
     if (video_codec.width > 640 &&
-        numberOfCores > codecSettings->numberOfSimulcastStreams) {
+        available_cores > codecSettings->numberOfSimulcastStreams) {
       cores = 2;
     }
     ret_val = encoder_[i]->InitEncode(&video_codec,
@@ -137,6 +368,9 @@ WebRtc_Word32 VP8SimulcastEncoder::InitEncode(const VideoCodec* codecSettings,
       }
     }
   }
+  if (encoded_complete_callback_) {
+    RegisterEncodeCompleteCallback(encoded_complete_callback_);
+  }
   return ret_val;
 }
 
@@ -176,25 +410,66 @@ WebRtc_Word32  VP8SimulcastEncoder::Encode(
     }
   }
 
+  if (parallel_encode_) {
+    if (encoded_complete_callback_ == NULL) {
+      return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+    }
+    // Hand the top layers to the workers and encode the others here,
+    // directly to the callback. The worker layers are delivered after them,
+    // in order.
+    bool started[kMaxSimulcastStreams] = { false };
+    for (int i = 0; i < numberOfStreams; i++) {
+      if (worker_[i] && encoder_[i] && encode_stream_[i]) {
+        info.codecSpecific.VP8.simulcastIdx = i;
+        worker_[i]->StartEncode(encoder_[i], scaler_[i], &video_frame_[i],
+                                inputImage, info, frame_type_[i]);
+        started[i] = true;
+      }
+    }
+    WebRtc_Word32 error = 0;
+    for (int i = 0; i < numberOfStreams && error == 0; i++) {
+      if (worker_[i] || encoder_[i] == NULL || !encode_stream_[i]) {
+        continue;
+      }
+      info.codecSpecific.VP8.simulcastIdx = i;
+      VideoFrameType requested_frame_type = frame_type_[i];
+      ret_val = EncodeLayer(encoder_[i], scaler_[i], &video_frame_[i],
+                            inputImage, &info, &requested_frame_type);
+      if (ret_val < 0) {
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCoding, -1,
+                     "Encode error:%d on stream:%d", ret_val, i);
+        error = ret_val;
+      } else {
+        frame_type_[i] = kDeltaFrame;
+      }
+    }
+    // Always wait for all workers; they use inputImage.
+    for (int i = 0; i < numberOfStreams; i++) {
+      if (!started[i]) {
+        continue;
+      }
+      ret_val = worker_[i]->WaitForEncode();
+      if (ret_val < 0) {
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCoding, -1,
+                     "Encode error:%d on stream:%d", ret_val, i);
+        if (error == 0) {
+          error = ret_val;
+        }
+        continue;
+      }
+      worker_[i]->DeliverEncoded(encoded_complete_callback_);
+      frame_type_[i] = kDeltaFrame;
+    }
+    return (error < 0) ? error : ret_val;
+  }
+
   for (int i = 0; i < numberOfStreams; i++) {
     if (encoder_[i] && encode_stream_[i]) {
       // Need the simulcastIdx to keep track of which encoder encoded the frame.
       info.codecSpecific.VP8.simulcastIdx = i;
       VideoFrameType requested_frame_type = frame_type_[i];
-      if (scaler_[i]) {
-        int video_frame_size = static_cast<int>(video_frame_[i]._size);
-        scaler_[i]->Scale(inputImage._buffer,
-                          video_frame_[i]._buffer,
-                          video_frame_size);
-        video_frame_[i]._length = video_frame_[i]._size = video_frame_size;
-        ret_val = encoder_[i]->Encode(video_frame_[i],
-                                      &info,
-                                      &requested_frame_type);
-      } else {
-        ret_val = encoder_[i]->Encode(inputImage,
-                                      &info,
-                                      &requested_frame_type);
-      }
+      ret_val = EncodeLayer(encoder_[i], scaler_[i], &video_frame_[i],
+                            inputImage, &info, &requested_frame_type);
       if (ret_val < 0) {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCoding, -1,
                      "Encode error:%d on stream:%d", ret_val, i);
@@ -208,10 +483,16 @@ WebRtc_Word32  VP8SimulcastEncoder::Encode(
 
 WebRtc_Word32 VP8SimulcastEncoder::RegisterEncodeCompleteCallback(
     EncodedImageCallback* callback) {
+  encoded_complete_callback_ = callback;
   WebRtc_Word32 ret_val = 0;
   for (int i = 0; i < kMaxSimulcastStreams; i++) {
     if (encoder_[i]) {
-      ret_val = encoder_[i]->RegisterEncodeCompleteCallback(callback);
+      // The workers pass the encoded images on to the callback.
+      EncodedImageCallback* encoder_callback = callback;
+      if (worker_[i]) {
+        encoder_callback = worker_[i];
+      }
+      ret_val = encoder_[i]->RegisterEncodeCompleteCallback(encoder_callback);
       if (ret_val < 0) {
         WEBRTC_TRACE(webrtc::kTraceError,
                      webrtc::kTraceVideoCoding,
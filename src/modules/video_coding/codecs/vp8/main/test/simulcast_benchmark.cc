@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/**
+ * Benchmark of VP8SimulcastEncoder. Measures the time from the call to
+ * Encode() until all simulcast layers of the frame have been delivered, for
+ * three layers up to 720p and an increasing number of cores. With more than
+ * one core the layers are encoded in parallel.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "tick_util.h"
+#include "vp8_simulcast.h"
+
+namespace {
+
+const int kWidth = 1280;
+const int kHeight = 720;
+const int kFrameRate = 30;
+const int kNumFrames = 300;
+
+class CountingCallback : public webrtc::EncodedImageCallback
+{
+public:
+    CountingCallback() : _numEncoded(0), _lastSimulcastIdx(-1), _inOrder(true)
+    {
+    }
+
+    virtual WebRtc_Word32 Encoded(
+        webrtc::EncodedImage& encodedImage,
+        const webrtc::CodecSpecificInfo* codecSpecificInfo,
+        const webrtc::RTPFragmentationHeader* fragmentation)
+    {
+        const int idx = codecSpecificInfo->codecSpecific.VP8.simulcastIdx;
+        if (idx < _lastSimulcastIdx)
+        {
+            _inOrder = false;
+        }
+        _lastSimulcastIdx = idx;
+        _numEncoded++;
+        return 0;
+    }
+
+    void NewFrame() { _lastSimulcastIdx = -1; }
+
+    int  _numEncoded;
+    int  _lastSimulcastIdx;
+    bool _inOrder;
+};
+
+// Fills frame with a moving pattern, so that every frame has some motion.
+void FillFrame(WebRtc_UWord8* frame, int frameNumber)
+{
+    for (int y = 0; y < kHeight; y++)
+    {
+        for (int x = 0; x < kWidth; x++)
+        {
+            frame[y * kWidth + x] =
+                static_cast<WebRtc_UWord8>((x + frameNumber * 4) ^ y);
+        }
+    }
+    memset(frame + kWidth * kHeight, 128, kWidth * kHeight / 2);
+}
+
+void SetUpCodec(webrtc::VideoCodec* codec)
+{
+    memset(codec, 0, sizeof(webrtc::VideoCodec));
+    codec->codecType = webrtc::kVideoCodecVP8;
+    strncpy(codec->plName, "VP8", webrtc::kPayloadNameSize);
+    codec->plType = 120;
+    codec->width = kWidth;
+    codec->height = kHeight;
+    codec->maxFramerate = kFrameRate;
+    codec->codecSpecific.VP8.complexity = webrtc::kComplexityNormal;
+    codec->codecSpecific.VP8.numberOfTemporalLayers = 1;
+    codec->numberOfSimulcastStreams = 3;
+    const unsigned int maxBitrate[] = {150, 500, 1200};
+    for (int i = 0; i < codec->numberOfSimulcastStreams; i++)
+    {
+        const int scale = 1 << (codec->numberOfSimulcastStreams - 1 - i);
+        codec->simulcastStream[i].width = kWidth / scale;
+        codec->simulcastStream[i].height = kHeight / scale;
+        codec->simulcastStream[i].numberOfTemporalLayers = 1;
+        codec->simulcastStream[i].maxBitrate = maxBitrate[i];
+        codec->simulcastStream[i].qpMax = 56;
+        codec->startBitrate += maxBitrate[i];
+    }
+    codec->maxBitrate = codec->startBitrate;
+    codec->qpMax = 56;
+}
+
+// Returns -1 on error.
+int RunBenchmark(int numberOfCores)
+{
+    webrtc::VideoCodec codec;
+    SetUpCodec(&codec);
+    webrtc::VP8SimulcastEncoder encoder;
+    CountingCallback callback;
+    encoder.RegisterEncodeCompleteCallback(&callback);
+    if (encoder.InitEncode(&codec, numberOfCores, 1440) < 0)
+    {
+        printf("Error: InitEncode() failed\n");
+        return -1;
+    }
+
+    const WebRtc_UWord32 frameLength = kWidth * kHeight * 3 / 2;
+    WebRtc_UWord8* frameBuffer = new WebRtc_UWord8[frameLength];
+    webrtc::RawImage inputImage(frameBuffer, frameLength, frameLength);
+    inputImage._width = kWidth;
+    inputImage._height = kHeight;
+    webrtc::CodecSpecificInfo info;
+    memset(&info, 0, sizeof(info));
+    info.codecType = webrtc::kVideoCodecVP8;
+    webrtc::VideoFrameType frameTypes[webrtc::kMaxSimulcastStreams];
+    for (int i = 0; i < webrtc::kMaxSimulcastStreams; i++)
+    {
+        frameTypes[i] = webrtc::kDeltaFrame;
+    }
+
+    webrtc::TickInterval totalTime;
+    WebRtc_Word64 maxTimeUs = 0;
+    for (int frame = 0; frame < kNumFrames; frame++)
+    {
+        FillFrame(frameBuffer, frame);
+        inputImage._timeStamp = frame * (90000 / kFrameRate);
+        callback.NewFrame();
+
+        const webrtc::TickTime startTime = webrtc::TickTime::Now();
+        if (encoder.Encode(inputImage, &info, frameTypes) < 0)
+        {
+            printf("Error: Encode() failed\n");
+            delete [] frameBuffer;
+            return -1;
+        }
+        const webrtc::TickInterval frameTime =
+            webrtc::TickTime::Now() - startTime;
+        totalTime += frameTime;
+        if (frameTime.Microseconds() > maxTimeUs)
+        {
+            maxTimeUs = frameTime.Microseconds();
+        }
+    }
+    encoder.Release();
+    delete [] frameBuffer;
+
+    if (!callback._inOrder)
+    {
+        printf("Error: simulcast layers delivered out of order\n");
+        return -1;
+    }
+    printf("%d cores: %d layers, %d encoded images, encode latency "
+           "%.2f ms/frame (max %.2f ms)\n",
+           numberOfCores, codec.numberOfSimulcastStreams,
+           callback._numEncoded,
+           totalTime.Microseconds() / 1000.0 / kNumFrames,
+           maxTimeUs / 1000.0);
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    const int numberOfCores[] = {1, 2, 4};
+    for (size_t i = 0; i < sizeof(numberOfCores) / sizeof(*numberOfCores);
+         i++)
+    {
+        if (RunBenchmark(numberOfCores[i]) != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -18,6 +18,7 @@
 #include "packet_loss_test.h"
 #include "unit_test.h"
 #include "rps_test.h"
+#include "thread_benchmark.h"
 #include "testsupport/fileutils.h"
 #include "vp8.h"
 
@@ -29,6 +30,7 @@ void PopulateTests(std::vector<Test*>* tests)
 //    tests->push_back(new VP8UnitTest());
 //    tests->push_back(new VP8DualDecoderTest());
 //    tests->push_back(new VP8Benchmark());
+//    tests->push_back(new VP8ThreadBenchmark());
 //    tests->push_back(new VP8PacketLossTest(0.05, false, 5));
     tests->push_back(new VP8NormalAsyncTest());
 }
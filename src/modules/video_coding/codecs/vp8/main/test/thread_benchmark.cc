@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "thread_benchmark.h"
+
+#include <iostream>
+#include <sstream>
+
+#include "testsupport/fileutils.h"
+#include "../../../test_framework/video_source.h"
+
+VP8ThreadBenchmark::VP8ThreadBenchmark()
+:
+VP8Benchmark("VP8ThreadBenchmark",
+             "VP8 speed versus number of threads",
+             webrtc::test::OutputPath() + "VP8ThreadBenchmark.txt")
+{
+}
+
+void
+VP8ThreadBenchmark::Perform()
+{
+    // Configuration --------------------------
+    const VideoSource source(webrtc::test::ProjectRootPath() +
+                             "resources/foreman_cif.yuv", kCIF);
+    const VideoSize size[] = {kCIF, kVGA, kWHD};
+    const int bitRate[] = {500, 1000, 2000};
+    const int numberOfCores[] = {1, 2, 4, 8};
+    const int frameRate = 30;
+    // ----------------------------------------
+
+    const int nSizes = sizeof(size)/sizeof(*size);
+    const int nCores = sizeof(numberOfCores)/sizeof(*numberOfCores);
+    double encodeFps[nCores];
+    double decodeFps[nCores];
+
+    _results.open(_resultsFileName.c_str(), std::fstream::out);
+    _results << GetMagicStr() << std::endl;
+    _results << _codecName << std::endl;
+
+    for (int i = 0; i < nSizes; i++)
+    {
+        std::stringstream ss;
+        std::string strFrameRate;
+        ss << frameRate;
+        ss >> strFrameRate;
+        const std::string outFileName = source.GetFilePath() + "/" +
+            source.GetName() + "_" + VideoSource::GetSizeString(size[i]) +
+            "_" + strFrameRate + ".yuv";
+
+        _target = new const VideoSource(outFileName, size[i], frameRate);
+        source.Convert(*_target);
+        if (VideoSource::FileExists(outFileName.c_str()))
+        {
+            _inname = outFileName;
+        }
+        else
+        {
+            _inname = source.GetFileName();
+        }
+        _bitRate = bitRate[i];
+
+        for (int k = 0; k < nCores; k++)
+        {
+            _encoderCores = numberOfCores[k];
+            _decoderCores = numberOfCores[k];
+            PerformNormalTest();
+            _appendNext = false;
+            encodeFps[k] = (_totalEncodeTime > 0) ?
+                _encFrameCnt / _totalEncodeTime : 0;
+            decodeFps[k] = (_totalDecodeTime > 0) ?
+                _framecnt / _totalDecodeTime : 0;
+        }
+
+        std::cout << source.GetName() << ", " <<
+            VideoSource::GetSizeString(size[i]) << ", " << _bitRate <<
+            " kbps" << std::endl << "Cores:";
+        _results << source.GetName() << "," <<
+            VideoSource::GetSizeString(size[i]) << "," << _bitRate <<
+            " kbps" << std::endl << "Cores";
+        for (int k = 0; k < nCores; k++)
+        {
+            std::cout << " " << numberOfCores[k];
+            _results << "," << numberOfCores[k];
+        }
+        std::cout << std::endl << "Encode Speed [fps]:";
+        _results << std::endl << "Encode Speed [fps]";
+        for (int k = 0; k < nCores; k++)
+        {
+            std::cout << " " << static_cast<int>(encodeFps[k] + 0.5);
+            _results << "," << static_cast<int>(encodeFps[k] + 0.5);
+        }
+        std::cout << std::endl << "Decode Speed [fps]:";
+        _results << std::endl << "Decode Speed [fps]";
+        for (int k = 0; k < nCores; k++)
+        {
+            std::cout << " " << static_cast<int>(decodeFps[k] + 0.5);
+            _results << "," << static_cast<int>(decodeFps[k] + 0.5);
+        }
+        std::cout << std::endl << std::endl;
+        _results << std::endl << std::endl;
+
+        delete _target;
+    }
+    _results.close();
+}
@@ -0,0 +1,25 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_THREAD_BENCHMARK_H_
+#define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_THREAD_BENCHMARK_H_
+
+#include "benchmark.h"
+
+// Measures the encode and decode speed of VP8 for an increasing number of
+// cores, over a range of resolutions.
+class VP8ThreadBenchmark : public VP8Benchmark
+{
+public:
+    VP8ThreadBenchmark();
+    virtual void Perform();
+};
+
+#endif // WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_THREAD_BENCHMARK_H_
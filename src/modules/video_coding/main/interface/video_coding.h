@@ -20,6 +20,7 @@ namespace webrtc
 
 class VideoEncoder;
 class VideoDecoder;
+class PacketBuffer;
 struct CodecSpecificInfo;
 
 class VideoCodingModule : public Module
@@ -440,6 +441,23 @@ public:
                                        WebRtc_UWord32 payloadLength,
                                        const WebRtcRTPHeader& rtpInfo) = 0;
 
+    // Same as above, for a payload which lies within a reference counted buffer.
+    // The jitter buffer keeps a reference to the buffer until the frame is
+    // assembled instead of copying the payload when the packet arrives.
+    //
+    // Input:
+    //      - incomingPayload      : Payload of the packet.
+    //      - payloadLength        : Length of the payload.
+    //      - rtpInfo              : The parsed header.
+    //      - buffer               : The buffer holding the payload, or NULL.
+    //
+    // Return value      : VCM_OK, on success.
+    //                     < 0,         on error.
+    virtual WebRtc_Word32 IncomingPacket(const WebRtc_UWord8* incomingPayload,
+                                       WebRtc_UWord32 payloadLength,
+                                       const WebRtcRTPHeader& rtpInfo,
+                                       PacketBuffer* buffer) = 0;
+
     // Sets codec config parameters received out-of-band to the currently
     // selected receive codec.
     //
@@ -42,6 +42,11 @@ _nackCount(rhs._nackCount),
 _latestPacketTimeMs(rhs._latestPacketTimeMs)
 {
     _sessionInfo = rhs._sessionInfo;
+    if (_buffer != NULL && rhs._buffer != NULL)
+    {
+        // The packets must refer to the copied data.
+        _sessionInfo.UpdateDataPointers(_buffer - rhs._buffer);
+    }
 }
 
 webrtc::FrameType
@@ -208,18 +213,6 @@ VCMFrameBuffer::LatestPacketTimeMs()
     return _latestPacketTimeMs;
 }
 
-// Zero out all entries in list up to and including the (first)
-// entry equal to _lowSeqNum
-WebRtc_Word32
-VCMFrameBuffer::ZeroOutSeqNum(WebRtc_Word32* list, WebRtc_Word32 num)
-{
-    if (_sessionInfo.ZeroOutSeqNum(list, num) != 0)
-    {
-       return -1;
-    }
-    return 0;
-}
-
 // Zero out all entries in list up to and including the (first) entry equal to
 // _lowSeqNum. Hybrid mode: 1. Don't NACK FEC packets 2. Make a smart decision
 // on whether to NACK or not
@@ -380,6 +373,14 @@ int VCMFrameBuffer::NotDecodablePackets() const {
   return _sessionInfo.packets_not_decodable();
 }
 
+int VCMFrameBuffer::PacketsHeld() const {
+  return _sessionInfo.packets_held();
+}
+
+WebRtc_Word64 VCMFrameBuffer::BytesCopied() const {
+  return _sessionInfo.bytes_copied();
+}
+
 // Set counted status (as counted by JB or not)
 void VCMFrameBuffer::SetCountedFrame(bool frameCounted)
 {
@@ -67,8 +67,6 @@ public:
     bool GetCountedFrame() const;
 
     // NACK
-    // Zero out all entries in list up to and including _lowSeqNum
-    WebRtc_Word32 ZeroOutSeqNum(WebRtc_Word32* list, WebRtc_Word32 num);
     // Hybrid extension: only NACK important packets, discard FEC packets
     WebRtc_Word32 ZeroOutSeqNumHybrid(WebRtc_Word32* list,
                                       WebRtc_Word32 num,
@@ -86,6 +84,9 @@ public:
     // The number of packets discarded because the decoder can't make use of
     // them.
     int NotDecodablePackets() const;
+    // Payload copy counters of the frame buffer, since construction.
+    int PacketsHeld() const;
+    WebRtc_Word64 BytesCopied() const;
 
 protected:
     void RestructureFrameInformation();
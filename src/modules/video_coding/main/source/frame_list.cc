@@ -24,44 +24,70 @@ void
 VCMFrameListTimestampOrderAsc::Flush()
 {
     while(Erase(First()) != -1) { }
+    _timestampIndex.clear();
 }
 
 // Inserts frame in timestamp order, with the oldest timestamp first. Takes wrap
-// arounds into account
+// arounds into account. New frames are usually the newest ones, so the search
+// for the insert position starts from the end of the list.
 WebRtc_Word32
 VCMFrameListTimestampOrderAsc::Insert(VCMFrameBuffer* frame)
 {
-    VCMFrameListItem* item = static_cast<VCMFrameListItem*>(First());
+    VCMFrameListItem* item = static_cast<VCMFrameListItem*>(Last());
     VCMFrameListItem* newItem = new VCMFrameListItem(frame);
-    bool inserted = false;
     if (newItem == NULL)
     {
         return -1;
     }
+    newItem->_timestamp = frame->TimeStamp();
     while (item != NULL)
     {
         const WebRtc_UWord32 itemTimestamp = item->GetItem()->TimeStamp();
-        if (LatestTimestamp(itemTimestamp, frame->TimeStamp(), NULL) ==
+        if (LatestTimestamp(itemTimestamp, frame->TimeStamp(), NULL) !=
             itemTimestamp)
         {
-            if (InsertBefore(item, newItem) < 0)
-            {
-                delete newItem;
-                return -1;
-            }
-            inserted = true;
+            // Found the newest frame older than this one.
             break;
         }
-        item = Next(item);
+        item = Previous(item);
     }
-    if (!inserted && ListWrapper::Insert(ListWrapper::Last(), newItem) < 0)
+    WebRtc_Word32 ret = 0;
+    if (item != NULL)
+    {
+        ret = ListWrapper::Insert(item, newItem);
+    }
+    else if (First() != NULL)
+    {
+        ret = InsertBefore(First(), newItem);
+    }
+    else
+    {
+        ret = ListWrapper::Insert(ListWrapper::Last(), newItem);
+    }
+    if (ret < 0)
     {
         delete newItem;
         return -1;
     }
+    _timestampIndex[newItem->_timestamp] = newItem;
     return 0;
 }
 
+WebRtc_Word32
+VCMFrameListTimestampOrderAsc::Erase(VCMFrameListItem* item)
+{
+    if (item == NULL)
+    {
+        return -1;
+    }
+    TimestampIndex::iterator it = _timestampIndex.find(item->_timestamp);
+    if (it != _timestampIndex.end() && it->second == item)
+    {
+        _timestampIndex.erase(it);
+    }
+    return ListWrapper::Erase(item);
+}
+
 VCMFrameBuffer*
 VCMFrameListTimestampOrderAsc::FirstFrame() const
 {
@@ -113,5 +139,23 @@ VCMFrameListTimestampOrderAsc::FindFrame(FindFrameCriteria criteria,
     return frameListItem->GetItem();
 }
 
+VCMFrameBuffer*
+VCMFrameListTimestampOrderAsc::FindFrame(WebRtc_UWord32 timestamp) const
+{
+    TimestampIndex::const_iterator it = _timestampIndex.find(timestamp);
+    if (it == _timestampIndex.end())
+    {
+        return NULL;
+    }
+    VCMFrameBuffer* frame = it->second->GetItem();
+    // A frame which has been reset keeps its list position until it's
+    // cleaned out, but no longer belongs to the timestamp.
+    if (frame->TimeStamp() != timestamp)
+    {
+        return NULL;
+    }
+    return frame;
+}
+
 }
 
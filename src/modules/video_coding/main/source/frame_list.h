@@ -13,6 +13,7 @@
 
 #include "list_wrapper.h"
 #include "typedefs.h"
+#include <map>
 #include <stdlib.h>
 
 namespace webrtc
@@ -26,11 +27,15 @@ class VCMFrameListItem : public ListItem
 {
     friend class VCMFrameListTimestampOrderAsc;
 public:
-    VCMFrameListItem(const VCMFrameBuffer* ptr) : ListItem(ptr) {}
+    VCMFrameListItem(const VCMFrameBuffer* ptr)
+        : ListItem(ptr), _timestamp(0) {}
     ~VCMFrameListItem() {};
 
     VCMFrameBuffer* GetItem() const
             { return static_cast<VCMFrameBuffer*>(ListItem::GetItem()); }
+private:
+    // The timestamp the item is indexed by
+    WebRtc_UWord32 _timestamp;
 };
 
 class VCMFrameListTimestampOrderAsc : public ListWrapper
@@ -44,6 +49,8 @@ public:
     // Inserts frame in timestamp order, with the oldest timestamp first.
     // Takes wrap arounds into account.
     WebRtc_Word32 Insert(VCMFrameBuffer* frame);
+    // Removes item from the list and the timestamp index, and deletes it.
+    WebRtc_Word32 Erase(VCMFrameListItem* item);
     VCMFrameBuffer* FirstFrame() const;
     VCMFrameListItem* Next(VCMFrameListItem* item) const
             { return static_cast<VCMFrameListItem*>(ListWrapper::Next(item)); }
@@ -59,6 +66,12 @@ public:
     VCMFrameBuffer* FindFrame(FindFrameCriteria criteria,
                                              const void* compareWith = NULL,
                                              VCMFrameListItem* startItem = NULL) const;
+    // Looks up the frame with this timestamp in the timestamp index.
+    VCMFrameBuffer* FindFrame(WebRtc_UWord32 timestamp) const;
+
+private:
+    typedef std::map<WebRtc_UWord32, VCMFrameListItem*> TimestampIndex;
+    TimestampIndex _timestampIndex;
 };
 
 } // namespace webrtc
@@ -16,6 +16,7 @@
 #include "jitter_buffer.h"
 #include "jitter_buffer_common.h"
 #include "jitter_estimator.h"
+#include "nack_tracker.h"
 #include "packet.h"
 
 #include "event.h"
@@ -34,18 +35,6 @@
 
 namespace webrtc {
 
-// Criteria used when searching for frames in the frame buffer list
-bool
-VCMJitterBuffer::FrameEqualTimestamp(VCMFrameBuffer* frame,
-                                     const void* timestamp)
-{
-    if (timestamp == NULL)
-    {
-        return false;
-    }
-    return (*static_cast<const WebRtc_UWord32*>(timestamp)) == frame->TimeStamp();
-}
-
 bool
 VCMJitterBuffer::CompleteDecodableKeyFrameCriteria(VCMFrameBuffer* frame,
                                                    const void* /*notUsed*/)
@@ -56,6 +45,23 @@ VCMJitterBuffer::CompleteDecodableKeyFrameCriteria(VCMFrameBuffer* frame,
            (state == kStateComplete || state == kStateDecodable);
 }
 
+// Number of sequence numbers after lowSeqNum up to and including highSeqNum.
+int
+VCMJitterBuffer::SequenceNumberSpan(WebRtc_Word32 lowSeqNum,
+                                    WebRtc_Word32 highSeqNum)
+{
+    if (lowSeqNum > highSeqNum)
+    {
+        if (lowSeqNum - highSeqNum > 0x00ff)
+        {
+            // wrap
+            return (0xffff - lowSeqNum) + highSeqNum + 1;
+        }
+        return 0;
+    }
+    return highSeqNum - lowSeqNum;
+}
+
 // Constructor
 VCMJitterBuffer::VCMJitterBuffer(WebRtc_Word32 vcmId, WebRtc_Word32 receiverId,
                                  bool master) :
@@ -66,9 +72,10 @@ VCMJitterBuffer::VCMJitterBuffer(WebRtc_Word32 vcmId, WebRtc_Word32 receiverId,
     _master(master),
     _frameEvent(),
     _packetEvent(),
-    _maxNumberOfFrames(kStartNumberOfFrames),
     _frameBuffers(),
     _frameBuffersTSOrder(),
+    _peakFramesInUse(0),
+    _timeLastFramePoolResize(VCMTickTime::MillisecondTimestamp()),
     _lastDecodedState(),
     _packetsNotDecodable(0),
     _receiveStatistics(),
@@ -80,6 +87,8 @@ VCMJitterBuffer::VCMJitterBuffer(WebRtc_Word32 vcmId, WebRtc_Word32 receiverId,
     _numConsecutiveOldFrames(0),
     _numConsecutiveOldPackets(0),
     _discardedPackets(0),
+    _releasedPacketsHeld(0),
+    _releasedBytesCopied(0),
     _jitterEstimate(vcmId, receiverId),
     _rttMs(0),
     _nackMode(kNoNack),
@@ -87,16 +96,16 @@ VCMJitterBuffer::VCMJitterBuffer(WebRtc_Word32 vcmId, WebRtc_Word32 receiverId,
     _highRttNackThresholdMs(-1),
     _NACKSeqNum(),
     _NACKSeqNumLength(0),
+    _nackTracker(kNackHistoryLength),
     _waitingForKeyFrame(false),
     _firstPacket(true)
 {
-    memset(_frameBuffers, 0, sizeof(_frameBuffers));
     memset(_receiveStatistics, 0, sizeof(_receiveStatistics));
     memset(_NACKSeqNumInternal, -1, sizeof(_NACKSeqNumInternal));
 
     for (int i = 0; i< kStartNumberOfFrames; i++)
     {
-        _frameBuffers[i] = new VCMFrameBuffer();
+        _frameBuffers.push_back(new VCMFrameBuffer());
     }
 }
 
@@ -104,12 +113,9 @@ VCMJitterBuffer::VCMJitterBuffer(WebRtc_Word32 vcmId, WebRtc_Word32 receiverId,
 VCMJitterBuffer::~VCMJitterBuffer()
 {
     Stop();
-    for (int i = 0; i< kMaxNumberOfFrames; i++)
+    for (unsigned int i = 0; i < _frameBuffers.size(); i++)
     {
-        if (_frameBuffers[i])
-        {
-            delete _frameBuffers[i];
-        }
+        delete _frameBuffers[i];
     }
     delete _critSect;
 }
@@ -125,7 +131,8 @@ VCMJitterBuffer::CopyFrom(const VCMJitterBuffer& rhs)
         _receiverId = rhs._receiverId;
         _running = rhs._running;
         _master = !rhs._master;
-        _maxNumberOfFrames = rhs._maxNumberOfFrames;
+        _peakFramesInUse = rhs._peakFramesInUse;
+        _timeLastFramePoolResize = rhs._timeLastFramePoolResize;
         _incomingFrameRate = rhs._incomingFrameRate;
         _incomingFrameCount = rhs._incomingFrameCount;
         _timeLastIncomingFrameCount = rhs._timeLastIncomingFrameCount;
@@ -134,6 +141,8 @@ VCMJitterBuffer::CopyFrom(const VCMJitterBuffer& rhs)
         _numConsecutiveOldFrames = rhs._numConsecutiveOldFrames;
         _numConsecutiveOldPackets = rhs._numConsecutiveOldPackets;
         _discardedPackets = rhs._discardedPackets;
+        _releasedPacketsHeld = rhs._releasedPacketsHeld;
+        _releasedBytesCopied = rhs._releasedBytesCopied;
         _jitterEstimate = rhs._jitterEstimate;
         _delayEstimate = rhs._delayEstimate;
         _waitingForCompletion = rhs._waitingForCompletion;
@@ -148,17 +157,14 @@ VCMJitterBuffer::CopyFrom(const VCMJitterBuffer& rhs)
         memcpy(_NACKSeqNumInternal, rhs._NACKSeqNumInternal,
                sizeof(_NACKSeqNumInternal));
         memcpy(_NACKSeqNum, rhs._NACKSeqNum, sizeof(_NACKSeqNum));
-        for (int i = 0; i < kMaxNumberOfFrames; i++)
+        _nackTracker = rhs._nackTracker;
+        for (unsigned int i = 0; i < _frameBuffers.size(); i++)
         {
-            if (_frameBuffers[i] != NULL)
-            {
-                delete _frameBuffers[i];
-                _frameBuffers[i] = NULL;
-            }
+            delete _frameBuffers[i];
         }
-        while(_frameBuffersTSOrder.Erase(_frameBuffersTSOrder.First()) != -1)
-        { }
-        for (int i = 0; i < _maxNumberOfFrames; i++)
+        _frameBuffersTSOrder.Flush();
+        _frameBuffers.resize(rhs._frameBuffers.size());
+        for (unsigned int i = 0; i < _frameBuffers.size(); i++)
         {
             _frameBuffers[i] = new VCMFrameBuffer(*(rhs._frameBuffers[i]));
             if (_frameBuffers[i]->Length() > 0)
@@ -194,6 +200,7 @@ VCMJitterBuffer::Start()
     _waitingForCompletion.latestPacketTime = -1;
     _firstPacket = true;
     _NACKSeqNumLength = 0;
+    _nackTracker.Reset();
     _waitingForKeyFrame = false;
     _rttMs = 0;
     _packetsNotDecodable = 0;
@@ -210,13 +217,11 @@ VCMJitterBuffer::Stop()
     _critSect->Enter();
     _running = false;
     _lastDecodedState.Reset();
+    _nackTracker.Reset();
     _frameBuffersTSOrder.Flush();
-    for (int i = 0; i < kMaxNumberOfFrames; i++)
+    for (unsigned int i = 0; i < _frameBuffers.size(); i++)
     {
-        if (_frameBuffers[i] != NULL)
-        {
-            static_cast<VCMFrameBuffer*>(_frameBuffers[i])->SetState(kStateFree);
-        }
+        _frameBuffers[i]->SetState(kStateFree);
     }
 
     _critSect->Leave();
@@ -247,7 +252,7 @@ VCMJitterBuffer::FlushInternal()
 {
     // Erase all frames from the sorted list and set their state to free.
     _frameBuffersTSOrder.Flush();
-    for (WebRtc_Word32 i = 0; i < _maxNumberOfFrames; i++)
+    for (unsigned int i = 0; i < _frameBuffers.size(); i++)
     {
         ReleaseFrameInternal(_frameBuffers[i]);
     }
@@ -271,6 +276,7 @@ VCMJitterBuffer::FlushInternal()
     _firstPacket = true;
 
     _NACKSeqNumLength = 0;
+    _nackTracker.Reset();
 
     WEBRTC_TRACE(webrtc::kTraceDebug, webrtc::kTraceVideoCoding, VCMId(_vcmId,
                  _receiverId), "JB(0x%x): Jitter buffer: flush", this);
@@ -422,6 +428,17 @@ WebRtc_UWord32 VCMJitterBuffer::DiscardedPackets() const {
   return _discardedPackets;
 }
 
+void VCMJitterBuffer::PayloadCopyStatistics(WebRtc_UWord32& packetsHeld,
+                                            WebRtc_Word64& bytesCopied) const {
+  CriticalSectionScoped cs(_critSect);
+  packetsHeld = _releasedPacketsHeld;
+  bytesCopied = _releasedBytesCopied;
+  for (size_t i = 0; i < _frameBuffers.size(); ++i) {
+    packetsHeld += _frameBuffers[i]->PacketsHeld();
+    bytesCopied += _frameBuffers[i]->BytesCopied();
+  }
+}
+
 // Gets frame to use for this timestamp. If no match, get empty frame.
 WebRtc_Word32
 VCMJitterBuffer::GetFrame(const VCMPacket& packet, VCMEncodedFrame*& frame)
@@ -452,8 +469,7 @@ VCMJitterBuffer::GetFrame(const VCMPacket& packet, VCMEncodedFrame*& frame)
     }
     _numConsecutiveOldPackets = 0;
 
-    frame = _frameBuffersTSOrder.FindFrame(FrameEqualTimestamp,
-                                           &packet.timestamp);
+    frame = _frameBuffersTSOrder.FindFrame(packet.timestamp);
 
     _critSect->Leave();
 
@@ -504,29 +520,46 @@ VCMJitterBuffer::GetEmptyFrame()
 
     _critSect->Enter();
 
-    for (int i = 0; i <_maxNumberOfFrames; ++i)
+    VCMFrameBuffer* freeFrame = NULL;
+    int framesInUse = 0;
+    for (unsigned int i = 0; i < _frameBuffers.size(); ++i)
     {
-        if (kStateFree == _frameBuffers[i]->GetState())
+        if (kStateFree != _frameBuffers[i]->GetState())
         {
-            // found a free buffer
-            _frameBuffers[i]->SetState(kStateEmpty);
-            _critSect->Leave();
-            return _frameBuffers[i];
+            framesInUse++;
+        }
+        else if (freeFrame == NULL)
+        {
+            freeFrame = _frameBuffers[i];
         }
     }
+    // Count the frame about to be handed out as well.
+    if (framesInUse + 1 > _peakFramesInUse)
+    {
+        _peakFramesInUse = framesInUse + 1;
+    }
+    ShrinkFramePool();
+
+    if (freeFrame != NULL)
+    {
+        // found a free buffer
+        freeFrame->SetState(kStateEmpty);
+        _critSect->Leave();
+        return freeFrame;
+    }
 
     // Check if we can increase JB size
-    if (_maxNumberOfFrames < kMaxNumberOfFrames)
+    if (_frameBuffers.size() < kMaxNumberOfFrames)
     {
         VCMFrameBuffer* ptrNewBuffer = new VCMFrameBuffer();
         ptrNewBuffer->SetState(kStateEmpty);
-        _frameBuffers[_maxNumberOfFrames] = ptrNewBuffer;
-        _maxNumberOfFrames++;
+        _frameBuffers.push_back(ptrNewBuffer);
 
         _critSect->Leave();
         WEBRTC_TRACE(webrtc::kTraceDebug, webrtc::kTraceVideoCoding,
         VCMId(_vcmId, _receiverId), "JB(0x%x) FB(0x%x): Jitter buffer "
-        "increased to:%d frames", this, ptrNewBuffer, _maxNumberOfFrames);
+        "increased to:%d frames", this, ptrNewBuffer,
+        static_cast<int>(_frameBuffers.size()));
         return ptrNewBuffer;
     }
     _critSect->Leave();
@@ -535,6 +568,45 @@ VCMJitterBuffer::GetEmptyFrame()
     return NULL;
 }
 
+// Releases free frames which haven't been needed for a while. The pool is
+// shrunk to twice the peak number of frames in use since the last resize.
+// Must be called from within _critSect.
+void
+VCMJitterBuffer::ShrinkFramePool()
+{
+    const WebRtc_Word64 nowMs = VCMTickTime::MillisecondTimestamp();
+    if (nowMs - _timeLastFramePoolResize < kFramePoolResizeIntervalMs)
+    {
+        return;
+    }
+    unsigned int targetSize = 2 * _peakFramesInUse;
+    if (targetSize < kStartNumberOfFrames)
+    {
+        targetSize = kStartNumberOfFrames;
+    }
+    unsigned int i = 0;
+    while (_frameBuffers.size() > targetSize && i < _frameBuffers.size())
+    {
+        if (kStateFree == _frameBuffers[i]->GetState())
+        {
+            _releasedPacketsHeld += _frameBuffers[i]->PacketsHeld();
+            _releasedBytesCopied += _frameBuffers[i]->BytesCopied();
+            delete _frameBuffers[i];
+            _frameBuffers.erase(_frameBuffers.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+    WEBRTC_TRACE(webrtc::kTraceDebug, webrtc::kTraceVideoCoding,
+                 VCMId(_vcmId, _receiverId), "JB(0x%x): Jitter buffer "
+                 "pool is %d frames, peak usage %d frames", this,
+                 static_cast<int>(_frameBuffers.size()), _peakFramesInUse);
+    _peakFramesInUse = 0;
+    _timeLastFramePoolResize = nowMs;
+}
+
 
 // Find oldest complete frame used for getting next frame to decode
 // Must be called under critical section
@@ -1204,47 +1276,10 @@ VCMJitterBuffer::GetNackList(WebRtc_UWord16& nackSize,bool& listExtended)
     return CreateNackList(nackSize,listExtended);
 }
 
-// Assume called internally with critsect
-WebRtc_Word32
-VCMJitterBuffer::GetLowHighSequenceNumbers(WebRtc_Word32& lowSeqNum,
-                                           WebRtc_Word32& highSeqNum) const
-{
-    // TODO (mikhal/stefan): refactor to use lastDecodedState
-    WebRtc_Word32 i = 0;
-    WebRtc_Word32 seqNum = -1;
-
-    highSeqNum = -1;
-    lowSeqNum = _lastDecodedState.sequence_num();
-
-    // find highest seq numbers
-    for (i = 0; i < _maxNumberOfFrames; ++i)
-    {
-        seqNum = _frameBuffers[i]->GetHighSeqNum();
-
-        // Ignore free / empty frames
-        VCMFrameBufferStateEnum state = _frameBuffers[i]->GetState();
-
-        if ((kStateFree != state) &&
-            (kStateEmpty != state) &&
-            (kStateDecoding != state) &&
-             seqNum != -1)
-        {
-            bool wrap;
-            highSeqNum = LatestSequenceNumber(seqNum, highSeqNum, &wrap);
-        }
-    } // for
-    return 0;
-}
-
-
 WebRtc_UWord16*
 VCMJitterBuffer::CreateNackList(WebRtc_UWord16& nackSize, bool& listExtended)
 {
-    // TODO (mikhal/stefan): Refactor to use lastDecodedState.
     CriticalSectionScoped cs(_critSect);
-    int i = 0;
-    WebRtc_Word32 lowSeqNum = -1;
-    WebRtc_Word32 highSeqNum = -1;
     listExtended = false;
 
     // Don't create list, if we won't wait for it
@@ -1254,43 +1289,18 @@ VCMJitterBuffer::CreateNackList(WebRtc_UWord16& nackSize, bool& listExtended)
         return NULL;
     }
 
-    // Find the lowest (last decoded) sequence number and
-    // the highest (highest sequence number of the newest frame)
-    // sequence number. The nack list is a subset of the range
-    // between those two numbers.
-    GetLowHighSequenceNumbers(lowSeqNum, highSeqNum);
-
-    // write a list of all seq num we have
-    if (lowSeqNum == -1 || highSeqNum == -1)
+    // The nack list is a subset of the range between the lowest (last
+    // decoded) sequence number and the highest sequence number received.
+    WebRtc_Word32 lowSeqNum = _lastDecodedState.sequence_num();
+    WebRtc_Word32 highSeqNum = _nackTracker.latest_seq_num();
+    if (highSeqNum == -1)
     {
-        // This happens if we lose the first packet, nothing is popped
-        if (highSeqNum == -1)
-        {
-            // we have not received any packets yet
-            nackSize = 0;
-        }
-        else
-        {
-            // signal that we want a key frame request to be sent
-            nackSize = 0xffff;
-        }
+        // we have not received any packets yet
+        nackSize = 0;
         return NULL;
     }
 
-    int numberOfSeqNum = 0;
-    if (lowSeqNum > highSeqNum)
-    {
-        if (lowSeqNum - highSeqNum > 0x00ff)
-        {
-            // wrap
-            numberOfSeqNum = (0xffff-lowSeqNum) + highSeqNum + 1;
-        }
-    }
-    else
-    {
-        numberOfSeqNum = highSeqNum - lowSeqNum;
-    }
-
+    int numberOfSeqNum = SequenceNumberSpan(lowSeqNum, highSeqNum);
     if (numberOfSeqNum > kNackHistoryLength)
     {
         // Nack list is too big, flush and try to restart.
@@ -1304,7 +1314,7 @@ VCMJitterBuffer::CreateNackList(WebRtc_UWord16& nackSize, bool& listExtended)
 
         while (numberOfSeqNum > kNackHistoryLength)
         {
-          foundKeyFrame = RecycleFramesUntilKeyFrame();
+            foundKeyFrame = RecycleFramesUntilKeyFrame();
 
             if (!foundKeyFrame)
             {
@@ -1312,32 +1322,8 @@ VCMJitterBuffer::CreateNackList(WebRtc_UWord16& nackSize, bool& listExtended)
             }
 
             // Check if we still have too many packets in JB
-            lowSeqNum = -1;
-            highSeqNum = -1;
-            GetLowHighSequenceNumbers(lowSeqNum, highSeqNum);
-
-            if (highSeqNum == -1)
-            {
-                assert(lowSeqNum != -1); // This should never happen
-                // We can't calculate the nack list length...
-                return NULL;
-            }
-
-            numberOfSeqNum = 0;
-            if (lowSeqNum > highSeqNum)
-            {
-                if (lowSeqNum - highSeqNum > 0x00ff)
-                {
-                    // wrap
-                    numberOfSeqNum = (0xffff-lowSeqNum) + highSeqNum + 1;
-                    highSeqNum=lowSeqNum;
-                }
-            }
-            else
-            {
-                numberOfSeqNum = highSeqNum - lowSeqNum;
-            }
-
+            lowSeqNum = _lastDecodedState.sequence_num();
+            numberOfSeqNum = SequenceNumberSpan(lowSeqNum, highSeqNum);
         } // end while
 
         if (!foundKeyFrame)
@@ -1347,6 +1333,7 @@ VCMJitterBuffer::CreateNackList(WebRtc_UWord16& nackSize, bool& listExtended)
             // Set the last decoded sequence number to current high.
             // This is to not get a large nack list again right away
             _lastDecodedState.SetSeqNum(static_cast<uint16_t>(highSeqNum));
+            _nackTracker.SetLowerBound(static_cast<uint16_t>(highSeqNum));
             _waitingForKeyFrame = true;
             // Set to trigger key frame signal
             nackSize = 0xffff;
@@ -1368,6 +1355,36 @@ VCMJitterBuffer::CreateNackList(WebRtc_UWord16& nackSize, bool& listExtended)
         return NULL;
     }
 
+    // Everything up to the last decoded packet is no longer of interest.
+    _nackTracker.SetLowerBound(static_cast<uint16_t>(lowSeqNum));
+
+    // Only request packets which haven't been requested within the last RTT,
+    // a retransmission may still be on its way for the others.
+    const WebRtc_Word64 nowMs = VCMTickTime::MillisecondTimestamp();
+    int length = 0;
+    if (_nackMode == kNackHybrid)
+    {
+        length = CreateHybridNackCandidates(lowSeqNum, numberOfSeqNum);
+        length = _nackTracker.FilterNackList(nowMs, _rttMs, _NACKSeqNum,
+                                             length, &listExtended);
+    }
+    else
+    {
+        length = _nackTracker.GetNackList(nowMs, _rttMs, _NACKSeqNum,
+                                          kNackHistoryLength, &listExtended);
+    }
+    nackSize = static_cast<WebRtc_UWord16>(length);
+    _NACKSeqNumLength = nackSize;
+
+    return _NACKSeqNum;
+}
+
+// Must be called from within _critSect
+int
+VCMJitterBuffer::CreateHybridNackCandidates(WebRtc_Word32 lowSeqNum,
+                                            int numberOfSeqNum)
+{
+    int i = 0;
     WebRtc_UWord16 seqNumberIterator = (WebRtc_UWord16)(lowSeqNum + 1);
     for (i = 0; i < numberOfSeqNum; i++)
     {
@@ -1377,8 +1394,12 @@ VCMJitterBuffer::CreateNackList(WebRtc_UWord16& nackSize, bool& listExtended)
 
     // now we have a list of all sequence numbers that could have been sent
 
-    // zero out the ones we have received
-    for (i = 0; i < _maxNumberOfFrames; i++)
+    // The hybrid mode decides per frame whether its missing packets are worth
+    // a retransmission, so every frame has to be visited. Received packets
+    // are also zeroed out, empty frames are left to the nack tracker.
+    // Unlike the plain NACK list this is still linear in the number of
+    // frames, up to kMaxNumberOfFrames, on every request.
+    for (i = 0; i < static_cast<int>(_frameBuffers.size()); i++)
     {
         // loop all created frames
         // We don't need to check if frame is decoding since lowSeqNum is based
@@ -1390,100 +1411,22 @@ VCMJitterBuffer::CreateNackList(WebRtc_UWord16& nackSize, bool& listExtended)
             (kStateEmpty != state) &&
             (kStateDecoding != state))
         {
-            // Reaching thus far means we are going to update the nack list
-            // When in hybrid mode, we also need to check empty frames, so as
-            // not to add empty packets to the nack list
-            if (_nackMode == kNackHybrid)
-            {
-                _frameBuffers[i]->ZeroOutSeqNumHybrid(_NACKSeqNumInternal,
-                                                      numberOfSeqNum,
-                                                      _rttMs);
-            }
-            else
-            {
-                // Used when the frame is being processed by the decoding thread
-                // don't need to use that info in this loop.
-                _frameBuffers[i]->ZeroOutSeqNum(_NACKSeqNumInternal,
-                                                numberOfSeqNum);
-            }
+            _frameBuffers[i]->ZeroOutSeqNumHybrid(_NACKSeqNumInternal,
+                                                  numberOfSeqNum,
+                                                  _rttMs);
         }
     }
 
     // compress list
-    int emptyIndex = -1;
+    int length = 0;
     for (i = 0; i < numberOfSeqNum; i++)
     {
-        if (_NACKSeqNumInternal[i] == -1 || _NACKSeqNumInternal[i] == -2 )
+        if (_NACKSeqNumInternal[i] != -1 && _NACKSeqNumInternal[i] != -2)
         {
-            // this is empty
-            if (emptyIndex == -1)
-            {
-                // no empty index before, remember this position
-                emptyIndex = i;
-            }
-        }
-        else
-        {
-            // this is not empty
-            if (emptyIndex == -1)
-            {
-                // no empty index, continue
-            }
-            else
-            {
-                _NACKSeqNumInternal[emptyIndex] = _NACKSeqNumInternal[i];
-                _NACKSeqNumInternal[i] = -1;
-                emptyIndex++;
-            }
-        }
-    } // for
-
-    if (emptyIndex == -1)
-    {
-        // no empty
-        nackSize = numberOfSeqNum;
-    }
-    else
-    {
-        nackSize = emptyIndex;
-    }
-
-    if (nackSize > _NACKSeqNumLength)
-    {
-        // Larger list: nack list was extended since the last call.
-        listExtended = true;
-    }
-
-    for (WebRtc_UWord32 j = 0; j < nackSize; j++)
-    {
-        // Check if the list has been extended since it was last created. I.e,
-        // new items have been added
-        if (_NACKSeqNumLength > j && !listExtended)
-        {
-            WebRtc_UWord32 k = 0;
-            for (k = j; k < _NACKSeqNumLength; k++)
-            {
-                // Found the item in the last list, i.e, no new items found yet.
-                if (_NACKSeqNum[k] == (WebRtc_UWord16)_NACKSeqNumInternal[j])
-                {
-                   break;
-                }
-            }
-            if (k == _NACKSeqNumLength) // New item not found in last list.
-            {
-                listExtended = true;
-            }
-        }
-        else
-        {
-            listExtended = true;
+            _NACKSeqNum[length++] = (WebRtc_UWord16)_NACKSeqNumInternal[i];
         }
-        _NACKSeqNum[j] = (WebRtc_UWord16)_NACKSeqNumInternal[j];
     }
-
-    _NACKSeqNumLength = nackSize;
-
-    return _NACKSeqNum;
+    return length;
 }
 
 // Release frame when done with decoding. Should never be used to release
@@ -1583,6 +1526,7 @@ VCMJitterBuffer::InsertPacket(VCMEncodedFrame* buffer, const VCMPacket& packet)
             {
                 frame->IncrementNackCount();
             }
+            _nackTracker.InsertPacket(packet.seqNum);
 
             // Insert each frame once on the arrival of the first packet
             // belonging to that frame (media or empty)
@@ -1661,17 +1605,7 @@ VCMJitterBuffer::UpdateOldJitterSample(const VCMPacket& packet)
 bool
 VCMJitterBuffer::IsPacketRetransmitted(const VCMPacket& packet) const
 {
-    if (_NACKSeqNum && _NACKSeqNumLength > 0)
-    {
-        for (WebRtc_UWord16 i = 0; i < _NACKSeqNumLength; i++)
-        {
-            if (packet.seqNum == _NACKSeqNum[i])
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    return _nackTracker.RetransmitCount(packet.seqNum) > 0;
 }
 
 // Get nack status (enabled/disabled)
@@ -21,6 +21,9 @@
 #include "frame_list.h"
 #include "jitter_buffer_common.h"
 #include "jitter_estimator.h"
+#include "nack_tracker.h"
+
+#include <vector>
 
 namespace webrtc
 {
@@ -75,6 +78,12 @@ public:
     // Get number of packets discarded by the jitter buffer
     WebRtc_UWord32 DiscardedPackets() const;
 
+    // Statistics, the number of packets that were kept in the PacketBuffer
+    // they were received in instead of being copied on insert, and the
+    // number of payload bytes copied while assembling frames.
+    void PayloadCopyStatistics(WebRtc_UWord32& packetsHeld,
+                               WebRtc_Word64& bytesCopied) const;
+
     // Statistics, Calculate frame and bit rates
     WebRtc_Word32 GetUpdate(WebRtc_UWord32& frameRate, WebRtc_UWord32& bitRate);
 
@@ -149,6 +158,8 @@ private:
     // Help functions for insert packet
     // Get empty frame, creates new (i.e. increases JB size) if necessary
     VCMFrameBuffer* GetEmptyFrame();
+    // Release free frames if the pool has been larger than needed for a while
+    void ShrinkFramePool();
     // Recycle oldest frames up to a key frame, used if JB is completely full
     bool RecycleFramesUntilKeyFrame();
     // Update frame state
@@ -179,11 +190,14 @@ private:
     // NACK help
     WebRtc_UWord16* CreateNackList(WebRtc_UWord16& nackSize,
                                    bool& listExtended);
-    WebRtc_Word32 GetLowHighSequenceNumbers(WebRtc_Word32& lowSeqNum,
-                                            WebRtc_Word32& highSeqNum) const;
+    // Writes the sequence numbers in the numberOfSeqNum long range following
+    // lowSeqNum which the hybrid mode wants to NACK to _NACKSeqNum. Returns
+    // the number of sequence numbers written.
+    int CreateHybridNackCandidates(WebRtc_Word32 lowSeqNum,
+                                   int numberOfSeqNum);
+    static int SequenceNumberSpan(WebRtc_Word32 lowSeqNum,
+                                  WebRtc_Word32 highSeqNum);
 
-    static bool FrameEqualTimestamp(VCMFrameBuffer* frame,
-                                    const void* timestamp);
     static bool CompleteDecodableKeyFrameCriteria(VCMFrameBuffer* frame,
                                                   const void* notUsed);
     // Decide whether should wait for NACK (mainly relevant for hybrid mode)
@@ -199,11 +213,12 @@ private:
     VCMEvent                      _frameEvent;
     // Event to signal when we have received a packet
     VCMEvent                      _packetEvent;
-    // Number of allocated frames
-    WebRtc_Word32                 _maxNumberOfFrames;
-    // Array of pointers to the frames in JB
-    VCMFrameBuffer*               _frameBuffers[kMaxNumberOfFrames];
+    // The allocated frames, grows up to kMaxNumberOfFrames on demand
+    std::vector<VCMFrameBuffer*>  _frameBuffers;
     VCMFrameListTimestampOrderAsc _frameBuffersTSOrder;
+    // Largest number of frames in use since the pool was last resized
+    int                           _peakFramesInUse;
+    WebRtc_Word64                 _timeLastFramePoolResize;
 
     // timing
     VCMDecodingState       _lastDecodedState;
@@ -228,6 +243,9 @@ private:
     WebRtc_UWord32          _numConsecutiveOldPackets;
     // Number of packets discarded by the jitter buffer
     WebRtc_UWord32          _discardedPackets;
+    // Payload copy counters of the frames released from the pool
+    WebRtc_UWord32          _releasedPacketsHeld;
+    WebRtc_Word64           _releasedBytesCopied;
 
     // Filters for estimating jitter
     VCMJitterEstimator      _jitterEstimate;
@@ -244,6 +262,8 @@ private:
     WebRtc_Word32           _NACKSeqNumInternal[kNackHistoryLength];
     WebRtc_UWord16          _NACKSeqNum[kNackHistoryLength];
     WebRtc_UWord32          _NACKSeqNumLength;
+    // Missing sequence numbers, updated on every inserted packet
+    VCMNackTracker          _nackTracker;
     bool                    _waitingForKeyFrame;
 
     bool                    _firstPacket;
@@ -16,9 +16,10 @@
 namespace webrtc
 {
 
-enum { kMaxNumberOfFrames     = 100 };
+enum { kMaxNumberOfFrames     = 300 }; // 5 s at 60 fps
 enum { kStartNumberOfFrames   = 6 };    // in packets, 6 packets are approximately 198 ms,
                                         // we need at least one more for process
+enum { kFramePoolResizeIntervalMs = 10000 }; // in ms
 enum { kMaxVideoDelayMs       = 2000 }; // in ms
 
 enum VCMJitterBufferEnum
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "nack_tracker.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+namespace webrtc {
+
+VCMNackTracker::VCMNackTracker(int max_missing)
+    : max_missing_(max_missing),
+      missing_(),
+      latest_seq_num_(0),
+      oldest_seq_num_(0),
+      has_lower_bound_(false),
+      initialized_(false) {
+  assert(max_missing_ > 0);
+}
+
+VCMNackTracker::~VCMNackTracker() {}
+
+void VCMNackTracker::Reset() {
+  missing_.clear();
+  latest_seq_num_ = 0;
+  oldest_seq_num_ = 0;
+  has_lower_bound_ = false;
+  initialized_ = false;
+}
+
+void VCMNackTracker::InsertPacket(uint16_t seq_num) {
+  if (!initialized_) {
+    latest_seq_num_ = seq_num;
+    oldest_seq_num_ = seq_num;
+    initialized_ = true;
+    return;
+  }
+  const int64_t unwrapped = Unwrap(seq_num);
+  if (unwrapped > latest_seq_num_) {
+    // Everything between the previous latest packet and this one is missing,
+    // unless it's already below the lower bound.
+    int64_t first_missing = latest_seq_num_ + 1;
+    if (first_missing < oldest_seq_num_) {
+      first_missing = oldest_seq_num_;
+    }
+    AddMissing(first_missing, unwrapped);
+    latest_seq_num_ = unwrapped;
+  } else if (unwrapped < oldest_seq_num_) {
+    if (!has_lower_bound_) {
+      // Reordered before the first packet seen.
+      AddMissing(unwrapped + 1, oldest_seq_num_);
+      oldest_seq_num_ = unwrapped;
+    }
+  } else if (!missing_.empty()) {
+    missing_.erase(unwrapped);
+  }
+}
+
+void VCMNackTracker::SetLowerBound(uint16_t seq_num) {
+  if (!initialized_) {
+    return;
+  }
+  const int64_t unwrapped = Unwrap(seq_num);
+  if (unwrapped + 1 < oldest_seq_num_) {
+    if (has_lower_bound_) {
+      // The lower bound never moves backwards.
+      return;
+    }
+    // Nothing has been seen between |seq_num| and the first packet.
+    AddMissing(unwrapped + 1, oldest_seq_num_);
+  } else {
+    missing_.erase(missing_.begin(), missing_.upper_bound(unwrapped));
+  }
+  oldest_seq_num_ = unwrapped + 1;
+  has_lower_bound_ = true;
+}
+
+int VCMNackTracker::GetNackList(int64_t now_ms, int rtt_ms, uint16_t* list,
+                                int max_length, bool* new_entries) {
+  assert(list != NULL && new_entries != NULL);
+  *new_entries = false;
+  int length = 0;
+  for (MissingMap::iterator it = missing_.begin();
+       it != missing_.end() && length < max_length; ++it) {
+    if (RequestIfDue(now_ms, rtt_ms, &it->second, new_entries)) {
+      list[length++] = static_cast<uint16_t>(it->first);
+    }
+  }
+  return length;
+}
+
+int VCMNackTracker::FilterNackList(int64_t now_ms, int rtt_ms, uint16_t* list,
+                                   int length, bool* new_entries) {
+  assert(list != NULL && new_entries != NULL);
+  *new_entries = false;
+  int new_length = 0;
+  for (int i = 0; i < length; ++i) {
+    MissingMap::iterator it = missing_.find(Unwrap(list[i]));
+    if (it != missing_.end() &&
+        RequestIfDue(now_ms, rtt_ms, &it->second, new_entries)) {
+      list[new_length++] = list[i];
+    }
+  }
+  return new_length;
+}
+
+int VCMNackTracker::latest_seq_num() const {
+  if (!initialized_) {
+    return -1;
+  }
+  return static_cast<uint16_t>(latest_seq_num_);
+}
+
+int VCMNackTracker::NumMissing() const {
+  return static_cast<int>(missing_.size());
+}
+
+bool VCMNackTracker::IsMissing(uint16_t seq_num) const {
+  return RetransmitCount(seq_num) >= 0;
+}
+
+int VCMNackTracker::RetransmitCount(uint16_t seq_num) const {
+  if (missing_.empty()) {
+    return -1;
+  }
+  MissingMap::const_iterator it = missing_.find(Unwrap(seq_num));
+  if (it == missing_.end()) {
+    return -1;
+  }
+  return it->second.retransmit_count;
+}
+
+int64_t VCMNackTracker::Unwrap(uint16_t seq_num) const {
+  const int16_t diff = static_cast<int16_t>(
+      seq_num - static_cast<uint16_t>(latest_seq_num_));
+  return latest_seq_num_ + diff;
+}
+
+void VCMNackTracker::AddMissing(int64_t first, int64_t last) {
+  // Only the newest |max_missing_| entries would survive anyway.
+  if (last - first > max_missing_) {
+    first = last - max_missing_;
+  }
+  for (int64_t seq_num = first; seq_num < last; ++seq_num) {
+    missing_.insert(std::make_pair(seq_num, NackEntry()));
+  }
+  LimitMissing();
+}
+
+void VCMNackTracker::LimitMissing() {
+  while (static_cast<int>(missing_.size()) > max_missing_) {
+    missing_.erase(missing_.begin());
+  }
+}
+
+bool VCMNackTracker::RequestIfDue(int64_t now_ms, int rtt_ms,
+                                  NackEntry* entry, bool* new_entries) {
+  if (entry->retransmit_count > 0 && now_ms - entry->last_sent_ms < rtt_ms) {
+    // A retransmission triggered by the last request may still be on its way.
+    return false;
+  }
+  if (entry->retransmit_count == 0) {
+    *new_entries = true;
+  }
+  ++entry->retransmit_count;
+  entry->last_sent_ms = now_ms;
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_NACK_TRACKER_H_
+#define WEBRTC_MODULES_VIDEO_CODING_NACK_TRACKER_H_
+
+#include <map>
+
+#include "typedefs.h"
+
+namespace webrtc {
+
+// Keeps the set of missing sequence numbers up to date as packets arrive, so
+// that a NACK list can be produced without rescanning the received frames.
+// Each missing sequence number remembers how many times it has been requested
+// and when it was last requested, which is used to avoid re-requesting a
+// packet before a retransmission could possibly have arrived.
+// Sequence numbers are unwrapped internally; packets more than half the
+// sequence number space apart are not expected to be tracked together.
+class VCMNackTracker {
+ public:
+  // |max_missing| is the maximum number of missing sequence numbers tracked,
+  // the oldest ones are dropped first.
+  explicit VCMNackTracker(int max_missing);
+  ~VCMNackTracker();
+
+  void Reset();
+
+  // Registers the arrival of |seq_num|. Sequence numbers skipped between the
+  // latest packet and |seq_num| are added to the missing set, a late or
+  // retransmitted packet is removed from it.
+  void InsertPacket(uint16_t seq_num);
+
+  // Sets |seq_num| as the newest sequence number which no longer needs to be
+  // requested (typically the last decoded one). Missing entries up to and
+  // including |seq_num| are dropped. The first time it's called, the
+  // sequence numbers between |seq_num| and the first packet seen are added as
+  // missing. Later packets older than the lower bound are ignored.
+  void SetLowerBound(uint16_t seq_num);
+
+  // Writes the missing sequence numbers which are due to be requested, in
+  // sequence number order, to |list|. A sequence number is due if it has
+  // never been requested or if it was last requested at least |rtt_ms| ago.
+  // The listed sequence numbers are marked as requested at |now_ms|.
+  // |new_entries| is set to true if any of them is requested for the first
+  // time. Returns the number of entries written, at most |max_length|.
+  int GetNackList(int64_t now_ms, int rtt_ms, uint16_t* list, int max_length,
+                  bool* new_entries);
+
+  // Same as GetNackList(), but restricted to the |length| candidates in
+  // |list|, which are filtered in place. Candidates which aren't missing are
+  // removed. Returns the new length of |list|.
+  int FilterNackList(int64_t now_ms, int rtt_ms, uint16_t* list, int length,
+                     bool* new_entries);
+
+  // Returns the latest sequence number received, or -1 if none.
+  int latest_seq_num() const;
+  int NumMissing() const;
+  bool IsMissing(uint16_t seq_num) const;
+  // Returns the number of times |seq_num| has been requested, or -1 if it
+  // isn't missing.
+  int RetransmitCount(uint16_t seq_num) const;
+
+ private:
+  struct NackEntry {
+    NackEntry() : retransmit_count(0), last_sent_ms(-1) {}
+    int retransmit_count;
+    int64_t last_sent_ms;
+  };
+  typedef std::map<int64_t, NackEntry> MissingMap;
+
+  int64_t Unwrap(uint16_t seq_num) const;
+  // Adds [first, last) to the missing set.
+  void AddMissing(int64_t first, int64_t last);
+  void LimitMissing();
+  // Returns true and updates |entry| if it's due to be requested.
+  static bool RequestIfDue(int64_t now_ms, int rtt_ms, NackEntry* entry,
+                           bool* new_entries);
+
+  int max_missing_;
+  MissingMap missing_;
+  // Unwrapped sequence numbers of the latest packet received and of the
+  // oldest sequence number accounted for, either received or missing.
+  int64_t latest_seq_num_;
+  int64_t oldest_seq_num_;
+  bool has_lower_bound_;
+  bool initialized_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_NACK_TRACKER_H_
@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "gtest/gtest.h"
+#include "modules/video_coding/main/source/nack_tracker.h"
+
+namespace webrtc {
+
+class TestNackTracker : public ::testing::Test {
+ protected:
+  enum { kMaxMissing = 100 };
+  enum { kListSize = 2 * kMaxMissing };
+
+  TestNackTracker() : tracker_(kMaxMissing) {}
+
+  // Inserts the sequence numbers [first, last].
+  void InsertRange(uint16_t first, uint16_t last) {
+    for (uint16_t seq_num = first; seq_num != last; ++seq_num)
+      tracker_.InsertPacket(seq_num);
+    tracker_.InsertPacket(last);
+  }
+
+  int GetNackList(int64_t now_ms, int rtt_ms) {
+    return tracker_.GetNackList(now_ms, rtt_ms, list_, kListSize,
+                                &new_entries_);
+  }
+
+  VCMNackTracker tracker_;
+  uint16_t list_[kListSize];
+  bool new_entries_;
+};
+
+TEST_F(TestNackTracker, NoPackets) {
+  EXPECT_EQ(-1, tracker_.latest_seq_num());
+  EXPECT_EQ(0, GetNackList(0, 0));
+  EXPECT_FALSE(new_entries_);
+}
+
+TEST_F(TestNackTracker, GapsAreMissing) {
+  InsertRange(0, 4);
+  InsertRange(7, 10);
+  tracker_.InsertPacket(12);
+  EXPECT_EQ(12, tracker_.latest_seq_num());
+  EXPECT_EQ(3, tracker_.NumMissing());
+  ASSERT_EQ(3, GetNackList(0, 0));
+  EXPECT_TRUE(new_entries_);
+  EXPECT_EQ(5, list_[0]);
+  EXPECT_EQ(6, list_[1]);
+  EXPECT_EQ(11, list_[2]);
+}
+
+TEST_F(TestNackTracker, LatePacketIsRemoved) {
+  InsertRange(0, 4);
+  tracker_.InsertPacket(8);
+  EXPECT_EQ(3, tracker_.NumMissing());
+  tracker_.InsertPacket(6);
+  EXPECT_EQ(2, tracker_.NumMissing());
+  EXPECT_TRUE(tracker_.IsMissing(5));
+  EXPECT_FALSE(tracker_.IsMissing(6));
+  EXPECT_TRUE(tracker_.IsMissing(7));
+  EXPECT_EQ(8, tracker_.latest_seq_num());
+}
+
+TEST_F(TestNackTracker, SequenceNumberWrap) {
+  InsertRange(0xfffd, 0xfffe);
+  InsertRange(1, 2);
+  EXPECT_EQ(2, tracker_.latest_seq_num());
+  ASSERT_EQ(2, GetNackList(0, 0));
+  EXPECT_EQ(0xffff, list_[0]);
+  EXPECT_EQ(0, list_[1]);
+}
+
+TEST_F(TestNackTracker, LowerBoundDropsOldEntries) {
+  InsertRange(0, 2);
+  tracker_.InsertPacket(5);
+  tracker_.InsertPacket(8);
+  EXPECT_EQ(4, tracker_.NumMissing());
+  tracker_.SetLowerBound(5);
+  ASSERT_EQ(2, GetNackList(0, 0));
+  EXPECT_EQ(6, list_[0]);
+  EXPECT_EQ(7, list_[1]);
+  // Packets older than the lower bound are no longer tracked.
+  tracker_.InsertPacket(3);
+  EXPECT_EQ(2, tracker_.NumMissing());
+  // The lower bound never moves backwards.
+  tracker_.SetLowerBound(1);
+  EXPECT_EQ(2, tracker_.NumMissing());
+}
+
+TEST_F(TestNackTracker, LowerBoundBeforeFirstPacket) {
+  InsertRange(10, 12);
+  tracker_.InsertPacket(7);
+  tracker_.SetLowerBound(4);
+  ASSERT_EQ(4, GetNackList(0, 0));
+  EXPECT_EQ(5, list_[0]);
+  EXPECT_EQ(6, list_[1]);
+  EXPECT_EQ(8, list_[2]);
+  EXPECT_EQ(9, list_[3]);
+}
+
+TEST_F(TestNackTracker, ResendAfterRtt) {
+  const int kRttMs = 100;
+  InsertRange(0, 2);
+  tracker_.InsertPacket(5);
+  EXPECT_EQ(0, tracker_.RetransmitCount(3));
+  ASSERT_EQ(2, GetNackList(1000, kRttMs));
+  EXPECT_TRUE(new_entries_);
+  EXPECT_EQ(1, tracker_.RetransmitCount(3));
+  EXPECT_EQ(1, tracker_.RetransmitCount(4));
+
+  // Nothing is due before a retransmission could have arrived.
+  EXPECT_EQ(0, GetNackList(1000 + kRttMs - 1, kRttMs));
+  EXPECT_FALSE(new_entries_);
+
+  // New losses are requested right away.
+  tracker_.InsertPacket(7);
+  ASSERT_EQ(1, GetNackList(1050, kRttMs));
+  EXPECT_TRUE(new_entries_);
+  EXPECT_EQ(6, list_[0]);
+
+  ASSERT_EQ(2, GetNackList(1000 + kRttMs, kRttMs));
+  EXPECT_FALSE(new_entries_);
+  EXPECT_EQ(3, list_[0]);
+  EXPECT_EQ(4, list_[1]);
+  EXPECT_EQ(2, tracker_.RetransmitCount(3));
+  EXPECT_EQ(-1, tracker_.RetransmitCount(5));
+}
+
+TEST_F(TestNackTracker, FilterNackList) {
+  InsertRange(0, 2);
+  tracker_.InsertPacket(6);
+  list_[0] = 3;
+  list_[1] = 4;
+  list_[2] = 6;
+  ASSERT_EQ(2, tracker_.FilterNackList(0, 100, list_, 3, &new_entries_));
+  EXPECT_TRUE(new_entries_);
+  EXPECT_EQ(3, list_[0]);
+  EXPECT_EQ(4, list_[1]);
+  EXPECT_EQ(1, tracker_.RetransmitCount(3));
+  EXPECT_EQ(0, tracker_.RetransmitCount(5));
+  EXPECT_EQ(0, tracker_.FilterNackList(50, 100, list_, 2, &new_entries_));
+}
+
+TEST_F(TestNackTracker, MissingSetIsLimited) {
+  tracker_.InsertPacket(0);
+  tracker_.InsertPacket(kMaxMissing + 11);
+  EXPECT_EQ(kMaxMissing, tracker_.NumMissing());
+  EXPECT_FALSE(tracker_.IsMissing(10));
+  EXPECT_TRUE(tracker_.IsMissing(11));
+  EXPECT_TRUE(tracker_.IsMissing(kMaxMissing + 10));
+}
+
+TEST_F(TestNackTracker, Reset) {
+  InsertRange(0, 2);
+  tracker_.InsertPacket(5);
+  tracker_.Reset();
+  EXPECT_EQ(-1, tracker_.latest_seq_num());
+  EXPECT_EQ(0, tracker_.NumMissing());
+  tracker_.InsertPacket(100);
+  EXPECT_EQ(0, tracker_.NumMissing());
+}
+
+}  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include "packet.h"
 #include "module_common_types.h"
+#include "packet_buffer_pool.h"
 
 #include <assert.h>
 
@@ -29,7 +30,8 @@ VCMPacket::VCMPacket()
     completeNALU(kNaluUnset),
     insertStartCode(false),
     bits(false),
-    codecSpecificHeader() {
+    codecSpecificHeader(),
+    _buffer(NULL) {
 }
 
 VCMPacket::VCMPacket(const WebRtc_UWord8* ptr,
@@ -48,7 +50,8 @@ VCMPacket::VCMPacket(const WebRtc_UWord8* ptr,
     completeNALU(kNaluComplete),
     insertStartCode(false),
     bits(false),
-    codecSpecificHeader(rtpHeader.type.Video)
+    codecSpecificHeader(rtpHeader.type.Video),
+    _buffer(NULL)
 {
     CopyCodecSpecifics(rtpHeader.type.Video);
 }
@@ -67,9 +70,41 @@ VCMPacket::VCMPacket(const WebRtc_UWord8* ptr, WebRtc_UWord32 size, WebRtc_UWord
     completeNALU(kNaluComplete),
     insertStartCode(false),
     bits(false),
-    codecSpecificHeader()
+    codecSpecificHeader(),
+    _buffer(NULL)
 {}
 
+VCMPacket::VCMPacket(const VCMPacket& rhs)
+  :
+    _buffer(NULL) {
+  *this = rhs;
+}
+
+VCMPacket::~VCMPacket() {
+  SetBuffer(NULL);
+}
+
+VCMPacket& VCMPacket::operator=(const VCMPacket& rhs) {
+  if (this == &rhs) {
+    return *this;
+  }
+  payloadType = rhs.payloadType;
+  timestamp = rhs.timestamp;
+  seqNum = rhs.seqNum;
+  dataPtr = rhs.dataPtr;
+  sizeBytes = rhs.sizeBytes;
+  markerBit = rhs.markerBit;
+  frameType = rhs.frameType;
+  codec = rhs.codec;
+  isFirstPacket = rhs.isFirstPacket;
+  completeNALU = rhs.completeNALU;
+  insertStartCode = rhs.insertStartCode;
+  bits = rhs.bits;
+  codecSpecificHeader = rhs.codecSpecificHeader;
+  SetBuffer(rhs._buffer);
+  return *this;
+}
+
 void VCMPacket::Reset() {
   payloadType = 0;
   timestamp = 0;
@@ -84,6 +119,17 @@ void VCMPacket::Reset() {
   insertStartCode = false;
   bits = false;
   memset(&codecSpecificHeader, 0, sizeof(RTPVideoHeader));
+  SetBuffer(NULL);
+}
+
+void VCMPacket::SetBuffer(PacketBuffer* buffer) {
+  if (buffer != NULL) {
+    buffer->AddRef();
+  }
+  if (_buffer != NULL) {
+    _buffer->Release();
+  }
+  _buffer = buffer;
 }
 
 void VCMPacket::CopyCodecSpecifics(const RTPVideoHeader& videoHeader)
@@ -17,6 +17,7 @@
 
 namespace webrtc
 {
+class PacketBuffer;
 
 class VCMPacket
 {
@@ -30,9 +31,19 @@ public:
                    WebRtc_UWord16 seqNum,
                    WebRtc_UWord32 timestamp,
                    bool markerBit);
+    VCMPacket(const VCMPacket& rhs);
+    ~VCMPacket();
+
+    VCMPacket& operator=(const VCMPacket& rhs);
 
     void Reset();
 
+    // The reference counted buffer which dataPtr points into, or NULL. The
+    // packet holds a reference to it, which lets the payload be kept where
+    // it was received instead of being copied.
+    PacketBuffer* Buffer() const {return _buffer;}
+    void SetBuffer(PacketBuffer* buffer);
+
     WebRtc_UWord8           payloadType;
     WebRtc_UWord32          timestamp;
     WebRtc_UWord16          seqNum;
@@ -55,6 +66,9 @@ public:
 
 protected:
     void CopyCodecSpecifics(const RTPVideoHeader& videoHeader);
+
+private:
+    PacketBuffer*           _buffer;
 };
 
 } // namespace webrtc
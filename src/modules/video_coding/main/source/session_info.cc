@@ -10,10 +10,15 @@
 
 #include "modules/video_coding/main/source/session_info.h"
 
+#include <string.h>
+
 #include "modules/video_coding/main/source/packet.h"
 
 namespace webrtc {
 
+// Payload of the padding packets inserted for lost H.263 packets.
+static const uint8_t kH263PaddingData[10] = {0};
+
 VCMSessionInfo::VCMSessionInfo()
     : session_nack_(false),
       complete_(false),
@@ -23,13 +28,23 @@ VCMSessionInfo::VCMSessionInfo()
       packets_(),
       empty_seq_num_low_(-1),
       empty_seq_num_high_(-1),
-      packets_not_decodable_(0) {
+      packets_not_decodable_(0),
+      frame_buffer_(NULL),
+      frame_buffer_length_(0),
+      contiguous_(true),
+      gather_buffer_(),
+      packets_held_(0),
+      bytes_copied_(0) {
 }
 
 void VCMSessionInfo::UpdateDataPointers(ptrdiff_t address_delta) {
+  if (frame_buffer_ == NULL)
+    return;
   for (PacketIterator it = packets_.begin(); it != packets_.end(); ++it)
-    if ((*it).dataPtr != NULL)
+    if ((*it).dataPtr >= frame_buffer_ &&
+        (*it).dataPtr <= frame_buffer_ + frame_buffer_length_)
       (*it).dataPtr = (*it).dataPtr + address_delta;
+  frame_buffer_ += address_delta;
 }
 
 int VCMSessionInfo::LowSequenceNumber() const {
@@ -90,6 +105,9 @@ void VCMSessionInfo::Reset() {
   empty_seq_num_low_ = -1;
   empty_seq_num_high_ = -1;
   packets_not_decodable_ = 0;
+  frame_buffer_ = NULL;
+  frame_buffer_length_ = 0;
+  contiguous_ = true;
 }
 
 int VCMSessionInfo::SessionLength() const {
@@ -102,52 +120,98 @@ int VCMSessionInfo::SessionLength() const {
 int VCMSessionInfo::InsertBuffer(uint8_t* frame_buffer,
                                  PacketIterator packet_it) {
   VCMPacket& packet = *packet_it;
-  PacketIterator it;
-
-  int packet_size = packet.sizeBytes;
-  if (!packet.bits)
-    packet_size += (packet.insertStartCode ? kH264StartCodeLengthBytes : 0);
+  assert(frame_buffer_ == NULL || frame_buffer_ == frame_buffer);
+  frame_buffer_ = frame_buffer;
+
+  if (packet.Buffer() != NULL && !packet.insertStartCode) {
+    // Keep the payload where it was received. A frame which is never
+    // decoded never copies it.
+    contiguous_ = false;
+    ++packets_held_;
+    return packet.sizeBytes;
+  }
 
-  // Calculate the offset into the frame buffer for this packet.
-  int offset = 0;
-  for (it = packets_.begin(); it != packet_it; ++it)
-    offset += (*it).sizeBytes;
+  const int start_code_length =
+      (packet.insertStartCode ? kH264StartCodeLengthBytes : 0);
+  const int packet_size = packet.sizeBytes + start_code_length;
 
-  // Set the data pointer to pointing to the start of this packet in the
-  // frame buffer.
+  // Append the packet to the data already in the frame buffer. It's only
+  // in the right place if it's the last packet in sequence number order.
   const uint8_t* data = packet.dataPtr;
-  packet.dataPtr = frame_buffer + offset;
+  packet.dataPtr = frame_buffer + frame_buffer_length_;
   packet.sizeBytes = packet_size;
-
-  ShiftSubsequentPackets(packet_it, packet_size);
+  frame_buffer_length_ += packet_size;
+  PacketIterator next_it = packet_it;
+  ++next_it;
+  if (next_it != packets_.end())
+    contiguous_ = false;
 
   const unsigned char startCode[] = {0, 0, 0, 1};
   if (packet.insertStartCode) {
     memcpy(const_cast<uint8_t*>(packet.dataPtr), startCode,
            kH264StartCodeLengthBytes);
   }
-  memcpy(const_cast<uint8_t*>(packet.dataPtr
-      + (packet.insertStartCode ? kH264StartCodeLengthBytes : 0)),
-      data,
-      packet.sizeBytes);
+  memcpy(const_cast<uint8_t*>(packet.dataPtr + start_code_length),
+         data,
+         packet_size - start_code_length);
+  bytes_copied_ += packet_size - start_code_length;
+  packet.SetBuffer(NULL);
 
   return packet_size;
 }
 
-void VCMSessionInfo::ShiftSubsequentPackets(PacketIterator it,
-                                            int steps_to_shift) {
-  ++it;
-  if (it == packets_.end())
+void VCMSessionInfo::GatherPackets() {
+  if (contiguous_)
     return;
-  uint8_t* first_packet_ptr = const_cast<WebRtc_UWord8*>((*it).dataPtr);
-  int shift_length = 0;
-  // Calculate the total move length and move the data pointers in advance.
-  for (; it != packets_.end(); ++it) {
-    shift_length += (*it).sizeBytes;
-    if ((*it).dataPtr != NULL)
-      (*it).dataPtr += steps_to_shift;
+  // The payloads in the frame buffer only have to be copied out of the way
+  // if one of them moves. Held packets are copied straight from their
+  // PacketBuffer, so in order packets are copied once.
+  bool in_place = true;
+  int offset = 0;
+  for (PacketIterator it = packets_.begin(); it != packets_.end(); ++it) {
+    if ((*it).dataPtr == NULL)
+      continue;  // Deleted.
+    if (InFrameBuffer((*it).dataPtr) &&
+        (*it).dataPtr != frame_buffer_ + offset) {
+      in_place = false;
+      break;
+    }
+    offset += (*it).sizeBytes;
   }
-  memmove(first_packet_ptr + steps_to_shift, first_packet_ptr, shift_length);
+  const uint8_t* gather_buffer = NULL;
+  if (!in_place) {
+    // Each byte in the frame buffer is moved at most twice, regardless of
+    // how the packets were reordered.
+    gather_buffer_.assign(frame_buffer_,
+                          frame_buffer_ + frame_buffer_length_);
+    gather_buffer = &gather_buffer_[0];
+    bytes_copied_ += frame_buffer_length_;
+  }
+  offset = 0;
+  for (PacketIterator it = packets_.begin(); it != packets_.end(); ++it) {
+    if ((*it).dataPtr == NULL)
+      continue;  // Deleted.
+    const uint8_t* data = (*it).dataPtr;
+    if (InFrameBuffer(data)) {
+      if (in_place) {
+        offset += (*it).sizeBytes;
+        continue;
+      }
+      data = gather_buffer + (data - frame_buffer_);
+    }
+    memcpy(frame_buffer_ + offset, data, (*it).sizeBytes);
+    bytes_copied_ += (*it).sizeBytes;
+    (*it).dataPtr = frame_buffer_ + offset;
+    (*it).SetBuffer(NULL);
+    offset += (*it).sizeBytes;
+  }
+  frame_buffer_length_ = offset;
+  contiguous_ = true;
+}
+
+bool VCMSessionInfo::InFrameBuffer(const uint8_t* data) const {
+  return (data >= frame_buffer_ &&
+          data < frame_buffer_ + frame_buffer_length_);
 }
 
 void VCMSessionInfo::UpdateCompleteSession() {
@@ -218,10 +282,11 @@ int VCMSessionInfo::DeletePacketData(PacketIterator start,
     bytes_to_delete += (*it).sizeBytes;
     (*it).sizeBytes = 0;
     (*it).dataPtr = NULL;
+    (*it).SetBuffer(NULL);
     ++packets_not_decodable_;
   }
   if (bytes_to_delete > 0)
-    ShiftSubsequentPackets(end, -bytes_to_delete);
+    contiguous_ = false;
   return bytes_to_delete;
 }
 
@@ -237,6 +302,7 @@ int VCMSessionInfo::BuildVP8FragmentationHeader(
          kMaxVP8Partitions * sizeof(WebRtc_UWord32));
   if (packets_.empty())
       return new_length;
+  GatherPackets();
   PacketIterator it = FindNextPartitionBeginning(packets_.begin(),
                                                  &packets_not_decodable_);
   while (it != packets_.end()) {
@@ -344,49 +410,10 @@ int VCMSessionInfo::MakeDecodable() {
     }
     prev_it = it;
   }
+  GatherPackets();
   return return_length;
 }
 
-int VCMSessionInfo::ZeroOutSeqNum(int* seq_num_list,
-                                  int seq_num_list_length) {
-  if (NULL == seq_num_list || seq_num_list_length < 1) {
-    return -1;
-  }
-  if (packets_.empty()) {
-    return 0;
-  }
-
-  // Find end point (index of entry equals the sequence number of the first
-  // packet).
-  int index = 0;
-  for (; index < seq_num_list_length; ++index) {
-    if (seq_num_list[index] == packets_.front().seqNum) {
-      seq_num_list[index] = -1;
-      ++index;
-      break;
-    }
-  }
-
-  // Zero out between the first entry and the end point.
-  PacketIterator it = packets_.begin();
-  PacketIterator prev_it = it;
-  ++it;
-  while (it != packets_.end() && index < seq_num_list_length) {
-    if (!InSequence(it, prev_it)) {
-      // Found a sequence number gap due to packet loss.
-      index += PacketsMissing(it, prev_it);
-      session_nack_ = true;
-    }
-    seq_num_list[index] = -1;
-    ++index;
-    prev_it = it;
-    ++it;
-  }
-  if (!packets_.front().isFirstPacket)
-    session_nack_ = true;
-  return 0;
-}
-
 // TODO(mikhal): Rename function.
 int VCMSessionInfo::ZeroOutSeqNumHybrid(int* seq_num_list,
                                         int seq_num_list_length,
@@ -587,6 +614,9 @@ int VCMSessionInfo::PrepareForDecode(uint8_t* frame_buffer) {
   int real_data_bytes = 0;
   if (length == 0)
       return length;
+  // The payloads are modified in place below, which is only done in the
+  // frame buffer.
+  GatherPackets();
   bool previous_lost = false;
   PacketIterator it = packets_.begin();
   PacketIterator prev_it = it;
@@ -605,17 +635,15 @@ int VCMSessionInfo::PrepareForDecode(uint8_t* frame_buffer) {
           previous_lost = true;
           ++packets_not_decodable_;
         } else if ((*it).sizeBytes > 0) {
-          // Glue with previous byte.
-          // Move everything from [this packet start + 1, end of buffer] one
-          // byte to the left.
+          // Glue with previous byte. The packet now starts one byte later,
+          // the gap is removed when the packets are gathered below.
           uint8_t* ptr_prev_byte =
               const_cast<uint8_t*>((*prev_it).dataPtr) +
               (*prev_it).sizeBytes - 1;
           *ptr_prev_byte = (*ptr_prev_byte) | (*ptr_first_byte);
-          memmove(const_cast<uint8_t*>((*it).dataPtr),
-                  (*it).dataPtr + 1, (*it).sizeBytes - 1);
-          ShiftSubsequentPackets(it, -1);
+          ++(*it).dataPtr;
           (*it).sizeBytes--;
+          contiguous_ = false;
           length--;
           previous_lost = false;
           real_data_bytes += (*it).sizeBytes;
@@ -629,15 +657,24 @@ int VCMSessionInfo::PrepareForDecode(uint8_t* frame_buffer) {
     } else if (packet_loss &&
       (*it).codecSpecificHeader.codec == kRTPVideoH263) {
       // Pad H.263 packet losses with 10 zeros to make it easier
-      // for the decoder.
-      const int kPaddingLength = 10;
-      WebRtc_UWord8 padding_data[kPaddingLength] = {0};
+      // for the decoder. The padding is copied into the frame buffer when
+      // the packets are gathered below.
+      const int kPaddingLength = sizeof(kH263PaddingData);
       // Make a copy of the previous packet.
       VCMPacket padding_packet(*it);
       ++padding_packet.seqNum;
-      padding_packet.dataPtr = padding_data;
+      padding_packet.dataPtr = kH263PaddingData;
       padding_packet.sizeBytes = kPaddingLength;
-      length += InsertPacket(padding_packet, frame_buffer, false, 0);
+      PacketIterator next_it = it;
+      ++next_it;
+      if (packets_.size() < kMaxPacketsInSession &&
+          (next_it == packets_.end() ||
+           (*next_it).seqNum != padding_packet.seqNum)) {
+        packets_.insert(next_it, padding_packet);
+        contiguous_ = false;
+        length += kPaddingLength;
+        UpdateCompleteSession();
+      }
       previous_lost = true;
     } else {
       real_data_bytes += (*it).sizeBytes;
@@ -651,6 +688,7 @@ int VCMSessionInfo::PrepareForDecode(uint8_t* frame_buffer) {
       (*it).sizeBytes = 0;
     length = 0;
   }
+  GatherPackets();
   return length;
 }
 
@@ -658,4 +696,12 @@ int VCMSessionInfo::packets_not_decodable() const {
   return packets_not_decodable_;
 }
 
+int VCMSessionInfo::packets_held() const {
+  return packets_held_;
+}
+
+int64_t VCMSessionInfo::bytes_copied() const {
+  return bytes_copied_;
+}
+
 }  // namespace webrtc
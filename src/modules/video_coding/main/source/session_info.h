@@ -13,6 +13,7 @@
 
 #include <cstddef>
 #include <list>
+#include <vector>
 
 #include "modules/interface/module_common_types.h"
 #include "modules/video_coding/main/source/packet.h"
@@ -24,9 +25,8 @@ class VCMSessionInfo {
  public:
   VCMSessionInfo();
 
+  // Must be called when the frame buffer has been moved.
   void UpdateDataPointers(ptrdiff_t address_delta);
-  int ZeroOutSeqNum(int* seq_num_list,
-                    int seq_num_list_length);
 
   // Hybrid version: Zero out seq num for NACK list
   // Selectively NACK packets.
@@ -74,6 +74,13 @@ class VCMSessionInfo {
   // them.
   int packets_not_decodable() const;
 
+  // The number of packets which were kept in their PacketBuffer when inserted
+  // instead of being copied into the frame buffer, since construction.
+  int packets_held() const;
+  // The number of payload bytes copied by the session since construction,
+  // both when packets are inserted and when they are gathered.
+  int64_t bytes_copied() const;
+
  private:
   enum { kMaxVP8Partitions = 9 };
 
@@ -99,12 +106,21 @@ class VCMSessionInfo {
                          const PacketIterator& prev_it);
   static int PacketsMissing(const PacketIterator& packet_it,
                             const PacketIterator& prev_packet_it);
+  // Appends the payload of the packet to the frame buffer. The payloads are
+  // stored in arrival order; reordered packets are put in sequence number
+  // order by GatherPackets() once the frame is about to be decoded. A packet
+  // which holds the PacketBuffer it was received in is left there and only
+  // copied by GatherPackets().
   int InsertBuffer(uint8_t* frame_buffer,
                    PacketIterator packetIterator);
-  void ShiftSubsequentPackets(PacketIterator it, int steps_to_shift);
+  // Moves the packet payloads into the frame buffer so that they are stored
+  // back to back in sequence number order, leaving out deleted packets.
+  void GatherPackets();
+  bool InFrameBuffer(const uint8_t* data) const;
   PacketIterator FindNaluEnd(PacketIterator packet_iter) const;
   // Deletes the data of all packets between |start| and |end|, inclusively.
-  // Note that this function doesn't delete the actual packets.
+  // Note that this function doesn't delete the actual packets, and that the
+  // data is left in the frame buffer until GatherPackets() is called.
   int DeletePacketData(PacketIterator start,
                        PacketIterator end);
   void UpdateCompleteSession();
@@ -125,6 +141,16 @@ class VCMSessionInfo {
   int empty_seq_num_high_;
   // Number of packets discarded because the decoder can't use them.
   int packets_not_decodable_;
+  // The frame buffer which the packet payloads are stored in.
+  uint8_t* frame_buffer_;
+  // Number of bytes of the frame buffer in use.
+  int frame_buffer_length_;
+  // True if the payloads are stored in sequence number order without gaps.
+  bool contiguous_;
+  // Copy of the frame buffer used when gathering reordered packets.
+  std::vector<uint8_t> gather_buffer_;
+  int packets_held_;
+  int64_t bytes_copied_;
 };
 
 }  // namespace webrtc
@@ -14,6 +14,7 @@
 #include "modules/interface/module_common_types.h"
 #include "modules/video_coding/main/source/packet.h"
 #include "modules/video_coding/main/source/session_info.h"
+#include "system_wrappers/interface/packet_buffer_pool.h"
 
 namespace webrtc {
 
@@ -52,6 +53,44 @@ class TestSessionInfo : public ::testing::Test {
   VCMPacket packet_;
 };
 
+class TestHeldPackets : public TestSessionInfo {
+ protected:
+  virtual void SetUp() {
+    TestSessionInfo::SetUp();
+    pool_ = PacketBufferPool::Create(kPacketBufferSize, 10);
+  }
+
+  virtual void TearDown() {
+    session_.Reset();
+    packet_.Reset();
+    pool_->Release();
+  }
+
+  // Inserts a packet the way ViEReceiver does, with the payload left in the
+  // pooled buffer it was received in.
+  int InsertHeldPacket(uint8_t start_value) {
+    PacketBuffer* buffer = pool_->Acquire();
+    FillPacket(start_value);
+    memcpy(buffer->Data(), packet_buffer_, kPacketBufferSize);
+    buffer->SetLength(kPacketBufferSize);
+    packet_.dataPtr = buffer->Data();
+    packet_.SetBuffer(buffer);
+    buffer->Release();
+    int ret = session_.InsertPacket(packet_, frame_buffer_, false, 0);
+    packet_.SetBuffer(NULL);
+    packet_.dataPtr = packet_buffer_;
+    return ret;
+  }
+
+  WebRtc_UWord32 BuffersInUse() const {
+    PacketBufferPoolStatistics stats;
+    pool_->Statistics(stats);
+    return stats.buffersInUse;
+  }
+
+  PacketBufferPool* pool_;
+};
+
 class TestVP8Partitions : public TestSessionInfo {
  protected:
   enum { kMaxVP8Partitions = 9 };
@@ -200,6 +239,105 @@ TEST_F(TestSessionInfo, NormalOperation) {
   }
 }
 
+TEST_F(TestSessionInfo, ReorderedPacketsGatheredForDecode) {
+  // Insert the ten packets of a frame in a scrambled order.
+  const int kOrder[] = {3, 0, 9, 1, 8, 2, 7, 4, 6, 5};
+  for (int i = 0; i < 10; ++i) {
+    packet_.seqNum = 0xFFFB + kOrder[i];
+    packet_.isFirstPacket = (kOrder[i] == 0);
+    packet_.markerBit = (kOrder[i] == 9);
+    FillPacket(kOrder[i]);
+    ASSERT_EQ(session_.InsertPacket(packet_, frame_buffer_, false, 0),
+              kPacketBufferSize);
+  }
+  EXPECT_TRUE(session_.complete());
+  EXPECT_EQ(10 * kPacketBufferSize, session_.PrepareForDecode(frame_buffer_));
+  // Copied on insert, to the gather buffer and back.
+  EXPECT_EQ(0, session_.packets_held());
+  EXPECT_EQ(3 * 10 * kPacketBufferSize, session_.bytes_copied());
+  for (int i = 0; i < 10; ++i) {
+    SCOPED_TRACE("Calling VerifyPacket");
+    VerifyPacket(frame_buffer_ + i * kPacketBufferSize, i);
+  }
+}
+
+TEST_F(TestHeldPackets, InOrderPacketsCopiedOnceForDecode) {
+  for (int i = 0; i < 10; ++i) {
+    packet_.seqNum = i;
+    packet_.isFirstPacket = (i == 0);
+    packet_.markerBit = (i == 9);
+    ASSERT_EQ(kPacketBufferSize, InsertHeldPacket(i));
+  }
+  EXPECT_TRUE(session_.complete());
+  EXPECT_EQ(10, session_.packets_held());
+  EXPECT_EQ(0, session_.bytes_copied());
+  EXPECT_EQ(10u, BuffersInUse());
+
+  EXPECT_EQ(10 * kPacketBufferSize, session_.PrepareForDecode(frame_buffer_));
+  EXPECT_EQ(10 * kPacketBufferSize, session_.bytes_copied());
+  EXPECT_EQ(0u, BuffersInUse());
+  for (int i = 0; i < 10; ++i) {
+    SCOPED_TRACE("Calling VerifyPacket");
+    VerifyPacket(frame_buffer_ + i * kPacketBufferSize, i);
+  }
+}
+
+TEST_F(TestHeldPackets, ReorderedPacketsCopiedOnceForDecode) {
+  const int kOrder[] = {3, 0, 9, 1, 8, 2, 7, 4, 6, 5};
+  for (int i = 0; i < 10; ++i) {
+    packet_.seqNum = 0xFFFB + kOrder[i];
+    packet_.isFirstPacket = (kOrder[i] == 0);
+    packet_.markerBit = (kOrder[i] == 9);
+    ASSERT_EQ(kPacketBufferSize, InsertHeldPacket(kOrder[i]));
+  }
+  EXPECT_TRUE(session_.complete());
+  EXPECT_EQ(10 * kPacketBufferSize, session_.PrepareForDecode(frame_buffer_));
+  // A copied packet would have been copied on insert and twice more when
+  // gathered.
+  EXPECT_EQ(10 * kPacketBufferSize, session_.bytes_copied());
+  EXPECT_EQ(0u, BuffersInUse());
+  for (int i = 0; i < 10; ++i) {
+    SCOPED_TRACE("Calling VerifyPacket");
+    VerifyPacket(frame_buffer_ + i * kPacketBufferSize, i);
+  }
+}
+
+TEST_F(TestHeldPackets, MixedPacketsGatheredForDecode) {
+  packet_.seqNum = 1;
+  ASSERT_EQ(kPacketBufferSize, InsertHeldPacket(1));
+  packet_.seqNum = 2;
+  packet_.markerBit = true;
+  FillPacket(2);
+  ASSERT_EQ(kPacketBufferSize,
+            session_.InsertPacket(packet_, frame_buffer_, false, 0));
+  packet_.seqNum = 0;
+  packet_.isFirstPacket = true;
+  packet_.markerBit = false;
+  ASSERT_EQ(kPacketBufferSize, InsertHeldPacket(0));
+  EXPECT_TRUE(session_.complete());
+  EXPECT_EQ(2, session_.packets_held());
+  EXPECT_EQ(kPacketBufferSize, session_.bytes_copied());
+
+  EXPECT_EQ(3 * kPacketBufferSize, session_.PrepareForDecode(frame_buffer_));
+  EXPECT_EQ(0u, BuffersInUse());
+  for (int i = 0; i < 3; ++i) {
+    SCOPED_TRACE("Calling VerifyPacket");
+    VerifyPacket(frame_buffer_ + i * kPacketBufferSize, i);
+  }
+}
+
+TEST_F(TestHeldPackets, DroppedFrameIsNeverCopied) {
+  for (int i = 0; i < 3; ++i) {
+    packet_.seqNum = i;
+    packet_.isFirstPacket = (i == 0);
+    ASSERT_EQ(kPacketBufferSize, InsertHeldPacket(i));
+  }
+  EXPECT_EQ(3u, BuffersInUse());
+  session_.Reset();
+  EXPECT_EQ(0u, BuffersInUse());
+  EXPECT_EQ(0, session_.bytes_copied());
+}
+
 TEST_F(TestVP8Partitions, TwoPartitionsOneLoss) {
   // Partition 0 | Partition 1
   // [ 0 ] [ 2 ] | [ 3 ]
@@ -803,12 +941,6 @@ TEST_F(TestZeroOutSeqNum, NoLosses) {
             kPacketBufferSize);
 
   EXPECT_EQ(10 * kPacketBufferSize, session_.SessionLength());
-  BuildSeqNumList(low, packet_.seqNum);
-  EXPECT_EQ(0, session_.ZeroOutSeqNum(seq_num_list_, seq_num_list_length_));
-  EXPECT_EQ(false, session_.session_nack());
-  SCOPED_TRACE("Calling VerifyAll");
-  VerifyAll(-1);
-
   BuildSeqNumList(low, packet_.seqNum);
   EXPECT_EQ(0, session_.ZeroOutSeqNumHybrid(seq_num_list_,
                                             seq_num_list_length_,
@@ -840,15 +972,6 @@ TEST_F(TestZeroOutSeqNum, FiveLossesSpreadOut) {
   packet_.seqNum++;  // Simulate loss of last packet.
 
   EXPECT_EQ(5 * kPacketBufferSize, session_.SessionLength());
-  BuildSeqNumList(low, packet_.seqNum);
-  EXPECT_EQ(0, session_.ZeroOutSeqNum(seq_num_list_, seq_num_list_length_));
-  for (int i = 0; i < seq_num_list_length_; ++i) {
-    if (i % 2)
-      EXPECT_EQ(static_cast<uint16_t>(low + i), seq_num_list_[i]);
-    else
-      EXPECT_EQ(-1, seq_num_list_[i]);
-  }
-
   BuildSeqNumList(low, packet_.seqNum);
   EXPECT_EQ(0, session_.ZeroOutSeqNumHybrid(seq_num_list_,
                                             seq_num_list_length_,
@@ -873,12 +996,6 @@ TEST_F(TestZeroOutSeqNum, FirstAndLastLost) {
             kPacketBufferSize);
 
   EXPECT_EQ(kPacketBufferSize, session_.SessionLength());
-  BuildSeqNumList(low, packet_.seqNum + 1);
-  EXPECT_EQ(0, session_.ZeroOutSeqNum(seq_num_list_, seq_num_list_length_));
-  EXPECT_EQ(0xFFFF, seq_num_list_[0]);
-  EXPECT_EQ(-1, seq_num_list_[1]);
-  EXPECT_EQ(1, seq_num_list_[2]);
-
   BuildSeqNumList(low, packet_.seqNum + 1);
   EXPECT_EQ(0, session_.ZeroOutSeqNumHybrid(seq_num_list_,
                                             seq_num_list_length_,
@@ -1401,12 +1401,22 @@ WebRtc_Word32
 VideoCodingModuleImpl::IncomingPacket(const WebRtc_UWord8* incomingPayload,
                                     WebRtc_UWord32 payloadLength,
                                     const WebRtcRTPHeader& rtpInfo)
+{
+    return IncomingPacket(incomingPayload, payloadLength, rtpInfo, NULL);
+}
+
+WebRtc_Word32
+VideoCodingModuleImpl::IncomingPacket(const WebRtc_UWord8* incomingPayload,
+                                    WebRtc_UWord32 payloadLength,
+                                    const WebRtcRTPHeader& rtpInfo,
+                                    PacketBuffer* buffer)
 {
     WEBRTC_TRACE(webrtc::kTraceModuleCall,
                  webrtc::kTraceVideoCoding,
                  VCMId(_id),
                  "IncomingPacket()");
-    const VCMPacket packet(incomingPayload, payloadLength, rtpInfo);
+    VCMPacket packet(incomingPayload, payloadLength, rtpInfo);
+    packet.SetBuffer(buffer);
     WebRtc_Word32 ret;
     if (_dualReceiver.State() != kPassive)
     {
@@ -221,6 +221,10 @@ public:
     virtual WebRtc_Word32 IncomingPacket(const WebRtc_UWord8* incomingPayload,
                                          WebRtc_UWord32 payloadLength,
                                          const WebRtcRTPHeader& rtpInfo);
+    virtual WebRtc_Word32 IncomingPacket(const WebRtc_UWord8* incomingPayload,
+                                         WebRtc_UWord32 payloadLength,
+                                         const WebRtcRTPHeader& rtpInfo,
+                                         PacketBuffer* buffer);
 
     // A part of an encoded frame to be decoded.
     // Used in conjunction with VCMFrameStorageCallback.
@@ -9,7 +9,9 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
+#include <vector>
 
 #include "common_types.h"
 #include "../source/event.h"
@@ -20,6 +22,7 @@
 #include "jitter_estimator.h"
 #include "media_opt_util.h"
 #include "packet.h"
+#include "packet_buffer_pool.h"
 #include "test_util.h"
 #include "test_macros.h"
 #include "tick_time.h"
@@ -117,6 +120,10 @@ int JitterBufferTest(CmdArgs& args)
         fb->InsertPacket(packet, VCMTickTime::MillisecondTimestamp(), false, 0);
         TEST(frameList.Insert(fb) == 0);
     }
+    // Frames are found by timestamp, also across the timestamp wrap.
+    TEST(frameList.FindFrame(0xfffffff0)->TimeStamp() == 0xfffffff0);
+    TEST(frameList.FindFrame(0x10)->TimeStamp() == 0x10);
+    TEST(frameList.FindFrame(0xffffffef) == NULL);
     VCMFrameListItem* item = NULL;
     WebRtc_UWord32 prevTimestamp = 0;
     int i = 0;
@@ -129,6 +136,7 @@ int JitterBufferTest(CmdArgs& args)
              || i == 0);
         prevTimestamp = fb->TimeStamp();
         frameList.Erase(item);
+        TEST(frameList.FindFrame(prevTimestamp) == NULL);
         delete fb;
     }
     TEST(i == 100);
@@ -1935,13 +1943,16 @@ int JitterBufferTest(CmdArgs& args)
     //printf("DONE fill JB - number of delta frames > max number of frames\n");
 
     //
-    // TEST fill JB with more than max number of frame (50 delta frames +
-    // 51 key frames) with wrap in seqNum
+    // TEST fill JB with more than max number of frames (50 delta frames
+    // followed by key frames up to kMaxNumberOfFrames, plus one more key
+    // frame) with wrap in seqNum. With kMaxNumberOfFrames = 300:
     //
-    //  --------------------------------------------------------------
-    // | 65485 | 65486 | 65487 | .... | 65535 | 0 | 1 | 2 | .....| 50 |
-    //  --------------------------------------------------------------
-    // |<-----------delta frames------------->|<------key frames----->|
+    //  ----------------------------------------------------------------
+    // | 65486 | 65487 | .... | 65535 | 0 | 1 | 2 | .... | 249 | 250 |
+    //  ----------------------------------------------------------------
+    // |<-------delta frames-------->|<-----------key frames---------->|
+    //
+    // 250 is the extra frame, which recycles the delta frames.
 
     jb.Flush();
 
@@ -2427,6 +2438,63 @@ int JitterBufferTest(CmdArgs& args)
 
     jb.Flush();
 
+    //
+    // TEST packets kept in the buffer they were received in
+    //
+    // The payload isn't copied when the packets are inserted, only once
+    // when the frame is assembled for decoding.
+
+    WebRtc_UWord32 packetsHeld = 0;
+    WebRtc_Word64 bytesCopied = 0;
+    jb.PayloadCopyStatistics(packetsHeld, bytesCopied);
+    const WebRtc_UWord32 packetsHeldBefore = packetsHeld;
+    const WebRtc_Word64 bytesCopiedBefore = bytesCopied;
+
+    PacketBufferPool* pool = PacketBufferPool::Create(size, 2);
+    PacketBuffer* received = pool->Acquire();
+    memcpy(received->Data(), data, size);
+    received->SetLength(size);
+    packet.dataPtr = received->Data();
+    packet.sizeBytes = size;
+    packet.SetBuffer(received);
+    received->Release();
+
+    seqNum = packet.seqNum + 1;
+    timeStamp = packet.timestamp + 33 * 90;
+    packet.frameType = kVideoFrameKey;
+    packet.isFirstPacket = true;
+    packet.markerBit = false;
+    packet.insertStartCode = false;
+    packet.seqNum = seqNum;
+    packet.timestamp = timeStamp;
+
+    TEST(frameIn = jb.GetFrame(packet));
+    TEST(kFirstPacket == jb.InsertPacket(frameIn, packet));
+
+    seqNum++;
+    packet.isFirstPacket = false;
+    packet.markerBit = true;
+    packet.seqNum = seqNum;
+
+    TEST(frameIn = jb.GetFrame(packet));
+    TEST(kCompleteSession == jb.InsertPacket(frameIn, packet));
+    packet.SetBuffer(NULL);
+    packet.dataPtr = data;
+
+    jb.PayloadCopyStatistics(packetsHeld, bytesCopied);
+    TEST(packetsHeld == packetsHeldBefore + 2);
+    TEST(bytesCopied == bytesCopiedBefore);
+
+    frameOut = jb.GetCompleteFrameForDecoding(10);
+    TEST(CheckOutFrame(frameOut, size * 2, false) == 0);
+    jb.ReleaseFrame(frameOut);
+
+    jb.PayloadCopyStatistics(packetsHeld, bytesCopied);
+    TEST(bytesCopied == bytesCopiedBefore + size * 2);
+
+    jb.Flush();
+    pool->Release();
+
     jb.Stop();
 
     printf("DONE !!!\n");
@@ -2445,3 +2513,326 @@ int JitterBufferTest(CmdArgs& args)
     return 0;
 
 }
+
+// Inserts the packets of a frame in the order given by |order|, skipping
+// lost packets, and prepares the frame for decoding. Returns the time it
+// took in microseconds, or -1 if the frame data is not in sequence number
+// order.
+static WebRtc_Word64 InsertReorderedFrame(VCMFrameBuffer* frame,
+                                          const int* order,
+                                          const bool* lost,
+                                          int numPackets,
+                                          int packetSize,
+                                          WebRtc_UWord16 firstSeqNum,
+                                          WebRtc_UWord32 timeStamp)
+{
+    WebRtc_UWord8 data[1500];
+    VCMPacket packet(data, packetSize, 0, timeStamp, false);
+    packet.frameType = kVideoFrameDelta;
+    packet.completeNALU = kNaluComplete;
+
+    frame->SetState(kStateEmpty);
+    const WebRtc_Word64 startTime = TickTime::MicrosecondTimestamp();
+    for (int i = 0; i < numPackets; i++)
+    {
+        const int index = order[i];
+        if (lost[index])
+        {
+            continue;
+        }
+        memset(data, index & 0xff, packetSize);
+        packet.seqNum = static_cast<WebRtc_UWord16>(firstSeqNum + index);
+        packet.isFirstPacket = (index == 0);
+        packet.markerBit = (index == numPackets - 1);
+        if (frame->InsertPacket(packet, 0, false, 0) < 0)
+        {
+            return -1;
+        }
+    }
+    frame->MakeSessionDecodable();
+    frame->SetState(kStateDecoding);
+    const WebRtc_Word64 elapsedTime =
+        TickTime::MicrosecondTimestamp() - startTime;
+
+    const WebRtc_UWord8* outData = frame->Buffer();
+    unsigned int offset = 0;
+    for (int index = 0; index < numPackets; index++)
+    {
+        if (lost[index])
+        {
+            continue;
+        }
+        for (int j = 0; j < packetSize; j++)
+        {
+            if (outData[offset + j] != (index & 0xff))
+            {
+                return -1;
+            }
+        }
+        offset += packetSize;
+    }
+    if (frame->Length() != offset)
+    {
+        return -1;
+    }
+    frame->SetState(kStateFree);
+    return elapsedTime;
+}
+
+// Measures the time it takes to assemble frames from reordered packets,
+// with and without packet loss.
+int JitterBufferReorderBenchmark(CmdArgs& args)
+{
+    enum { kPacketSize = 1000 };
+    enum { kNumFrames = 100 };
+    const int numPackets[] = {10, 100, 400};
+    const char* orderName[] = {"in order", "reversed", "shuffled",
+                               "shuffled, 5% loss"};
+    const int numOrders = sizeof(orderName) / sizeof(*orderName);
+
+    srand(1234);
+    VCMFrameBuffer frame;
+    // Large frames can't be ordered across a sequence number wrap, since
+    // LatestSequenceNumber() only detects wraps within 255 packets.
+    const WebRtc_UWord16 seqNum = 1000;
+    WebRtc_UWord32 timeStamp = 0;
+    for (unsigned int n = 0; n < sizeof(numPackets) / sizeof(*numPackets);
+         n++)
+    {
+        int* order = new int[numPackets[n]];
+        bool* lost = new bool[numPackets[n]];
+        for (int o = 0; o < numOrders; o++)
+        {
+            WebRtc_Word64 totalTime = 0;
+            for (int f = 0; f < kNumFrames; f++)
+            {
+                for (int i = 0; i < numPackets[n]; i++)
+                {
+                    order[i] = (o == 1) ? numPackets[n] - 1 - i : i;
+                    lost[i] = (o == 3) && (rand() % 100 < 5);
+                }
+                if (o >= 2)
+                {
+                    for (int i = numPackets[n] - 1; i > 0; i--)
+                    {
+                        const int j = rand() % (i + 1);
+                        const int tmp = order[i];
+                        order[i] = order[j];
+                        order[j] = tmp;
+                    }
+                }
+                const WebRtc_Word64 time = InsertReorderedFrame(
+                    &frame, order, lost, numPackets[n], kPacketSize, seqNum,
+                    timeStamp);
+                if (time < 0)
+                {
+                    printf("Error: frame data out of order\n");
+                    delete [] order;
+                    delete [] lost;
+                    return -1;
+                }
+                totalTime += time;
+                timeStamp += 3000;
+            }
+            printf("%3d packets/frame, %-17s: %8.1f us/frame\n",
+                   numPackets[n], orderName[o],
+                   static_cast<double>(totalTime) / kNumFrames);
+        }
+        delete [] order;
+        delete [] lost;
+    }
+    return 0;
+}
+
+// Pretends to decode all complete frames.
+static void ReleaseCompleteFrames(VCMJitterBuffer& jb)
+{
+    VCMEncodedFrame* frameOut = NULL;
+    while ((frameOut = jb.GetCompleteFrameForDecoding(0)) != NULL)
+    {
+        jb.ReleaseFrame(frameOut);
+    }
+}
+
+// Measures the cost of keeping the NACK list up to date for a 1080p stream
+// (about 6 Mbps at 30 fps) with 5% random packet loss. Lost packets are
+// retransmitted kRttFrames frames later, and the NACK list is requested
+// kNackCallsPerFrame times per frame, as the retransmission timer would.
+// The RTT is left at zero so that every missing packet is listed on every
+// call.
+int JitterBufferNackBenchmark(CmdArgs& args)
+{
+    enum { kPacketSize = 1200 };
+    enum { kPacketsPerFrame = 21 };
+    enum { kNumFrames = 3000 };
+    enum { kRttFrames = 3 };
+    enum { kNackCallsPerFrame = 3 };
+    enum { kLossPercent = 5 };
+    enum { kHistory = kRttFrames + 1 };
+
+    srand(1234);
+    VCMJitterBuffer jb;
+    jb.Start();
+    jb.SetNackMode(kNackInfinite, -1, -1);
+
+    WebRtc_UWord8 data[kPacketSize];
+    memset(data, 0, sizeof(data));
+    VCMPacket packet(data, kPacketSize, 0, 0, false);
+    packet.completeNALU = kNaluComplete;
+
+    // Packets lost in the most recent frames, waiting for retransmission.
+    std::vector<int> lost[kHistory];
+    WebRtc_UWord16 firstSeqNum[kHistory];
+    WebRtc_UWord32 timeStamp[kHistory];
+    int numMissing = 0;
+    WebRtc_UWord16 seqNum = 0xffff - 1000;
+    WebRtc_Word64 insertTime = 0;
+    WebRtc_Word64 nackTime = 0;
+    int numInserted = 0;
+    int numNackCalls = 0;
+    for (int f = 0; f < kNumFrames; f++)
+    {
+        // Media packets, retransmissions of frame f - kRttFrames are sent
+        // after them.
+        for (int pass = 0; pass < 2; pass++)
+        {
+            if (pass == 1 && f < kRttFrames)
+            {
+                break;
+            }
+            const int h = (pass == 0 ? f : f - kRttFrames) % kHistory;
+            if (pass == 0)
+            {
+                lost[h].clear();
+                firstSeqNum[h] = seqNum;
+                timeStamp[h] = 3000 * f;
+                seqNum += kPacketsPerFrame;
+            }
+            packet.frameType = (f == 0) ? kVideoFrameKey : kVideoFrameDelta;
+            packet.timestamp = timeStamp[h];
+            const int numPackets = (pass == 0) ? kPacketsPerFrame :
+                static_cast<int>(lost[h].size());
+            for (int i = 0; i < numPackets; i++)
+            {
+                const int index = (pass == 0) ? i : lost[h][i];
+                // Never lose the first frame, there's nothing to NACK before
+                // it, nor the last packet of a frame, which reveals the
+                // losses before it.
+                if (pass == 0 && f > 0 && index < kPacketsPerFrame - 1 &&
+                    rand() % 100 < kLossPercent)
+                {
+                    lost[h].push_back(index);
+                    continue;
+                }
+                packet.seqNum = static_cast<WebRtc_UWord16>(firstSeqNum[h] +
+                                                            index);
+                packet.isFirstPacket = (index == 0);
+                packet.markerBit = (index == kPacketsPerFrame - 1);
+                const WebRtc_Word64 startTime =
+                    TickTime::MicrosecondTimestamp();
+                VCMEncodedFrame* frame = jb.GetFrame(packet);
+                if (frame == NULL || jb.InsertPacket(frame, packet) < 0)
+                {
+                    printf("Error: failed to insert packet %u\n",
+                           packet.seqNum);
+                    return -1;
+                }
+                insertTime += TickTime::MicrosecondTimestamp() - startTime;
+                numInserted++;
+            }
+            numMissing += (pass == 0 ? 1 : -1) *
+                static_cast<int>(lost[h].size());
+
+            ReleaseCompleteFrames(jb);
+            if (pass == 0)
+            {
+                for (int n = 0; n < kNackCallsPerFrame; n++)
+                {
+                    WebRtc_UWord16 nackSize = 0;
+                    bool extended = false;
+                    const WebRtc_Word64 startTime =
+                        TickTime::MicrosecondTimestamp();
+                    jb.GetNackList(nackSize, extended);
+                    nackTime += TickTime::MicrosecondTimestamp() - startTime;
+                    numNackCalls++;
+                    if (nackSize != numMissing)
+                    {
+                        printf("Error: NACK list has %u entries, expected "
+                               "%d\n", nackSize, numMissing);
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+    jb.Stop();
+
+    printf("1080p, %d%% loss, %d packets/frame, %d frames\n", kLossPercent,
+           kPacketsPerFrame, kNumFrames);
+    printf("InsertPacket: %6.2f us/packet\n",
+           static_cast<double>(insertTime) / numInserted);
+    printf("GetNackList:  %6.2f us/call\n",
+           static_cast<double>(nackTime) / numNackCalls);
+    return 0;
+}
+
+// Measures the packet insertion rate (GetFrame() and InsertPacket()) when
+// the jitter buffer holds many frames, as on high frame rate, high latency
+// links where frames are kept until their retransmissions arrive.
+int JitterBufferInsertBenchmark(CmdArgs& args)
+{
+    enum { kPacketSize = 1000 };
+    enum { kPacketsPerFrame = 10 };
+    enum { kNumFrames = 5000 };
+    const int framesBuffered[] = {10, 50, 90, 250};
+
+    WebRtc_UWord8 data[kPacketSize];
+    memset(data, 0, sizeof(data));
+    for (unsigned int n = 0;
+         n < sizeof(framesBuffered) / sizeof(*framesBuffered); n++)
+    {
+        VCMJitterBuffer jb;
+        jb.Start();
+        VCMPacket packet(data, kPacketSize, 0, 0, false);
+        packet.completeNALU = kNaluComplete;
+        packet.frameType = kVideoFrameKey;
+
+        WebRtc_UWord16 seqNum = 0;
+        WebRtc_Word64 insertTime = 0;
+        for (int f = 0; f < kNumFrames; f++)
+        {
+            packet.timestamp = 1500 * f;
+            const WebRtc_Word64 startTime = TickTime::MicrosecondTimestamp();
+            for (int i = 0; i < kPacketsPerFrame; i++)
+            {
+                packet.seqNum = seqNum++;
+                packet.isFirstPacket = (i == 0);
+                packet.markerBit = (i == kPacketsPerFrame - 1);
+                VCMEncodedFrame* frame = jb.GetFrame(packet);
+                if (frame == NULL || jb.InsertPacket(frame, packet) < 0)
+                {
+                    printf("Error: failed to insert packet %u\n",
+                           packet.seqNum);
+                    return -1;
+                }
+            }
+            insertTime += TickTime::MicrosecondTimestamp() - startTime;
+
+            // Keep framesBuffered[n] frames in the jitter buffer.
+            if (f >= framesBuffered[n])
+            {
+                VCMEncodedFrame* frameOut = jb.GetCompleteFrameForDecoding(0);
+                if (frameOut == NULL)
+                {
+                    printf("Error: no frame to decode\n");
+                    return -1;
+                }
+                jb.ReleaseFrame(frameOut);
+            }
+        }
+        jb.Stop();
+        printf("%3d frames buffered: %8.0f packets/s\n", framesBuffered[n],
+               1e6 * kNumFrames * kPacketsPerFrame / insertTime);
+    }
+    return 0;
+}
@@ -70,6 +70,9 @@ int RtpPlayMT(CmdArgs& args,
               webrtc::VideoCodecType releaseTestVideoType = webrtc::kVideoCodecVP8);
 int ReceiverTimingTests(CmdArgs& args);
 int JitterBufferTest(CmdArgs& args);
+int JitterBufferReorderBenchmark(CmdArgs& args);
+int JitterBufferNackBenchmark(CmdArgs& args);
+int JitterBufferInsertBenchmark(CmdArgs& args);
 int DecodeFromStorageTest(CmdArgs& args);
 
 // Thread functions:
@@ -202,6 +202,15 @@ int main(int argc, char **argv)
         ret |= ReceiverTimingTests(args);
         ret |= JitterBufferTest(args);
         break;
+    case 12:
+        ret = JitterBufferReorderBenchmark(args);
+        break;
+    case 13:
+        ret = JitterBufferNackBenchmark(args);
+        break;
+    case 14:
+        ret = JitterBufferInsertBenchmark(args);
+        break;
     default:
         ret = -1;
         break;
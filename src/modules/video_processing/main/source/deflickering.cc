@@ -15,7 +15,11 @@
 #include "deflickering.h"
 #include "trace.h"
 #include "signal_processing_library.h"
-#include "sort.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_USE_SSE2)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
 
@@ -46,9 +50,21 @@ const WebRtc_UWord16 VPMDeflickering::_probUW16[kNumProbs] =
 const WebRtc_UWord16 VPMDeflickering::_weightUW16[kNumQuants - kMaxOnlyLength] =
     {16384, 18432, 20480, 22528, 24576, 26624, 28672, 30720, 32768}; // <Q15>
  
-VPMDeflickering::VPMDeflickering() :
+VPMDeflickering::VPMDeflickering(bool RTCD) :
     _id(0)
 {
+    ComputeHistogram = &VPMDeflickering::ComputeHistogram_C;
+
+    if (RTCD)
+    {
+        if (WebRtc_GetCPUInfo(kSSE2))
+        {
+#if defined(WEBRTC_USE_SSE2)
+            ComputeHistogram = &VPMDeflickering::ComputeHistogram_SSE2;
+#endif
+        }
+    }
+
     Reset();
 }
 
@@ -146,19 +162,6 @@ VPMDeflickering::ProcessFrame(WebRtc_UWord8* frame,
 
     const WebRtc_UWord32 ySubSize = width * (((height - 1) >>
         kLog2OfDownsamplingFactor) + 1);
-    WebRtc_UWord8* ySorted = new WebRtc_UWord8[ySubSize];
-    WebRtc_UWord32 sortRowIdx = 0;
-    for (WebRtc_UWord32 i = 0; i < height; i += kDownsamplingFactor)
-    {
-        memcpy(ySorted + sortRowIdx * width, frame + i * width, width);
-        sortRowIdx++;
-    }
-    
-    webrtc::Sort(ySorted, ySubSize, webrtc::TYPE_UWord8);
-
-    WebRtc_UWord32 probIdxUW32 = 0;
-    quantUW8[0] = 0;
-    quantUW8[kNumQuants - 1] = 255;
 
     // Ensure we won't get an overflow below.
     // In practice, the number of subsampled pixels will not become this large.
@@ -169,15 +172,31 @@ VPMDeflickering::ProcessFrame(WebRtc_UWord8* frame,
         return -1;
     }
 
+    // The quantiles are read off the cumulative histogram; the pixel with
+    // index probIdxUW32 in sorted order is the first bin whose cumulative
+    // count exceeds probIdxUW32.
+    WebRtc_UWord32 histUW32[256];
+    (this->*ComputeHistogram)(frame, width, height, histUW32);
+
+    WebRtc_UWord32 probIdxUW32 = 0;
+    WebRtc_UWord32 binIdx = 0;
+    WebRtc_UWord32 cumSumUW32 = histUW32[0];
+    quantUW8[0] = 0;
+    quantUW8[kNumQuants - 1] = 255;
+
     for (WebRtc_Word32 i = 0; i < kNumProbs; i++)
     {
         probIdxUW32 = WEBRTC_SPL_UMUL_32_16(ySubSize, _probUW16[i]) >> 11; // <Q0>
-        quantUW8[i + 1] = ySorted[probIdxUW32];
+        // The probabilities are increasing and below one, so this stops
+        // before the last bin.
+        while (cumSumUW32 <= probIdxUW32)
+        {
+            binIdx++;
+            cumSumUW32 += histUW32[binIdx];
+        }
+        quantUW8[i + 1] = static_cast<WebRtc_UWord8>(binIdx);
     }
 
-    delete [] ySorted;
-    ySorted = NULL;
-
     // Shift history for new frame.
     memmove(_quantHistUW8[1], _quantHistUW8[0], (kFrameHistorySize - 1) * kNumQuants *
         sizeof(WebRtc_UWord8));
@@ -265,6 +284,75 @@ VPMDeflickering::ProcessFrame(WebRtc_UWord8* frame,
     return 0;
 }
 
+void
+VPMDeflickering::ComputeHistogram_C(const WebRtc_UWord8* frame,
+                                    const WebRtc_UWord32 width,
+                                    const WebRtc_UWord32 height,
+                                    WebRtc_UWord32* histUW32)
+{
+    memset(histUW32, 0, 256 * sizeof(WebRtc_UWord32));
+    for (WebRtc_UWord32 i = 0; i < height; i += kDownsamplingFactor)
+    {
+        const WebRtc_UWord8* row = frame + i * width;
+        for (WebRtc_UWord32 j = 0; j < width; j++)
+        {
+            histUW32[row[j]]++;
+        }
+    }
+}
+
+#if defined(WEBRTC_USE_SSE2)
+void
+VPMDeflickering::ComputeHistogram_SSE2(const WebRtc_UWord8* frame,
+                                       const WebRtc_UWord32 width,
+                                       const WebRtc_UWord32 height,
+                                       WebRtc_UWord32* histUW32)
+{
+    // Four partial histograms, so that neighbouring pixels of equal value
+    // (common in flat regions) don't serialize on the same counter.
+    WebRtc_UWord32 partialHistUW32[4][256];
+    memset(partialHistUW32, 0, sizeof(partialHistUW32));
+
+    for (WebRtc_UWord32 i = 0; i < height; i += kDownsamplingFactor)
+    {
+        const WebRtc_UWord8* row = frame + i * width;
+        WebRtc_UWord32 j = 0;
+        for (; j + 16 <= width; j += 16)
+        {
+            __m128i pixels = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(row + j));
+            for (WebRtc_Word32 k = 0; k < 4; k++)
+            {
+                const WebRtc_UWord32 fourPixels =
+                    static_cast<WebRtc_UWord32>(_mm_cvtsi128_si32(pixels));
+                partialHistUW32[0][fourPixels & 0xff]++;
+                partialHistUW32[1][(fourPixels >> 8) & 0xff]++;
+                partialHistUW32[2][(fourPixels >> 16) & 0xff]++;
+                partialHistUW32[3][fourPixels >> 24]++;
+                pixels = _mm_srli_si128(pixels, 4);
+            }
+        }
+        for (; j < width; j++)
+        {
+            partialHistUW32[0][row[j]]++;
+        }
+    }
+
+    // Sum up the partial histograms four bins at a time.
+    for (WebRtc_Word32 k = 0; k < 256; k += 4)
+    {
+        __m128i sum = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(&partialHistUW32[0][k]));
+        for (WebRtc_Word32 h = 1; h < 4; h++)
+        {
+            sum = _mm_add_epi32(sum, _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(&partialHistUW32[h][k])));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&histUW32[k]), sum);
+    }
+}
+#endif // #if defined(WEBRTC_USE_SSE2)
+
 /**
    Performs some pre-detection operations. Must be called before 
    DetectFlicker().
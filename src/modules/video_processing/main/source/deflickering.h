@@ -25,7 +25,9 @@ namespace webrtc {
 class VPMDeflickering
 {
 public:
-    VPMDeflickering();
+    // The optimized histogram is used when |RTCD| is true and the CPU
+    // supports it.
+    VPMDeflickering(bool RTCD = true);
     ~VPMDeflickering();
 
     WebRtc_Word32 ChangeUniqueId(WebRtc_Word32 id);
@@ -43,6 +45,20 @@ private:
 
     WebRtc_Word32 DetectFlicker();
 
+    // Computes the 256-bin histogram of the luminance in every
+    // kDownsamplingFactor:th row of |frame|.
+    typedef void (VPMDeflickering::*ComputeHistogramFunc)(
+        const WebRtc_UWord8* frame, WebRtc_UWord32 width,
+        WebRtc_UWord32 height, WebRtc_UWord32* histUW32);
+    ComputeHistogramFunc ComputeHistogram;
+    void ComputeHistogram_C(const WebRtc_UWord8* frame, WebRtc_UWord32 width,
+                            WebRtc_UWord32 height, WebRtc_UWord32* histUW32);
+#if defined(WEBRTC_USE_SSE2)
+    void ComputeHistogram_SSE2(const WebRtc_UWord8* frame,
+                               WebRtc_UWord32 width, WebRtc_UWord32 height,
+                               WebRtc_UWord32* histUW32);
+#endif
+
     enum { kMeanBufferLength = 32 };
     enum { kFrameHistorySize = 15 };
     enum { kNumProbs = 12 };
@@ -28,6 +28,26 @@
  * trunk/tools/matlab/parseLog.m.
  *
  * Table names and column names are case sensitive.
+ *
+ * Columnar tables are a cheaper alternative for data logged at a high rate.
+ * Tables and columns are registered up front and referred to by the handles
+ * returned at registration, and every column has a fixed type and length.
+ * Cells are copied into preallocated per-column buffers, without allocations
+ * or name lookups, and written in blocks to a binary file, table_name +
+ * ".dat", with the following layout:
+ *
+ *   "WDLC", version (1), number of columns
+ *   For each column:
+ *     length of the name, name, DataLogType, multi-value length
+ *   Blocks until the end of the file, each with:
+ *     number of rows
+ *     For each column:
+ *       (rows + 7) / 8 bytes of bit flags telling which rows have a value,
+ *       followed by rows * multi-value length values.
+ *
+ * All numbers except the name characters are 32-bit, and all numbers and
+ * values are stored in the byte order of the machine that wrote the file.
+ * ConvertColumnarToCsv() converts such a file to the CSV format above.
  */
 
 #ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_DATA_LOG_H_
@@ -114,6 +134,56 @@ class DataLog {
   // Starts a new empty row.
   // table_name is treated in a case-sensitive way.
   static int NextRow(const std::string& table_name);
+
+  // Adds a new columnar table, with the name table_name, and creates the file,
+  // with the name table_name + ".dat", to which the table will be written.
+  // Returns a handle to the table, or -1 on error.
+  static int AddColumnarTable(const std::string& table_name);
+
+  // Adds a new column of values of the given type to a columnar table. The
+  // column will be a multi-value-column if multi_value_length is greater
+  // than 1. Columns can only be added before the first cell is inserted.
+  // Returns a handle to the column, unique within the table, or -1 on error.
+  static int AddColumn(int table,
+                       const std::string& column_name,
+                       DataLogType type,
+                       int multi_value_length);
+
+  // Inserts a single value into the columnar table with handle table at the
+  // column with handle column. T must match the type of the column.
+  template<class T>
+  static int InsertCell(int table, int column, T value) {
+    DataLogImpl* data_log = DataLogImpl::StaticInstance();
+    if (data_log == NULL)
+      return -1;
+    return data_log->InsertCell(table, column, DataLogTypeTraits<T>::kType,
+                                &value, 1);
+  }
+
+  // Inserts an array of values into the columnar table with handle table at
+  // the column with handle column. T must match the type of the column and
+  // length the multi-value length of the column.
+  template<class T>
+  static int InsertCell(int table, int column, const T* array, int length) {
+    DataLogImpl* data_log = DataLogImpl::StaticInstance();
+    if (data_log == NULL)
+      return -1;
+    return data_log->InsertCell(table, column, DataLogTypeTraits<T>::kType,
+                                array, length);
+  }
+
+  // For the columnar table with handle table: Completes the current row and
+  // starts a new empty row. The row is written to file when its block is
+  // full, or when the log is deleted. Returns -1 if the file writer thread
+  // has fallen so far behind that the rows of the block had to be dropped.
+  static int NextRow(int table);
+
+  // Converts the columnar table file columnar_file_name to the CSV format
+  // described at the top of this file and writes it to csv_file_name.
+  // Columns are written in the order they were added, and every value of a
+  // missing cell is written as NaN.
+  static int ConvertColumnarToCsv(const std::string& columnar_file_name,
+                                  const std::string& csv_file_name);
 };
 
 }  // namespace webrtc
@@ -29,6 +29,7 @@
 
 namespace webrtc {
 
+class ColumnarTable;
 class CriticalSectionWrapper;
 class EventWrapper;
 class LogTable;
@@ -79,6 +80,40 @@ class MultiValueContainer : public Container {
   std::vector<T>  data_;
 };
 
+// The value types of columnar table columns. The values are stored in the
+// columnar table files, don't change them.
+enum DataLogType {
+  kDataLogInt32 = 0,
+  kDataLogUInt32 = 1,
+  kDataLogInt64 = 2,
+  kDataLogFloat = 3,
+  kDataLogDouble = 4
+};
+
+// Maps the C++ types that can be inserted into columnar tables to their
+// DataLogType. Other types fail to compile.
+template<class T> struct DataLogTypeTraits;
+
+template<> struct DataLogTypeTraits<WebRtc_Word32> {
+  static const DataLogType kType = kDataLogInt32;
+};
+
+template<> struct DataLogTypeTraits<WebRtc_UWord32> {
+  static const DataLogType kType = kDataLogUInt32;
+};
+
+template<> struct DataLogTypeTraits<WebRtc_Word64> {
+  static const DataLogType kType = kDataLogInt64;
+};
+
+template<> struct DataLogTypeTraits<float> {
+  static const DataLogType kType = kDataLogFloat;
+};
+
+template<> struct DataLogTypeTraits<double> {
+  static const DataLogType kType = kDataLogDouble;
+};
+
 class DataLogImpl {
  public:
   ~DataLogImpl();
@@ -116,6 +151,29 @@ class DataLogImpl {
   // data_log.h for a description.
   int NextRow(const std::string& table_name);
 
+  // The implementation of the AddColumnarTable() method declared in
+  // data_log.h. See data_log.h for a description.
+  int AddColumnarTable(const std::string& table_name);
+
+  // The implementation of the columnar AddColumn() method declared in
+  // data_log.h. See data_log.h for a description.
+  int AddColumn(int table,
+                const std::string& column_name,
+                DataLogType type,
+                int multi_value_length);
+
+  // Copies length values of the given type from values into the cell of the
+  // columnar table with handle table at the column with handle column.
+  int InsertCell(int table,
+                 int column,
+                 DataLogType type,
+                 const void* values,
+                 int length);
+
+  // The implementation of the columnar NextRow() method declared in
+  // data_log.h. See data_log.h for a description.
+  int NextRow(int table);
+
  private:
   DataLogImpl();
 
@@ -139,6 +197,12 @@ class DataLogImpl {
   // Stops the continuous calling of Process().
   void StopThread();
 
+  // Returns the columnar table with handle table, or NULL if there is none.
+  ColumnarTable* GetColumnarTable(int table) const;
+
+  // The maximum number of columnar tables.
+  enum { kMaxColumnarTables = 64 };
+
   // Collection of tables indexed by the table name as std::string.
   typedef std::map<std::string, LogTable*> TableMap;
   typedef webrtc::scoped_ptr<CriticalSectionWrapper> CritSectScopedPtr;
@@ -150,6 +214,10 @@ class DataLogImpl {
   EventWrapper*             flush_event_;
   ThreadWrapper*            file_writer_thread_;
   RWLockWrapper*            tables_lock_;
+  // Columnar tables indexed by their handles. Tables are only added, under
+  // tables_lock_, so the logging functions can look them up without a lock.
+  ColumnarTable*            columnar_tables_[kMaxColumnarTables];
+  int                       num_columnar_tables_;
 };
 
 }  // namespace webrtc
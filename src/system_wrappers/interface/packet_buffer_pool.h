@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Reference counted, pool allocated packet buffers. Packets are read from the
+// network straight into a PacketBuffer. A receiver that needs the packet after
+// the receive callback has returned keeps a reference to it instead of copying
+// the payload. The buffer goes back to its pool when the last reference is
+// released, so keeping packets doesn't allocate from the heap in steady state.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_PACKET_BUFFER_POOL_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_PACKET_BUFFER_POOL_H_
+
+#include "atomic32_wrapper.h"
+#include "typedefs.h"
+
+namespace webrtc {
+class CriticalSectionWrapper;
+class PacketBufferPool;
+
+struct PacketBufferPoolStatistics
+{
+    // Buffers allocated from the heap.
+    WebRtc_UWord32 allocations;
+    // Buffers handed out from the free list without touching the heap.
+    WebRtc_UWord32 reuses;
+    // Buffers currently referenced by someone.
+    WebRtc_UWord32 buffersInUse;
+    // Buffers waiting in the free list.
+    WebRtc_UWord32 buffersFree;
+};
+
+class PacketBuffer
+{
+public:
+    WebRtc_UWord8* Data() {return _data;}
+    const WebRtc_UWord8* Data() const {return _data;}
+    WebRtc_UWord32 Capacity() const {return _capacity;}
+
+    // Number of valid bytes in Data().
+    WebRtc_UWord32 Length() const {return _length;}
+    void SetLength(WebRtc_UWord32 length);
+
+    WebRtc_Word32 AddRef();
+    // Returns the buffer to its pool when the last reference is released.
+    WebRtc_Word32 Release();
+    // Returns true if the caller holds the only reference.
+    bool HasOneRef() const {return _refCount.Value() == 1;}
+
+private:
+    friend class PacketBufferPool;
+
+    PacketBuffer(PacketBufferPool* pool, WebRtc_UWord32 capacity);
+    ~PacketBuffer();
+
+    PacketBufferPool* _pool;
+    Atomic32Wrapper _refCount;
+    WebRtc_UWord8* _data;
+    WebRtc_UWord32 _capacity;
+    WebRtc_UWord32 _length;
+    // Free list link, only used while the buffer is owned by the pool.
+    PacketBuffer* _next;
+};
+
+class PacketBufferPool
+{
+public:
+    // Factory method, constructor disabled. Buffers hold bufferSize bytes.
+    // At most maxFreeBuffers released buffers are kept for reuse, the rest
+    // are returned to the heap. The pool is returned with one reference.
+    static PacketBufferPool* Create(WebRtc_UWord32 bufferSize,
+                                    WebRtc_UWord32 maxFreeBuffers);
+
+    // Returns a buffer holding one reference, or NULL if out of memory.
+    PacketBuffer* Acquire();
+
+    void Statistics(PacketBufferPoolStatistics& stats) const;
+
+    WebRtc_UWord32 BufferSize() const {return _bufferSize;}
+
+    // Every buffer in use holds a reference to its pool, so the pool is
+    // deleted when the owner and all buffers have released it.
+    WebRtc_Word32 AddRef();
+    WebRtc_Word32 Release();
+
+private:
+    friend class PacketBuffer;
+
+    PacketBufferPool(WebRtc_UWord32 bufferSize, WebRtc_UWord32 maxFreeBuffers);
+    ~PacketBufferPool();
+
+    void Return(PacketBuffer* buffer);
+
+    CriticalSectionWrapper* _crit;
+    Atomic32Wrapper _refCount;
+    const WebRtc_UWord32 _bufferSize;
+    const WebRtc_UWord32 _maxFreeBuffers;
+    PacketBuffer* _freeList;
+    PacketBufferPoolStatistics _stats;
+};
+} // namespace webrtc
+
+#endif // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_PACKET_BUFFER_POOL_H_
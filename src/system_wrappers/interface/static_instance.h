@@ -13,6 +13,7 @@
 
 #include <assert.h>
 
+#include "atomic32_wrapper.h"
 #include "critical_section_wrapper.h"
 #ifdef _WIN32
 #include "fix_interlocked_exchange_pointer_win.h"
@@ -35,10 +36,7 @@ template <class T>
 // Construct On First Use idiom. Avoids
 // "static initialization order fiasco".
 static T* GetStaticInstance(CountOperation count_operation) {
-  // TODO (hellner): use atomic wrapper instead.
-  static volatile long instance_count = 0;
   static T* volatile instance = NULL;
-  CreateOperation state = kInstanceExists;
 #ifndef _WIN32
   // This memory is staticly allocated once. The application does not try to
   // free this memory. This approach is taken to avoid issues with
@@ -47,46 +45,55 @@ static T* GetStaticInstance(CountOperation count_operation) {
   // reachable from statics leaked so no noise is added by doing this.
   static CriticalSectionWrapper* crit_sect(
       CriticalSectionWrapper::CreateCriticalSection());
-  CriticalSectionScoped lock(crit_sect);
+  static Atomic32Wrapper* instance_count(new Atomic32Wrapper(0));
 
-  if (count_operation ==
-      kAddRefNoCreate && instance_count == 0) {
-    return NULL;
+  // Taking and dropping a reference to an existing instance is lock free.
+  // The critical section is only needed to create and destroy the instance.
+  // instance is set before instance_count leaves zero and isn't cleared
+  // until instance_count is back at zero.
+  if (count_operation == kAddRefNoCreate) {
+    for (;;) {
+      const WebRtc_Word32 count = instance_count->Value();
+      if (count == 0) {
+        return NULL;
+      }
+      if (instance_count->CompareExchange(count + 1, count)) {
+        return instance;
+      }
+    }
   }
-  if (count_operation ==
-      kAddRef ||
-      count_operation == kAddRefNoCreate) {
-    instance_count++;
-    if (instance_count == 1) {
-      state = kCreate;
+  if (count_operation == kRelease) {
+    if (--(*instance_count) != 0) {
+      return instance;
     }
-  } else {
-    instance_count--;
-    if (instance_count == 0) {
-      state = kDestroy;
+    T* old_instance = NULL;
+    crit_sect->Enter();
+    // A kAddRef may have taken a new reference since the count reached zero.
+    if (instance_count->Value() == 0) {
+      old_instance = instance;
+      instance = NULL;
     }
-  }
-  if (state == kCreate) {
-    instance = T::CreateInstance();
-  } else if (state == kDestroy) {
-    T* old_instance = instance;
-    instance = NULL;
-    // The state will not change past this point. Release the critical
-    // section while deleting the object in case it would be blocking on
-    // access back to this object. (This is the case for the tracing class
-    // since the thread owned by the tracing class also traces).
+    // Release the critical section while deleting the object in case it
+    // would be blocking on access back to this object. (This is the case for
+    // the tracing class since the thread owned by the tracing class also
+    // traces).
     // TODO(hellner): this is a bit out of place but here goes, de-couple
     // thread implementation with trace implementation.
     crit_sect->Leave();
     if (old_instance) {
       delete old_instance;
     }
-    // Re-acquire the lock since the scoped critical section will release
-    // it.
-    crit_sect->Enter();
     return NULL;
   }
+
+  CriticalSectionScoped lock(crit_sect);
+  if (instance == NULL) {
+    instance = T::CreateInstance();
+  }
+  ++(*instance_count);
 #else  // _WIN32
+  static volatile long instance_count = 0;
+  CreateOperation state = kInstanceExists;
   if (count_operation ==
       kAddRefNoCreate && instance_count == 0) {
     return NULL;
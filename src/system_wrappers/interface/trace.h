@@ -64,7 +64,9 @@ public:
     // part of the code the message is comming.
     // id is an identifier that should be unique for that set of classes that
     // are associated (e.g. all instances owned by an engine).
-    // msg and the elipsis are the same as e.g. sprintf.
+    // msg and the elipsis are the same as e.g. sprintf. Formatting is done
+    // by the trace thread, so msg must outlive the call (e.g. a string
+    // literal). Pass messages built at runtime as "%s" arguments.
     // TODO (hellner) Why is TraceModule not defined in this file?
     static void Add(const TraceLevel level,
                     const TraceModule module,
@@ -18,6 +18,7 @@ LOCAL_MODULE_TAGS := optional
 LOCAL_CPP_EXTENSION := .cc
 LOCAL_SRC_FILES := \
     map.cc \
+    packet_buffer_pool.cc \
     rw_lock_generic.cc \
     sort.cc \
     aligned_malloc.cc \
@@ -34,6 +35,7 @@ LOCAL_SRC_FILES := \
     rw_lock.cc \
     thread.cc \
     trace_impl.cc \
+    trace_ring_buffer.cc \
     condition_variable_posix.cc \
     cpu_linux.cc \
     critical_section_posix.cc \
@@ -11,6 +11,7 @@
 #include "data_log.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include <algorithm>
 #include <list>
@@ -104,6 +105,132 @@ class LogTable {
   CriticalSectionWrapper* table_lock_;
 };
 
+// A ColumnarTable stores the cells of each column in a preallocated block of
+// rows, with a fixed size for each cell given by the type and the length of
+// the column. There are two blocks: one being filled by the logging thread,
+// and one full block waiting for, or being written by, Flush().
+class ColumnarTable {
+ public:
+  // The number of rows in a block.
+  enum { kRowsPerBlock = 256 };
+
+  ColumnarTable();
+  ~ColumnarTable();
+
+  // Creates a log file, named as specified in the string file_name, to
+  // where the table will be written when calling Flush().
+  int CreateLogFile(const std::string& file_name);
+
+  // Adds a column and returns its handle. Fails once the first cell has been
+  // inserted.
+  int AddColumn(const std::string& column_name,
+                DataLogType type,
+                int multi_value_length);
+
+  // Copies length values of the given type into the current row at the
+  // column with handle column.
+  int InsertCell(int column, DataLogType type, const void* values,
+                 int length);
+
+  // Completes the current row. Returns 1 if a block is ready to be written
+  // by Flush(), 0 if not, and -1 if a full block had to be dropped because
+  // the previous one still hasn't been written.
+  int NextRow();
+
+  // Writes the full block, if there is one, to file.
+  // May not be called by two threads simultaneously. Will be called by the
+  // file_writer_thread_ when that thread is running.
+  void Flush();
+
+ private:
+  struct Column {
+    std::string name;
+    DataLogType type;
+    int multi_value_length;
+    // Size of one cell in bytes.
+    int cell_size;
+    // Offset of the column in the values and the flags of a block.
+    size_t values_offset;
+    size_t flags_offset;
+  };
+
+  struct Block {
+    std::vector<WebRtc_UWord8> values;
+    // One bit per row and column, set for the cells that have a value.
+    std::vector<WebRtc_UWord8> flags;
+    int rows;
+  };
+
+  // Sizes the blocks for the columns added so far.
+  void AllocateBlocks();
+
+  void WriteHeader();
+  void WriteBlock(const Block& block);
+  void ClearBlock(Block* block);
+
+  std::vector<Column>     columns_;
+  Block                   blocks_[2];
+  Block*                  fill_block_;
+  Block*                  flush_block_;
+  bool                    allocated_;
+  bool                    write_header_;
+  FileWrapper*            file_;
+  CriticalSectionWrapper* table_lock_;
+};
+
+namespace {
+
+const char kColumnarMagic[4] = {'W', 'D', 'L', 'C'};
+const WebRtc_UWord32 kColumnarVersion = 1;
+
+int DataLogTypeSize(DataLogType type) {
+  switch (type) {
+    case kDataLogInt32:
+      return sizeof(WebRtc_Word32);
+    case kDataLogUInt32:
+      return sizeof(WebRtc_UWord32);
+    case kDataLogInt64:
+      return sizeof(WebRtc_Word64);
+    case kDataLogFloat:
+      return sizeof(float);
+    case kDataLogDouble:
+      return sizeof(double);
+  }
+  return 0;
+}
+
+// Formats value the same way as ValueContainer does.
+template<class T>
+std::string FormatValue(const WebRtc_UWord8* value) {
+  T data;
+  memcpy(&data, value, sizeof(data));
+  std::stringstream ss;
+  ss << data << ",";
+  return ss.str();
+}
+
+std::string FormatValue(DataLogType type, const WebRtc_UWord8* value) {
+  switch (type) {
+    case kDataLogInt32:
+      return FormatValue<WebRtc_Word32>(value);
+    case kDataLogUInt32:
+      return FormatValue<WebRtc_UWord32>(value);
+    case kDataLogInt64:
+      return FormatValue<WebRtc_Word64>(value);
+    case kDataLogFloat:
+      return FormatValue<float>(value);
+    case kDataLogDouble:
+      return FormatValue<double>(value);
+  }
+  return "NaN,";
+}
+
+bool ReadUWord32(FileWrapper* file, WebRtc_UWord32* value) {
+  return file->Read(value, sizeof(*value)) == sizeof(*value);
+}
+
+}  // namespace
+
 Row::Row()
   : cells_(),
     cells_lock_(CriticalSectionWrapper::CreateCriticalSection()) {
@@ -273,6 +400,165 @@ void LogTable::Flush() {
   }
 }
 
+ColumnarTable::ColumnarTable()
+  : columns_(),
+    fill_block_(&blocks_[0]),
+    flush_block_(&blocks_[1]),
+    allocated_(false),
+    write_header_(true),
+    file_(FileWrapper::Create()),
+    table_lock_(CriticalSectionWrapper::CreateCriticalSection()) {
+  blocks_[0].rows = 0;
+  blocks_[1].rows = 0;
+}
+
+ColumnarTable::~ColumnarTable() {
+  // Write the full block and what there is of the one being filled.
+  Flush();
+  if (write_header_)
+    WriteHeader();
+  if (fill_block_->rows > 0)
+    WriteBlock(*fill_block_);
+  file_->Flush();
+  file_->CloseFile();
+  delete file_;
+  delete table_lock_;
+}
+
+int ColumnarTable::CreateLogFile(const std::string& file_name) {
+  if (file_name.length() == 0)
+    return -1;
+  if (file_->Open())
+    return -1;
+  return file_->OpenFile(file_name.c_str(),
+                         false,  // Open with read/write permissions
+                         false,  // Don't wraparound
+                         false);  // Open as a binary file
+}
+
+int ColumnarTable::AddColumn(const std::string& column_name,
+                             DataLogType type,
+                             int multi_value_length) {
+  if (multi_value_length < 1 || DataLogTypeSize(type) == 0)
+    return -1;
+  CriticalSectionScoped synchronize(table_lock_);
+  if (allocated_)
+    return -1;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    if (columns_[i].name == column_name)
+      return -1;
+  }
+  Column column;
+  column.name = column_name;
+  column.type = type;
+  column.multi_value_length = multi_value_length;
+  column.cell_size = DataLogTypeSize(type) * multi_value_length;
+  column.values_offset = 0;
+  column.flags_offset = 0;
+  columns_.push_back(column);
+  return static_cast<int>(columns_.size()) - 1;
+}
+
+void ColumnarTable::AllocateBlocks() {
+  size_t values_size = 0;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    columns_[i].values_offset = values_size;
+    columns_[i].flags_offset = i * (kRowsPerBlock / 8);
+    values_size += kRowsPerBlock * columns_[i].cell_size;
+  }
+  for (int i = 0; i < 2; ++i) {
+    blocks_[i].values.resize(values_size);
+    blocks_[i].flags.assign(columns_.size() * (kRowsPerBlock / 8), 0);
+  }
+  allocated_ = true;
+}
+
+int ColumnarTable::InsertCell(int column, DataLogType type,
+                              const void* values, int length) {
+  CriticalSectionScoped synchronize(table_lock_);
+  if (column < 0 || column >= static_cast<int>(columns_.size()))
+    return -1;
+  const Column& col = columns_[column];
+  if (type != col.type || length != col.multi_value_length)
+    return -1;
+  if (!allocated_)
+    AllocateBlocks();
+  const int row = fill_block_->rows;
+  WebRtc_UWord8& flags = fill_block_->flags[col.flags_offset + row / 8];
+  const WebRtc_UWord8 bit = static_cast<WebRtc_UWord8>(1 << (row % 8));
+  if (flags & bit)
+    return -1;
+  flags |= bit;
+  memcpy(&fill_block_->values[col.values_offset + row * col.cell_size],
+         values, col.cell_size);
+  return 0;
+}
+
+int ColumnarTable::NextRow() {
+  CriticalSectionScoped synchronize(table_lock_);
+  if (!allocated_)
+    AllocateBlocks();
+  if (++fill_block_->rows < kRowsPerBlock)
+    return 0;
+  if (flush_block_->rows > 0) {
+    // Flush() hasn't written the previous block yet.
+    ClearBlock(fill_block_);
+    return -1;
+  }
+  Block* tmp = flush_block_;
+  flush_block_ = fill_block_;
+  fill_block_ = tmp;
+  return 1;
+}
+
+void ColumnarTable::Flush() {
+  // The block is only written here, and NextRow() doesn't touch it until it
+  // has been cleared, so it can be written without holding the lock.
+  {
+    CriticalSectionScoped synchronize(table_lock_);
+    if (flush_block_->rows == 0)
+      return;
+  }
+  if (write_header_)
+    WriteHeader();
+  WriteBlock(*flush_block_);
+  CriticalSectionScoped synchronize(table_lock_);
+  ClearBlock(flush_block_);
+}
+
+void ColumnarTable::WriteHeader() {
+  write_header_ = false;
+  const WebRtc_UWord32 num_columns = columns_.size();
+  file_->Write(kColumnarMagic, sizeof(kColumnarMagic));
+  file_->Write(&kColumnarVersion, sizeof(kColumnarVersion));
+  file_->Write(&num_columns, sizeof(num_columns));
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    const WebRtc_UWord32 name_length = columns_[i].name.length();
+    const WebRtc_UWord32 type = columns_[i].type;
+    const WebRtc_UWord32 multi_value_length = columns_[i].multi_value_length;
+    file_->Write(&name_length, sizeof(name_length));
+    file_->Write(columns_[i].name.data(), name_length);
+    file_->Write(&type, sizeof(type));
+    file_->Write(&multi_value_length, sizeof(multi_value_length));
+  }
+}
+
+void ColumnarTable::WriteBlock(const Block& block) {
+  const WebRtc_UWord32 rows = block.rows;
+  file_->Write(&rows, sizeof(rows));
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    file_->Write(&block.flags[columns_[i].flags_offset], (rows + 7) / 8);
+    file_->Write(&block.values[columns_[i].values_offset],
+                 rows * columns_[i].cell_size);
+  }
+}
+
+void ColumnarTable::ClearBlock(Block* block) {
+  block->rows = 0;
+  if (!block->flags.empty())
+    memset(&block->flags[0], 0, block->flags.size());
+}
+
 int DataLog::CreateLog() {
   return DataLogImpl::CreateLog();
 }
@@ -318,12 +604,127 @@ int DataLog::NextRow(const std::string& table_name) {
   return data_log->DataLogImpl::StaticInstance()->NextRow(table_name);
 }
 
+int DataLog::AddColumnarTable(const std::string& table_name) {
+  DataLogImpl* data_log = DataLogImpl::StaticInstance();
+  if (data_log == NULL)
+    return -1;
+  return data_log->AddColumnarTable(table_name);
+}
+
+int DataLog::AddColumn(int table,
+                       const std::string& column_name,
+                       DataLogType type,
+                       int multi_value_length) {
+  DataLogImpl* data_log = DataLogImpl::StaticInstance();
+  if (data_log == NULL)
+    return -1;
+  return data_log->AddColumn(table, column_name, type, multi_value_length);
+}
+
+int DataLog::NextRow(int table) {
+  DataLogImpl* data_log = DataLogImpl::StaticInstance();
+  if (data_log == NULL)
+    return -1;
+  return data_log->NextRow(table);
+}
+
+int DataLog::ConvertColumnarToCsv(const std::string& columnar_file_name,
+                                  const std::string& csv_file_name) {
+  scoped_ptr<FileWrapper> in_file(FileWrapper::Create());
+  if (in_file->OpenFile(columnar_file_name.c_str(), true) == -1)
+    return -1;
+  char magic[sizeof(kColumnarMagic)];
+  WebRtc_UWord32 version = 0;
+  WebRtc_UWord32 num_columns = 0;
+  if (in_file->Read(magic, sizeof(magic)) != sizeof(magic) ||
+      memcmp(magic, kColumnarMagic, sizeof(magic)) != 0 ||
+      !ReadUWord32(in_file.get(), &version) ||
+      version != kColumnarVersion ||
+      !ReadUWord32(in_file.get(), &num_columns))
+    return -1;
+
+  std::vector<std::string> names(num_columns);
+  std::vector<DataLogType> types(num_columns);
+  std::vector<WebRtc_UWord32> lengths(num_columns);
+  for (WebRtc_UWord32 i = 0; i < num_columns; ++i) {
+    WebRtc_UWord32 name_length = 0;
+    WebRtc_UWord32 type = 0;
+    if (!ReadUWord32(in_file.get(), &name_length))
+      return -1;
+    names[i].resize(name_length);
+    if ((name_length > 0 &&
+         in_file->Read(&names[i][0], name_length) !=
+             static_cast<int>(name_length)) ||
+        !ReadUWord32(in_file.get(), &type) ||
+        !ReadUWord32(in_file.get(), &lengths[i]))
+      return -1;
+    types[i] = static_cast<DataLogType>(type);
+    if (DataLogTypeSize(types[i]) == 0 || lengths[i] < 1)
+      return -1;
+  }
+
+  scoped_ptr<FileWrapper> out_file(FileWrapper::Create());
+  if (out_file->OpenFile(csv_file_name.c_str(), false, false, true) == -1)
+    return -1;
+  for (WebRtc_UWord32 i = 0; i < num_columns; ++i) {
+    if (lengths[i] > 1) {
+      out_file->WriteText("%s[%u],", names[i].c_str(), lengths[i]);
+      for (WebRtc_UWord32 j = 1; j < lengths[i]; ++j)
+        out_file->WriteText(",");
+    } else {
+      out_file->WriteText("%s,", names[i].c_str());
+    }
+  }
+  if (num_columns > 0)
+    out_file->WriteText("\n");
+
+  WebRtc_UWord32 rows = 0;
+  std::vector<std::vector<WebRtc_UWord8> > flags(num_columns);
+  std::vector<std::vector<WebRtc_UWord8> > values(num_columns);
+  while (ReadUWord32(in_file.get(), &rows)) {
+    for (WebRtc_UWord32 i = 0; i < num_columns; ++i) {
+      const int cell_size = DataLogTypeSize(types[i]) * lengths[i];
+      flags[i].resize((rows + 7) / 8);
+      values[i].resize(rows * cell_size);
+      if ((rows > 0 &&
+           in_file->Read(&flags[i][0], flags[i].size()) !=
+               static_cast<int>(flags[i].size())) ||
+          (rows > 0 &&
+           in_file->Read(&values[i][0], values[i].size()) !=
+               static_cast<int>(values[i].size())))
+        return -1;
+    }
+    for (WebRtc_UWord32 row = 0; row < rows; ++row) {
+      for (WebRtc_UWord32 i = 0; i < num_columns; ++i) {
+        const int value_size = DataLogTypeSize(types[i]);
+        const bool present = (flags[i][row / 8] >> (row % 8)) & 1;
+        for (WebRtc_UWord32 j = 0; j < lengths[i]; ++j) {
+          if (present) {
+            const WebRtc_UWord8* value =
+                &values[i][(row * lengths[i] + j) * value_size];
+            out_file->WriteText("%s", FormatValue(types[i], value).c_str());
+          } else {
+            out_file->WriteText("NaN,");
+          }
+        }
+      }
+      if (num_columns > 0)
+        out_file->WriteText("\n");
+    }
+  }
+  out_file->Flush();
+  out_file->CloseFile();
+  return 0;
+}
+
 DataLogImpl::DataLogImpl()
   : counter_(1),
     tables_(),
     flush_event_(EventWrapper::Create()),
     file_writer_thread_(NULL),
-    tables_lock_(RWLockWrapper::CreateRWLock()) {
+    tables_lock_(RWLockWrapper::CreateRWLock()),
+    num_columnar_tables_(0) {
+  memset(columnar_tables_, 0, sizeof(columnar_tables_));
 }
 
 DataLogImpl::~DataLogImpl() {
@@ -336,6 +737,8 @@ DataLogImpl::~DataLogImpl() {
     // For maps all iterators (except the erased) are valid after an erase
     tables_.erase(it++);
   }
+  for (int i = 0; i < num_columnar_tables_; ++i)
+    delete columnar_tables_[i];
   delete tables_lock_;
 }
 
@@ -424,11 +827,70 @@ int DataLogImpl::NextRow(const std::string& table_name) {
   return 0;
 }
 
+int DataLogImpl::AddColumnarTable(const std::string& table_name) {
+  WriteLockScoped synchronize(*tables_lock_);
+  if (num_columnar_tables_ == kMaxColumnarTables)
+    return -1;
+  ColumnarTable* table = new ColumnarTable();
+  if (table->CreateLogFile(table_name + ".dat") == -1) {
+    delete table;
+    return -1;
+  }
+  columnar_tables_[num_columnar_tables_] = table;
+  return num_columnar_tables_++;
+}
+
+ColumnarTable* DataLogImpl::GetColumnarTable(int table) const {
+  if (table < 0 || table >= kMaxColumnarTables)
+    return NULL;
+  return columnar_tables_[table];
+}
+
+int DataLogImpl::AddColumn(int table,
+                           const std::string& column_name,
+                           DataLogType type,
+                           int multi_value_length) {
+  ColumnarTable* columnar_table = GetColumnarTable(table);
+  if (columnar_table == NULL)
+    return -1;
+  return columnar_table->AddColumn(column_name, type, multi_value_length);
+}
+
+int DataLogImpl::InsertCell(int table,
+                            int column,
+                            DataLogType type,
+                            const void* values,
+                            int length) {
+  ColumnarTable* columnar_table = GetColumnarTable(table);
+  if (columnar_table == NULL)
+    return -1;
+  return columnar_table->InsertCell(column, type, values, length);
+}
+
+int DataLogImpl::NextRow(int table) {
+  ColumnarTable* columnar_table = GetColumnarTable(table);
+  if (columnar_table == NULL)
+    return -1;
+  const int ret = columnar_table->NextRow();
+  if (ret == 1) {
+    if (file_writer_thread_ == NULL) {
+      columnar_table->Flush();
+    } else {
+      // Signal a complete block.
+      flush_event_->Set();
+    }
+  }
+  return ret < 0 ? -1 : 0;
+}
+
 void DataLogImpl::Flush() {
   ReadLockScoped synchronize(*tables_lock_);
   for (TableMap::iterator it = tables_.begin(); it != tables_.end(); ++it) {
     it->second->Flush();
   }
+  for (int i = 0; i < num_columnar_tables_; ++i) {
+    columnar_tables_[i]->Flush();
+  }
 }
 
 bool DataLogImpl::Run(void* obj) {
@@ -39,6 +39,26 @@ int DataLog::NextRow(const std::string& /*table_name*/) {
   return 0;
 }
 
+int DataLog::AddColumnarTable(const std::string& /*table_name*/) {
+  return 0;
+}
+
+int DataLog::AddColumn(int /*table*/,
+                       const std::string& /*column_name*/,
+                       DataLogType /*type*/,
+                       int /*multi_value_length*/) {
+  return 0;
+}
+
+int DataLog::NextRow(int /*table*/) {
+  return 0;
+}
+
+int DataLog::ConvertColumnarToCsv(const std::string& /*columnar_file_name*/,
+                                  const std::string& /*csv_file_name*/) {
+  return -1;
+}
+
 DataLogImpl::DataLogImpl() {
 }
 
@@ -72,6 +92,29 @@ int DataLogImpl::NextRow(const std::string& /*table_name*/) {
   return 0;
 }
 
+int DataLogImpl::AddColumnarTable(const std::string& /*table_name*/) {
+  return 0;
+}
+
+int DataLogImpl::AddColumn(int /*table*/,
+                           const std::string& /*column_name*/,
+                           DataLogType /*type*/,
+                           int /*multi_value_length*/) {
+  return 0;
+}
+
+int DataLogImpl::InsertCell(int /*table*/,
+                            int /*column*/,
+                            DataLogType /*type*/,
+                            const void* /*values*/,
+                            int /*length*/) {
+  return 0;
+}
+
+int DataLogImpl::NextRow(int /*table*/) {
+  return 0;
+}
+
 void DataLogImpl::Flush() {
 }
 
@@ -9,7 +9,9 @@
  */
 
 #include <map>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "system_wrappers/interface/data_log.h"
 #include "system_wrappers/interface/data_log_c.h"
@@ -280,6 +282,87 @@ TEST(TestDataLog, VerifyMultipleTables) {
   }
 }
 
+TEST(TestDataLog, VerifyColumnarTable) {
+  ASSERT_EQ(0, DataLog::CreateLog());
+  const int table = DataLog::AddColumnarTable("columnar_1");
+  ASSERT_GE(table, 0);
+  // Registered in alphabetical order, which is what DataLogParser expects.
+  const int arrival = DataLog::AddColumn(table, "arrival",
+                                         webrtc::kDataLogDouble, 1);
+  const int size = DataLog::AddColumn(table, "size",
+                                      webrtc::kDataLogUInt32, 5);
+  const int timestamp = DataLog::AddColumn(table, "timestamp",
+                                           webrtc::kDataLogInt64, 1);
+  ASSERT_GE(arrival, 0);
+  ASSERT_GE(size, 0);
+  ASSERT_GE(timestamp, 0);
+  EXPECT_EQ(-1, DataLog::AddColumn(table, "arrival",
+                                   webrtc::kDataLogDouble, 1));
+  EXPECT_EQ(-1, DataLog::AddColumn(table + 1, "arrival",
+                                   webrtc::kDataLogDouble, 1));
+
+  // Enough rows for several blocks. Every third timestamp is missing.
+  const int kNumberOfRows = 1000;
+  WebRtc_UWord32 sizes[5] = {1400, 1500, 1600, 1700, 1800};
+  std::vector<std::string> string_arrival;
+  std::vector<std::string> string_timestamp;
+  std::vector<std::string> block_arrival;
+  std::vector<std::string> block_timestamp;
+  for (int i = 0; i < kNumberOfRows; ++i) {
+    std::stringstream ss;
+    ss << i << ",";
+    block_arrival.push_back(ss.str());
+    EXPECT_EQ(0, DataLog::InsertCell(table, arrival, static_cast<double>(i)));
+    EXPECT_EQ(0, DataLog::InsertCell(table, size, sizes, 5));
+    if (i % 3 != 0) {
+      std::stringstream ts;
+      ts << 4354 + i << ",";
+      block_timestamp.push_back(ts.str());
+      EXPECT_EQ(0, DataLog::InsertCell(table, timestamp,
+                                       static_cast<WebRtc_Word64>(4354 + i)));
+    } else {
+      block_timestamp.push_back("NaN,");
+    }
+    // Wrong type, wrong length and a cell which is already set.
+    EXPECT_EQ(-1, DataLog::InsertCell(table, arrival,
+                                      static_cast<WebRtc_Word32>(i)));
+    EXPECT_EQ(-1, DataLog::InsertCell(table, size, sizes, 4));
+    EXPECT_EQ(-1, DataLog::InsertCell(table, arrival, 0.0));
+    // NextRow() drops a full block if the file writer thread hasn't written
+    // the previous one yet; keep track of the rows which make it to file.
+    const int ret = DataLog::NextRow(table);
+    if (ret == -1 || (i + 1) % 256 == 0 || i == kNumberOfRows - 1) {
+      if (ret == 0) {
+        string_arrival.insert(string_arrival.end(), block_arrival.begin(),
+                              block_arrival.end());
+        string_timestamp.insert(string_timestamp.end(),
+                                block_timestamp.begin(),
+                                block_timestamp.end());
+      }
+      block_arrival.clear();
+      block_timestamp.clear();
+    }
+  }
+  EXPECT_EQ(-1, DataLog::AddColumn(table, "late", webrtc::kDataLogFloat, 1));
+  DataLog::ReturnLog();
+
+  ASSERT_EQ(0, DataLog::ConvertColumnarToCsv("columnar_1.dat",
+                                             "columnar_1.txt"));
+  FILE* csv = fopen("columnar_1.txt", "r");
+  ASSERT_FALSE(csv == NULL);
+  ExpectedValuesMap expected;
+  expected["arrival,"] = ExpectedValues(string_arrival, 1);
+  expected["size[5],,,,,"] = ExpectedValues(
+      std::vector<std::string>(string_arrival.size(),
+                               "1400,1500,1600,1700,1800,"), 5);
+  expected["timestamp,"] = ExpectedValues(string_timestamp, 1);
+  ASSERT_EQ(DataLogParser::VerifyTable(csv, expected), 0);
+  fclose(csv);
+
+  EXPECT_EQ(-1, DataLog::ConvertColumnarToCsv("table_1.txt",
+                                              "columnar_2.txt"));
+}
+
 TEST(TestDataLogCWrapper, VerifyCWrapper) {
   // Simply call all C wrapper log functions through the C helper unittests.
   // Main purpose is to make sure that the linkage is correct.
@@ -53,3 +53,17 @@ TEST(TestDataLogDisabled, EnsureNoFileIsWritten) {
   // Verify no data log file have been written:
   ASSERT_EQ(NULL, fopen(kDataLogFileName, "r"));
 }
+
+TEST(TestDataLogDisabled, EnsureNoColumnarFileIsWritten) {
+  std::remove("columnar_1.dat");
+  ASSERT_EQ(0, DataLog::CreateLog());
+  const int table = DataLog::AddColumnarTable("columnar_1");
+  const int column = DataLog::AddColumn(table, "test",
+                                        webrtc::kDataLogDouble, 1);
+  for (int i = 0; i < 10; ++i) {
+    DataLog::InsertCell(table, column, static_cast<double>(i));
+    EXPECT_EQ(0, DataLog::NextRow(table));
+  }
+  DataLog::ReturnLog();
+  ASSERT_EQ(NULL, fopen("columnar_1.dat", "r"));
+}
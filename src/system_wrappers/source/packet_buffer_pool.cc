@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "packet_buffer_pool.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "critical_section_wrapper.h"
+
+namespace webrtc {
+PacketBuffer::PacketBuffer(PacketBufferPool* pool, WebRtc_UWord32 capacity)
+    : _pool(pool),
+      _refCount(0),
+      _data(new WebRtc_UWord8[capacity]),
+      _capacity(capacity),
+      _length(0),
+      _next(NULL)
+{
+}
+
+PacketBuffer::~PacketBuffer()
+{
+    delete [] _data;
+}
+
+void PacketBuffer::SetLength(WebRtc_UWord32 length)
+{
+    assert(length <= _capacity);
+    _length = (length <= _capacity) ? length : _capacity;
+}
+
+WebRtc_Word32 PacketBuffer::AddRef()
+{
+    return ++_refCount;
+}
+
+WebRtc_Word32 PacketBuffer::Release()
+{
+    WebRtc_Word32 refCount = --_refCount;
+    if (refCount == 0)
+    {
+        _pool->Return(this);
+    }
+    return refCount;
+}
+
+PacketBufferPool* PacketBufferPool::Create(WebRtc_UWord32 bufferSize,
+                                           WebRtc_UWord32 maxFreeBuffers)
+{
+    PacketBufferPool* pool = new PacketBufferPool(bufferSize, maxFreeBuffers);
+    pool->AddRef();
+    return pool;
+}
+
+PacketBufferPool::PacketBufferPool(WebRtc_UWord32 bufferSize,
+                                   WebRtc_UWord32 maxFreeBuffers)
+    : _crit(CriticalSectionWrapper::CreateCriticalSection()),
+      _refCount(0),
+      _bufferSize(bufferSize),
+      _maxFreeBuffers(maxFreeBuffers),
+      _freeList(NULL)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+PacketBufferPool::~PacketBufferPool()
+{
+    assert(_stats.buffersInUse == 0);
+    while (_freeList)
+    {
+        PacketBuffer* buffer = _freeList;
+        _freeList = buffer->_next;
+        delete buffer;
+    }
+    delete _crit;
+}
+
+WebRtc_Word32 PacketBufferPool::AddRef()
+{
+    return ++_refCount;
+}
+
+WebRtc_Word32 PacketBufferPool::Release()
+{
+    WebRtc_Word32 refCount = --_refCount;
+    if (refCount == 0)
+    {
+        delete this;
+    }
+    return refCount;
+}
+
+PacketBuffer* PacketBufferPool::Acquire()
+{
+    PacketBuffer* buffer = NULL;
+    {
+        CriticalSectionScoped cs(_crit);
+        if (_freeList)
+        {
+            buffer = _freeList;
+            _freeList = buffer->_next;
+            buffer->_next = NULL;
+            _stats.buffersFree--;
+            _stats.reuses++;
+        } else {
+            buffer = new PacketBuffer(this, _bufferSize);
+            if (buffer == NULL)
+            {
+                return NULL;
+            }
+            _stats.allocations++;
+        }
+        _stats.buffersInUse++;
+    }
+    buffer->_length = 0;
+    buffer->AddRef();
+    AddRef();
+    return buffer;
+}
+
+void PacketBufferPool::Return(PacketBuffer* buffer)
+{
+    {
+        CriticalSectionScoped cs(_crit);
+        _stats.buffersInUse--;
+        if (_stats.buffersFree < _maxFreeBuffers)
+        {
+            buffer->_next = _freeList;
+            _freeList = buffer;
+            _stats.buffersFree++;
+            buffer = NULL;
+        }
+    }
+    delete buffer;
+    // Drop the reference held by the buffer.
+    Release();
+}
+
+void PacketBufferPool::Statistics(PacketBufferPoolStatistics& stats) const
+{
+    CriticalSectionScoped cs(_crit);
+    stats = _stats;
+}
+} // namespace webrtc
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "gtest/gtest.h"
+
+#include "system_wrappers/interface/packet_buffer_pool.h"
+
+using ::webrtc::PacketBuffer;
+using ::webrtc::PacketBufferPool;
+using ::webrtc::PacketBufferPoolStatistics;
+
+TEST(PacketBufferPoolTest, ReusesReleasedBuffers) {
+  PacketBufferPool* pool = PacketBufferPool::Create(1500, 4);
+  PacketBufferPoolStatistics stats;
+
+  PacketBuffer* first = pool->Acquire();
+  ASSERT_TRUE(first != NULL);
+  EXPECT_EQ(1500u, first->Capacity());
+  EXPECT_EQ(0u, first->Length());
+  first->Release();
+
+  for (int i = 0; i < 100; ++i) {
+    PacketBuffer* buffer = pool->Acquire();
+    EXPECT_EQ(first, buffer);
+    buffer->Release();
+  }
+  pool->Statistics(stats);
+  EXPECT_EQ(1u, stats.allocations);
+  EXPECT_EQ(100u, stats.reuses);
+  EXPECT_EQ(0u, stats.buffersInUse);
+  EXPECT_EQ(1u, stats.buffersFree);
+  pool->Release();
+}
+
+TEST(PacketBufferPoolTest, ReferencesKeepBufferAlive) {
+  PacketBufferPool* pool = PacketBufferPool::Create(1500, 4);
+  PacketBufferPoolStatistics stats;
+
+  PacketBuffer* buffer = pool->Acquire();
+  EXPECT_TRUE(buffer->HasOneRef());
+  buffer->AddRef();
+  EXPECT_FALSE(buffer->HasOneRef());
+  buffer->Release();
+  pool->Statistics(stats);
+  EXPECT_EQ(1u, stats.buffersInUse);
+
+  // The buffer outlives the owner's reference to the pool.
+  pool->Release();
+  buffer->SetLength(10);
+  EXPECT_EQ(10u, buffer->Length());
+  buffer->Release();
+}
+
+TEST(PacketBufferPoolTest, LimitsFreeBuffers) {
+  const int kBuffers = 8;
+  PacketBufferPool* pool = PacketBufferPool::Create(100, 2);
+  PacketBuffer* buffers[kBuffers];
+  for (int i = 0; i < kBuffers; ++i) {
+    buffers[i] = pool->Acquire();
+  }
+  for (int i = 0; i < kBuffers; ++i) {
+    buffers[i]->Release();
+  }
+  PacketBufferPoolStatistics stats;
+  pool->Statistics(stats);
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kBuffers), stats.allocations);
+  EXPECT_EQ(0u, stats.buffersInUse);
+  EXPECT_EQ(2u, stats.buffersFree);
+  pool->Release();
+}
@@ -37,6 +37,7 @@
         '../interface/fix_interlocked_exchange_pointer_win.h',
         '../interface/list_wrapper.h',
         '../interface/map_wrapper.h',
+        '../interface/packet_buffer_pool.h',
         '../interface/ref_count.h',
         '../interface/rw_lock_wrapper.h',
         '../interface/scoped_ptr.h',
@@ -83,6 +84,7 @@
         'file_impl.h',
         'list_no_stl.cc',
         'map.cc',
+        'packet_buffer_pool.cc',
         'rw_lock.cc',
         'rw_lock_posix.cc',
         'rw_lock_posix.h',
@@ -100,6 +102,8 @@
         'trace_impl_no_op.cc',
         'trace_posix.cc',
         'trace_posix.h',
+        'trace_ring_buffer.cc',
+        'trace_ring_buffer.h',
         'trace_win.cc',
         'trace_win.h',
       ],
@@ -134,6 +138,8 @@
             'trace_impl.h',
             'trace_posix.cc',
             'trace_posix.h',
+            'trace_ring_buffer.cc',
+            'trace_ring_buffer.h',
             'trace_win.cc',
             'trace_win.h',
           ],
@@ -161,6 +167,8 @@
             'cpu_wrapper_unittest.cc',
             'list_unittest.cc',
             'map_unittest.cc',
+            'packet_buffer_pool_unittest.cc',
+            'trace_unittest.cc',
             'data_log_unittest.cc',
             'data_log_unittest_disabled.cc',
             'data_log_helpers_unittest.cc',
@@ -76,27 +76,11 @@ TraceImpl::TraceImpl()
       _thread(*ThreadWrapper::CreateThread(TraceImpl::Run, this,
                                            kHighestPriority, "Trace")),
       _event(*EventWrapper::Create()),
-      _critsectArray(CriticalSectionWrapper::CreateCriticalSection()),
-      _nextFreeIdx(),
-      _level(),
-      _length(),
-      _messageQueue(),
-      _activeQueue(0)
+      _rings(new TraceRingBuffer[WEBRTC_TRACE_NUM_RINGS]),
+      _writerWaiting(0)
 {
-    _nextFreeIdx[0] = 0;
-    _nextFreeIdx[1] = 0;
-
     unsigned int tid = 0;
     _thread.Start(tid);
-
-    for(int m = 0; m < WEBRTC_TRACE_NUM_ARRAY; m++)
-    {
-        for(int n = 0; n < WEBRTC_TRACE_MAX_QUEUE; n++)
-        {
-            _messageQueue[m][n] = new
-                WebRtc_Word8[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
-        }
-    }
 }
 
 bool TraceImpl::StopThread()
@@ -136,15 +120,7 @@ TraceImpl::~TraceImpl()
     delete &_traceFile;
     delete &_thread;
     delete _critsectInterface;
-    delete _critsectArray;
-
-    for(int m = 0; m < WEBRTC_TRACE_NUM_ARRAY; m++)
-    {
-        for(int n = 0; n < WEBRTC_TRACE_MAX_QUEUE; n++)
-        {
-            delete [] _messageQueue[m][n];
-        }
-    }
+    delete [] _rings;
 }
 
 WebRtc_Word32 TraceImpl::AddLevel(char* szMessage, const TraceLevel level) const
@@ -375,6 +351,8 @@ WebRtc_Word32 TraceImpl::SetTraceFileImpl(const WebRtc_Word8* fileNameUTF8,
         }
     }
     _rowCountText = 0;
+    // Write the messages buffered while there was no output.
+    _event.Set();
     return 0;
 }
 
@@ -389,95 +367,64 @@ WebRtc_Word32 TraceImpl::SetTraceCallbackImpl(TraceCallback* callback)
 {
     CriticalSectionScoped lock(_critsectInterface);
     _callback = callback;
+    // Write the messages buffered while there was no output.
+    _event.Set();
     return 0;
 }
 
-WebRtc_Word32 TraceImpl::AddMessage(
-    char* traceMessage,
-    const char msg[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
-    const WebRtc_UWord16 writtenSoFar) const
-
+WebRtc_Word32 TraceImpl::AddMessage(char* traceMessage,
+                                    const TraceRecord& record,
+                                    const WebRtc_UWord16 writtenSoFar) const
 {
-    int length = 0;
     if(writtenSoFar >= WEBRTC_TRACE_MAX_MESSAGE_SIZE)
     {
         return -1;
     }
-    // - 2 to leave room for newline and NULL termination
-#ifdef _WIN32
-    length = _snprintf(traceMessage,
-                       WEBRTC_TRACE_MAX_MESSAGE_SIZE - writtenSoFar - 2,
-                       "%s",msg);
-    if(length < 0)
-    {
-        length = WEBRTC_TRACE_MAX_MESSAGE_SIZE - writtenSoFar - 2;
-        traceMessage[length] = 0;
-    }
-#else
-    length = snprintf(traceMessage,
-                      WEBRTC_TRACE_MAX_MESSAGE_SIZE-writtenSoFar-2, "%s",msg);
-    if(length < 0 || length > WEBRTC_TRACE_MAX_MESSAGE_SIZE-writtenSoFar - 2)
-    {
-        length = WEBRTC_TRACE_MAX_MESSAGE_SIZE - writtenSoFar - 2;
-        traceMessage[length] = 0;
-    }
-#endif
+    // - 1 to leave room for newline, the null termination is included in the
+    // size.
+    WebRtc_Word32 length = FormatTraceRecord(
+        record, traceMessage, WEBRTC_TRACE_MAX_MESSAGE_SIZE - writtenSoFar - 1);
     // Length with NULL termination.
     return length+1;
 }
 
-void TraceImpl::AddMessageToList(
-    const char traceMessage[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
-    const WebRtc_UWord16 length,
-    const TraceLevel level)
+TraceRecord* TraceImpl::BeginRecord(const TraceLevel level,
+                                    const TraceModule module,
+                                    const WebRtc_Word32 id)
 {
-    CriticalSectionScoped lock(_critsectArray);
-
-    if(_nextFreeIdx[_activeQueue] >= WEBRTC_TRACE_MAX_QUEUE)
+    const WebRtc_UWord64 threadId = ThreadId();
+    // Fibonacci hash of the thread id picks the ring.
+    const WebRtc_UWord32 ring = static_cast<WebRtc_UWord32>(
+        (threadId * 0x9E3779B97F4A7C15ULL) >>
+        (64 - WEBRTC_TRACE_NUM_RINGS_LOG2));
+    TraceRecord* record = _rings[ring].Reserve();
+    if(record == NULL)
     {
-        if( ! _traceFile.Open() &&
-            !_callback)
-        {
-            // Keep at least the last 1/4 of old messages when not logging.
-            // TODO (hellner): isn't this redundant. The user will make it known
-            //                 when to start logging. Why keep messages before
-            //                 that?
-            for(int n = 0; n < WEBRTC_TRACE_MAX_QUEUE/4; n++)
-            {
-                const int lastQuarterOffset = (3*WEBRTC_TRACE_MAX_QUEUE/4);
-                memcpy(_messageQueue[_activeQueue][n],
-                       _messageQueue[_activeQueue][n + lastQuarterOffset],
-                       WEBRTC_TRACE_MAX_MESSAGE_SIZE);
-            }
-            _nextFreeIdx[_activeQueue] = WEBRTC_TRACE_MAX_QUEUE/4;
-        } else {
-            // More messages are being written than there is room for in the
-            // buffer. Drop any new messages.
-            // TODO (hellner): its probably better to drop old messages instead
-            //                 of new ones. One step further: if this happens
-            //                 it's due to writing faster than what can be
-            //                 processed. Maybe modify the filter at this point.
-            //                 E.g. turn of STREAM.
-            return;
-        }
+        // More messages are being written than there is room for in the
+        // buffer. The trace thread reports the number of dropped messages.
+        return NULL;
     }
+    record->level = level;
+    record->module = module;
+    record->id = id;
+    record->threadId = threadId;
+    record->timeMs = Time();
+    record->format = NULL;
+    record->dataLength = 0;
+    return record;
+}
 
-    WebRtc_UWord16 idx = _nextFreeIdx[_activeQueue];
-    _nextFreeIdx[_activeQueue]++;
-
-    _level[_activeQueue][idx] = level;
-    _length[_activeQueue][idx] = length;
-    memcpy(_messageQueue[_activeQueue][idx], traceMessage, length);
-
-    if(_nextFreeIdx[_activeQueue] == WEBRTC_TRACE_MAX_QUEUE-1)
+void TraceImpl::CommitRecord(TraceRecord* record)
+{
+    const bool halfRing = TraceRingBuffer::Commit(record);
+    // Set() takes a lock. Only call it for the first message after the trace
+    // thread has gone idle, or when the thread is writing in batches and the
+    // ring is filling up.
+    if(_writerWaiting.Value() != 0 && _writerWaiting.CompareExchange(0, 1))
     {
-        // Logging more messages than can be worked off. Log a warning.
-        const char warning_msg[] = "WARNING MISSING TRACE MESSAGES\n";
-        _level[_activeQueue][_nextFreeIdx[_activeQueue]] = kTraceWarning;
-        _length[_activeQueue][_nextFreeIdx[_activeQueue]] = strlen(warning_msg);
-        memcpy(_messageQueue[_activeQueue][_nextFreeIdx[_activeQueue]],
-               warning_msg, _length[_activeQueue][idx]);
-        _nextFreeIdx[_activeQueue]++;
+        _event.Set();
+    } else if(halfRing) {
+        _event.Set();
     }
 }
 
@@ -488,172 +435,212 @@ bool TraceImpl::Run(void* obj)
 
 bool TraceImpl::Process()
 {
-    if(_event.Wait(1000) == kEventSignaled)
+    // Reading _traceFile and _callback without the lock is only a hint, it
+    // is checked again when writing.
+    const bool hasOutput = _traceFile.Open() || _callback;
+    bool idle = true;
+    if(hasOutput)
     {
-        if(_traceFile.Open() || _callback)
+        idle = (WriteToFile() == 0);
+        if(idle)
         {
-            // File mode (not calback mode).
-            WriteToFile();
+            // Messages committed after this wake the thread. Messages
+            // committed before it are picked up by the check below.
+            _writerWaiting.CompareExchange(1, 0);
+            if(HasPendingRecords())
+            {
+                _writerWaiting = 0;
+                return true;
+            }
         }
-    } else {
+    }
+    // Without output the messages are kept in the rings until a trace file
+    // or callback is set. While messages keep coming they are written in
+    // batches instead of waking the thread for each message.
+    if(_event.Wait(idle ? 1000 : WEBRTC_TRACE_WRITE_INTERVAL_MS) !=
+       kEventSignaled && idle)
+    {
         _traceFile.Flush();
     }
+    _writerWaiting = 0;
     return true;
 }
 
-void TraceImpl::WriteToFile()
+bool TraceImpl::HasPendingRecords()
 {
-    WebRtc_UWord8 localQueueActive = 0;
-    WebRtc_UWord16 localNextFreeIdx = 0;
-
-    // There are two buffer. One for reading (for writing to file) and one for
-    // writing (for storing new messages). Let new messages be posted to the
-    // unused buffer so that the current buffer can be flushed safely.
-    {
-        CriticalSectionScoped lock(_critsectArray);
-        localNextFreeIdx = _nextFreeIdx[_activeQueue];
-        _nextFreeIdx[_activeQueue] = 0;
-        localQueueActive = _activeQueue;
-        if(_activeQueue == 0)
-        {
-            _activeQueue = 1;
-        } else
+    for(int i = 0; i < WEBRTC_TRACE_NUM_RINGS; i++)
+    {
+        if(_rings[i].Front())
         {
-            _activeQueue = 0;
+            return true;
         }
     }
-    if(localNextFreeIdx == 0)
-    {
-        return;
-    }
+    return false;
+}
 
+WebRtc_UWord32 TraceImpl::WriteToFile()
+{
     CriticalSectionScoped lock(_critsectInterface);
 
-    for(WebRtc_UWord16 idx = 0; idx <localNextFreeIdx; idx++)
+    WebRtc_UWord32 dropped = 0;
+    for(int i = 0; i < WEBRTC_TRACE_NUM_RINGS; i++)
+    {
+        dropped += _rings[i].TakeDropped();
+    }
+    // Write the oldest message first so that messages from different threads
+    // end up in time order.
+    WebRtc_UWord32 written = 0;
+    TraceRecord* front[WEBRTC_TRACE_NUM_RINGS];
+    for(int i = 0; i < WEBRTC_TRACE_NUM_RINGS; i++)
+    {
+        front[i] = _rings[i].Front();
+    }
+    for(;;)
     {
-        TraceLevel localLevel = _level[localQueueActive][idx];
-        if(_callback)
+        int oldest = -1;
+        for(int i = 0; i < WEBRTC_TRACE_NUM_RINGS; i++)
         {
-            _callback->Print(localLevel, _messageQueue[localQueueActive][idx],
-                             _length[localQueueActive][idx]);
+            if(front[i] &&
+               (oldest == -1 || front[i]->timeMs < front[oldest]->timeMs))
+            {
+                oldest = i;
+            }
         }
-        if(_traceFile.Open())
+        if(oldest == -1)
         {
-            if(_rowCountText > WEBRTC_TRACE_MAX_FILE_SIZE)
-            {
-                // wrap file
-                _rowCountText = 0;
-                _traceFile.Flush();
+            break;
+        }
+        WriteRecord(*front[oldest]);
+        _rings[oldest].Pop();
+        written++;
+        front[oldest] = _rings[oldest].Front();
+    }
+    if(dropped > 0)
+    {
+        // Logging more messages than can be worked off. Log a warning.
+        char message[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
+        sprintf(message, "WARNING MISSING TRACE MESSAGES (%lu)\n",
+                static_cast<unsigned long>(dropped));
+        WriteMessage(kTraceWarning, message,
+                     static_cast<WebRtc_UWord16>(strlen(message)));
+    }
+    return written;
+}
 
-                if(_fileCountText == 0)
-                {
-                    _traceFile.Rewind();
-                } else
-                {
-                    WebRtc_Word8 oldFileName[FileWrapper::kMaxFileNameSize];
-                    WebRtc_Word8 newFileName[FileWrapper::kMaxFileNameSize];
+void TraceImpl::WriteRecord(const TraceRecord& record)
+{
+    char traceMessage[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
+    char* meassagePtr = traceMessage;
 
-                    // get current name
-                    _traceFile.FileName(oldFileName,
-                                        FileWrapper::kMaxFileNameSize);
-                    _traceFile.CloseFile();
+    WebRtc_Word32 len = 0;
+    WebRtc_Word32 ackLen = 0;
 
-                    _fileCountText++;
+    len = AddLevel(meassagePtr, record.level);
+    if(len == -1)
+    {
+        return;
+    }
+    meassagePtr += len;
+    ackLen += len;
 
-                    UpdateFileName(oldFileName, newFileName, _fileCountText);
+    len = AddTime(meassagePtr, record.level, record.timeMs);
+    if(len == -1)
+    {
+        return;
+    }
+    meassagePtr += len;
+    ackLen += len;
 
-                    if(_traceFile.OpenFile(newFileName, false, false,
-                                           true) == -1)
-                    {
-                        return;
-                    }
-                }
-            }
-            if(_rowCountText ==  0)
-            {
-                WebRtc_Word8 message[WEBRTC_TRACE_MAX_MESSAGE_SIZE + 1];
-                WebRtc_Word32 length = AddDateTimeInfo(message);
-                if(length != -1)
-                {
-                    message[length] = 0;
-                    message[length-1] = '\n';
-                    _traceFile.Write(message, length);
-                    _rowCountText++;
-                }
-                length = AddBuildInfo(message);
-                if(length != -1)
-                {
-                    message[length+1] = 0;
-                    message[length] = '\n';
-                    message[length-1] = '\n';
-                    _traceFile.Write(message, length+1);
-                    _rowCountText++;
-                    _rowCountText++;
-                }
-            }
-            WebRtc_UWord16 length = _length[localQueueActive][idx];
-            _messageQueue[localQueueActive][idx][length] = 0;
-            _messageQueue[localQueueActive][idx][length-1] = '\n';
-            _traceFile.Write(_messageQueue[localQueueActive][idx], length);
-            _rowCountText++;
-        }
+    len = AddModuleAndId(meassagePtr, record.module, record.id);
+    if(len == -1)
+    {
+        return;
+    }
+    meassagePtr += len;
+    ackLen += len;
+
+    len = AddThreadId(meassagePtr, record.threadId);
+    if(len == -1)
+    {
+        return;
+    }
+    meassagePtr += len;
+    ackLen += len;
+
+    len = AddMessage(meassagePtr, record, (WebRtc_UWord16)ackLen);
+    if(len == -1)
+    {
+        return;
     }
+    ackLen += len;
+    WriteMessage(record.level, traceMessage, (WebRtc_UWord16)ackLen);
 }
 
-void TraceImpl::AddImpl(const TraceLevel level, const TraceModule module,
-                        const WebRtc_Word32 id,
-                        const char msg[WEBRTC_TRACE_MAX_MESSAGE_SIZE])
+void TraceImpl::WriteMessage(const TraceLevel level, char* traceMessage,
+                             const WebRtc_UWord16 length)
 {
-    if (TraceCheck(level))
+    if(_callback)
+    {
+        _callback->Print(level, traceMessage, length);
+    }
+    if(_traceFile.Open())
     {
-        char traceMessage[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
-        char* meassagePtr = traceMessage;
+        if(_rowCountText > WEBRTC_TRACE_MAX_FILE_SIZE)
+        {
+            // wrap file
+            _rowCountText = 0;
+            _traceFile.Flush();
 
-        WebRtc_Word32 len = 0;
-        WebRtc_Word32 ackLen = 0;
+            if(_fileCountText == 0)
+            {
+                _traceFile.Rewind();
+            } else
+            {
+                WebRtc_Word8 oldFileName[FileWrapper::kMaxFileNameSize];
+                WebRtc_Word8 newFileName[FileWrapper::kMaxFileNameSize];
 
-        len = AddLevel(meassagePtr, level);
-        if(len == -1)
-        {
-            return;
-        }
-        meassagePtr += len;
-        ackLen += len;
+                // get current name
+                _traceFile.FileName(oldFileName,
+                                    FileWrapper::kMaxFileNameSize);
+                _traceFile.CloseFile();
 
-        len = AddTime(meassagePtr, level);
-        if(len == -1)
-        {
-            return;
-        }
-        meassagePtr += len;
-        ackLen += len;
+                _fileCountText++;
 
-        len = AddModuleAndId(meassagePtr, module, id);
-        if(len == -1)
-        {
-            return;
-        }
-        meassagePtr += len;
-        ackLen += len;
+                UpdateFileName(oldFileName, newFileName, _fileCountText);
 
-        len = AddThreadId(meassagePtr);
-        if(len == -1)
-        {
-            return;
+                if(_traceFile.OpenFile(newFileName, false, false,
+                                       true) == -1)
+                {
+                    return;
+                }
+            }
         }
-        meassagePtr += len;
-        ackLen += len;
-
-        len = AddMessage(meassagePtr, msg, (WebRtc_UWord16)ackLen);
-        if(len == -1)
+        if(_rowCountText ==  0)
         {
-            return;
+            WebRtc_Word8 message[WEBRTC_TRACE_MAX_MESSAGE_SIZE + 1];
+            WebRtc_Word32 infoLength = AddDateTimeInfo(message);
+            if(infoLength != -1)
+            {
+                message[infoLength] = 0;
+                message[infoLength-1] = '\n';
+                _traceFile.Write(message, infoLength);
+                _rowCountText++;
+            }
+            infoLength = AddBuildInfo(message);
+            if(infoLength != -1)
+            {
+                message[infoLength+1] = 0;
+                message[infoLength] = '\n';
+                message[infoLength-1] = '\n';
+                _traceFile.Write(message, infoLength+1);
+                _rowCountText++;
+                _rowCountText++;
+            }
         }
-        ackLen += len;
-        AddMessageToList(traceMessage,(WebRtc_UWord16)ackLen, level);
-
-        // Make sure that messages are written as soon as possible.
-        _event.Set();
+        traceMessage[length] = 0;
+        traceMessage[length-1] = '\n';
+        _traceFile.Write(traceMessage, length);
+        _rowCountText++;
     }
 }
 
@@ -806,21 +793,36 @@ void Trace::Add(const TraceLevel level, const TraceModule module,
     {
         if(trace->TraceCheck(level))
         {
-            char tempBuff[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
-            char* buff = 0;
-            if(msg)
+            TraceRecord* record = trace->BeginRecord(level, module, id);
+            if(record)
             {
-                va_list args;
-                va_start(args, msg);
+                if(msg)
+                {
+                    // Formatting is left to the trace thread. Conversions
+                    // that can't be deferred are formatted here.
+                    va_list args;
+                    va_start(args, msg);
+                    const bool packed = PackTraceArguments(*record, msg, args);
+                    va_end(args);
+                    if(!packed)
+                    {
+                        char* buff = reinterpret_cast<char*>(record->data);
+                        va_start(args, msg);
 #ifdef _WIN32
-                _vsnprintf(tempBuff,WEBRTC_TRACE_MAX_MESSAGE_SIZE-1,msg,args);
+                        _vsnprintf(buff, WEBRTC_TRACE_MAX_RECORD_DATA-1, msg,
+                                   args);
 #else
-                vsnprintf(tempBuff,WEBRTC_TRACE_MAX_MESSAGE_SIZE-1,msg,args);
+                        vsnprintf(buff, WEBRTC_TRACE_MAX_RECORD_DATA-1, msg,
+                                  args);
 #endif
-                va_end(args);
-                buff = tempBuff;
+                        va_end(args);
+                        buff[WEBRTC_TRACE_MAX_RECORD_DATA-1] = 0;
+                        record->format = NULL;
+                        record->dataLength = WEBRTC_TRACE_MAX_RECORD_DATA;
+                    }
+                }
+                trace->CommitRecord(record);
             }
-            trace->AddImpl(level, module, id, buff);
         }
         ReturnTrace();
     }
@@ -11,30 +11,25 @@
 #ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_IMPL_H_
 #define WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_IMPL_H_
 
+#include "system_wrappers/interface/atomic32_wrapper.h"
 #include "system_wrappers/interface/critical_section_wrapper.h"
 #include "system_wrappers/interface/event_wrapper.h"
 #include "system_wrappers/interface/file_wrapper.h"
 #include "system_wrappers/interface/static_instance.h"
 #include "system_wrappers/interface/trace.h"
 #include "system_wrappers/interface/thread_wrapper.h"
+#include "trace_ring_buffer.h"
 
 namespace webrtc {
 
-// TODO (pwestin) WEBRTC_TRACE_MAX_QUEUE needs to be tweaked
-// TODO (hellner) the buffer should be close to how much the system can write to
-//                file. Increasing the buffer will not solve anything. Sooner or
-//                later the buffer is going to fill up anyways.
-#if defined(MAC_IPHONE)
-    #define WEBRTC_TRACE_MAX_QUEUE  2000
-#else
-    #define WEBRTC_TRACE_MAX_QUEUE  8000
-#endif
-#define WEBRTC_TRACE_NUM_ARRAY 2
 #define WEBRTC_TRACE_MAX_MESSAGE_SIZE 256
-// Total buffer size is WEBRTC_TRACE_NUM_ARRAY (number of buffer partitions) *
-// WEBRTC_TRACE_MAX_QUEUE (number of lines per buffer partition) *
-// WEBRTC_TRACE_MAX_MESSAGE_SIZE (number of 1 byte charachters per line) =
-// 1 or 4 Mbyte
+// Trace calls are spread over WEBRTC_TRACE_NUM_RINGS lock free rings based on
+// the calling thread. Total buffer size is WEBRTC_TRACE_NUM_RINGS *
+// WEBRTC_TRACE_RING_SIZE records of about 300 bytes each = 0.6 or 2.4 Mbyte.
+#define WEBRTC_TRACE_NUM_RINGS_LOG2 6
+#define WEBRTC_TRACE_NUM_RINGS (1 << WEBRTC_TRACE_NUM_RINGS_LOG2)
+// While messages keep coming they are written this often.
+#define WEBRTC_TRACE_WRITE_INTERVAL_MS 10
 
 #define WEBRTC_TRACE_MAX_FILE_SIZE 100*1000
 // Number of rows that may be written to file. On average 110 bytes per row (max
@@ -56,8 +51,11 @@ public:
 
     WebRtc_Word32 SetTraceCallbackImpl(TraceCallback* callback);
 
-    void AddImpl(const TraceLevel level, const TraceModule module,
-                 const WebRtc_Word32 id, const char* msg);
+    // Returns a record for the calling thread to fill in, or NULL if the
+    // thread's ring is full. The record must be passed to CommitRecord().
+    TraceRecord* BeginRecord(const TraceLevel level, const TraceModule module,
+                             const WebRtc_Word32 id);
+    void CommitRecord(TraceRecord* record);
 
     bool StopThread();
 
@@ -70,9 +68,16 @@ protected:
         const TraceLevel level = kTraceAll);
 
     // OS specific implementations
-    virtual WebRtc_Word32 AddThreadId(char* traceMessage) const = 0;
-    virtual WebRtc_Word32 AddTime(char* traceMessage,
-                                  const TraceLevel level) const = 0;
+    // Called on the thread adding a message.
+    virtual WebRtc_UWord64 ThreadId() const = 0;
+    // Returns the current time in milliseconds.
+    virtual WebRtc_Word64 Time() const = 0;
+
+    // Called by the trace thread when the message is written.
+    virtual WebRtc_Word32 AddThreadId(char* traceMessage,
+                                      const WebRtc_UWord64 threadId) const = 0;
+    virtual WebRtc_Word32 AddTime(char* traceMessage, const TraceLevel level,
+                                  const WebRtc_Word64 timeMs) const = 0;
 
     virtual WebRtc_Word32 AddBuildInfo(char* traceMessage) const = 0;
     virtual WebRtc_Word32 AddDateTimeInfo(char* traceMessage) const = 0;
@@ -88,15 +93,9 @@ private:
     WebRtc_Word32 AddModuleAndId(char* traceMessage, const TraceModule module,
                                  const WebRtc_Word32 id) const;
 
-    WebRtc_Word32 AddMessage(char* traceMessage,
-                             const char msg[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
+    WebRtc_Word32 AddMessage(char* traceMessage, const TraceRecord& record,
                              const WebRtc_UWord16 writtenSoFar) const;
 
-    void AddMessageToList(
-        const char traceMessage[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
-        const WebRtc_UWord16 length,
-        const TraceLevel level);
-
     bool UpdateFileName(
         const WebRtc_Word8 fileNameUTF8[FileWrapper::kMaxFileNameSize],
         WebRtc_Word8 fileNameWithCounterUTF8[FileWrapper::kMaxFileNameSize],
@@ -107,7 +106,12 @@ private:
         WebRtc_Word8 fileNameWithCounterUTF8[FileWrapper::kMaxFileNameSize],
         const WebRtc_UWord32 newCount) const;
 
-    void WriteToFile();
+    // Returns the number of messages written.
+    WebRtc_UWord32 WriteToFile();
+    void WriteRecord(const TraceRecord& record);
+    void WriteMessage(const TraceLevel level, char* traceMessage,
+                      const WebRtc_UWord16 length);
+    bool HasPendingRecords();
 
     CriticalSectionWrapper* _critsectInterface;
     TraceCallback* _callback;
@@ -118,13 +122,10 @@ private:
     ThreadWrapper& _thread;
     EventWrapper& _event;
 
-    // _critsectArray protects _activeQueue
-    CriticalSectionWrapper* _critsectArray;
-    WebRtc_UWord16 _nextFreeIdx[WEBRTC_TRACE_NUM_ARRAY];
-    TraceLevel _level[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-    WebRtc_UWord16 _length[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-    WebRtc_Word8* _messageQueue[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-    WebRtc_UWord8 _activeQueue;
+    TraceRingBuffer* _rings;
+    // Set by the trace thread before it waits for new messages. The first
+    // message committed after that clears it and wakes the thread.
+    Atomic32Wrapper _writerWaiting;
 };
 } // namespace webrtc
 
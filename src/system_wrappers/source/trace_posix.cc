@@ -14,6 +14,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/time.h>
 #include <time.h>
 
 #ifdef WEBRTC_ANDROID
@@ -39,7 +40,7 @@
 namespace webrtc {
 TracePosix::TracePosix()
 {
-    _prevAPITickCount = time(NULL);
+    _prevAPITickCount = static_cast<WebRtc_UWord32>(Time());
     _prevTickCount = _prevAPITickCount;
 }
 
@@ -48,26 +49,40 @@ TracePosix::~TracePosix()
     StopThread();
 }
 
-WebRtc_Word32 TracePosix::AddThreadId(char* traceMessage) const
+WebRtc_UWord64 TracePosix::ThreadId() const
+{
+    return (WebRtc_UWord64)pthread_self();
+}
+
+WebRtc_Word64 TracePosix::Time() const
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<WebRtc_Word64>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+WebRtc_Word32 TracePosix::AddThreadId(char* traceMessage,
+                                      const WebRtc_UWord64 threadId) const
 {
-    WebRtc_UWord64 threadId = (WebRtc_UWord64)pthread_self();
     sprintf(traceMessage, "%10llu; ",
             static_cast<long long unsigned int>(threadId));
     // 12 bytes are written.
     return 12;
 }
 
-WebRtc_Word32 TracePosix::AddTime(char* traceMessage,
-                                  const TraceLevel level) const
+WebRtc_Word32 TracePosix::AddTime(char* traceMessage, const TraceLevel level,
+                                  const WebRtc_Word64 timeMs) const
 {
-    time_t dwCurrentTimeInSeconds = time(NULL);
+    time_t dwCurrentTimeInSeconds = static_cast<time_t>(timeMs / 1000);
     struct tm systemTime;
     gmtime_r(&dwCurrentTimeInSeconds, &systemTime);
+    const WebRtc_UWord32 dwCurrentTime = static_cast<WebRtc_UWord32>(timeMs);
+    const unsigned int milliseconds = static_cast<unsigned int>(timeMs % 1000);
 
     if(level == kTraceApiCall)
     {
-        WebRtc_UWord32 dwDeltaTime = dwCurrentTimeInSeconds - _prevTickCount;
-        _prevTickCount = dwCurrentTimeInSeconds;
+        WebRtc_UWord32 dwDeltaTime = dwCurrentTime - _prevTickCount;
+        _prevTickCount = dwCurrentTime;
 
         if(_prevTickCount == 0)
         {
@@ -84,11 +99,11 @@ WebRtc_Word32 TracePosix::AddTime(char* traceMessage,
         }
 
         sprintf(traceMessage, "(%2u:%2u:%2u:%3u |%5lu) ", systemTime.tm_hour,
-                systemTime.tm_min, systemTime.tm_sec, 0,
+                systemTime.tm_min, systemTime.tm_sec, milliseconds,
                 static_cast<unsigned long>(dwDeltaTime));
     } else {
-        WebRtc_UWord32 dwDeltaTime = dwCurrentTimeInSeconds - _prevAPITickCount;
-        _prevAPITickCount = dwCurrentTimeInSeconds;
+        WebRtc_UWord32 dwDeltaTime = dwCurrentTime - _prevAPITickCount;
+        _prevAPITickCount = dwCurrentTime;
         if(_prevAPITickCount == 0)
         {
             dwDeltaTime = 0;
@@ -103,7 +118,7 @@ WebRtc_Word32 TracePosix::AddTime(char* traceMessage,
             dwDeltaTime = 99999;
         }
         sprintf(traceMessage, "(%2u:%2u:%2u:%3u |%5lu) ", systemTime.tm_hour,
-                systemTime.tm_min, systemTime.tm_sec, 0,
+                systemTime.tm_min, systemTime.tm_sec, milliseconds,
                 static_cast<unsigned long>(dwDeltaTime));
     }
     // Messages is 22 characters.
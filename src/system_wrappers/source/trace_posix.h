@@ -21,9 +21,13 @@ public:
     TracePosix();
     virtual ~TracePosix();
 
-    virtual WebRtc_Word32 AddThreadId(char *traceMessage) const;
-    virtual WebRtc_Word32 AddTime(char* traceMessage,
-                                  const TraceLevel level) const;
+    virtual WebRtc_UWord64 ThreadId() const;
+    virtual WebRtc_Word64 Time() const;
+
+    virtual WebRtc_Word32 AddThreadId(char *traceMessage,
+                                      const WebRtc_UWord64 threadId) const;
+    virtual WebRtc_Word32 AddTime(char* traceMessage, const TraceLevel level,
+                                  const WebRtc_Word64 timeMs) const;
 
     virtual WebRtc_Word32 AddBuildInfo(char* traceMessage) const;
     virtual WebRtc_Word32 AddDateTimeInfo(char* traceMessage) const;
@@ -0,0 +1,594 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "trace_ring_buffer.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #define snprintf _snprintf
+#endif
+
+namespace webrtc {
+namespace {
+enum ArgumentType
+{
+    kArgumentNone,  // "%%"
+    kArgumentInt,
+    kArgumentLong,
+    kArgumentLongLong,
+    kArgumentSize,
+    kArgumentPtrDiff,
+    kArgumentDouble,
+    kArgumentPointer,
+    kArgumentString
+};
+
+enum LengthModifier
+{
+    kModifierNone,
+    kModifierShort,
+    kModifierLong,
+    kModifierLongLong,
+    kModifierLongDouble,
+    kModifierSize,
+    kModifierPtrDiff
+};
+
+// Longest conversion specification that can be deferred, e.g. "%-+#020.8llx".
+const int kMaxSpecLength = 32;
+
+struct ConversionSpec
+{
+    // Number of characters in the specification, including the '%'.
+    int length;
+    // The width and precision are given as '*' arguments.
+    bool widthArgument;
+    bool precisionArgument;
+    // Precision given in the format string, -1 if none.
+    int precision;
+    ArgumentType type;
+};
+
+// Parses the conversion specification starting at format, which points to a
+// '%'. Returns false if the conversion can't be deferred, e.g. "%n", "%ls" or
+// "%Lf".
+bool ParseConversion(const char* format, ConversionSpec& spec)
+{
+    const char* p = format + 1;
+    spec.widthArgument = false;
+    spec.precisionArgument = false;
+    spec.precision = -1;
+
+    while(*p != '\0' && strchr("-+ #0'", *p))
+    {
+        p++;
+    }
+    if(*p == '*')
+    {
+        spec.widthArgument = true;
+        p++;
+    } else {
+        while(*p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+    if(*p == '.')
+    {
+        p++;
+        if(*p == '*')
+        {
+            spec.precisionArgument = true;
+            p++;
+        } else {
+            spec.precision = 0;
+            while(*p >= '0' && *p <= '9')
+            {
+                spec.precision = spec.precision * 10 + (*p - '0');
+                p++;
+            }
+        }
+    }
+
+    LengthModifier modifier = kModifierNone;
+    switch(*p)
+    {
+        case 'h':
+            p++;
+            if(*p == 'h')
+            {
+                p++;
+            }
+            modifier = kModifierShort;
+            break;
+        case 'l':
+            p++;
+            if(*p == 'l')
+            {
+                p++;
+                modifier = kModifierLongLong;
+            } else {
+                modifier = kModifierLong;
+            }
+            break;
+        case 'q':
+            p++;
+            modifier = kModifierLongLong;
+            break;
+        case 'L':
+            p++;
+            modifier = kModifierLongDouble;
+            break;
+        case 'z':
+            p++;
+            modifier = kModifierSize;
+            break;
+        case 't':
+            p++;
+            modifier = kModifierPtrDiff;
+            break;
+        case 'I':
+            // Microsoft extensions: I64, I32 and I (pointer sized).
+            if(p[1] == '6' && p[2] == '4')
+            {
+                p += 3;
+                modifier = kModifierLongLong;
+            } else if(p[1] == '3' && p[2] == '2') {
+                p += 3;
+            } else {
+                p++;
+                modifier = kModifierSize;
+            }
+            break;
+        default:
+            break;
+    }
+
+    const char conversion = *p;
+    spec.length = static_cast<int>(p - format) + 1;
+    if(conversion == '\0' || spec.length > kMaxSpecLength)
+    {
+        return false;
+    }
+    switch(conversion)
+    {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            switch(modifier)
+            {
+                case kModifierNone:
+                case kModifierShort:
+                    spec.type = kArgumentInt;
+                    return true;
+                case kModifierLong:
+                    spec.type = kArgumentLong;
+                    return true;
+                case kModifierLongLong:
+                    spec.type = kArgumentLongLong;
+                    return true;
+                case kModifierSize:
+                    spec.type = kArgumentSize;
+                    return true;
+                case kModifierPtrDiff:
+                    spec.type = kArgumentPtrDiff;
+                    return true;
+                default:
+                    return false;
+            }
+        case 'c':
+            spec.type = kArgumentInt;
+            return modifier == kModifierNone;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec.type = kArgumentDouble;
+            return modifier == kModifierNone || modifier == kModifierLong;
+        case 'p':
+            spec.type = kArgumentPointer;
+            return modifier == kModifierNone;
+        case 's':
+            spec.type = kArgumentString;
+            return modifier == kModifierNone;
+        case '%':
+            spec.type = kArgumentNone;
+            return spec.length == 2;
+        default:
+            return false;
+    }
+}
+
+bool Append(TraceRecord& record, const void* value, WebRtc_UWord32 size)
+{
+    if(record.dataLength + size > WEBRTC_TRACE_MAX_RECORD_DATA)
+    {
+        return false;
+    }
+    memcpy(record.data + record.dataLength, value, size);
+    record.dataLength += static_cast<WebRtc_UWord16>(size);
+    return true;
+}
+
+void Read(const TraceRecord& record, WebRtc_UWord32& offset, void* value,
+          WebRtc_UWord32 size)
+{
+    memcpy(value, record.data + offset, size);
+    offset += size;
+}
+
+template <typename T>
+int FormatArgument(char* message, WebRtc_UWord32 size, const char* conversion,
+                   const ConversionSpec& spec, int width, int precision,
+                   T value)
+{
+    if(spec.widthArgument && spec.precisionArgument)
+    {
+        return snprintf(message, size, conversion, width, precision, value);
+    }
+    if(spec.widthArgument)
+    {
+        return snprintf(message, size, conversion, width, value);
+    }
+    if(spec.precisionArgument)
+    {
+        return snprintf(message, size, conversion, precision, value);
+    }
+    return snprintf(message, size, conversion, value);
+}
+} // namespace
+
+bool PackTraceArguments(TraceRecord& record, const char* format,
+                        va_list args)
+{
+    record.format = format;
+    record.dataLength = 0;
+    for(const char* p = format; *p != '\0'; p++)
+    {
+        if(*p != '%')
+        {
+            continue;
+        }
+        ConversionSpec spec;
+        if(!ParseConversion(p, spec))
+        {
+            return false;
+        }
+        p += spec.length - 1;
+
+        int precision = spec.precision;
+        if(spec.widthArgument)
+        {
+            int width = va_arg(args, int);
+            if(!Append(record, &width, sizeof(width)))
+            {
+                return false;
+            }
+        }
+        if(spec.precisionArgument)
+        {
+            precision = va_arg(args, int);
+            if(!Append(record, &precision, sizeof(precision)))
+            {
+                return false;
+            }
+        }
+
+        bool fits = true;
+        switch(spec.type)
+        {
+            case kArgumentNone:
+                break;
+            case kArgumentInt:
+            {
+                int value = va_arg(args, int);
+                fits = Append(record, &value, sizeof(value));
+                break;
+            }
+            case kArgumentLong:
+            {
+                long value = va_arg(args, long);
+                fits = Append(record, &value, sizeof(value));
+                break;
+            }
+            case kArgumentLongLong:
+            {
+                long long value = va_arg(args, long long);
+                fits = Append(record, &value, sizeof(value));
+                break;
+            }
+            case kArgumentSize:
+            {
+                size_t value = va_arg(args, size_t);
+                fits = Append(record, &value, sizeof(value));
+                break;
+            }
+            case kArgumentPtrDiff:
+            {
+                ptrdiff_t value = va_arg(args, ptrdiff_t);
+                fits = Append(record, &value, sizeof(value));
+                break;
+            }
+            case kArgumentDouble:
+            {
+                double value = va_arg(args, double);
+                fits = Append(record, &value, sizeof(value));
+                break;
+            }
+            case kArgumentPointer:
+            {
+                void* value = va_arg(args, void*);
+                fits = Append(record, &value, sizeof(value));
+                break;
+            }
+            case kArgumentString:
+            {
+                // The string may be gone by the time the record is
+                // formatted, copy it. Honor the precision since the string
+                // doesn't have to be null terminated in that case.
+                const char* value = va_arg(args, const char*);
+                if(value == NULL)
+                {
+                    value = "(null)";
+                }
+                WebRtc_UWord32 length = 0;
+                while((precision < 0 ||
+                       length < static_cast<WebRtc_UWord32>(precision)) &&
+                      value[length] != '\0')
+                {
+                    length++;
+                }
+                const char termination = '\0';
+                fits = Append(record, value, length) &&
+                       Append(record, &termination, 1);
+                break;
+            }
+        }
+        if(!fits)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+WebRtc_Word32 FormatTraceRecord(const TraceRecord& record, char* message,
+                                WebRtc_UWord32 size)
+{
+    if(size == 0)
+    {
+        return 0;
+    }
+    WebRtc_UWord32 written = 0;
+    if(record.format == NULL)
+    {
+        // Formatted by the caller.
+        while(written + 1 < size && written < record.dataLength &&
+              record.data[written] != '\0')
+        {
+            message[written] = record.data[written];
+            written++;
+        }
+        message[written] = '\0';
+        return written;
+    }
+
+    WebRtc_UWord32 offset = 0;
+    const char* p = record.format;
+    while(*p != '\0' && written + 1 < size)
+    {
+        if(*p != '%')
+        {
+            message[written++] = *p++;
+            continue;
+        }
+        ConversionSpec spec;
+        if(!ParseConversion(p, spec))
+        {
+            // Can't happen, the record was packed from the same format.
+            break;
+        }
+        char conversion[kMaxSpecLength + 1];
+        memcpy(conversion, p, spec.length);
+        conversion[spec.length] = '\0';
+        p += spec.length;
+
+        int width = 0;
+        int precision = 0;
+        if(spec.widthArgument)
+        {
+            Read(record, offset, &width, sizeof(width));
+        }
+        if(spec.precisionArgument)
+        {
+            Read(record, offset, &precision, sizeof(precision));
+        }
+
+        char* out = message + written;
+        const WebRtc_UWord32 remaining = size - written;
+        int length = 0;
+        switch(spec.type)
+        {
+            case kArgumentNone:
+                *out = '%';
+                length = 1;
+                break;
+            case kArgumentInt:
+            {
+                int value;
+                Read(record, offset, &value, sizeof(value));
+                length = FormatArgument(out, remaining, conversion, spec,
+                                        width, precision, value);
+                break;
+            }
+            case kArgumentLong:
+            {
+                long value;
+                Read(record, offset, &value, sizeof(value));
+                length = FormatArgument(out, remaining, conversion, spec,
+                                        width, precision, value);
+                break;
+            }
+            case kArgumentLongLong:
+            {
+                long long value;
+                Read(record, offset, &value, sizeof(value));
+                length = FormatArgument(out, remaining, conversion, spec,
+                                        width, precision, value);
+                break;
+            }
+            case kArgumentSize:
+            {
+                size_t value;
+                Read(record, offset, &value, sizeof(value));
+                length = FormatArgument(out, remaining, conversion, spec,
+                                        width, precision, value);
+                break;
+            }
+            case kArgumentPtrDiff:
+            {
+                ptrdiff_t value;
+                Read(record, offset, &value, sizeof(value));
+                length = FormatArgument(out, remaining, conversion, spec,
+                                        width, precision, value);
+                break;
+            }
+            case kArgumentDouble:
+            {
+                double value;
+                Read(record, offset, &value, sizeof(value));
+                length = FormatArgument(out, remaining, conversion, spec,
+                                        width, precision, value);
+                break;
+            }
+            case kArgumentPointer:
+            {
+                void* value;
+                Read(record, offset, &value, sizeof(value));
+                length = FormatArgument(out, remaining, conversion, spec,
+                                        width, precision, value);
+                break;
+            }
+            case kArgumentString:
+            {
+                const char* value =
+                    reinterpret_cast<const char*>(record.data + offset);
+                offset += static_cast<WebRtc_UWord32>(strlen(value)) + 1;
+                length = FormatArgument(out, remaining, conversion, spec,
+                                        width, precision, value);
+                break;
+            }
+        }
+        if(length < 0 || static_cast<WebRtc_UWord32>(length) >= remaining)
+        {
+            // Truncated.
+            written = size - 1;
+            break;
+        }
+        written += length;
+    }
+    message[written] = '\0';
+    return written;
+}
+
+TraceRingBuffer::TraceRingBuffer()
+    : _records(new TraceRecord[WEBRTC_TRACE_RING_SIZE]),
+      _tail(0),
+      _head(0),
+      _dropped(0)
+{
+    for(WebRtc_Word32 i = 0; i < WEBRTC_TRACE_RING_SIZE; i++)
+    {
+        _records[i].sequence = i;
+    }
+}
+
+TraceRingBuffer::~TraceRingBuffer()
+{
+    delete [] _records;
+}
+
+// A record at position n in the ring is free when its sequence is n, filled
+// in when its sequence is n + 1 and free for position n + RING_SIZE once the
+// consumer is done with it.
+TraceRecord* TraceRingBuffer::Reserve()
+{
+    WebRtc_UWord32 position = static_cast<WebRtc_UWord32>(_tail.Value());
+    for(;;)
+    {
+        TraceRecord* record =
+            &_records[position & (WEBRTC_TRACE_RING_SIZE - 1)];
+        const WebRtc_Word32 diff = static_cast<WebRtc_Word32>(
+            static_cast<WebRtc_UWord32>(record->sequence.Value()) - position);
+        if(diff == 0)
+        {
+            if(_tail.CompareExchange(static_cast<WebRtc_Word32>(position + 1),
+                                     static_cast<WebRtc_Word32>(position)))
+            {
+                return record;
+            }
+        } else if(diff < 0) {
+            // The consumer hasn't released this record yet.
+            ++_dropped;
+            return NULL;
+        }
+        // Another producer took the position.
+        position = static_cast<WebRtc_UWord32>(_tail.Value());
+    }
+}
+
+bool TraceRingBuffer::Commit(TraceRecord* record)
+{
+    const WebRtc_UWord32 position =
+        static_cast<WebRtc_UWord32>(++record->sequence) - 1;
+    return (position & (WEBRTC_TRACE_RING_SIZE / 2 - 1)) == 0;
+}
+
+TraceRecord* TraceRingBuffer::Front()
+{
+    TraceRecord* record = &_records[_head & (WEBRTC_TRACE_RING_SIZE - 1)];
+    // Adding zero reads the sequence with a full memory barrier, so the
+    // contents of the record are read after it has been committed.
+    const WebRtc_UWord32 sequence =
+        static_cast<WebRtc_UWord32>(record->sequence += 0);
+    if(sequence != _head + 1)
+    {
+        return NULL;
+    }
+    return record;
+}
+
+void TraceRingBuffer::Pop()
+{
+    TraceRecord* record = &_records[_head & (WEBRTC_TRACE_RING_SIZE - 1)];
+    record->sequence += WEBRTC_TRACE_RING_SIZE - 1;
+    _head++;
+}
+
+WebRtc_UWord32 TraceRingBuffer::TakeDropped()
+{
+    const WebRtc_Word32 dropped = _dropped.Value();
+    if(dropped != 0)
+    {
+        _dropped -= dropped;
+    }
+    return static_cast<WebRtc_UWord32>(dropped);
+}
+} // namespace webrtc
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Lock free storage of trace messages that have not been formatted yet.
+// A trace call stores the format string and its raw arguments in a
+// TraceRecord. The trace thread formats the record when it is written.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_RING_BUFFER_H_
+#define WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_RING_BUFFER_H_
+
+#include <stdarg.h>
+
+#include "system_wrappers/interface/atomic32_wrapper.h"
+#include "common_types.h"
+#include "typedefs.h"
+
+namespace webrtc {
+
+// Number of records in each ring. Must be a power of two.
+#if defined(MAC_IPHONE)
+    #define WEBRTC_TRACE_RING_SIZE 32
+#else
+    #define WEBRTC_TRACE_RING_SIZE 128
+#endif
+#define WEBRTC_TRACE_MAX_RECORD_DATA 256
+
+struct TraceRecord
+{
+    // Position of the record in its ring. Owned by TraceRingBuffer.
+    Atomic32Wrapper sequence;
+
+    TraceLevel level;
+    TraceModule module;
+    WebRtc_Word32 id;
+    WebRtc_UWord64 threadId;
+    WebRtc_Word64 timeMs;
+
+    // The format string passed to Trace::Add(). Must outlive the trace. If
+    // NULL, data holds the already formatted message.
+    const char* format;
+    // The arguments of format, packed back to back. Strings are copied.
+    WebRtc_UWord16 dataLength;
+    WebRtc_UWord8 data[WEBRTC_TRACE_MAX_RECORD_DATA];
+};
+
+// Stores the arguments of format in record. Returns false if format uses a
+// conversion that can't be deferred or the arguments don't fit.
+bool PackTraceArguments(TraceRecord& record, const char* format,
+                        va_list args);
+
+// Formats record into message the way vsnprintf() would have formatted
+// record.format with the original arguments. Returns the number of
+// characters written, not counting the null termination.
+WebRtc_Word32 FormatTraceRecord(const TraceRecord& record, char* message,
+                                WebRtc_UWord32 size);
+
+// Bounded multiple producer, single consumer queue of TraceRecords.
+class TraceRingBuffer
+{
+public:
+    TraceRingBuffer();
+    ~TraceRingBuffer();
+
+    // Called by any thread. Returns a record to fill in, or NULL if the ring
+    // is full. Dropped messages are counted.
+    TraceRecord* Reserve();
+    // Makes a reserved record visible to the consumer. Returns true for
+    // every half ring so that a consumer that is busy or batching can be
+    // woken before the ring fills up.
+    static bool Commit(TraceRecord* record);
+
+    // Called by the consumer only. Returns the oldest record, or NULL if the
+    // ring is empty or the oldest record hasn't been committed yet.
+    TraceRecord* Front();
+    // Releases the record returned by Front().
+    void Pop();
+    // Returns the number of messages dropped since the last call.
+    WebRtc_UWord32 TakeDropped();
+
+private:
+    TraceRecord* _records;
+    Atomic32Wrapper _tail;
+    WebRtc_UWord32 _head;
+    Atomic32Wrapper _dropped;
+};
+} // namespace webrtc
+
+#endif // WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_RING_BUFFER_H_
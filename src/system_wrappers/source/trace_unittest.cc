@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "system_wrappers/interface/atomic32_wrapper.h"
+#include "system_wrappers/interface/critical_section_wrapper.h"
+#include "system_wrappers/interface/event_wrapper.h"
+#include "system_wrappers/interface/scoped_ptr.h"
+#include "system_wrappers/interface/thread_wrapper.h"
+#include "system_wrappers/interface/tick_util.h"
+#include "system_wrappers/interface/trace.h"
+
+using ::webrtc::Atomic32Wrapper;
+using ::webrtc::CriticalSectionScoped;
+using ::webrtc::CriticalSectionWrapper;
+using ::webrtc::EventWrapper;
+using ::webrtc::ThreadWrapper;
+using ::webrtc::TickTime;
+using ::webrtc::Trace;
+using ::webrtc::scoped_ptr;
+
+namespace {
+
+const char kMissingMessages[] = "WARNING MISSING TRACE MESSAGES (";
+// Only the messages of this module are collected, the trace itself and the
+// threads it uses trace too.
+const char kTestModule[] = "RTP/RTCP:";
+
+// Collects the messages written by the trace thread.
+class TraceCollector : public webrtc::TraceCallback
+{
+public:
+    TraceCollector()
+        : _crit(CriticalSectionWrapper::CreateCriticalSection()),
+          _event(EventWrapper::Create()),
+          _keepMessages(true),
+          _received(0),
+          _dropped(0)
+    {
+    }
+
+    virtual void Print(const webrtc::TraceLevel /*level*/,
+                       const char* traceString,
+                       const int /*length*/)
+    {
+        CriticalSectionScoped lock(_crit.get());
+        const char* missing = strstr(traceString, kMissingMessages);
+        if(missing)
+        {
+            _dropped += atoi(missing + strlen(kMissingMessages));
+        } else if(strstr(traceString, kTestModule)) {
+            _received++;
+            if(_keepMessages)
+            {
+                _messages.push_back(traceString);
+            }
+        }
+        _event->Set();
+    }
+
+    void SetKeepMessages(bool keep)
+    {
+        CriticalSectionScoped lock(_crit.get());
+        _keepMessages = keep;
+    }
+
+    // Waits until count messages have been received or dropped.
+    bool WaitFor(int count)
+    {
+        for(int i = 0; i < 50; i++)
+        {
+            if(Received() + Dropped() >= count)
+            {
+                return true;
+            }
+            _event->Wait(100);
+        }
+        return false;
+    }
+
+    int Received() const
+    {
+        CriticalSectionScoped lock(_crit.get());
+        return _received;
+    }
+    int Dropped() const
+    {
+        CriticalSectionScoped lock(_crit.get());
+        return _dropped;
+    }
+    std::string Message(int i) const
+    {
+        CriticalSectionScoped lock(_crit.get());
+        return _messages[i];
+    }
+
+private:
+    scoped_ptr<CriticalSectionWrapper> _crit;
+    scoped_ptr<EventWrapper> _event;
+    bool _keepMessages;
+    int _received;
+    int _dropped;
+    std::vector<std::string> _messages;
+};
+
+class TraceTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        Trace::CreateTrace();
+        Trace::LevelFilter(_oldFilter);
+        Trace::SetLevelFilter(webrtc::kTraceAll);
+        ASSERT_EQ(0, Trace::SetTraceCallback(&_collector));
+    }
+    virtual void TearDown()
+    {
+        Trace::SetTraceCallback(NULL);
+        Trace::SetLevelFilter(_oldFilter);
+        Trace::ReturnTrace();
+    }
+
+    // Returns true if message ends with the text vsnprintf() gives for
+    // format.
+    static bool EndsWithFormatted(const std::string& message,
+                                  const char* expected)
+    {
+        const size_t length = strlen(expected);
+        return message.size() >= length &&
+               message.compare(message.size() - length, length,
+                               expected) == 0;
+    }
+
+    WebRtc_UWord32 _oldFilter;
+    TraceCollector _collector;
+};
+
+const int kNumberOfThreads = 32;
+const int kTracesPerThread = 20000;
+
+struct BenchmarkThread
+{
+    Atomic32Wrapper* start;
+    int threadIndex;
+    WebRtc_Word64 elapsedUs;
+};
+
+bool RunBenchmarkThread(void* obj)
+{
+    BenchmarkThread* thread = static_cast<BenchmarkThread*>(obj);
+    scoped_ptr<EventWrapper> sleep(EventWrapper::Create());
+    while(thread->start->Value() == 0)
+    {
+        sleep->Wait(1);
+    }
+    const TickTime startTime = TickTime::Now();
+    for(int i = 0; i < kTracesPerThread; i++)
+    {
+        WEBRTC_TRACE(webrtc::kTraceStream, webrtc::kTraceRtpRtcp,
+                     thread->threadIndex,
+                     "incoming packet seq:%u ts:%u len:%d from %s", i,
+                     i * 160, 172, "127.0.0.1");
+    }
+    thread->elapsedUs = (TickTime::Now() - startTime).Microseconds();
+    return false;
+}
+
+}  // namespace
+
+TEST_F(TraceTest, DeferredFormattingMatchesPrintf) {
+  char expected[256];
+  const char* text = "abcdef";
+
+  WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceRtpRtcp, 1,
+               "int:%d unsigned:%u hex:%08x long:%ld", -42, 42u, 0xbeef,
+               123456789L);
+  WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceRtpRtcp, 1,
+               "long long:%lld char:%c percent:%% float:%5.2f exp:%e", -1LL,
+               'x', 3.14159, 1e10);
+  WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceRtpRtcp, 1,
+               "string:%s width:%-8s| precision:%.3s star:%*.*s|", text,
+               text, text, 6, 2, text);
+  // "%n" can't be deferred and the string is formatted by the caller.
+  int written = 0;
+  WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceRtpRtcp, 1,
+               "fallback:%d%n", 7, &written);
+  // Arguments that don't fit in a record are formatted by the caller too.
+  const std::string longText(200, 'z');
+  WEBRTC_TRACE(webrtc::kTraceInfo, webrtc::kTraceRtpRtcp, 1,
+               "long:%s", longText.c_str());
+
+  ASSERT_TRUE(_collector.WaitFor(5));
+  ASSERT_EQ(5, _collector.Received());
+
+  snprintf(expected, sizeof(expected), "int:%d unsigned:%u hex:%08x long:%ld",
+           -42, 42u, 0xbeef, 123456789L);
+  EXPECT_TRUE(EndsWithFormatted(_collector.Message(0), expected))
+      << _collector.Message(0);
+  snprintf(expected, sizeof(expected),
+           "long long:%lld char:%c percent:%% float:%5.2f exp:%e", -1LL, 'x',
+           3.14159, 1e10);
+  EXPECT_TRUE(EndsWithFormatted(_collector.Message(1), expected))
+      << _collector.Message(1);
+  snprintf(expected, sizeof(expected),
+           "string:%s width:%-8s| precision:%.3s star:%*.*s|", text, text,
+           text, 6, 2, text);
+  EXPECT_TRUE(EndsWithFormatted(_collector.Message(2), expected))
+      << _collector.Message(2);
+  EXPECT_TRUE(EndsWithFormatted(_collector.Message(3), "fallback:7"))
+      << _collector.Message(3);
+  EXPECT_NE(std::string::npos, _collector.Message(4).find("long:zzzz"));
+}
+
+// Measures the cost of a trace call with many threads tracing at once.
+TEST_F(TraceTest, ThirtyTwoThreadsBenchmark) {
+  _collector.SetKeepMessages(false);
+  Atomic32Wrapper start(0);
+  BenchmarkThread threads[kNumberOfThreads];
+  ThreadWrapper* threadWrappers[kNumberOfThreads];
+  for (int i = 0; i < kNumberOfThreads; i++) {
+    threads[i].start = &start;
+    threads[i].threadIndex = i;
+    threads[i].elapsedUs = 0;
+    threadWrappers[i] = ThreadWrapper::CreateThread(
+        RunBenchmarkThread, &threads[i], webrtc::kNormalPriority,
+        "TraceBenchmark");
+    unsigned int id = 0;
+    ASSERT_TRUE(threadWrappers[i]->Start(id));
+  }
+  start = 1;
+  WebRtc_Word64 totalUs = 0;
+  for (int i = 0; i < kNumberOfThreads; i++) {
+    EXPECT_TRUE(threadWrappers[i]->Stop());
+    delete threadWrappers[i];
+    totalUs += threads[i].elapsedUs;
+  }
+
+  const int expected = kNumberOfThreads * kTracesPerThread;
+  EXPECT_TRUE(_collector.WaitFor(expected));
+  printf("%d threads: %.0f ns per trace call, %d written, %d dropped\n",
+         kNumberOfThreads, 1000.0 * totalUs / expected,
+         _collector.Received(), _collector.Dropped());
+  // Every message is either written or reported as dropped. The dropped
+  // count may include messages from other modules.
+  EXPECT_LE(_collector.Received(), expected);
+  EXPECT_GE(_collector.Received() + _collector.Dropped(), expected);
+}
@@ -41,20 +41,42 @@ TraceWindows::~TraceWindows()
     StopThread();
 }
 
-WebRtc_Word32 TraceWindows::AddThreadId(char* traceMessage) const
+WebRtc_UWord64 TraceWindows::ThreadId() const
 {
-    WebRtc_UWord32 threadId= GetCurrentThreadId();
-    sprintf (traceMessage, "%10u; ", threadId);
+    return GetCurrentThreadId();
+}
+
+WebRtc_Word64 TraceWindows::Time() const
+{
+    // Milliseconds since January 1, 1601 (UTC).
+    FILETIME fileTime;
+    GetSystemTimeAsFileTime(&fileTime);
+    ULARGE_INTEGER time;
+    time.LowPart = fileTime.dwLowDateTime;
+    time.HighPart = fileTime.dwHighDateTime;
+    return static_cast<WebRtc_Word64>(time.QuadPart / 10000);
+}
+
+WebRtc_Word32 TraceWindows::AddThreadId(char* traceMessage,
+                                        const WebRtc_UWord64 threadId) const
+{
+    sprintf (traceMessage, "%10u; ", static_cast<WebRtc_UWord32>(threadId));
     // Messages is 12 characters.
     return 12;
 }
 
 WebRtc_Word32 TraceWindows::AddTime(char* traceMessage,
-                                    const TraceLevel level) const
+                                    const TraceLevel level,
+                                    const WebRtc_Word64 timeMs) const
 {
-    WebRtc_UWord32 dwCurrentTime = timeGetTime();
+    WebRtc_UWord32 dwCurrentTime = static_cast<WebRtc_UWord32>(timeMs);
+    ULARGE_INTEGER time;
+    time.QuadPart = static_cast<ULONGLONG>(timeMs) * 10000;
+    FILETIME fileTime;
+    fileTime.dwLowDateTime = time.LowPart;
+    fileTime.dwHighDateTime = time.HighPart;
     SYSTEMTIME systemTime;
-    GetSystemTime(&systemTime);
+    FileTimeToSystemTime(&fileTime, &systemTime);
 
     if(level == kTraceApiCall)
     {
@@ -113,7 +135,7 @@ WebRtc_Word32 TraceWindows::AddBuildInfo(char* traceMessage) const
 
 WebRtc_Word32 TraceWindows::AddDateTimeInfo(char* traceMessage) const
 {
-    _prevAPITickCount = timeGetTime();
+    _prevAPITickCount = static_cast<WebRtc_UWord32>(Time());
     _prevTickCount = _prevAPITickCount;
 
     SYSTEMTIME sysTime;
@@ -45,6 +45,7 @@ LOCAL_SRC_FILES := \
     vie_renderer.cc \
     vie_render_manager.cc \
     vie_sender.cc \
+    vie_shared_frame.cc \
     vie_sync_module.cc
 
 # Flags passed to both C and C++ files.
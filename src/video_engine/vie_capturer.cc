@@ -611,6 +611,10 @@ void ViECapturer::DeliverI420Frame(VideoFrame& video_frame) {
                               video_frame.TimeStamp(), video_frame.Width(),
                               video_frame.Height());
   }
+  // Set the RTP timestamp the encoders send the frame with before it's shared
+  // with them, since writing it later would copy the frame.
+  video_frame.SetTimeStamp(
+      90 * static_cast<WebRtc_UWord32>(video_frame.RenderTimeMs()));
   // Deliver the captured frame to all observers (channels, renderer or file).
   ViEFrameProviderBase::DeliverFrame(video_frame);
 }
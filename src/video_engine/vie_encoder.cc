@@ -382,12 +382,12 @@ RtpRtcp* ViEEncoder::SendRtpRtcpModule() {
   return &default_rtp_rtcp_;
 }
 
-void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& video_frame,
+void ViEEncoder::DeliverFrame(int id, ViESharedFrame& shared_frame,
                               int num_csrcs,
                               const WebRtc_UWord32 CSRC[kRtpCsrcSize]) {
   WEBRTC_TRACE(webrtc::kTraceStream, webrtc::kTraceVideo,
                ViEId(engine_id_, channel_id_), "%s: %llu", __FUNCTION__,
-               video_frame.TimeStamp());
+               shared_frame.Frame().TimeStamp());
 
   {
     CriticalSectionScoped cs(data_critsect_);
@@ -400,24 +400,35 @@ void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& video_frame,
       WEBRTC_TRACE(webrtc::kTraceStream, webrtc::kTraceVideo,
                    ViEId(engine_id_, channel_id_),
                    "%s: Dropping frame %llu after a key fame", __FUNCTION__,
-                   video_frame.TimeStamp());
+                   shared_frame.Frame().TimeStamp());
       drop_next_frame_ = false;
       return;
     }
   }
 
-  // Convert render time, in ms, to RTP timestamp.
+  // Convert render time, in ms, to RTP timestamp. ViECapturer and
+  // ViEFilePlayer set it before sharing the frame; the other callbacks must
+  // not see the change, so the frame is only written if the timestamp differs.
   const WebRtc_UWord32 time_stamp =
-      90 * static_cast<WebRtc_UWord32>(video_frame.RenderTimeMs());
-  video_frame.SetTimeStamp(time_stamp);
+      90 * static_cast<WebRtc_UWord32>(shared_frame.Frame().RenderTimeMs());
+  if (shared_frame.Frame().TimeStamp() != time_stamp) {
+    shared_frame.MutableFrame().SetTimeStamp(time_stamp);
+  }
   {
     CriticalSectionScoped cs(callback_critsect_);
     if (effect_filter_) {
-      effect_filter_->Transform(video_frame.Length(), video_frame.Buffer(),
-                                video_frame.TimeStamp(),
-                                video_frame.Width(), video_frame.Height());
+      VideoFrame& filtered_frame = shared_frame.MutableFrame();
+      effect_filter_->Transform(filtered_frame.Length(),
+                                filtered_frame.Buffer(),
+                                filtered_frame.TimeStamp(),
+                                filtered_frame.Width(),
+                                filtered_frame.Height());
     }
   }
+  // The frame may still be shared with other callbacks, so it is only read
+  // from here on.
+  const VideoFrame& video_frame = shared_frame.Frame();
+
   // Record raw frame.
   file_recorder_.RecordVideoFrame(video_frame);
 
@@ -469,11 +480,12 @@ void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& video_frame,
     content_metrics = vpm_.ContentMetrics();
 
     // Frame was not re-sampled => use original.
-    if (decimated_frame == NULL)  {
-      decimated_frame = &video_frame;
+    const VideoFrame* frame_to_encode = decimated_frame;
+    if (frame_to_encode == NULL)  {
+      frame_to_encode = &video_frame;
     }
 
-    if (vcm_.AddVideoFrame(*decimated_frame, content_metrics,
+    if (vcm_.AddVideoFrame(*frame_to_encode, content_metrics,
                            &codec_specific_info) != VCM_OK) {
       WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideo,
                    ViEId(engine_id_, channel_id_),
@@ -499,10 +511,11 @@ void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& video_frame,
   }
 
   // Frame was not sampled => use original.
-  if (decimated_frame == NULL)  {
-    decimated_frame = &video_frame;
+  const VideoFrame* frame_to_encode = decimated_frame;
+  if (frame_to_encode == NULL)  {
+    frame_to_encode = &video_frame;
   }
-  if (vcm_.AddVideoFrame(*decimated_frame) != VCM_OK) {
+  if (vcm_.AddVideoFrame(*frame_to_encode) != VCM_OK) {
     WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideo,
                  ViEId(engine_id_, channel_id_), "%s: Error encoding frame %u",
                  __FUNCTION__, video_frame.TimeStamp());
@@ -71,7 +71,7 @@ class ViEEncoder
 
   // Implementing ViEFrameCallback.
   virtual void DeliverFrame(int id,
-                            VideoFrame& video_frame,
+                            ViESharedFrame& video_frame,
                             int num_csrcs = 0,
                             const WebRtc_UWord32 CSRC[kRtpCsrcSize] = NULL);
   virtual void DelayChanged(int id, int frame_delay);
@@ -978,14 +978,14 @@ unsigned int max_wait_time) {
   return false;
 }
 
-void ViECaptureSnapshot::DeliverFrame(int id, VideoFrame& video_frame,
+void ViECaptureSnapshot::DeliverFrame(int id, ViESharedFrame& video_frame,
                                       int num_csrcs,
 const WebRtc_UWord32 CSRC[kRtpCsrcSize]) {
   CriticalSectionScoped cs(crit_);
   if (!video_frame_) {
     return;
   }
-  video_frame_->SwapFrame(video_frame);
+  video_frame_->SwapFrame(video_frame.MutableFrame());
   condition_varaible_.WakeAll();
   return;
 }
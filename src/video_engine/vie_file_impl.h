@@ -30,7 +30,8 @@ class ViECaptureSnapshot : public ViEFrameCallback {
   bool GetSnapshot(VideoFrame& video_frame, unsigned int max_wait_time);
 
   // Implements ViEFrameCallback.
-  virtual void DeliverFrame(int id, VideoFrame& video_frame, int num_csrcs = 0,
+  virtual void DeliverFrame(int id, ViESharedFrame& video_frame,
+                            int num_csrcs = 0,
                             const WebRtc_UWord32 CSRC[kRtpCsrcSize] = NULL);
   virtual void DelayChanged(int id, int frame_delay) {}
   virtual int GetPreferedFrameSettings(int& width, int& height,
@@ -38,6 +39,7 @@ class ViECaptureSnapshot : public ViEFrameCallback {
     return -1;
   }
   virtual void ProviderDestroyed(int id) {}
+  virtual bool ModifiesFrame() { return true; }
 
  private:
   CriticalSectionWrapper& crit_;
@@ -225,6 +225,9 @@ bool ViEFilePlayer::FilePlayDecodeProcess() {
                                        audio_delay);
         }
       }
+      // Set the RTP timestamp for encoders before the frame is shared.
+      decoded_video_.SetTimeStamp(
+          90 * static_cast<WebRtc_UWord32>(decoded_video_.RenderTimeMs()));
       DeliverFrame(decoded_video_);
       decoded_video_.SetLength(0);
     }
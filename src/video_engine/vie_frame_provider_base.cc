@@ -14,6 +14,7 @@
 #include "system_wrappers/interface/tick_util.h"
 #include "system_wrappers/interface/trace.h"
 #include "video_engine/vie_defines.h"
+#include "video_engine/vie_performance_monitor.h"
 
 namespace webrtc {
 
@@ -22,7 +23,6 @@ ViEFrameProviderBase::ViEFrameProviderBase(int Id, int engine_id)
       engine_id_(engine_id),
       frame_callbacks_(),
       provider_crit_sect_(*CriticalSectionWrapper::CreateCriticalSection()),
-      extra_frame_(NULL),
       frame_delay_(0) {
 }
 
@@ -41,7 +41,6 @@ ViEFrameProviderBase::~ViEFrameProviderBase() {
   }
 
   delete &provider_crit_sect_;
-  delete extra_frame_;
 }
 
 int ViEFrameProviderBase::Id() {
@@ -57,32 +56,41 @@ void ViEFrameProviderBase::DeliverFrame(
 #endif
   CriticalSectionScoped cs(provider_crit_sect_);
 
-  // Deliver the frame to all registered callbacks.
+  // Deliver the frame to all registered callbacks. The image is shared
+  // instead of copied for each callback: all callbacks but the last get an
+  // extra reference, so a callback modifying the frame gets a private copy
+  // and leaves it untouched for the others. The last callback gets the only
+  // reference and may modify or take over the frame without any copy.
+  // Callbacks that always modify the frame, e.g. a renderer, are served
+  // last.
   if (frame_callbacks_.Size() > 0) {
-    if (frame_callbacks_.Size() == 1) {
-      // We don't have to copy the frame.
-      ViEFrameCallback* frame_observer =
-          static_cast<ViEFrameCallback*>(frame_callbacks_.First()->GetItem());
-      frame_observer->DeliverFrame(id_, video_frame, num_csrcs, CSRC);
-    } else {
-      // Make a copy of the frame for all callbacks.
+    shared_frame_.Attach(video_frame);
+    ViEFrameCallback* pending_observer = NULL;
+    for (int modifying = 0; modifying < 2; ++modifying) {
       for (MapItem* map_item = frame_callbacks_.First(); map_item != NULL;
            map_item = frame_callbacks_.Next(map_item)) {
-        if (extra_frame_ == NULL) {
-          extra_frame_ = new VideoFrame();
+        ViEFrameCallback* frame_observer =
+            static_cast<ViEFrameCallback*>(map_item->GetItem());
+        if (frame_observer == NULL ||
+            frame_observer->ModifiesFrame() != (modifying == 1)) {
+          continue;
         }
-        if (map_item != NULL) {
-          ViEFrameCallback* frame_observer =
-              static_cast<ViEFrameCallback*>(map_item->GetItem());
-          if (frame_observer != NULL) {
-            // We must copy the frame each time since the previous receiver
-            // might swap it to avoid a copy.
-            extra_frame_->CopyFrame(video_frame);
-            frame_observer->DeliverFrame(id_, *extra_frame_, num_csrcs, CSRC);
-          }
+        // Deliver to the previous callback now that we know it isn't last.
+        if (pending_observer != NULL) {
+          ViEPerformanceMonitor::FrameDelivered();
+          ViESharedFrame frame_reference(shared_frame_);
+          pending_observer->DeliverFrame(id_, frame_reference, num_csrcs,
+                                         CSRC);
         }
+        pending_observer = frame_observer;
       }
     }
+    if (pending_observer != NULL) {
+      ViEPerformanceMonitor::FrameDelivered();
+      pending_observer->DeliverFrame(id_, shared_frame_, num_csrcs, CSRC);
+    }
+    // Hand the frame back to the caller, as it is after the last callback.
+    shared_frame_.Detach(video_frame);
   }
 #ifdef DEBUG_
   const int process_time =
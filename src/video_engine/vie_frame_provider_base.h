@@ -14,6 +14,7 @@
 #include "modules/interface/module_common_types.h"
 #include "system_wrappers/interface/map_wrapper.h"
 #include "typedefs.h"
+#include "video_engine/vie_shared_frame.h"
 
 namespace webrtc {
 
@@ -24,8 +25,11 @@ class VideoEncoder;
 // frame provider.
 class ViEFrameCallback {
  public:
+  // |video_frame| may be shared with the other callbacks of the provider.
+  // Callbacks that modify the frame, or swap out its buffer, must do so
+  // through ViESharedFrame::MutableFrame().
   virtual void DeliverFrame(int id,
-                            VideoFrame& video_frame,
+                            ViESharedFrame& video_frame,
                             int num_csrcs = 0,
                             const WebRtc_UWord32 CSRC[kRtpCsrcSize] = NULL) = 0;
 
@@ -42,6 +46,11 @@ class ViEFrameCallback {
   // must not be any more calls to the frame provider after this.
   virtual void ProviderDestroyed(int id) = 0;
 
+  // Returns true if the callback modifies every frame or takes over its
+  // buffer. Such callbacks get the frame after the others, so that the last
+  // of them can do so without a copy.
+  virtual bool ModifiesFrame() { return false; }
+
   virtual ~ViEFrameCallback() {}
 };
 
@@ -89,7 +98,8 @@ class ViEFrameProviderBase {
   CriticalSectionWrapper& provider_crit_sect_;
 
  private:
-  VideoFrame* extra_frame_;
+  // Holds the frame being delivered; reused between frames.
+  ViESharedFrame shared_frame_;
   int frame_delay_;
 };
 
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video_engine/vie_frame_provider_base.h"
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "modules/video_render/main/interface/video_render.h"
+#include "system_wrappers/interface/tick_util.h"
+#include "video_engine/vie_performance_monitor.h"
+#include "video_engine/vie_render_manager.h"
+#include "video_engine/vie_renderer.h"
+#include "video_engine/vie_shared_frame.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kEngineId = 0;
+const int kProviderId = 0;
+const int kRenderId = 1;
+const int kWidth = 16;
+const int kHeight = 8;
+const int kFrameLength = kWidth * kHeight * 3 / 2;
+
+class TestFrameProvider : public ViEFrameProviderBase {
+ public:
+  TestFrameProvider() : ViEFrameProviderBase(kProviderId, kEngineId) {}
+
+  virtual int FrameCallbackChanged() { return 0; }
+
+  using ViEFrameProviderBase::DeliverFrame;
+};
+
+// Reads every frame like ViEEncoder does when no effect filter is
+// registered: the RTP timestamp set by the capturer is used as is.
+class FrameReader : public ViEFrameCallback {
+ public:
+  FrameReader() : frames_(0), last_time_stamp_(0), last_first_byte_(0) {}
+
+  virtual void DeliverFrame(int id, ViESharedFrame& video_frame,
+                            int num_csrcs,
+                            const WebRtc_UWord32 CSRC[kRtpCsrcSize]) {
+    const VideoFrame& frame = video_frame.Frame();
+    ++frames_;
+    last_time_stamp_ = frame.TimeStamp();
+    last_first_byte_ = frame.Buffer()[0];
+  }
+  virtual void DelayChanged(int id, int frame_delay) {}
+  virtual int GetPreferedFrameSettings(int& width, int& height,
+                                       int& frame_rate) {
+    return -1;
+  }
+  virtual void ProviderDestroyed(int id) {}
+
+  int frames_;
+  WebRtc_UWord32 last_time_stamp_;
+  WebRtc_UWord8 last_first_byte_;
+};
+
+}  // namespace
+
+class ViEFrameProviderBaseTest : public ::testing::Test {
+ protected:
+  ViEFrameProviderBaseTest()
+      : render_module_(NULL),
+        render_manager_(kEngineId),
+        renderer_(NULL),
+        delivered_at_start_(0),
+        copies_at_start_(0) {
+  }
+
+  virtual void SetUp() {
+    render_module_ = VideoRender::CreateVideoRender(kEngineId, NULL, false,
+                                                    kRenderExternal);
+    ASSERT_TRUE(render_module_ != NULL);
+    renderer_ = ViERenderer::CreateViERenderer(kRenderId, kEngineId,
+                                               *render_module_,
+                                               render_manager_, 0, 0.0f,
+                                               0.0f, 1.0f, 1.0f);
+    ASSERT_TRUE(renderer_ != NULL);
+    ASSERT_EQ(0, renderer_->StartRender());
+    ViEPerformanceMonitor::GetFrameCopyStatistics(delivered_at_start_,
+                                                  copies_at_start_);
+  }
+
+  virtual void TearDown() {
+    provider_.DeregisterFrameCallback(renderer_);
+    provider_.DeregisterFrameCallback(&encoder_);
+    if (renderer_ != NULL) {
+      renderer_->StopRender();
+      delete renderer_;
+    }
+    if (render_module_ != NULL) {
+      VideoRender::DestroyVideoRender(render_module_);
+    }
+  }
+
+  // A captured frame, as ViECapturer delivers it.
+  static void MakeFrame(int index, VideoFrame& frame) {
+    WebRtc_UWord8 image[kFrameLength];
+    memset(image, index, sizeof(image));
+    frame.CopyFrame(kFrameLength, image);
+    frame.SetWidth(kWidth);
+    frame.SetHeight(kHeight);
+    frame.SetRenderTime(TickTime::MillisecondTimestamp());
+    frame.SetTimeStamp(
+        90 * static_cast<WebRtc_UWord32>(frame.RenderTimeMs()));
+  }
+
+  void GetStatisticsSinceStart(int& delivered, int& copies) const {
+    ViEPerformanceMonitor::GetFrameCopyStatistics(delivered, copies);
+    delivered -= delivered_at_start_;
+    copies -= copies_at_start_;
+  }
+
+  TestFrameProvider provider_;
+  VideoRender* render_module_;
+  ViERenderManager render_manager_;
+  ViERenderer* renderer_;
+  FrameReader encoder_;
+  int delivered_at_start_;
+  int copies_at_start_;
+};
+
+TEST_F(ViEFrameProviderBaseTest, EncoderAndRendererShareFrameWithoutCopy) {
+  // The renderer is registered first, but takes over the buffer; it must
+  // get the frame after the encoder.
+  ASSERT_EQ(0, provider_.RegisterFrameCallback(0, renderer_));
+  ASSERT_EQ(0, provider_.RegisterFrameCallback(1, &encoder_));
+
+  const int kNumFrames = 5;
+  for (int i = 0; i < kNumFrames; i++) {
+    VideoFrame frame;
+    MakeFrame(i + 1, frame);
+    const WebRtc_UWord32 time_stamp = frame.TimeStamp();
+    provider_.DeliverFrame(frame);
+
+    EXPECT_EQ(i + 1, encoder_.frames_);
+    EXPECT_EQ(time_stamp, encoder_.last_time_stamp_);
+    EXPECT_EQ(i + 1, encoder_.last_first_byte_);
+    // The render module swapped its own, empty, buffer in.
+    EXPECT_EQ(0u, frame.Length());
+  }
+
+  int delivered = 0;
+  int copies = 0;
+  GetStatisticsSinceStart(delivered, copies);
+  EXPECT_EQ(2 * kNumFrames, delivered);
+  EXPECT_EQ(0, copies);
+}
+
+}  // namespace webrtc
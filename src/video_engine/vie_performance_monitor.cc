@@ -10,6 +10,7 @@
 
 #include "vie_performance_monitor.h"
 
+#include "atomic32_wrapper.h"
 #include "cpu_wrapper.h"
 #include "critical_section_wrapper.h"
 #include "event_wrapper.h"
@@ -24,6 +25,9 @@ namespace webrtc {
 enum { kVieMonitorPeriodMs = 975 };
 enum { kVieCpuStartValue = 75 };
 
+static Atomic32Wrapper g_frames_delivered;
+static Atomic32Wrapper g_frames_copied;
+
 ViEPerformanceMonitor::ViEPerformanceMonitor(int engine_id)
     : engine_id_(engine_id),
       pointer_critsect_(*CriticalSectionWrapper::CreateCriticalSection()),
@@ -115,6 +119,20 @@ bool ViEPerformanceMonitor::ViEBaseObserverRegistered() {
   return vie_base_observer_ != NULL;
 }
 
+void ViEPerformanceMonitor::FrameDelivered() {
+  ++g_frames_delivered;
+}
+
+void ViEPerformanceMonitor::FrameCopied() {
+  ++g_frames_copied;
+}
+
+void ViEPerformanceMonitor::GetFrameCopyStatistics(int& frames_delivered,
+                                                   int& frames_copied) {
+  frames_delivered = g_frames_delivered.Value();
+  frames_copied = g_frames_copied.Value();
+}
+
 bool ViEPerformanceMonitor::ViEMonitorThreadFunction(void* obj) {
   return static_cast<ViEPerformanceMonitor*>(obj)->ViEMonitorProcess();
 }
@@ -34,6 +34,14 @@ class ViEPerformanceMonitor {
   void Terminate();
   bool ViEBaseObserverRegistered();
 
+  // Frame delivery statistics, counted over all frame providers in the
+  // process. Providers report every frame handed to a frame callback and
+  // every image copy it took; copies are only needed when a frame is shared
+  // and a callback modifies it.
+  static void FrameDelivered();
+  static void FrameCopied();
+  static void GetFrameCopyStatistics(int& frames_delivered, int& frames_copied);
+
  protected:
   static bool ViEMonitorThreadFunction(void* obj);
   bool ViEMonitorProcess();
@@ -11,6 +11,7 @@
 #include "vie_receiver.h"
 
 #include "critical_section_wrapper.h"
+#include "packet_buffer_pool.h"
 #include "rtp_dump.h"
 #include "rtp_rtcp.h"
 #include "video_coding.h"
@@ -29,6 +30,7 @@ ViEReceiver::ViEReceiver(int engine_id, int channel_id,
       external_decryption_(NULL),
       decryption_buffer_(NULL),
       rtp_dump_(NULL),
+      packet_buffer_(NULL),
       receiving_(false) {
 }
 
@@ -87,6 +89,19 @@ void ViEReceiver::IncomingRTPPacket(const WebRtc_Word8* rtp_packet,
   InsertRTPPacket(rtp_packet, rtp_packet_length);
 }
 
+void ViEReceiver::IncomingRTPPacketBuffer(PacketBuffer* rtp_packet,
+                                          const WebRtc_Word8* from_ip,
+                                          const WebRtc_UWord16 from_port) {
+  {
+    CriticalSectionScoped cs(receive_critsect_);
+    packet_buffer_ = rtp_packet;
+  }
+  InsertRTPPacket(reinterpret_cast<const WebRtc_Word8*>(rtp_packet->Data()),
+                  rtp_packet->Length());
+  CriticalSectionScoped cs(receive_critsect_);
+  packet_buffer_ = NULL;
+}
+
 void ViEReceiver::IncomingRTCPPacket(const WebRtc_Word8* rtcp_packet,
                                      const WebRtc_Word32 rtcp_packet_length,
                                      const WebRtc_Word8* from_ip,
@@ -118,7 +133,25 @@ WebRtc_Word32 ViEReceiver::OnReceivedPayloadData(
     return 0;
   }
 
-  if (vcm_.IncomingPacket(payload_data, payload_size, *rtp_header) != 0) {
+  // Let VCM keep the payload in the received packet if it wasn't decrypted
+  // or otherwise moved by the RTP module.
+  PacketBuffer* buffer = NULL;
+  {
+    CriticalSectionScoped cs(receive_critsect_);
+    if (packet_buffer_ != NULL &&
+        payload_data >= packet_buffer_->Data() &&
+        payload_data + payload_size <=
+            packet_buffer_->Data() + packet_buffer_->Length()) {
+      buffer = packet_buffer_;
+      buffer->AddRef();
+    }
+  }
+  WebRtc_Word32 ret = vcm_.IncomingPacket(payload_data, payload_size,
+                                          *rtp_header, buffer);
+  if (buffer != NULL) {
+    buffer->Release();
+  }
+  if (ret != 0) {
     // Check this...
     return -1;
   }
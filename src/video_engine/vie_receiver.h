@@ -23,6 +23,7 @@ namespace webrtc {
 
 class CriticalSectionWrapper;
 class Encryption;
+class PacketBuffer;
 class RtpDump;
 class RtpRtcp;
 class VideoCodingModule;
@@ -49,6 +50,9 @@ class ViEReceiver : public UdpTransportData, public RtpData {
                                  const WebRtc_Word32 rtp_packet_length,
                                  const WebRtc_Word8* from_ip,
                                  const WebRtc_UWord16 from_port);
+  virtual void IncomingRTPPacketBuffer(PacketBuffer* rtp_packet,
+                                       const WebRtc_Word8* from_ip,
+                                       const WebRtc_UWord16 from_port);
   virtual void IncomingRTCPPacket(const WebRtc_Word8* rtcp_packet,
                                   const WebRtc_Word32 rtcp_packet_length,
                                   const WebRtc_Word8* from_ip,
@@ -78,6 +82,8 @@ class ViEReceiver : public UdpTransportData, public RtpData {
   Encryption* external_decryption_;
   WebRtc_UWord8* decryption_buffer_;
   RtpDump* rtp_dump_;
+  // The buffer of the packet being inserted by IncomingRTPPacketBuffer().
+  PacketBuffer* packet_buffer_;
   bool receiving_;
 };
 
@@ -127,10 +127,10 @@ WebRtc_Word32 ViERenderer::Init(const WebRtc_UWord32 z_order,
 }
 
 void ViERenderer::DeliverFrame(int id,
-                               VideoFrame& video_frame,
+                               ViESharedFrame& video_frame,
                                int num_csrcs,
                                const WebRtc_UWord32 CSRC[kRtpCsrcSize]) {
-  render_callback_->RenderFrame(render_id_, video_frame);
+  render_callback_->RenderFrame(render_id_, video_frame.MutableFrame());
 }
 
 void ViERenderer::DelayChanged(int id, int frame_delay) {}
@@ -93,7 +93,7 @@ class ViERenderer: public ViEFrameCallback {
 
   // Implement ViEFrameCallback
   virtual void DeliverFrame(int id,
-                            VideoFrame& video_frame,
+                            ViESharedFrame& video_frame,
                             int num_csrcs = 0,
                             const WebRtc_UWord32 CSRC[kRtpCsrcSize] = NULL);
   virtual void DelayChanged(int id, int frame_delay);
@@ -101,6 +101,8 @@ class ViERenderer: public ViEFrameCallback {
                                        int& height,
                                        int& frame_rate);
   virtual void ProviderDestroyed(int id);
+  // The render module takes over the buffer of every frame.
+  virtual bool ModifiesFrame() { return true; }
 
   WebRtc_UWord32 render_id_;
   WebRtc_Word32 engine_id_;
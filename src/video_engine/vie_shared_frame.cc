@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video_engine/vie_shared_frame.h"
+
+#include "system_wrappers/interface/atomic32_wrapper.h"
+#include "video_engine/vie_performance_monitor.h"
+
+namespace webrtc {
+
+class ViESharedFrame::Buffer {
+ public:
+  Buffer() : ref_count_(1) {}
+
+  void AddRef() {
+    ++ref_count_;
+  }
+
+  // Deletes the buffer when the last reference is released.
+  void Release() {
+    if (--ref_count_ == 0) {
+      delete this;
+    }
+  }
+
+  bool HasOneRef() const {
+    return ref_count_.Value() == 1;
+  }
+
+  VideoFrame frame;
+
+ private:
+  ~Buffer() {}
+
+  Atomic32Wrapper ref_count_;
+};
+
+ViESharedFrame::ViESharedFrame()
+    : buffer_(new Buffer()) {
+}
+
+ViESharedFrame::ViESharedFrame(const ViESharedFrame& other)
+    : buffer_(other.buffer_) {
+  buffer_->AddRef();
+}
+
+ViESharedFrame::~ViESharedFrame() {
+  buffer_->Release();
+}
+
+ViESharedFrame& ViESharedFrame::operator=(const ViESharedFrame& other) {
+  other.buffer_->AddRef();
+  buffer_->Release();
+  buffer_ = other.buffer_;
+  return *this;
+}
+
+void ViESharedFrame::Attach(VideoFrame& video_frame) {
+  Reset();
+  buffer_->frame.SwapFrame(video_frame);
+}
+
+void ViESharedFrame::Detach(VideoFrame& video_frame) {
+  if (buffer_->HasOneRef()) {
+    video_frame.SwapFrame(buffer_->frame);
+  } else {
+    video_frame.CopyFrame(buffer_->frame);
+    ViEPerformanceMonitor::FrameCopied();
+  }
+  Reset();
+}
+
+const VideoFrame& ViESharedFrame::Frame() const {
+  return buffer_->frame;
+}
+
+VideoFrame& ViESharedFrame::MutableFrame() {
+  if (!buffer_->HasOneRef()) {
+    Buffer* copy = new Buffer();
+    copy->frame.CopyFrame(buffer_->frame);
+    ViEPerformanceMonitor::FrameCopied();
+    buffer_->Release();
+    buffer_ = copy;
+  }
+  return buffer_->frame;
+}
+
+bool ViESharedFrame::IsShared() const {
+  return !buffer_->HasOneRef();
+}
+
+void ViESharedFrame::Reset() {
+  // Drop the current frame and start over with an empty, unshared one.
+  if (buffer_->HasOneRef()) {
+    buffer_->frame.SetLength(0);
+    return;
+  }
+  buffer_->Release();
+  buffer_ = new Buffer();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// ViESharedFrame is a reference to a video frame that can be shared between
+// several frame callbacks without copying the image. Copies of a
+// ViESharedFrame refer to the same reference counted frame. Reading is free;
+// the frame is copied on the first write through a reference that isn't the
+// only one.
+
+#ifndef WEBRTC_VIDEO_ENGINE_VIE_SHARED_FRAME_H_
+#define WEBRTC_VIDEO_ENGINE_VIE_SHARED_FRAME_H_
+
+#include "modules/interface/module_common_types.h"
+#include "typedefs.h"
+
+namespace webrtc {
+
+class ViESharedFrame {
+ public:
+  ViESharedFrame();
+  ViESharedFrame(const ViESharedFrame& other);
+  ~ViESharedFrame();
+
+  ViESharedFrame& operator=(const ViESharedFrame& other);
+
+  // Takes over the buffer of |video_frame| without copying it. Any frame
+  // referenced before is released.
+  void Attach(VideoFrame& video_frame);
+
+  // Swaps the frame back into |video_frame| and releases the reference. The
+  // image is only copied if other references to the frame remain.
+  void Detach(VideoFrame& video_frame);
+
+  const VideoFrame& Frame() const;
+
+  // Returns the frame for modification, e.g. for an in-place filter or to
+  // swap out its buffer. If the frame is shared with other references, this
+  // reference is first given a private copy.
+  VideoFrame& MutableFrame();
+
+  // True if other references to the frame exist.
+  bool IsShared() const;
+
+ private:
+  class Buffer;
+
+  void Reset();
+
+  Buffer* buffer_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_VIE_SHARED_FRAME_H_
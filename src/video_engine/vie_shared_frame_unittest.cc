@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video_engine/vie_shared_frame.h"
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "video_engine/vie_performance_monitor.h"
+
+namespace webrtc {
+
+class ViESharedFrameTest : public ::testing::Test {
+ protected:
+  enum { kFrameLength = 64 };
+
+  virtual void SetUp() {
+    for (int i = 0; i < kFrameLength; i++) {
+      image_[i] = static_cast<WebRtc_UWord8>(i);
+    }
+    frame_.CopyFrame(kFrameLength, image_);
+    frame_.SetTimeStamp(1234);
+    ViEPerformanceMonitor::GetFrameCopyStatistics(delivered_at_start_,
+                                                  copies_at_start_);
+  }
+
+  int CopiesSinceStart() const {
+    int delivered = 0;
+    int copies = 0;
+    ViEPerformanceMonitor::GetFrameCopyStatistics(delivered, copies);
+    return copies - copies_at_start_;
+  }
+
+  WebRtc_UWord8 image_[kFrameLength];
+  VideoFrame frame_;
+  int delivered_at_start_;
+  int copies_at_start_;
+};
+
+TEST_F(ViESharedFrameTest, AttachTakesOverBufferWithoutCopy) {
+  const WebRtc_UWord8* buffer = frame_.Buffer();
+  ViESharedFrame shared;
+  shared.Attach(frame_);
+  EXPECT_EQ(buffer, shared.Frame().Buffer());
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kFrameLength),
+            shared.Frame().Length());
+  EXPECT_EQ(1234u, shared.Frame().TimeStamp());
+  EXPECT_EQ(0u, frame_.Length());
+  EXPECT_FALSE(shared.IsShared());
+  EXPECT_EQ(0, CopiesSinceStart());
+}
+
+TEST_F(ViESharedFrameTest, CopiesShareTheFrame) {
+  ViESharedFrame shared;
+  shared.Attach(frame_);
+  {
+    ViESharedFrame reference(shared);
+    EXPECT_TRUE(shared.IsShared());
+    EXPECT_TRUE(reference.IsShared());
+    EXPECT_EQ(shared.Frame().Buffer(), reference.Frame().Buffer());
+
+    ViESharedFrame assigned;
+    assigned = reference;
+    EXPECT_EQ(shared.Frame().Buffer(), assigned.Frame().Buffer());
+  }
+  EXPECT_FALSE(shared.IsShared());
+  EXPECT_EQ(0, CopiesSinceStart());
+}
+
+TEST_F(ViESharedFrameTest, MutableFrameCopiesOnlyWhenShared) {
+  ViESharedFrame shared;
+  shared.Attach(frame_);
+  const WebRtc_UWord8* buffer = shared.Frame().Buffer();
+
+  // The only reference is written in place.
+  EXPECT_EQ(buffer, shared.MutableFrame().Buffer());
+  EXPECT_EQ(0, CopiesSinceStart());
+
+  ViESharedFrame reference(shared);
+  VideoFrame& mutable_frame = reference.MutableFrame();
+  EXPECT_EQ(1, CopiesSinceStart());
+  EXPECT_NE(buffer, mutable_frame.Buffer());
+  EXPECT_FALSE(shared.IsShared());
+  EXPECT_FALSE(reference.IsShared());
+
+  // Writing to the copy leaves the original untouched.
+  mutable_frame.Buffer()[0] = 0xff;
+  mutable_frame.SetTimeStamp(5678);
+  EXPECT_EQ(0, shared.Frame().Buffer()[0]);
+  EXPECT_EQ(1234u, shared.Frame().TimeStamp());
+  EXPECT_EQ(0, memcmp(image_ + 1, mutable_frame.Buffer() + 1,
+                      kFrameLength - 1));
+
+  // Both references are unshared now, so further writes don't copy.
+  shared.MutableFrame();
+  reference.MutableFrame();
+  EXPECT_EQ(1, CopiesSinceStart());
+}
+
+TEST_F(ViESharedFrameTest, DetachSwapsTheOnlyReference) {
+  const WebRtc_UWord8* buffer = frame_.Buffer();
+  ViESharedFrame shared;
+  shared.Attach(frame_);
+
+  VideoFrame detached;
+  shared.Detach(detached);
+  EXPECT_EQ(buffer, detached.Buffer());
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kFrameLength), detached.Length());
+  EXPECT_EQ(1234u, detached.TimeStamp());
+  EXPECT_EQ(0u, shared.Frame().Length());
+  EXPECT_EQ(0, CopiesSinceStart());
+}
+
+TEST_F(ViESharedFrameTest, DetachCopiesWhenShared) {
+  const WebRtc_UWord8* buffer = frame_.Buffer();
+  ViESharedFrame shared;
+  shared.Attach(frame_);
+  ViESharedFrame reference(shared);
+
+  VideoFrame detached;
+  shared.Detach(detached);
+  EXPECT_EQ(1, CopiesSinceStart());
+  EXPECT_NE(buffer, detached.Buffer());
+  EXPECT_EQ(0, memcmp(image_, detached.Buffer(), kFrameLength));
+  EXPECT_EQ(1234u, detached.TimeStamp());
+
+  // The other reference keeps the frame and is no longer shared.
+  EXPECT_EQ(0u, shared.Frame().Length());
+  EXPECT_FALSE(shared.IsShared());
+  EXPECT_FALSE(reference.IsShared());
+  EXPECT_EQ(buffer, reference.Frame().Buffer());
+}
+
+TEST_F(ViESharedFrameTest, AttachReleasesSharedFrame) {
+  ViESharedFrame shared;
+  shared.Attach(frame_);
+  ViESharedFrame reference(shared);
+  const WebRtc_UWord8* buffer = reference.Frame().Buffer();
+
+  VideoFrame next_frame;
+  next_frame.CopyFrame(kFrameLength / 2, image_);
+  shared.Attach(next_frame);
+  EXPECT_FALSE(shared.IsShared());
+  EXPECT_FALSE(reference.IsShared());
+  EXPECT_EQ(buffer, reference.Frame().Buffer());
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kFrameLength / 2),
+            shared.Frame().Length());
+  EXPECT_EQ(0, CopiesSinceStart());
+}
+
+}  // namespace webrtc
@@ -112,6 +112,11 @@ public:
     virtual int GetVADStatus(int channel, bool& enabled, VadModes& mode,
                              bool& disabledDTX) = 0;
 
+    // Gets the number of encoders that were not run for the last 10 ms
+    // frame because sending channels with identical input and encoder
+    // settings shared the encoder of another channel.
+    virtual int GetNumOfEncodersSaved(int& encodersSaved) = 0;
+
     // Not supported
     virtual int SetAMREncFormat(int channel, AmrMode mode) = 0;
 
@@ -57,6 +57,8 @@ Channel::SendData(FrameType frameType,
         _rtpRtcpModule.SetAudioLevel(_rtpAudioProc->level_estimator()->RMS());
     }
 
+    WebRtc_Word32 ret = 0;
+
     // Push data from ACM to RTP/RTCP-module to deliver audio frame for
     // packetization.
     // This call will trigger Transport::SendPacket() from the RTP/RTCP module.
@@ -70,13 +72,39 @@ Channel::SendData(FrameType frameType,
         _engineStatisticsPtr->SetLastError(
             VE_RTP_RTCP_MODULE_ERROR, kTraceWarning,
             "Channel::SendData() failed to send data to RTP/RTCP module");
-        return -1;
+        ret = -1;
+    }
+    else
+    {
+        _lastLocalTimeStamp = timeStamp;
+        _lastPayloadType = payloadType;
+    }
+
+    // The encoder has delivered a complete packet, whether or not we managed
+    // to send it.
+    _encoderStarted = true;
+    _encoderAtPacketBoundary = true;
+
+    // Packetize the same payload on all channels sharing our encoder, also
+    // if we failed to send it ourselves. Each follower keeps its own SSRC,
+    // sequence numbers and timestamp base.
+    for (int i = 0; i < _numEncoderFollowers; i++)
+    {
+        Channel* followerPtr = _encoderFollowers[i];
+        const WebRtc_UWord32 followerTimeStamp =
+            timeStamp + followerPtr->_sharedEncoderTimeStampOffset;
+        if (followerPtr->SendData(frameType,
+                                  payloadType,
+                                  followerTimeStamp,
+                                  payloadData,
+                                  payloadSize,
+                                  fragmentation) != 0)
+        {
+            ret = -1;
+        }
     }
 
-    _lastLocalTimeStamp = timeStamp;
-    _lastPayloadType = payloadType;
-
-    return 0;
+    return ret;
 }
 
 WebRtc_Word32
@@ -1114,6 +1142,11 @@ Channel::Channel(const WebRtc_Word32 channelId,
     _playoutTimeStampRTP(0),
     _playoutTimeStampRTCP(0),
     _numberOfDiscardedPackets(0),
+    _numEncoderFollowers(0),
+    _encoderLeaderId(-1),
+    _sharedEncoderTimeStampOffset(0),
+    _encoderStarted(false),
+    _encoderAtPacketBoundary(true),
     _engineStatisticsPtr(NULL),
     _moduleProcessThreadPtr(NULL),
     _audioDeviceModulePtr(NULL),
@@ -1156,6 +1189,8 @@ Channel::Channel(const WebRtc_Word32 channelId,
     _lastLocalTimeStamp(0),
     _lastPayloadType(0),
     _includeAudioLevelIndication(false),
+    _sendCNPayloadTypeWb(-1),
+    _sendCNPayloadTypeSwb(-1),
     _rtpPacketTimedOut(false),
     _rtpPacketTimeOutIsEnabled(false),
     _rtpTimeOutSeconds(0),
@@ -1705,6 +1740,12 @@ Channel::StartSend()
         _sending = true;
     }
 
+    // Start the stream from a clean encoder so that it may share the encoder
+    // of a channel started at the same time (see CanShareEncoderWith()).
+    _audioCodingModule.ResetEncoder();
+    _encoderStarted = false;
+    _encoderAtPacketBoundary = true;
+
     if (_rtpRtcpModule.SetSendingStatus(true) != 0)
     {
         _engineStatisticsPtr->SetLastError(
@@ -2598,6 +2639,11 @@ Channel::SetSendCNPayloadType(int type, PayloadFrequencies frequency)
             return -1;
         }
     }
+
+    if (frequency == kFreq32000Hz)
+        _sendCNPayloadTypeSwb = type;
+    else
+        _sendCNPayloadTypeWb = type;
     return 0;
 }
 
@@ -5977,6 +6023,15 @@ Channel::EncodeAndSend()
 
     _audioFrame._id = _channelId;
 
+    if (_encoderLeaderId != -1)
+    {
+        // Our encoder has not seen the audio sent while another channel
+        // encoded for us. It was empty when we joined; reset its state.
+        _audioCodingModule.ResetEncoder();
+        _encoderLeaderId = -1;
+    }
+    _encoderAtPacketBoundary = false;
+
     // --- Add 10ms of raw (PCM) audio data to the encoder @ 32kHz.
 
     // The ACM resamples internally.
@@ -5997,6 +6052,146 @@ Channel::EncodeAndSend()
     return _audioCodingModule.Process();
 }
 
+bool
+Channel::CanShareEncoderWith(Channel& leader)
+{
+    // The input must be identical after all per-channel processing (file
+    // mixing, mute, external media, inband DTMF).
+    const AudioFrame& frame = leader._audioFrame;
+    if ((_audioFrame._payloadDataLengthInSamples !=
+            frame._payloadDataLengthInSamples) ||
+        (_audioFrame._frequencyInHz != frame._frequencyInHz) ||
+        (_audioFrame._audioChannel != frame._audioChannel) ||
+        (memcmp(_audioFrame._payloadData, frame._payloadData,
+                sizeof(WebRtc_Word16) * _audioFrame._audioChannel *
+                _audioFrame._payloadDataLengthInSamples) != 0))
+    {
+        return false;
+    }
+
+    CodecInst codec;
+    CodecInst leaderCodec;
+    if ((_audioCodingModule.SendCodec(codec) != 0) ||
+        (leader._audioCodingModule.SendCodec(leaderCodec) != 0))
+    {
+        return false;
+    }
+    // Our RTP timestamps follow |_timeStamp| only if the ACM does not
+    // resample, which the timestamp offset to the leader relies on.
+    if (_audioFrame._frequencyInHz != codec.plfreq)
+    {
+        return false;
+    }
+    if ((codec.pltype != leaderCodec.pltype) ||
+        (codec.plfreq != leaderCodec.plfreq) ||
+        (codec.pacsize != leaderCodec.pacsize) ||
+        (codec.channels != leaderCodec.channels) ||
+        (codec.rate != leaderCodec.rate) ||
+        (STR_CASE_CMP(codec.plname, leaderCodec.plname) != 0))
+    {
+        return false;
+    }
+    // Adaptive iSAC follows the bandwidth estimate of its own link.
+    if (!STR_CASE_CMP(codec.plname, "ISAC") && (codec.rate == -1))
+    {
+        return false;
+    }
+
+    bool dtx(false), vad(false), leaderDtx(false), leaderVad(false);
+    ACMVADMode mode(VADNormal), leaderMode(VADNormal);
+    if ((_audioCodingModule.VAD(dtx, vad, mode) != 0) ||
+        (leader._audioCodingModule.VAD(leaderDtx, leaderVad, leaderMode) !=
+            0) ||
+        (dtx != leaderDtx) || (vad != leaderVad) || (mode != leaderMode))
+    {
+        return false;
+    }
+    if (dtx && ((_sendCNPayloadTypeWb != leader._sendCNPayloadTypeWb) ||
+                (_sendCNPayloadTypeSwb != leader._sendCNPayloadTypeSwb)))
+    {
+        return false;
+    }
+
+    const bool fec = _audioCodingModule.FECStatus();
+    if (fec != leader._audioCodingModule.FECStatus())
+    {
+        return false;
+    }
+    if (fec)
+    {
+        WebRtc_Word8 redPayloadType(-1), leaderRedPayloadType(-1);
+        if ((_rtpRtcpModule.SendREDPayloadType(redPayloadType) != 0) ||
+            (leader._rtpRtcpModule.SendREDPayloadType(
+                leaderRedPayloadType) != 0) ||
+            (redPayloadType != leaderRedPayloadType))
+        {
+            return false;
+        }
+    }
+
+    if (_encoderLeaderId == leader._channelId)
+    {
+        // Already following; the streams are aligned.
+        return true;
+    }
+
+    // Joining. The leader's next packet must start with this frame, like our
+    // own next packet would.
+    if (!_encoderAtPacketBoundary || !leader._encoderAtPacketBoundary)
+    {
+        return false;
+    }
+    // A payload that depends on earlier audio (codec state, RED) can only be
+    // spliced into our stream if both encoders start out clean. Stateless
+    // payloads can join at any packet boundary.
+    const bool stateless = !fec &&
+        (!STR_CASE_CMP(codec.plname, "PCMU") ||
+         !STR_CASE_CMP(codec.plname, "PCMA") ||
+         !STR_CASE_CMP(codec.plname, "L16"));
+    if (!stateless && (_encoderStarted || leader._encoderStarted))
+    {
+        return false;
+    }
+    return true;
+}
+
+void
+Channel::AddEncoderFollower(Channel& follower)
+{
+    WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId,_channelId),
+                 "Channel::AddEncoderFollower(channel=%d)",
+                 follower._channelId);
+
+    assert(_numEncoderFollowers < kVoiceEngineMaxNumOfChannels);
+    follower.FollowEncoder(*this);
+    _encoderFollowers[_numEncoderFollowers++] = &follower;
+}
+
+void
+Channel::ClearEncoderFollowers()
+{
+    _numEncoderFollowers = 0;
+}
+
+void
+Channel::FollowEncoder(const Channel& leader)
+{
+    if (_encoderLeaderId != leader._channelId)
+    {
+        // Both encoders are on a packet boundary and do not resample (see
+        // CanShareEncoderWith()), so the leader's next packet is stamped with
+        // its |_timeStamp| where ours would have been stamped with ours. This
+        // also holds if we have never sent, so that our timeline continues
+        // when we leave the group.
+        _sharedEncoderTimeStampOffset = _timeStamp - leader._timeStamp;
+        _encoderLeaderId = leader._channelId;
+    }
+    // Keep the input timeline running so that our own encoder picks up
+    // seamlessly if we leave the group.
+    _timeStamp += _audioFrame._payloadDataLengthInSamples;
+    _encoderAtPacketBoundary = false;
+}
+
 int Channel::RegisterExternalMediaProcessing(
     ProcessingTypes type,
     VoEMediaProcess& processObject)
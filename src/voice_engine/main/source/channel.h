@@ -516,8 +516,19 @@ public:
     WebRtc_UWord32 Demultiplex(const AudioFrame& audioFrame);
     WebRtc_UWord32 PrepareEncodeAndSend(int mixingFrequency);
     WebRtc_UWord32 EncodeAndSend();
+    // Encode-once support. TransmitMixer groups sending channels whose
+    // encoders would produce identical payloads; only the first channel of
+    // each group encodes and the payload is packetized by every follower.
+    // A channel can only join a leader on a packet boundary of both
+    // encoders that do not resample, and only stateless codecs can join a
+    // running stream.
+    bool CanShareEncoderWith(Channel& leader);
+    void AddEncoderFollower(Channel& follower);
+    void ClearEncoderFollowers();
 
 private:
+    void FollowEncoder(const Channel& leader);
+
     int InsertInbandDtmfTone();
     WebRtc_Word32
             MixOrReplaceAudioWithFile(const int mixingFrequency);
@@ -579,6 +590,14 @@ private:
     WebRtc_UWord32 _playoutTimeStampRTP;
     WebRtc_UWord32 _playoutTimeStampRTCP;
     WebRtc_UWord32 _numberOfDiscardedPackets;
+    Channel* _encoderFollowers[kVoiceEngineMaxNumOfChannels];
+    int _numEncoderFollowers;
+    WebRtc_Word32 _encoderLeaderId; // -1 when encoding with own ACM
+    WebRtc_UWord32 _sharedEncoderTimeStampOffset;
+    // Our stream has received a payload since StartSend().
+    bool _encoderStarted;
+    // The encoder feeding our stream has no audio buffered.
+    bool _encoderAtPacketBoundary;
 private:
     // uses
     Statistics* _engineStatisticsPtr;
@@ -631,6 +650,8 @@ private:
     WebRtc_UWord32 _lastLocalTimeStamp;
     WebRtc_Word8 _lastPayloadType;
     bool _includeAudioLevelIndication;
+    int _sendCNPayloadTypeWb;
+    int _sendCNPayloadTypeSwb;
     // VoENetwork
     bool _rtpPacketTimedOut;
     bool _rtpPacketTimeOutIsEnabled;
@@ -9,7 +9,292 @@
  */
 
 #include "channel.h"
+
+#include <vector>
+
+#include "audio_device_impl.h"
+#include "channel_manager.h"
+#include "critical_section_wrapper.h"
 #include "gtest/gtest.h"
+#include "module_common_types.h"
+#include "output_mixer.h"
+#include "process_thread.h"
+#include "statistics.h"
+#include "transmit_mixer.h"
+
+namespace webrtc {
+namespace voe {
+namespace {
+
+const WebRtc_UWord32 kInstanceId = 0;
+const int kSampleRateHz = 8000;
+const int kSamplesPer10Ms = kSampleRateHz / 100;
+const int kSamplesPerPacket = 2 * kSamplesPer10Ms;
+const int kRtpHeaderLength = 12;
+const CodecInst kPcmu = {0, "PCMU", kSampleRateHz, kSamplesPerPacket, 1,
+                         64000};
+
+struct RtpPacket {
+  WebRtc_UWord16 sequence_number;
+  WebRtc_UWord32 timestamp;
+  WebRtc_UWord32 ssrc;
+  std::vector<WebRtc_UWord8> payload;
+};
+
+// Parses and stores the RTP packets sent by a channel.
+class PacketRecorder : public Transport {
+ public:
+  PacketRecorder() : fail_(false) {}
+  virtual ~PacketRecorder() {}
+
+  virtual int SendPacket(int channel, const void* data, int len) {
+    if (fail_ || len < kRtpHeaderLength) {
+      return -1;
+    }
+    const WebRtc_UWord8* ptr = static_cast<const WebRtc_UWord8*>(data);
+    RtpPacket packet;
+    packet.sequence_number = (ptr[2] << 8) | ptr[3];
+    packet.timestamp = (ptr[4] << 24) | (ptr[5] << 16) | (ptr[6] << 8) |
+        ptr[7];
+    packet.ssrc = (ptr[8] << 24) | (ptr[9] << 16) | (ptr[10] << 8) | ptr[11];
+    packet.payload.assign(ptr + kRtpHeaderLength, ptr + len);
+    packets_.push_back(packet);
+    return len;
+  }
+
+  virtual int SendRTCPPacket(int channel, const void* data, int len) {
+    return len;
+  }
+
+  void set_fail(bool fail) { fail_ = fail; }
+  const std::vector<RtpPacket>& packets() const { return packets_; }
+
+ private:
+  bool fail_;
+  std::vector<RtpPacket> packets_;
+};
+
+class ChannelEncoderSharingTest : public ::testing::Test {
+ protected:
+  ChannelEncoderSharingTest()
+      : statistics_(kInstanceId),
+        channel_manager_(kInstanceId),
+        callback_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+        process_thread_(ProcessThread::CreateProcessThread()),
+        transmit_mixer_(NULL),
+        output_mixer_(NULL),
+        audio_device_(NULL),
+        leader_(NULL),
+        follower_(NULL) {
+  }
+
+  virtual void SetUp() {
+    ASSERT_EQ(0, TransmitMixer::Create(transmit_mixer_, kInstanceId));
+    ASSERT_EQ(0, transmit_mixer_->SetEngineInformation(*process_thread_,
+                                                       statistics_,
+                                                       channel_manager_));
+    ASSERT_EQ(0, OutputMixer::Create(output_mixer_, kInstanceId));
+    audio_device_ = AudioDeviceModuleImpl::Create(
+        kInstanceId, AudioDeviceModule::kDummyAudio);
+    ASSERT_TRUE(audio_device_ != NULL);
+    audio_device_->AddRef();
+    // TransmitMixer visits the channels in creation order.
+    CreateSendingChannel(leader_transport_, leader_);
+    CreateSendingChannel(follower_transport_, follower_);
+  }
+
+  virtual void TearDown() {
+    DeleteChannel(leader_);
+    DeleteChannel(follower_);
+    if (audio_device_ != NULL) {
+      audio_device_->Release();
+    }
+    OutputMixer::Destroy(output_mixer_);
+    TransmitMixer::Destroy(transmit_mixer_);
+    ProcessThread::DestroyProcessThread(process_thread_);
+    delete callback_crit_sect_;
+  }
+
+  void CreateSendingChannel(PacketRecorder& transport, Channel*& channel) {
+    WebRtc_Word32 id = -1;
+    ASSERT_TRUE(channel_manager_.CreateChannel(id));
+    channel = ScopedChannel(channel_manager_, id).ChannelPtr();
+    ASSERT_TRUE(channel != NULL);
+    ASSERT_EQ(0, channel->SetEngineInformation(statistics_, *output_mixer_,
+                                               *transmit_mixer_,
+                                               *process_thread_,
+                                               *audio_device_, NULL,
+                                               callback_crit_sect_));
+    ASSERT_EQ(0, channel->Init());
+    ASSERT_EQ(0, channel->RegisterExternalTransport(transport));
+    ASSERT_EQ(0, channel->SetSendCodec(kPcmu));
+    ASSERT_EQ(0, channel->StartSend());
+  }
+
+  void DeleteChannel(Channel*& channel) {
+    if (channel != NULL) {
+      channel->StopSend();
+      channel->DeRegisterExternalTransport();
+      channel_manager_.DestroyChannel(channel->ChannelId());
+      channel = NULL;
+    }
+  }
+
+  // 10 ms of audio that differs from frame to frame.
+  static void MakeFrame(int index, int amplitude, AudioFrame& frame) {
+    WebRtc_Word16 samples[kSamplesPer10Ms];
+    for (int i = 0; i < kSamplesPer10Ms; i++) {
+      samples[i] = static_cast<WebRtc_Word16>(
+          amplitude * (((index * kSamplesPer10Ms + i) % 40) - 20));
+    }
+    frame.UpdateFrame(-1, 0, samples, kSamplesPer10Ms, kSampleRateHz,
+                      AudioFrame::kNormalSpeech, AudioFrame::kVadActive);
+  }
+
+  // Feeds one frame to each channel, as TransmitMixer::DemuxAndMix() does
+  // but with per-channel audio, and encodes them through TransmitMixer.
+  // Returns true if the follower used the encoder of the leader.
+  bool EncodeFrame(const AudioFrame& leader_frame,
+                   const AudioFrame& follower_frame) {
+    leader_->Demultiplex(leader_frame);
+    follower_->Demultiplex(follower_frame);
+    leader_->PrepareEncodeAndSend(kSampleRateHz);
+    follower_->PrepareEncodeAndSend(kSampleRateHz);
+    EXPECT_EQ(0, transmit_mixer_->EncodeAndSend());
+    return transmit_mixer_->EncodersSaved() == 1;
+  }
+
+  // Checks that the follower's RTP stream is continuous, whoever encoded it.
+  void ExpectContinuousStream(const std::vector<RtpPacket>& packets) {
+    for (size_t i = 1; i < packets.size(); i++) {
+      EXPECT_EQ(static_cast<WebRtc_UWord16>(
+                    packets[i - 1].sequence_number + 1),
+                packets[i].sequence_number);
+      EXPECT_EQ(packets[i - 1].timestamp + kSamplesPerPacket,
+                packets[i].timestamp);
+      EXPECT_EQ(packets[0].ssrc, packets[i].ssrc);
+    }
+  }
+
+  Statistics statistics_;
+  ChannelManager channel_manager_;
+  CriticalSectionWrapper* callback_crit_sect_;
+  ProcessThread* process_thread_;
+  TransmitMixer* transmit_mixer_;
+  OutputMixer* output_mixer_;
+  AudioDeviceModule* audio_device_;
+  PacketRecorder leader_transport_;
+  PacketRecorder follower_transport_;
+  Channel* leader_;
+  Channel* follower_;
+};
 
-// Empty test just to get coverage metrics.
 TEST(ChannelTest, EmptyTestToGetCodeCoverage) {}
+
+TEST_F(ChannelEncoderSharingTest, LeaderPacketizesForFollower) {
+  AudioFrame frame;
+  for (int i = 0; i < 10; i++) {
+    MakeFrame(i, 100, frame);
+    EXPECT_TRUE(EncodeFrame(frame, frame));
+  }
+
+  const std::vector<RtpPacket>& leader = leader_transport_.packets();
+  const std::vector<RtpPacket>& follower = follower_transport_.packets();
+  ASSERT_EQ(5u, leader.size());
+  ASSERT_EQ(5u, follower.size());
+  for (size_t i = 0; i < leader.size(); i++) {
+    EXPECT_EQ(static_cast<size_t>(kSamplesPerPacket),
+              follower[i].payload.size());
+    EXPECT_TRUE(leader[i].payload == follower[i].payload);
+  }
+  EXPECT_NE(leader[0].ssrc, follower[0].ssrc);
+  ExpectContinuousStream(leader);
+  ExpectContinuousStream(follower);
+}
+
+TEST_F(ChannelEncoderSharingTest, FollowerLeavesAndRejoinsOnPacketBoundary) {
+  AudioFrame frame;
+  AudioFrame other_frame;
+  int index = 0;
+  for (; index < 4; index++) {
+    MakeFrame(index, 100, frame);
+    EXPECT_TRUE(EncodeFrame(frame, frame));
+  }
+  // Different audio takes the follower out of the group.
+  for (; index < 7; index++) {
+    MakeFrame(index, 100, frame);
+    MakeFrame(index, 50, other_frame);
+    EXPECT_FALSE(EncodeFrame(frame, other_frame));
+  }
+  // Identical audio again, but the follower's own encoder holds half a
+  // packet. It can only rejoin once that packet is complete.
+  MakeFrame(index++, 100, frame);
+  EXPECT_FALSE(EncodeFrame(frame, frame));
+  for (; index < 12; index++) {
+    MakeFrame(index, 100, frame);
+    EXPECT_TRUE(EncodeFrame(frame, frame));
+  }
+
+  const std::vector<RtpPacket>& leader = leader_transport_.packets();
+  const std::vector<RtpPacket>& follower = follower_transport_.packets();
+  ASSERT_EQ(6u, leader.size());
+  ASSERT_EQ(6u, follower.size());
+  EXPECT_TRUE(leader[1].payload == follower[1].payload);
+  EXPECT_FALSE(leader[2].payload == follower[2].payload);
+  EXPECT_FALSE(leader[3].payload == follower[3].payload);
+  EXPECT_TRUE(leader[4].payload == follower[4].payload);
+  EXPECT_TRUE(leader[5].payload == follower[5].payload);
+  ExpectContinuousStream(leader);
+  ExpectContinuousStream(follower);
+}
+
+TEST_F(ChannelEncoderSharingTest, FollowerKeepsItsTimelineWhenLeaving) {
+  AudioFrame frame;
+  // Put the follower's input timeline ahead of the leader's, as if its input
+  // had been on hold, before it has sent anything.
+  MakeFrame(0, 100, frame);
+  follower_->Demultiplex(frame);
+  for (int i = 0; i < 3; i++) {
+    follower_->UpdateLocalTimeStamp();
+  }
+
+  AudioFrame other_frame;
+  int index = 0;
+  for (; index < 4; index++) {
+    MakeFrame(index, 100, frame);
+    EXPECT_TRUE(EncodeFrame(frame, frame));
+  }
+  // The follower leaves and continues with its own encoder.
+  for (; index < 8; index++) {
+    MakeFrame(index, 100, frame);
+    MakeFrame(index, 50, other_frame);
+    EXPECT_FALSE(EncodeFrame(frame, other_frame));
+  }
+
+  const std::vector<RtpPacket>& leader = leader_transport_.packets();
+  const std::vector<RtpPacket>& follower = follower_transport_.packets();
+  ASSERT_EQ(4u, leader.size());
+  ASSERT_EQ(4u, follower.size());
+  EXPECT_TRUE(leader[1].payload == follower[1].payload);
+  EXPECT_FALSE(leader[2].payload == follower[2].payload);
+  ExpectContinuousStream(leader);
+  ExpectContinuousStream(follower);
+}
+
+TEST_F(ChannelEncoderSharingTest, FollowerSendsWhenLeaderFails) {
+  const WebRtc_UWord8 payload[kSamplesPerPacket] = {0};
+  leader_->AddEncoderFollower(*follower_);
+  leader_transport_.set_fail(true);
+  EXPECT_EQ(-1, leader_->SendData(kAudioFrameSpeech, kPcmu.pltype, 0,
+                                  payload, sizeof(payload), NULL));
+  leader_->ClearEncoderFollowers();
+
+  EXPECT_TRUE(leader_transport_.packets().empty());
+  ASSERT_EQ(1u, follower_transport_.packets().size());
+  EXPECT_EQ(static_cast<size_t>(kSamplesPerPacket),
+            follower_transport_.packets()[0].payload.size());
+}
+
+}  // namespace
+}  // namespace voe
+}  // namespace webrtc
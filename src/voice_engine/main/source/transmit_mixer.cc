@@ -196,7 +196,8 @@ TransmitMixer::TransmitMixer(const WebRtc_UWord32 instanceId) :
     _mute(false),
     _remainingMuteMicTimeMs(0),
     _mixingFrequency(0),
-    _includeAudioLevelIndication(false)
+    _includeAudioLevelIndication(false),
+    _encodersSaved(0)
 {
     WEBRTC_TRACE(kTraceMemory, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::TransmitMixer() - ctor");
@@ -455,6 +456,13 @@ TransmitMixer::EncodeAndSend()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::EncodeAndSend()");
 
+    // Channels fed with identical audio and configured with identical
+    // encoders share the encoder of the first such channel; its payload is
+    // then packetized by every channel in the group.
+    Channel* encodingChannels[kVoiceEngineMaxNumOfChannels];
+    int numEncodingChannels = 0;
+    WebRtc_UWord32 encodersSaved = 0;
+
     ScopedChannel sc(*_channelManagerPtr);
     void* iterator(NULL);
     Channel* channelPtr = sc.GetFirstChannel(iterator);
@@ -462,13 +470,53 @@ TransmitMixer::EncodeAndSend()
     {
         if (channelPtr->Sending() && !channelPtr->InputIsOnHold())
         {
-            channelPtr->EncodeAndSend();
+            channelPtr->ClearEncoderFollowers();
+            Channel* leaderPtr = NULL;
+            for (int i = 0; i < numEncodingChannels; i++)
+            {
+                if (channelPtr->CanShareEncoderWith(*encodingChannels[i]))
+                {
+                    leaderPtr = encodingChannels[i];
+                    break;
+                }
+            }
+            if (leaderPtr != NULL)
+            {
+                leaderPtr->AddEncoderFollower(*channelPtr);
+                encodersSaved++;
+            }
+            else
+            {
+                assert(numEncodingChannels < kVoiceEngineMaxNumOfChannels);
+                encodingChannels[numEncodingChannels++] = channelPtr;
+            }
         }
         channelPtr = sc.GetNextChannel(iterator);
     }
+
+    for (int i = 0; i < numEncodingChannels; i++)
+    {
+        encodingChannels[i]->EncodeAndSend();
+        encodingChannels[i]->ClearEncoderFollowers();
+    }
+
+    if (encodersSaved != _encodersSaved)
+    {
+        WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId, -1),
+                     "TransmitMixer::EncodeAndSend() => %u of %u sending "
+                     "channels share an encoder (%u encoders saved)",
+                     encodersSaved, numEncodingChannels + encodersSaved,
+                     encodersSaved);
+        _encodersSaved = encodersSaved;
+    }
     return 0;
 }
 
+WebRtc_UWord32 TransmitMixer::EncodersSaved() const
+{
+    return _encodersSaved;
+}
+
 WebRtc_UWord32 TransmitMixer::CaptureLevel() const
 {
     return _captureLevel;
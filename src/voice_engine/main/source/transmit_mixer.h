@@ -65,6 +65,10 @@ public:
 
     WebRtc_Word32 EncodeAndSend();
 
+    // Number of sending channels that shared the encoder of another channel
+    // in the last EncodeAndSend().
+    WebRtc_UWord32 EncodersSaved() const;
+
     WebRtc_UWord32 CaptureLevel() const;
 
     WebRtc_Word32 StopSend();
@@ -213,6 +217,8 @@ private:
     WebRtc_Word32 _remainingMuteMicTimeMs;
     int _mixingFrequency;
     bool _includeAudioLevelIndication;
+    // Encoders not run for the last frame.
+    WebRtc_UWord32 _encodersSaved;
 };
 
 #endif // WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
@@ -14,6 +14,7 @@
 #include "channel.h"
 #include "critical_section_wrapper.h"
 #include "trace.h"
+#include "transmit_mixer.h"
 #include "voe_errors.h"
 #include "voice_engine_impl.h"
 
@@ -664,6 +665,22 @@ int VoECodecImpl::GetVADStatus(int channel, bool& enabled, VadModes& mode,
     return 0;
 }
 
+int VoECodecImpl::GetNumOfEncodersSaved(int& encodersSaved)
+{
+    WEBRTC_TRACE(kTraceApiCall, kTraceVoice, VoEId(_instanceId, -1),
+                 "GetNumOfEncodersSaved(encodersSaved=?)");
+    if (!_engineStatistics.Initialized())
+    {
+        _engineStatistics.SetLastError(VE_NOT_INITED, kTraceError);
+        return -1;
+    }
+    encodersSaved = static_cast<int>(_transmitMixerPtr->EncodersSaved());
+    WEBRTC_TRACE(kTraceStateInfo, kTraceVoice, VoEId(_instanceId, -1),
+                 "GetNumOfEncodersSaved() => encodersSaved=%d",
+                 encodersSaved);
+    return 0;
+}
+
 void VoECodecImpl::ACMToExternalCodecRepresentation(CodecInst& toInst,
                                                     const CodecInst& fromInst)
 {
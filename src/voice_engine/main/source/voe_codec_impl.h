@@ -75,6 +75,8 @@ public:
                              VadModes& mode,
                              bool& disabledDTX);
 
+    virtual int GetNumOfEncodersSaved(int& encodersSaved);
+
 protected:
     VoECodecImpl();
     virtual ~VoECodecImpl();
@@ -80,3 +80,9 @@ TEST_F(CodecBeforeStreamingTest, SetRecPayloadTypeCanChangeILBCPayloadType) {
 
   EXPECT_EQ(original_pltype, codec_instance_.pltype);
 }
+
+TEST_F(CodecBeforeStreamingTest, NoEncodersAreSavedBeforeStreaming) {
+  int encoders_saved = -1;
+  EXPECT_EQ(0, voe_codec_->GetNumOfEncodersSaved(encoders_saved));
+  EXPECT_EQ(0, encoders_saved);
+}